@@ -4,6 +4,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <sys/resource.h>
 #include <sys/time.h>
 #include <time.h>
 #include <unistd.h>
@@ -18,6 +19,13 @@ void printThreadId(pthread_t id, char* buf)
     sprintf(buf + strlen(buf), "%02x", *(((unsigned char*) &id) + i - 1));
 }
 
+static int64_t getCpuTimeInUs() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return (int64_t)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000L +
+         (int64_t)(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec);
+}
+
 static int64_t getTimeInUs() {
   struct timeval systemTime;
   gettimeofday(&systemTime, NULL);
@@ -147,9 +155,10 @@ int main(int argc, char* argv[]) {
 
   int protocol = TSDB_SML_TELNET_PROTOCOL;
   int assembleSTables = 0;
+  int directInsert = -1;
 
   int opt;
-  while ((opt = getopt(argc, argv, "s:c:r:f:t:b:p:w:hv")) != -1) {
+  while ((opt = getopt(argc, argv, "s:c:r:f:t:b:p:w:m:a:hv")) != -1) {
     switch (opt) {
       case 's':
         numSuperTables = atoi(optarg);
@@ -175,6 +184,9 @@ int main(int argc, char* argv[]) {
       case 'a':
         assembleSTables = atoi(optarg);
         break;
+      case 'm':
+        directInsert = (optarg[0] == 'd') ? 1 : 0;
+        break;
       case 'p':
         if (optarg[0] == 't') {
           protocol = TSDB_SML_TELNET_PROTOCOL;
@@ -185,11 +197,11 @@ int main(int argc, char* argv[]) {
         }
         break;
       case 'h':
-        fprintf(stderr, "Usage: %s -s supertable -c childtable -r rows -f fields -t threads -b maxlines_per_batch -p [t|l|j] -a assemble-stables -v\n",
+        fprintf(stderr, "Usage: %s -s supertable -c childtable -r rows -f fields -t threads -b maxlines_per_batch -p [t|l|j] -a assemble-stables -m [s|d] -v\n",
                 argv[0]);
         exit(0);
       default: /* '?' */
-        fprintf(stderr, "Usage: %s -s supertable -c childtable -r rows -f fields -t threads -b maxlines_per_batch -p [t|l|j] -a assemble-stables -v\n",
+        fprintf(stderr, "Usage: %s -s supertable -c childtable -r rows -f fields -t threads -b maxlines_per_batch -p [t|l|j] -a assemble-stables -m [s|d] -v\n",
                 argv[0]);
         exit(-1);
     }
@@ -201,6 +213,16 @@ int main(int argc, char* argv[]) {
   const char* user = "root";
   const char* passwd = "taosdata";
 
+  if (directInsert >= 0) {
+    // s: insert by sql/stmt, d: write submit blocks directly
+    char cfg[64];
+    snprintf(cfg, sizeof(cfg), "{\"smlDirectInsert\":\"%d\"}", directInsert);
+    setConfRet ret = taos_set_config(cfg);
+    if (ret.retCode != SET_CONF_RET_SUCC) {
+      printf("failed to set smlDirectInsert, reason:%s\n", ret.retMsg);
+    }
+  }
+
   taos_options(TSDB_OPTION_TIMEZONE, "GMT-8");
   TAOS* taos = taos_connect(host, user, passwd, "", 0);
   if (taos == NULL) {
@@ -282,6 +304,7 @@ int main(int argc, char* argv[]) {
 
   printf("begin multi-thread insertion...\n");
   int64_t begin = taosGetTimestampUs();
+  int64_t cpuBegin = getCpuTimeInUs();
 
   for (int i=0; i < numThreads; ++i) {
     pthread_create(tids+i, NULL, insertLines, argsThread+i);
@@ -290,6 +313,7 @@ int main(int argc, char* argv[]) {
     pthread_join(tids[i], NULL);
   }
   int64_t end = taosGetTimestampUs();
+  int64_t cpuEnd = getCpuTimeInUs();
 
   size_t linesNum = numSuperTables*numChildTables*numRowsPerChildTable;
   printf("TOTAL LINES: %zu\n", linesNum);
@@ -297,6 +321,10 @@ int main(int argc, char* argv[]) {
   printf("TIME: %d(ms)\n", (int)(end-begin)/1000);
   double throughput = (double)(totalLines)/(double)(end-begin) * 1000000;
   printf("THROUGHPUT:%d/s\n", (int)throughput);
+  printf("CLIENT CPU TIME: %d(ms)\n", (int)(cpuEnd-cpuBegin)/1000);
+  if (cpuEnd > cpuBegin) {
+    printf("THROUGHPUT PER CORE:%d/s\n", (int)((double)(totalLines)/(double)(cpuEnd-cpuBegin) * 1000000));
+  }
 
   for (int i = 0; i < totalBatches; ++i) {
     free(allBatches[i]);
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TDENGINE_BALANCE_LOAD_H
+#define TDENGINE_BALANCE_LOAD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "os.h"
+
+/*
+ * The load of a vnode is the sum of its write bytes, write rows, query time and disk usage, each divided by the
+ * average of all vnodes, and scaled so that an average vnode costs 1. A vnode without any load also costs 1, so the
+ * load of a dnode degenerates to its vnodes per core while nothing is measured.
+ */
+typedef struct {
+  int32_t dnodeId;
+  int32_t numOfCores;
+  bool    online;    // the vnodes can be moved out of the dnode
+  bool    avail;     // the dnode can accept vnodes
+  float   baseLoad;  // load not from vnodes, such as the mnode
+  float   load;      // calculated
+} SBnLoadDnode;
+
+typedef struct {
+  int32_t vgId;
+  int32_t dnodeId;  // the replicas of a vgroup are different vnodes with the same vgId
+  int64_t writeBytesRate;
+  int64_t writeRowsRate;
+  int64_t queryTimeRate;
+  int64_t diskUsed;
+  float   cost;     // calculated
+} SBnLoadVnode;
+
+typedef struct {
+  int32_t vgId;
+  int32_t srcDnodeId;
+  int32_t destDnodeId;
+  float   cost;      // load of the vnode moved
+  float   srcLoad;   // dnode loads before the move
+  float   destLoad;
+  float   peakLoad;  // peak dnode load before and after the move
+  float   newPeakLoad;
+} SBnLoadMove;
+
+/**
+ * calculate the cost of the vnodes and the load of the dnodes
+ */
+void bnCalcLoads(SBnLoadDnode *dnodes, int32_t numOfDnodes, SBnLoadVnode *vnodes, int32_t numOfVnodes);
+
+/**
+ * plan the vnode moves which lower the peak dnode load, one after another. A vnode is moved out of the most loaded
+ * dnode which has a move lowering the larger load of the source and the destination. The destination must be less
+ * loaded than the source by the threshold, so the moves stop before they chase the noise of the rates.
+ *
+ * @param threshold  minimal ratio of the source load which the destination is less loaded by
+ * @param moves      the moves planned, the dnodes and vnodes are updated as if they are done
+ * @param maxMoves   the maximum number of moves
+ * @return           the number of moves planned
+ */
+int32_t bnPlanLoadMoves(SBnLoadDnode *dnodes, int32_t numOfDnodes, SBnLoadVnode *vnodes, int32_t numOfVnodes,
+                        float threshold, SBnLoadMove *moves, int32_t maxMoves);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
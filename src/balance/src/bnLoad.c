@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _DEFAULT_SOURCE
+#include "os.h"
+#include "bnLoad.h"
+
+#define BN_LOAD_DIMS    4
+#define BN_LOAD_EPSILON 0.0001f
+
+static int64_t bnGetVnodeLoadDim(SBnLoadVnode *pVnode, int32_t dim) {
+  switch (dim) {
+    case 0:  return pVnode->writeBytesRate;
+    case 1:  return pVnode->writeRowsRate;
+    case 2:  return pVnode->queryTimeRate;
+    default: return pVnode->diskUsed;
+  }
+}
+
+static int32_t bnGetDnodeCores(SBnLoadDnode *pDnode) {
+  return (pDnode->numOfCores > 0) ? pDnode->numOfCores : 1;
+}
+
+static SBnLoadDnode *bnGetLoadDnode(SBnLoadDnode *dnodes, int32_t numOfDnodes, int32_t dnodeId) {
+  for (int32_t i = 0; i < numOfDnodes; ++i) {
+    if (dnodes[i].dnodeId == dnodeId) return &dnodes[i];
+  }
+  return NULL;
+}
+
+void bnCalcLoads(SBnLoadDnode *dnodes, int32_t numOfDnodes, SBnLoadVnode *vnodes, int32_t numOfVnodes) {
+  double avg[BN_LOAD_DIMS] = {0};
+  int32_t numOfDims = 0;
+
+  for (int32_t dim = 0; dim < BN_LOAD_DIMS; ++dim) {
+    for (int32_t v = 0; v < numOfVnodes; ++v) {
+      avg[dim] += MAX(bnGetVnodeLoadDim(&vnodes[v], dim), 0);
+    }
+    if (numOfVnodes > 0) avg[dim] /= numOfVnodes;
+    if (avg[dim] > 0) numOfDims++;
+  }
+
+  for (int32_t v = 0; v < numOfVnodes; ++v) {
+    double cost = 1;
+    for (int32_t dim = 0; dim < BN_LOAD_DIMS; ++dim) {
+      if (avg[dim] > 0) cost += MAX(bnGetVnodeLoadDim(&vnodes[v], dim), 0) / avg[dim];
+    }
+    vnodes[v].cost = (float)(cost / (1 + numOfDims));
+  }
+
+  for (int32_t d = 0; d < numOfDnodes; ++d) {
+    dnodes[d].load = dnodes[d].baseLoad;
+  }
+
+  for (int32_t v = 0; v < numOfVnodes; ++v) {
+    SBnLoadDnode *pDnode = bnGetLoadDnode(dnodes, numOfDnodes, vnodes[v].dnodeId);
+    if (pDnode != NULL) pDnode->load += vnodes[v].cost / bnGetDnodeCores(pDnode);
+  }
+}
+
+static float bnGetPeakLoad(SBnLoadDnode *dnodes, int32_t numOfDnodes) {
+  float peak = 0;
+  for (int32_t d = 0; d < numOfDnodes; ++d) {
+    peak = MAX(peak, dnodes[d].load);
+  }
+  return peak;
+}
+
+static bool bnCheckVgroupInDnode(SBnLoadVnode *vnodes, int32_t numOfVnodes, int32_t vgId, int32_t dnodeId) {
+  for (int32_t v = 0; v < numOfVnodes; ++v) {
+    if (vnodes[v].vgId == vgId && vnodes[v].dnodeId == dnodeId) return true;
+  }
+  return false;
+}
+
+// find the move out of the source which lowers the larger load of the source and the destination most, the
+// destination is less loaded than the source by the threshold at least
+static bool bnPlanMoveFromDnode(SBnLoadDnode *dnodes, int32_t numOfDnodes, SBnLoadVnode *vnodes, int32_t numOfVnodes,
+                                SBnLoadDnode *pSrc, float threshold, int32_t *pVnodeIdx, int32_t *pDestIdx) {
+  float best = pSrc->load - BN_LOAD_EPSILON;
+  float maxDestLoad = pSrc->load * (1 - threshold);
+  bool  found = false;
+
+  for (int32_t v = 0; v < numOfVnodes; ++v) {
+    SBnLoadVnode *pVnode = &vnodes[v];
+    if (pVnode->dnodeId != pSrc->dnodeId) continue;
+
+    float srcLoad = pSrc->load - pVnode->cost / bnGetDnodeCores(pSrc);
+    for (int32_t d = 0; d < numOfDnodes; ++d) {
+      SBnLoadDnode *pDest = &dnodes[d];
+      if (pDest == pSrc || !pDest->avail || pDest->load >= maxDestLoad) continue;
+
+      float pairLoad = MAX(srcLoad, pDest->load + pVnode->cost / bnGetDnodeCores(pDest));
+      if (pairLoad >= best) continue;
+      if (bnCheckVgroupInDnode(vnodes, numOfVnodes, pVnode->vgId, pDest->dnodeId)) continue;
+
+      best = pairLoad;
+      *pVnodeIdx = v;
+      *pDestIdx = d;
+      found = true;
+    }
+  }
+
+  return found;
+}
+
+int32_t bnPlanLoadMoves(SBnLoadDnode *dnodes, int32_t numOfDnodes, SBnLoadVnode *vnodes, int32_t numOfVnodes,
+                        float threshold, SBnLoadMove *moves, int32_t maxMoves) {
+  int32_t numOfMoves = 0;
+  bool *  tried = calloc(MAX(numOfDnodes, 1), sizeof(bool));
+  if (tried == NULL) return 0;
+
+  bnCalcLoads(dnodes, numOfDnodes, vnodes, numOfVnodes);
+
+  while (numOfMoves < maxMoves) {
+    memset(tried, 0, numOfDnodes * sizeof(bool));
+
+    // the sources are tried from the most loaded one
+    int32_t v = -1;
+    int32_t dest = -1;
+    int32_t src = -1;
+    while (1) {
+      src = -1;
+      for (int32_t d = 0; d < numOfDnodes; ++d) {
+        if (tried[d] || !dnodes[d].online) continue;
+        if (src < 0 || dnodes[d].load > dnodes[src].load) src = d;
+      }
+      if (src < 0) break;
+
+      tried[src] = true;
+      if (bnPlanMoveFromDnode(dnodes, numOfDnodes, vnodes, numOfVnodes, &dnodes[src], threshold, &v, &dest)) break;
+    }
+    if (src < 0) break;
+
+    SBnLoadDnode *pSrc = &dnodes[src];
+    SBnLoadDnode *pDest = &dnodes[dest];
+    SBnLoadVnode *pVnode = &vnodes[v];
+    SBnLoadMove * pMove = &moves[numOfMoves++];
+
+    pMove->vgId = pVnode->vgId;
+    pMove->srcDnodeId = pSrc->dnodeId;
+    pMove->destDnodeId = pDest->dnodeId;
+    pMove->cost = pVnode->cost;
+    pMove->srcLoad = pSrc->load;
+    pMove->destLoad = pDest->load;
+    pMove->peakLoad = bnGetPeakLoad(dnodes, numOfDnodes);
+
+    pSrc->load -= pVnode->cost / bnGetDnodeCores(pSrc);
+    pDest->load += pVnode->cost / bnGetDnodeCores(pDest);
+    pVnode->dnodeId = pDest->dnodeId;
+    pMove->newPeakLoad = bnGetPeakLoad(dnodes, numOfDnodes);
+  }
+
+  free(tried);
+  return numOfMoves;
+}
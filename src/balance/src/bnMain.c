@@ -20,6 +20,7 @@
 #include "tglobal.h"
 #include "dnode.h"
 #include "bnInt.h"
+#include "bnLoad.h"
 #include "bnScore.h"
 #include "bnThread.h"
 #include "mnodeDb.h"
@@ -29,10 +30,21 @@
 #include "mnodeUser.h"
 #include "mnodeVgroup.h"
 
+#define BN_MAX_PLAN_MOVES 100
+#define BN_PLAN_LOAD_THRESHOLD 0.2f
+
+typedef struct {
+  int32_t     numOfMoves;
+  SBnLoadMove moves[];
+} SBnPlan;
+
 extern int64_t tsDnodeRid;
 extern int32_t tsSdbRid;
 static SBnMgmt tsBnMgmt;
 static void  bnMonitorDnodeModule();
+static int32_t bnGetPlanMeta(STableMetaMsg *pMeta, SShowObj *pShow, void *pConn);
+static int32_t bnRetrievePlan(SShowObj *pShow, char *data, int32_t rows, void *pConn);
+static void    bnFreePlan(void *pIter);
 
 static void bnLock() {
   pthread_mutex_lock(&tsBnMgmt.mutex);
@@ -334,9 +346,114 @@ static int32_t bnAddVnode(SVgObj *pVgroup, SDnodeObj *pSrcDnode, SDnodeObj *pDes
   return TSDB_CODE_SUCCESS;
 }
 
+// the loads of all dnodes and vnodes, the vnodes out of the arrays are left out while the sdb grows
+static int32_t bnBuildLoads(SBnLoadDnode **ppDnodes, int32_t *pNumOfDnodes, SBnLoadVnode **ppVnodes,
+                            int32_t *pNumOfVnodes) {
+  int32_t maxDnodes = mnodeGetDnodesNum();
+  int32_t maxVnodes = (int32_t)mnodeGetVgroupNum() * TSDB_MAX_REPLICA;
+  int64_t now = taosGetTimestampMs();
+
+  *pNumOfDnodes = 0;
+  *pNumOfVnodes = 0;
+  *ppDnodes = calloc(MAX(maxDnodes, 1), sizeof(SBnLoadDnode));
+  *ppVnodes = calloc(MAX(maxVnodes, 1), sizeof(SBnLoadVnode));
+  if (*ppDnodes == NULL || *ppVnodes == NULL) {
+    tfree(*ppDnodes);
+    tfree(*ppVnodes);
+    return TSDB_CODE_MND_OUT_OF_MEMORY;
+  }
+
+  void *     pIter = NULL;
+  SDnodeObj *pDnode = NULL;
+  while (1) {
+    pIter = mnodeGetNextDnode(pIter, &pDnode);
+    if (pDnode == NULL) break;
+
+    if (*pNumOfDnodes < maxDnodes) {
+      SBnLoadDnode *pLoad = *ppDnodes + (*pNumOfDnodes)++;
+      pLoad->dnodeId = pDnode->dnodeId;
+      pLoad->numOfCores = pDnode->numOfCores;
+      pLoad->online = (pDnode->status == TAOS_DN_STATUS_READY);
+      pLoad->avail = pLoad->online && now - pDnode->createdTime >= 2000 && bnCheckFree(pDnode);
+      if (pDnode->isMgmt && pDnode->numOfCores > 0) {
+        pLoad->baseLoad = (float)tsMnodeEqualVnodeNum / pDnode->numOfCores;
+      }
+    }
+
+    mnodeDecDnodeRef(pDnode);
+  }
+
+  pIter = NULL;
+  while (1) {
+    SVgObj *pVgroup = NULL;
+    pIter = mnodeGetNextVgroup(pIter, &pVgroup);
+    if (pVgroup == NULL) break;
+
+    for (int32_t i = 0; i < pVgroup->numOfVnodes && *pNumOfVnodes < maxVnodes; ++i) {
+      SBnLoadVnode *pLoad = *ppVnodes + (*pNumOfVnodes)++;
+      pLoad->vgId = pVgroup->vgId;
+      pLoad->dnodeId = pVgroup->vnodeGid[i].dnodeId;
+      pLoad->writeBytesRate = pVgroup->writeBytesRate;
+      pLoad->writeRowsRate = pVgroup->writeRowsRate;
+      pLoad->queryTimeRate = pVgroup->queryTimeRate[i];
+      pLoad->diskUsed = pVgroup->compStorage;
+    }
+
+    mnodeDecVgroupRef(pVgroup);
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static bool bnMonitorLoadBalance() {
+  SBnLoadDnode *dnodes = NULL;
+  SBnLoadVnode *vnodes = NULL;
+  int32_t       numOfDnodes = 0;
+  int32_t       numOfVnodes = 0;
+  SBnLoadMove   move = {0};
+
+  if (bnBuildLoads(&dnodes, &numOfDnodes, &vnodes, &numOfVnodes) != TSDB_CODE_SUCCESS) return false;
+  int32_t numOfMoves = bnPlanLoadMoves(dnodes, numOfDnodes, vnodes, numOfVnodes, tsBalanceLoadThreshold, &move, 1);
+  free(dnodes);
+  free(vnodes);
+
+  if (numOfMoves == 0) {
+    mDebug("all dnodes:%d is already balanced by load", numOfDnodes);
+    return false;
+  }
+
+  SVgObj *   pVgroup = mnodeGetVgroup(move.vgId);
+  SDnodeObj *pSrcDnode = mnodeGetDnode(move.srcDnodeId);
+  SDnodeObj *pDestDnode = mnodeGetDnode(move.destDnodeId);
+  int32_t    code = TSDB_CODE_MND_DNODE_NOT_EXIST;
+
+  if (pVgroup != NULL && pSrcDnode != NULL && pDestDnode != NULL) {
+    mInfo("vgId:%d, balance from dnode:%d to dnode:%d by load, vnode:%.2f srcLoad:%.2f destLoad:%.2f peak:%.2f:%.2f",
+          pVgroup->vgId, pSrcDnode->dnodeId, pDestDnode->dnodeId, move.cost, move.srcLoad, move.destLoad,
+          move.peakLoad, move.newPeakLoad);
+    code = bnAddVnode(pVgroup, pSrcDnode, pDestDnode);
+  }
+
+  mnodeDecVgroupRef(pVgroup);
+  mnodeDecDnodeRef(pSrcDnode);
+  mnodeDecDnodeRef(pDestDnode);
+
+  return code == TSDB_CODE_SUCCESS;
+}
+
 static bool bnMonitorBalance() {
   if (tsBnDnodes.size < 2) return false;
 
+  // the vnodes of the dropping dnodes are moved out by scores first
+  bool hasDropping = false;
+  for (int32_t i = 0; i < tsBnDnodes.size; ++i) {
+    if (tsBnDnodes.list[i]->status == TAOS_DN_STATUS_DROPPING) hasDropping = true;
+  }
+
+  if (tsEnableBalance != 0 && tsBalanceLoadThreshold > 0 && !hasDropping) {
+    return bnMonitorLoadBalance();
+  }
+
   mDebug("monitor dnodes for balance, avail:%d", tsBnDnodes.size);
   for (int32_t src = tsBnDnodes.size - 1; src >= 0; --src) {
     SDnodeObj *pDnode = tsBnDnodes.list[src];
@@ -594,6 +711,10 @@ void bnCheckModules() {
 }
 
 int32_t bnInit() {
+  mnodeAddShowMetaHandle(TSDB_MGMT_TABLE_BALANCE_PLAN, bnGetPlanMeta);
+  mnodeAddShowRetrieveHandle(TSDB_MGMT_TABLE_BALANCE_PLAN, bnRetrievePlan);
+  mnodeAddShowFreeIterHandle(TSDB_MGMT_TABLE_BALANCE_PLAN, bnFreePlan);
+
   pthread_mutex_init(&tsBnMgmt.mutex, NULL);
   bnInitDnodes();
   bnInitThread();
@@ -726,3 +847,169 @@ int32_t bnAlterDnode(struct SDnodeObj *pSrcDnode, int32_t vnodeId, int32_t dnode
 
   return code;
 }
+
+// the moves planned by load are shown without being done, they start from the current placement of the vnodes. While
+// the balance goes by numbers, the plan shows what a typical threshold would do
+static SBnPlan *bnDryRunPlan() {
+  SBnLoadDnode *dnodes = NULL;
+  SBnLoadVnode *vnodes = NULL;
+  int32_t       numOfDnodes = 0;
+  int32_t       numOfVnodes = 0;
+
+  SBnPlan *pPlan = calloc(1, sizeof(SBnPlan) + BN_MAX_PLAN_MOVES * sizeof(SBnLoadMove));
+  if (pPlan == NULL) return NULL;
+
+  if (bnBuildLoads(&dnodes, &numOfDnodes, &vnodes, &numOfVnodes) == TSDB_CODE_SUCCESS) {
+    float threshold = (tsBalanceLoadThreshold > 0) ? tsBalanceLoadThreshold : BN_PLAN_LOAD_THRESHOLD;
+    pPlan->numOfMoves =
+        bnPlanLoadMoves(dnodes, numOfDnodes, vnodes, numOfVnodes, threshold, pPlan->moves, BN_MAX_PLAN_MOVES);
+    free(dnodes);
+    free(vnodes);
+  }
+
+  return pPlan;
+}
+
+static void bnFreePlan(void *pIter) {
+  free(pIter);
+}
+
+static int32_t bnGetPlanMeta(STableMetaMsg *pMeta, SShowObj *pShow, void *pConn) {
+  SUserObj *pUser = mnodeGetUserFromConn(pConn);
+  if (pUser == NULL) return 0;
+
+  if (strcmp(pUser->pAcct->user, "root") != 0) {
+    mnodeDecUserRef(pUser);
+    return TSDB_CODE_MND_NO_RIGHTS;
+  }
+
+  int32_t  cols = 0;
+  SSchema *pSchema = pMeta->schema;
+
+  pShow->bytes[cols] = 4;
+  pSchema[cols].type = TSDB_DATA_TYPE_INT;
+  strcpy(pSchema[cols].name, "step");
+  pSchema[cols].bytes = htons(pShow->bytes[cols]);
+  cols++;
+
+  pShow->bytes[cols] = 4;
+  pSchema[cols].type = TSDB_DATA_TYPE_INT;
+  strcpy(pSchema[cols].name, "vgId");
+  pSchema[cols].bytes = htons(pShow->bytes[cols]);
+  cols++;
+
+  pShow->bytes[cols] = 2;
+  pSchema[cols].type = TSDB_DATA_TYPE_SMALLINT;
+  strcpy(pSchema[cols].name, "src dnode");
+  pSchema[cols].bytes = htons(pShow->bytes[cols]);
+  cols++;
+
+  pShow->bytes[cols] = 2;
+  pSchema[cols].type = TSDB_DATA_TYPE_SMALLINT;
+  strcpy(pSchema[cols].name, "dest dnode");
+  pSchema[cols].bytes = htons(pShow->bytes[cols]);
+  cols++;
+
+  pShow->bytes[cols] = 4;
+  pSchema[cols].type = TSDB_DATA_TYPE_FLOAT;
+  strcpy(pSchema[cols].name, "vnode load");
+  pSchema[cols].bytes = htons(pShow->bytes[cols]);
+  cols++;
+
+  pShow->bytes[cols] = 4;
+  pSchema[cols].type = TSDB_DATA_TYPE_FLOAT;
+  strcpy(pSchema[cols].name, "src load");
+  pSchema[cols].bytes = htons(pShow->bytes[cols]);
+  cols++;
+
+  pShow->bytes[cols] = 4;
+  pSchema[cols].type = TSDB_DATA_TYPE_FLOAT;
+  strcpy(pSchema[cols].name, "dest load");
+  pSchema[cols].bytes = htons(pShow->bytes[cols]);
+  cols++;
+
+  pShow->bytes[cols] = 4;
+  pSchema[cols].type = TSDB_DATA_TYPE_FLOAT;
+  strcpy(pSchema[cols].name, "peak load");
+  pSchema[cols].bytes = htons(pShow->bytes[cols]);
+  cols++;
+
+  pShow->bytes[cols] = 4;
+  pSchema[cols].type = TSDB_DATA_TYPE_FLOAT;
+  strcpy(pSchema[cols].name, "new peak load");
+  pSchema[cols].bytes = htons(pShow->bytes[cols]);
+  cols++;
+
+  pMeta->numOfColumns = htons(cols);
+  pShow->numOfColumns = cols;
+
+  pShow->offset[0] = 0;
+  for (int32_t i = 1; i < cols; ++i) {
+    pShow->offset[i] = pShow->offset[i - 1] + pShow->bytes[i - 1];
+  }
+
+  SBnPlan *pPlan = bnDryRunPlan();
+  pShow->numOfRows = (pPlan != NULL) ? pPlan->numOfMoves : 0;
+  pShow->rowSize = pShow->offset[cols - 1] + pShow->bytes[cols - 1];
+  pShow->pIter = pPlan;
+
+  mnodeDecUserRef(pUser);
+
+  return 0;
+}
+
+static int32_t bnRetrievePlan(SShowObj *pShow, char *data, int32_t rows, void *pConn) {
+  SBnPlan *pPlan = pShow->pIter;
+  int32_t  numOfRows = 0;
+  char *   pWrite;
+  int32_t  cols = 0;
+
+  while (pPlan != NULL && numOfRows < rows && pShow->numOfReads + numOfRows < pPlan->numOfMoves) {
+    int32_t      step = pShow->numOfReads + numOfRows;
+    SBnLoadMove *pMove = &pPlan->moves[step];
+
+    cols = 0;
+
+    pWrite = data + pShow->offset[cols] * rows + pShow->bytes[cols] * numOfRows;
+    *(int32_t *)pWrite = step + 1;
+    cols++;
+
+    pWrite = data + pShow->offset[cols] * rows + pShow->bytes[cols] * numOfRows;
+    *(int32_t *)pWrite = pMove->vgId;
+    cols++;
+
+    pWrite = data + pShow->offset[cols] * rows + pShow->bytes[cols] * numOfRows;
+    *(int16_t *)pWrite = (int16_t)pMove->srcDnodeId;
+    cols++;
+
+    pWrite = data + pShow->offset[cols] * rows + pShow->bytes[cols] * numOfRows;
+    *(int16_t *)pWrite = (int16_t)pMove->destDnodeId;
+    cols++;
+
+    pWrite = data + pShow->offset[cols] * rows + pShow->bytes[cols] * numOfRows;
+    *(float *)pWrite = pMove->cost;
+    cols++;
+
+    pWrite = data + pShow->offset[cols] * rows + pShow->bytes[cols] * numOfRows;
+    *(float *)pWrite = pMove->srcLoad;
+    cols++;
+
+    pWrite = data + pShow->offset[cols] * rows + pShow->bytes[cols] * numOfRows;
+    *(float *)pWrite = pMove->destLoad;
+    cols++;
+
+    pWrite = data + pShow->offset[cols] * rows + pShow->bytes[cols] * numOfRows;
+    *(float *)pWrite = pMove->peakLoad;
+    cols++;
+
+    pWrite = data + pShow->offset[cols] * rows + pShow->bytes[cols] * numOfRows;
+    *(float *)pWrite = pMove->newPeakLoad;
+    cols++;
+
+    numOfRows++;
+  }
+
+  mnodeVacuumResult(data, pShow->numOfColumns, numOfRows, rows, pShow);
+  pShow->numOfReads += numOfRows;
+  return numOfRows;
+}
@@ -0,0 +1,314 @@
+#include "os.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "bnLoad.h"
+
+/*
+ * A simulator which replays the load profiles recorded from a cluster, and balances the vnodes by the planner of the
+ * mnode after every sample. A profile is made of lines:
+ *
+ *   dnode <dnodeId> <cores>
+ *   vgroup <vgId> <dnodeId>[,<dnodeId>...]     the initial dnodes of the replicas
+ *   epoch                                       starts a sample of the rates
+ *   load <vgId> <write bytes/s> <write rows/s> <query us/s> <disk bytes>
+ *
+ * The load of a vgroup is kept until it is sampled again, and its query time is shared by the replicas. A profile
+ * file is replayed by 'balanceTest <profile>'.
+ */
+namespace {
+const char *profilePath = NULL;
+
+typedef struct {
+  int64_t writeBytesRate;
+  int64_t writeRowsRate;
+  int64_t queryTimeRate;
+  int64_t diskUsed;
+} SVgroupLoad;
+
+typedef struct {
+  int32_t            numOfMoves;
+  int32_t            maxEpochMoves;
+  std::vector<float> peaks;  // peak dnode load after balanced, of every epoch
+  std::vector<float> ideal;  // the total load shared by all cores, of every epoch
+} SSimResult;
+
+class SBnSimulator {
+ public:
+  std::vector<SBnLoadDnode>     dnodes;
+  std::vector<SBnLoadVnode>     vnodes;
+  std::map<int32_t, SVgroupLoad> loads;
+
+  void addDnode(int32_t dnodeId, int32_t numOfCores) {
+    SBnLoadDnode dnode = {0};
+    dnode.dnodeId = dnodeId;
+    dnode.numOfCores = numOfCores;
+    dnode.online = true;
+    dnode.avail = true;
+    dnodes.push_back(dnode);
+  }
+
+  void addVgroup(int32_t vgId, const std::vector<int32_t> &dnodeIds) {
+    for (size_t i = 0; i < dnodeIds.size(); ++i) {
+      SBnLoadVnode vnode = {0};
+      vnode.vgId = vgId;
+      vnode.dnodeId = dnodeIds[i];
+      vnodes.push_back(vnode);
+    }
+  }
+
+  void setLoads() {
+    for (size_t v = 0; v < vnodes.size(); ++v) {
+      SBnLoadVnode *pVnode = &vnodes[v];
+      SVgroupLoad & load = loads[pVnode->vgId];
+      pVnode->writeBytesRate = load.writeBytesRate;
+      pVnode->writeRowsRate = load.writeRowsRate;
+      pVnode->queryTimeRate = load.queryTimeRate / numOfReplicas(pVnode->vgId);
+      pVnode->diskUsed = load.diskUsed;
+    }
+  }
+
+  int32_t numOfReplicas(int32_t vgId) {
+    int32_t num = 0;
+    for (size_t v = 0; v < vnodes.size(); ++v) {
+      if (vnodes[v].vgId == vgId) num++;
+    }
+    return num;
+  }
+
+  int32_t numOfVnodes(int32_t dnodeId) {
+    int32_t num = 0;
+    for (size_t v = 0; v < vnodes.size(); ++v) {
+      if (vnodes[v].dnodeId == dnodeId) num++;
+    }
+    return num;
+  }
+
+  float peakLoad() {
+    float peak = 0;
+    for (size_t d = 0; d < dnodes.size(); ++d) peak = std::max(peak, dnodes[d].load);
+    return peak;
+  }
+
+  float idealLoad() {
+    float   total = 0;
+    int32_t cores = 0;
+    for (size_t v = 0; v < vnodes.size(); ++v) total += vnodes[v].cost;
+    for (size_t d = 0; d < dnodes.size(); ++d) cores += dnodes[d].numOfCores;
+    return total / cores;
+  }
+
+  // the balance thread moves one vnode a round, until nothing is planned
+  int32_t balance(float threshold, int32_t maxRounds) {
+    int32_t numOfMoves = 0;
+    for (int32_t round = 0; round < maxRounds; ++round) {
+      SBnLoadMove move = {0};
+      if (bnPlanLoadMoves(&dnodes[0], (int32_t)dnodes.size(), &vnodes[0], (int32_t)vnodes.size(), threshold, &move,
+                          1) == 0) {
+        break;
+      }
+      EXPECT_LT(move.newPeakLoad, move.peakLoad + 0.0001f);
+      EXPECT_TRUE(checkReplicas());
+      numOfMoves++;
+    }
+    bnCalcLoads(&dnodes[0], (int32_t)dnodes.size(), &vnodes[0], (int32_t)vnodes.size());
+    return numOfMoves;
+  }
+
+  bool checkReplicas() {
+    for (size_t i = 0; i < vnodes.size(); ++i) {
+      for (size_t j = i + 1; j < vnodes.size(); ++j) {
+        if (vnodes[i].vgId == vnodes[j].vgId && vnodes[i].dnodeId == vnodes[j].dnodeId) return false;
+      }
+    }
+    return true;
+  }
+};
+
+void replayEpoch(SBnSimulator &sim, float threshold, SSimResult *pResult) {
+  sim.setLoads();
+  int32_t numOfMoves = sim.balance(threshold, 1000);
+  pResult->numOfMoves += numOfMoves;
+  pResult->maxEpochMoves = std::max(pResult->maxEpochMoves, numOfMoves);
+  pResult->peaks.push_back(sim.peakLoad());
+  pResult->ideal.push_back(sim.idealLoad());
+}
+
+void replay(SBnSimulator &sim, std::istream &profile, float threshold, SSimResult *pResult) {
+  std::string line;
+  bool        inEpoch = false;
+
+  while (std::getline(profile, line)) {
+    std::istringstream words(line);
+    std::string        word;
+    if (!(words >> word) || word[0] == '#') continue;
+
+    if (word == "dnode") {
+      int32_t dnodeId = 0, numOfCores = 0;
+      words >> dnodeId >> numOfCores;
+      sim.addDnode(dnodeId, numOfCores);
+    } else if (word == "vgroup") {
+      int32_t              vgId = 0;
+      std::string          list;
+      std::vector<int32_t> dnodeIds;
+      words >> vgId >> list;
+      std::istringstream ids(list);
+      for (std::string id; std::getline(ids, id, ',');) dnodeIds.push_back(atoi(id.c_str()));
+      sim.addVgroup(vgId, dnodeIds);
+    } else if (word == "epoch") {
+      if (inEpoch) replayEpoch(sim, threshold, pResult);
+      inEpoch = true;
+    } else if (word == "load") {
+      int32_t     vgId = 0;
+      SVgroupLoad load = {0};
+      words >> vgId >> load.writeBytesRate >> load.writeRowsRate >> load.queryTimeRate >> load.diskUsed;
+      sim.loads[vgId] = load;
+    }
+  }
+
+  if (inEpoch) replayEpoch(sim, threshold, pResult);
+}
+
+void replay(SBnSimulator &sim, const std::string &profile, float threshold, SSimResult *pResult) {
+  std::istringstream in(profile);
+  replay(sim, in, threshold, pResult);
+}
+
+// nothing measured, the vnodes are balanced by their numbers per core
+void vnodeNumTest() {
+  SBnSimulator sim;
+  SSimResult   result = {0};
+  std::string  profile = "dnode 1 4\ndnode 2 4\ndnode 3 8\n";
+  for (int32_t vgId = 2; vgId < 14; ++vgId) {
+    profile += "vgroup " + std::to_string(vgId) + " 1\n";
+  }
+  profile += "epoch\n";
+
+  replay(sim, profile, 0.1f, &result);
+  ASSERT_EQ(sim.numOfVnodes(1), 3);
+  ASSERT_EQ(sim.numOfVnodes(2), 3);
+  ASSERT_EQ(sim.numOfVnodes(3), 6);
+  ASSERT_FLOAT_EQ(result.peaks[0], 0.75f);
+}
+
+// the hot vgroups are on the same dnode while the numbers of vnodes are balanced
+void hotVgroupsTest() {
+  SBnSimulator sim;
+  SSimResult   result = {0};
+  std::string  profile = "dnode 1 8\ndnode 2 8\ndnode 3 8\ndnode 4 8\n";
+  for (int32_t vgId = 2; vgId < 18; ++vgId) {
+    profile += "vgroup " + std::to_string(vgId) + " " + std::to_string((vgId - 2) / 4 + 1) + "\n";
+  }
+  profile += "epoch\n";
+  for (int32_t vgId = 2; vgId < 18; ++vgId) {
+    bool hot = (vgId < 6);
+    profile += "load " + std::to_string(vgId) + (hot ? " 104857600 1000000 900000" : " 1048576 10000 9000") +
+               " 1073741824\n";
+  }
+
+  replay(sim, profile, 0.1f, &result);
+  ASSERT_GT(result.numOfMoves, 0);
+  ASSERT_LT(result.peaks[0], result.ideal[0] * 1.3f);
+
+  // the hot vgroups are spread to all dnodes
+  for (int32_t dnodeId = 1; dnodeId <= 4; ++dnodeId) {
+    int32_t numOfHot = 0;
+    for (size_t v = 0; v < sim.vnodes.size(); ++v) {
+      if (sim.vnodes[v].dnodeId == dnodeId && sim.vnodes[v].vgId < 6) numOfHot++;
+    }
+    ASSERT_EQ(numOfHot, 1);
+  }
+}
+
+// the replicas of a vgroup are never moved to the same dnode
+void replicaTest() {
+  SBnSimulator sim;
+  SSimResult   result = {0};
+  std::string  profile = "dnode 1 4\ndnode 2 4\ndnode 3 4\ndnode 4 4\ndnode 5 4\n";
+  for (int32_t vgId = 2; vgId < 12; ++vgId) {
+    profile += "vgroup " + std::to_string(vgId) + (vgId % 2 ? " 1,2\n" : " 2,1\n");
+  }
+  profile += "epoch\n";
+  for (int32_t vgId = 2; vgId < 12; ++vgId) {
+    profile += "load " + std::to_string(vgId) + " " + std::to_string(vgId * 1048576) + " 10000 " +
+               std::to_string((12 - vgId) * 10000) + " 1073741824\n";
+  }
+
+  replay(sim, profile, 0.1f, &result);
+  ASSERT_TRUE(sim.checkReplicas());
+  ASSERT_LT(result.peaks[0], result.ideal[0] * 1.5f);
+  for (int32_t vgId = 2; vgId < 12; ++vgId) {
+    ASSERT_EQ(sim.numOfReplicas(vgId), 2);
+  }
+}
+
+// the hot spot moves from vgroup to vgroup, and the rates are noisy
+void shiftingProfileTest() {
+  SBnSimulator sim;
+  SSimResult   result = {0};
+  std::string  profile = "dnode 1 8\ndnode 2 8\ndnode 3 8\n";
+  for (int32_t vgId = 2; vgId < 14; ++vgId) {
+    profile += "vgroup " + std::to_string(vgId) + " " + std::to_string((vgId - 2) % 3 + 1) + "\n";
+  }
+
+  srand(1);
+  for (int32_t epoch = 0; epoch < 20; ++epoch) {
+    profile += "epoch\n";
+    int32_t hot = 2 + (epoch / 5) * 3;
+    for (int32_t vgId = 2; vgId < 14; ++vgId) {
+      int64_t noise = 95 + rand() % 11;
+      int64_t rate = (vgId == hot || vgId == hot + 3) ? 50 * noise : noise;
+      profile += "load " + std::to_string(vgId) + " " + std::to_string(rate * 1048576) + " " +
+                 std::to_string(rate * 10000) + " " + std::to_string(rate * 1000) + " 1073741824\n";
+    }
+  }
+
+  replay(sim, profile, 0.2f, &result);
+  ASSERT_EQ(result.peaks.size(), 20u);
+  for (size_t i = 0; i < result.peaks.size(); ++i) {
+    ASSERT_LT(result.peaks[i], result.ideal[i] * 1.6f);
+  }
+
+  // the noise moves nothing, the vnodes are only moved when the hot spot moves
+  ASSERT_LE(result.numOfMoves, 4 * 4);
+  std::cout << "shifting profile, moves:" << result.numOfMoves << " max moves of an epoch:" << result.maxEpochMoves
+            << std::endl;
+}
+
+void profileFileTest() {
+  if (profilePath == NULL) return;
+
+  std::ifstream in(profilePath);
+  ASSERT_TRUE(in.good());
+
+  SBnSimulator sim;
+  SSimResult   result = {0};
+  replay(sim, in, 0.2f, &result);
+  ASSERT_TRUE(sim.checkReplicas());
+
+  for (size_t i = 0; i < result.peaks.size(); ++i) {
+    std::cout << "epoch:" << i << " peak load:" << result.peaks[i] << " ideal load:" << result.ideal[i] << std::endl;
+  }
+  std::cout << "moves:" << result.numOfMoves << " max moves of an epoch:" << result.maxEpochMoves << std::endl;
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  if (argc > 1) profilePath = argv[1];
+  return RUN_ALL_TESTS();
+}
+
+TEST(testCase, balanceLoadTest) {
+  vnodeNumTest();
+  hotVgroupsTest();
+  replicaTest();
+  shiftingProfileTest();
+  profileFileTest();
+}
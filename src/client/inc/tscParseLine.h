@@ -81,6 +81,10 @@ int32_t convertSmlTimeStamp(TAOS_SML_KV *pVal, char *value,
 
 void destroySmlDataPoint(TAOS_SML_DATA_POINT* point);
 
+typedef int32_t (*__sml_parse_line_fn_t)(const char* line, TAOS_SML_DATA_POINT* smlData, SSmlLinesInfo* info);
+int32_t smlParseLinesInParallel(char* lines[], int numLines, SArray* points, SSmlLinesInfo* info,
+                                __sml_parse_line_fn_t fp);
+
 int taos_insert_lines(TAOS* taos, char* lines[], int numLines, SMLProtocolType protocol,
                       SMLTimeStampType tsType, int* affectedRows);
 int taos_insert_telnet_lines(TAOS* taos, char* lines[], int numLines, SMLProtocolType protocol,
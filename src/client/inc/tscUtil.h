@@ -137,6 +137,7 @@ void    tscDestroyDataBlock(SSqlObj *pSql, STableDataBlocks* pDataBlock, bool re
 void    tscSortRemoveDataBlockDupRowsRaw(STableDataBlocks* dataBuf);
 int     tscSortRemoveDataBlockDupRows(STableDataBlocks* dataBuf, SBlockKeyInfo* pBlkKeyInfo);
 int32_t tsSetBlockInfo(SSubmitBlk *pBlocks, const STableMeta *pTableMeta, int32_t numOfRows);
+int32_t tsCheckTimestamp(STableDataBlocks *pDataBlocks, const char *start);
 
 void tscDestroyBoundColumnInfo(SParsedDataColInfo* pColInfo);
 void doRetrieveSubqueryData(SSchedMsg *pMsg);
@@ -290,6 +291,7 @@ STableMetaInfo* tscGetMetaInfo(SQueryInfo *pQueryInfo, int32_t tableIndex);
 void        tscInitQueryInfo(SQueryInfo* pQueryInfo);
 void        tscClearSubqueryInfo(SSqlCmd* pCmd);
 int32_t     tscAddQueryInfo(SSqlCmd *pCmd);
+int32_t     tscQueryInfoCopy(SQueryInfo* pQueryInfo, const SQueryInfo* pSrc);
 SQueryInfo *tscGetQueryInfo(SSqlCmd* pCmd);
 SQueryInfo *tscGetQueryInfoS(SSqlCmd *pCmd);
 
@@ -362,7 +364,8 @@ void tscFreeQueryInfo(SSqlCmd* pCmd, bool removeCachedMeta, uint64_t id);
 void tscTryQueryNextVnode(SSqlObj *pSql, __async_cb_func_t fp);
 void tscTryQueryNextClause(SSqlObj* pSql, __async_cb_func_t fp);
 int  tscSetMgmtEpSetFromCfg(const char *first, const char *second, SRpcCorEpSet *corEpSet);
-int32_t getMultiTableMetaFromMnode(SSqlObj *pSql, SArray* pNameList, SArray* pVgroupNameList, SArray* pUdfList, __async_cb_func_t fp, bool metaClone);
+int32_t getMultiTableMetaFromMnode(SSqlObj *pSql, SArray* pNameList, SArray* pVgroupNameList, SArray* pUdfList, __async_cb_func_t fp, bool metaClone, bool skipMissing);
+void    tscFinishPendingTableMeta(SSqlObj *pSql);
 
 int tscTransferTableNameList(SSqlObj *pSql, const char *pNameList, int32_t length, SArray* pNameArray);
 
@@ -378,6 +381,11 @@ int32_t copyTagData(STagData* dst, const STagData* src);
 STableMeta* createSuperTableMeta(STableMetaMsg* pChild);
 uint32_t tscGetTableMetaSize(STableMeta* pTableMeta);
 CChildTableMeta* tscCreateChildMeta(STableMeta* pTableMeta);
+void        tscAddSTableNameToCache(SSqlObj *pSql, uint64_t suid, const char* name);
+void        tscRemoveSTableNameFromCache(SSqlObj *pSql, uint64_t suid);
+// same as taosHashGetCloneExt on the table meta cache, the compact record of a child table is expanded to STableMeta
+STableMeta* tscGetTableMetaFromCache(SSqlObj *pSql, const char* name, size_t len, STableMeta** ppMeta, size_t* pCapacity);
+void        tscEvictTableMetaCache(SSqlObj *pSql, int64_t bytes);
 uint32_t tscGetTableMetaMaxSize();
 int32_t tscCreateTableMetaFromSTableMeta(SSqlObj *pSql, STableMeta** ppChild, const char* name, size_t *tableMetaCapacity, STableMeta **ppStable);
 STableMeta* tscTableMetaDup(STableMeta* pTableMeta);
@@ -57,11 +57,12 @@ typedef struct SNewVgroupInfo {
   SEpAddrMsg ep[TSDB_MAX_REPLICA];
 } SNewVgroupInfo;
 
+// the compact record of a child table in the table meta cache, the schema is kept in the super table meta, and the
+// name of the super table in SClusterInfo::stableNameMap
 typedef struct CChildTableMeta {
   int32_t        vgId;
   STableId       id;
   uint8_t        tableType;
-  char           sTableName[TSDB_TABLE_FNAME_LEN];  // TODO: refactor super table name, not full name
   uint64_t       suid;                              // super table id
 } CChildTableMeta;
 
@@ -146,6 +147,12 @@ typedef struct {
   void *vgroupMap;  
   void *tableMetaMap;
   void *vgroupListBuf; 
+  void *stableNameMap;    // uid of the super table -> full name, of the child tables cached
+  void *pendingMetaMap;   // full name -> SPendingTableMeta, of the table meta being retrieved from mnode
+  pthread_mutex_t pendingMetaLock;
+  int32_t evicting;
+  int64_t metaBytes;      // of the metas put into tableMetaMap, not subtracted when removed but recounted by eviction
+  int64_t evictSize;      // evicted above it instead of the limit, once the metas kept alone exceed the limit
   int64_t ref;
 } SClusterInfo;
 
@@ -261,6 +268,10 @@ typedef struct SInsertStatementParam {
   uint32_t     insertType;              // insert data from [file|sql statement| bound statement]
   uint64_t     objectId;                // sql object id
   char        *sql;                     // current sql statement position
+
+  SArray      *pCreateNames;            // SArray<char*>, names of the tables to create in batch before parsing
+  SArray      *pCreateClauses;          // SArray<char*>, USING clauses of the tables above
+  int32_t      numOfCreateSent;         // number of the tables above sent to create
 } SInsertStatementParam;
 
 typedef enum {
@@ -271,6 +282,18 @@ typedef enum {
 #define IS_RAW_PAYLOAD(t) \
   (((int)(t)) == PAYLOAD_TYPE_RAW)  // 0: K-V payload for non-prepare insert, 1: rawPayload for prepare insert
 
+/*
+ * The query message of a prepared statement. It is built once, and only the time window and the sql string are
+ * patched for each execution.
+ */
+typedef struct SQueryMsgTemplate {
+  int32_t len;
+  int32_t tableIdOffset;  // STableIdInfo of the queried table
+  int32_t sqlOffset;
+  int32_t sqlLen;
+  char    msg[];
+} SQueryMsgTemplate;
+
 // TODO extract sql parser supporter
 typedef struct {
   int     command;
@@ -292,6 +315,10 @@ typedef struct {
   SQueryInfo  *active;         // current active query info
   int32_t      batchSize;      // for parameter ('?') binding and batch processing
   int32_t      resColumnId;
+
+  int32_t            tableIdOffset;  // layout of the query message in payload, to create the message template
+  int32_t            sqlOffset;
+  SQueryMsgTemplate *pMsgTemplate;   // the query message is built from it instead of the query info if not NULL
 } SSqlCmd;
 
 typedef struct {
@@ -318,6 +345,8 @@ typedef struct {
   SColumnIndex*  pColumnIndex;
 
   TAOS_FIELD*    final;
+  TAOS_COLUMN*   columns;  // columns of current block returned by taos_fetch_columns
+  int8_t*        isNull;   // null flags of the columns
   struct SGlobalMerger *pMerger;
 } SSqlRes;
 
@@ -358,6 +387,21 @@ typedef struct SSubqueryState {
   uint64_t numOfRetrievedRows;  // total number of points in this query
 } SSubqueryState;
 
+// state of the fetch request sent before the application asks for the next block
+enum {
+  TSC_FETCH_AHEAD_NONE      = 0,
+  TSC_FETCH_AHEAD_INFLIGHT  = 1,  // no one is waiting for the response yet, it is kept when it arrives
+  TSC_FETCH_AHEAD_CLAIMED   = 2,  // the application is waiting for the response, it is processed as usual
+  TSC_FETCH_AHEAD_ABANDONED = 3,  // the result is freed, the response is dropped
+};
+
+typedef struct SFetchAhead {
+  SRWLatch latch;
+  int8_t   state;     // of the fetch request in flight, at most one for a query
+  int8_t   sending;   // the fetch request is being built and sent, the payload is in use
+  SArray  *pRspList;  // SArray<SRpcMsg>, responses kept in the order of the blocks
+} SFetchAhead;
+
 typedef struct SSqlObj {
   void            *signature;
   int64_t          owner;        // owner of sql object, by which it is executed
@@ -376,6 +420,7 @@ typedef struct SSqlObj {
   char             parseRetry;
   char             retry;
   char             maxRetry;
+  char             flowCtrlRetry;  // the resends in flow control, apart from the retries of the epset
   SRpcEpSet        epSet;
   char             listed;
   tsem_t           rspSem;
@@ -391,6 +436,7 @@ typedef struct SSqlObj {
 
   int64_t          squeryLock;
   int32_t          retryReason;  // previous error code
+  SFetchAhead      fetchAhead;
   struct SSqlObj  *prev, *next;
   int64_t          self;
 } SSqlObj;
@@ -423,6 +469,8 @@ typedef struct SSqlStream {
   SInterval interval;
   void *  pTimer;
 
+  struct SStreamIncr *pIncr;  // partial results of the panes, NULL if every window is queried again
+
   void (*fp)();
   void *param;
 
@@ -442,6 +490,12 @@ void tscReleaseClusterInfo(const char *clusterId);
 int tsParseSql(SSqlObj *pSql, bool initial);
 
 void tscProcessMsgFromServer(SRpcMsg *rpcMsg, SRpcEpSet *pEpSet);
+void tscProcessFetchAheadRsp(SRpcMsg *rpcMsg);
+SQueryMsgTemplate *tscCreateQueryMsgTemplate(SSqlObj *pSql);
+void tscFetchNextBlockAhead(SSqlObj *pSql);
+bool tscTakeFetchAheadRsp(SSqlObj *pSql, SRpcMsg *pRspMsg);
+bool tscUseFetchAheadRsp(SSqlObj *pSql);
+void tscDiscardFetchAheadRsp(SSqlObj *pSql);
 int  tscBuildAndSendRequest(SSqlObj *pSql, SQueryInfo* pQueryInfo);
 
 int  tscRenewTableMeta(SSqlObj *pSql);
@@ -461,6 +515,7 @@ void tscSetResRawPtrRv(SSqlRes* pRes, SQueryInfo* pQueryInfo, SSDataBlock* pBloc
 
 void handleDownstreamOperator(SSqlObj** pSqlList, int32_t numOfUpstream, SQueryInfo* px, SSqlObj* pParent);
 void destroyTableNameList(SInsertStatementParam* pInsertParam);
+void destroyCreateTableList(SInsertStatementParam* pInsertParam);
 
 void tscResetSqlCmd(SSqlCmd *pCmd, bool removeMeta, uint64_t id);
 
@@ -490,6 +545,8 @@ TAOS_RES* taos_query_h(TAOS* taos, const char *sqlstr, int64_t* res);
 TAOS_RES * taos_query_ra(TAOS *taos, const char *sqlstr, __async_cb_func_t fp, void *param);
 // get taos connection unused session number
 int32_t taos_unused_session(TAOS* taos);
+// load the meta of tables given by their full names (db.table, names are case sensitive) into the local cache
+int32_t tscLoadMultiTableMeta(TAOS *taos, SArray *pNameList);
 
 void waitForQueryRsp(void *param, TAOS_RES *tres, int code);
 
@@ -157,6 +157,8 @@ static void tscAsyncFetchRowsProxy(void *param, TAOS_RES *tres, int numOfRows) {
     pRes->numOfClauseTotal += pRes->numOfRows;
   }
 
+  // request the next block while this one is being consumed by the application
+  tscFetchNextBlockAhead(pSql);
   (*pSql->fetchFp)(param, tres, numOfRows);
 }
 
@@ -207,6 +209,41 @@ static void tscAsyncQueryRowsForNextVnode(void *param, TAOS_RES *tres, int numOf
   tscProcessAsyncRetrieveImpl(param, tres, numOfRows, tscAsyncFetchRowsProxy);
 }
 
+static void tscProcessFetchAheadTask(SSchedMsg *pSchedMsg) {
+  tscProcessFetchAheadRsp(pSchedMsg->msg);
+  tfree(pSchedMsg->msg);
+}
+
+/*
+ * The next block has been requested ahead. If its response has arrived, it is processed in the task queue as if it
+ * just arrived, otherwise it is processed when it arrives.
+ */
+bool tscUseFetchAheadRsp(SSqlObj *pSql) {
+  SRpcMsg rspMsg;
+  if (!tscTakeFetchAheadRsp(pSql, &rspMsg)) {
+    return false;
+  }
+
+  // the application waits for the request in flight
+  if (rspMsg.pCont == NULL) {
+    return true;
+  }
+
+  SRpcMsg *pMsg = malloc(sizeof(SRpcMsg));
+  if (pMsg == NULL) {
+    tscProcessFetchAheadRsp(&rspMsg);
+    return true;
+  }
+
+  *pMsg = rspMsg;
+
+  SSchedMsg schedMsg = {0};
+  schedMsg.fp  = tscProcessFetchAheadTask;
+  schedMsg.msg = pMsg;
+  taosScheduleTask(tscQhandle, &schedMsg);
+  return true;
+}
+
 void taos_fetch_rows_a(TAOS_RES *tres, __async_cb_func_t fp, void *param) {
   SSqlObj *pSql = (SSqlObj *)tres;
   if (pSql == NULL || pSql->signature != pSql) {
@@ -280,6 +317,10 @@ void taos_fetch_rows_a(TAOS_RES *tres, __async_cb_func_t fp, void *param) {
       pCmd->command = (pCmd->command > TSDB_SQL_MGMT) ? TSDB_SQL_RETRIEVE : TSDB_SQL_FETCH;
     }
 
+    if (tscUseFetchAheadRsp(pSql)) {
+      return;
+    }
+
     SQueryInfo* pQueryInfo1 = tscGetQueryInfo(&pSql->cmd);
     tscBuildAndSendRequest(pSql, pQueryInfo1);
   }
@@ -353,7 +394,7 @@ void tscTableMetaCallBack(void *param, TAOS_RES *res, int code) {
   pRes->code = code;
 
   SSqlObj *sub = (SSqlObj*) res;
-  const char* msg = (sub->cmd.command == TSDB_SQL_STABLEVGROUP)? "vgroup-list":"multi-tableMeta";
+  const char* msg = (sub != NULL && sub->cmd.command == TSDB_SQL_STABLEVGROUP)? "vgroup-list":"multi-tableMeta";
   if (code != TSDB_CODE_SUCCESS) {
     tscError("0x%"PRIx64" get %s failed, code:%s", pSql->self, msg, tstrerror(code));
     if (code == TSDB_CODE_RPC_FQDN_ERROR) {
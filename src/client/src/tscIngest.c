@@ -0,0 +1,742 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Ingest pipeline: the insert statements written by the application are parsed by the parser threads of the pipeline,
+ * and the submit blocks of each vgroup are merged across statements into one submit message, which is sent once it
+ * reaches ingestBatchSize or is kept for ingestFlushInterval. At most ingestMaxInflight submit messages of a vgroup
+ * wait for the response, the parser threads wait for them otherwise, and so does the application when the statement
+ * queue is full.
+ *
+ * The statements whose tables are not in the meta cache are executed one by one by the parser threads, which fetch
+ * the meta for the following statements. When a merged submit message fails, the statements which have rows in it are
+ * executed again one by one, and the rows already inserted by the other submit messages are inserted again, which
+ * makes no difference to the database.
+ */
+
+#include "os.h"
+#include "taos.h"
+#include "tglobal.h"
+#include "tsclient.h"
+#include "tscLog.h"
+#include "tscUtil.h"
+#include "tscSubquery.h"
+
+#define INGEST_QUEUE_SIZE   256
+#define INGEST_MAX_BYTES    (TSDB_MAX_WAL_SIZE / 3 * 2)
+#define INGEST_HEAD_SIZE    (sizeof(SMsgDesc) + sizeof(SSubmitMsg))
+
+typedef struct SIngestStmt {
+  int32_t ref;  // the statement is kept by the submit messages having its rows, in case they fail
+  char    sql[];
+} SIngestStmt;
+
+typedef struct SIngestBatch {
+  struct SIngest   *pIngest;
+  struct SIngestVgroup *pVgroup;
+  STableDataBlocks *pBlocks;  // [SMsgDesc|SSubmitMsg|SSubmitBlk...] of the vgroup
+  int32_t           numOfRows;
+  int64_t           stime;    // ms, the time the first statement is merged
+  SArray           *pStmts;   // SArray<SIngestStmt*>
+} SIngestBatch;
+
+typedef struct SIngestVgroup {
+  int32_t       vgId;
+  int32_t       inflight;
+  SIngestBatch *pBatch;       // the submit message being merged
+} SIngestVgroup;
+
+typedef struct SIngest {
+  void            *signature;
+  STscObj         *pObj;
+  pthread_mutex_t  mutex;
+  pthread_cond_t   cond;      // broadcast on any change of the states below
+  SIngestStmt    **queue;     // statements to be parsed
+  int32_t          head;
+  int32_t          num;
+  SArray          *pRetry;    // SArray<SIngestStmt*>, statements of the failed submit messages
+  SArray          *pFreeList; // SArray<SSqlObj*>, submit objects freed by the parser threads, not by their callback
+  SHashObj        *pVgroups;  // vgId -> SIngestVgroup*
+  int32_t          numOfBusy; // statements being parsed or executed
+  int32_t          inflight;
+  int32_t          flushing;
+  bool             closing;
+  int32_t          numOfThreads;
+  pthread_t       *threads;
+  int32_t          maxBytes;
+  int64_t          firstTime;  // us
+  int64_t          lastTime;   // us
+  TAOS_INGEST_STAT stat;
+} SIngest;
+
+static void ingestReleaseStmt(SIngestStmt *pStmt) {
+  if (--pStmt->ref == 0) {
+    free(pStmt);
+  }
+}
+
+static void ingestDestroyBatch(SIngestBatch *pBatch) {
+  for (int32_t i = 0; i < taosArrayGetSize(pBatch->pStmts); ++i) {
+    ingestReleaseStmt(taosArrayGetP(pBatch->pStmts, i));
+  }
+
+  taosArrayDestroy(&pBatch->pStmts);
+  tscDestroyDataBlock(NULL, pBatch->pBlocks, false);
+  free(pBatch);
+}
+
+static void ingestSetError(SIngest *pIngest, int32_t code) {
+  if (pIngest->stat.code == TSDB_CODE_SUCCESS) {
+    pIngest->stat.code = code;
+  }
+}
+
+static void ingestFreeSubmitObjs(SIngest *pIngest) {
+  pthread_mutex_lock(&pIngest->mutex);
+  SArray *pList = pIngest->pFreeList;
+  pIngest->pFreeList = taosArrayInit(4, POINTER_BYTES);
+  pthread_mutex_unlock(&pIngest->mutex);
+
+  for (int32_t i = 0; i < taosArrayGetSize(pList); ++i) {
+    taos_free_result(taosArrayGetP(pList, i));
+  }
+  taosArrayDestroy(&pList);
+}
+
+static bool ingestBatchIsReady(SIngest *pIngest, SIngestVgroup *pVgroup, int64_t now) {
+  SIngestBatch *pBatch = pVgroup->pBatch;
+  if (pBatch == NULL || pVgroup->inflight >= tsIngestMaxInflight) {
+    return false;
+  }
+
+  return pIngest->flushing > 0 || pIngest->closing || pBatch->pBlocks->size >= pIngest->maxBytes ||
+         now - pBatch->stime >= tsIngestFlushInterval;
+}
+
+// take the submit message out of the vgroup if it is ready to be sent, with the mutex locked
+static SIngestBatch *ingestTakeBatch(SIngest *pIngest, SIngestVgroup *pVgroup, int64_t now) {
+  if (!ingestBatchIsReady(pIngest, pVgroup, now)) {
+    return NULL;
+  }
+
+  SIngestBatch *pBatch = pVgroup->pBatch;
+  pVgroup->pBatch = NULL;
+  pVgroup->inflight += 1;
+  pIngest->inflight += 1;
+
+  pIngest->stat.submits += 1;
+  pIngest->stat.submitRows += pBatch->numOfRows;
+  pIngest->stat.submitBytes += pBatch->pBlocks->size;
+  if (pBatch->numOfRows > pIngest->stat.maxSubmitRows) {
+    pIngest->stat.maxSubmitRows = pBatch->numOfRows;
+  }
+
+  return pBatch;
+}
+
+static void ingestSubmitCallback(void *param, TAOS_RES *tres, int numOfRows);
+
+static void ingestSendBatch(SIngest *pIngest, SIngestBatch *pBatch) {
+  int32_t  code = TSDB_CODE_TSC_OUT_OF_MEMORY;
+  SSqlObj *pSql = calloc(1, sizeof(SSqlObj));
+
+  if (pSql != NULL && tscAllocPayload(&pSql->cmd, TSDB_DEFAULT_PAYLOAD_SIZE) == TSDB_CODE_SUCCESS) {
+    tsem_init(&pSql->rspSem, 0, 0);
+    pSql->signature = pSql;
+    pSql->pTscObj   = pIngest->pObj;
+    pSql->rootObj   = pSql;
+    pSql->param     = pBatch;
+    pSql->fp        = ingestSubmitCallback;
+    pSql->fetchFp   = ingestSubmitCallback;
+    pSql->maxRetry  = TSDB_MAX_REPLICA;
+    pSql->retry     = pSql->maxRetry + 1;  // no sql to re-parse, the statements are executed again by the parser threads
+
+    SSqlCmd *pCmd = &pSql->cmd;
+    pCmd->command = TSDB_SQL_INSERT;
+
+    // the sub objects of the multi-vnode insertion copy the name of the first table meta info
+    SQueryInfo *pQueryInfo = tscGetQueryInfoS(pCmd);
+    pCmd->insertParam.pDataBlocks = taosArrayInit(1, POINTER_BYTES);
+    if (pQueryInfo != NULL && pCmd->insertParam.pDataBlocks != NULL && tscAddEmptyMetaInfo(pQueryInfo) != NULL) {
+      TSDB_QUERY_SET_TYPE(pQueryInfo->type, TSDB_QUERY_TYPE_INSERT);
+      registerSqlObj(pSql);
+      pCmd->insertParam.objectId = pSql->self;
+
+      taosArrayPush(pCmd->insertParam.pDataBlocks, &pBatch->pBlocks);
+      pBatch->pBlocks = NULL;
+
+      tscDebug("0x%" PRIx64 " ingest:%p submit %d rows of %d statements to vgId:%d", pSql->self, pIngest,
+               pBatch->numOfRows, (int32_t)taosArrayGetSize(pBatch->pStmts), pBatch->pVgroup->vgId);
+      code = tscHandleMultivnodeInsert(pSql);
+    }
+  } else {
+    tfree(pSql);
+  }
+
+  if (code != TSDB_CODE_SUCCESS) {
+    if (pSql != NULL && pSql->self != 0) {
+      pSql->res.code = code;
+      ingestSubmitCallback(pBatch, pSql, code);
+    } else {
+      // not registered, so it is freed here instead of by taos_free_result
+      tscFreeSqlObj(pSql);
+      ingestSubmitCallback(pBatch, NULL, code);
+    }
+  }
+}
+
+static void ingestSubmitCallback(void *param, TAOS_RES *tres, int numOfRows) {
+  SIngestBatch  *pBatch = param;
+  SIngest       *pIngest = pBatch->pIngest;
+  SIngestVgroup *pVgroup = pBatch->pVgroup;
+  int32_t        code = (tres == NULL) ? numOfRows : taos_errno(tres);
+
+  pthread_mutex_lock(&pIngest->mutex);
+
+  pVgroup->inflight -= 1;
+  pIngest->inflight -= 1;
+
+  if (code == TSDB_CODE_SUCCESS) {
+    pIngest->stat.rows += numOfRows;
+    pIngest->lastTime = taosGetTimestampUs();
+  } else {
+    tscWarn("ingest:%p failed to submit %d rows to vgId:%d, %d statements are executed again, code:%s", pIngest,
+            pBatch->numOfRows, pVgroup->vgId, (int32_t)taosArrayGetSize(pBatch->pStmts), tstrerror(code));
+    for (int32_t i = 0; i < taosArrayGetSize(pBatch->pStmts); ++i) {
+      SIngestStmt *pStmt = taosArrayGetP(pBatch->pStmts, i);
+      pStmt->ref += 1;
+      taosArrayPush(pIngest->pRetry, &pStmt);
+    }
+  }
+
+  if (tres != NULL) {
+    taosArrayPush(pIngest->pFreeList, &tres);
+  }
+
+  ingestDestroyBatch(pBatch);
+
+  // the next submit message of the vgroup may be waiting for this one
+  SIngestBatch *pNext = ingestTakeBatch(pIngest, pVgroup, taosGetTimestampMs());
+  pthread_cond_broadcast(&pIngest->cond);
+  pthread_mutex_unlock(&pIngest->mutex);
+
+  if (pNext != NULL) {
+    ingestSendBatch(pIngest, pNext);
+  }
+}
+
+// send the submit messages ready to be sent, with the mutex locked
+static void ingestSendReadyBatches(SIngest *pIngest) {
+  int64_t now = taosGetTimestampMs();
+  SArray *pReady = NULL;
+
+  SIngestVgroup **ppVgroup = taosHashIterate(pIngest->pVgroups, NULL);
+  while (ppVgroup != NULL) {
+    SIngestBatch *pBatch = ingestTakeBatch(pIngest, *ppVgroup, now);
+    if (pBatch != NULL) {
+      if (pReady == NULL) {
+        pReady = taosArrayInit(4, POINTER_BYTES);
+      }
+      taosArrayPush(pReady, &pBatch);
+    }
+    ppVgroup = taosHashIterate(pIngest->pVgroups, ppVgroup);
+  }
+
+  if (pReady == NULL) {
+    return;
+  }
+
+  pthread_mutex_unlock(&pIngest->mutex);
+  for (int32_t i = 0; i < taosArrayGetSize(pReady); ++i) {
+    ingestSendBatch(pIngest, taosArrayGetP(pReady, i));
+  }
+  pthread_mutex_lock(&pIngest->mutex);
+
+  taosArrayDestroy(&pReady);
+}
+
+static SIngestVgroup *ingestGetVgroup(SIngest *pIngest, int32_t vgId) {
+  SIngestVgroup **ppVgroup = taosHashGet(pIngest->pVgroups, &vgId, sizeof(vgId));
+  if (ppVgroup != NULL) {
+    return *ppVgroup;
+  }
+
+  SIngestVgroup *pVgroup = calloc(1, sizeof(SIngestVgroup));
+  if (pVgroup == NULL) {
+    return NULL;
+  }
+
+  pVgroup->vgId = vgId;
+  taosHashPut(pIngest->pVgroups, &vgId, sizeof(vgId), &pVgroup, POINTER_BYTES);
+  return pVgroup;
+}
+
+static int32_t ingestGetNumOfRows(STableDataBlocks *pBlocks) {
+  int32_t numOfRows = 0;
+  char   *p = pBlocks->pData + INGEST_HEAD_SIZE;
+
+  for (int32_t i = 0; i < pBlocks->numOfTables; ++i) {
+    SSubmitBlk *pBlk = (SSubmitBlk *)p;
+    numOfRows += htons(pBlk->numOfRows);
+    p += sizeof(SSubmitBlk) + htonl(pBlk->dataLen) + htonl(pBlk->schemaLen);
+  }
+
+  return numOfRows;
+}
+
+// merge the submit blocks of a vgroup into the submit message being merged, the blocks are freed
+static int32_t ingestMergeBlocks(SIngest *pIngest, SIngestStmt *pStmt, STableDataBlocks *pBlocks) {
+  int32_t numOfRows = ingestGetNumOfRows(pBlocks);
+
+  SIngestVgroup *pVgroup = ingestGetVgroup(pIngest, pBlocks->vgId);
+  if (pVgroup == NULL) {
+    tscDestroyDataBlock(NULL, pBlocks, false);
+    return TSDB_CODE_TSC_OUT_OF_MEMORY;
+  }
+
+  // send the current one if it can not hold the blocks, and wait for the response of the previous ones if necessary
+  while (pVgroup->pBatch != NULL && pVgroup->pBatch->pBlocks->size + pBlocks->size - INGEST_HEAD_SIZE > pIngest->maxBytes) {
+    if (pVgroup->inflight < tsIngestMaxInflight) {
+      SIngestBatch *pBatch = pVgroup->pBatch;
+      pBatch->stime = 0;  // ready to be sent
+
+      pBatch = ingestTakeBatch(pIngest, pVgroup, taosGetTimestampMs());
+      pthread_mutex_unlock(&pIngest->mutex);
+      ingestSendBatch(pIngest, pBatch);
+      pthread_mutex_lock(&pIngest->mutex);
+    } else {
+      pthread_cond_wait(&pIngest->cond, &pIngest->mutex);
+    }
+  }
+
+  SIngestBatch *pBatch = pVgroup->pBatch;
+  if (pBatch == NULL) {
+    pBatch = calloc(1, sizeof(SIngestBatch));
+    if (pBatch == NULL || (pBatch->pStmts = taosArrayInit(4, POINTER_BYTES)) == NULL) {
+      tfree(pBatch);
+      tscDestroyDataBlock(NULL, pBlocks, false);
+      return TSDB_CODE_TSC_OUT_OF_MEMORY;
+    }
+
+    pBatch->pIngest = pIngest;
+    pBatch->pVgroup = pVgroup;
+    pBatch->pBlocks = pBlocks;
+    pBatch->stime = taosGetTimestampMs();
+    pVgroup->pBatch = pBatch;
+  } else {
+    STableDataBlocks *pDst = pBatch->pBlocks;
+    uint32_t          len = pBlocks->size - INGEST_HEAD_SIZE;
+
+    if (pDst->size + len > pDst->nAllocSize) {
+      uint32_t size = (pDst->size + len) * 2;
+      if (size > pIngest->maxBytes + pDst->size) {
+        size = pDst->size + len;
+      }
+
+      char *tmp = realloc(pDst->pData, size);
+      if (tmp == NULL) {
+        tscDestroyDataBlock(NULL, pBlocks, false);
+        return TSDB_CODE_TSC_OUT_OF_MEMORY;
+      }
+
+      pDst->pData = tmp;
+      pDst->nAllocSize = size;
+    }
+
+    memcpy(pDst->pData + pDst->size, pBlocks->pData + INGEST_HEAD_SIZE, len);
+    pDst->size += len;
+    pDst->numOfTables += pBlocks->numOfTables;
+    tscDestroyDataBlock(NULL, pBlocks, false);
+  }
+
+  pBatch->numOfRows += numOfRows;
+  if (taosArrayGetSize(pBatch->pStmts) == 0 || taosArrayGetP(pBatch->pStmts, taosArrayGetSize(pBatch->pStmts) - 1) != pStmt) {
+    pStmt->ref += 1;
+    taosArrayPush(pBatch->pStmts, &pStmt);
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static SSqlObj *ingestCreateSqlObj(SIngest *pIngest, const char *sql) {
+  SSqlObj *pSql = calloc(1, sizeof(SSqlObj));
+  if (pSql == NULL) {
+    return NULL;
+  }
+
+  size_t sqlLen = strlen(sql);
+
+  tsem_init(&pSql->rspSem, 0, 0);
+  pSql->signature = pSql;
+  pSql->param     = pIngest->pObj;
+  pSql->pTscObj   = pIngest->pObj;
+  pSql->maxRetry  = TSDB_MAX_REPLICA;
+  pSql->fp        = waitForQueryRsp;
+  pSql->fetchFp   = waitForQueryRsp;
+  pSql->rootObj   = pSql;
+
+  registerSqlObj(pSql);
+
+  pSql->sqlstr = calloc(1, sqlLen + 1);
+  if (pSql->sqlstr == NULL) {
+    taos_free_result(pSql);
+    return NULL;
+  }
+
+  strntolower(pSql->sqlstr, sql, (int32_t)sqlLen);
+  tscDebugL("0x%" PRIx64 " ingest:%p SQL: %s", pSql->self, pIngest, pSql->sqlstr);
+  pSql->cmd.resColumnId = TSDB_RES_COL_ID;
+  return pSql;
+}
+
+// execute the statement one by one, the same as taos_query
+static void ingestExecuteStmt(SIngest *pIngest, SIngestStmt *pStmt) {
+  TAOS_RES *res = taos_query(pIngest->pObj, pStmt->sql);
+  int32_t   code = taos_errno(res);
+  int32_t   rows = taos_affected_rows(res);
+  taos_free_result(res);
+
+  pthread_mutex_lock(&pIngest->mutex);
+  pIngest->stat.directStatements += 1;
+  if (code == TSDB_CODE_SUCCESS) {
+    pIngest->stat.rows += rows;
+    pIngest->lastTime = taosGetTimestampUs();
+  } else {
+    pIngest->stat.failedStatements += 1;
+    ingestSetError(pIngest, code);
+  }
+  pthread_mutex_unlock(&pIngest->mutex);
+}
+
+static void ingestParseStmt(SIngest *pIngest, SIngestStmt *pStmt) {
+  SSqlObj *pSql = ingestCreateSqlObj(pIngest, pStmt->sql);
+  if (pSql == NULL) {
+    pthread_mutex_lock(&pIngest->mutex);
+    pIngest->stat.failedStatements += 1;
+    ingestSetError(pIngest, TSDB_CODE_TSC_OUT_OF_MEMORY);
+    pthread_mutex_unlock(&pIngest->mutex);
+    return;
+  }
+
+  SSqlCmd *pCmd = &pSql->cmd;
+  int32_t  code = tsParseSql(pSql, true);
+
+  if (code == TSDB_CODE_TSC_ACTION_IN_PROGRESS) {
+    // the table meta is retrieved, and the statement is inserted after it is parsed
+    tsem_wait(&pSql->rspSem);
+    code = pSql->res.code;
+
+    pthread_mutex_lock(&pIngest->mutex);
+    pIngest->stat.directStatements += 1;
+    if (code == TSDB_CODE_SUCCESS) {
+      pIngest->stat.rows += pSql->res.numOfRows;
+      pIngest->lastTime = taosGetTimestampUs();
+    }
+  } else {
+    if (code == TSDB_CODE_SUCCESS && (pCmd->command != TSDB_SQL_INSERT ||
+        TSDB_QUERY_HAS_TYPE(pCmd->insertParam.insertType, TSDB_QUERY_TYPE_FILE_INSERT))) {
+      code = TSDB_CODE_TSC_INVALID_OPERATION;
+    }
+
+    SArray *pBlockList = pCmd->insertParam.pDataBlocks;
+    size_t  numOfBlocks = (code == TSDB_CODE_SUCCESS && pBlockList != NULL) ? taosArrayGetSize(pBlockList) : 0;
+
+    pthread_mutex_lock(&pIngest->mutex);
+    for (int32_t i = 0; i < numOfBlocks; ++i) {
+      STableDataBlocks *pBlocks = taosArrayGetP(pBlockList, i);
+      int32_t           ret = ingestMergeBlocks(pIngest, pStmt, pBlocks);
+      if (ret != TSDB_CODE_SUCCESS && code == TSDB_CODE_SUCCESS) {
+        code = ret;
+      }
+    }
+
+    if (numOfBlocks > 0) {
+      taosArrayClear(pBlockList);
+    }
+  }
+
+  if (code != TSDB_CODE_SUCCESS) {
+    tscError("0x%" PRIx64 " ingest:%p failed to insert the statement, code:%s", pSql->self, pIngest, tstrerror(code));
+    pIngest->stat.failedStatements += 1;
+    ingestSetError(pIngest, code);
+  }
+
+  ingestSendReadyBatches(pIngest);
+  pthread_mutex_unlock(&pIngest->mutex);
+
+  taos_free_result(pSql);
+}
+
+static void *ingestParseThread(void *param) {
+  SIngest *pIngest = param;
+  setThreadName("ingestParse");
+
+  pthread_mutex_lock(&pIngest->mutex);
+  while (true) {
+    SIngestStmt *pStmt = NULL;
+    bool         retry = false;
+
+    if (taosArrayGetSize(pIngest->pRetry) > 0) {
+      pStmt = *(SIngestStmt **)taosArrayPop(pIngest->pRetry);
+      retry = true;
+    } else if (pIngest->num > 0) {
+      pStmt = pIngest->queue[pIngest->head];
+      pIngest->head = (pIngest->head + 1) % INGEST_QUEUE_SIZE;
+      pIngest->num -= 1;
+    }
+
+    if (pStmt != NULL) {
+      pIngest->numOfBusy += 1;
+      pthread_cond_broadcast(&pIngest->cond);
+      pthread_mutex_unlock(&pIngest->mutex);
+
+      ingestFreeSubmitObjs(pIngest);
+      if (retry) {
+        ingestExecuteStmt(pIngest, pStmt);
+      } else {
+        ingestParseStmt(pIngest, pStmt);
+      }
+
+      pthread_mutex_lock(&pIngest->mutex);
+      ingestReleaseStmt(pStmt);
+      pIngest->numOfBusy -= 1;
+      pthread_cond_broadcast(&pIngest->cond);
+      continue;
+    }
+
+    if (pIngest->closing) {
+      break;
+    }
+
+    // the submit messages kept for ingestFlushInterval are sent
+    ingestSendReadyBatches(pIngest);
+
+    struct timespec ts = {0};
+    clock_gettime(CLOCK_REALTIME, &ts);
+    int64_t ns = ts.tv_nsec + (int64_t)tsIngestFlushInterval * 1000000;
+    ts.tv_sec += ns / 1000000000;
+    ts.tv_nsec = ns % 1000000000;
+    pthread_cond_timedwait(&pIngest->cond, &pIngest->mutex, &ts);
+  }
+  pthread_mutex_unlock(&pIngest->mutex);
+
+  return NULL;
+}
+
+static bool ingestIsIdle(SIngest *pIngest) {
+  if (pIngest->num > 0 || pIngest->numOfBusy > 0 || pIngest->inflight > 0 || taosArrayGetSize(pIngest->pRetry) > 0) {
+    return false;
+  }
+
+  SIngestVgroup **ppVgroup = taosHashIterate(pIngest->pVgroups, NULL);
+  while (ppVgroup != NULL) {
+    if ((*ppVgroup)->pBatch != NULL) {
+      taosHashCancelIterate(pIngest->pVgroups, ppVgroup);
+      return false;
+    }
+    ppVgroup = taosHashIterate(pIngest->pVgroups, ppVgroup);
+  }
+
+  return true;
+}
+
+TAOS_INGEST *taos_ingest_open(TAOS *taos) {
+  STscObj *pObj = (STscObj *)taos;
+  if (pObj == NULL || pObj->signature != pObj) {
+    terrno = TSDB_CODE_TSC_DISCONNECTED;
+    return NULL;
+  }
+
+  SIngest *pIngest = calloc(1, sizeof(SIngest));
+  if (pIngest == NULL) {
+    terrno = TSDB_CODE_TSC_OUT_OF_MEMORY;
+    return NULL;
+  }
+
+  pIngest->pObj = pObj;
+  pIngest->numOfThreads = tsIngestParseThreads;
+  pIngest->maxBytes = tsIngestBatchSize * 1024;
+  if (pIngest->maxBytes > INGEST_MAX_BYTES) {
+    pIngest->maxBytes = INGEST_MAX_BYTES;
+  }
+
+  pIngest->queue = calloc(INGEST_QUEUE_SIZE, POINTER_BYTES);
+  pIngest->pRetry = taosArrayInit(4, POINTER_BYTES);
+  pIngest->pFreeList = taosArrayInit(4, POINTER_BYTES);
+  pIngest->pVgroups = taosHashInit(16, taosGetDefaultHashFunction(TSDB_DATA_TYPE_INT), true, HASH_NO_LOCK);
+  pIngest->threads = calloc(pIngest->numOfThreads, sizeof(pthread_t));
+  if (pIngest->queue == NULL || pIngest->pRetry == NULL || pIngest->pFreeList == NULL || pIngest->pVgroups == NULL ||
+      pIngest->threads == NULL) {
+    taosArrayDestroy(&pIngest->pRetry);
+    taosArrayDestroy(&pIngest->pFreeList);
+    taosHashCleanup(pIngest->pVgroups);
+    tfree(pIngest->queue);
+    tfree(pIngest->threads);
+    tfree(pIngest);
+    terrno = TSDB_CODE_TSC_OUT_OF_MEMORY;
+    return NULL;
+  }
+
+  pthread_mutex_init(&pIngest->mutex, NULL);
+  pthread_cond_init(&pIngest->cond, NULL);
+
+  pthread_attr_t thattr;
+  pthread_attr_init(&thattr);
+  pthread_attr_setdetachstate(&thattr, PTHREAD_CREATE_JOINABLE);
+
+  for (int32_t i = 0; i < pIngest->numOfThreads; ++i) {
+    if (pthread_create(pIngest->threads + i, &thattr, ingestParseThread, pIngest) != 0) {
+      tscError("ingest:%p failed to create parse thread, reason:%s", pIngest, strerror(errno));
+      pIngest->numOfThreads = i;
+      break;
+    }
+  }
+  pthread_attr_destroy(&thattr);
+
+  pIngest->signature = pIngest;
+  if (pIngest->numOfThreads == 0) {
+    taos_ingest_close(pIngest);
+    terrno = TSDB_CODE_TSC_OUT_OF_MEMORY;
+    return NULL;
+  }
+
+  tscDebug("ingest:%p is opened, parse threads:%d batch size:%d flush interval:%dms max inflight:%d", pIngest,
+           pIngest->numOfThreads, pIngest->maxBytes, tsIngestFlushInterval, tsIngestMaxInflight);
+  return pIngest;
+}
+
+int taos_ingest_write(TAOS_INGEST *ingest, const char *sql) {
+  SIngest *pIngest = (SIngest *)ingest;
+  if (pIngest == NULL || pIngest->signature != pIngest) {
+    return TSDB_CODE_TSC_DISCONNECTED;
+  }
+
+  size_t sqlLen = (sql == NULL) ? 0 : strlen(sql);
+  if (sqlLen == 0 || !tscIsInsertData((char *)sql)) {
+    return TSDB_CODE_TSC_INVALID_OPERATION;
+  }
+
+  if (sqlLen > (size_t)tsMaxSQLStringLen) {
+    return TSDB_CODE_TSC_EXCEED_SQL_LIMIT;
+  }
+
+  SIngestStmt *pStmt = malloc(sizeof(SIngestStmt) + sqlLen + 1);
+  if (pStmt == NULL) {
+    return TSDB_CODE_TSC_OUT_OF_MEMORY;
+  }
+
+  pStmt->ref = 1;
+  memcpy(pStmt->sql, sql, sqlLen + 1);
+
+  pthread_mutex_lock(&pIngest->mutex);
+  while (pIngest->num >= INGEST_QUEUE_SIZE) {
+    pthread_cond_wait(&pIngest->cond, &pIngest->mutex);
+  }
+
+  if (pIngest->firstTime == 0) {
+    pIngest->firstTime = taosGetTimestampUs();
+  }
+
+  pIngest->queue[(pIngest->head + pIngest->num) % INGEST_QUEUE_SIZE] = pStmt;
+  pIngest->num += 1;
+  pIngest->stat.statements += 1;
+  pthread_cond_broadcast(&pIngest->cond);
+  pthread_mutex_unlock(&pIngest->mutex);
+
+  return TSDB_CODE_SUCCESS;
+}
+
+int taos_ingest_flush(TAOS_INGEST *ingest) {
+  SIngest *pIngest = (SIngest *)ingest;
+  if (pIngest == NULL || pIngest->signature != pIngest) {
+    return TSDB_CODE_TSC_DISCONNECTED;
+  }
+
+  pthread_mutex_lock(&pIngest->mutex);
+  pIngest->flushing += 1;
+  while (!ingestIsIdle(pIngest)) {
+    ingestSendReadyBatches(pIngest);
+    if (!ingestIsIdle(pIngest)) {
+      pthread_cond_wait(&pIngest->cond, &pIngest->mutex);
+    }
+  }
+  pIngest->flushing -= 1;
+
+  int32_t code = pIngest->stat.code;
+  pthread_mutex_unlock(&pIngest->mutex);
+
+  ingestFreeSubmitObjs(pIngest);
+  return code;
+}
+
+void taos_ingest_stat(TAOS_INGEST *ingest, TAOS_INGEST_STAT *stat) {
+  SIngest *pIngest = (SIngest *)ingest;
+  if (pIngest == NULL || pIngest->signature != pIngest || stat == NULL) {
+    return;
+  }
+
+  pthread_mutex_lock(&pIngest->mutex);
+  *stat = pIngest->stat;
+  stat->elapsed = (pIngest->lastTime > pIngest->firstTime) ? pIngest->lastTime - pIngest->firstTime : 0;
+  stat->rowsPerSecond = (stat->elapsed > 0) ? stat->rows * 1000000.0 / stat->elapsed : 0;
+  pthread_mutex_unlock(&pIngest->mutex);
+}
+
+int taos_ingest_close(TAOS_INGEST *ingest) {
+  SIngest *pIngest = (SIngest *)ingest;
+  if (pIngest == NULL || pIngest->signature != pIngest) {
+    return TSDB_CODE_TSC_DISCONNECTED;
+  }
+
+  int32_t code = taos_ingest_flush(pIngest);
+
+  pthread_mutex_lock(&pIngest->mutex);
+  pIngest->closing = true;
+  pthread_cond_broadcast(&pIngest->cond);
+  pthread_mutex_unlock(&pIngest->mutex);
+
+  for (int32_t i = 0; i < pIngest->numOfThreads; ++i) {
+    pthread_join(pIngest->threads[i], NULL);
+  }
+
+  TAOS_INGEST_STAT stat = {0};
+  taos_ingest_stat(pIngest, &stat);
+  tscInfo("ingest:%p is closed, statements:%" PRId64 " failed:%" PRId64 " direct:%" PRId64 " rows:%" PRId64
+          " submits:%" PRId64 " rows per submit:%.1f max:%d bytes per submit:%.1f, %.1f rows/s",
+          pIngest, stat.statements, stat.failedStatements, stat.directStatements, stat.rows, stat.submits,
+          (stat.submits > 0) ? (double)stat.submitRows / stat.submits : 0, stat.maxSubmitRows,
+          (stat.submits > 0) ? (double)stat.submitBytes / stat.submits : 0, stat.rowsPerSecond);
+
+  pIngest->signature = NULL;
+  ingestFreeSubmitObjs(pIngest);
+
+  SIngestVgroup **ppVgroup = taosHashIterate(pIngest->pVgroups, NULL);
+  while (ppVgroup != NULL) {
+    assert((*ppVgroup)->pBatch == NULL && (*ppVgroup)->inflight == 0);
+    free(*ppVgroup);
+    ppVgroup = taosHashIterate(pIngest->pVgroups, ppVgroup);
+  }
+
+  taosHashCleanup(pIngest->pVgroups);
+  taosArrayDestroy(&pIngest->pRetry);
+  taosArrayDestroy(&pIngest->pFreeList);
+  pthread_cond_destroy(&pIngest->cond);
+  pthread_mutex_destroy(&pIngest->mutex);
+  tfree(pIngest->queue);
+  tfree(pIngest->threads);
+  tfree(pIngest);
+
+  return code;
+}
@@ -964,6 +964,7 @@ int tscProcessLocalCmd(SSqlObj *pSql) {
     pRes->code = tscProcessShowCreateDatabase(pSql); 
   } else if (pCmd->command == TSDB_SQL_RESET_CACHE) {
     taosHashClear(UTIL_GET_TABLEMETA(pSql));
+    taosHashClear(pSql->pTscObj->pClusterInfo->stableNameMap);
     taosCacheEmpty(UTIL_GET_VGROUPLIST(pSql));
     pRes->code = TSDB_CODE_SUCCESS;
   } else if (pCmd->command == TSDB_SQL_SERV_VERSION) {
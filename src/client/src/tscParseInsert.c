@@ -33,6 +33,9 @@
 
 #include "tdataformat.h"
 
+// the tables created by one statement before an insert, mnode counts them in int16
+#define INSERT_CREATE_TABLES_MAX_NUM 16384
+
 enum {
   TSDB_USE_SERVER_TS = 0,
   TSDB_USE_CLI_TS = 1,
@@ -1366,6 +1369,339 @@ static int32_t getFileFullPath(SStrToken* pToken, char* output) {
   return TSDB_CODE_SUCCESS;
 }
 
+void tscTableMetaCallBack(void *param, TAOS_RES *res, int code);
+
+static void freeElem(void* p) {
+  tfree(*(char**)p);
+}
+
+// skip the tokens till the right parenthesis matching the left one that has been consumed
+static bool tscSkipParenthesis(char **str) {
+  int32_t depth = 1;
+  while (depth > 0) {
+    int32_t   index = 0;
+    SStrToken sToken = tStrGetToken(*str, &index, false);
+    if (sToken.n == 0) {
+      return false;
+    }
+
+    *str += index;
+    if (sToken.type == TK_LP) {
+      depth += 1;
+    } else if (sToken.type == TK_RP) {
+      depth -= 1;
+    }
+  }
+
+  return true;
+}
+
+static void tscPrefetchInsertTableMetaCallBack(void *param, TAOS_RES *res, int code) {
+  if (code != TSDB_CODE_SUCCESS) {
+    tscDebug("0x%"PRIx64" failed to prefetch table meta, code:%s, get them one by one", (int64_t)param, tstrerror(code));
+  }
+
+  // the tables not retrieved are fetched again during parsing
+  tscTableMetaCallBack(param, res, TSDB_CODE_SUCCESS);
+}
+
+// consume the next token
+static SStrToken tscNextInsertToken(char **str) {
+  int32_t   index = 0;
+  SStrToken sToken = tStrGetToken(*str, &index, false);
+  *str += index;
+  return sToken;
+}
+
+/*
+ * The names of the tables written by an insert statement, which are not in the cache, are put into pNameList. The
+ * names and the USING clauses of those with one are put into pCreateNames and pCreateClauses as well. The scan stops
+ * at anything unexpected, since the syntax is checked later by the parser.
+ */
+static void tscScanInsertTables(SSqlObj *pSql, SArray *pNameList, SArray *pCreateNames, SArray *pCreateClauses) {
+  char *str = pSql->cmd.insertParam.sql;
+
+  SHashObj *pNameSet = taosHashInit(16, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), false, HASH_NO_LOCK);
+  if (pNameSet == NULL) {
+    return;
+  }
+
+  while (taosArrayGetSize(pNameList) < TSDB_MULTI_TABLEMETA_MAX_NUM) {
+    SStrToken sToken = tscNextInsertToken(&str);
+    if (sToken.n == 0) {
+      break;
+    }
+
+    char      buf[TSDB_TABLE_FNAME_LEN];
+    SStrToken sTblToken;
+    sTblToken.z = buf;
+    bool  dbIncluded = false;
+    SName name = {0};
+    if (validateTableName(sToken.z, sToken.n, &sTblToken, &dbIncluded) != TSDB_CODE_SUCCESS ||
+        tscSetTableFullName(&name, &sTblToken, pSql, dbIncluded) != TSDB_CODE_SUCCESS) {
+      break;
+    }
+
+    char *clause = sToken.z;
+    char *added = NULL;
+
+    char fname[TSDB_TABLE_FNAME_LEN] = {0};
+    tNameExtractFullName(&name, fname);
+    size_t len = strlen(fname);
+    if (taosHashGet(UTIL_GET_TABLEMETA(pSql), fname, len) == NULL && taosHashGet(pNameSet, fname, len) == NULL) {
+      char *p = strdup(fname);
+      if (p == NULL) {
+        break;
+      }
+
+      taosArrayPush(pNameList, &p);
+      taosHashPut(pNameSet, fname, len, &p, POINTER_BYTES);
+      added = p;
+    }
+
+    // USING stable [(tag names)] TAGS (tag values)
+    sToken = tscNextInsertToken(&str);
+    if (sToken.type == TK_USING) {
+      tscNextInsertToken(&str);
+
+      sToken = tscNextInsertToken(&str);
+      if (sToken.type == TK_LP) {
+        if (!tscSkipParenthesis(&str)) {
+          break;
+        }
+        sToken = tscNextInsertToken(&str);
+      }
+
+      if (sToken.type != TK_TAGS) {
+        break;
+      }
+
+      sToken = tscNextInsertToken(&str);
+      if (sToken.type != TK_LP || !tscSkipParenthesis(&str)) {
+        break;
+      }
+
+      if (added != NULL) {
+        char *pName = strdup(added);
+        char *p = strndup(clause, str - clause);
+        if (pName == NULL || p == NULL) {
+          tfree(pName);
+          tfree(p);
+          break;
+        }
+        taosArrayPush(pCreateNames, &pName);
+        taosArrayPush(pCreateClauses, &p);
+      }
+      sToken = tscNextInsertToken(&str);
+    }
+
+    // bound columns
+    if (sToken.type == TK_LP) {
+      if (!tscSkipParenthesis(&str)) {
+        break;
+      }
+      sToken = tscNextInsertToken(&str);
+    }
+
+    if (sToken.type == TK_VALUES) {
+      bool valid = true;
+      while (1) {
+        int32_t index = 0;
+        sToken = tStrGetToken(str, &index, false);
+        if (sToken.type != TK_LP) {
+          break;
+        }
+
+        str += index;
+        if (!tscSkipParenthesis(&str)) {
+          valid = false;
+          break;
+        }
+      }
+
+      if (!valid) {
+        break;
+      }
+    } else if (sToken.type == TK_FILE) {
+      tscNextInsertToken(&str);
+    } else {
+      break;
+    }
+  }
+
+  taosHashCleanup(pNameSet);
+}
+
+// the parsing is resumed once the meta of the tables created in batch are retrieved in one request as well
+static void tscCreateInsertTablesCallBack(void *param, TAOS_RES *res, int code);
+
+/*
+ * The tables are sent to create in batches, each within tsMaxSQLStringLen and INSERT_CREATE_TABLES_MAX_NUM tables. A
+ * USING clause too long to fit in any batch is left to the parser.
+ */
+static bool tscCreateInsertTablesInBatch(SSqlObj *pSql) {
+  SInsertStatementParam *pInsertParam = &pSql->cmd.insertParam;
+  int32_t                numOfTables = (int32_t)taosArrayGetSize(pInsertParam->pCreateClauses);
+
+  const char *prefix = "create table";
+  const char *ifNotExists = " if not exists ";
+  int32_t     len = (int32_t)strlen(prefix);
+
+  int32_t start = pInsertParam->numOfCreateSent;
+  int32_t end = start;
+  for (; end < numOfTables && end - start < INSERT_CREATE_TABLES_MAX_NUM; ++end) {
+    int32_t clauseLen = (int32_t)(strlen(ifNotExists) + strlen(taosArrayGetP(pInsertParam->pCreateClauses, end)));
+    if (len + clauseLen > tsMaxSQLStringLen) {
+      if (end == start) {
+        start += 1;
+        continue;
+      }
+      break;
+    }
+    len += clauseLen;
+  }
+
+  pInsertParam->numOfCreateSent = end;
+  if (end == start) {
+    return false;
+  }
+
+  char *sql = malloc(len + 1);
+  if (sql == NULL) {
+    return false;
+  }
+
+  char *p = sql + sprintf(sql, "%s", prefix);
+  for (int32_t i = start; i < end; ++i) {
+    p += sprintf(p, "%s%s", ifNotExists, (char *)taosArrayGetP(pInsertParam->pCreateClauses, i));
+  }
+
+  tscDebug("0x%"PRIx64" create %d of %d tables of the insert statement in batch, len:%d", pSql->self, end - start,
+           numOfTables, len);
+  taos_query_a(pSql->pTscObj, sql, tscCreateInsertTablesCallBack, (void *)pSql->self);
+  free(sql);
+  return true;
+}
+
+static void tscCreateInsertTablesCallBack(void *param, TAOS_RES *res, int code) {
+  if (code != TSDB_CODE_SUCCESS) {
+    tscDebug("0x%"PRIx64" failed to create tables in batch, code:%s, create them one by one", (int64_t)param,
+             tstrerror(code));
+  }
+  taos_free_result(res);
+
+  SSqlObj *pSql = (SSqlObj *)taosAcquireRef(tscObjRef, (int64_t)param);
+  if (pSql == NULL) return;
+
+  SInsertStatementParam *pInsertParam = &pSql->cmd.insertParam;
+  if (code == TSDB_CODE_SUCCESS && tscCreateInsertTablesInBatch(pSql)) {
+    taosReleaseRef(tscObjRef, (int64_t)param);
+    return;
+  }
+
+  SArray *pVgroupList = taosArrayInit(1, POINTER_BYTES);
+  code = TSDB_CODE_SUCCESS;
+  if (pVgroupList != NULL && taosArrayGetSize(pInsertParam->pCreateNames) > 0) {
+    code = getMultiTableMetaFromMnode(pSql, pInsertParam->pCreateNames, pVgroupList, NULL,
+                                      tscPrefetchInsertTableMetaCallBack, false, true);
+  }
+
+  destroyCreateTableList(pInsertParam);
+  taosArrayDestroy(&pVgroupList);
+  taosReleaseRef(tscObjRef, (int64_t)param);
+
+  if (code != TSDB_CODE_TSC_ACTION_IN_PROGRESS) {
+    tscTableMetaCallBack(param, NULL, TSDB_CODE_SUCCESS);
+  }
+}
+
+/*
+ * The child tables of USING clauses which do not exist yet are created by multi-table statements, so mnode allocates
+ * them in one message and sends them to each vgroup together, instead of creating them one by one while parsing. The
+ * tables are those scanned before the meta are prefetched, less the ones whose meta are retrieved.
+ */
+static void tscPrefetchInsertTableMetaThenCreate(void *param, TAOS_RES *res, int code) {
+  SSqlObj *pSql = (SSqlObj *)taosAcquireRef(tscObjRef, (int64_t)param);
+  if (pSql == NULL) return;
+
+  SInsertStatementParam *pInsertParam = &pSql->cmd.insertParam;
+  if (code == TSDB_CODE_SUCCESS) {
+    size_t num = 0;
+    for (size_t i = 0; i < taosArrayGetSize(pInsertParam->pCreateNames); ++i) {
+      char *name = taosArrayGetP(pInsertParam->pCreateNames, i);
+      char *clause = taosArrayGetP(pInsertParam->pCreateClauses, i);
+      if (taosHashGet(UTIL_GET_TABLEMETA(pSql), name, strlen(name)) != NULL) {
+        free(name);
+        free(clause);
+        continue;
+      }
+
+      taosArraySet(pInsertParam->pCreateNames, num, &name);
+      taosArraySet(pInsertParam->pCreateClauses, num, &clause);
+      num += 1;
+    }
+
+    taosArraySetSize(pInsertParam->pCreateNames, num);
+    taosArraySetSize(pInsertParam->pCreateClauses, num);
+  }
+
+  // a single table is created during parsing, with its meta retrieved in the same request
+  bool sent = false;
+  if (code == TSDB_CODE_SUCCESS && taosArrayGetSize(pInsertParam->pCreateNames) > 1) {
+    sent = tscCreateInsertTablesInBatch(pSql);
+  }
+
+  if (!sent) {
+    destroyCreateTableList(pInsertParam);
+  }
+  taosReleaseRef(tscObjRef, (int64_t)param);
+
+  if (!sent) {
+    tscPrefetchInsertTableMetaCallBack(param, res, code);
+  }
+}
+
+/*
+ * The names of the tables written by an insert statement are scanned before parsing, and the meta of the tables not
+ * in the cache are retrieved from mnode in one request, instead of one request for each table while parsing. The
+ * tables with USING clauses are kept to create them in batch once the meta are retrieved.
+ */
+static int32_t tscPrefetchInsertTableMeta(SSqlObj *pSql) {
+  SInsertStatementParam *pInsertParam = &pSql->cmd.insertParam;
+  int32_t                code = TSDB_CODE_SUCCESS;
+
+  SArray *pNameList = taosArrayInit(4, POINTER_BYTES);
+  SArray *pVgroupList = taosArrayInit(1, POINTER_BYTES);
+  pInsertParam->pCreateNames = taosArrayInit(4, POINTER_BYTES);
+  pInsertParam->pCreateClauses = taosArrayInit(4, POINTER_BYTES);
+  pInsertParam->numOfCreateSent = 0;
+  if (pNameList == NULL || pVgroupList == NULL || pInsertParam->pCreateNames == NULL ||
+      pInsertParam->pCreateClauses == NULL) {
+    goto _end;
+  }
+
+  tscScanInsertTables(pSql, pNameList, pInsertParam->pCreateNames, pInsertParam->pCreateClauses);
+
+  // the meta of a single table is retrieved during parsing, with the tags to create it if not exists
+  if (taosArrayGetSize(pNameList) > 1) {
+    tscDebug("0x%"PRIx64" prefetch the meta of %d tables of the insert statement", pSql->self,
+             (int32_t)taosArrayGetSize(pNameList));
+    code = getMultiTableMetaFromMnode(pSql, pNameList, pVgroupList, NULL, tscPrefetchInsertTableMetaThenCreate, false,
+                                      true);
+    if (code != TSDB_CODE_TSC_ACTION_IN_PROGRESS) {
+      code = TSDB_CODE_SUCCESS;
+    }
+  }
+
+_end:
+  if (code != TSDB_CODE_TSC_ACTION_IN_PROGRESS) {
+    destroyCreateTableList(pInsertParam);
+  }
+  taosArrayDestroyEx(&pNameList, freeElem);
+  taosArrayDestroy(&pVgroupList);
+  return code;
+}
+
 /**
  * parse insert sql
  * @param pSql
@@ -1397,6 +1733,12 @@ int tsParseInsertSql(SSqlObj *pSql) {
       code = TSDB_CODE_TSC_OUT_OF_MEMORY;
       goto _clean;
     }
+
+    // parsing is resumed once the meta are retrieved, with the block list created
+    if (!TSDB_QUERY_HAS_TYPE(pInsertParam->insertType, TSDB_QUERY_TYPE_STMT_INSERT) &&
+        tscPrefetchInsertTableMeta(pSql) == TSDB_CODE_TSC_ACTION_IN_PROGRESS) {
+      return TSDB_CODE_TSC_ACTION_IN_PROGRESS;
+    }
   } else {
     str = pInsertParam->sql;
   }
@@ -15,6 +15,11 @@
 #include "tscUtil.h"
 #include "tsclient.h"
 #include "tscLog.h"
+#include "tscSubquery.h"
+
+#if !defined(_TD_ARM_) && !defined(_TD_MIPS_)
+#include <emmintrin.h>
+#endif
 
 #include "taos.h"
 #include "tscParseLine.h"
@@ -596,7 +601,7 @@ static int32_t getSuperTableMetaFromLocalCache(TAOS* taos, char* tableName, STab
   tNameExtractFullName(&sname, fullTableName);
 
   size_t size = 0;
-  taosHashGetCloneExt(UTIL_GET_TABLEMETA(pSql), fullTableName, strlen(fullTableName), NULL, (void**)&tableMeta, &size);
+  tscGetTableMetaFromCache(pSql, fullTableName, strlen(fullTableName), &tableMeta, &size);
 
   STableMeta* stableMeta = tableMeta;
   if (tableMeta != NULL && tableMeta->tableType == TSDB_CHILD_TABLE) {
@@ -1199,23 +1204,19 @@ static int32_t applyChildTableDataPoints(TAOS* taos, char* cTableName, char* sTa
   return code;
 }
 
-static int32_t applyDataPoints(TAOS* taos, TAOS_SML_DATA_POINT* points, int32_t numPoints, SArray* stableSchemas, SSmlLinesInfo* info) {
+static int32_t applyChildTableDataPointsList(TAOS* taos, SArray* cTablePointsList, SArray* stableSchemas, SSmlLinesInfo* info) {
   int32_t code = TSDB_CODE_SUCCESS;
 
-  SHashObj* cname2points = taosHashInit(128, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), true, false);
-  arrangePointsByChildTableName(points, numPoints, cname2points, stableSchemas, info);
-
-  SArray** pCTablePoints = taosHashIterate(cname2points, NULL);
-  while (pCTablePoints) {
-    SArray* cTablePoints = *pCTablePoints;
+  for (int32_t i = 0; i < taosArrayGetSize(cTablePointsList); ++i) {
+    SArray* cTablePoints = taosArrayGetP(cTablePointsList, i);
 
     TAOS_SML_DATA_POINT* point = taosArrayGetP(cTablePoints, 0);
     SSmlSTableSchema*    sTableSchema = taosArrayGet(stableSchemas, point->schemaIdx);
 
     size_t rowSize = 0;
     size_t numCols = taosArrayGetSize(sTableSchema->fields);
-    for (int i = 0; i < numCols; ++i) {
-      SSchema* colSchema = taosArrayGet(sTableSchema->fields, i);
+    for (int j = 0; j < numCols; ++j) {
+      SSchema* colSchema = taosArrayGet(sTableSchema->fields, j);
       rowSize += colSchema->bytes;
     }
 
@@ -1224,418 +1225,946 @@ static int32_t applyDataPoints(TAOS* taos, TAOS_SML_DATA_POINT* points, int32_t
     code = applyChildTableDataPoints(taos, point->childTableName, point->stableName, sTableSchema, cTablePoints, rowSize, info);
     if (code != 0) {
       tscError("SML:0x%"PRIx64" Apply child table points failed. child table %s, error %s", info->id, point->childTableName, tstrerror(code));
-      goto cleanup;
+      return code;
     }
 
     tscDebug("SML:0x%"PRIx64" successfully applied data points of child table %s", info->id, point->childTableName);
-
-    pCTablePoints = taosHashIterate(cname2points, pCTablePoints);
   }
 
-cleanup:
-  pCTablePoints = taosHashIterate(cname2points, NULL);
-  while (pCTablePoints) {
-    SArray* pPoints = *pCTablePoints;
-    taosArrayDestroy(&pPoints);
-    pCTablePoints = taosHashIterate(cname2points, pCTablePoints);
-  }
-  taosHashCleanup(cname2points);
   return code;
 }
 
-static int doSmlInsertOneDataPoint(TAOS* taos, TAOS_SML_DATA_POINT* point, SSmlLinesInfo* info) {
-  int32_t code = TSDB_CODE_SUCCESS;
+//=================================================================================================
+// write the points of child tables into submit blocks directly
+//
+// The points are written as memory rows into the STableDataBlocks of their child tables, the same way the SQL parser
+// does, and the blocks are merged per vgroup and submitted by one multi-vnode insertion. It requires the meta of the
+// child table in the client cache. Missing child tables are created by batched create table statements and their meta
+// is loaded by one request, the points of the child tables still not available are left to the SQL/stmt path.
 
-  if (!point->childTableName) {
-    int tableNameLen = TSDB_TABLE_NAME_LEN;
-    point->childTableName = calloc(1, tableNameLen + 1);
-    getSmlMd5ChildTableName(point, point->childTableName, &tableNameLen, info);
-    point->childTableName[tableNameLen] = '\0';
+#define SML_SUBMIT_MAX_BYTES (TSDB_MAX_WAL_SIZE / 3 * 2)
+
+typedef struct {
+  SSqlObj*  pSql;
+  SHashObj* vgroupBytes;    // vgId -> estimated size of the submit message of the vgroup
+  SArray*   cTablePoints;   // points of the child tables in the submit blocks, SArray<SArray<TAOS_SML_DATA_POINT*>*>
+} SSmlSubmitBatch;
+
+static SSqlObj* smlCreateSubmitObj(TAOS* taos) {
+  SSqlObj* pSql = calloc(1, sizeof(SSqlObj));
+  if (pSql == NULL) {
+    return NULL;
   }
 
-  STableMeta* tableMeta = NULL;
-  int32_t ret = getSuperTableMetaFromLocalCache(taos, point->stableName, &tableMeta, info);
-  if (ret != TSDB_CODE_SUCCESS) {
-    return ret;
+  if (tscAllocPayload(&pSql->cmd, TSDB_DEFAULT_PAYLOAD_SIZE) != TSDB_CODE_SUCCESS) {
+    free(pSql);
+    return NULL;
   }
-  uint8_t precision = tableMeta->tableInfo.precision;
-  free(tableMeta);
 
-  char* sql = malloc(TSDB_MAX_SQL_LEN + 1);
-  int   freeBytes = TSDB_MAX_SQL_LEN;
-  int   sqlLen = 0;
-  sqlLen += snprintf(sql + sqlLen, freeBytes - sqlLen, "insert into %s(", point->childTableName);
-  for (int col = 0; col < point->fieldNum; ++col) {
-    TAOS_SML_KV* kv = point->fields + col;
-    sqlLen += snprintf(sql + sqlLen, freeBytes - sqlLen, "%s,", kv->key);
+  tsem_init(&pSql->rspSem, 0, 0);
+  pSql->signature = pSql;
+  pSql->pTscObj   = taos;
+  pSql->rootObj   = pSql;
+  pSql->param     = pSql;
+  pSql->fp        = waitForQueryRsp;
+  pSql->fetchFp   = waitForQueryRsp;
+  pSql->maxRetry  = TSDB_MAX_REPLICA;
+  pSql->retry     = pSql->maxRetry + 1;  // no sql to re-parse, the failed points are retried by the SQL/stmt path
+
+  SSqlCmd* pCmd = &pSql->cmd;
+  pCmd->command = TSDB_SQL_INSERT;
+  pCmd->insertParam.pTableBlockHashList = taosHashInit(128, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), true, false);
+
+  // the sub objects of the multi-vnode insertion copy the name of the first table meta info
+  SQueryInfo* pQueryInfo = tscGetQueryInfoS(pCmd);
+  if (pQueryInfo == NULL || pCmd->insertParam.pTableBlockHashList == NULL || tscAddEmptyMetaInfo(pQueryInfo) == NULL) {
+    tscFreeSqlObj(pSql);
+    return NULL;
   }
-  --sqlLen;
-  sqlLen += snprintf(sql + sqlLen, freeBytes - sqlLen, ") values (");
-  TAOS_SML_KV* tsField = point->fields + 0;
-  int64_t      ts = *(int64_t*)(tsField->value);
-  ts = convertTimePrecision(ts, TSDB_TIME_PRECISION_NANO, precision);
-  sqlLen += snprintf(sql + sqlLen, freeBytes - sqlLen, "%" PRId64 ",", ts);
-  for (int col = 1; col < point->fieldNum; ++col) {
-    TAOS_SML_KV* kv = point->fields + col;
-    int32_t      len = 0;
-    converToStr(sql + sqlLen, kv->type, kv->value, kv->length, &len);
-    sqlLen += len;
-    sqlLen += snprintf(sql + sqlLen, freeBytes - sqlLen, ",");
+
+  TSDB_QUERY_SET_TYPE(pQueryInfo->type, TSDB_QUERY_TYPE_INSERT);
+
+  registerSqlObj(pSql);
+  pCmd->insertParam.objectId = pSql->self;
+  return pSql;
+}
+
+static int32_t smlGetTableName(SSqlObj* pSql, char* tableName, SName* pName) {
+  char   tableNameBuf[TSDB_TABLE_NAME_LEN + TS_BACKQUOTE_CHAR_SIZE] = {0};
+  size_t len = strlen(tableName);
+  if (len >= tListLen(tableNameBuf)) {
+    return TSDB_CODE_TSC_INVALID_TABLE_ID_LENGTH;
   }
-  --sqlLen;
-  sqlLen += snprintf(sql + sqlLen, freeBytes - sqlLen, ")");
-  sql[sqlLen] = 0;
 
-  tscDebug("SML:0x%" PRIx64 " insert child table table %s of super table %s sql: %s", info->id,
-           point->childTableName, point->stableName, sql);
-  TAOS_RES* res = taos_query(taos, sql);
-  free(sql);
-  code = taos_errno(res);
-  info->affectedRows = taos_affected_rows(res);
-  taos_free_result(res);
+  memcpy(tableNameBuf, tableName, len);
+  SStrToken tableToken = {.z = tableNameBuf, .n = (uint32_t)len, .type = TK_ID};
+  tGetToken(tableNameBuf, &tableToken.type);
 
-  return code;
+  bool dbIncluded = false;
+  if (tscValidateName(&tableToken, true, &dbIncluded) != TSDB_CODE_SUCCESS) {
+    return TSDB_CODE_TSC_INVALID_TABLE_ID_LENGTH;
+  }
+
+  return tscSetTableFullName(pName, &tableToken, pSql, dbIncluded);
 }
 
-int tscSmlInsert(TAOS* taos, TAOS_SML_DATA_POINT* points, int numPoint, SSmlLinesInfo* info) {
-  tscDebug("SML:0x%"PRIx64" taos_sml_insert. number of points: %d", info->id, numPoint);
+// get the meta of the child table from the local cache only, the schema is filled from the super table meta
+static int32_t smlGetCachedChildTableMeta(SSqlObj* pSql, SName* pName, STableMeta** ppMeta, size_t* pCapacity) {
+  char fullName[TSDB_TABLE_FNAME_LEN] = {0};
+  tNameExtractFullName(pName, fullName);
 
-  int32_t code = TSDB_CODE_SUCCESS;
+  if (tscGetTableMetaFromCache(pSql, fullName, strlen(fullName), ppMeta, pCapacity) == NULL) {
+    return TSDB_CODE_TSC_NO_META_CACHED;
+  }
 
-  info->affectedRows = 0;
+  if ((*ppMeta)->id.uid <= 0 || (*ppMeta)->tableType != TSDB_CHILD_TABLE) {
+    return TSDB_CODE_TSC_NO_META_CACHED;
+  }
 
-  if (numPoint == 1) {
-    TAOS_SML_DATA_POINT* point = points + 0;
-    code = doSmlInsertOneDataPoint(taos, point, info);
-    if (code == TSDB_CODE_SUCCESS) {
-      return code;
+  STableMeta* pSTableMeta = NULL;
+  int32_t     code = tscCreateTableMetaFromSTableMeta(pSql, ppMeta, fullName, pCapacity, &pSTableMeta);
+  tfree(pSTableMeta);
+
+  return (code == TSDB_CODE_SUCCESS) ? TSDB_CODE_SUCCESS : TSDB_CODE_TSC_NO_META_CACHED;
+}
+
+// map the fields of the point schema to the columns of the table, return false if any of them is unknown
+static bool smlBuildColumnIndex(STableMeta* pTableMeta, SSmlSTableSchema* sTableSchema, int32_t* colIndex) {
+  SSchema* pSchema = tscGetTableSchema(pTableMeta);
+  int32_t  numOfCols = tscGetNumOfColumns(pTableMeta);
+  size_t   numOfFields = taosArrayGetSize(sTableSchema->fields);
+
+  for (int32_t i = 0; i < numOfFields; ++i) {
+    SSchema* pField = taosArrayGet(sTableSchema->fields, i);
+
+    // the field names are quoted by backquotes
+    char*  name = pField->name;
+    size_t len = strlen(name);
+    if (len >= 2 && name[0] == TS_BACKQUOTE_CHAR && name[len - 1] == TS_BACKQUOTE_CHAR) {
+      name += 1;
+      len -= 2;
     }
-  }
 
-  tscDebug("SML:0x%"PRIx64" build data point schemas", info->id);
-  SArray* stableSchemas = taosArrayInit(32, sizeof(SSmlSTableSchema)); // SArray<STableColumnsSchema>
-  code = buildDataPointSchemas(points, numPoint, stableSchemas, info);
-  if (code != 0) {
-    tscError("SML:0x%"PRIx64" error building data point schemas : %s", info->id, tstrerror(code));
-    goto clean_up;
+    colIndex[i] = -1;
+    for (int32_t j = 0; j < numOfCols; ++j) {
+      if (strlen(pSchema[j].name) == len && strncmp(pSchema[j].name, name, len) == 0) {
+        colIndex[i] = j;
+        break;
+      }
+    }
+
+    if (colIndex[i] < 0 || pSchema[colIndex[i]].type != pField->type) {
+      return false;
+    }
   }
 
-  tscDebug("SML:0x%"PRIx64" modify db schemas", info->id);
-  code = modifyDBSchemas(taos, stableSchemas, info);
-  if (code != 0) {
-    tscError("SML:0x%"PRIx64" error change db schema : %s", info->id, tstrerror(code));
-    goto clean_up;
+  return true;
+}
+
+static int32_t smlEstimateRowSize(STableMeta* pTableMeta) {
+  SSchema* pSchema = tscGetTableSchema(pTableMeta);
+  int32_t  numOfCols = tscGetNumOfColumns(pTableMeta);
+  int32_t  size = pTableMeta->tableInfo.rowSize + TD_MEM_ROW_DATA_HEAD_SIZE;
+
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    if (IS_VAR_DATA_TYPE(pSchema[i].type)) {
+      size += sizeof(VarDataOffsetT);
+    }
   }
 
-  tscDebug("SML:0x%"PRIx64" apply data points", info->id);
-  code = applyDataPoints(taos, points, numPoint, stableSchemas, info);
-  if (code != 0) {
-    tscError("SML:0x%"PRIx64" error apply data points : %s", info->id, tstrerror(code));
+  return size;
+}
+
+static int32_t smlAppendChildTableRows(SSqlObj* pSql, SName* pName, STableMeta* pTableMeta, SArray* cTablePoints,
+                                       int32_t start, int32_t numOfRows, int32_t* colIndex, TAOS_SML_KV** colKVs,
+                                       SSmlLinesInfo* info) {
+  SInsertStatementParam* pInsertParam = &pSql->cmd.insertParam;
+  STableDataBlocks*      dataBuf = NULL;
+
+  int32_t code = tscGetDataBlockFromList(pInsertParam->pTableBlockHashList, pTableMeta->id.uid, TSDB_DEFAULT_PAYLOAD_SIZE,
+                                         sizeof(SSubmitBlk), pTableMeta->tableInfo.rowSize, pName, pTableMeta, &dataBuf,
+                                         NULL);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
   }
 
-clean_up:
-  for (int i = 0; i < taosArrayGetSize(stableSchemas); ++i) {
-    SSmlSTableSchema* schema = taosArrayGet(stableSchemas, i);
-    taosArrayDestroy(&schema->fields);
-    taosArrayDestroy(&schema->tags);
+  SParsedDataColInfo* spd = &dataBuf->boundColumnInfo;
+  SSchema*            pSchema = tscGetTableSchema(dataBuf->pTableMeta);
+  SSubmitBlk*         pBlk = (SSubmitBlk*)dataBuf->pData;
+  int32_t             numOfCols = spd->numOfCols;
+
+  if ((code = initMemRowBuilder(&dataBuf->rowBuilder, 0, spd)) != TSDB_CODE_SUCCESS) {
+    return code;
   }
-  taosArrayDestroy(&stableSchemas);
-  return code;
-}
 
-//=========================================================================
+  int32_t extendedRowSize = getExtendedRowSize(dataBuf);
+  uint8_t memRowType = dataBuf->rowBuilder.memRowType;
+  dataBuf->rowBuilder.rowSize = extendedRowSize;
 
-/*        Field                          Escape charaters
-    1: measurement                        Comma,Space
-    2: tag_key, tag_value, field_key  Comma,Equal Sign,Space
-    3: field_value                    Double quote,Backslash
-*/
-static void escapeSpecialCharacter(uint8_t field, const char **pos) {
-  const char *cur = *pos;
-  if (*cur != '\\') {
-    return;
+  size_t allocSize = dataBuf->size + (size_t)numOfRows * extendedRowSize;
+  if (allocSize > dataBuf->nAllocSize) {
+    char* tmp = realloc(dataBuf->pData, allocSize);
+    if (tmp == NULL) {
+      return TSDB_CODE_TSC_OUT_OF_MEMORY;
+    }
+
+    dataBuf->pData = tmp;
+    dataBuf->nAllocSize = (uint32_t)allocSize;
+    pBlk = (SSubmitBlk*)dataBuf->pData;
   }
-  switch (field) {
-    case 1:
-      switch (*(cur + 1)) {
-        case ',':
-        case ' ':
-          cur++;
-          break;
-        default:
-          break;
-      }
-      break;
-    case 2:
-      switch (*(cur + 1)) {
-        case ',':
-        case ' ':
-        case '=':
-          cur++;
-          break;
-        default:
-          break;
+
+  for (int32_t r = start; r < start + numOfRows; ++r) {
+    TAOS_SML_DATA_POINT* point = taosArrayGetP(cTablePoints, r);
+
+    memset(colKVs, 0, numOfCols * POINTER_BYTES);
+    for (int32_t i = 0; i < point->fieldNum; ++i) {
+      TAOS_SML_KV* kv = point->fields + i;
+      colKVs[colIndex[kv->fieldSchemaIdx]] = kv;
+    }
+
+    SMemRow row = dataBuf->pData + dataBuf->size;
+    initSMemRow(row, memRowType, dataBuf, spd->numOfBound);
+
+    for (int32_t i = 0; i < numOfCols; ++i) {
+      int32_t  toffset = -1;
+      int16_t  colId = -1;
+      SSchema* pColSchema = &pSchema[i];
+      tscGetMemRowAppendInfo(pSchema, memRowType, spd, i, &toffset, &colId);
+
+      TAOS_SML_KV* kv = colKVs[i];
+      if (kv == NULL) {
+        tdAppendMemRowColVal(row, getNullValue(pColSchema->type), true, colId, pColSchema->type, toffset);
+        continue;
       }
-      break;
-    case 3:
-      switch (*(cur + 1)) {
-        case '"':
-        case '\\':
-          cur++;
-          break;
-        default:
-          break;
+
+      if (kv->type == TSDB_DATA_TYPE_BINARY) {
+        if (kv->length + VARSTR_HEADER_SIZE > pColSchema->bytes) {
+          tscError("SML:0x%"PRIx64" string data overflow, column %s, length %d", info->id, pColSchema->name, kv->length);
+          return TSDB_CODE_TSC_INVALID_VALUE;
+        }
+
+        char* rowEnd = memRowEnd(row);
+        STR_WITH_SIZE_TO_VARSTR(rowEnd, kv->value, kv->length);
+        tdAppendMemRowColVal(row, rowEnd, false, colId, pColSchema->type, toffset);
+      } else if (kv->type == TSDB_DATA_TYPE_NCHAR) {
+        int32_t output = 0;
+        char*   rowEnd = memRowEnd(row);
+        if (!taosMbsToUcs4(kv->value, kv->length, (char*)varDataVal(rowEnd), pColSchema->bytes - VARSTR_HEADER_SIZE,
+                           &output)) {
+          tscError("SML:0x%"PRIx64" convert nchar column %s failed, %s", info->id, pColSchema->name, strerror(errno));
+          return TSDB_CODE_TSC_INVALID_VALUE;
+        }
+
+        varDataSetLen(rowEnd, output);
+        tdAppendMemRowColVal(row, rowEnd, false, colId, pColSchema->type, toffset);
+      } else {
+        tdAppendMemRowColVal(row, kv->value, true, colId, pColSchema->type, toffset);
       }
-      break;
-    default:
-      break;
-  }
-  *pos = cur;
-}
+    }
 
-char* addEscapeCharToString(char *str, int32_t len) {
-  if (str == NULL) {
-    return NULL;
+    TSKEY key = memRowKey(row);
+    if (tsCheckTimestamp(dataBuf, (const char*)&key) != TSDB_CODE_SUCCESS) {
+      return TSDB_CODE_TSC_INVALID_TIME_STAMP;
+    }
+
+    dataBuf->size += extendedRowSize;
   }
-  memmove(str + 1, str, len);
-  str[0] = str[len + 1] = TS_BACKQUOTE_CHAR;
-  str[len + 2] = '\0';
-  return str;
+
+  dataBuf->numOfTables = 1;
+  return tsSetBlockInfo(pBlk, dataBuf->pTableMeta, pBlk->numOfRows + numOfRows);
 }
 
-bool isValidInteger(char *str) {
-  char *c = str;
-  if (*c != '+' && *c != '-' && !isdigit(*c)) {
-    return false;
+static int32_t smlFlushSubmitBatch(SSmlSubmitBatch* pBatch, SArray* pendingTables, SSmlLinesInfo* info) {
+  SSqlObj* pSql = pBatch->pSql;
+  int32_t  code = TSDB_CODE_SUCCESS;
+
+  if (pSql == NULL) {
+    return code;
   }
-  c++;
-  while (*c != '\0') {
-    if (!isdigit(*c)) {
-      return false;
+
+  if (taosArrayGetSize(pBatch->cTablePoints) > 0) {
+    code = tscMergeTableDataBlocks(pSql, &pSql->cmd.insertParam, true);
+    if (code == TSDB_CODE_SUCCESS) {
+      code = tscHandleMultivnodeInsert(pSql);
+    }
+
+    if (code == TSDB_CODE_SUCCESS) {
+      // wait for the callback function to post the semaphore
+      tsem_wait(&pSql->rspSem);
+      code = pSql->res.code;
+    }
+
+    tscDebug("SML:0x%"PRIx64" submit blocks of %zu child tables to %d vgroups, inserted %d rows, code:%s", info->id,
+             taosArrayGetSize(pBatch->cTablePoints), (int32_t)taosHashGetSize(pBatch->vgroupBytes),
+             pSql->res.numOfRows, tstrerror(code));
+
+    if (code == TSDB_CODE_SUCCESS) {
+      info->affectedRows += pSql->res.numOfRows;
+    } else if (pendingTables != NULL) {
+      taosArrayAddAll(pendingTables, pBatch->cTablePoints);
     }
-    c++;
   }
-  return true;
-}
 
-bool isValidFloat(char *str) {
-  char *c = str;
-  uint8_t has_dot, has_exp, has_sign;
-  has_dot = 0;
-  has_exp = 0;
-  has_sign = 0;
+  taos_free_result(pSql);
+  pBatch->pSql = NULL;
+  taosHashClear(pBatch->vgroupBytes);
+  taosArrayClear(pBatch->cTablePoints);
+  return code;
+}
 
-  if (*c != '+' && *c != '-' && *c != '.' && !isdigit(*c)) {
-    return false;
+static void smlFreeNameList(SArray* pNameList) {
+  for (int32_t i = 0; i < taosArrayGetSize(pNameList); ++i) {
+    char* name = taosArrayGetP(pNameList, i);
+    tfree(name);
   }
-  if (*c == '.' && isdigit(*(c + 1))) {
-    has_dot = 1;
-  }
-  c++;
-  while (*c != '\0') {
-    if (!isdigit(*c)) {
-      switch (*c) {
-        case '.': {
-          if (!has_dot && !has_exp && isdigit(*(c + 1))) {
-            has_dot = 1;
-          } else {
-            return false;
-          }
-          break;
-        }
-        case 'e':
-        case 'E': {
-          if (!has_exp && isdigit(*(c - 1)) &&
-              (isdigit(*(c + 1)) ||
-               *(c + 1) == '+' ||
-               *(c + 1) == '-')) {
-            has_exp = 1;
-          } else {
-            return false;
-          }
-          break;
-        }
-        case '+':
-        case '-': {
-          if (!has_sign && has_exp && isdigit(*(c + 1))) {
-            has_sign = 1;
-          } else {
-            return false;
-          }
-          break;
-        }
-        default: {
-          return false;
-        }
-      }
-    }
-    c++;
-  } //while
-  return true;
+  taosArrayClear(pNameList);
 }
 
-static bool isInteger(char *pVal, uint16_t len, bool *has_sign) {
-  if (len <= 1) {
-    return false;
+static int32_t smlFlushCreateTables(TAOS* taos, char* sql, int32_t* sqlLen, SArray* pNameList, SSmlLinesInfo* info) {
+  int32_t code = TSDB_CODE_SUCCESS;
+  if (taosArrayGetSize(pNameList) == 0) {
+    return code;
   }
-  if (pVal[len - 1] == 'i') {
-    *has_sign = true;
-    return true;
+
+  sql[*sqlLen] = 0;
+  TAOS_RES* res = taos_query(taos, sql);
+  code = taos_errno(res);
+  if (code != TSDB_CODE_SUCCESS) {
+    tscError("SML:0x%"PRIx64" create %zu child tables failed, error %s", info->id, taosArrayGetSize(pNameList),
+             taos_errstr(res));
   }
-  if (pVal[len - 1] == 'u') {
-    *has_sign = false;
-    return true;
+  taos_free_result(res);
+
+  if (code == TSDB_CODE_SUCCESS) {
+    code = tscLoadMultiTableMeta(taos, pNameList);
+    tscDebug("SML:0x%"PRIx64" created %zu child tables and loaded their meta, code:%s", info->id,
+             taosArrayGetSize(pNameList), tstrerror(code));
   }
 
-  return false;
+  smlFreeNameList(pNameList);
+  *sqlLen = 0;
+  return code;
 }
 
-static bool isTinyInt(char *pVal, uint16_t len) {
-  if (len <= 2) {
-    return false;
+// build the "if not exists ... using ... tags (...)" clause of the child table, the last tag values of its points win
+static int32_t smlBuildCreateTableClause(char* clause, int32_t capacity, TAOS_SML_DATA_POINT* point,
+                                         SSmlSTableSchema* sTableSchema, SArray* cTablePoints) {
+  TAOS_SML_KV* tagKVs[TSDB_MAX_TAGS] = {0};
+  size_t       numTags = taosArrayGetSize(sTableSchema->tags);
+
+  for (int32_t i = 0; i < taosArrayGetSize(cTablePoints); ++i) {
+    TAOS_SML_DATA_POINT* pDataPoint = taosArrayGetP(cTablePoints, i);
+    for (int32_t j = 0; j < pDataPoint->tagNum; ++j) {
+      TAOS_SML_KV* kv = pDataPoint->tags + j;
+      tagKVs[kv->fieldSchemaIdx] = kv;
+    }
   }
-  if (!strcasecmp(&pVal[len - 2], "i8")) {
-    //printf("Type is int8(%s)\n", pVal);
-    return true;
+
+  int32_t len = snprintf(clause, capacity, " if not exists %s using %s (", point->childTableName, point->stableName);
+  for (int32_t i = 0; i < numTags && len < capacity; ++i) {
+    SSchema* tagSchema = taosArrayGet(sTableSchema->tags, i);
+    len += snprintf(clause + len, capacity - len, "%s%s", (i == 0) ? "" : ",", tagSchema->name);
   }
-  return false;
-}
 
-static bool isTinyUint(char *pVal, uint16_t len) {
-  if (len <= 2) {
-    return false;
+  if (len < capacity) {
+    len += snprintf(clause + len, capacity - len, ") tags (");
   }
-  if (pVal[0] == '-') {
-    return false;
+
+  for (int32_t i = 0; i < numTags && len < capacity; ++i) {
+    TAOS_SML_KV* kv = tagKVs[i];
+
+    // a string is escaped into at most twice of its length
+    int32_t maxLen = (kv == NULL) ? 8 : kv->length * 2 + 64;
+    if (len + maxLen >= capacity) {
+      return -1;
+    }
+
+    if (i > 0) {
+      clause[len++] = ',';
+    }
+
+    int32_t n = 0;
+    if (kv == NULL) {
+      n = sprintf(clause + len, "NULL");
+    } else if (converToStr(clause + len, kv->type, kv->value, kv->length, &n) != TSDB_CODE_SUCCESS) {
+      return -1;
+    }
+    len += n;
   }
-  if (!strcasecmp(&pVal[len - 2], "u8")) {
-    //printf("Type is uint8(%s)\n", pVal);
-    return true;
+
+  if (len + 1 >= capacity) {
+    return -1;
   }
-  return false;
+
+  clause[len++] = ')';
+  clause[len] = 0;
+  return len;
 }
 
-static bool isSmallInt(char *pVal, uint16_t len) {
-  if (len <= 3) {
-    return false;
+/**
+ * Create the child tables whose meta is not cached in batched create table statements and load their meta into the
+ * local cache by one request. The failures are not reported, the points of these tables go to the SQL/stmt path.
+ */
+static void smlCreateChildTables(TAOS* taos, SHashObj* cname2points, SArray* stableSchemas, SSmlLinesInfo* info) {
+  STableMeta* pTableMeta = NULL;
+  size_t      metaCapacity = 0;
+  int32_t     sqlLen = 0;
+  int32_t     numOfCreated = 0;
+
+  SSqlObj* pSql = smlCreateSubmitObj(taos);
+  char*    sql = malloc(tsMaxSQLStringLen + 1);
+  char*    clause = malloc(tsMaxSQLStringLen + 1);
+  SArray*  pNameList = taosArrayInit(64, POINTER_BYTES);
+  if (pSql == NULL || sql == NULL || clause == NULL || pNameList == NULL) {
+    goto _end;
   }
-  if (!strcasecmp(&pVal[len - 3], "i16")) {
-    //printf("Type is int16(%s)\n", pVal);
-    return true;
+
+  SArray** pCTablePoints = taosHashIterate(cname2points, NULL);
+  while (pCTablePoints) {
+    SArray* cTablePoints = *pCTablePoints;
+    pCTablePoints = taosHashIterate(cname2points, pCTablePoints);
+
+    TAOS_SML_DATA_POINT* point = taosArrayGetP(cTablePoints, 0);
+    SSmlSTableSchema*    sTableSchema = taosArrayGet(stableSchemas, point->schemaIdx);
+
+    SName name = {0};
+    if (smlGetTableName(pSql, point->childTableName, &name) != TSDB_CODE_SUCCESS ||
+        smlGetCachedChildTableMeta(pSql, &name, &pTableMeta, &metaCapacity) == TSDB_CODE_SUCCESS) {
+      continue;
+    }
+
+    int32_t len = smlBuildCreateTableClause(clause, tsMaxSQLStringLen + 1, point, sTableSchema, cTablePoints);
+    if (len < 0) {
+      continue;
+    }
+
+    if (sqlLen + len >= tsMaxSQLStringLen || taosArrayGetSize(pNameList) >= TSDB_MULTI_TABLEMETA_MAX_NUM) {
+      smlFlushCreateTables(taos, sql, &sqlLen, pNameList, info);
+    }
+
+    if (sqlLen == 0) {
+      sqlLen = sprintf(sql, "create table");
+    }
+
+    if (sqlLen + len >= tsMaxSQLStringLen) {
+      sqlLen = 0;
+      continue;
+    }
+
+    char* fullName = malloc(TSDB_TABLE_FNAME_LEN);
+    if (fullName == NULL) {
+      continue;
+    }
+    tNameExtractFullName(&name, fullName);
+    taosArrayPush(pNameList, &fullName);
+
+    memcpy(sql + sqlLen, clause, len);
+    sqlLen += len;
+    numOfCreated++;
   }
-  return false;
+
+  smlFlushCreateTables(taos, sql, &sqlLen, pNameList, info);
+  tscDebug("SML:0x%"PRIx64" %d child tables are created before written into submit blocks", info->id, numOfCreated);
+
+_end:
+  if (pSql != NULL) {
+    taos_free_result(pSql);
+  }
+  if (pNameList != NULL) {
+    smlFreeNameList(pNameList);
+    taosArrayDestroy(&pNameList);
+  }
+  tfree(pTableMeta);
+  tfree(sql);
+  tfree(clause);
 }
 
-static bool isSmallUint(char *pVal, uint16_t len) {
-  if (len <= 3) {
-    return false;
+static bool smlIsRetryableInsertError(int32_t code) {
+  return code == TSDB_CODE_TDB_INVALID_TABLE_ID || code == TSDB_CODE_VND_INVALID_VGROUP_ID ||
+         code == TSDB_CODE_TDB_TABLE_RECONFIGURE || code == TSDB_CODE_APP_NOT_READY ||
+         code == TSDB_CODE_RPC_NETWORK_UNAVAIL;
+}
+
+/**
+ * Write the points of the child tables with cached meta into submit blocks and send them to the vnodes. The points of
+ * the other child tables are put into pendingTables. If a submission fails with an error that the SQL/stmt path
+ * retries, the points of the failed and the remaining child tables are put into pendingTables as well.
+ */
+static int32_t applyDataPointsWithSubmitBlocks(TAOS* taos, SHashObj* cname2points, SArray* stableSchemas,
+                                               SArray* pendingTables, SSmlLinesInfo* info) {
+  int32_t         code = TSDB_CODE_SUCCESS;
+  STableMeta*     pTableMeta = NULL;
+  size_t          metaCapacity = 0;
+  bool            fallback = false;
+  SSmlSubmitBatch batch = {0};
+
+  int32_t*      colIndex = malloc(TSDB_MAX_COLUMNS * sizeof(int32_t));
+  TAOS_SML_KV** colKVs = malloc(TSDB_MAX_COLUMNS * POINTER_BYTES);
+  batch.vgroupBytes = taosHashInit(16, taosGetDefaultHashFunction(TSDB_DATA_TYPE_INT), true, false);
+  batch.cTablePoints = taosArrayInit(64, POINTER_BYTES);
+  if (colIndex == NULL || colKVs == NULL || batch.vgroupBytes == NULL || batch.cTablePoints == NULL) {
+    code = TSDB_CODE_TSC_OUT_OF_MEMORY;
+    goto _end;
   }
-  if (pVal[0] == '-') {
-    return false;
+
+  SArray** pCTablePoints = taosHashIterate(cname2points, NULL);
+  while (pCTablePoints) {
+    SArray* cTablePoints = *pCTablePoints;
+    pCTablePoints = taosHashIterate(cname2points, pCTablePoints);
+
+    if (fallback) {
+      taosArrayPush(pendingTables, &cTablePoints);
+      continue;
+    }
+
+    if (batch.pSql == NULL && (batch.pSql = smlCreateSubmitObj(taos)) == NULL) {
+      code = TSDB_CODE_TSC_OUT_OF_MEMORY;
+      break;
+    }
+
+    TAOS_SML_DATA_POINT* point = taosArrayGetP(cTablePoints, 0);
+    SSmlSTableSchema*    sTableSchema = taosArrayGet(stableSchemas, point->schemaIdx);
+
+    SName name = {0};
+    if ((code = smlGetTableName(batch.pSql, point->childTableName, &name)) != TSDB_CODE_SUCCESS) {
+      tscError("SML:0x%"PRIx64" invalid child table name %s", info->id, point->childTableName);
+      break;
+    }
+
+    if (smlGetCachedChildTableMeta(batch.pSql, &name, &pTableMeta, &metaCapacity) != TSDB_CODE_SUCCESS ||
+        !smlBuildColumnIndex(pTableMeta, sTableSchema, colIndex)) {
+      taosArrayPush(pendingTables, &cTablePoints);
+      continue;
+    }
+
+    int32_t rowSize = smlEstimateRowSize(pTableMeta);
+    int32_t maxRows = MIN(INT16_MAX, SML_SUBMIT_MAX_BYTES / rowSize);
+    int32_t rows = (int32_t)taosArrayGetSize(cTablePoints);
+
+    for (int32_t start = 0; start < rows && code == TSDB_CODE_SUCCESS;) {
+      int32_t numOfRows = MIN(rows - start, maxRows);
+      int32_t vgId = pTableMeta->vgId;
+
+      int64_t  vgroupBytes = 0;
+      int64_t* pBytes = taosHashGet(batch.vgroupBytes, &vgId, sizeof(vgId));
+      if (pBytes != NULL) {
+        vgroupBytes = *pBytes;
+      }
+
+      // one submit block per table in a submit message, so the rest rows of a large table go to the next one
+      if (start > 0 || vgroupBytes + (int64_t)numOfRows * rowSize > SML_SUBMIT_MAX_BYTES) {
+        if ((code = smlFlushSubmitBatch(&batch, pendingTables, info)) != TSDB_CODE_SUCCESS) {
+          break;
+        }
+
+        if ((batch.pSql = smlCreateSubmitObj(taos)) == NULL) {
+          code = TSDB_CODE_TSC_OUT_OF_MEMORY;
+          break;
+        }
+        vgroupBytes = 0;
+      }
+
+      code = smlAppendChildTableRows(batch.pSql, &name, pTableMeta, cTablePoints, start, numOfRows, colIndex, colKVs,
+                                     info);
+      if (code != TSDB_CODE_SUCCESS) {
+        tscError("SML:0x%"PRIx64" failed to write points of child table %s into submit block, error %s", info->id,
+                 point->childTableName, tstrerror(code));
+        break;
+      }
+
+      if (start == 0) {
+        taosArrayPush(batch.cTablePoints, &cTablePoints);
+      }
+
+      vgroupBytes += (int64_t)numOfRows * rowSize;
+      taosHashPut(batch.vgroupBytes, &vgId, sizeof(vgId), &vgroupBytes, sizeof(vgroupBytes));
+      start += numOfRows;
+    }
+
+    if (code != TSDB_CODE_SUCCESS) {
+      if (!smlIsRetryableInsertError(code)) {
+        break;
+      }
+
+      // the points of this and the remaining child tables are left to the SQL/stmt path
+      tscWarn("SML:0x%"PRIx64" submit blocks failed, error %s, insert the rest points by sql", info->id, tstrerror(code));
+      size_t numOfPending = taosArrayGetSize(pendingTables);
+      if (numOfPending == 0 || taosArrayGetP(pendingTables, numOfPending - 1) != cTablePoints) {
+        taosArrayPush(pendingTables, &cTablePoints);
+      }
+      fallback = true;
+      code = TSDB_CODE_SUCCESS;
+    }
   }
-  if (strcasecmp(&pVal[len - 3], "u16") == 0) {
-    //printf("Type is uint16(%s)\n", pVal);
-    return true;
+
+  if (pCTablePoints != NULL) {
+    taosHashCancelIterate(cname2points, pCTablePoints);
   }
-  return false;
+
+  if (code == TSDB_CODE_SUCCESS && !fallback) {
+    code = smlFlushSubmitBatch(&batch, pendingTables, info);
+    if (smlIsRetryableInsertError(code)) {
+      tscWarn("SML:0x%"PRIx64" submit blocks failed, error %s, insert the rest points by sql", info->id, tstrerror(code));
+      fallback = true;
+      code = TSDB_CODE_SUCCESS;
+    }
+  }
+
+  if (fallback) {
+    TAOS_RES* res = taos_query(taos, "RESET QUERY CACHE");
+    if (taos_errno(res) != TSDB_CODE_SUCCESS) {
+      tscError("SML:0x%" PRIx64 " insert child table by submit blocks. reset query cache. error: %s", info->id, taos_errstr(res));
+    }
+    taos_free_result(res);
+  }
+
+_end:
+  if (batch.pSql != NULL) {
+    taos_free_result(batch.pSql);
+  }
+  taosHashCleanup(batch.vgroupBytes);
+  taosArrayDestroy(&batch.cTablePoints);
+  tfree(pTableMeta);
+  tfree(colIndex);
+  tfree(colKVs);
+  return code;
 }
 
-static bool isInt(char *pVal, uint16_t len) {
-  if (len <= 3) {
-    return false;
+static int32_t applyDataPoints(TAOS* taos, TAOS_SML_DATA_POINT* points, int32_t numPoints, SArray* stableSchemas, SSmlLinesInfo* info) {
+  int32_t code = TSDB_CODE_SUCCESS;
+
+  SHashObj* cname2points = taosHashInit(128, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), true, false);
+  arrangePointsByChildTableName(points, numPoints, cname2points, stableSchemas, info);
+
+  SArray* cTablePointsList = taosArrayInit(taosHashGetSize(cname2points), POINTER_BYTES);
+  if (tsSmlDirectInsert) {
+    smlCreateChildTables(taos, cname2points, stableSchemas, info);
+    code = applyDataPointsWithSubmitBlocks(taos, cname2points, stableSchemas, cTablePointsList, info);
+    if (code != TSDB_CODE_SUCCESS) {
+      tscError("SML:0x%"PRIx64" Apply data points by submit blocks failed. error %s", info->id, tstrerror(code));
+      goto cleanup;
+    }
+  } else {
+    SArray** pCTablePoints = taosHashIterate(cname2points, NULL);
+    while (pCTablePoints) {
+      taosArrayPush(cTablePointsList, pCTablePoints);
+      pCTablePoints = taosHashIterate(cname2points, pCTablePoints);
+    }
   }
-  if (strcasecmp(&pVal[len - 3], "i32") == 0) {
-    //printf("Type is int32(%s)\n", pVal);
-    return true;
+
+  code = applyChildTableDataPointsList(taos, cTablePointsList, stableSchemas, info);
+
+cleanup:
+  taosArrayDestroy(&cTablePointsList);
+  SArray** pCTablePoints = taosHashIterate(cname2points, NULL);
+  while (pCTablePoints) {
+    SArray* pPoints = *pCTablePoints;
+    taosArrayDestroy(&pPoints);
+    pCTablePoints = taosHashIterate(cname2points, pCTablePoints);
   }
-  return false;
+  taosHashCleanup(cname2points);
+  return code;
 }
 
-static bool isUint(char *pVal, uint16_t len) {
-  if (len <= 3) {
-    return false;
+static int doSmlInsertOneDataPoint(TAOS* taos, TAOS_SML_DATA_POINT* point, SSmlLinesInfo* info) {
+  int32_t code = TSDB_CODE_SUCCESS;
+
+  if (!point->childTableName) {
+    int tableNameLen = TSDB_TABLE_NAME_LEN;
+    point->childTableName = calloc(1, tableNameLen + 1);
+    getSmlMd5ChildTableName(point, point->childTableName, &tableNameLen, info);
+    point->childTableName[tableNameLen] = '\0';
   }
-  if (pVal[0] == '-') {
-    return false;
+
+  STableMeta* tableMeta = NULL;
+  int32_t ret = getSuperTableMetaFromLocalCache(taos, point->stableName, &tableMeta, info);
+  if (ret != TSDB_CODE_SUCCESS) {
+    return ret;
   }
-  if (strcasecmp(&pVal[len - 3], "u32") == 0) {
-    //printf("Type is uint32(%s)\n", pVal);
-    return true;
+  uint8_t precision = tableMeta->tableInfo.precision;
+  free(tableMeta);
+
+  char* sql = malloc(TSDB_MAX_SQL_LEN + 1);
+  int   freeBytes = TSDB_MAX_SQL_LEN;
+  int   sqlLen = 0;
+  sqlLen += snprintf(sql + sqlLen, freeBytes - sqlLen, "insert into %s(", point->childTableName);
+  for (int col = 0; col < point->fieldNum; ++col) {
+    TAOS_SML_KV* kv = point->fields + col;
+    sqlLen += snprintf(sql + sqlLen, freeBytes - sqlLen, "%s,", kv->key);
   }
-  return false;
+  --sqlLen;
+  sqlLen += snprintf(sql + sqlLen, freeBytes - sqlLen, ") values (");
+  TAOS_SML_KV* tsField = point->fields + 0;
+  int64_t      ts = *(int64_t*)(tsField->value);
+  ts = convertTimePrecision(ts, TSDB_TIME_PRECISION_NANO, precision);
+  sqlLen += snprintf(sql + sqlLen, freeBytes - sqlLen, "%" PRId64 ",", ts);
+  for (int col = 1; col < point->fieldNum; ++col) {
+    TAOS_SML_KV* kv = point->fields + col;
+    int32_t      len = 0;
+    converToStr(sql + sqlLen, kv->type, kv->value, kv->length, &len);
+    sqlLen += len;
+    sqlLen += snprintf(sql + sqlLen, freeBytes - sqlLen, ",");
+  }
+  --sqlLen;
+  sqlLen += snprintf(sql + sqlLen, freeBytes - sqlLen, ")");
+  sql[sqlLen] = 0;
+
+  tscDebug("SML:0x%" PRIx64 " insert child table table %s of super table %s sql: %s", info->id,
+           point->childTableName, point->stableName, sql);
+  TAOS_RES* res = taos_query(taos, sql);
+  free(sql);
+  code = taos_errno(res);
+  info->affectedRows = taos_affected_rows(res);
+  taos_free_result(res);
+
+  return code;
 }
 
-static bool isBigInt(char *pVal, uint16_t len) {
-  if (len <= 3) {
-    return false;
+int tscSmlInsert(TAOS* taos, TAOS_SML_DATA_POINT* points, int numPoint, SSmlLinesInfo* info) {
+  tscDebug("SML:0x%"PRIx64" taos_sml_insert. number of points: %d", info->id, numPoint);
+
+  int32_t code = TSDB_CODE_SUCCESS;
+
+  info->affectedRows = 0;
+
+  if (numPoint == 1) {
+    TAOS_SML_DATA_POINT* point = points + 0;
+    code = doSmlInsertOneDataPoint(taos, point, info);
+    if (code == TSDB_CODE_SUCCESS) {
+      return code;
+    }
   }
-  if (strcasecmp(&pVal[len - 3], "i64") == 0) {
-    //printf("Type is int64(%s)\n", pVal);
-    return true;
+
+  tscDebug("SML:0x%"PRIx64" build data point schemas", info->id);
+  SArray* stableSchemas = taosArrayInit(32, sizeof(SSmlSTableSchema)); // SArray<STableColumnsSchema>
+  code = buildDataPointSchemas(points, numPoint, stableSchemas, info);
+  if (code != 0) {
+    tscError("SML:0x%"PRIx64" error building data point schemas : %s", info->id, tstrerror(code));
+    goto clean_up;
   }
-  return false;
+
+  tscDebug("SML:0x%"PRIx64" modify db schemas", info->id);
+  code = modifyDBSchemas(taos, stableSchemas, info);
+  if (code != 0) {
+    tscError("SML:0x%"PRIx64" error change db schema : %s", info->id, tstrerror(code));
+    goto clean_up;
+  }
+
+  tscDebug("SML:0x%"PRIx64" apply data points", info->id);
+  code = applyDataPoints(taos, points, numPoint, stableSchemas, info);
+  if (code != 0) {
+    tscError("SML:0x%"PRIx64" error apply data points : %s", info->id, tstrerror(code));
+  }
+
+clean_up:
+  for (int i = 0; i < taosArrayGetSize(stableSchemas); ++i) {
+    SSmlSTableSchema* schema = taosArrayGet(stableSchemas, i);
+    taosArrayDestroy(&schema->fields);
+    taosArrayDestroy(&schema->tags);
+  }
+  taosArrayDestroy(&stableSchemas);
+  return code;
+}
+
+//=========================================================================
+
+/*        Field                          Escape charaters
+    1: measurement                        Comma,Space
+    2: tag_key, tag_value, field_key  Comma,Equal Sign,Space
+    3: field_value                    Double quote,Backslash
+*/
+//=================================================================================================
+// structural character scanner of the line protocol
+//
+// Most of the bytes of a line are plain characters of names and values, the parser only has to stop at commas, spaces,
+// equal signs and backslashes. The scanner finds the next one of them in 16 bytes at a time, and the bytes before it are
+// consumed at once.
+
+#define SML_KEY_CHECK_LINEAR_NUM 32
+
+typedef struct {
+  const char *end;        // end of the line
+  int32_t     numOfKeys;  // keys of tags and fields parsed in the line
+  char        keys[SML_KEY_CHECK_LINEAR_NUM][TSDB_COL_NAME_LEN + 1];
+  SHashObj   *pKeyHash;   // keys of the line with more keys than SML_KEY_CHECK_LINEAR_NUM
+} SSmlLineParser;
+
+// return the number of the leading bytes in [cur, end) that are none of c0, c1 and c2
+static FORCE_INLINE int32_t smlSkipPlainChars(const char *cur, const char *end, char c0, char c1, char c2) {
+  const char *p = cur;
+
+#if !defined(_TD_ARM_) && !defined(_TD_MIPS_)
+  __m128i v0 = _mm_set1_epi8(c0);
+  __m128i v1 = _mm_set1_epi8(c1);
+  __m128i v2 = _mm_set1_epi8(c2);
+  while (end - p >= 16) {
+    __m128i chunk = _mm_loadu_si128((const __m128i *)p);
+    __m128i found = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, v0), _mm_cmpeq_epi8(chunk, v1)),
+                                 _mm_cmpeq_epi8(chunk, v2));
+    int32_t mask = _mm_movemask_epi8(found);
+    if (mask != 0) {
+      return (int32_t)(p - cur) + BUILDIN_CTZ((uint32_t)mask);
+    }
+    p += 16;
+  }
+#endif
+
+  while (p < end && *p != c0 && *p != c1 && *p != c2) {
+    p++;
+  }
+  return (int32_t)(p - cur);
 }
 
-static bool isBigUint(char *pVal, uint16_t len) {
-  if (len <= 3) {
+// the keys of a line are few in most cases, they are compared one by one instead of being put into a hash table
+static bool smlCheckDuplicateKey(SSmlLineParser *pParser, char *key, int16_t len, SSmlLinesInfo *info) {
+  if (pParser->numOfKeys < SML_KEY_CHECK_LINEAR_NUM) {
+    for (int32_t i = 0; i < pParser->numOfKeys; ++i) {
+      if (strcmp(pParser->keys[i], key) == 0) {
+        tscError("SML:0x%"PRIx64" Duplicate key detected:%s", info->id, key);
+        return true;
+      }
+    }
+
+    memcpy(pParser->keys[pParser->numOfKeys++], key, len + 1);
     return false;
   }
-  if (pVal[0] == '-') {
-    return false;
+
+  if (pParser->pKeyHash == NULL) {
+    pParser->pKeyHash = taosHashInit(128, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), true, false);
   }
-  if (strcasecmp(&pVal[len - 3], "u64") == 0) {
-    //printf("Type is uint64(%s)\n", pVal);
-    return true;
+
+  if (pParser->numOfKeys == SML_KEY_CHECK_LINEAR_NUM) {
+    for (int32_t i = 0; i < SML_KEY_CHECK_LINEAR_NUM; ++i) {
+      checkDuplicateKey(pParser->keys[i], pParser->pKeyHash, info);
+    }
   }
-  return false;
+
+  pParser->numOfKeys++;
+  return checkDuplicateKey(key, pParser->pKeyHash, info);
 }
 
-static bool isFloat(char *pVal, uint16_t len) {
-  if (len <= 3) {
-    return false;
+static void escapeSpecialCharacter(uint8_t field, const char **pos) {
+  const char *cur = *pos;
+  if (*cur != '\\') {
+    return;
   }
-  if (strcasecmp(&pVal[len - 3], "f32") == 0) {
-    //printf("Type is float(%s)\n", pVal);
-    return true;
+  switch (field) {
+    case 1:
+      switch (*(cur + 1)) {
+        case ',':
+        case ' ':
+          cur++;
+          break;
+        default:
+          break;
+      }
+      break;
+    case 2:
+      switch (*(cur + 1)) {
+        case ',':
+        case ' ':
+        case '=':
+          cur++;
+          break;
+        default:
+          break;
+      }
+      break;
+    case 3:
+      switch (*(cur + 1)) {
+        case '"':
+        case '\\':
+          cur++;
+          break;
+        default:
+          break;
+      }
+      break;
+    default:
+      break;
   }
-  return false;
+  *pos = cur;
 }
 
-static bool isDouble(char *pVal, uint16_t len) {
-  if (len <= 3) {
+char* addEscapeCharToString(char *str, int32_t len) {
+  if (str == NULL) {
+    return NULL;
+  }
+  memmove(str + 1, str, len);
+  str[0] = str[len + 1] = TS_BACKQUOTE_CHAR;
+  str[len + 2] = '\0';
+  return str;
+}
+
+bool isValidInteger(char *str) {
+  char *c = str;
+  if (*c != '+' && *c != '-' && !isdigit(*c)) {
     return false;
   }
-  if (strcasecmp(&pVal[len - 3], "f64") == 0) {
-    //printf("Type is double(%s)\n", pVal);
-    return true;
+  c++;
+  while (*c != '\0') {
+    if (!isdigit(*c)) {
+      return false;
+    }
+    c++;
   }
-  return false;
+  return true;
 }
 
-static bool isBool(char *pVal, uint16_t len, bool *bVal) {
-  if ((len == 1) && !strcasecmp(&pVal[len - 1], "t")) {
-    //printf("Type is bool(%c)\n", pVal[len - 1]);
-    *bVal = true;
-    return true;
-  }
-
-  if ((len == 1) && !strcasecmp(&pVal[len - 1], "f")) {
-    //printf("Type is bool(%c)\n", pVal[len - 1]);
-    *bVal = false;
-    return true;
-  }
+bool isValidFloat(char *str) {
+  char *c = str;
+  uint8_t has_dot, has_exp, has_sign;
+  has_dot = 0;
+  has_exp = 0;
+  has_sign = 0;
 
-  if((len == 4) && !strcasecmp(&pVal[len - 4], "true")) {
-    //printf("Type is bool(%s)\n", &pVal[len - 4]);
-    *bVal = true;
-    return true;
+  if (*c != '+' && *c != '-' && *c != '.' && !isdigit(*c)) {
+    return false;
   }
-  if((len == 5) && !strcasecmp(&pVal[len - 5], "false")) {
-    //printf("Type is bool(%s)\n", &pVal[len - 5]);
-    *bVal = false;
-    return true;
+  if (*c == '.' && isdigit(*(c + 1))) {
+    has_dot = 1;
   }
-  return false;
+  c++;
+  while (*c != '\0') {
+    if (!isdigit(*c)) {
+      switch (*c) {
+        case '.': {
+          if (!has_dot && !has_exp && isdigit(*(c + 1))) {
+            has_dot = 1;
+          } else {
+            return false;
+          }
+          break;
+        }
+        case 'e':
+        case 'E': {
+          if (!has_exp && isdigit(*(c - 1)) &&
+              (isdigit(*(c + 1)) ||
+               *(c + 1) == '+' ||
+               *(c + 1) == '-')) {
+            has_exp = 1;
+          } else {
+            return false;
+          }
+          break;
+        }
+        case '+':
+        case '-': {
+          if (!has_sign && has_exp && isdigit(*(c + 1))) {
+            has_sign = 1;
+          } else {
+            return false;
+          }
+          break;
+        }
+        default: {
+          return false;
+        }
+      }
+    }
+    c++;
+  } //while
+  return true;
 }
 
 static bool isBinary(char *pVal, uint16_t len) {
@@ -1724,30 +2253,76 @@ static int32_t isTimeStamp(char *pVal, uint16_t len, SMLTimeStampType *tsType, S
   //return false;
 }
 
-static bool convertStrToNumber(TAOS_SML_KV *pVal, char *str, SSmlLinesInfo* info) {
-  errno = 0;
-  uint8_t type = pVal->type;
-  int16_t length = pVal->length;
-  int64_t val_s = 0;
-  uint64_t val_u = 0;
-  double val_d = 0.0;
+static bool isBool(char *pVal, uint16_t len, bool *bVal) {
+  if ((len == 1) && !strcasecmp(&pVal[len - 1], "t")) {
+    //printf("Type is bool(%c)\n", pVal[len - 1]);
+    *bVal = true;
+    return true;
+  }
 
-  strntolower_s(str, str, (int32_t)strlen(str));
-  if (IS_FLOAT_TYPE(type)) {
-    val_d = strtod(str, NULL);
-  } else {
-    if (IS_SIGNED_NUMERIC_TYPE(type)) {
-      val_s = strtoll(str, NULL, 10);
-    } else {
-      val_u = strtoull(str, NULL, 10);
-    }
+  if ((len == 1) && !strcasecmp(&pVal[len - 1], "f")) {
+    //printf("Type is bool(%c)\n", pVal[len - 1]);
+    *bVal = false;
+    return true;
+  }
+
+  if((len == 4) && !strcasecmp(&pVal[len - 4], "true")) {
+    //printf("Type is bool(%s)\n", &pVal[len - 4]);
+    *bVal = true;
+    return true;
+  }
+  if((len == 5) && !strcasecmp(&pVal[len - 5], "false")) {
+    //printf("Type is bool(%s)\n", &pVal[len - 5]);
+    *bVal = false;
+    return true;
   }
+  return false;
+}
 
-  if (errno == ERANGE) {
-    tscError("SML:0x%"PRIx64" Convert number(%s) out of range", info->id, str);
+// parse the integer in one pass, it accepts the same strings as isValidInteger and gets the same value as strtoll and
+// strtoull, an out of range value is rejected
+static bool parseSmlInteger(const char *str, uint16_t len, bool isSigned, int64_t *pVal, uint64_t *pUVal) {
+  const char *cur = str;
+  const char *end = str + len;
+  bool        neg = false;
+
+  if (*cur == '+' || *cur == '-') {
+    neg = (*cur == '-');
+    cur++;
+  } else if (!isdigit((unsigned char)*cur)) {
     return false;
   }
 
+  uint64_t val = 0;
+  for (; cur < end; ++cur) {
+    if (!isdigit((unsigned char)*cur)) {
+      return false;
+    }
+
+    uint64_t digit = (uint64_t)(*cur - '0');
+    if (val > (UINT64_MAX - digit) / 10) {
+      return false;
+    }
+    val = val * 10 + digit;
+  }
+
+  if (isSigned) {
+    // INT64_MIN is not a valid bigint either
+    if (val > INT64_MAX) {
+      return false;
+    }
+    *pVal = neg ? -(int64_t)val : (int64_t)val;
+  } else {
+    *pUVal = neg ? (0 - val) : val;
+  }
+
+  return true;
+}
+
+static bool setSmlNumberValue(TAOS_SML_KV *pVal, int64_t val_s, uint64_t val_u, double val_d) {
+  uint8_t type = pVal->type;
+  int16_t length = pVal->length;
+
   switch (type) {
     case TSDB_DATA_TYPE_TINYINT:
       if (!IS_VALID_TINYINT(val_s)) {
@@ -1824,6 +2399,68 @@ static bool convertStrToNumber(TAOS_SML_KV *pVal, char *str, SSmlLinesInfo* info
   }
   return true;
 }
+
+static bool convertStrToNumber(TAOS_SML_KV *pVal, char *str, uint16_t len, SSmlLinesInfo* info) {
+  int64_t  val_s = 0;
+  uint64_t val_u = 0;
+  double   val_d = 0.0;
+
+  if (IS_FLOAT_TYPE(pVal->type)) {
+    errno = 0;
+    val_d = strtod(str, NULL);
+    if (errno == ERANGE) {
+      tscError("SML:0x%"PRIx64" Convert number(%s) out of range", info->id, str);
+      return false;
+    }
+  } else if (!parseSmlInteger(str, len, IS_SIGNED_NUMERIC_TYPE(pVal->type), &val_s, &val_u)) {
+    tscError("SML:0x%"PRIx64" Convert number(%s) failed", info->id, str);
+    return false;
+  }
+
+  return setSmlNumberValue(pVal, val_s, val_u, val_d);
+}
+
+// get the number type from the suffix of the value, -1 is returned if there is no valid suffix
+static int32_t getSmlNumberSuffixType(const char *value, uint16_t len, uint16_t *suffixLen) {
+  char last = value[len - 1];
+
+  // the single character suffixes are case sensitive
+  if (len > 1 && (last == 'i' || last == 'u')) {
+    *suffixLen = 1;
+    return (last == 'i') ? TSDB_DATA_TYPE_BIGINT : TSDB_DATA_TYPE_UBIGINT;
+  }
+
+  if (len > 2 && last == '8') {
+    char sign = (char)tolower(value[len - 2]);
+    if (sign == 'i' || sign == 'u') {
+      *suffixLen = 2;
+      return (sign == 'i') ? TSDB_DATA_TYPE_TINYINT : TSDB_DATA_TYPE_UTINYINT;
+    }
+    return -1;
+  }
+
+  if (len <= 3 || !isdigit((unsigned char)last) || !isdigit((unsigned char)value[len - 2])) {
+    return -1;
+  }
+
+  int32_t bits = (value[len - 2] - '0') * 10 + (last - '0');
+  char    sign = (char)tolower(value[len - 3]);
+  *suffixLen = 3;
+
+  switch (bits) {
+    case 16:
+      return (sign == 'i') ? TSDB_DATA_TYPE_SMALLINT : ((sign == 'u') ? TSDB_DATA_TYPE_USMALLINT : -1);
+    case 32:
+      return (sign == 'i') ? TSDB_DATA_TYPE_INT
+                           : ((sign == 'u') ? TSDB_DATA_TYPE_UINT : ((sign == 'f') ? TSDB_DATA_TYPE_FLOAT : -1));
+    case 64:
+      return (sign == 'i') ? TSDB_DATA_TYPE_BIGINT
+                           : ((sign == 'u') ? TSDB_DATA_TYPE_UBIGINT : ((sign == 'f') ? TSDB_DATA_TYPE_DOUBLE : -1));
+    default:
+      return -1;
+  }
+}
+
 //len does not include '\0' from value.
 bool convertSmlValueType(TAOS_SML_KV *pVal, char *value,
                          uint16_t len, SSmlLinesInfo* info, bool isTag) {
@@ -1840,108 +2477,24 @@ bool convertSmlValueType(TAOS_SML_KV *pVal, char *value,
     return true;
   }
 
-  //integer number
-  bool has_sign;
-  if (isInteger(value, len, &has_sign)) {
-    pVal->type = has_sign ? TSDB_DATA_TYPE_BIGINT : TSDB_DATA_TYPE_UBIGINT;
-    pVal->length = (int16_t)tDataTypes[pVal->type].bytes;
-    value[len - 1] = '\0';
-    if (!isValidInteger(value) || !convertStrToNumber(pVal, value, info)) {
-      return false;
-    }
-    return true;
-  }
-  if (isTinyInt(value, len)) {
-    pVal->type = TSDB_DATA_TYPE_TINYINT;
-    pVal->length = (int16_t)tDataTypes[pVal->type].bytes;
-    value[len - 2] = '\0';
-    if (!isValidInteger(value) || !convertStrToNumber(pVal, value, info)) {
-      return false;
-    }
-    return true;
-  }
-  if (isTinyUint(value, len)) {
-    pVal->type = TSDB_DATA_TYPE_UTINYINT;
-    pVal->length = (int16_t)tDataTypes[pVal->type].bytes;
-    value[len - 2] = '\0';
-    if (!isValidInteger(value) || !convertStrToNumber(pVal, value, info)) {
-      return false;
-    }
-    return true;
-  }
-  if (isSmallInt(value, len)) {
-    pVal->type = TSDB_DATA_TYPE_SMALLINT;
-    pVal->length = (int16_t)tDataTypes[pVal->type].bytes;
-    value[len - 3] = '\0';
-    if (!isValidInteger(value) || !convertStrToNumber(pVal, value, info)) {
-      return false;
-    }
-    return true;
-  }
-  if (isSmallUint(value, len)) {
-    pVal->type = TSDB_DATA_TYPE_USMALLINT;
-    pVal->length = (int16_t)tDataTypes[pVal->type].bytes;
-    value[len - 3] = '\0';
-    if (!isValidInteger(value) || !convertStrToNumber(pVal, value, info)) {
-      return false;
-    }
-    return true;
-  }
-  if (isInt(value, len)) {
-    pVal->type = TSDB_DATA_TYPE_INT;
-    pVal->length = (int16_t)tDataTypes[pVal->type].bytes;
-    value[len - 3] = '\0';
-    if (!isValidInteger(value) || !convertStrToNumber(pVal, value, info)) {
-      return false;
-    }
-    return true;
-  }
-  if (isUint(value, len)) {
-    pVal->type = TSDB_DATA_TYPE_UINT;
-    pVal->length = (int16_t)tDataTypes[pVal->type].bytes;
-    value[len - 3] = '\0';
-    if (!isValidInteger(value) || !convertStrToNumber(pVal, value, info)) {
-      return false;
-    }
-    return true;
-  }
-  if (isBigInt(value, len)) {
-    pVal->type = TSDB_DATA_TYPE_BIGINT;
-    pVal->length = (int16_t)tDataTypes[pVal->type].bytes;
-    value[len - 3] = '\0';
-    if (!isValidInteger(value) || !convertStrToNumber(pVal, value, info)) {
-      return false;
-    }
-    return true;
-  }
-  if (isBigUint(value, len)) {
-    pVal->type = TSDB_DATA_TYPE_UBIGINT;
-    pVal->length = (int16_t)tDataTypes[pVal->type].bytes;
-    value[len - 3] = '\0';
-    if (!isValidInteger(value) || !convertStrToNumber(pVal, value, info)) {
-      return false;
-    }
-    return true;
-  }
-  //floating number
-  if (isFloat(value, len)) {
-    pVal->type = TSDB_DATA_TYPE_FLOAT;
-    pVal->length = (int16_t)tDataTypes[pVal->type].bytes;
-    value[len - 3] = '\0';
-    if (!isValidFloat(value) || !convertStrToNumber(pVal, value, info)) {
+  //integer and floating number, the type is told by the suffix in one look
+  uint16_t suffixLen = 0;
+  int32_t  type = getSmlNumberSuffixType(value, len, &suffixLen);
+  if (type >= 0) {
+    // an unsigned number with an explicit width cannot be negative
+    if (suffixLen > 1 && IS_UNSIGNED_NUMERIC_TYPE(type) && value[0] == '-') {
       return false;
     }
-    return true;
-  }
-  if (isDouble(value, len)) {
-    pVal->type = TSDB_DATA_TYPE_DOUBLE;
+
+    pVal->type = (uint8_t)type;
     pVal->length = (int16_t)tDataTypes[pVal->type].bytes;
-    value[len - 3] = '\0';
-    if (!isValidFloat(value) || !convertStrToNumber(pVal, value, info)) {
+    value[len - suffixLen] = '\0';
+    if (IS_FLOAT_TYPE(type) && !isValidFloat(value)) {
       return false;
     }
-    return true;
+    return convertStrToNumber(pVal, value, len - suffixLen, info);
   }
+
   //binary
   if (isBinary(value, len)) {
     pVal->type = TSDB_DATA_TYPE_BINARY;
@@ -1974,7 +2527,7 @@ bool convertSmlValueType(TAOS_SML_KV *pVal, char *value,
   if (isValidInteger(value) || isValidFloat(value)) {
     pVal->type = TSDB_DATA_TYPE_DOUBLE;
     pVal->length = (int16_t)tDataTypes[pVal->type].bytes;
-    if (!convertStrToNumber(pVal, value, info)) {
+    if (!convertStrToNumber(pVal, value, len, info)) {
       return false;
     }
     return true;
@@ -2098,7 +2651,7 @@ bool checkDuplicateKey(char *key, SHashObj *pHash, SSmlLinesInfo* info) {
   return false;
 }
 
-static int32_t parseSmlKey(TAOS_SML_KV *pKV, const char **index, SHashObj *pHash, SSmlLinesInfo* info) {
+static int32_t parseSmlKey(TAOS_SML_KV *pKV, const char **index, SSmlLineParser *pParser, SSmlLinesInfo* info) {
   const char *cur = *index;
   char key[TSDB_COL_NAME_LEN + 1];  // +1 to avoid key[len] over write
   int16_t len = 0;
@@ -2108,6 +2661,14 @@ static int32_t parseSmlKey(TAOS_SML_KV *pKV, const char **index, SHashObj *pHash
       tscError("SML:0x%"PRIx64" Key field cannot exceeds %d characters", info->id, TSDB_COL_NAME_LEN - 1);
       return TSDB_CODE_TSC_INVALID_COLUMN_LENGTH;
     }
+    int32_t n = smlSkipPlainChars(cur, pParser->end, '=', '\\', '=');
+    if (n > 0) {
+      n = MIN(n, TSDB_COL_NAME_LEN - len);
+      memcpy(key + len, cur, n);
+      cur += n;
+      len += n;
+      continue;
+    }
     //unescaped '=' identifies a tag key
     if (*cur == '=' && *(cur - 1) != '\\') {
       break;
@@ -2125,7 +2686,7 @@ static int32_t parseSmlKey(TAOS_SML_KV *pKV, const char **index, SHashObj *pHash
   }
   key[len] = '\0';
 
-  if (checkDuplicateKey(key, pHash, info)) {
+  if (smlCheckDuplicateKey(pParser, key, len, info)) {
     return TSDB_CODE_TSC_LINE_SYNTAX_ERROR;
   }
 
@@ -2138,10 +2699,11 @@ static int32_t parseSmlKey(TAOS_SML_KV *pKV, const char **index, SHashObj *pHash
 }
 
 
-static int32_t parseSmlValue(TAOS_SML_KV *pKV, const char **index,
+static int32_t parseSmlValue(TAOS_SML_KV *pKV, const char **index, const char *end,
                           bool *is_last_kv, SSmlLinesInfo* info, bool isTag) {
   const char *start, *cur, *tmp;
   int32_t ret = TSDB_CODE_SUCCESS;
+  char buf[64];
   char *value = NULL;
   int16_t len = 0;
   bool searchQuote = false;
@@ -2161,6 +2723,10 @@ static int32_t parseSmlValue(TAOS_SML_KV *pKV, const char **index,
   }
 
   while (1) {
+    int32_t n = smlSkipPlainChars(cur, end, ',', ' ', '\\');
+    cur += n;
+    len += n;
+
     // unescaped ',' or ' ' or '\0' identifies a value
     if (((*cur == ',' || *cur == ' ' ) && *(cur - 1) != '\\') || *cur == '\0') {
       if (searchQuote == true) {
@@ -2203,17 +2769,21 @@ static int32_t parseSmlValue(TAOS_SML_KV *pKV, const char **index,
     return TSDB_CODE_TSC_LINE_SYNTAX_ERROR;
   }
 
-  value = calloc(len + 1, 1);
+  value = (len < tListLen(buf)) ? buf : calloc(len + 1, 1);
   memcpy(value, start, len);
   value[len] = '\0';
   if (!convertSmlValueType(pKV, value, len, info, isTag)) {
     tscError("SML:0x%"PRIx64" Failed to convert sml value string(%s) to any type",
             info->id, value);
-    free(value);
+    if (value != buf) {
+      free(value);
+    }
     ret = TSDB_CODE_TSC_INVALID_VALUE;
     goto error;
   }
-  free(value);
+  if (value != buf) {
+    free(value);
+  }
 
   *index = (*cur == '\0') ? cur : cur + 1;
   return ret;
@@ -2225,7 +2795,7 @@ error:
   return ret;
 }
 
-static int32_t parseSmlMeasurement(TAOS_SML_DATA_POINT *pSml, const char **index,
+static int32_t parseSmlMeasurement(TAOS_SML_DATA_POINT *pSml, const char **index, const char *end,
                                    uint8_t *has_tags, SSmlLinesInfo* info) {
   const char *cur = *index;
   int16_t len = 0;
@@ -2242,6 +2812,14 @@ static int32_t parseSmlMeasurement(TAOS_SML_DATA_POINT *pSml, const char **index
       pSml->stableName = NULL;
       return TSDB_CODE_TSC_INVALID_TABLE_ID_LENGTH;
     }
+    int32_t n = smlSkipPlainChars(cur, end, ',', ' ', '\\');
+    if (n > 0) {
+      n = MIN(n, TSDB_TABLE_NAME_LEN - len);
+      memcpy(pSml->stableName + len, cur, n);
+      cur += n;
+      len += n;
+      continue;
+    }
     //first unescaped comma or space identifies measurement
     //if space detected first, meaning no tag in the input
     if (*cur == ',' && *(cur - 1) != '\\') {
@@ -2295,7 +2873,7 @@ int32_t isValidChildTableName(const char *pTbName, int16_t len, SSmlLinesInfo* i
 
 static int32_t parseSmlKvPairs(TAOS_SML_KV **pKVs, int *num_kvs,
                                const char **index, bool isField,
-                               TAOS_SML_DATA_POINT* smlData, SHashObj *pHash,
+                               TAOS_SML_DATA_POINT* smlData, SSmlLineParser *pParser,
                                SSmlLinesInfo* info) {
   const char *cur = *index;
   int32_t ret = TSDB_CODE_SUCCESS;
@@ -2323,12 +2901,12 @@ static int32_t parseSmlKvPairs(TAOS_SML_KV **pKVs, int *num_kvs,
   }
 
   while (*cur != '\0') {
-    ret = parseSmlKey(pkv, &cur, pHash, info);
+    ret = parseSmlKey(pkv, &cur, pParser, info);
     if (ret) {
       tscError("SML:0x%"PRIx64" Unable to parse key", info->id);
       goto error;
     }
-    ret = parseSmlValue(pkv, &cur, &is_last_kv, info, !isField);
+    ret = parseSmlValue(pkv, &cur, pParser->end, &is_last_kv, info, !isField);
     if (ret) {
       tscError("SML:0x%"PRIx64" Unable to parse value", info->id);
       goto error;
@@ -2401,41 +2979,39 @@ static void moveTimeStampToFirstKv(TAOS_SML_DATA_POINT** smlData, TAOS_SML_KV *t
   free(ts);
 }
 
-int32_t tscParseLine(const char* sql, TAOS_SML_DATA_POINT* smlData, SSmlLinesInfo* info) {
+static int32_t parseSmlLine(SSmlLineParser* pParser, const char* sql, TAOS_SML_DATA_POINT* smlData, SSmlLinesInfo* info) {
   const char* index = sql;
   int32_t ret = TSDB_CODE_SUCCESS;
   uint8_t has_tags = 0;
   TAOS_SML_KV *timestamp = NULL;
-  SHashObj *keyHashTable = taosHashInit(128, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), true, false);
 
-  ret = parseSmlMeasurement(smlData, &index, &has_tags, info);
+  pParser->end = sql + strlen(sql);
+  pParser->numOfKeys = 0;
+
+  ret = parseSmlMeasurement(smlData, &index, pParser->end, &has_tags, info);
   if (ret) {
     tscError("SML:0x%"PRIx64" Unable to parse measurement", info->id);
-    taosHashCleanup(keyHashTable);
     return ret;
   }
   tscDebug("SML:0x%"PRIx64" Parse measurement finished, has_tags:%d", info->id, has_tags);
 
   //Parse Tags
   if (has_tags) {
-    ret = parseSmlKvPairs(&smlData->tags, &smlData->tagNum, &index, false, smlData, keyHashTable, info);
+    ret = parseSmlKvPairs(&smlData->tags, &smlData->tagNum, &index, false, smlData, pParser, info);
     if (ret) {
       tscError("SML:0x%"PRIx64" Unable to parse tag", info->id);
-      taosHashCleanup(keyHashTable);
       return ret;
     }
   }
   tscDebug("SML:0x%"PRIx64" Parse tags finished, num of tags:%d", info->id, smlData->tagNum);
 
   //Parse fields
-  ret = parseSmlKvPairs(&smlData->fields, &smlData->fieldNum, &index, true, smlData, keyHashTable, info);
+  ret = parseSmlKvPairs(&smlData->fields, &smlData->fieldNum, &index, true, smlData, pParser, info);
   if (ret) {
     tscError("SML:0x%"PRIx64" Unable to parse field", info->id);
-    taosHashCleanup(keyHashTable);
     return ret;
   }
   tscDebug("SML:0x%"PRIx64" Parse fields finished, num of fields:%d", info->id, smlData->fieldNum);
-  taosHashCleanup(keyHashTable);
 
   //Parse timestamp
   ret = parseSmlTimeStamp(&timestamp, &index, info);
@@ -2449,6 +3025,15 @@ int32_t tscParseLine(const char* sql, TAOS_SML_DATA_POINT* smlData, SSmlLinesInf
   return TSDB_CODE_SUCCESS;
 }
 
+int32_t tscParseLine(const char* sql, TAOS_SML_DATA_POINT* smlData, SSmlLinesInfo* info) {
+  SSmlLineParser parser;
+  parser.pKeyHash = NULL;
+
+  int32_t ret = parseSmlLine(&parser, sql, smlData, info);
+  taosHashCleanup(parser.pKeyHash);
+  return ret;
+}
+
 //=========================================================================
 
 void destroySmlDataPoint(TAOS_SML_DATA_POINT* point) {
@@ -2466,21 +3051,134 @@ void destroySmlDataPoint(TAOS_SML_DATA_POINT* point) {
   free(point->childTableName);
 }
 
-int32_t tscParseLines(char* lines[], int numLines, SArray* points, SArray* failedLines, SSmlLinesInfo* info) {
-  for (int32_t i = 0; i < numLines; ++i) {
+#define SML_MIN_LINES_PER_PARSE_THREAD 1000
+
+typedef struct {
+  __sml_parse_line_fn_t fp;
+  char**                lines;
+  int32_t               start;
+  int32_t               numLines;
+  SArray*               points;
+  SSmlLinesInfo*        info;
+  int32_t               code;
+} SSmlParseTask;
+
+static void* smlParseLinesTask(void* param) {
+  SSmlParseTask* pTask = (SSmlParseTask*)param;
+  SSmlLinesInfo* info = pTask->info;
+
+  for (int32_t i = pTask->start; i < pTask->start + pTask->numLines; ++i) {
     TAOS_SML_DATA_POINT point = {0};
-    int32_t code = tscParseLine(lines[i], &point, info);
+    int32_t code = (*pTask->fp)(pTask->lines[i], &point, info);
     if (code != TSDB_CODE_SUCCESS) {
-      tscError("SML:0x%"PRIx64" data point line parse failed. line %d : %s", info->id, i, lines[i]);
+      tscError("SML:0x%"PRIx64" data point line parse failed. line %d : %s", info->id, i, pTask->lines[i]);
       destroySmlDataPoint(&point);
-      return code;
+      pTask->code = code;
+      break;
     } else {
       tscDebug("SML:0x%"PRIx64" data point line parse success. line %d", info->id, i);
     }
 
-    taosArrayPush(points, &point);
+    taosArrayPush(pTask->points, &point);
   }
-  return TSDB_CODE_SUCCESS;
+
+  return NULL;
+}
+
+static int32_t smlGetNumOfParseThreads(int numLines) {
+  int32_t numOfThreads = tsSmlParseThreads;
+  if (numOfThreads <= 0) {
+    numOfThreads = MIN(tsNumOfCores, numLines / SML_MIN_LINES_PER_PARSE_THREAD);
+  }
+
+  numOfThreads = MIN(numOfThreads, numLines);
+  return MAX(numOfThreads, 1);
+}
+
+/*
+ * The lines are divided into contiguous ranges parsed by different threads, the first range is parsed by the calling
+ * thread. The points are appended to the array in the order of the lines, and the code of the first failed line is
+ * returned.
+ */
+int32_t smlParseLinesInParallel(char* lines[], int numLines, SArray* points, SSmlLinesInfo* info,
+                                __sml_parse_line_fn_t fp) {
+  int32_t numOfThreads = smlGetNumOfParseThreads(numLines);
+  if (numOfThreads == 1) {
+    SSmlParseTask task = {.fp = fp, .lines = lines, .start = 0, .numLines = numLines, .points = points, .info = info};
+    smlParseLinesTask(&task);
+    return task.code;
+  }
+
+  SSmlParseTask* pTasks = calloc(numOfThreads, sizeof(SSmlParseTask));
+  pthread_t*     pThreads = calloc(numOfThreads, sizeof(pthread_t));
+  bool*          pStarted = calloc(numOfThreads, sizeof(bool));
+  if (pTasks == NULL || pThreads == NULL || pStarted == NULL) {
+    tfree(pTasks);
+    tfree(pThreads);
+    tfree(pStarted);
+    return TSDB_CODE_TSC_OUT_OF_MEMORY;
+  }
+
+  int32_t start = 0;
+  for (int32_t i = 0; i < numOfThreads; ++i) {
+    SSmlParseTask* pTask = pTasks + i;
+    pTask->fp = fp;
+    pTask->lines = lines;
+    pTask->start = start;
+    pTask->numLines = numLines / numOfThreads + ((i < numLines % numOfThreads) ? 1 : 0);
+    pTask->points = taosArrayInit(pTask->numLines, sizeof(TAOS_SML_DATA_POINT));
+    pTask->info = info;
+    start += pTask->numLines;
+
+    if (pTask->points == NULL) {
+      tscError("SML:0x%"PRIx64" failed to allocate memory for the points of parse task %d", info->id, i);
+      for (int32_t j = 0; j < i; ++j) {
+        taosArrayDestroy(&pTasks[j].points);
+      }
+      tfree(pTasks);
+      tfree(pThreads);
+      tfree(pStarted);
+      return TSDB_CODE_TSC_OUT_OF_MEMORY;
+    }
+  }
+
+  pthread_attr_t thattr;
+  pthread_attr_init(&thattr);
+  pthread_attr_setdetachstate(&thattr, PTHREAD_CREATE_JOINABLE);
+
+  // the ranges whose thread fails to be created are parsed by the calling thread
+  for (int32_t i = 1; i < numOfThreads; ++i) {
+    pStarted[i] = (pthread_create(pThreads + i, &thattr, smlParseLinesTask, pTasks + i) == 0);
+  }
+  pthread_attr_destroy(&thattr);
+
+  for (int32_t i = 0; i < numOfThreads; ++i) {
+    if (pStarted[i]) {
+      pthread_join(pThreads[i], NULL);
+    } else {
+      smlParseLinesTask(pTasks + i);
+    }
+  }
+
+  int32_t code = TSDB_CODE_SUCCESS;
+  for (int32_t i = 0; i < numOfThreads; ++i) {
+    SSmlParseTask* pTask = pTasks + i;
+    if (code == TSDB_CODE_SUCCESS) {
+      code = pTask->code;
+    }
+
+    taosArrayAddBatch(points, TARRAY_GET_START(pTask->points), (int32_t)taosArrayGetSize(pTask->points));
+    taosArrayDestroy(&pTask->points);
+  }
+
+  tfree(pTasks);
+  tfree(pThreads);
+  tfree(pStarted);
+  return code;
+}
+
+int32_t tscParseLines(char* lines[], int numLines, SArray* points, SArray* failedLines, SSmlLinesInfo* info) {
+  return smlParseLinesInParallel(lines, numLines, points, info, tscParseLine);
 }
 
 int taos_insert_lines(TAOS* taos, char* lines[], int numLines, SMLProtocolType protocol, SMLTimeStampType tsType, int *affectedRows) {
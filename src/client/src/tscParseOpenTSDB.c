@@ -400,20 +400,7 @@ static int32_t tscParseTelnetLine(const char* line, TAOS_SML_DATA_POINT* smlData
 }
 
 static int32_t tscParseTelnetLines(char* lines[], int numLines, SArray* points, SArray* failedLines, SSmlLinesInfo* info) {
-  for (int32_t i = 0; i < numLines; ++i) {
-    TAOS_SML_DATA_POINT point = {0};
-    int32_t code = tscParseTelnetLine(lines[i], &point, info);
-    if (code != TSDB_CODE_SUCCESS) {
-      tscError("OTD:0x%"PRIx64" data point line parse failed. line %d : %s", info->id, i, lines[i]);
-      destroySmlDataPoint(&point);
-      return code;
-    } else {
-      tscDebug("OTD:0x%"PRIx64" data point line parse success. line %d", info->id, i);
-    }
-
-    taosArrayPush(points, &point);
-  }
-  return TSDB_CODE_SUCCESS;
+  return smlParseLinesInParallel(lines, numLines, points, info, tscParseTelnetLine);
 }
 
 int taos_insert_telnet_lines(TAOS* taos, char* lines[], int numLines, SMLProtocolType protocol, SMLTimeStampType tsType, int* affectedRows) {
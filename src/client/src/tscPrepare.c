@@ -24,7 +24,6 @@
 #include "tscSubquery.h"
 
 int tsParseInsertSql(SSqlObj *pSql);
-int32_t tsCheckTimestamp(STableDataBlocks *pDataBlocks, const char *start);
 
 ////////////////////////////////////////////////////////////////////////////////
 // functions for normal statement preparation
@@ -35,6 +34,19 @@ typedef struct SNormalStmtPart {
   char* str;
 } SNormalStmtPart;
 
+/*
+ * The validated plan of a select statement whose parameters only bound the primary timestamp, like
+ * "select avg(c) from t where ts >= ? and ts < ?". It is created by the first execution, and the following executions
+ * skip the parsing, validation and table meta lookup, only the time window is patched.
+ */
+typedef struct SNormalStmtPlan {
+  bool               cacheable;     // all parameters bound the primary timestamp
+  int8_t            *winOptr;       // TK_GE/TK_GT/TK_LE/TK_LT/TK_EQ of each parameter
+  SSqlCmd            cmd;           // holder of the query info
+  SQueryInfo        *pQueryInfo;
+  SQueryMsgTemplate *pMsgTemplate;
+} SNormalStmtPlan;
+
 typedef struct SNormalStmt {
   uint16_t         sizeParts;
   uint16_t         numParts;
@@ -42,6 +54,7 @@ typedef struct SNormalStmt {
   char* sql;
   SNormalStmtPart* parts;
   tVariant*        params;
+  SNormalStmtPlan  plan;
 } SNormalStmt;
 
 typedef struct SMultiTbStmt {
@@ -94,6 +107,14 @@ typedef struct STscStmt {
                       STMT_RET(TSDB_CODE_TSC_DISCONNECTED);  \
                     }
 
+// the query statement is executed again after its result is taken by taos_stmt_use_result
+#define STMT_QUERY_CHECK if (pStmt == NULL || pStmt->taos == NULL || (pStmt->pSql == NULL && pStmt->isInsert)) { \
+                      STMT_RET(TSDB_CODE_TSC_DISCONNECTED);  \
+                    }
+
+// bytes of the rows filled by taos_stmt_bind_param_batch in a round, the columns are copied into them one by one
+#define STMT_BIND_TILE_SIZE (32 * 1024)
+
 static int32_t invalidOperationMsg(char* dstBuffer, const char* errMsg) {
   return tscInvalidOperationMsg(dstBuffer, errMsg, NULL);
 }
@@ -199,6 +220,10 @@ static int normalStmtBindParam(STscStmt* stmt, TAOS_BIND* bind) {
         break;
 
       default:
+        if (stmt->pSql == NULL) {  // the result of the last execution is taken
+          tscError("bind column%d: type mismatch or invalid", i);
+          return TSDB_CODE_TSC_INVALID_VALUE;
+        }
         tscError("0x%"PRIx64" bind column%d: type mismatch or invalid", stmt->pSql->self, i);
         return invalidOperationMsg(tscGetErrorMsgPayload(&stmt->pSql->cmd), "bind type mismatch or invalid");
     }
@@ -208,11 +233,112 @@ static int normalStmtBindParam(STscStmt* stmt, TAOS_BIND* bind) {
 }
 
 
+static bool isTimeRangeOptr(int32_t optr) {
+  return optr == TK_GE || optr == TK_GT || optr == TK_LE || optr == TK_LT || optr == TK_EQ;
+}
+
+/*
+ * The plan of the statement is cacheable if it is a select statement, each parameter is compared with the same column,
+ * and the column is not compared with anything else. Whether the column is the primary timestamp is verified by the
+ * time window of the first execution.
+ */
+static void normalStmtCheckPlan(STscStmt* stmt) {
+  SNormalStmtPlan* plan = &stmt->normal.plan;
+  char*            sql = stmt->pSql->sqlstr;
+
+  plan->cacheable = false;
+
+  SStrToken column = {0};
+  SStrToken prev[2] = {{0}};  // the two tokens before the current one
+  int32_t   numOfParams = 0;
+  int32_t   numOfOthers = 0;
+  bool      first = true;
+
+  for (uint32_t i = 0; sql[i] != 0;) {
+    SStrToken token = {.z = sql + i};
+    token.n = tGetToken(sql + i, &token.type);
+    i += token.n;
+
+    if (token.type == TK_SPACE || token.type == TK_COMMENT) {
+      continue;
+    }
+
+    if (first && token.type != TK_SELECT) {
+      return;
+    }
+    first = false;
+
+    if (token.type == TK_QUESTION) {
+      if (prev[0].type != TK_ID || !isTimeRangeOptr(prev[1].type)) {
+        return;
+      }
+
+      if (column.n == 0) {
+        column = prev[0];
+      } else if (column.n != prev[0].n || strncasecmp(column.z, prev[0].z, column.n) != 0) {
+        return;
+      }
+
+      int8_t* p = realloc(plan->winOptr, numOfParams + 1);
+      if (p == NULL) {
+        return;
+      }
+
+      plan->winOptr = p;
+      plan->winOptr[numOfParams++] = (int8_t)prev[1].type;
+    } else if (prev[0].type == TK_ID && isTimeRangeOptr(prev[1].type)) {
+      // the column is verified after all the parameters are found
+      numOfOthers++;
+    }
+
+    prev[0] = prev[1];
+    prev[1] = token;
+  }
+
+  if (numOfParams == 0) {
+    return;
+  }
+
+  // the window is not decided by the parameters only if the column is compared with anything else
+  if (numOfOthers > 0) {
+    memset(prev, 0, sizeof(prev));
+    for (uint32_t i = 0; sql[i] != 0;) {
+      SStrToken token = {.z = sql + i};
+      token.n = tGetToken(sql + i, &token.type);
+      i += token.n;
+
+      if (token.type == TK_SPACE || token.type == TK_COMMENT) {
+        continue;
+      }
+
+      if (token.type != TK_QUESTION && prev[0].type == TK_ID && isTimeRangeOptr(prev[1].type) &&
+          column.n == prev[0].n && strncasecmp(column.z, prev[0].z, column.n) == 0) {
+        return;
+      }
+
+      prev[0] = prev[1];
+      prev[1] = token;
+    }
+  }
+
+  plan->cacheable = true;
+}
+
 static int normalStmtPrepare(STscStmt* stmt) {
   SNormalStmt* normal = &stmt->normal;
-  char* sql = stmt->pSql->sqlstr;
   uint32_t i = 0, start = 0;
 
+  // before the parameters are replaced by '\0'
+  normalStmtCheckPlan(stmt);
+
+  // the parts refer to the sql string, which is kept after the sql object is freed by the execution
+  normal->sql = strdup(stmt->pSql->sqlstr);
+  if (normal->sql == NULL) {
+    return TSDB_CODE_TSC_OUT_OF_MEMORY;
+  }
+
+  char* sql = normal->sql;
+
   while (sql[i] != 0) {
     SStrToken token = {0};
     token.n = tGetToken(sql + i, &token.type);
@@ -254,6 +380,167 @@ static int normalStmtPrepare(STscStmt* stmt) {
   return TSDB_CODE_SUCCESS;
 }
 
+static bool normalStmtGetWindow(SNormalStmt* normal, STimeWindow* win) {
+  win->skey = INT64_MIN;
+  win->ekey = INT64_MAX;
+
+  for (uint16_t i = 0; i < normal->numParams; ++i) {
+    tVariant* var = normal->params + i;
+    if (var->nType != TSDB_DATA_TYPE_TIMESTAMP && var->nType != TSDB_DATA_TYPE_BIGINT &&
+        var->nType != TSDB_DATA_TYPE_INT) {
+      return false;
+    }
+
+    // the same as getTimeRange
+    switch (normal->plan.winOptr[i]) {
+      case TK_GE: win->skey = var->i64; break;
+      case TK_GT: win->skey = var->i64 + 1; break;
+      case TK_LE: win->ekey = var->i64; break;
+      case TK_LT: win->ekey = var->i64 - 1; break;
+      default:    win->skey = win->ekey = var->i64; break;
+    }
+  }
+
+  return true;
+}
+
+static int32_t normalStmtCopyQueryInfo(SQueryInfo* pQueryInfo, SQueryInfo* pSrc) {
+  int32_t code = tscQueryInfoCopy(pQueryInfo, pSrc);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  // not copied by tscQueryInfoCopy, which is used for the subqueries
+  pQueryInfo->udColumnId      = pSrc->udColumnId;
+  pQueryInfo->distinct        = pSrc->distinct;
+  pQueryInfo->onlyHasTagCond  = pSrc->onlyHasTagCond;
+  pQueryInfo->round           = pSrc->round;
+  pQueryInfo->havingFieldNum  = pSrc->havingFieldNum;
+  pQueryInfo->stableQuery     = pSrc->stableQuery;
+  pQueryInfo->groupbyColumn   = pSrc->groupbyColumn;
+  pQueryInfo->groupbyTag      = pSrc->groupbyTag;
+  pQueryInfo->simpleAgg       = pSrc->simpleAgg;
+  pQueryInfo->projectionQuery = pSrc->projectionQuery;
+  pQueryInfo->hasFilter       = pSrc->hasFilter;
+  pQueryInfo->onlyTagQuery    = pSrc->onlyTagQuery;
+  pQueryInfo->globalMerge     = pSrc->globalMerge;
+  pQueryInfo->isStddev        = pSrc->isStddev;
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static void normalStmtFreePlan(SNormalStmtPlan* plan) {
+  tscFreeQueryInfo(&plan->cmd, false, 0);
+  plan->pQueryInfo = NULL;
+  tfree(plan->pMsgTemplate);
+}
+
+// keep the plan of the first successful execution, if its time window is decided by the parameters only
+static void normalStmtSavePlan(STscStmt* stmt, SSqlObj* pSql) {
+  SNormalStmt*     normal = &stmt->normal;
+  SNormalStmtPlan* plan = &normal->plan;
+
+  if (!plan->cacheable || plan->pQueryInfo != NULL || pSql == NULL || pSql->res.code != TSDB_CODE_SUCCESS ||
+      pSql->cmd.command != TSDB_SQL_SELECT) {
+    return;
+  }
+
+  SQueryInfo* pQueryInfo = tscGetQueryInfo(&pSql->cmd);
+  if (pQueryInfo == NULL || pQueryInfo->command != TSDB_SQL_SELECT || pQueryInfo->sibling != NULL ||
+      pQueryInfo->numOfTables != 1 || taosArrayGetSize(pQueryInfo->pUpstream) > 0 ||
+      QUERY_IS_JOIN_QUERY(pQueryInfo->type) || pQueryInfo->tsBuf != NULL || pQueryInfo->pUdfInfo != NULL ||
+      pQueryInfo->fillType != TSDB_FILL_NONE || tscIsPointInterpQuery(pQueryInfo) ||
+      UTIL_TABLE_IS_SUPER_TABLE(tscGetMetaInfo(pQueryInfo, 0))) {
+    plan->cacheable = false;
+    return;
+  }
+
+  STimeWindow win;
+  if (!normalStmtGetWindow(normal, &win) || win.skey != pQueryInfo->window.skey ||
+      win.ekey != pQueryInfo->window.ekey) {
+    plan->cacheable = false;
+    return;
+  }
+
+  plan->pMsgTemplate = tscCreateQueryMsgTemplate(pSql);
+  if (plan->pMsgTemplate == NULL || tscAddQueryInfo(&plan->cmd) != TSDB_CODE_SUCCESS) {
+    normalStmtFreePlan(plan);
+    return;
+  }
+
+  plan->pQueryInfo = tscGetQueryInfo(&plan->cmd);
+  if (normalStmtCopyQueryInfo(plan->pQueryInfo, pQueryInfo) != TSDB_CODE_SUCCESS) {
+    normalStmtFreePlan(plan);
+    return;
+  }
+
+  tscDebug("0x%" PRIx64 " plan of the statement is cached, msgLen:%d", pSql->self, plan->pMsgTemplate->len);
+}
+
+// execute the cached plan with the time window of the parameters, the same as taos_query otherwise
+static SSqlObj* normalStmtExecutePlan(STscStmt* stmt, char* sql, STimeWindow* win) {
+  SNormalStmtPlan* plan = &stmt->normal.plan;
+  STscObj*         pObj = stmt->taos;
+
+  SSqlObj* pSql = calloc(1, sizeof(SSqlObj));
+  if (pSql == NULL) {
+    free(sql);
+    return NULL;
+  }
+
+  tsem_init(&pSql->rspSem, 0, 0);
+
+  pSql->signature = pSql;
+  pSql->param     = pObj;
+  pSql->pTscObj   = pObj;
+  pSql->maxRetry  = TSDB_MAX_REPLICA;
+  pSql->fp        = waitForQueryRsp;
+  pSql->fetchFp   = waitForQueryRsp;
+  pSql->rootObj   = pSql;
+  pSql->sqlstr    = sql;
+
+  registerSqlObj(pSql);
+  strntolower(pSql->sqlstr, sql, (int32_t)strlen(sql));
+  tscDebugL("0x%" PRIx64 " SQL: %s", pSql->self, pSql->sqlstr);
+
+  SSqlCmd* pCmd = &pSql->cmd;
+  pCmd->resColumnId = TSDB_RES_COL_ID;
+  pCmd->command = TSDB_SQL_SELECT;
+
+  int32_t code = tscAllocPayload(pCmd, TSDB_DEFAULT_PAYLOAD_SIZE);
+  if (code == TSDB_CODE_SUCCESS) {
+    code = tscAddQueryInfo(pCmd);
+  }
+
+  SQueryInfo* pQueryInfo = NULL;
+  if (code == TSDB_CODE_SUCCESS) {
+    pQueryInfo = tscGetQueryInfo(pCmd);
+    code = normalStmtCopyQueryInfo(pQueryInfo, plan->pQueryInfo);
+  }
+
+  if (code == TSDB_CODE_SUCCESS) {
+    pQueryInfo->window = *win;
+    pCmd->pMsgTemplate = malloc(sizeof(SQueryMsgTemplate) + plan->pMsgTemplate->len);
+    if (pCmd->pMsgTemplate == NULL) {
+      code = TSDB_CODE_TSC_OUT_OF_MEMORY;
+    } else {
+      memcpy(pCmd->pMsgTemplate, plan->pMsgTemplate, sizeof(SQueryMsgTemplate) + plan->pMsgTemplate->len);
+    }
+  }
+
+  if (code != TSDB_CODE_SUCCESS) {
+    pSql->res.code = code;
+    return pSql;
+  }
+
+  taosAcquireRef(tscObjRef, pSql->self);
+  executeQuery(pSql, pQueryInfo);
+  taosReleaseRef(tscObjRef, pSql->self);
+
+  tsem_wait(&pSql->rspSem);
+  return pSql;
+}
+
 static char* normalStmtBuildSql(STscStmt* stmt) {
   SNormalStmt* normal = &stmt->normal;
   SStringBuilder sb; memset(&sb, 0, sizeof(sb));
@@ -889,7 +1176,7 @@ static int32_t insertStmtGenBlock(STscStmt* pStmt, STableDataBlocks** pBlock, ST
 }
 
 
-static int doBindBatchParam(STableDataBlocks* pBlock, SParamInfo* param, TAOS_MULTI_BIND* bind, int32_t rowNum) {
+static int checkBatchParam(SParamInfo* param, TAOS_MULTI_BIND* bind) {
   if (bind->buffer_type != param->type || !isValidDataType(param->type)) {
     tscError("column mismatch or invalid");
     return TSDB_CODE_TSC_INVALID_VALUE;
@@ -900,30 +1187,88 @@ static int doBindBatchParam(STableDataBlocks* pBlock, SParamInfo* param, TAOS_MU
     return TSDB_CODE_TSC_INVALID_VALUE;
   }
 
-  for (int i = 0; i < bind->num; ++i) {
-    char* data = pBlock->pData + sizeof(SSubmitBlk) + pBlock->rowSize * (rowNum + i);
+  return TSDB_CODE_SUCCESS;
+}
 
-    if (bind->is_null != NULL && bind->is_null[i]) {
-      setNull(data + param->offset, param->type, param->bytes);
-      continue;
+// the primary timestamp of a row can not be null, and a null one must not reach tsCheckTimestamp as the server time
+static bool hasNullPrimaryTimestamp(SParamInfo* param, TAOS_MULTI_BIND* bind) {
+  if (param->offset != 0 || bind->is_null == NULL) {
+    return false;
+  }
+
+  for (int32_t i = 0; i < bind->num; ++i) {
+    if (bind->is_null[i]) {
+      return true;
     }
+  }
+  return false;
+}
 
-    if (!IS_VAR_DATA_TYPE(param->type)) {
-      memcpy(data + param->offset, (char *)bind->buffer + bind->buffer_length * i, tDataTypes[param->type].bytes);
+// copy the values of a fixed length column with a loop of its own type, instead of checking the type of each value
+#define BIND_BATCH_COPY(_type)                                                        \
+  do {                                                                               \
+    for (int32_t i = start; i < end; ++i, data += pBlock->rowSize, src += stride) {   \
+      memcpy(data, src, sizeof(_type));                                              \
+    }                                                                                \
+  } while (0)
+
+// bind the values [start, end) of a column to the rows from rowNum + start on
+static int doBindBatchParam(STableDataBlocks* pBlock, SParamInfo* param, TAOS_MULTI_BIND* bind, int32_t rowNum,
+                            int32_t start, int32_t end) {
+  char*   pRows = pBlock->pData + sizeof(SSubmitBlk) + pBlock->rowSize * rowNum;
+  int32_t stride = (int32_t)bind->buffer_length;
+
+  if (!IS_VAR_DATA_TYPE(param->type)) {
+    char*       data = pRows + pBlock->rowSize * start + param->offset;
+    const char* src = (const char*)bind->buffer + stride * start;
+
+    switch (tDataTypes[param->type].bytes) {
+      case sizeof(int8_t):  BIND_BATCH_COPY(int8_t);  break;
+      case sizeof(int16_t): BIND_BATCH_COPY(int16_t); break;
+      case sizeof(int32_t): BIND_BATCH_COPY(int32_t); break;
+      case sizeof(int64_t): BIND_BATCH_COPY(int64_t); break;
+      default:
+        for (int32_t i = start; i < end; ++i, data += pBlock->rowSize, src += stride) {
+          memcpy(data, src, tDataTypes[param->type].bytes);
+        }
+        break;
+    }
 
-      if (param->offset == 0) {
-        if (tsCheckTimestamp(pBlock, data + param->offset) != TSDB_CODE_SUCCESS) {
+    if (bind->is_null != NULL) {
+      for (int32_t i = start; i < end; ++i) {
+        if (bind->is_null[i]) {
+          setNull(pRows + pBlock->rowSize * i + param->offset, param->type, param->bytes);
+        }
+      }
+    }
+
+    if (param->offset == 0) {
+      for (int32_t i = start; i < end; ++i) {
+        if (tsCheckTimestamp(pBlock, pRows + pBlock->rowSize * i) != TSDB_CODE_SUCCESS) {
           tscError("invalid timestamp");
           return TSDB_CODE_TSC_INVALID_VALUE;
         }
       }
-    } else if (param->type == TSDB_DATA_TYPE_BINARY) {
+    }
+
+    return TSDB_CODE_SUCCESS;
+  }
+
+  for (int32_t i = start; i < end; ++i) {
+    char* data = pRows + pBlock->rowSize * i + param->offset;
+
+    if (bind->is_null != NULL && bind->is_null[i]) {
+      setNull(data, param->type, param->bytes);
+      continue;
+    }
+
+    if (param->type == TSDB_DATA_TYPE_BINARY) {
       if (bind->length[i] > (uintptr_t)param->bytes) {
         tscError("binary length too long, ignore it, max:%d, actual:%d", param->bytes, (int32_t)bind->length[i]);
         return TSDB_CODE_TSC_INVALID_VALUE;
       }
       int16_t bsize = (short)bind->length[i];
-      STR_WITH_SIZE_TO_VARSTR(data + param->offset, (char *)bind->buffer + bind->buffer_length * i, bsize);
+      STR_WITH_SIZE_TO_VARSTR(data, (char *)bind->buffer + bind->buffer_length * i, bsize);
     } else if (param->type == TSDB_DATA_TYPE_NCHAR) {
       if (bind->length[i] > (uintptr_t)param->bytes) {
         tscError("nchar string length too long, ignore it, max:%d, actual:%d", param->bytes, (int32_t)bind->length[i]);
@@ -931,12 +1276,12 @@ static int doBindBatchParam(STableDataBlocks* pBlock, SParamInfo* param, TAOS_MU
       }
 
       int32_t output = 0;
-      if (!taosMbsToUcs4((char *)bind->buffer + bind->buffer_length * i, bind->length[i], varDataVal(data + param->offset), param->bytes - VARSTR_HEADER_SIZE, &output)) {
+      if (!taosMbsToUcs4((char *)bind->buffer + bind->buffer_length * i, bind->length[i], varDataVal(data), param->bytes - VARSTR_HEADER_SIZE, &output)) {
         tscError("convert nchar string to UCS4_LE failed:%s", (char*)((char *)bind->buffer + bind->buffer_length * i));
         return TSDB_CODE_TSC_INVALID_VALUE;
       }
 
-      varDataSetLen(data + param->offset, output);
+      varDataSetLen(data, output);
     }
   }
 
@@ -1068,18 +1413,54 @@ static int insertStmtBindParamBatch(STscStmt* stmt, TAOS_MULTI_BIND* bind, int c
         return invalidOperationMsg(tscGetErrorMsgPayload(&stmt->pSql->cmd), "bind row num mismatch");
       }
 
-      int code = doBindBatchParam(pBlock, param, &bind[param->idx], pCmd->batchSize);
-      if (code != TSDB_CODE_SUCCESS) {
+      if (checkBatchParam(param, &bind[param->idx]) != TSDB_CODE_SUCCESS) {
         tscError("0x%"PRIx64" bind column %d: type mismatch or invalid", pStmt->pSql->self, param->idx);
         return invalidOperationMsg(tscGetErrorMsgPayload(&stmt->pSql->cmd), "bind column type mismatch or invalid");
       }
+
+      if (hasNullPrimaryTimestamp(param, &bind[param->idx])) {
+        tscError("0x%"PRIx64" bind column %d: primary timestamp is null", pStmt->pSql->self, param->idx);
+        return invalidOperationMsg(tscGetErrorMsgPayload(&stmt->pSql->cmd), "primary timestamp column can not be null");
+      }
+    }
+
+    // the columns are bound to a few rows at a time, so that the rows stay in the cache while all the columns are
+    // copied into them, it matters for the tables of hundreds of columns
+    int32_t tileRows = STMT_BIND_TILE_SIZE / pBlock->rowSize;
+    if (tileRows <= 0) {
+      tileRows = 1;
+    }
+
+    for (int32_t start = 0; start < rowNum; start += tileRows) {
+      int32_t end = start + tileRows;
+      if (end > rowNum) {
+        end = rowNum;
+      }
+
+      for (uint32_t j = 0; j < pBlock->numOfParams; ++j) {
+        SParamInfo* param = &pBlock->params[j];
+
+        int code = doBindBatchParam(pBlock, param, &bind[param->idx], pCmd->batchSize, start, end);
+        if (code != TSDB_CODE_SUCCESS) {
+          tscError("0x%"PRIx64" bind column %d: type mismatch or invalid", pStmt->pSql->self, param->idx);
+          return invalidOperationMsg(tscGetErrorMsgPayload(&stmt->pSql->cmd), "bind column type mismatch or invalid");
+        }
+      }
     }
 
     pCmd->batchSize += rowNum - 1;
   } else {
     SParamInfo* param = &pBlock->params[colIdx];
 
-    int code = doBindBatchParam(pBlock, param, bind, pCmd->batchSize);
+    if (hasNullPrimaryTimestamp(param, bind)) {
+      tscError("0x%"PRIx64" bind column %d: primary timestamp is null", pStmt->pSql->self, param->idx);
+      return invalidOperationMsg(tscGetErrorMsgPayload(&stmt->pSql->cmd), "primary timestamp column can not be null");
+    }
+
+    int code = checkBatchParam(param, bind);
+    if (code == TSDB_CODE_SUCCESS) {
+      code = doBindBatchParam(pBlock, param, bind, pCmd->batchSize, 0, bind->num);
+    }
     if (code != TSDB_CODE_SUCCESS) {
       tscError("0x%"PRIx64" bind column %d: type mismatch or invalid", pStmt->pSql->self, param->idx);
       return invalidOperationMsg(tscGetErrorMsgPayload(&stmt->pSql->cmd), "bind column type mismatch or invalid");
@@ -1920,6 +2301,8 @@ int taos_stmt_close(TAOS_STMT* stmt) {
     }
     free(normal->parts);
     free(normal->sql);
+    normalStmtFreePlan(&normal->plan);
+    tfree(normal->plan.winOptr);
   } else {
     if (pStmt->multiTbInsert) {
       taosHashCleanup(pStmt->mtb.pTableHash);
@@ -1946,7 +2329,7 @@ int taos_stmt_close(TAOS_STMT* stmt) {
 
 int taos_stmt_bind_param(TAOS_STMT* stmt, TAOS_BIND* bind) {
   STscStmt* pStmt = (STscStmt*)stmt;
-  STMT_CHECK
+  STMT_QUERY_CHECK
 
   if (pStmt->isInsert) {
     if (pStmt->multiTbInsert) {
@@ -2077,7 +2460,7 @@ int taos_stmt_reset(TAOS_STMT* stmt) {
 int taos_stmt_execute(TAOS_STMT* stmt) {
   int ret = 0;
   STscStmt* pStmt = (STscStmt*)stmt;
-  STMT_CHECK
+  STMT_QUERY_CHECK
 
   if (pStmt->isInsert) {
     if (pStmt->last != STMT_ADD_BATCH) {
@@ -2098,11 +2481,31 @@ int taos_stmt_execute(TAOS_STMT* stmt) {
     if (sql == NULL) {
       ret = TSDB_CODE_TSC_OUT_OF_MEMORY;
     } else {
-      taosReleaseRef(tscObjRef, pStmt->pSql->self);
-      pStmt->pSql = taos_query((TAOS*)pStmt->taos, sql);
+      SNormalStmtPlan* plan = &pStmt->normal.plan;
+      STimeWindow      win = {0};
+
+      if (pStmt->pSql != NULL) {
+        taosReleaseRef(tscObjRef, pStmt->pSql->self);
+      }
+
+      if (plan->pQueryInfo != NULL && normalStmtGetWindow(&pStmt->normal, &win) && win.skey <= win.ekey) {
+        pStmt->pSql = normalStmtExecutePlan(pStmt, sql, &win);
+        if (pStmt->pSql == NULL) {
+          STMT_RET(TSDB_CODE_TSC_OUT_OF_MEMORY);
+        }
+
+        // the table meta is renewed, the plan may be stale
+        if (pStmt->pSql->res.code != TSDB_CODE_SUCCESS || pStmt->pSql->retry > 0) {
+          normalStmtFreePlan(plan);
+        }
+      } else {
+        pStmt->pSql = taos_query((TAOS*)pStmt->taos, sql);
+        normalStmtSavePlan(pStmt, pStmt->pSql);
+        free(sql);
+      }
+
       pStmt->numOfRows += taos_affected_rows(pStmt->pSql);
       ret = taos_errno(pStmt->pSql);
-      free(sql);
     }
   }
 
@@ -27,12 +27,17 @@
 #include "tsclient.h"
 #include "ttimer.h"
 
+#define TSC_FLOWCTRL_MAX_RETRY   20
+#define TSC_FLOWCTRL_MAX_WAIT_MS 5000
+
 int (*tscBuildMsg[TSDB_SQL_MAX])(SSqlObj *pSql, SSqlInfo *pInfo) = {0};
 
 int (*tscProcessMsgRsp[TSDB_SQL_MAX])(SSqlObj *pSql);
 void tscProcessActivityTimer(void *handle, void *tmrId);
 int tscKeepConn[TSDB_SQL_MAX] = {0};
 
+static int64_t tscFetchAheadBytes = 0;  // memory of the responses kept by fetch ahead of all queries
+
 TSKEY tscGetSubscriptionProgress(void* sub, int64_t uid, TSKEY dflt);
 void tscUpdateSubscriptionProgress(void* sub, int64_t uid, TSKEY ts);
 void tscSaveSubscriptionProgress(void* sub);
@@ -403,7 +408,50 @@ bool shouldRewTableMeta(SSqlObj* pSql, SRpcMsg* rpcMsg) {
   return true;
 }
 
-void tscProcessMsgFromServer(SRpcMsg *rpcMsg, SRpcEpSet *pEpSet) {
+static void tscResendFlowCtrlMsg(void *param, void *tmrId) {
+  int64_t  rid = (int64_t)param;
+  SSqlObj *pSql = (SSqlObj *)taosAcquireRef(tscObjRef, rid);
+  if (pSql == NULL) {
+    return;
+  }
+
+  int32_t code = tscSendMsgToServer(pSql);
+  if (code != TSDB_CODE_SUCCESS) {
+    pSql->res.code = code;
+    tscAsyncResultOnError(pSql);
+  }
+
+  taosReleaseRef(tscObjRef, rid);
+}
+
+// the vnode is short of memory and tells when it expects to accept the submit again, resend it then
+static bool tscRetryFlowCtrlMsg(SSqlObj *pSql, SRpcMsg *rpcMsg) {
+  if (pSql->cmd.command != TSDB_SQL_INSERT || rpcMsg->code != TSDB_CODE_VND_IS_FLOWCTRL ||
+      rpcMsg->pCont == NULL || rpcMsg->contLen < (int32_t)sizeof(SShellFlowCtrlRspMsg)) {
+    return false;
+  }
+
+  if (++pSql->flowCtrlRetry > TSC_FLOWCTRL_MAX_RETRY) {
+    tscError("0x%" PRIx64 " max flow control retry %d reached, give up", pSql->self, TSC_FLOWCTRL_MAX_RETRY);
+    return false;
+  }
+
+  SShellFlowCtrlRspMsg *pRsp = (SShellFlowCtrlRspMsg *)rpcMsg->pCont;
+  int32_t retryAfter = htonl(pRsp->retryAfter);
+  if (retryAfter <= 0) retryAfter = 1;
+  if (retryAfter > TSC_FLOWCTRL_MAX_WAIT_MS) retryAfter = TSC_FLOWCTRL_MAX_WAIT_MS;
+
+  tscDebug("0x%" PRIx64 " vnode is in flow control, resend submit after %dms, retry:%d", pSql->self, retryAfter,
+           pSql->flowCtrlRetry);
+
+  void *tmrId = NULL;
+  taosTmrReset(tscResendFlowCtrlMsg, retryAfter, (void *)pSql->self, tscTmr, &tmrId);
+  return true;
+}
+
+static bool tscKeepFetchAheadRsp(SSqlObj *pSql, SRpcMsg *rpcMsg);
+
+static void doProcessMsgFromServer(SRpcMsg *rpcMsg, SRpcEpSet *pEpSet, bool fetchedAhead) {
   TSDB_CACHE_PTR_TYPE handle = (TSDB_CACHE_PTR_TYPE) rpcMsg->ahandle;
   SSqlObj* pSql = (SSqlObj*)taosAcquireRef(tscObjRef, handle);
   if (pSql == NULL) {
@@ -455,6 +503,17 @@ void tscProcessMsgFromServer(SRpcMsg *rpcMsg, SRpcEpSet *pEpSet) {
     pSql->cmd.insertParam.schemaAttached = 1;
   }
 
+  if (tscRetryFlowCtrlMsg(pSql, rpcMsg)) {
+    taosReleaseRef(tscObjRef, handle);
+    rpcFreeCont(rpcMsg->pCont);
+    return;
+  }
+
+  if (!fetchedAhead && tscKeepFetchAheadRsp(pSql, rpcMsg)) {
+    taosReleaseRef(tscObjRef, handle);
+    return;
+  }
+
   bool renewTableMeta = shouldRewTableMeta(pSql, rpcMsg);
  if (renewTableMeta) {
     pSql->retry += 1;
@@ -493,6 +552,7 @@ void tscProcessMsgFromServer(SRpcMsg *rpcMsg, SRpcEpSet *pEpSet) {
   if (pRes->code == TSDB_CODE_SUCCESS) {
     tscDebug("0x%"PRIx64" reset retry counter to be 0 due to success rsp, old:%d", pSql->self, pSql->retry);
     pSql->retry = 0;
+    pSql->flowCtrlRetry = 0;
   }
 
   if (pRes->code != TSDB_CODE_TSC_QUERY_CANCELLED) {
@@ -562,6 +622,15 @@ void tscProcessMsgFromServer(SRpcMsg *rpcMsg, SRpcEpSet *pEpSet) {
   rpcFreeCont(rpcMsg->pCont);
 }
 
+void tscProcessMsgFromServer(SRpcMsg *rpcMsg, SRpcEpSet *pEpSet) {
+  doProcessMsgFromServer(rpcMsg, pEpSet, false);
+}
+
+// the response kept by fetch ahead is processed as if it just arrived
+void tscProcessFetchAheadRsp(SRpcMsg *rpcMsg) {
+  doProcessMsgFromServer(rpcMsg, NULL, true);
+}
+
 int doBuildAndSendMsg(SSqlObj *pSql) {
   SSqlCmd *pCmd = &pSql->cmd;
   SSqlRes *pRes = &pSql->res;
@@ -675,6 +744,202 @@ int tscBuildFetchMsg(SSqlObj *pSql, SSqlInfo *pInfo) {
   return TSDB_CODE_SUCCESS;
 }
 
+static bool tscCanFetchAhead(SSqlObj *pSql) {
+  SSqlCmd *pCmd = &pSql->cmd;
+  SSqlRes *pRes = &pSql->res;
+
+  if (tsFetchAheadBlocks <= 0 || pCmd->command != TSDB_SQL_FETCH || pRes->code != TSDB_CODE_SUCCESS ||
+      pRes->completed || pRes->qId == 0 || pSql->rootObj != pSql || pSql->pStream != NULL ||
+      pSql->pSubscription != NULL) {
+    return false;
+  }
+
+  SQueryInfo *pQueryInfo = tscGetQueryInfo(pCmd);
+  return pQueryInfo != NULL && pQueryInfo->type != TSDB_QUERY_TYPE_FREE_RESOURCE &&
+         taosArrayGetSize(pQueryInfo->pUpstream) == 0;
+}
+
+static size_t tscNumOfKeptRsp(SFetchAhead *pAhead) {
+  return (pAhead->pRspList == NULL) ? 0 : taosArrayGetSize(pAhead->pRspList);
+}
+
+// no more blocks after this one, or the query has failed
+static bool tscIsLastBlockRsp(SRpcMsg *pMsg) {
+  return pMsg->code != TSDB_CODE_SUCCESS || pMsg->contLen < (int32_t)sizeof(SRetrieveTableRsp) ||
+         ((SRetrieveTableRsp *)pMsg->pCont)->completed == 1;
+}
+
+/*
+ * Reserve the sending of the next fetch request, the latch of fetch ahead is held by the caller. The memory budget is
+ * checked before the request is sent, so it may be exceeded by one block for each query.
+ */
+static bool tscReserveFetchAhead(SSqlObj *pSql) {
+  SFetchAhead *pAhead = &pSql->fetchAhead;
+
+  size_t numOfKept = tscNumOfKeptRsp(pAhead);
+  if (pAhead->state != TSC_FETCH_AHEAD_NONE || numOfKept >= (size_t)tsFetchAheadBlocks) {
+    return false;
+  }
+
+  if (numOfKept > 0 && tscIsLastBlockRsp(taosArrayGetLast(pAhead->pRspList))) {
+    return false;
+  }
+
+  if (atomic_load_64(&tscFetchAheadBytes) >= (int64_t)tsFetchAheadBufferSize * 1024 * 1024) {
+    tscDebug("0x%" PRIx64 " memory of blocks fetched ahead reaches %dMB, kept blocks:%d", pSql->self,
+             tsFetchAheadBufferSize, (int32_t)numOfKept);
+    return false;
+  }
+
+  // the list is never enlarged when a response is kept, so keeping a response never fails
+  if (pAhead->pRspList == NULL) {
+    pAhead->pRspList = taosArrayInit(tsFetchAheadBlocks, sizeof(SRpcMsg));
+    if (pAhead->pRspList == NULL) {
+      return false;
+    }
+  }
+
+  pAhead->state = TSC_FETCH_AHEAD_INFLIGHT;
+  pAhead->sending = 1;
+  return true;
+}
+
+static void tscSendFetchAheadMsg(SSqlObj *pSql) {
+  SFetchAhead *pAhead = &pSql->fetchAhead;
+
+  tscDebug("0x%" PRIx64 " fetch the next block ahead, qId:0x%" PRIx64, pSql->self, pSql->res.qId);
+
+  int32_t code = tscBuildFetchMsg(pSql, NULL);
+  if (code == TSDB_CODE_SUCCESS) {
+    code = tscSendMsgToServer(pSql);
+  }
+
+  if (code != TSDB_CODE_SUCCESS) {
+    taosWLockLatch(&pAhead->latch);
+    int8_t state = pAhead->state;
+    pAhead->state = TSC_FETCH_AHEAD_NONE;
+    taosWUnLockLatch(&pAhead->latch);
+
+    // the application is waiting for this block
+    if (state == TSC_FETCH_AHEAD_CLAIMED) {
+      pSql->res.code = code;
+      tscAsyncResultOnError(pSql);
+    }
+  }
+
+  atomic_store_8(&pAhead->sending, 0);
+}
+
+/*
+ * Send the fetch request of the next block while the application is processing the current one, so the round trip
+ * is overlapped with the processing. Since the vnode serves the fetch requests of a query one by one, only one request
+ * is in flight, and the next one is sent once its response is kept, until tsFetchAheadBlocks blocks are kept.
+ */
+void tscFetchNextBlockAhead(SSqlObj *pSql) {
+  if (!tscCanFetchAhead(pSql)) {
+    return;
+  }
+
+  SFetchAhead *pAhead = &pSql->fetchAhead;
+  taosWLockLatch(&pAhead->latch);
+  bool reserved = tscReserveFetchAhead(pSql);
+  taosWUnLockLatch(&pAhead->latch);
+
+  if (reserved) {
+    tscSendFetchAheadMsg(pSql);
+  }
+}
+
+/*
+ * The response of the fetch request sent ahead is kept in the sql object if the application has not asked for the next
+ * block yet, since the current block in pRes is still in use.
+ */
+static bool tscKeepFetchAheadRsp(SSqlObj *pSql, SRpcMsg *rpcMsg) {
+  SFetchAhead *pAhead = &pSql->fetchAhead;
+  bool         kept = false;
+  bool         fetchNext = false;
+
+  taosWLockLatch(&pAhead->latch);
+  int8_t state = pAhead->state;
+  pAhead->state = TSC_FETCH_AHEAD_NONE;
+
+  if (state == TSC_FETCH_AHEAD_INFLIGHT) {
+    taosArrayPush(pAhead->pRspList, rpcMsg);
+    atomic_add_fetch_64(&tscFetchAheadBytes, rpcMsg->contLen);
+    kept = true;
+
+    tscDebug("0x%" PRIx64 " keep the block fetched ahead, code:%s rspLen:%d, kept blocks:%d", pSql->self,
+             tstrerror(rpcMsg->code), rpcMsg->contLen, (int32_t)tscNumOfKeptRsp(pAhead));
+
+    fetchNext = !tscIsLastBlockRsp(rpcMsg) && tscCanFetchAhead(pSql) && tscReserveFetchAhead(pSql);
+  } else if (state == TSC_FETCH_AHEAD_ABANDONED) {
+    rpcFreeCont(rpcMsg->pCont);
+    kept = true;
+  }
+  taosWUnLockLatch(&pAhead->latch);
+
+  if (fetchNext) {
+    tscSendFetchAheadMsg(pSql);
+  }
+
+  return kept;
+}
+
+/*
+ * Take the first kept response, or mark the request in flight as claimed by the application. False is returned if the
+ * next block has not been requested ahead.
+ */
+bool tscTakeFetchAheadRsp(SSqlObj *pSql, SRpcMsg *pRspMsg) {
+  SFetchAhead *pAhead = &pSql->fetchAhead;
+  bool         used = true;
+
+  memset(pRspMsg, 0, sizeof(SRpcMsg));
+
+  taosWLockLatch(&pAhead->latch);
+  if (tscNumOfKeptRsp(pAhead) > 0) {
+    *pRspMsg = *(SRpcMsg *)taosArrayGet(pAhead->pRspList, 0);
+    taosArrayRemove(pAhead->pRspList, 0);
+    atomic_sub_fetch_64(&tscFetchAheadBytes, pRspMsg->contLen);
+  } else if (pAhead->state == TSC_FETCH_AHEAD_INFLIGHT) {
+    pAhead->state = TSC_FETCH_AHEAD_CLAIMED;
+  } else {
+    used = false;
+  }
+  taosWUnLockLatch(&pAhead->latch);
+
+  return used;
+}
+
+void tscDiscardFetchAheadRsp(SSqlObj *pSql) {
+  SFetchAhead *pAhead = &pSql->fetchAhead;
+
+  taosWLockLatch(&pAhead->latch);
+  if (pAhead->state == TSC_FETCH_AHEAD_INFLIGHT || pAhead->state == TSC_FETCH_AHEAD_CLAIMED) {
+    pAhead->state = TSC_FETCH_AHEAD_ABANDONED;
+  }
+
+  size_t numOfKept = tscNumOfKeptRsp(pAhead);
+  for (int32_t i = 0; i < numOfKept; ++i) {
+    SRpcMsg *pMsg = taosArrayGet(pAhead->pRspList, i);
+
+    // the query handle in vnode has been released if the kept block is the last one
+    if (pMsg->code == TSDB_CODE_SUCCESS && tscIsLastBlockRsp(pMsg)) {
+      pSql->res.completed = true;
+    }
+
+    atomic_sub_fetch_64(&tscFetchAheadBytes, pMsg->contLen);
+    rpcFreeCont(pMsg->pCont);
+  }
+
+  taosArrayDestroy(&pAhead->pRspList);
+  taosWUnLockLatch(&pAhead->latch);
+
+  // the payload is shared with the fetch request being sent ahead
+  while (atomic_load_8(&pAhead->sending)) {
+    taosMsleep(1);
+  }
+}
+
 int tscBuildSubmitMsg(SSqlObj *pSql, SSqlInfo *pInfo) {
   SQueryInfo *pQueryInfo = tscGetQueryInfo(&pSql->cmd);
   STableMeta* pTableMeta = tscGetMetaInfo(pQueryInfo, 0)->pTableMeta;
@@ -906,9 +1171,88 @@ static int32_t serializeSqlExpr(SSqlExpr* pExpr, STableMetaInfo* pTableMetaInfo,
   return TSDB_CODE_SUCCESS;
 }
 
+SQueryMsgTemplate *tscCreateQueryMsgTemplate(SSqlObj *pSql) {
+  SSqlCmd        *pCmd = &pSql->cmd;
+  SQueryTableMsg *pQueryMsg = (SQueryTableMsg *)pCmd->payload;
+
+  // only the query message on one table is patched
+  if (pCmd->msgType != TSDB_MSG_TYPE_QUERY || pCmd->payloadLen <= 0 || htonl(pQueryMsg->numOfTables) != 1) {
+    return NULL;
+  }
+
+  SQueryMsgTemplate *pTemplate = malloc(sizeof(SQueryMsgTemplate) + pCmd->payloadLen);
+  if (pTemplate == NULL) {
+    return NULL;
+  }
+
+  pTemplate->len           = pCmd->payloadLen;
+  pTemplate->tableIdOffset = pCmd->tableIdOffset;
+  pTemplate->sqlOffset     = pCmd->sqlOffset;
+  pTemplate->sqlLen        = htonl(pQueryMsg->sqlstrLen);
+  memcpy(pTemplate->msg, pCmd->payload, pCmd->payloadLen);
+
+  return pTemplate;
+}
+
+static int32_t tscBuildQueryMsgFromTemplate(SSqlObj *pSql) {
+  SSqlCmd           *pCmd = &pSql->cmd;
+  SQueryMsgTemplate *pTemplate = pCmd->pMsgTemplate;
+
+  SQueryInfo *pQueryInfo = tscGetQueryInfo(pCmd);
+  STableMeta *pTableMeta = tscGetMetaInfo(pQueryInfo, 0)->pTableMeta;
+
+  int32_t sqlLen = (int32_t)strlen(pSql->sqlstr);
+  int32_t tailLen = pTemplate->len - pTemplate->sqlOffset - pTemplate->sqlLen;
+  int32_t msgLen = pTemplate->sqlOffset + sqlLen + tailLen;
+
+  if (TSDB_CODE_SUCCESS != tscAllocPayloadFast(pCmd, msgLen + minMsgSize())) {
+    tscError("%p failed to malloc for query msg", pSql);
+    return TSDB_CODE_TSC_OUT_OF_MEMORY;
+  }
+
+  char *pMsg = pCmd->payload;
+  memcpy(pMsg, pTemplate->msg, pTemplate->sqlOffset);
+  memcpy(pMsg + pTemplate->sqlOffset, pSql->sqlstr, sqlLen);
+  memcpy(pMsg + pTemplate->sqlOffset + sqlLen, pTemplate->msg + pTemplate->sqlOffset + pTemplate->sqlLen, tailLen);
+
+  // the same as the window set by tscCreateQueryFromQueryInfo
+  STimeWindow win = pQueryInfo->window;
+  if (pQueryInfo->order.order != TSDB_ORDER_ASC) {
+    win.skey = pQueryInfo->window.ekey;
+    win.ekey = pQueryInfo->window.skey;
+  }
+
+  SQueryTableMsg *pQueryMsg = (SQueryTableMsg *)pMsg;
+  pQueryMsg->window.skey = htobe64(win.skey);
+  pQueryMsg->window.ekey = htobe64(win.ekey);
+  pQueryMsg->sqlstrLen   = htonl(sqlLen);
+  pQueryMsg->head.contLen = htonl(msgLen);
+
+  STableIdInfo *pTableIdInfo = (STableIdInfo *)(pMsg + pTemplate->tableIdOffset);
+  pTableIdInfo->key = htobe64(win.skey);
+
+  SNewVgroupInfo vgroupInfo = {0};
+  taosHashGetClone(UTIL_GET_VGROUPMAP(pSql), &pTableMeta->vgId, sizeof(pTableMeta->vgId), NULL, &vgroupInfo);
+  tscDumpEpSetFromVgroupInfo(&pSql->epSet, &vgroupInfo);
+  if (pSql->epSet.numOfEps > 0) {
+    pSql->epSet.inUse = rand() % pSql->epSet.numOfEps;
+  }
+
+  tscDebug("0x%" PRIx64 " msg built from template, len:%d bytes, window:[%" PRId64 ", %" PRId64 "]", pSql->self, msgLen,
+           pQueryInfo->window.skey, pQueryInfo->window.ekey);
+
+  pCmd->payloadLen = msgLen;
+  pCmd->msgType = TSDB_MSG_TYPE_QUERY;
+  return TSDB_CODE_SUCCESS;
+}
+
 int tscBuildQueryMsg(SSqlObj *pSql, SSqlInfo *pInfo) {
   SSqlCmd *pCmd = &pSql->cmd;
 
+  if (pCmd->pMsgTemplate != NULL) {
+    return tscBuildQueryMsgFromTemplate(pSql);
+  }
+
   SQueryInfo     *pQueryInfo = NULL;
   STableMeta     *pTableMeta = NULL;
   STableMetaInfo *pTableMetaInfo = NULL;
@@ -1037,6 +1381,7 @@ int tscBuildQueryMsg(SSqlObj *pSql, SSqlInfo *pInfo) {
   int32_t succeed = 1;
 
   // serialize the table info (sid, uid, tags)
+  pCmd->tableIdOffset = (int32_t)(pMsg - pCmd->payload);
   pMsg = doSerializeTableInfo(pQueryMsg, pSql, pTableMetaInfo, pMsg, &succeed);
   if (succeed == 0) {
     code = TSDB_CODE_TSC_APP_ERROR;
@@ -1172,6 +1517,7 @@ int tscBuildQueryMsg(SSqlObj *pSql, SSqlInfo *pInfo) {
     pQueryMsg->udfContentLen = 0;
   }
 
+  pCmd->sqlOffset = (int32_t)(pMsg - pCmd->payload);
   memcpy(pMsg, pSql->sqlstr, sqlLen);
   pMsg += sqlLen;
 
@@ -2200,6 +2546,8 @@ static void doUpdateVgroupInfo(SSqlObj *pSql, int32_t vgId, SVgroupMsg *pVgroupM
 }
 
 static void doAddTableMetaToLocalBuf(SSqlObj *pSql, STableMeta* pTableMeta, STableMetaMsg* pMetaMsg, bool updateSTable) {
+  int64_t bytes = 0;
+
   if (pTableMeta->tableType == TSDB_CHILD_TABLE) {
     // add or update the corresponding super table meta data info
     int32_t len = (int32_t) strnlen(pTableMeta->sTableName, TSDB_TABLE_FNAME_LEN);
@@ -2211,16 +2559,23 @@ static void doAddTableMetaToLocalBuf(SSqlObj *pSql, STableMeta* pTableMeta, STab
       int32_t code = taosHashPut(UTIL_GET_TABLEMETA(pSql), pTableMeta->sTableName, len, pSupTableMeta, size);
       assert(code == TSDB_CODE_SUCCESS);
 
+      bytes += size;
       tfree(pSupTableMeta);
     }
 
+    tscAddSTableNameToCache(pSql, pTableMeta->suid, pTableMeta->sTableName);
+
     CChildTableMeta* cMeta = tscCreateChildMeta(pTableMeta);
     taosHashPut(UTIL_GET_TABLEMETA(pSql), pMetaMsg->tableFname, strlen(pMetaMsg->tableFname), cMeta, sizeof(CChildTableMeta));
+    bytes += sizeof(CChildTableMeta);
     tfree(cMeta);
   } else {
     uint32_t s = tscGetTableMetaSize(pTableMeta);
     taosHashPut(UTIL_GET_TABLEMETA(pSql), pMetaMsg->tableFname, strlen(pMetaMsg->tableFname), pTableMeta, s);
+    bytes += s;
   }
+
+  tscEvictTableMetaCache(pSql, bytes);
 }
 
 int tscProcessTableMetaRsp(SSqlObj *pSql) {
@@ -2747,6 +3102,7 @@ int tscProcessDropDbRsp(SSqlObj *pSql) {
   //pSql->pTscObj->db[0] = 0;
   
   taosHashClear(UTIL_GET_TABLEMETA(pSql));
+  taosHashClear(pSql->pTscObj->pClusterInfo->stableNameMap);
   taosHashClear(UTIL_GET_VGROUPMAP(pSql));
   taosCacheEmpty(UTIL_GET_VGROUPLIST(pSql));
   return 0;
@@ -2754,6 +3110,9 @@ int tscProcessDropDbRsp(SSqlObj *pSql) {
 
 int tscProcessDropTableRsp(SSqlObj *pSql) {
   STableMetaInfo *pTableMetaInfo = tscGetTableMetaInfoFromCmd(&pSql->cmd, 0);
+  if (UTIL_TABLE_IS_SUPER_TABLE(pTableMetaInfo)) {
+    tscRemoveSTableNameFromCache(pSql, pTableMetaInfo->pTableMeta->id.uid);
+  }
   tscRemoveCachedTableMeta(pTableMetaInfo, pSql->self);
   tfree(pTableMetaInfo->pTableMeta);
   return 0;
@@ -2928,10 +3287,109 @@ int tscProcessRetrieveRspFromNode(SSqlObj *pSql) {
 
 void tscTableMetaCallBack(void *param, TAOS_RES *res, int code);
 
+/*
+ * Only one request retrieves the meta of a table from mnode at a time, the others asking for the same table wait for
+ * it, and parse their sql again once it is completed. If it failed, they will find the meta not cached and send their
+ * own requests.
+ */
+typedef struct SPendingTableMeta {
+  int64_t owner;    // the object retrieving the table meta, 0 if it is not sent yet
+  SArray *waiters;  // SArray<int64_t>
+} SPendingTableMeta;
+
+// returns true if the table meta is being retrieved by another request, and pSql waits for it
+static bool tscAddPendingTableMeta(SSqlObj *pSql, const char *name) {
+  SClusterInfo *pInfo = pSql->pTscObj->pClusterInfo;
+  size_t        len = strlen(name);
+  bool          wait = false;
+
+  pthread_mutex_lock(&pInfo->pendingMetaLock);
+  SPendingTableMeta *p = taosHashGet(pInfo->pendingMetaMap, name, len);
+  if (p != NULL) {
+    if (p->waiters == NULL) {
+      p->waiters = taosArrayInit(4, sizeof(int64_t));
+    }
+    wait = (p->waiters != NULL && taosArrayPush(p->waiters, &pSql->self) != NULL);
+  } else {
+    SPendingTableMeta pending = {0};
+    taosHashPut(pInfo->pendingMetaMap, name, len, &pending, sizeof(pending));
+  }
+  pthread_mutex_unlock(&pInfo->pendingMetaLock);
+
+  if (wait) {
+    tscDebug("0x%"PRIx64" wait for the table meta of %s being retrieved", pSql->self, name);
+  }
+  return wait;
+}
+
+static void tscSetPendingTableMetaOwner(SClusterInfo *pInfo, const char *name, int64_t owner) {
+  pthread_mutex_lock(&pInfo->pendingMetaLock);
+  SPendingTableMeta *p = taosHashGet(pInfo->pendingMetaMap, name, strlen(name));
+  if (p != NULL && p->owner == 0) {
+    p->owner = owner;
+  }
+  pthread_mutex_unlock(&pInfo->pendingMetaLock);
+}
+
+static void tscResumeTableMetaWaiter(SSchedMsg *pMsg) {
+  tscTableMetaCallBack(pMsg->ahandle, NULL, TSDB_CODE_SUCCESS);
+}
+
+// the waiters are resumed in the task queue, since the owner may be in its callback or being freed
+static void tscRemovePendingTableMeta(SClusterInfo *pInfo, const char *name, int64_t owner) {
+  size_t            len = strlen(name);
+  SPendingTableMeta pending = {0};
+
+  pthread_mutex_lock(&pInfo->pendingMetaLock);
+  SPendingTableMeta *p = taosHashGet(pInfo->pendingMetaMap, name, len);
+  if (p != NULL && p->owner == owner) {
+    pending = *p;
+    taosHashRemove(pInfo->pendingMetaMap, name, len);
+  }
+  pthread_mutex_unlock(&pInfo->pendingMetaLock);
+
+  size_t numOfWaiters = (pending.waiters == NULL)? 0:taosArrayGetSize(pending.waiters);
+  for (size_t i = 0; i < numOfWaiters; ++i) {
+    SSchedMsg schedMsg = {0};
+    schedMsg.fp = tscResumeTableMetaWaiter;
+    schedMsg.ahandle = (void *)(*(int64_t *)taosArrayGet(pending.waiters, i));
+    taosScheduleTask(tscQhandle, &schedMsg);
+  }
+
+  if (numOfWaiters > 0) {
+    tscDebug("0x%"PRIx64" table meta of %s is retrieved, resume %d waiting requests", owner, name, (int32_t)numOfWaiters);
+  }
+  taosArrayDestroy(&pending.waiters);
+}
+
+void tscFinishPendingTableMeta(SSqlObj *pSql) {
+  STableMetaInfo *pTableMetaInfo = tscGetTableMetaInfoFromCmd(&pSql->cmd, 0);
+  char            name[TSDB_TABLE_FNAME_LEN] = {0};
+
+  if (pTableMetaInfo != NULL && tNameExtractFullName(&pTableMetaInfo->name, name) == TSDB_CODE_SUCCESS) {
+    tscRemovePendingTableMeta(pSql->pTscObj->pClusterInfo, name, pSql->self);
+  }
+}
+
+static void tscPendingTableMetaCallBack(void *param, TAOS_RES *res, int code) {
+  tscFinishPendingTableMeta((SSqlObj *)res);
+  tscTableMetaCallBack(param, res, code);
+}
+
 static int32_t getTableMetaFromMnode(SSqlObj *pSql, STableMetaInfo *pTableMetaInfo, bool autocreate) {
+  char name[TSDB_TABLE_FNAME_LEN] = {0};
+  if (tNameExtractFullName(&pTableMetaInfo->name, name) != TSDB_CODE_SUCCESS) {
+    return TSDB_CODE_TSC_INVALID_OPERATION;
+  }
+
+  if (tscAddPendingTableMeta(pSql, name)) {
+    return TSDB_CODE_TSC_ACTION_IN_PROGRESS;
+  }
+
   SSqlObj *pNew = calloc(1, sizeof(SSqlObj));
   if (NULL == pNew) {
     tscError("0x%"PRIx64" malloc failed for new sqlobj to get table meta", pSql->self);
+    tscRemovePendingTableMeta(pSql->pTscObj->pClusterInfo, name, 0);
     return TSDB_CODE_TSC_OUT_OF_MEMORY;
   }
 
@@ -2950,6 +3408,7 @@ static int32_t getTableMetaFromMnode(SSqlObj *pSql, STableMetaInfo *pTableMetaIn
     tscError("0x%"PRIx64" malloc failed for payload to get table meta", pSql->self);
 
     tscFreeSqlObj(pNew);
+    tscRemovePendingTableMeta(pSql->pTscObj->pClusterInfo, name, 0);
     return TSDB_CODE_TSC_OUT_OF_MEMORY;
   }
 
@@ -2959,8 +3418,9 @@ static int32_t getTableMetaFromMnode(SSqlObj *pSql, STableMetaInfo *pTableMetaIn
   tNameAssign(&pNewTableMetaInfo->name, &pTableMetaInfo->name);
 
   registerSqlObj(pNew);
+  tscSetPendingTableMetaOwner(pSql->pTscObj->pClusterInfo, name, pNew->self);
 
-  pNew->fp    = tscTableMetaCallBack;
+  pNew->fp    = tscPendingTableMetaCallBack;
   pNew->param = (void *)pSql->self;
 
   tscDebug("0x%"PRIx64" new pSqlObj:0x%"PRIx64" to get tableMeta, auto create:%d, metaRid from %"PRId64" to %"PRId64,
@@ -2994,7 +3454,7 @@ static int32_t getTableMetaFromMnode(SSqlObj *pSql, STableMetaInfo *pTableMetaIn
   return code;
 }
 
-int32_t getMultiTableMetaFromMnode(SSqlObj *pSql, SArray* pNameList, SArray* pVgroupNameList, SArray* pUdfList, __async_cb_func_t fp, bool metaClone) {
+int32_t getMultiTableMetaFromMnode(SSqlObj *pSql, SArray* pNameList, SArray* pVgroupNameList, SArray* pUdfList, __async_cb_func_t fp, bool metaClone, bool skipMissing) {
   SSqlObj *pNew = calloc(1, sizeof(SSqlObj));
   if (NULL == pNew) {
     tscError("0x%"PRIx64" failed to allocate sqlobj to get multiple table meta", pSql->self);
@@ -3017,6 +3477,7 @@ int32_t getMultiTableMetaFromMnode(SSqlObj *pSql, SArray* pNameList, SArray* pVg
   }
 
   SMultiTableInfoMsg* pInfo = (SMultiTableInfoMsg*) pNew->cmd.payload;
+  pInfo->extend       = skipMissing? TSDB_MULTI_META_SKIP_MISSING:0;
   pInfo->metaClone    = metaClone? 1:0;
   pInfo->numOfTables  = htonl((uint32_t) taosArrayGetSize(pNameList));
   pInfo->numOfVgroups = htonl((uint32_t) taosArrayGetSize(pVgroupNameList));
@@ -3093,7 +3554,7 @@ int32_t tscGetTableMetaImpl(SSqlObj* pSql, STableMetaInfo *pTableMetaInfo, bool
     memset(pTableMetaInfo->pTableMeta, 0, pTableMetaInfo->tableMetaCapacity);
   }
 
-  if (NULL == taosHashGetCloneExt(UTIL_GET_TABLEMETA(pSql), name, len, NULL, (void **)&(pTableMetaInfo->pTableMeta), &pTableMetaInfo->tableMetaCapacity)) {
+  if (NULL == tscGetTableMetaFromCache(pSql, name, len, &pTableMetaInfo->pTableMeta, &pTableMetaInfo->tableMetaCapacity)) {
     tfree(pTableMetaInfo->pTableMeta);
      pTableMetaInfo->tableMetaCapacity = 0;
   }
@@ -3247,7 +3708,7 @@ int tscRenewTableMeta(SSqlObj *pSql) {
   tfree(rootSql->pSubs);
   tscResetSqlCmd(&rootSql->cmd, true, rootSql->self);
 
-  code = getMultiTableMetaFromMnode(rootSql, pNameList, vgroupList, NULL, tscTableMetaCallBack, true);
+  code = getMultiTableMetaFromMnode(rootSql, pNameList, vgroupList, NULL, tscTableMetaCallBack, true, false);
   taosArrayDestroyEx(&pNameList, freeElem);
   taosArrayDestroyEx(&vgroupList, freeElem);
 
@@ -564,6 +564,89 @@ int taos_fetch_block(TAOS_RES *res, TAOS_ROW *rows) {
   return pRes->numOfRows;
 }
 
+static int32_t tscSetResColumns(SSqlObj *pSql, int32_t numOfCols) {
+  SSqlRes    *pRes = &pSql->res;
+  SQueryInfo *pQueryInfo = tscGetQueryInfo(&pSql->cmd);
+
+  if (pRes->columns == NULL) {
+    pRes->columns = calloc(pRes->numOfCols, sizeof(TAOS_COLUMN));
+    if (pRes->columns == NULL) {
+      return TSDB_CODE_TSC_OUT_OF_MEMORY;
+    }
+  }
+
+  int8_t *pNull = realloc(pRes->isNull, (size_t)numOfCols * pRes->numOfRows);
+  if (pNull == NULL) {
+    return TSDB_CODE_TSC_OUT_OF_MEMORY;
+  }
+  pRes->isNull = pNull;
+
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SInternalField *pInfo = (SInternalField *)TARRAY_GET_ELEM(pQueryInfo->fieldsInfo.internalField, i);
+    TAOS_COLUMN    *pCol = &pRes->columns[i];
+
+    pCol->type   = pInfo->field.type;
+    pCol->bytes  = pInfo->field.bytes;
+    pCol->data   = pRes->urow[i];
+    pCol->isNull = pNull + (size_t)i * pRes->numOfRows;
+
+    char *p = pCol->data;
+    for (int32_t j = 0; j < pRes->numOfRows; ++j, p += pCol->bytes) {
+      pCol->isNull[j] = isNull(p, pCol->type) ? 1 : 0;
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+/*
+ * The block is returned column by column in the retrieved message without being pivoted into rows. The next block is
+ * requested from vnode before returning, and it is fetched while the application is processing this one.
+ */
+int taos_fetch_columns(TAOS_RES *res, TAOS_COLUMN **columns) {
+  SSqlObj *pSql = (SSqlObj *)res;
+  if (pSql == NULL || pSql->signature != pSql) {
+    terrno = TSDB_CODE_TSC_DISCONNECTED;
+    return 0;
+  }
+
+  SSqlCmd *pCmd = &pSql->cmd;
+  SSqlRes *pRes = &pSql->res;
+
+  *columns = NULL;
+  if (pRes->qId == 0 ||
+      pRes->code == TSDB_CODE_TSC_QUERY_CANCELLED ||
+      pCmd->command == TSDB_SQL_RETRIEVE_EMPTY_RESULT ||
+      pCmd->command == TSDB_SQL_INSERT) {
+    return 0;
+  }
+
+  tscResetForNextRetrieve(pRes);
+
+  // set the sql object owner
+  tscSetSqlOwner(pSql);
+
+  // current data set are exhausted, fetch more data from node
+  if (needToFetchNewBlock(pSql)) {
+    taos_fetch_rows_a(res, waitForRetrieveRsp, pSql->pTscObj);
+    tsem_wait(&pSql->rspSem);
+  }
+
+  int32_t numOfRows = pRes->numOfRows;
+  if (numOfRows > 0) {
+    int32_t code = tscSetResColumns(pSql, taos_num_fields(res));
+    if (code != TSDB_CODE_SUCCESS) {
+      pRes->code = code;
+      numOfRows = 0;
+    } else {
+      *columns = pRes->columns;
+    }
+  }
+
+  tscClearSqlOwner(pSql);
+  return numOfRows;
+}
+
 TAOS_ROW *taos_result_block(TAOS_RES *res) {
   SSqlObj *pSql = (SSqlObj *)res;
   if (pSql == NULL || pSql->signature != pSql) {
@@ -645,6 +728,8 @@ void taos_free_result(TAOS_RES *res) {
     return;
   }
 
+  tscDiscardFetchAheadRsp(pSql);
+
   bool freeNow = tscKillQueryInDnode(pSql);
   if (freeNow) {
     tscDebug("0x%"PRIx64" free sqlObj in cache", pSql->self);
@@ -1115,6 +1200,36 @@ static void freeElem(void* p) {
   tfree(*(char**)p);
 }
 
+// load the meta of the tables in pNameList into the local cache, the pSql is released here
+static int32_t doLoadMultiTableMeta(SSqlObj* pSql, SArray* pNameList) {
+  SArray* vgroupList = taosArrayInit(4, POINTER_BYTES);
+  if (vgroupList == NULL) {
+    tscFreeSqlObj(pSql);
+    return TSDB_CODE_TSC_OUT_OF_MEMORY;
+  }
+
+  pSql->cmd.pTableMetaMap = taosHashInit(taosArrayGetSize(pNameList), taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), false, HASH_NO_LOCK);
+  registerSqlObj(pSql);
+  tscDebug("0x%"PRIx64" load multiple table meta, numOfTables:%d pObj:%p", pSql->self, (int32_t)taosArrayGetSize(pNameList),
+           pSql->pTscObj);
+
+  int32_t code = getMultiTableMetaFromMnode(pSql, pNameList, vgroupList, NULL, loadMultiTableMetaCallback, false, false);
+  if (code == TSDB_CODE_TSC_ACTION_IN_PROGRESS) {
+    code = TSDB_CODE_SUCCESS;
+  }
+
+  taosArrayDestroyEx(&vgroupList, freeElem);
+
+  if (code != TSDB_CODE_SUCCESS) {
+    tscFreeRegisteredSqlObj(pSql);
+    return code;
+  }
+
+  tsem_wait(&pSql->rspSem);
+  tscFreeRegisteredSqlObj(pSql);
+  return code;
+}
+
 int taos_load_table_info(TAOS *taos, const char *tableNameList) {
   const int32_t MAX_TABLE_NAME_LENGTH = 12 * 1024 * 1024;  // 12MB list
 
@@ -1147,13 +1262,6 @@ int taos_load_table_info(TAOS *taos, const char *tableNameList) {
     return TSDB_CODE_TSC_OUT_OF_MEMORY;
   }
 
-  SArray* vgroupList = taosArrayInit(4, POINTER_BYTES);
-  if (vgroupList == NULL) {
-    taosArrayDestroy(&plist);
-    tfree(str);
-    return TSDB_CODE_TSC_OUT_OF_MEMORY;
-  }
-
   SSqlObj* pSql = calloc(1, sizeof(SSqlObj));
   tscAllocPayload(&pSql->cmd, 1024);
 
@@ -1167,28 +1275,33 @@ int taos_load_table_info(TAOS *taos, const char *tableNameList) {
   if (code != TSDB_CODE_SUCCESS) {
     tscFreeSqlObj(pSql);
     taosArrayDestroyEx(&plist, freeElem);
-    taosArrayDestroyEx(&vgroupList, freeElem);
     return code;
   }
 
-  pSql->cmd.pTableMetaMap = taosHashInit(taosArrayGetSize(plist), taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), false, HASH_NO_LOCK);
-  registerSqlObj(pSql);
-  tscDebug("0x%"PRIx64" load multiple table meta, tableNameList: %s pObj:%p", pSql->self, tableNameList, pObj);
+  code = doLoadMultiTableMeta(pSql, plist);
+  taosArrayDestroyEx(&plist, freeElem);
+  return code;
+}
 
-  code = getMultiTableMetaFromMnode(pSql, plist, vgroupList, NULL, loadMultiTableMetaCallback, false);
-  if (code == TSDB_CODE_TSC_ACTION_IN_PROGRESS) {
-    code = TSDB_CODE_SUCCESS;
+int32_t tscLoadMultiTableMeta(TAOS *taos, SArray *pNameList) {
+  STscObj *pObj = (STscObj *)taos;
+  if (pObj == NULL || pObj->signature != pObj) {
+    return TSDB_CODE_TSC_DISCONNECTED;
   }
 
-  taosArrayDestroyEx(&plist, freeElem);
-  taosArrayDestroyEx(&vgroupList, freeElem);
+  if (taosArrayGetSize(pNameList) == 0) {
+    return TSDB_CODE_SUCCESS;
+  }
 
-  if (code != TSDB_CODE_SUCCESS) {
-    tscFreeRegisteredSqlObj(pSql);
-    return code;
+  SSqlObj* pSql = calloc(1, sizeof(SSqlObj));
+  if (pSql == NULL || tscAllocPayload(&pSql->cmd, 1024) != TSDB_CODE_SUCCESS) {
+    tfree(pSql);
+    return TSDB_CODE_TSC_OUT_OF_MEMORY;
   }
 
-  tsem_wait(&pSql->rspSem);
-  tscFreeRegisteredSqlObj(pSql);
-  return code;
+  pSql->pTscObj   = taos;
+  pSql->signature = pSql;
+  pSql->rootObj   = pSql;
+
+  return doLoadMultiTableMeta(pSql, pNameList);
 }
@@ -25,6 +25,8 @@
 
 #include "tscProfile.h"
 #include "tscSubquery.h"
+#include "ttoken.h"
+#include "ttokendef.h"
 
 static void tscProcessStreamQueryCallback(void *param, TAOS_RES *tres, int numOfRows);
 static void tscProcessStreamRetrieveResult(void *param, TAOS_RES *res, int numOfRows);
@@ -32,6 +34,78 @@ static void tscSetNextLaunchTimer(SSqlStream *pStream, SSqlObj *pSql);
 static void tscSetRetryTimer(SSqlStream *pStream, SSqlObj *pSql, int64_t timer);
 static int64_t getLaunchTimeDelay(const SSqlStream* pStream);
 
+/*
+ * The incremental stream splits the windows into panes, whose length is the gcd of the interval and the sliding. The
+ * partial results of a pane (count, sum, min, max, first, last) are queried only once, once the pane ends
+ * maxStreamCompDelay before now, and the result of a window is merged from the panes in it.
+ */
+#define STREAM_INCR_MAX_PANES    (10 * 1000 * 1000)  // of a window
+#define STREAM_INCR_CHUNK_PANES  4096                // read from the state file at once
+
+enum {
+  STREAM_MERGE_TS = 0,  // start of the window
+  STREAM_MERGE_COUNT,
+  STREAM_MERGE_SUM,
+  STREAM_MERGE_MIN,
+  STREAM_MERGE_MAX,
+  STREAM_MERGE_FIRST,
+  STREAM_MERGE_LAST,
+  STREAM_MERGE_AVG,     // sum of the sums divided by the sum of the counts
+  STREAM_MERGE_SPREAD,  // max of the max values minus min of the min values
+};
+
+typedef union SStreamVal {
+  int64_t  i;
+  uint64_t u;
+  double   d;
+} SStreamVal;
+
+typedef struct SStreamIncrCol {
+  int8_t  merge;
+  int8_t  type;     // of the result column of the stream
+  int16_t bytes;
+  int32_t offset;   // in the result row
+  int16_t pane[2];  // pane columns merged
+} SStreamIncrCol;
+
+typedef struct SStreamIncr {
+  SSqlObj        *pSql;          // queries the partial results of the panes
+  int64_t         pane;
+  int64_t         paneEnd;       // the panes before it are retrieved
+  int64_t         queryEnd;      // of the panes being queried
+  int64_t         lastPane;      // start of the last pane retrieved, the panes retrieved again by a retry are skipped
+  int32_t         numOfCols;
+  SStreamIncrCol *cols;
+  int32_t         numOfPaneCols;
+  int8_t         *paneTypes;
+  SStreamVal     *acc;           // two values of each result column when merging the panes of a window
+  bool           *hasAcc;
+
+  // the panes of the windows not emitted yet are kept in a ring, which is in a file if it is larger than
+  // streamStateBufferSize. a pane is the start time, a value and a null flag of each pane column
+  int32_t         paneSize;
+  int32_t         capacity;
+  int32_t         head;
+  int32_t         numOfPanes;
+  char           *buf;           // the ring, or the panes read from the file
+  int32_t         bufStart;      // index of the first pane in buf, if the ring is in the file
+  int32_t         bufNum;
+  char           *newPane;
+  FILE           *file;
+  char            path[PATH_MAX];
+
+  char           *row;           // result of a window
+  void          **rowData;
+} SStreamIncr;
+
+static void tscProcessStreamIncrTimer(SSqlStream *pStream);
+static void tscProcessStreamIncrRetrieveResult(void *param, TAOS_RES *res, int numOfRows);
+
+// the incremental stream queries the panes instead of the windows
+static SSqlObj* tscGetStreamQuerySql(SSqlStream* pStream) {
+  return (pStream->pIncr != NULL) ? pStream->pIncr->pSql : pStream->pSql;
+}
+
 static int64_t getDelayValueAfterTimewindowClosed(SSqlStream* pStream, int64_t launchDelay) {
   return taosGetTimestamp(pStream->precision) + launchDelay - pStream->stime - 1;
 }
@@ -65,7 +139,7 @@ static int64_t tscGetRetryDelayTime(SSqlStream* pStream, int64_t slidingTime, in
 }
 
 static void setRetryInfo(SSqlStream* pStream, int32_t code) {
-  SSqlObj* pSql = pStream->pSql;
+  SSqlObj* pSql = tscGetStreamQuerySql(pStream);
 
   pSql->res.code = code;
   int64_t retryDelayTime = tscGetRetryDelayTime(pStream, pStream->interval.sliding, pStream->precision);
@@ -75,7 +149,7 @@ static void setRetryInfo(SSqlStream* pStream, int32_t code) {
 
 static void doLaunchQuery(void* param, TAOS_RES* tres, int32_t code) {
   SSqlStream *pStream = (SSqlStream *)param;
-  assert(pStream->pSql == tres);
+  assert(tscGetStreamQuerySql(pStream) == tres);
 
   SSqlObj* pSql = (SSqlObj*) tres;
 
@@ -125,7 +199,7 @@ static void doLaunchQuery(void* param, TAOS_RES* tres, int32_t code) {
 
 static void tscProcessStreamLaunchQuery(SSchedMsg *pMsg) {
   SSqlStream *pStream = (SSqlStream *)pMsg->ahandle;
-  doLaunchQuery(pStream, pStream->pSql, 0);
+  doLaunchQuery(pStream, tscGetStreamQuerySql(pStream), 0);
 }
 
 static void tscProcessStreamTimer(void *handle, void *tmrId) {
@@ -143,6 +217,12 @@ static void tscProcessStreamTimer(void *handle, void *tmrId) {
   if(pSql == NULL) {
     return ;
   }
+
+  if (pStream->pIncr != NULL) {
+    tscProcessStreamIncrTimer(pStream);
+    return;
+  }
+
   SQueryInfo* pQueryInfo = tscGetQueryInfo(&pSql->cmd);
   tscDebug("0x%"PRIx64" add into timer", pSql->self);
 
@@ -215,31 +295,36 @@ static void tscProcessStreamTimer(void *handle, void *tmrId) {
 
 static void tscProcessStreamQueryCallback(void *param, TAOS_RES *tres, int numOfRows) {
   SSqlStream *pStream = (SSqlStream *)param;
+  SSqlObj    *pSql = tscGetStreamQuerySql(pStream);
   if (tres == NULL || numOfRows < 0) {
     int64_t retryDelay = tscGetRetryDelayTime(pStream, pStream->interval.sliding, pStream->precision);
-    tscError("0x%"PRIx64" stream:%p, query data failed, code:0x%08x, retry in %" PRId64 "ms", pStream->pSql->self,
+    tscError("0x%"PRIx64" stream:%p, query data failed, code:0x%08x, retry in %" PRId64 "ms", pSql->self,
         pStream, numOfRows, retryDelay);
 
-    STableMetaInfo* pTableMetaInfo = tscGetTableMetaInfoFromCmd(&pStream->pSql->cmd, 0);
+    STableMetaInfo* pTableMetaInfo = tscGetTableMetaInfoFromCmd(&pSql->cmd, 0);
 
     char name[TSDB_TABLE_FNAME_LEN] = {0};
     tNameExtractFullName(&pTableMetaInfo->name, name);
 
-    taosHashRemove(UTIL_GET_TABLEMETA(pStream->pSql), name, strnlen(name, TSDB_TABLE_FNAME_LEN));
+    taosHashRemove(UTIL_GET_TABLEMETA(pSql), name, strnlen(name, TSDB_TABLE_FNAME_LEN));
 
     tfree(pTableMetaInfo->pTableMeta);
 
-    tscFreeSqlResult(pStream->pSql);
-    tscFreeSubobj(pStream->pSql);
-    tfree(pStream->pSql->pSubs);
-    pStream->pSql->subState.numOfSub = 0;
+    tscFreeSqlResult(pSql);
+    tscFreeSubobj(pSql);
+    tfree(pSql->pSubs);
+    pSql->subState.numOfSub = 0;
 
     pTableMetaInfo->vgroupList = tscVgroupInfoClear(pTableMetaInfo->vgroupList);
-    tscSetRetryTimer(pStream, pStream->pSql, retryDelay);
+    tscSetRetryTimer(pStream, pSql, retryDelay);
     return;
   }
 
-  taos_fetch_rows_a(tres, tscProcessStreamRetrieveResult, param);
+  if (pStream->pIncr != NULL) {
+    taos_fetch_rows_a(tres, tscProcessStreamIncrRetrieveResult, param);
+  } else {
+    taos_fetch_rows_a(tres, tscProcessStreamRetrieveResult, param);
+  }
 }
 
 // no need to be called as this is alreay done in the query
@@ -733,6 +818,826 @@ static void tscSetNextLaunchTimer(SSqlStream *pStream, SSqlObj *pSql) {
   tscSetRetryTimer(pStream, pSql, timer);
 }
 
+static int64_t tscGetGcd(int64_t a, int64_t b) {
+  while (b != 0) {
+    int64_t t = a % b;
+    a = b;
+    b = t;
+  }
+
+  return a;
+}
+
+static void tscGetStreamVal(int8_t type, const void *data, SStreamVal *pVal) {
+  if (IS_UNSIGNED_NUMERIC_TYPE(type)) {
+    GET_TYPED_DATA(pVal->u, uint64_t, type, data);
+  } else if (IS_FLOAT_TYPE(type)) {
+    GET_TYPED_DATA(pVal->d, double, type, data);
+  } else {
+    GET_TYPED_DATA(pVal->i, int64_t, type, data);
+  }
+}
+
+static void tscSetStreamVal(int8_t type, const SStreamVal *pVal, void *data) {
+  if (IS_UNSIGNED_NUMERIC_TYPE(type)) {
+    SET_TYPED_DATA(data, type, pVal->u);
+  } else if (IS_FLOAT_TYPE(type)) {
+    SET_TYPED_DATA(data, type, pVal->d);
+  } else {
+    SET_TYPED_DATA(data, type, pVal->i);
+  }
+}
+
+static double tscStreamValToDouble(int8_t type, const SStreamVal *pVal) {
+  if (IS_UNSIGNED_NUMERIC_TYPE(type)) {
+    return (double)pVal->u;
+  } else if (IS_FLOAT_TYPE(type)) {
+    return pVal->d;
+  } else {
+    return (double)pVal->i;
+  }
+}
+
+static int32_t tscCompareStreamVal(int8_t type, const SStreamVal *p1, const SStreamVal *p2) {
+  if (IS_UNSIGNED_NUMERIC_TYPE(type)) {
+    return (p1->u > p2->u) - (p1->u < p2->u);
+  } else if (IS_FLOAT_TYPE(type)) {
+    return (p1->d > p2->d) - (p1->d < p2->d);
+  } else {
+    return (p1->i > p2->i) - (p1->i < p2->i);
+  }
+}
+
+static void tscAddStreamVal(int8_t type, SStreamVal *pAcc, const SStreamVal *pVal) {
+  if (IS_UNSIGNED_NUMERIC_TYPE(type)) {
+    pAcc->u += pVal->u;
+  } else if (IS_FLOAT_TYPE(type)) {
+    pAcc->d += pVal->d;
+  } else {
+    pAcc->i += pVal->i;
+  }
+}
+
+#define STREAM_PANE_TS(_p)            (*(int64_t *)(_p))
+#define STREAM_PANE_VALS(_p)          ((SStreamVal *)((_p) + sizeof(int64_t)))
+#define STREAM_PANE_NULLS(_p, _n)     ((int8_t *)((_p) + sizeof(int64_t) + sizeof(SStreamVal) * (_n)))
+
+// the pane of index in the ring, NULL if the ring can not be read from the file, and all the panes are dropped
+static char* tscGetStreamPane(SStreamIncr *pIncr, int32_t index) {
+  int32_t pos = (pIncr->head + index) % pIncr->capacity;
+  if (pIncr->file == NULL) {
+    return pIncr->buf + (size_t)pos * pIncr->paneSize;
+  }
+
+  if (index >= pIncr->bufStart && index < pIncr->bufStart + pIncr->bufNum) {
+    return pIncr->buf + (size_t)(index - pIncr->bufStart) * pIncr->paneSize;
+  }
+
+  int32_t num = pIncr->numOfPanes - index;
+  if (num > pIncr->capacity - pos) {
+    num = pIncr->capacity - pos;
+  }
+  if (num > STREAM_INCR_CHUNK_PANES) {
+    num = STREAM_INCR_CHUNK_PANES;
+  }
+
+  size_t size = (size_t)num * pIncr->paneSize;
+  if (fseek(pIncr->file, (long)pos * pIncr->paneSize, SEEK_SET) != 0 || fread(pIncr->buf, 1, size, pIncr->file) != size) {
+    tscError("failed to read stream state file:%s, reason:%s, %d panes are dropped", pIncr->path, strerror(errno),
+             pIncr->numOfPanes);
+    pIncr->numOfPanes = 0;
+    pIncr->bufNum = 0;
+    return NULL;
+  }
+
+  pIncr->bufStart = index;
+  pIncr->bufNum = num;
+  return pIncr->buf;
+}
+
+static void tscPopStreamPane(SStreamIncr *pIncr) {
+  pIncr->head = (pIncr->head + 1) % pIncr->capacity;
+  pIncr->numOfPanes -= 1;
+  pIncr->bufStart -= 1;
+}
+
+static void tscPushStreamPane(SStreamIncr *pIncr) {
+  // not expected, the ring is large enough for the panes of a window
+  if (pIncr->numOfPanes >= pIncr->capacity) {
+    tscPopStreamPane(pIncr);
+  }
+
+  int32_t pos = (pIncr->head + pIncr->numOfPanes) % pIncr->capacity;
+  if (pIncr->file == NULL) {
+    memcpy(pIncr->buf + (size_t)pos * pIncr->paneSize, pIncr->newPane, pIncr->paneSize);
+  } else if (fseek(pIncr->file, (long)pos * pIncr->paneSize, SEEK_SET) != 0 ||
+             fwrite(pIncr->newPane, 1, pIncr->paneSize, pIncr->file) != (size_t)pIncr->paneSize) {
+    tscError("failed to write stream state file:%s, reason:%s, pane:%" PRId64 " is dropped", pIncr->path,
+             strerror(errno), STREAM_PANE_TS(pIncr->newPane));
+    return;
+  }
+
+  pIncr->numOfPanes += 1;
+}
+
+// the panes before the next window are not needed any more
+static void tscDropStreamPanes(SSqlStream *pStream) {
+  SStreamIncr *pIncr = pStream->pIncr;
+  while (pIncr->numOfPanes > 0) {
+    char *pane = tscGetStreamPane(pIncr, 0);
+    if (pane == NULL || STREAM_PANE_TS(pane) >= pStream->stime) {
+      break;
+    }
+
+    tscPopStreamPane(pIncr);
+  }
+}
+
+// merge the first numOfPanes panes in the ring into the result of the window starting at pStream->stime
+static void tscMergeStreamPanes(SSqlStream *pStream, int32_t numOfPanes) {
+  SStreamIncr *pIncr = pStream->pIncr;
+  memset(pIncr->acc, 0, sizeof(SStreamVal) * pIncr->numOfCols * 2);
+  memset(pIncr->hasAcc, 0, sizeof(bool) * pIncr->numOfCols * 2);
+
+  for (int32_t p = 0; p < numOfPanes; ++p) {
+    char *pane = tscGetStreamPane(pIncr, p);
+    if (pane == NULL) {
+      return;
+    }
+
+    SStreamVal *vals = STREAM_PANE_VALS(pane);
+    int8_t *    isNull = STREAM_PANE_NULLS(pane, pIncr->numOfPaneCols);
+
+    for (int32_t i = 1; i < pIncr->numOfCols; ++i) {
+      SStreamIncrCol *pCol = &pIncr->cols[i];
+      SStreamVal *    acc = &pIncr->acc[i * 2];
+      bool *          hasAcc = &pIncr->hasAcc[i * 2];
+      int16_t         c0 = pCol->pane[0], c1 = pCol->pane[1];
+
+      switch (pCol->merge) {
+        case STREAM_MERGE_COUNT:
+        case STREAM_MERGE_SUM:
+          if (!isNull[c0]) {
+            tscAddStreamVal(pIncr->paneTypes[c0], &acc[0], &vals[c0]);
+            hasAcc[0] = true;
+          }
+          break;
+        case STREAM_MERGE_MIN:
+        case STREAM_MERGE_MAX: {
+          int32_t order = (pCol->merge == STREAM_MERGE_MIN) ? -1 : 1;
+          if (!isNull[c0] && (!hasAcc[0] || tscCompareStreamVal(pCol->type, &vals[c0], &acc[0]) == order)) {
+            acc[0] = vals[c0];
+            hasAcc[0] = true;
+          }
+          break;
+        }
+        case STREAM_MERGE_FIRST:
+        case STREAM_MERGE_LAST:
+          if (!isNull[c0] && (!hasAcc[0] || pCol->merge == STREAM_MERGE_LAST)) {
+            acc[0] = vals[c0];
+            hasAcc[0] = true;
+          }
+          break;
+        case STREAM_MERGE_AVG:
+          if (!isNull[c0] && !isNull[c1]) {
+            acc[0].d += tscStreamValToDouble(pIncr->paneTypes[c0], &vals[c0]);
+            acc[1].i += vals[c1].i;
+          }
+          break;
+        case STREAM_MERGE_SPREAD:
+          if (!isNull[c0] && !isNull[c1]) {
+            double min = tscStreamValToDouble(pIncr->paneTypes[c0], &vals[c0]);
+            double max = tscStreamValToDouble(pIncr->paneTypes[c1], &vals[c1]);
+            if (!hasAcc[0] || min < acc[0].d) {
+              acc[0].d = min;
+            }
+            if (!hasAcc[0] || max > acc[1].d) {
+              acc[1].d = max;
+            }
+            hasAcc[0] = true;
+          }
+          break;
+        default:
+          break;
+      }
+    }
+  }
+
+  for (int32_t i = 0; i < pIncr->numOfCols; ++i) {
+    SStreamIncrCol *pCol = &pIncr->cols[i];
+    SStreamVal *    acc = &pIncr->acc[i * 2];
+    char *          data = pIncr->row + pCol->offset;
+
+    pIncr->rowData[i] = data;
+    switch (pCol->merge) {
+      case STREAM_MERGE_TS:
+        *(int64_t *)data = pStream->stime;
+        break;
+      case STREAM_MERGE_COUNT:
+        *(int64_t *)data = acc[0].i;
+        break;
+      case STREAM_MERGE_AVG:
+        if (acc[1].i > 0) {
+          *(double *)data = acc[0].d / (double)acc[1].i;
+        } else {
+          pIncr->rowData[i] = NULL;
+        }
+        break;
+      case STREAM_MERGE_SPREAD:
+        if (pIncr->hasAcc[i * 2]) {
+          *(double *)data = acc[1].d - acc[0].d;
+        } else {
+          pIncr->rowData[i] = NULL;
+        }
+        break;
+      default:
+        if (pIncr->hasAcc[i * 2]) {
+          tscSetStreamVal(pCol->type, &acc[0], data);
+        } else {
+          pIncr->rowData[i] = NULL;
+        }
+        break;
+    }
+  }
+
+  tscDebug("0x%" PRIx64 " stream:%p, window:%" PRId64 " is merged from %d panes", pIncr->pSql->self, pStream,
+           pStream->stime, numOfPanes);
+  (*pStream->fp)(pStream->param, pStream->pSql, pIncr->rowData);
+  pStream->numOfRes++;
+}
+
+// emit the windows ending before end, all the panes of them are retrieved
+static void tscEmitStreamWindows(SSqlStream *pStream, int64_t end) {
+  SStreamIncr *pIncr = pStream->pIncr;
+  if (pStream->stime == INT64_MIN) {
+    return;
+  }
+
+  while (pStream->stime <= pStream->etime && pStream->stime <= end - pStream->interval.interval) {
+    tscDropStreamPanes(pStream);
+
+    if (pIncr->numOfPanes == 0) {
+      // no data in the windows before end
+      if (end != INT64_MAX) {
+        int64_t next = taosTimeTruncate(end, &pStream->interval, pStream->precision);
+        if (next > pStream->stime) {
+          pStream->stime = next;
+        }
+      }
+      break;
+    }
+
+    char *pane = tscGetStreamPane(pIncr, 0);
+    if (pane == NULL) {
+      continue;
+    }
+
+    int64_t windowEnd = pStream->stime + pStream->interval.interval;
+    if (STREAM_PANE_TS(pane) >= windowEnd) {
+      // skip the windows without data
+      pStream->stime = taosTimeTruncate(STREAM_PANE_TS(pane), &pStream->interval, pStream->precision);
+      continue;
+    }
+
+    int32_t num = 1;
+    while (num < pIncr->numOfPanes) {
+      pane = tscGetStreamPane(pIncr, num);
+      if (pane == NULL || STREAM_PANE_TS(pane) >= windowEnd) {
+        break;
+      }
+      num++;
+    }
+
+    if (pIncr->numOfPanes > 0) {
+      tscMergeStreamPanes(pStream, num);
+    }
+    pStream->stime += pStream->interval.sliding;
+  }
+
+  tscDropStreamPanes(pStream);
+}
+
+static void tscAddStreamPane(SSqlStream *pStream, TAOS_ROW row) {
+  SStreamIncr *pIncr = pStream->pIncr;
+  int64_t      ts = *(int64_t *)row[0];
+
+  // retrieved again after the query is retried
+  if (ts <= pIncr->lastPane) {
+    return;
+  }
+  pIncr->lastPane = ts;
+
+  if (pStream->stime == INT64_MIN) {
+    pStream->stime = taosTimeTruncate(ts, &pStream->interval, pStream->precision);
+  }
+  tscEmitStreamWindows(pStream, ts);
+
+  char *      pane = pIncr->newPane;
+  SStreamVal *vals = STREAM_PANE_VALS(pane);
+  int8_t *    isNull = STREAM_PANE_NULLS(pane, pIncr->numOfPaneCols);
+
+  STREAM_PANE_TS(pane) = ts;
+  for (int32_t i = 0; i < pIncr->numOfPaneCols; ++i) {
+    isNull[i] = (row[i + 1] == NULL);
+    vals[i].i = 0;
+    if (!isNull[i]) {
+      tscGetStreamVal(pIncr->paneTypes[i], row[i + 1], &vals[i]);
+    }
+  }
+
+  tscPushStreamPane(pIncr);
+}
+
+static void tscSetNextIncrLaunchTimer(SSqlStream *pStream) {
+  SStreamIncr *pIncr = pStream->pIncr;
+
+  if (pIncr->paneEnd != INT64_MIN && pIncr->paneEnd > pStream->etime) {
+    // the last windows are emitted with the data before the end time of the stream
+    tscEmitStreamWindows(pStream, INT64_MAX);
+    tscDebug("0x%" PRIx64 " stream:%p, panes before end time:%" PRId64 " are retrieved, stop the stream", pIncr->pSql->self,
+             pStream, pStream->etime);
+    if (pStream->callback) {
+      pStream->callback(pStream->param);
+    }
+    taos_close_stream(pStream);
+    return;
+  }
+
+  // launched once the next window is closed
+  int64_t now = taosGetTimestamp(pStream->precision);
+  int64_t next = now;
+  if (pStream->stime != INT64_MIN) {
+    next = pStream->stime + pStream->interval.interval;
+  } else if (pIncr->paneEnd != INT64_MIN) {
+    next = pIncr->paneEnd + pIncr->pane;
+  }
+
+  int64_t timer = next + convertTimePrecision(tsMaxStreamComputDelay, TSDB_TIME_PRECISION_MILLI, pStream->precision) - now;
+  if (timer < 0) {
+    timer = 0;
+  }
+
+  tscSetRetryTimer(pStream, pIncr->pSql, convertTimePrecision(timer, pStream->precision, TSDB_TIME_PRECISION_MILLI));
+}
+
+static void tscProcessStreamIncrTimer(SSqlStream *pStream) {
+  SStreamIncr *pIncr = pStream->pIncr;
+  SQueryInfo * pQueryInfo = tscGetQueryInfo(&pIncr->pSql->cmd);
+
+  // the panes ending maxStreamCompDelay before now are closed, the rows arriving later are not aggregated
+  int64_t end = taosGetTimestamp(pStream->precision) -
+                convertTimePrecision(tsMaxStreamComputDelay, TSDB_TIME_PRECISION_MILLI, pStream->precision);
+  end -= end % pIncr->pane;
+  if (end > pStream->etime) {
+    end = pStream->etime - pStream->etime % pIncr->pane + pIncr->pane;
+  }
+
+  if (end <= pIncr->paneEnd) {
+    tscSetNextIncrLaunchTimer(pStream);
+    return;
+  }
+
+  pQueryInfo->window.skey = pIncr->paneEnd;
+  pQueryInfo->window.ekey = end - 1;
+  pIncr->queryEnd = end;
+
+  tscDebug("0x%" PRIx64 " stream:%p, query panes skey=%" PRId64 " ekey=%" PRId64 " stime=%" PRId64, pIncr->pSql->self,
+           pStream, pQueryInfo->window.skey, pQueryInfo->window.ekey, pStream->stime);
+
+  SSchedMsg schedMsg = { 0 };
+  schedMsg.fp = tscProcessStreamLaunchQuery;
+  schedMsg.ahandle = pStream;
+  schedMsg.thandle = (void *)1;
+  schedMsg.msg = NULL;
+  taosScheduleTask(tscQhandle, &schedMsg);
+}
+
+static void tscProcessStreamIncrRetrieveResult(void *param, TAOS_RES *res, int numOfRows) {
+  SSqlStream * pStream = (SSqlStream *)param;
+  SStreamIncr *pIncr = pStream->pIncr;
+  SSqlObj *    pSql = (SSqlObj *)res;
+
+  if (pSql == NULL || numOfRows < 0) {
+    int64_t retryDelayTime = tscGetRetryDelayTime(pStream, pStream->interval.sliding, pStream->precision);
+    tscError("stream:%p, retrieve panes failed, code:0x%08x, retry in %" PRId64 " ms", pStream, numOfRows, retryDelayTime);
+    tscSetRetryTimer(pStream, pIncr->pSql, retryDelayTime);
+    return;
+  }
+
+  if (numOfRows > 0) {
+    for (int32_t i = 0; i < numOfRows; ++i) {
+      TAOS_ROW row = taos_fetch_row(res);
+      if (row != NULL) {
+        tscAddStreamPane(pStream, row);
+      }
+    }
+
+    taos_fetch_rows_a(res, tscProcessStreamIncrRetrieveResult, pStream);
+    return;
+  }
+
+  // all the panes are retrieved
+  SQueryInfo *    pQueryInfo = tscGetQueryInfo(&pSql->cmd);
+  STableMetaInfo *pTableMetaInfo = pQueryInfo->pTableMetaInfo[0];
+
+  pStream->useconds += pSql->res.useconds;
+  pIncr->paneEnd = pIncr->queryEnd;
+  tscEmitStreamWindows(pStream, pIncr->paneEnd);
+
+  tscDebug("0x%" PRIx64 " stream:%p, query on:%s, panes before %" PRId64 " are retrieved, %d panes kept, results:%" PRId64,
+           pSql->self, pStream, tNameGetTableName(&pTableMetaInfo->name), pIncr->paneEnd, pIncr->numOfPanes,
+           pStream->numOfRes);
+
+  tfree(pTableMetaInfo->pTableMeta);
+  if (pQueryInfo->pQInfo != NULL) {
+    qDestroyQueryInfo(pQueryInfo->pQInfo);
+    pQueryInfo->pQInfo = NULL;
+  }
+
+  tscFreeSqlResult(pSql);
+  tscFreeSubobj(pSql);
+  tfree(pSql->pSubs);
+  pSql->subState.numOfSub = 0;
+  pTableMetaInfo->vgroupList = tscVgroupInfoClear(pTableMetaInfo->vgroupList);
+  tscSetNextIncrLaunchTimer(pStream);
+}
+
+static void tscFreeStreamIncr(SStreamIncr *pIncr) {
+  if (pIncr == NULL) {
+    return;
+  }
+
+  if (pIncr->pSql != NULL) {
+    taos_free_result(pIncr->pSql);
+  }
+
+  if (pIncr->file != NULL) {
+    fclose(pIncr->file);
+    remove(pIncr->path);
+  }
+
+  tfree(pIncr->cols);
+  tfree(pIncr->paneTypes);
+  tfree(pIncr->acc);
+  tfree(pIncr->hasAcc);
+  tfree(pIncr->buf);
+  tfree(pIncr->newPane);
+  tfree(pIncr->row);
+  tfree(pIncr->rowData);
+  free(pIncr);
+}
+
+static int16_t tscAddStreamPaneCol(SStreamIncr *pIncr, char *list, const char *func, const char *col) {
+  sprintf(list + strlen(list), "%s%s(%s)", (pIncr->numOfPaneCols > 0) ? ", " : "", func, col);
+  return (int16_t)(pIncr->numOfPaneCols++);
+}
+
+// the select clause of the panes, NULL if any result of the stream can not be merged from the panes
+static char *tscBuildStreamPaneCols(SSqlStream *pStream, SStreamIncr *pIncr) {
+  SQueryInfo *    pQueryInfo = tscGetQueryInfo(&pStream->pSql->cmd);
+  STableMetaInfo *pTableMetaInfo = tscGetMetaInfo(pQueryInfo, 0);
+  SSchema *       pSchema = tscGetTableSchema(pTableMetaInfo->pTableMeta);
+  int32_t         numOfColumns = tscGetNumOfColumns(pTableMetaInfo->pTableMeta);
+  int32_t         numOfCols = tscNumOfFields(pQueryInfo);
+
+  if (numOfCols != (int32_t)tscNumOfExprs(pQueryInfo)) {
+    return NULL;
+  }
+
+  pIncr->numOfCols = numOfCols;
+  pIncr->cols = calloc(numOfCols, sizeof(SStreamIncrCol));
+  char *list = calloc(1, (size_t)numOfCols * 2 * (TSDB_COL_NAME_LEN + 16));
+  if (pIncr->cols == NULL || list == NULL) {
+    free(list);
+    return NULL;
+  }
+
+  int32_t offset = 0;
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SExprInfo *     pExpr = tscExprGet(pQueryInfo, i);
+    TAOS_FIELD *    pField = tscFieldInfoGetField(&pQueryInfo->fieldsInfo, i);
+    SStreamIncrCol *pCol = &pIncr->cols[i];
+    int16_t         functionId = pExpr->base.functionId;
+    int16_t         colIndex = pExpr->base.colInfo.colIndex;
+
+    // first and last of the super tables
+    if (functionId == TSDB_FUNC_FIRST_DST) {
+      functionId = TSDB_FUNC_FIRST;
+    } else if (functionId == TSDB_FUNC_LAST_DST) {
+      functionId = TSDB_FUNC_LAST;
+    }
+
+    pCol->type = (int8_t)pField->type;
+    pCol->bytes = pField->bytes;
+    pCol->offset = offset;
+    offset += pField->bytes;
+
+    if (i == 0) {
+      if (functionId != TSDB_FUNC_TS) {
+        goto _error;
+      }
+      pCol->merge = STREAM_MERGE_TS;
+      continue;
+    }
+
+    if (TSDB_COL_IS_TAG(pExpr->base.colInfo.flag) || colIndex < 0 || colIndex >= numOfColumns) {
+      goto _error;
+    }
+
+    const char *name = pSchema[colIndex].name;
+    int8_t      type = pSchema[colIndex].type;
+    bool        comparable = IS_NUMERIC_TYPE(type) || type == TSDB_DATA_TYPE_BOOL || type == TSDB_DATA_TYPE_TIMESTAMP;
+
+    switch (functionId) {
+      case TSDB_FUNC_COUNT:
+        pCol->merge = STREAM_MERGE_COUNT;
+        pCol->pane[0] = tscAddStreamPaneCol(pIncr, list, "count", name);
+        break;
+      case TSDB_FUNC_SUM:
+        if (!IS_NUMERIC_TYPE(type)) {
+          goto _error;
+        }
+        pCol->merge = STREAM_MERGE_SUM;
+        pCol->pane[0] = tscAddStreamPaneCol(pIncr, list, "sum", name);
+        break;
+      case TSDB_FUNC_MIN:
+      case TSDB_FUNC_MAX:
+      case TSDB_FUNC_FIRST:
+      case TSDB_FUNC_LAST: {
+        if (!comparable) {
+          goto _error;
+        }
+        const char *func = (functionId == TSDB_FUNC_MIN) ? "min" : ((functionId == TSDB_FUNC_MAX) ? "max" : NULL);
+        if (func == NULL) {
+          func = (functionId == TSDB_FUNC_FIRST) ? "first" : "last";
+        }
+        pCol->merge = (functionId == TSDB_FUNC_MIN) ? STREAM_MERGE_MIN :
+                      (functionId == TSDB_FUNC_MAX) ? STREAM_MERGE_MAX :
+                      (functionId == TSDB_FUNC_FIRST) ? STREAM_MERGE_FIRST : STREAM_MERGE_LAST;
+        pCol->pane[0] = tscAddStreamPaneCol(pIncr, list, func, name);
+        break;
+      }
+      case TSDB_FUNC_AVG:
+        if (!IS_NUMERIC_TYPE(type)) {
+          goto _error;
+        }
+        pCol->merge = STREAM_MERGE_AVG;
+        pCol->pane[0] = tscAddStreamPaneCol(pIncr, list, "sum", name);
+        pCol->pane[1] = tscAddStreamPaneCol(pIncr, list, "count", name);
+        break;
+      case TSDB_FUNC_SPREAD:
+        if (!IS_NUMERIC_TYPE(type) && type != TSDB_DATA_TYPE_TIMESTAMP) {
+          goto _error;
+        }
+        pCol->merge = STREAM_MERGE_SPREAD;
+        pCol->pane[0] = tscAddStreamPaneCol(pIncr, list, "min", name);
+        pCol->pane[1] = tscAddStreamPaneCol(pIncr, list, "max", name);
+        break;
+      default:
+        goto _error;
+    }
+  }
+
+  pIncr->row = calloc(1, offset);
+  if (pIncr->row == NULL) {
+    goto _error;
+  }
+  return list;
+
+_error:
+  free(list);
+  return NULL;
+}
+
+// the query of the panes keeps the from and where clauses of the stream
+static char *tscBuildStreamPaneSql(SSqlStream *pStream, SStreamIncr *pIncr, const char *cols) {
+  char *  sql = pStream->pSql->sqlstr;
+  int32_t fromPos = -1, intervalPos = -1, depth = 0, numOfSelect = 0;
+
+  for (int32_t pos = 0; sql[pos] != 0;) {
+    uint32_t type = 0;
+    uint32_t n = tGetToken(sql + pos, &type);
+    if (n == 0) {
+      break;
+    }
+
+    if (type == TK_LP) {
+      depth++;
+    } else if (type == TK_RP) {
+      depth--;
+    } else if (type == TK_SELECT) {
+      numOfSelect++;
+    } else if (depth == 0 && type == TK_FROM && fromPos < 0) {
+      fromPos = pos;
+    } else if (depth == 0 && type == TK_INTERVAL && intervalPos < 0) {
+      intervalPos = pos;
+    }
+
+    pos += n;
+  }
+
+  if (numOfSelect != 1 || fromPos < 0 || intervalPos < fromPos) {
+    return NULL;
+  }
+
+  char   unit = (pStream->precision == TSDB_TIME_PRECISION_MICRO) ? 'u' :
+                ((pStream->precision == TSDB_TIME_PRECISION_NANO) ? 'b' : 'a');
+  size_t len = strlen(cols) + (intervalPos - fromPos) + 64;
+  char * paneSql = malloc(len);
+  if (paneSql != NULL) {
+    snprintf(paneSql, len, "select %s %.*s interval(%" PRId64 "%c)", cols, intervalPos - fromPos, sql + fromPos,
+             pIncr->pane, unit);
+  }
+
+  return paneSql;
+}
+
+// check the results of the panes and allocate the ring for them
+static int32_t tscSetupStreamPanes(SSqlStream *pStream, SStreamIncr *pIncr) {
+  SQueryInfo *pQueryInfo = tscGetQueryInfo(&pIncr->pSql->cmd);
+
+  if (tscNumOfFields(pQueryInfo) != pIncr->numOfPaneCols + 1 || pQueryInfo->interval.interval != pIncr->pane ||
+      pQueryInfo->interval.sliding != pIncr->pane) {
+    return TSDB_CODE_TSC_INVALID_OPERATION;
+  }
+
+  pIncr->paneTypes = calloc(pIncr->numOfPaneCols, sizeof(int8_t));
+  if (pIncr->paneTypes == NULL) {
+    return TSDB_CODE_TSC_OUT_OF_MEMORY;
+  }
+
+  for (int32_t i = 0; i < pIncr->numOfPaneCols; ++i) {
+    int8_t type = (int8_t)tscFieldInfoGetField(&pQueryInfo->fieldsInfo, i + 1)->type;
+    if (!IS_NUMERIC_TYPE(type) && type != TSDB_DATA_TYPE_BOOL && type != TSDB_DATA_TYPE_TIMESTAMP) {
+      return TSDB_CODE_TSC_INVALID_OPERATION;
+    }
+    pIncr->paneTypes[i] = type;
+  }
+
+  for (int32_t i = 1; i < pIncr->numOfCols; ++i) {
+    SStreamIncrCol *pCol = &pIncr->cols[i];
+    bool            valid = false;
+
+    switch (pCol->merge) {
+      case STREAM_MERGE_COUNT:
+        valid = pCol->type == TSDB_DATA_TYPE_BIGINT && pIncr->paneTypes[pCol->pane[0]] == TSDB_DATA_TYPE_BIGINT;
+        break;
+      case STREAM_MERGE_AVG:
+        valid = pCol->type == TSDB_DATA_TYPE_DOUBLE && pIncr->paneTypes[pCol->pane[1]] == TSDB_DATA_TYPE_BIGINT;
+        break;
+      case STREAM_MERGE_SPREAD:
+        valid = pCol->type == TSDB_DATA_TYPE_DOUBLE;
+        break;
+      default:
+        valid = pCol->type == pIncr->paneTypes[pCol->pane[0]];
+        break;
+    }
+
+    if (!valid) {
+      return TSDB_CODE_TSC_INVALID_OPERATION;
+    }
+  }
+
+  int32_t numOfPaneCols = pIncr->numOfPaneCols;
+  pIncr->paneSize = (int32_t)(sizeof(int64_t) + (sizeof(SStreamVal) + 1) * numOfPaneCols);
+  pIncr->paneSize = ((pIncr->paneSize + 7) / 8) * 8;
+
+  int64_t size = (int64_t)pIncr->capacity * pIncr->paneSize;
+  if (size > (int64_t)tsStreamStateBufferSize * 1024 * 1024) {
+    taosGetTmpfilePath("stream-state", pIncr->path);
+    pIncr->file = fopen(pIncr->path, "wb+");
+    if (pIncr->file == NULL) {
+      tscError("stream:%p, failed to create stream state file:%s, reason:%s", pStream, pIncr->path, strerror(errno));
+      return TAOS_SYSTEM_ERROR(errno);
+    }
+    size = (int64_t)STREAM_INCR_CHUNK_PANES * pIncr->paneSize;
+  }
+
+  pIncr->buf = malloc((size_t)size);
+  pIncr->newPane = calloc(1, pIncr->paneSize);
+  pIncr->acc = calloc(pIncr->numOfCols * 2, sizeof(SStreamVal));
+  pIncr->hasAcc = calloc(pIncr->numOfCols * 2, sizeof(bool));
+  pIncr->rowData = calloc(pIncr->numOfCols, POINTER_BYTES);
+  if (pIncr->buf == NULL || pIncr->newPane == NULL || pIncr->acc == NULL || pIncr->hasAcc == NULL ||
+      pIncr->rowData == NULL) {
+    return TSDB_CODE_TSC_OUT_OF_MEMORY;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static void tscStartStream(SSqlStream *pStream);
+
+static void tscStreamIncrParsed(void *param, TAOS_RES *res, int code) {
+  SSqlStream * pStream = (SSqlStream *)param;
+  SStreamIncr *pIncr = pStream->pIncr;
+
+  if (code == TSDB_CODE_SUCCESS) {
+    code = tscSetupStreamPanes(pStream, pIncr);
+  }
+
+  if (code != TSDB_CODE_SUCCESS) {
+    tscWarn("0x%" PRIx64 " stream:%p, windows are queried again since the panes can not be queried, sql:%s, reason:%s",
+            pStream->pSql->self, pStream, pIncr->pSql->sqlstr, tstrerror(code));
+    pStream->pIncr = NULL;
+    tscFreeStreamIncr(pIncr);
+  } else {
+    tscDebug("0x%" PRIx64 " stream:%p, pane:%" PRId64 ", panes of a window:%d, state file:%s, sql:%s", pStream->pSql->self,
+             pStream, pIncr->pane, pIncr->capacity - 1, (pIncr->file != NULL) ? pIncr->path : "none", pIncr->pSql->sqlstr);
+  }
+
+  tscStartStream(pStream);
+}
+
+static bool tscIsIncrementalStream(SSqlStream *pStream) {
+  SQueryInfo *pQueryInfo = tscGetQueryInfo(&pStream->pSql->cmd);
+  SInterval * pInterval = &pStream->interval;
+
+  if (tsIncrementalStream == 0 || pStream->isProject || pStream->to != NULL) {
+    return false;
+  }
+
+  // every row is aggregated once if the windows do not overlap
+  if (pInterval->intervalUnit == 'n' || pInterval->intervalUnit == 'y' || pInterval->slidingUnit == 'n' ||
+      pInterval->slidingUnit == 'y' || pInterval->sliding >= pInterval->interval || pQueryInfo->interval.offset != 0) {
+    return false;
+  }
+
+  if (pQueryInfo->pUpstream != NULL && taosArrayGetSize(pQueryInfo->pUpstream) > 0) {
+    return false;
+  }
+
+  return pQueryInfo->numOfTables == 1 && pQueryInfo->groupbyExpr.numOfGroupCols == 0 &&
+         pQueryInfo->fillType == TSDB_FILL_NONE && pQueryInfo->havingFieldNum == 0 && pQueryInfo->limit.limit < 0 &&
+         pQueryInfo->slimit.limit < 0 && pQueryInfo->sessionWindow.gap == 0 && !pQueryInfo->stateWindow &&
+         !pQueryInfo->arithmeticOnAgg && pQueryInfo->order.order == TSDB_ORDER_ASC;
+}
+
+// query the panes instead of the windows if the stream can be computed incrementally, the stream is started once the
+// query of the panes is parsed
+static void tscOpenStreamIncr(SSqlStream *pStream) {
+  if (!tscIsIncrementalStream(pStream)) {
+    tscStartStream(pStream);
+    return;
+  }
+
+  SStreamIncr *pIncr = calloc(1, sizeof(SStreamIncr));
+  if (pIncr == NULL) {
+    tscStartStream(pStream);
+    return;
+  }
+
+  // the windows and the panes shall be aligned
+  int64_t now = taosGetTimestamp(pStream->precision);
+  pIncr->pane = tscGetGcd(pStream->interval.interval, pStream->interval.sliding);
+  pIncr->capacity = (int32_t)MIN(pStream->interval.interval / pIncr->pane + 1, STREAM_INCR_MAX_PANES + 1);
+  pIncr->paneEnd = pStream->stime;
+  pIncr->lastPane = INT64_MIN;
+
+  char *cols = NULL, *sql = NULL;
+  if (pStream->interval.interval / pIncr->pane > STREAM_INCR_MAX_PANES ||
+      taosTimeTruncate(now, &pStream->interval, pStream->precision) % pIncr->pane != 0 ||
+      (pStream->stime != INT64_MIN && pStream->stime % pIncr->pane != 0) ||
+      (cols = tscBuildStreamPaneCols(pStream, pIncr)) == NULL || (sql = tscBuildStreamPaneSql(pStream, pIncr, cols)) == NULL) {
+    tscDebug("0x%" PRIx64 " stream:%p, windows are queried again, pane:%" PRId64, pStream->pSql->self, pStream, pIncr->pane);
+    free(cols);
+    tscFreeStreamIncr(pIncr);
+    tscStartStream(pStream);
+    return;
+  }
+  free(cols);
+
+  SSqlObj *pSql = (SSqlObj *)calloc(1, sizeof(SSqlObj));
+  if (pSql == NULL) {
+    free(sql);
+    tscFreeStreamIncr(pIncr);
+    tscStartStream(pStream);
+    return;
+  }
+
+  pSql->signature = pSql;
+  pSql->pTscObj = pStream->pSql->pTscObj;
+  pSql->rootObj = pSql;
+  pSql->pStream = pStream;
+  pSql->param = pStream;
+  pSql->maxRetry = TSDB_MAX_REPLICA;
+  pSql->sqlstr = sql;
+  pSql->cmd.resColumnId = TSDB_RES_COL_ID;
+  pSql->fp = tscStreamIncrParsed;
+  pSql->fetchFp = tscStreamIncrParsed;
+  tsem_init(&pSql->rspSem, 0, 0);
+  registerSqlObj(pSql);
+
+  pIncr->pSql = pSql;
+  pStream->pIncr = pIncr;
+  tscDebugL("0x%" PRIx64 " stream:%p, query panes, SQL: %s", pSql->self, pStream, sql);
+
+  int32_t code = tsParseSql(pSql, true);
+  if (code != TSDB_CODE_TSC_ACTION_IN_PROGRESS) {
+    tscStreamIncrParsed(pStream, pSql, code);
+  }
+}
+
 static int32_t tscSetSlidingWindowInfo(SSqlObj *pSql, SSqlStream *pStream) {
   int64_t minIntervalTime =
       convertTimePrecision(tsMinIntervalTime, TSDB_TIME_PRECISION_MILLI, pStream->precision);
@@ -878,15 +1783,22 @@ static void tscCreateStream(void *param, TAOS_RES *res, int code) {
     pStream->stime = pStream->ltime;
   }
 
-  int64_t starttime = tscGetFirstLaunchTime(pStream);
   pCmd->command = TSDB_SQL_SELECT;
+  tscOpenStreamIncr(pStream);
+}
+
+static void tscStartStream(SSqlStream *pStream) {
+  SSqlObj*        pSql = pStream->pSql;
+  STableMetaInfo* pTableMetaInfo = tscGetMetaInfo(tscGetQueryInfo(&pSql->cmd), 0);
+
+  int64_t starttime = tscGetFirstLaunchTime(pStream);
 
   tscAddIntoStreamList(pStream);
 
   taosTmrReset(tscProcessStreamTimer, (int32_t)starttime, pStream, tscTmr, &pStream->pTimer);
 
-  tscDebug("0x%"PRIx64" stream:%p is opened, query on:%s, interval:%" PRId64 ", sliding:%" PRId64 ", first launched in:%" PRId64 ", sql:%s", pSql->self,
-           pStream, tNameGetTableName(&pTableMetaInfo->name), pStream->interval.interval, pStream->interval.sliding, starttime, pSql->sqlstr);
+  tscDebug("0x%"PRIx64" stream:%p is opened, query on:%s, interval:%" PRId64 ", sliding:%" PRId64 ", first launched in:%" PRId64 ", incremental:%d, sql:%s", pSql->self,
+           pStream, tNameGetTableName(&pTableMetaInfo->name), pStream->interval.interval, pStream->interval.sliding, starttime, pStream->pIncr != NULL, pSql->sqlstr);
 }
 
 void tscSetStreamDestTable(SSqlStream* pStream, const char* dstTable) {
@@ -1110,6 +2022,8 @@ void taos_close_stream(TAOS_STREAM *handle) {
     pStream->fp(pStream->param, NULL, NULL);
 
     taos_free_result(pSql);
+    tscFreeStreamIncr(pStream->pIncr);
+    pStream->pIncr = NULL;
 
     // free malloc
     if(pStream->to) {
@@ -24,12 +24,39 @@
 #include "tscUtil.h"
 #include "tcache.h"
 #include "tscProfile.h"
+#include "tcompare.h"
 
 typedef struct SSubscriptionProgress {
   int64_t uid;
   TSKEY key;
 } SSubscriptionProgress;
 
+// the tables of the subscription in a vgroup, the subscribe request waits in the vnode until any of them is written
+typedef struct SSubVgroup {
+  int32_t   vgId;
+  int8_t    pending;  // the subscribe request is waiting in the vnode
+  SRpcEpSet epSet;
+  int64_t   version;  // vnode version the subscription has caught up with
+  SArray *  uids;     // int64_t
+} SSubVgroup;
+
+// it is released by the subscription and the pending subscribe requests, whichever is the last
+typedef struct SSubPush {
+  pthread_mutex_t mutex;
+  tsem_t          sem;       // posted once a subscribe request is responded
+  int32_t         refCount;
+  int8_t          failed;    // any subscribe request failed since the last consume
+  int32_t         numOfPending;
+  SArray *        vgroups;   // SSubVgroup
+  SArray *        changed;   // int64_t, the tables written since the last query
+  SArray *        pVgroupTables;  // all the tables of a super table, the query only covers the tables written
+} SSubPush;
+
+typedef struct SSubWaitParam {
+  SSubPush *pPush;
+  int32_t   vgId;
+} SSubWaitParam;
+
 typedef struct SSub {
   void *                  signature;
   char                    topic[32];
@@ -43,6 +70,7 @@ typedef struct SSub {
   TAOS_SUBSCRIBE_CALLBACK fp;
   void *                  param;
   SArray* progress;
+  SSubPush*               push;  // NULL if the tables are queried on every consume
 } SSub;
 
 
@@ -261,6 +289,8 @@ static int32_t compareTidTag(const void* p1, const void* p2) {
 }
 
 
+static void tscBuildSubVgroups(SSub* pSub);
+
 static int tscUpdateSubscription(STscObj* pObj, SSub* pSub) {
   SSqlObj* pSql = pSub->pSql;
 
@@ -281,6 +311,7 @@ static int tscUpdateSubscription(STscObj* pObj, SSub* pSub) {
     }
     
     pSub->lastSyncTime = taosGetTimestampMs();
+    tscBuildSubVgroups(pSub);
     return 1;
   }
 
@@ -315,9 +346,388 @@ static int tscUpdateSubscription(STscObj* pObj, SSub* pSub) {
   }
 
   pSub->lastSyncTime = taosGetTimestampMs();
+  tscBuildSubVgroups(pSub);
   return 1;
 }
 
+static SSubPush* tscCreateSubPush() {
+  SSubPush* pPush = calloc(1, sizeof(SSubPush));
+  if (pPush == NULL) {
+    return NULL;
+  }
+
+  pPush->vgroups = taosArrayInit(4, sizeof(SSubVgroup));
+  pPush->changed = taosArrayInit(32, sizeof(int64_t));
+  if (pPush->vgroups == NULL || pPush->changed == NULL || tsem_init(&pPush->sem, 0, 0) == -1) {
+    taosArrayDestroy(&pPush->vgroups);
+    taosArrayDestroy(&pPush->changed);
+    free(pPush);
+    return NULL;
+  }
+
+  pthread_mutex_init(&pPush->mutex, NULL);
+  pPush->refCount = 1;
+  return pPush;
+}
+
+static void tscFreeSubVgroups(SArray* vgroups) {
+  size_t num = taosArrayGetSize(vgroups);
+  for (size_t i = 0; i < num; ++i) {
+    SSubVgroup* pVgroup = taosArrayGet(vgroups, i);
+    taosArrayDestroy(&pVgroup->uids);
+  }
+  taosArrayDestroy(&vgroups);
+}
+
+static void tscReleaseSubPush(SSubPush* pPush) {
+  pthread_mutex_lock(&pPush->mutex);
+  int32_t ref = --pPush->refCount;
+  pthread_mutex_unlock(&pPush->mutex);
+
+  if (ref > 0) {
+    return;
+  }
+
+  tscFreeSubVgroups(pPush->vgroups);
+  taosArrayDestroy(&pPush->changed);
+  tscFreeVgroupTableInfo(pPush->pVgroupTables);
+  tsem_destroy(&pPush->sem);
+  pthread_mutex_destroy(&pPush->mutex);
+  free(pPush);
+}
+
+static SSubVgroup* tscGetSubVgroup(SArray* vgroups, int32_t vgId) {
+  size_t num = taosArrayGetSize(vgroups);
+  for (size_t i = 0; i < num; ++i) {
+    SSubVgroup* pVgroup = taosArrayGet(vgroups, i);
+    if (pVgroup->vgId == vgId) {
+      return pVgroup;
+    }
+  }
+  return NULL;
+}
+
+static void tscVgroupMsgToEpSet(SRpcEpSet* pEpSet, SVgroupMsg* pVgroupMsg) {
+  pEpSet->inUse = 0;
+  pEpSet->numOfEps = pVgroupMsg->numOfEps;
+  for (int32_t i = 0; i < pVgroupMsg->numOfEps; ++i) {
+    tstrncpy(pEpSet->fqdn[i], pVgroupMsg->epAddr[i].fqdn, sizeof(pEpSet->fqdn[i]));
+    pEpSet->port[i] = pVgroupMsg->epAddr[i].port;
+  }
+}
+
+// the vgroups are rebuilt along with the table list, the version of the vgroups still subscribed is kept
+static void tscBuildSubVgroups(SSub* pSub) {
+  SSubPush* pPush = pSub->push;
+  if (pPush == NULL) {
+    return;
+  }
+
+  SSqlObj*        pSql = pSub->pSql;
+  STableMetaInfo* pTableMetaInfo = tscGetTableMetaInfoFromCmd(&pSql->cmd, 0);
+  STableMeta*     pTableMeta = pTableMetaInfo->pTableMeta;
+  SArray*         vgroups = taosArrayInit(4, sizeof(SSubVgroup));
+  SArray*         pVgroupTables = NULL;
+  if (vgroups == NULL) {
+    return;
+  }
+
+  if (UTIL_TABLE_IS_SUPER_TABLE(pTableMetaInfo)) {
+    pVgroupTables = tscVgroupTableInfoDup(pTableMetaInfo->pVgroupTables);
+    size_t numOfVgroups = (pVgroupTables == NULL) ? 0 : taosArrayGetSize(pVgroupTables);
+
+    for (size_t i = 0; i < numOfVgroups; ++i) {
+      SVgroupTableInfo* pInfo = taosArrayGet(pVgroupTables, i);
+      size_t            numOfTables = taosArrayGetSize(pInfo->itemList);
+      SSubVgroup        vgroup = {.vgId = pInfo->vgInfo.vgId, .uids = taosArrayInit(numOfTables, sizeof(int64_t))};
+
+      tscVgroupMsgToEpSet(&vgroup.epSet, &pInfo->vgInfo);
+      for (size_t j = 0; j < numOfTables; ++j) {
+        STableIdInfo* pItem = taosArrayGet(pInfo->itemList, j);
+        taosArrayPush(vgroup.uids, &pItem->uid);
+      }
+      taosArrayPush(vgroups, &vgroup);
+    }
+  } else if (pTableMeta != NULL) {
+    SNewVgroupInfo vgroupInfo = {.vgId = -1};
+    taosHashGetClone(UTIL_GET_VGROUPMAP(pSql), &pTableMeta->vgId, sizeof(pTableMeta->vgId), NULL, &vgroupInfo);
+
+    if (vgroupInfo.numOfEps > 0) {
+      SSubVgroup vgroup = {.vgId = pTableMeta->vgId, .uids = taosArrayInit(1, sizeof(int64_t))};
+      vgroup.epSet.inUse = (vgroupInfo.inUse >= 0 && vgroupInfo.inUse < vgroupInfo.numOfEps) ? vgroupInfo.inUse : 0;
+      vgroup.epSet.numOfEps = vgroupInfo.numOfEps;
+      for (int32_t i = 0; i < vgroupInfo.numOfEps; ++i) {
+        tstrncpy(vgroup.epSet.fqdn[i], vgroupInfo.ep[i].fqdn, sizeof(vgroup.epSet.fqdn[i]));
+        vgroup.epSet.port[i] = vgroupInfo.ep[i].port;
+      }
+      taosArrayPush(vgroup.uids, &pTableMeta->id.uid);
+      taosArrayPush(vgroups, &vgroup);
+    }
+  }
+
+  pthread_mutex_lock(&pPush->mutex);
+  size_t numOfVgroups = taosArrayGetSize(vgroups);
+  for (size_t i = 0; i < numOfVgroups; ++i) {
+    SSubVgroup* pVgroup = taosArrayGet(vgroups, i);
+    SSubVgroup* pOld = tscGetSubVgroup(pPush->vgroups, pVgroup->vgId);
+    if (pOld != NULL) {
+      pVgroup->version = pOld->version;
+      pVgroup->pending = pOld->pending;
+    }
+  }
+
+  tscFreeSubVgroups(pPush->vgroups);
+  pPush->vgroups = vgroups;
+  tscFreeVgroupTableInfo(pPush->pVgroupTables);
+  pPush->pVgroupTables = pVgroupTables;
+  pthread_mutex_unlock(&pPush->mutex);
+
+  tscDebug("subscribe:%s, waits for the submits of %d vgroups", pSub->topic, (int32_t)numOfVgroups);
+}
+
+static void tscSubscribeCallback(void *param, TAOS_RES *tres, int code) {
+  SSubWaitParam* pParam = (SSubWaitParam*)param;
+  SSubPush*      pPush = pParam->pPush;
+  SSqlObj*       pSql = (SSqlObj*)tres;
+  SSqlRes*       pRes = &pSql->res;
+
+  SSubscribeRsp* pRsp = (SSubscribeRsp*)pRes->pRsp;
+  int32_t        numOfTables = -1;
+  if (pRes->code == TSDB_CODE_SUCCESS && pRsp != NULL && pRes->rspLen >= (int32_t)sizeof(SSubscribeRsp)) {
+    numOfTables = htonl(pRsp->numOfTables);
+    if (numOfTables < 0 || pRes->rspLen < (int32_t)(sizeof(SSubscribeRsp) + sizeof(int64_t) * numOfTables)) {
+      numOfTables = -1;
+    }
+  }
+
+  pthread_mutex_lock(&pPush->mutex);
+  pPush->numOfPending -= 1;
+
+  SSubVgroup* pVgroup = tscGetSubVgroup(pPush->vgroups, pParam->vgId);
+  if (pVgroup != NULL) {
+    pVgroup->pending = 0;
+    if (numOfTables >= 0) {
+      pVgroup->version = htobe64(pRsp->version);
+      for (int32_t i = 0; i < numOfTables; ++i) {
+        int64_t uid = htobe64(pRsp->uids[i]);
+        taosArrayPush(pPush->changed, &uid);
+      }
+    } else {
+      // all the tables of the vgroup are queried, and caught up with the vnode again in the next request
+      tscDebug("0x%" PRIx64 " failed to subscribe vgId:%d, code:%s", pSql->self, pParam->vgId, tstrerror(pRes->code));
+      pVgroup->version = 0;
+      pPush->failed = 1;
+      taosArrayAddAll(pPush->changed, pVgroup->uids);
+    }
+  }
+
+  tsem_post(&pPush->sem);
+  pthread_mutex_unlock(&pPush->mutex);
+
+  tscReleaseSubPush(pPush);
+  taosRemoveRef(tscObjRef, pSql->self);
+  free(pParam);
+}
+
+int tscSendMsgToServer(SSqlObj *pSql);
+
+static SSqlObj* tscBuildSubscribeReq(SSub* pSub, SSubVgroup* pVgroup, int32_t waitTime) {
+  int32_t numOfTables = (int32_t)taosArrayGetSize(pVgroup->uids);
+  int32_t size = (int32_t)(sizeof(SSubscribeMsg) + sizeof(int64_t) * numOfTables);
+
+  SSubWaitParam* pParam = calloc(1, sizeof(SSubWaitParam));
+  SSqlObj*       pSql = calloc(1, sizeof(SSqlObj));
+  if (pParam == NULL || pSql == NULL) {
+    free(pParam);
+    free(pSql);
+    return NULL;
+  }
+
+  tsem_init(&pSql->rspSem, 0, 0);
+  pSql->signature = pSql;
+  if (tscAllocPayload(&pSql->cmd, size) != TSDB_CODE_SUCCESS || tscGetQueryInfoS(&pSql->cmd) == NULL) {
+    free(pParam);
+    tscFreeSqlObj(pSql);
+    return NULL;
+  }
+
+  pParam->pPush = pSub->push;
+  pParam->vgId = pVgroup->vgId;
+
+  pSql->pTscObj   = pSub->taos;
+  pSql->rootObj   = pSql;
+  pSql->param     = pParam;
+  pSql->fp        = tscSubscribeCallback;
+  pSql->fetchFp   = tscSubscribeCallback;
+  pSql->maxRetry  = TSDB_MAX_REPLICA;
+  pSql->epSet     = pVgroup->epSet;
+
+  SSqlCmd* pCmd = &pSql->cmd;
+  pCmd->command    = TSDB_SQL_SUBSCRIBE;
+  pCmd->msgType    = TSDB_MSG_TYPE_SUBSCRIBE;
+  pCmd->payloadLen = size;
+
+  SSubscribeMsg* pMsg = (SSubscribeMsg*)pCmd->payload;
+  pMsg->header.vgId    = htonl(pVgroup->vgId);
+  pMsg->header.contLen = htonl(size);
+  pMsg->version        = htobe64(pVgroup->version);
+  pMsg->waitTime       = htonl(waitTime);
+  pMsg->numOfTables    = htonl(numOfTables);
+  for (int32_t i = 0; i < numOfTables; ++i) {
+    pMsg->uids[i] = htobe64(*(int64_t*)taosArrayGet(pVgroup->uids, i));
+  }
+
+  registerSqlObj(pSql);
+  return pSql;
+}
+
+/*
+ * Send the subscribe requests to the vgroups without one waiting, and return the tables written since the last
+ * query, sorted by uid. If block is set, it waits until any table is written or all the requests are responded.
+ * NULL is returned if the tables are unknown, and all the tables shall be queried.
+ */
+static SArray* tscWaitForSubmits(SSub* pSub, bool block) {
+  SSubPush* pPush = pSub->push;
+  SArray*   reqs = taosArrayInit(4, POINTER_BYTES);
+  if (reqs == NULL) {
+    return NULL;
+  }
+
+  pthread_mutex_lock(&pPush->mutex);
+  size_t numOfVgroups = taosArrayGetSize(pPush->vgroups);
+  for (size_t i = 0; i < numOfVgroups; ++i) {
+    SSubVgroup* pVgroup = taosArrayGet(pPush->vgroups, i);
+    if (pVgroup->pending) {
+      continue;
+    }
+
+    SSqlObj* pSql = tscBuildSubscribeReq(pSub, pVgroup, pSub->interval);
+    if (pSql == NULL) {
+      taosArrayAddAll(pPush->changed, pVgroup->uids);
+      continue;
+    }
+
+    pVgroup->pending = 1;
+    pPush->numOfPending += 1;
+    pPush->refCount += 1;
+    taosArrayPush(reqs, &pSql);
+  }
+
+  // no table is known, the tables are queried as if the subscription is not pushed
+  if (numOfVgroups == 0) {
+    pPush->failed = 1;
+  }
+  pthread_mutex_unlock(&pPush->mutex);
+
+  size_t numOfReqs = taosArrayGetSize(reqs);
+  for (size_t i = 0; i < numOfReqs; ++i) {
+    SSqlObj* pSql = taosArrayGetP(reqs, i);
+    tscDebug("0x%" PRIx64 " subscribe:%s, wait for the submits of vgId:%d", pSql->self, pSub->topic,
+             ((SSubWaitParam*)pSql->param)->vgId);
+
+    int32_t code = tscSendMsgToServer(pSql);
+    if (code != TSDB_CODE_SUCCESS) {
+      pSql->res.code = code;
+      tscSubscribeCallback(pSql->param, pSql, code);
+    }
+  }
+  taosArrayDestroy(&reqs);
+
+  if (numOfVgroups == 0) {
+    return NULL;
+  }
+
+  while (block) {
+    pthread_mutex_lock(&pPush->mutex);
+    bool done = taosArrayGetSize(pPush->changed) > 0 || pPush->numOfPending == 0;
+    pthread_mutex_unlock(&pPush->mutex);
+
+    if (done) {
+      break;
+    }
+    tsem_wait(&pPush->sem);
+  }
+
+  pthread_mutex_lock(&pPush->mutex);
+  SArray* changed = pPush->changed;
+  pPush->changed = taosArrayInit(32, sizeof(int64_t));
+  pthread_mutex_unlock(&pPush->mutex);
+
+  if (pPush->changed == NULL) {
+    pPush->changed = changed;
+    return NULL;
+  }
+
+  taosArraySort(changed, compareInt64Val);
+  taosArrayRemoveDuplicate(changed, compareInt64Val, NULL);
+  return changed;
+}
+
+// the tables not written are queried again in the next round
+static void tscRestoreSubmits(SSub* pSub, SArray* changed) {
+  SSubPush* pPush = pSub->push;
+  pthread_mutex_lock(&pPush->mutex);
+  taosArrayAddAll(pPush->changed, changed);
+  pthread_mutex_unlock(&pPush->mutex);
+}
+
+// limit the query to the tables written, false is returned if none of them is subscribed
+static bool tscSetSubscribedTables(SSub* pSub, SArray* changed) {
+  if (taosArrayGetSize(changed) == 0) {
+    return false;
+  }
+
+  STableMetaInfo* pTableMetaInfo = tscGetTableMetaInfoFromCmd(&pSub->pSql->cmd, 0);
+  if (!UTIL_TABLE_IS_SUPER_TABLE(pTableMetaInfo)) {
+    return true;
+  }
+
+  SSubPush* pPush = pSub->push;
+  size_t    numOfVgroups = (pPush->pVgroupTables == NULL) ? 0 : taosArrayGetSize(pPush->pVgroupTables);
+  SArray*   pVgroupTables = taosArrayInit(numOfVgroups, sizeof(SVgroupTableInfo));
+  if (pVgroupTables == NULL) {
+    return true;
+  }
+
+  for (size_t i = 0; i < numOfVgroups; ++i) {
+    SVgroupTableInfo* pInfo = taosArrayGet(pPush->pVgroupTables, i);
+    size_t            numOfTables = taosArrayGetSize(pInfo->itemList);
+    SVgroupTableInfo  info = {.vgInfo = pInfo->vgInfo, .itemList = taosArrayInit(4, sizeof(STableIdInfo))};
+
+    for (size_t j = 0; j < numOfTables; ++j) {
+      STableIdInfo* pItem = taosArrayGet(pInfo->itemList, j);
+      if (taosArraySearch(changed, &pItem->uid, compareInt64Val, TD_EQ) != NULL) {
+        taosArrayPush(info.itemList, pItem);
+      }
+    }
+
+    if (taosArrayGetSize(info.itemList) == 0) {
+      taosArrayDestroy(&info.itemList);
+    } else {
+      taosArrayPush(pVgroupTables, &info);
+    }
+  }
+
+  tscFreeVgroupTableInfo(pTableMetaInfo->pVgroupTables);
+  pTableMetaInfo->pVgroupTables = pVgroupTables;
+  return taosArrayGetSize(pVgroupTables) > 0;
+}
+
+// nothing is written into the tables of the subscription
+static TAOS_RES* tscEmptySubscriptionResult(SSub* pSub) {
+  SSqlObj* pSql = pSub->pSql;
+  tscRemoveFromSqlList(pSql);
+  tscFreeSqlResult(pSql);
+
+  pSql->res.code = TSDB_CODE_SUCCESS;
+  pSql->res.numOfRows = 0;
+  pSql->res.qId = 0;
+  pSql->res.completed = true;
+
+  pSub->lastConsumeTime = taosGetTimestampMs();
+  return pSql;
+}
+
 
 static int tscLoadSubscriptionProgress(SSub* pSub) {
   char buf[TSDB_MAX_SQL_LEN];
@@ -408,6 +818,13 @@ TAOS_SUB *taos_subscribe(TAOS *taos, int restart, const char* topic, const char
   }
   pSub->taos = taos;
 
+  if (tsSubscribePush) {
+    pSub->push = tscCreateSubPush();
+    if (pSub->push == NULL) {
+      tscWarn("subscribe:%s, failed to wait for the submits, tables are queried on every consume", topic);
+    }
+  }
+
   if (restart) {
     tscDebug("restart subscription: %s", topic);
   } else {
@@ -492,7 +909,16 @@ TAOS_RES *taos_consume(TAOS_SUB *tsub) {
   SSub *pSub = (SSub *)tsub;
   if (pSub == NULL) return NULL;
 
-  if (pSub->pTimer == NULL) {
+  // the subscribe requests wait in the vnodes instead, unless they failed in the last round
+  bool throttle = true;
+  if (pSub->push != NULL) {
+    pthread_mutex_lock(&pSub->push->mutex);
+    throttle = (pSub->push->failed != 0);
+    pSub->push->failed = 0;
+    pthread_mutex_unlock(&pSub->push->mutex);
+  }
+
+  if (pSub->pTimer == NULL && throttle) {
     int64_t duration = taosGetTimestampMs() - pSub->lastConsumeTime;
     if (duration < (int64_t)(pSub->interval)) {
       tscDebug("subscription consume too frequently, blocking...");
@@ -522,6 +948,23 @@ TAOS_RES *taos_consume(TAOS_SUB *tsub) {
     tscDebug("table synchronization completed");    
   }
 
+  // only the tables written are queried, the asynchronous subscription checks them on its timer without blocking
+  SArray* changed = NULL;
+  if (pSub->push != NULL) {
+    if (taosGetTimestampMs() - pSub->lastSyncTime > 10 * 60 * 1000) {
+      tscDebug("begin table synchronization");
+      if (!tscUpdateSubscription(pSub->taos, pSub)) return NULL;
+      tscDebug("table synchronization completed");
+    }
+
+    changed = tscWaitForSubmits(pSub, pSub->pTimer == NULL);
+    if (changed != NULL && !tscSetSubscribedTables(pSub, changed)) {
+      tscDebug("subscribe:%s, no table is written", pSub->topic);
+      taosArrayDestroy(&changed);
+      return tscEmptySubscriptionResult(pSub);
+    }
+  }
+
   tscSaveSubscriptionProgress(pSub);
 
   SSqlObj *pSql = pSub->pSql;
@@ -534,13 +977,18 @@ TAOS_RES *taos_consume(TAOS_SUB *tsub) {
     size_t size = taosArrayGetSize(pSub->progress);
     TSKEY s = INT64_MAX;
     for(int32_t i = 0; i < size; ++i) {
-      TSKEY k = ((SSubscriptionProgress*)taosArrayGet(pSub->progress, i))->key;
-      if (s > k) {
-        s = k;
+      SSubscriptionProgress* p = taosArrayGet(pSub->progress, i);
+      if (changed != NULL && taosArraySearch(changed, &p->uid, compareInt64Val, TD_EQ) == NULL) {
+        continue;
+      }
+      if (s > p->key) {
+        s = p->key;
       }
     }
 
-    pQueryInfo->window.skey = s;
+    if (s != INT64_MAX) {
+      pQueryInfo->window.skey = s;
+    }
     tscDebug("subscribe:%s set next round subscribe skey:%"PRId64, pSub->topic, pQueryInfo->window.skey);
   }
 
@@ -549,6 +997,10 @@ TAOS_RES *taos_consume(TAOS_SUB *tsub) {
   int code = tscAllocPayload(&pSql->cmd, (int)size);
   if (code != TSDB_CODE_SUCCESS) {
     tscError("failed to alloc payload");
+    if (changed != NULL) {
+      tscRestoreSubmits(pSub, changed);
+      taosArrayDestroy(&changed);
+    }
     return NULL;
   }
 
@@ -557,7 +1009,13 @@ TAOS_RES *taos_consume(TAOS_SUB *tsub) {
 
     if (taosGetTimestampMs() - pSub->lastSyncTime > 10 * 60 * 1000) {
       tscDebug("begin table synchronization");
-      if (!tscUpdateSubscription(pSub->taos, pSub)) return NULL;
+      if (!tscUpdateSubscription(pSub->taos, pSub)) {
+        if (changed != NULL) {
+          tscRestoreSubmits(pSub, changed);
+          taosArrayDestroy(&changed);
+        }
+        return NULL;
+      }
       tscDebug("table synchronization completed");
     }
 
@@ -588,6 +1046,13 @@ TAOS_RES *taos_consume(TAOS_SUB *tsub) {
     break;
   }
 
+  if (changed != NULL) {
+    if (pRes->code != TSDB_CODE_SUCCESS) {
+      tscRestoreSubmits(pSub, changed);
+    }
+    taosArrayDestroy(&changed);
+  }
+
   if (pRes->code != TSDB_CODE_SUCCESS) {
     tscError("failed to query data: %s", tstrerror(pRes->code));
     tscRemoveFromSqlList(pSql);
@@ -626,6 +1091,11 @@ void taos_unsubscribe(TAOS_SUB *tsub, int keepProgress) {
     }
   }
 
+  // the pending subscribe requests release it once they are responded
+  if (pSub->push != NULL) {
+    tscReleaseSubPush(pSub->push);
+  }
+
   taosArrayDestroy(&pSub->progress);
   tsem_destroy(&pSub->sem);
   memset(pSub, 0, sizeof(*pSub));
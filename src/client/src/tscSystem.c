@@ -128,6 +128,11 @@ void tscClusterInfoDestroy(SClusterInfo *pObj) {
   taosHashCleanup(pObj->vgroupMap);
   taosHashCleanup(pObj->tableMetaMap);
   taosCacheCleanup(pObj->vgroupListBuf);
+  taosHashCleanup(pObj->stableNameMap);
+  if (pObj->pendingMetaMap != NULL) {
+    taosHashCleanup(pObj->pendingMetaMap);
+    pthread_mutex_destroy(&pObj->pendingMetaLock);
+  }
   tfree(pObj);
 }
 
@@ -143,7 +148,13 @@ void *tscAcquireClusterInfo(const char *clusterId) {
       pObj->vgroupMap     = taosHashInit(256, taosGetDefaultHashFunction(TSDB_DATA_TYPE_INT), true, HASH_ENTRY_LOCK);
       pObj->tableMetaMap  = taosHashInit(1024, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), true, HASH_ENTRY_LOCK); //
       pObj->vgroupListBuf = taosCacheInit(TSDB_DATA_TYPE_BINARY, 5, false, NULL, "stable-vgroup-list");
-      if (pObj->vgroupMap == NULL || pObj->tableMetaMap == NULL || pObj->vgroupListBuf == NULL) {
+      pObj->stableNameMap = taosHashInit(64, taosGetDefaultHashFunction(TSDB_DATA_TYPE_UBIGINT), true, HASH_ENTRY_LOCK);
+      pObj->pendingMetaMap = taosHashInit(64, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), true, HASH_NO_LOCK);
+      if (pObj->pendingMetaMap != NULL) {
+        pthread_mutex_init(&pObj->pendingMetaLock, NULL);
+      }
+      if (pObj->vgroupMap == NULL || pObj->tableMetaMap == NULL || pObj->vgroupListBuf == NULL ||
+          pObj->stableNameMap == NULL || pObj->pendingMetaMap == NULL) {
         tscClusterInfoDestroy(pObj);
         pObj = NULL;
       } else {
@@ -1529,6 +1529,8 @@ static void tscDestroyResPointerInfo(SSqlRes* pRes) {
 
   tfree(pRes->pColumnIndex);
   tfree(pRes->final);
+  tfree(pRes->columns);
+  tfree(pRes->isNull);
 
   pRes->data = NULL;  // pRes->data points to the buffer of pRsp, no need to free
 }
@@ -1593,6 +1595,16 @@ void destroyTableNameList(SInsertStatementParam* pInsertParam) {
   tfree(pInsertParam->pTableNameList);
 }
 
+static void freeCreateTableElem(void* p) {
+  tfree(*(char**)p);
+}
+
+void destroyCreateTableList(SInsertStatementParam* pInsertParam) {
+  taosArrayDestroyEx(&pInsertParam->pCreateNames, freeCreateTableElem);
+  taosArrayDestroyEx(&pInsertParam->pCreateClauses, freeCreateTableElem);
+  pInsertParam->numOfCreateSent = 0;
+}
+
 void tscResetSqlCmd(SSqlCmd* pCmd, bool clearCachedMeta, uint64_t id) {
   SSqlObj *pSql = (SSqlObj*)taosAcquireRef(tscObjRef, id);
   pCmd->command   = 0;
@@ -1602,6 +1614,7 @@ void tscResetSqlCmd(SSqlCmd* pCmd, bool clearCachedMeta, uint64_t id) {
 
   pCmd->insertParam.sql = NULL;
   destroyTableNameList(&pCmd->insertParam);
+  destroyCreateTableList(&pCmd->insertParam);
 
   pCmd->insertParam.pTableBlockHashList = tscDestroyBlockHashTable(pSql, pCmd->insertParam.pTableBlockHashList, clearCachedMeta);
   pCmd->insertParam.pDataBlocks = tscDestroyBlockArrayList(pSql, pCmd->insertParam.pDataBlocks);
@@ -1610,6 +1623,7 @@ void tscResetSqlCmd(SSqlCmd* pCmd, bool clearCachedMeta, uint64_t id) {
 
   tscFreeQueryInfo(pCmd, clearCachedMeta, id);
   pCmd->pTableMetaMap = tscCleanupTableMetaMap(pCmd->pTableMetaMap);
+  tfree(pCmd->pMsgTemplate);
   taosReleaseRef(tscObjRef, id);
 }
 
@@ -1683,6 +1697,12 @@ void tscFreeRegisteredSqlObj(void *pSql) {
   int32_t total = atomic_sub_fetch_32(&tscNumOfObj, 1);
 
   tscDebug("0x%"PRIx64" free SqlObj, total in tscObj:%d, total:%d", p->self, num, total);
+
+  // the requests waiting for the table meta are resumed, if it is cancelled before the response
+  if (p->cmd.command == TSDB_SQL_META) {
+    tscFinishPendingTableMeta(p);
+  }
+
   tscFreeSqlObj(p);
   taosReleaseRef(tscRefId, pTscObj->rid);
 }
@@ -1712,6 +1732,7 @@ void tscFreeSqlObj(SSqlObj* pSql) {
 
   tscFreeMetaSqlObj(&pSql->metaRid);
   tscFreeMetaSqlObj(&pSql->svgroupRid);
+  tscDiscardFetchAheadRsp(pSql);
 
   SSqlCmd* pCmd = &pSql->cmd;
   int32_t cmd = pCmd->command;
@@ -2064,7 +2085,23 @@ static int trimDataBlock(void* pDataBlock, STableDataBlocks* pTableDataBlock, SI
   pBlock->dataLen = 0;
   int32_t numOfRows = htons(pBlock->numOfRows);
 
-  if (IS_RAW_PAYLOAD(insertParam->payloadType)) {
+  if (IS_RAW_PAYLOAD(insertParam->payloadType) && flen == pTableDataBlock->rowSize) {
+    // no binary/nchar column, the raw row is the same as the tuple of the data row except the key
+    for (int32_t i = 0; i < numOfRows; ++i) {
+      SMemRow memRow = (SMemRow)pDataBlock;
+      memRowSetType(memRow, SMEM_ROW_DATA);
+      SDataRow trow = memRowDataBody(memRow);
+      dataRowSetLen(trow, (uint16_t)(TD_DATA_ROW_HEAD_SIZE + flen));
+      dataRowSetVersion(trow, pTableMeta->sversion);
+
+      memcpy(dataRowTuple(trow), p, flen);
+      *(TKEY*)dataRowTuple(trow) = tdGetTKEY(*(TSKEY*)p);
+      p += flen;
+
+      pDataBlock = (char*)pDataBlock + memRowTLen(memRow);
+      pBlock->dataLen += memRowTLen(memRow);
+    }
+  } else if (IS_RAW_PAYLOAD(insertParam->payloadType)) {
     for (int32_t i = 0; i < numOfRows; ++i) {
       SMemRow memRow = (SMemRow)pDataBlock;
       memRowSetType(memRow, SMEM_ROW_DATA);
@@ -3822,6 +3859,7 @@ SSqlObj* createSubqueryObj(SSqlObj* pSql, int16_t tableIndex, __async_cb_func_t
   pnCmd->payload = NULL;
   pnCmd->allocSize = 0;
   pnCmd->pTableMetaMap = NULL;
+  pnCmd->pMsgTemplate = NULL;
 
   pnCmd->pQueryInfo  = NULL;
   pnCmd->insertParam.pDataBlocks = NULL;
@@ -4766,11 +4804,152 @@ CChildTableMeta* tscCreateChildMeta(STableMeta* pTableMeta) {
   cMeta->vgId      = pTableMeta->vgId;
   cMeta->id        = pTableMeta->id;
   cMeta->suid      = pTableMeta->suid;
-  tstrncpy(cMeta->sTableName, pTableMeta->sTableName, TSDB_TABLE_FNAME_LEN);
 
   return cMeta;
 }
 
+void tscAddSTableNameToCache(SSqlObj *pSql, uint64_t suid, const char* name) {
+  SHashObj* pNameMap = pSql->pTscObj->pClusterInfo->stableNameMap;
+  if (taosHashGet(pNameMap, &suid, sizeof(suid)) == NULL) {
+    taosHashPut(pNameMap, &suid, sizeof(suid), (void*) name, strnlen(name, TSDB_TABLE_FNAME_LEN - 1) + 1);
+  }
+}
+
+// the child tables of a dropped super table are found missing by the name, and retrieved from mnode again
+void tscRemoveSTableNameFromCache(SSqlObj *pSql, uint64_t suid) {
+  taosHashRemove(pSql->pTscObj->pClusterInfo->stableNameMap, &suid, sizeof(suid));
+}
+
+STableMeta* tscGetTableMetaFromCache(SSqlObj *pSql, const char* name, size_t len, STableMeta** ppMeta, size_t* pCapacity) {
+  if (NULL == taosHashGetCloneExt(UTIL_GET_TABLEMETA(pSql), name, len, NULL, (void **)ppMeta, pCapacity)) {
+    return NULL;
+  }
+
+  STableMeta* pMeta = *ppMeta;
+  if (pMeta->tableType != TSDB_CHILD_TABLE) {
+    return pMeta;
+  }
+
+  // expand the compact record of the child table
+  CChildTableMeta cMeta;
+  memcpy(&cMeta, pMeta, sizeof(CChildTableMeta));
+
+  if (*pCapacity < sizeof(STableMeta)) {
+    pMeta = realloc(pMeta, sizeof(STableMeta));
+    if (pMeta == NULL) {
+      return NULL;
+    }
+
+    *ppMeta = pMeta;
+    *pCapacity = sizeof(STableMeta);
+  }
+
+  memset(pMeta, 0, sizeof(STableMeta));
+  pMeta->vgId      = cMeta.vgId;
+  pMeta->id        = cMeta.id;
+  pMeta->tableType = TSDB_CHILD_TABLE;
+  pMeta->suid      = cMeta.suid;
+
+  if (NULL == taosHashGetClone(pSql->pTscObj->pClusterInfo->stableNameMap, &cMeta.suid, sizeof(cMeta.suid), NULL, pMeta->sTableName)) {
+    memset(pMeta, 0, sizeof(STableMeta));
+    return NULL;
+  }
+
+  return pMeta;
+}
+
+// estimated memory of the key of an entry in the table meta cache
+#define TSC_META_CACHE_KEY_SIZE    64
+
+// estimated memory of a child table in the table meta cache besides the hash node
+#define TSC_META_CACHE_ENTRY_SIZE  (sizeof(CChildTableMeta) + TSC_META_CACHE_KEY_SIZE)
+
+// the bytes of the metas in the cache, with the schemas of the super and normal tables
+static int64_t tscCountTableMetaBytes(SHashObj* pMap) {
+  int64_t bytes = 0;
+
+  void* p = taosHashIterate(pMap, NULL);
+  while (p != NULL) {
+    STableMeta* pMeta = p;
+    bytes += (pMeta->tableType == TSDB_CHILD_TABLE) ? sizeof(CChildTableMeta) : tscGetTableMetaSize(pMeta);
+    p = taosHashIterate(pMap, p);
+  }
+
+  return bytes;
+}
+
+/*
+ * The bytes of the metas put are added up, but not subtracted when the metas are replaced or removed, so they are
+ * recounted before the child tables are evicted.
+ */
+void tscEvictTableMetaCache(SSqlObj *pSql, int64_t bytes) {
+  SClusterInfo* pInfo = pSql->pTscObj->pClusterInfo;
+  SHashObj*     pMap = pInfo->tableMetaMap;
+  SHashObj*     pNameMap = pInfo->stableNameMap;
+
+  int64_t metaBytes = atomic_add_fetch_64(&pInfo->metaBytes, bytes);
+  if (tsMetaCacheMaxSize <= 0) {
+    return;
+  }
+
+  int64_t limit = (int64_t)tsMetaCacheMaxSize * 1024 * 1024;
+  int64_t threshold = MAX(limit, atomic_load_64(&pInfo->evictSize));
+  int64_t overhead = (int64_t)taosHashGetMemSize(pMap) + taosHashGetSize(pMap) * (int64_t)TSC_META_CACHE_KEY_SIZE +
+                     (int64_t)taosHashGetMemSize(pNameMap) + taosHashGetSize(pNameMap) * (int64_t)TSDB_TABLE_FNAME_LEN;
+  if (overhead + metaBytes <= threshold || atomic_val_compare_exchange_32(&pInfo->evicting, 0, 1) != 0) {
+    return;
+  }
+
+  metaBytes = tscCountTableMetaBytes(pMap);
+  atomic_store_64(&pInfo->metaBytes, metaBytes);
+
+  int64_t size = overhead + metaBytes;
+  if (size <= limit) {
+    atomic_store_64(&pInfo->evictSize, 0);
+    atomic_store_32(&pInfo->evicting, 0);
+    return;
+  }
+
+  // evict the child tables until the cache shrinks to 3/4 of the limit, the super tables are kept since the
+  // cached child tables refer to them
+  int64_t numOfEntries = MAX(taosHashGetSize(pMap), 1);
+  int64_t entrySize = (int64_t)TSC_META_CACHE_ENTRY_SIZE + (int64_t)taosHashGetMemSize(pMap) / numOfEntries;
+  int64_t num = (size - limit / 4 * 3) / entrySize + 1;
+  SArray* pKeys = taosArrayInit((size_t)MIN(num, taosHashGetSize(pMap)), TSDB_TABLE_FNAME_LEN);
+
+  void* p = taosHashIterate(pMap, NULL);
+  while (p != NULL && (int64_t)taosArrayGetSize(pKeys) < num) {
+    if (((STableMeta*)p)->tableType == TSDB_CHILD_TABLE) {
+      char     key[TSDB_TABLE_FNAME_LEN] = {0};
+      uint32_t len = taosHashGetDataKeyLen(pMap, p);
+      memcpy(key, taosHashGetDataKey(pMap, p), MIN(len, TSDB_TABLE_FNAME_LEN - 1));
+      taosArrayPush(pKeys, key);
+    }
+
+    p = taosHashIterate(pMap, p);
+  }
+
+  if (p != NULL) {
+    taosHashCancelIterate(pMap, p);
+  }
+
+  size_t numOfKeys = taosArrayGetSize(pKeys);
+  for (size_t i = 0; i < numOfKeys; ++i) {
+    char* key = taosArrayGet(pKeys, i);
+    taosHashRemove(pMap, key, strlen(key));
+  }
+  atomic_sub_fetch_64(&pInfo->metaBytes, (int64_t)numOfKeys * sizeof(CChildTableMeta));
+
+  // the metas kept alone exceed the limit, they are not evicted again till a quarter of the limit more is put
+  int64_t remain = size - (int64_t)numOfKeys * entrySize;
+  atomic_store_64(&pInfo->evictSize, (remain > limit) ? remain + limit / 4 : 0);
+
+  tscDebug("0x%"PRIx64" %d child tables evicted from the table meta cache of %" PRId64 " bytes, remain:%d", pSql->self,
+           (int32_t)numOfKeys, size, taosHashGetSize(pMap));
+  taosArrayDestroy(&pKeys);
+  atomic_store_32(&pInfo->evicting, 0);
+}
+
 int32_t tscCreateTableMetaFromSTableMeta(SSqlObj *pSql, STableMeta** ppChild, const char* name, size_t *tableMetaCapacity, STableMeta**ppSTable) {
   assert(*ppChild != NULL);
   STableMeta* p      = *ppSTable;
@@ -4806,6 +4985,9 @@ int32_t tscCreateTableMetaFromSTableMeta(SSqlObj *pSql, STableMeta** ppChild, co
     *ppChild = pChild;
     return TSDB_CODE_SUCCESS;
   } else { // super table has been removed, current tableMeta is also expired. remove it here
+    if (p != NULL && p->id.uid > 0) {  // the super table of the name is created again, the old one is dropped
+      tscRemoveSTableNameFromCache(pSql, pChild->suid);
+    }
     taosHashRemove(UTIL_GET_TABLEMETA(pSql), name, strnlen(name, TSDB_TABLE_FNAME_LEN));
     return -1;
   }
@@ -61,6 +61,9 @@ extern char     tsLocale[];
 extern char     tsCharset[];  // default encode string
 extern int8_t   tsEnableCoreFile;
 extern int32_t  tsCompressMsgSize;
+extern int32_t  tsCompressMsgAlgo;
+extern int32_t  tsCompressMsgLevel;
+extern char     tsCompressMsgDict[];
 extern int32_t  tsCompressColData;
 extern int32_t  tsMaxNumOfDistinctResults;
 extern char     tsTempDir[];
@@ -71,6 +74,7 @@ extern int32_t tsQueryBufferSize;  // maximum allowed usage buffer size in MB fo
 extern int64_t
     tsQueryBufferSizeBytes;  // maximum allowed usage buffer size in byte for each data node during query processing
 extern int32_t tsRetrieveBlockingModel;  // retrieve threads will be blocked
+extern int32_t tsQueryTimeSlice;         // queries running longer than this (ms) are served after short ones
 
 extern int8_t tsKeepOriginalColumnName;
 
@@ -115,17 +119,23 @@ extern int8_t  tsCacheLastRow;
 extern bool    tsdbForceKeepFile;
 extern bool    tsdbForceCompactFile;
 extern int32_t tsdbWalFlushSize;
+extern int32_t tsTierMigrateInterval;
+extern int32_t tsTierMigrateRate;
+extern int32_t tsTierHotReads;
 
 // balance
 extern int8_t  tsEnableBalance;
 extern int8_t  tsAlternativeRole;
 extern int32_t tsBalanceInterval;
+extern float   tsBalanceLoadThreshold;
 extern int32_t tsOfflineInterval;
 extern int32_t tsOfflineThreshold;
 extern int32_t tsMnodeEqualVnodeNum;
+extern int32_t tsMnodeSnapshotRows;
 extern int8_t  tsEnableFlowCtrl;
 extern int8_t  tsEnableSlaveQuery;
 extern int8_t  tsEnableAdjustMaster;
+extern int8_t  tsZeroCopySubmit;
 
 // restful
 extern int8_t   tsEnableHttpModule;
@@ -241,6 +251,20 @@ extern int8_t tsDeadLockKillQuery;
 extern char tsDefaultJSONStrType[];
 extern char tsSmlChildTableName[];
 extern char tsSmlTagNullName[];
+extern int8_t tsSmlDirectInsert;
+extern int32_t tsSmlParseThreads;
+extern int32_t tsFetchAheadBlocks;
+extern int32_t tsFetchAheadBufferSize;
+
+// ingest pipeline
+extern int32_t tsIngestParseThreads;
+extern int32_t tsIngestBatchSize;
+extern int32_t tsIngestFlushInterval;
+extern int32_t tsIngestMaxInflight;
+extern int8_t  tsSubscribePush;
+extern int8_t  tsIncrementalStream;
+extern int32_t tsStreamStateBufferSize;
+extern int32_t tsMetaCacheMaxSize;
 
 
 typedef struct {
@@ -77,6 +77,18 @@ int32_t tsShortcutFlag = 0;  // shortcut flag to facilitate debugging
  */
 int32_t tsCompressMsgSize = 512 * 1024;
 
+/*
+ * algorithm used to compress the response messages, it is only applied if the peer is able to decompress it,
+ * otherwise lz4 is used. Request messages are always compressed with lz4.
+ * 1: lz4
+ * 2: deflate, the compression level is set by tsCompressMsgLevel
+ */
+int32_t tsCompressMsgAlgo = 1;
+int32_t tsCompressMsgLevel = 1;
+
+// dictionary shared by client and server to compress small messages, it must be identical on both sides
+char    tsCompressMsgDict[PATH_MAX] = {0};
+
 /* denote if server needs to compress the retrieved column data before adding to the rpc response message body.
  * 0: all data are compressed
  * -1: all data are not compressed
@@ -129,6 +141,10 @@ int64_t tsQueryBufferSizeBytes = -1;
 // in retrieve blocking model, the retrieve threads will wait for the completion of the query processing.
 int32_t tsRetrieveBlockingModel = 0;
 
+// a query which has been executed longer than this time (ms) is resumed from a low priority queue, so that new queries
+// and short running ones are served first. 0 means all queries are scheduled in the same queue.
+int32_t tsQueryTimeSlice = 100;
+
 // last_row(*), first(*), last_row(ts, col1, col2) query, the result fields will be the original column name
 int8_t tsKeepOriginalColumnName = 0;
 
@@ -160,18 +176,26 @@ int32_t tsTsdbMetaCompactRatio = TSDB_META_COMPACT_RATIO;
 bool    tsdbForceKeepFile = false;
 bool    tsdbForceCompactFile = false;                    // compact TSDB fileset forcibly
 int32_t tsdbWalFlushSize = TSDB_DEFAULT_WAL_FLUSH_SIZE;  // MB
+int32_t tsTierMigrateInterval = 0;    // seconds, 0 means the file sets move between tiers only when committed
+int32_t tsTierMigrateRate = 20;       // MB per second
+int32_t tsTierHotReads = 100;         // reads of the last hour to keep a file set one tier hotter, 0 means never
 
 // balance
 int8_t  tsEnableBalance = 1;
 int8_t  tsAlternativeRole = 0;
 int32_t tsBalanceInterval = 300;          // seconds
+float   tsBalanceLoadThreshold = 0;       // vnodes move to the dnodes less loaded by the ratio, 0 means by numbers
 int32_t tsOfflineInterval = 3;            // seconds
 int32_t tsOfflineThreshold = 86400 * 10;  // seconds of 10 days
 int32_t tsMnodeEqualVnodeNum = 4;
+int32_t tsMnodeSnapshotRows = 1000000;    // wal records between two snapshots of sdb, 0 means no snapshot
 int8_t  tsEnableFlowCtrl = 1;
 int8_t  tsEnableSlaveQuery = 1;
 int8_t  tsEnableAdjustMaster = 1;
 
+// submit msg from client is referenced by WAL and memtable until commit, instead of being copied
+int8_t  tsZeroCopySubmit = 0;
+
 // restful
 int8_t   tsEnableHttpModule = 1;
 int32_t  tsRestRowLimit = 10240;
@@ -299,6 +323,26 @@ char tsSmlChildTableName[TSDB_TABLE_NAME_LEN] = ""; //user defined child table n
 char tsSmlTagNullName[TSDB_COL_NAME_LEN] = "_tag_null"; //for line protocol if tag is omitted, add a tag with NULL value
                                                         //to make sure inserted records belongs to the same measurement
                                                         //default name is _tag_null and can be user configurable
+int8_t tsSmlDirectInsert = 1; //write the points of existing child tables into submit blocks directly, without SQL/stmt
+int32_t tsSmlParseThreads = 0; //number of threads to parse the lines of a schemaless insert, 0 means decided by the
+                               //number of lines and CPU cores
+int32_t tsFetchAheadBlocks = 1; //number of result blocks requested before the application asks for them, 0 means disabled
+int32_t tsFetchAheadBufferSize = 64; //MB, memory of all the result blocks requested ahead in the client
+
+// ingest pipeline (taos_ingest_*)
+int32_t tsIngestParseThreads = 1;     // number of threads to parse the insert statements of an ingest pipeline
+int32_t tsIngestBatchSize = 1024;     // KB, a submit message of a vgroup is sent once its blocks reach this size
+int32_t tsIngestFlushInterval = 100;  // ms, a submit message of a vgroup is sent once it is kept for this time
+int32_t tsIngestMaxInflight = 2;      // max number of submit messages of a vgroup waiting for the response
+
+int8_t tsSubscribePush = 0; //taos_consume waits for the vnodes to report new submits of the subscribed tables, instead
+                            //of querying all the tables on every consume
+
+int8_t  tsIncrementalStream = 0;     // streams keep the partial results of the panes instead of querying the windows again
+int32_t tsStreamStateBufferSize = 16;  // MB, the pane states of an incremental stream beyond it are kept in a file
+
+// MB, child tables are evicted from the table meta cache of the client beyond it, 0 means no limit
+int32_t tsMetaCacheMaxSize = 512;
 
 int32_t (*monStartSystemFp)() = NULL;
 void (*monStopSystemFp)() = NULL;
@@ -655,6 +699,16 @@ static void doInitGlobalConfig(void) {
   cfg.unitType = TAOS_CFG_UTYPE_NONE;
   taosInitConfigOption(cfg);
 
+  cfg.option = "balanceLoadThreshold";
+  cfg.ptr = &tsBalanceLoadThreshold;
+  cfg.valType = TAOS_CFG_VTYPE_FLOAT;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = 0;
+  cfg.maxValue = 0.9f;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
   cfg.option = "offlineInterval";
   cfg.ptr = &tsOfflineInterval;
   cfg.valType = TAOS_CFG_VTYPE_INT32;
@@ -1058,6 +1112,36 @@ static void doInitGlobalConfig(void) {
   cfg.unitType = TAOS_CFG_UTYPE_NONE;
   taosInitConfigOption(cfg);
 
+  cfg.option = "compressMsgAlgo";
+  cfg.ptr = &tsCompressMsgAlgo;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_CLIENT | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = 1;
+  cfg.maxValue = 2;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
+  cfg.option = "compressMsgLevel";
+  cfg.ptr = &tsCompressMsgLevel;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_CLIENT | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = 1;
+  cfg.maxValue = 9;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
+  cfg.option = "compressMsgDict";
+  cfg.ptr = tsCompressMsgDict;
+  cfg.valType = TAOS_CFG_VTYPE_STRING;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_CLIENT;
+  cfg.minValue = 0;
+  cfg.maxValue = 0;
+  cfg.ptrLength = tListLen(tsCompressMsgDict);
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
   cfg.option = "compressColData";
   cfg.ptr = &tsCompressColData;
   cfg.valType = TAOS_CFG_VTYPE_INT32;
@@ -1128,6 +1212,16 @@ static void doInitGlobalConfig(void) {
   cfg.unitType = TAOS_CFG_UTYPE_NONE;
   taosInitConfigOption(cfg);
 
+  cfg.option = "queryTimeSlice";
+  cfg.ptr = &tsQueryTimeSlice;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = 0;
+  cfg.maxValue = 3600000;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_MS;
+  taosInitConfigOption(cfg);
+
   cfg.option = "keepColumnName";
   cfg.ptr = &tsKeepOriginalColumnName;
   cfg.valType = TAOS_CFG_VTYPE_INT8;
@@ -1231,7 +1325,27 @@ static void doInitGlobalConfig(void) {
   cfg.unitType = TAOS_CFG_UTYPE_NONE;
   taosInitConfigOption(cfg);
 
+  cfg.option = "mnodeSnapshotRows";
+  cfg.ptr = &tsMnodeSnapshotRows;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = 0;
+  cfg.maxValue = INT32_MAX;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
   // module configs
+  cfg.option = "zeroCopySubmit";
+  cfg.ptr = &tsZeroCopySubmit;
+  cfg.valType = TAOS_CFG_VTYPE_INT8;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = 0;
+  cfg.maxValue = 1;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
   cfg.option = "flowctrl";
   cfg.ptr = &tsEnableFlowCtrl;
   cfg.valType = TAOS_CFG_VTYPE_INT8;
@@ -1685,6 +1799,36 @@ static void doInitGlobalConfig(void) {
   cfg.unitType = TAOS_CFG_UTYPE_NONE;
   taosInitConfigOption(cfg);
 
+  cfg.option = "tierMigrateInterval";
+  cfg.ptr = &tsTierMigrateInterval;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = 0;
+  cfg.maxValue = 86400;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_SECOND;
+  taosInitConfigOption(cfg);
+
+  cfg.option = "tierMigrateRate";
+  cfg.ptr = &tsTierMigrateRate;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = 1;
+  cfg.maxValue = 10240;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_MB;
+  taosInitConfigOption(cfg);
+
+  cfg.option = "tierHotReads";
+  cfg.ptr = &tsTierHotReads;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = 0;
+  cfg.maxValue = 100000000;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
   // enable kill long query
   cfg.option = "deadLockKillQuery";
   cfg.ptr = &tsDeadLockKillQuery;
@@ -1739,6 +1883,136 @@ static void doInitGlobalConfig(void) {
   cfg.unitType = TAOS_CFG_UTYPE_NONE;
   taosInitConfigOption(cfg);
 
+  // write the points of child tables with cached meta into submit blocks directly
+  cfg.option = "smlDirectInsert";
+  cfg.ptr = &tsSmlDirectInsert;
+  cfg.valType = TAOS_CFG_VTYPE_INT8;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW | TSDB_CFG_CTYPE_B_CLIENT;
+  cfg.minValue = 0;
+  cfg.maxValue = 1;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
+  // number of threads to parse the lines of a schemaless insert
+  cfg.option = "smlParseThreads";
+  cfg.ptr = &tsSmlParseThreads;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW | TSDB_CFG_CTYPE_B_CLIENT;
+  cfg.minValue = 0;
+  cfg.maxValue = 64;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
+  // number of result blocks requested ahead of the application for each query
+  cfg.option = "fetchAheadBlocks";
+  cfg.ptr = &tsFetchAheadBlocks;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW | TSDB_CFG_CTYPE_B_CLIENT;
+  cfg.minValue = 0;
+  cfg.maxValue = 16;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
+  // memory of the result blocks requested ahead of the application for all queries of the client
+  cfg.option = "fetchAheadBufferSize";
+  cfg.ptr = &tsFetchAheadBufferSize;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW | TSDB_CFG_CTYPE_B_CLIENT;
+  cfg.minValue = 1;
+  cfg.maxValue = 65536;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_MB;
+  taosInitConfigOption(cfg);
+
+  // number of threads to parse the insert statements of an ingest pipeline
+  cfg.option = "ingestParseThreads";
+  cfg.ptr = &tsIngestParseThreads;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW | TSDB_CFG_CTYPE_B_CLIENT;
+  cfg.minValue = 1;
+  cfg.maxValue = 64;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
+  // the submit message is limited by the wal size of vnode, see TSDB_MAX_WAL_SIZE
+  cfg.option = "ingestBatchSize";
+  cfg.ptr = &tsIngestBatchSize;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW | TSDB_CFG_CTYPE_B_CLIENT;
+  cfg.minValue = 1;
+  cfg.maxValue = 2048;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
+  // time to keep the submit message of a vgroup in an ingest pipeline before it is sent
+  cfg.option = "ingestFlushInterval";
+  cfg.ptr = &tsIngestFlushInterval;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW | TSDB_CFG_CTYPE_B_CLIENT;
+  cfg.minValue = 1;
+  cfg.maxValue = 60000;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_MS;
+  taosInitConfigOption(cfg);
+
+  // submit messages of a vgroup in an ingest pipeline sent without waiting for the response
+  cfg.option = "ingestMaxInflight";
+  cfg.ptr = &tsIngestMaxInflight;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW | TSDB_CFG_CTYPE_B_CLIENT;
+  cfg.minValue = 1;
+  cfg.maxValue = 64;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
+  // subscriptions are notified of the new submits by the vnodes
+  cfg.option = "subscribePush";
+  cfg.ptr = &tsSubscribePush;
+  cfg.valType = TAOS_CFG_VTYPE_INT8;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW | TSDB_CFG_CTYPE_B_CLIENT;
+  cfg.minValue = 0;
+  cfg.maxValue = 1;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
+  // sliding window streams aggregate every row only once
+  cfg.option = "incrementalStream";
+  cfg.ptr = &tsIncrementalStream;
+  cfg.valType = TAOS_CFG_VTYPE_INT8;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW | TSDB_CFG_CTYPE_B_CLIENT;
+  cfg.minValue = 0;
+  cfg.maxValue = 1;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
+  cfg.option = "streamStateBufferSize";
+  cfg.ptr = &tsStreamStateBufferSize;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW | TSDB_CFG_CTYPE_B_CLIENT;
+  cfg.minValue = 1;
+  cfg.maxValue = 65536;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_MB;
+  taosInitConfigOption(cfg);
+
+  cfg.option = "metaCacheMaxSize";
+  cfg.ptr = &tsMetaCacheMaxSize;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW | TSDB_CFG_CTYPE_B_CLIENT;
+  cfg.minValue = 0;
+  cfg.maxValue = 65536;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_MB;
+  taosInitConfigOption(cfg);
+
   // flush vnode wal file if walSize > walFlushSize and walSize > cache*0.5*blocks
   cfg.option = "walFlushSize";
   cfg.ptr = &tsdbWalFlushSize;
@@ -24,6 +24,7 @@ static void *dnodeProcessReadQueue(void *pWorker);
 // module global variable
 static SWorkerPool tsVQueryWP;
 static SWorkerPool tsVFetchWP;
+static int64_t     tsVReadWaitHist[DNODE_VREAD_QUEUE_NUM][DNODE_VREAD_WAIT_BUCKETS];
 
 int32_t dnodeInitVRead() {
   const int32_t maxFetchThreads = 4;
@@ -86,6 +87,13 @@ void *dnodeAllocVQueryQueue(void *pVnode) {
   return tWorkerAllocQueue(&tsVQueryWP, pVnode);
 }
 
+// long running queries share the query workers, but they are only picked up when no other query is waiting
+void *dnodeAllocVLQueryQueue(void *pVnode) {
+  void *pQueue = tWorkerAllocQueue(&tsVQueryWP, pVnode);
+  if (pQueue != NULL) taosSetQueuePriority(pQueue, TAOS_QPRIORITY_LOW);
+  return pQueue;
+}
+
 void *dnodeAllocVFetchQueue(void *pVnode) {
   return tWorkerAllocQueue(&tsVFetchWP, pVnode);
 }
@@ -112,6 +120,31 @@ void dnodeSendRpcVReadRsp(void *pVnode, SVReadMsg *pRead, int32_t code) {
 void dnodeDispatchNonRspMsg(void *pVnode, SVReadMsg *pRead, int32_t code) {
 }
 
+static void dnodeUpdateVReadWaitHist(SWorkerPool *pPool, SVReadMsg *pRead) {
+  int32_t queue = DNODE_VREAD_QUERY;
+  if (pPool == &tsVFetchWP) {
+    queue = DNODE_VREAD_FETCH;
+  } else if (pRead->lowPriority) {
+    queue = DNODE_VREAD_LQUERY;
+  }
+
+  int64_t waitUs = taosGetTimestampUs() - pRead->queuedUs;
+  int32_t bucket = 0;
+  for (int64_t bound = 100; bucket < DNODE_VREAD_WAIT_BUCKETS - 1 && waitUs >= bound; bound *= 10) {
+    bucket++;
+  }
+
+  atomic_add_fetch_64(&tsVReadWaitHist[queue][bucket], 1);
+}
+
+void dnodeGetVReadStatis(SDnodeVReadStatis *pStatis) {
+  for (int32_t i = 0; i < DNODE_VREAD_QUEUE_NUM; ++i) {
+    for (int32_t j = 0; j < DNODE_VREAD_WAIT_BUCKETS; ++j) {
+      pStatis->waitHist[i][j] = atomic_load_64(&tsVReadWaitHist[i][j]);
+    }
+  }
+}
+
 static void *dnodeProcessReadQueue(void *wparam) {
   SWorker *    pWorker = wparam;
   SWorkerPool *pPool = pWorker->pPool;
@@ -134,6 +167,8 @@ static void *dnodeProcessReadQueue(void *wparam) {
     dTrace("msg:%p, app:%p type:%s will be processed in vquery queue, qtype:%d", pRead, pRead->rpcAhandle,
            taosMsg[pRead->msgType], qtype);
 
+    dnodeUpdateVReadWaitHist(pPool, pRead);
+
     int32_t code = vnodeProcessRead(pVnode, pRead);
 
     if (qtype == TAOS_QTYPE_RPC && code != TSDB_CODE_QRY_NOT_READY) {
@@ -142,7 +177,9 @@ static void *dnodeProcessReadQueue(void *wparam) {
       if (code == TSDB_CODE_QRY_HAS_RSP) {
         dnodeSendRpcVReadRsp(pVnode, pRead, pRead->code);
       } else {  // code == TSDB_CODE_QRY_NOT_READY, do not return msg to client
-        assert(pRead->rpcHandle == NULL || (pRead->rpcHandle != NULL && pRead->msgType == 5));
+        // a subscribe request waiting for the submits is responded by the vnode later
+        assert(pRead->rpcHandle == NULL || (pRead->rpcHandle != NULL && pRead->msgType == 5) ||
+               pRead->msgType == TSDB_MSG_TYPE_SUBSCRIBE);
         dnodeDispatchNonRspMsg(pVnode, pRead, code);
       }
     }
@@ -30,7 +30,22 @@ typedef struct {
   int64_t httpReqNum;
 } SDnodeStatisInfo;
 
+// wait time of read messages in vnode queues, upper bounds of the buckets are 0.1ms, 1ms, 10ms, 100ms, 1s, 10s, inf
+#define DNODE_VREAD_WAIT_BUCKETS 7
+
+typedef enum {
+  DNODE_VREAD_QUERY,
+  DNODE_VREAD_LQUERY,  // long running queries
+  DNODE_VREAD_FETCH,
+  DNODE_VREAD_QUEUE_NUM
+} EDnodeVReadQueue;
+
+typedef struct {
+  int64_t waitHist[DNODE_VREAD_QUEUE_NUM][DNODE_VREAD_WAIT_BUCKETS];
+} SDnodeVReadStatis;
+
 SDnodeStatisInfo dnodeGetStatisInfo();
+void             dnodeGetVReadStatis(SDnodeVReadStatis *pStatis);
 int32_t          dnodeGetHttpStatusInfo(int32_t index);
 void             dnodeClearHttpStatusInfo();
 
@@ -57,6 +72,7 @@ void *dnodeAllocVWriteQueue(void *pVnode);
 void  dnodeFreeVWriteQueue(void *pWqueue);
 void  dnodeSendRpcVWriteRsp(void *pVnode, void *pWrite, int32_t code);
 void *dnodeAllocVQueryQueue(void *pVnode);
+void *dnodeAllocVLQueryQueue(void *pVnode);
 void *dnodeAllocVFetchQueue(void *pVnode);
 void  dnodeFreeVQueryQueue(void *pQqueue);
 void  dnodeFreeVFetchQueue(void *pFqueue);
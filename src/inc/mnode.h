@@ -43,6 +43,7 @@ typedef struct SMnodeMsg {
   struct STableObj *pTable;
   struct SSTableObj*pSTable;
   struct SMnodeMsg *pBatchMasterMsg;
+  void *            pCreateBatch;  // the sub msgs of a batch master whose tables are sent to vnodes together
   SMnodeRsp rpcRsp;
   int16_t   received;
   int16_t   successed;
@@ -83,6 +83,13 @@ bool qSolveCommitNoBlock(void* pRepo, void* pMgmt);
 
 int32_t qQueryCompleted(qinfo_t qinfo);
 
+/**
+ * the time spent in executing the query so far
+ * @param qinfo  qhandle
+ * @return       elapsed time in microseconds
+ */
+int64_t qGetQueryExecTime(qinfo_t qinfo);
+
 /**
  * destroy query info structure
  * @param qHandle
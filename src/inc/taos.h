@@ -28,6 +28,7 @@ typedef void   TAOS_STMT;
 typedef void   TAOS_RES;
 typedef void   TAOS_STREAM;
 typedef void   TAOS_SUB;
+typedef void   TAOS_INGEST;
 typedef void **TAOS_ROW;
 
 // Data type definition
@@ -63,6 +64,15 @@ typedef struct taosField {
   int16_t  bytes;
 } TAOS_FIELD;
 
+// a column of the block returned by taos_fetch_columns, it points into the retrieved block and is valid until the
+// next block is fetched
+typedef struct taosColumn {
+  uint8_t  type;
+  int16_t  bytes;   // width of each value, a binary/nchar value starts with its length in 2 bytes
+  char    *data;    // the value of row i is at data + i * bytes
+  int8_t  *isNull;  // isNull[i] is 1 if the value of row i is NULL
+} TAOS_COLUMN;
+
 typedef enum {
   SET_CONF_RET_SUCC = 0,
   SET_CONF_RET_ERR_PART = -1,
@@ -184,6 +194,7 @@ DLL_EXPORT bool taos_is_update_query(TAOS_RES *res);
 DLL_EXPORT int taos_fetch_block(TAOS_RES *res, TAOS_ROW *rows);
 DLL_EXPORT int* taos_fetch_lengths(TAOS_RES *res);
 DLL_EXPORT TAOS_ROW *taos_result_block(TAOS_RES *res);
+DLL_EXPORT int taos_fetch_columns(TAOS_RES *res, TAOS_COLUMN **columns);
 
 DLL_EXPORT int taos_validate_sql(TAOS *taos, const char *sql);
 DLL_EXPORT void taos_reset_current_db(TAOS *taos);
@@ -212,6 +223,26 @@ DLL_EXPORT void taos_close_stream(TAOS_STREAM *tstr);
 
 DLL_EXPORT int taos_load_table_info(TAOS *taos, const char* tableNameList);
 
+typedef struct TAOS_INGEST_STAT {
+  int64_t statements;        // insert statements written into the pipeline
+  int64_t failedStatements;
+  int64_t directStatements;  // statements executed one by one: tables not in the meta cache, or failed submits retried
+  int64_t rows;              // rows inserted
+  int64_t submits;           // submit messages of the merged statements
+  int64_t submitRows;
+  int64_t submitBytes;
+  int32_t maxSubmitRows;
+  int32_t code;              // the first error
+  int64_t elapsed;           // us, from the first statement written to the last one inserted
+  double  rowsPerSecond;
+} TAOS_INGEST_STAT;
+
+DLL_EXPORT TAOS_INGEST *taos_ingest_open(TAOS *taos);
+DLL_EXPORT int  taos_ingest_write(TAOS_INGEST *ingest, const char *sql);
+DLL_EXPORT int  taos_ingest_flush(TAOS_INGEST *ingest);
+DLL_EXPORT void taos_ingest_stat(TAOS_INGEST *ingest, TAOS_INGEST_STAT *stat);
+DLL_EXPORT int  taos_ingest_close(TAOS_INGEST *ingest);
+
 DLL_EXPORT TAOS_RES *taos_schemaless_insert(TAOS* taos, char* lines[], int numLines, int protocol, int precision);
 
 DLL_EXPORT int32_t taos_parse_time(char* timestr, int64_t* time, int32_t len, int32_t timePrec, int8_t dayligth);
@@ -267,6 +267,8 @@ do { \
 #define TSDB_CQ_SQL_SIZE          1024
 #define TSDB_MIN_VNODES           64
 #define TSDB_MAX_VNODES           2048
+#define TSDB_MAX_FSET_LOADS       1024  // file sets reported by a dnode
+#define TSDB_MAX_VNODE_FSET_LOADS 16    // file sets reported by a vnode
 #define TSDB_MIN_VNODES_PER_DB    2
 #define TSDB_MAX_VNODES_PER_DB    64
 
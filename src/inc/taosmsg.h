@@ -45,7 +45,7 @@ TAOS_DEFINE_MESSAGE_TYPE( TSDB_MSG_TYPE_SUBMIT, "submit" )
 TAOS_DEFINE_MESSAGE_TYPE( TSDB_MSG_TYPE_QUERY, "query" )
 TAOS_DEFINE_MESSAGE_TYPE( TSDB_MSG_TYPE_FETCH, "fetch" )
 TAOS_DEFINE_MESSAGE_TYPE( TSDB_MSG_TYPE_UPDATE_TAG_VAL, "update-tag-val" )
-TAOS_DEFINE_MESSAGE_TYPE( TSDB_MSG_TYPE_DUMMY1, "dummy1" )
+TAOS_DEFINE_MESSAGE_TYPE( TSDB_MSG_TYPE_SUBSCRIBE, "subscribe" )
 TAOS_DEFINE_MESSAGE_TYPE( TSDB_MSG_TYPE_DUMMY2, "dummy2" )
 TAOS_DEFINE_MESSAGE_TYPE( TSDB_MSG_TYPE_DUMMY3, "dummy3" )
 
@@ -62,7 +62,7 @@ TAOS_DEFINE_MESSAGE_TYPE( TSDB_MSG_TYPE_MD_ALTER_VNODE, "alter-vnode" )
 TAOS_DEFINE_MESSAGE_TYPE( TSDB_MSG_TYPE_MD_SYNC_VNODE, "sync-vnode" )
 TAOS_DEFINE_MESSAGE_TYPE( TSDB_MSG_TYPE_MD_CREATE_MNODE, "create-mnode" )
 TAOS_DEFINE_MESSAGE_TYPE( TSDB_MSG_TYPE_MD_COMPACT_VNODE, "compact-vnode" )
-TAOS_DEFINE_MESSAGE_TYPE( TSDB_MSG_TYPE_DUMMY6, "dummy6" )
+TAOS_DEFINE_MESSAGE_TYPE( TSDB_MSG_TYPE_MD_CREATE_TABLES, "create-tables" )
 TAOS_DEFINE_MESSAGE_TYPE( TSDB_MSG_TYPE_DUMMY7, "dummy7" )
 
 
@@ -156,6 +156,8 @@ enum _mgmt_table {
   TSDB_MGMT_TABLE_CLUSTER,
   TSDB_MGMT_TABLE_TP,
   TSDB_MGMT_TABLE_FUNCTION,
+  TSDB_MGMT_TABLE_BALANCE_PLAN,
+  TSDB_MGMT_TABLE_FILESET,
   TSDB_MGMT_TABLE_MAX,
 };
 
@@ -253,6 +255,12 @@ typedef struct {
   SShellSubmitRspBlock failedBlocks[];
 } SShellSubmitRspMsg;
 
+// body of a TSDB_CODE_VND_IS_FLOWCTRL response to a submit msg
+typedef struct {
+  int32_t code;
+  int32_t retryAfter;  // ms, when the vnode expects to accept the msg again
+} SShellFlowCtrlRspMsg;
+
 typedef struct SSchema {
   uint8_t type;
   char    name[TSDB_COL_NAME_LEN];
@@ -279,6 +287,19 @@ typedef struct {
   char     data[];
 } SMDCreateTableMsg;
 
+// the tables of one vgroup created together, it is written into the wal of the vnode as one record
+typedef struct {
+  int32_t contLen;
+  int32_t vgId;
+  int32_t numOfTables;
+  char    data[];  // SMDCreateTableMsg of the tables one by one
+} SMDCreateTablesMsg;
+
+typedef struct {
+  int32_t numOfTables;
+  int32_t codes[];  // the result of each table
+} SMDCreateTablesRsp;
+
 typedef struct {
   int8_t  extend;
   int32_t len;  // one create table message
@@ -552,6 +573,22 @@ typedef struct SRetrieveTableRsp {
   char    data[];
 } SRetrieveTableRsp;
 
+// the request waits in the vnode until the submits of any of the tables after the version are processed, or the
+// wait time elapses
+typedef struct {
+  SMsgHead header;
+  int64_t  version;     // version of the vnode the consumer has caught up with
+  int32_t  waitTime;    // ms
+  int32_t  numOfTables;
+  int64_t  uids[];
+} SSubscribeMsg;
+
+typedef struct {
+  int64_t  version;     // version of the vnode the changes are reported up to
+  int32_t  numOfTables;
+  int64_t  uids[];      // the tables written after the version of the request
+} SSubscribeRsp;
+
 typedef struct {
   int32_t  vgId;
   int32_t  dbCfgVersion;
@@ -564,8 +601,24 @@ typedef struct {
   uint8_t  role;
   uint8_t  replica;
   uint8_t  compact;
+  int64_t  writeBytesRate;  // rolling bytes written per second
+  int64_t  writeRowsRate;   // rolling rows written per second
+  int64_t  queryTimeRate;   // rolling query time in us per second
 } SVnodeLoad;
 
+// the file sets read by queries, the hottest ones of each vnode
+typedef struct {
+  int32_t vgId;
+  int32_t fid;
+  int64_t reads;
+  int64_t blocksRead;
+  int64_t bytesRead;
+  int64_t lastRead;  // ms
+  float   heat;      // reads decayed by half every hour
+  int8_t  level;
+  int8_t  reserved[3];
+} SFSetLoad;
+
 typedef struct {
   int8_t   extend;
   char     db[TSDB_ACCT_ID_LEN + TSDB_DB_NAME_LEN];
@@ -710,7 +763,7 @@ typedef struct {
   char        dnodeEp[TSDB_EP_LEN];
   uint32_t    moduleStatus;
   uint32_t    lastReboot;        // time stamp for last reboot
-  uint16_t    reserve1;          // from config file
+  uint16_t    numOfFSets;        // SFSetLoad follow the vnode loads
   uint16_t    openVnodes;
   uint16_t    numOfCores;
   float       diskAvailable;  // GB
@@ -773,6 +826,9 @@ typedef struct {
   char    tags[];
 } STableInfoMsg;
 
+// the tables not existing are skipped instead of failing the whole request, set in SMultiTableInfoMsg.extend
+#define TSDB_MULTI_META_SKIP_MISSING 0x1
+
 typedef struct {
   int8_t  extend;
   uint8_t metaClone;     // create local clone of the cached table meta
@@ -78,6 +78,18 @@ typedef struct SRpcInit {
   int  (*afp)(char *tableId, char *spi, char *encrypt, char *secret, char *ckey);
 } SRpcInit;
 
+typedef struct SRpcCompStat {
+  int64_t compMsgs;       // messages sent compressed
+  int64_t compSkipped;    // messages not compressed since the ratio is not good enough
+  int64_t compBytesIn;    // original size of compressed messages
+  int64_t compBytesOut;   // compressed size including the compression head
+  int64_t compTimeUs;     // time spent on compression, including the skipped messages
+  int64_t decompMsgs;
+  int64_t decompBytesIn;
+  int64_t decompBytesOut;
+  int64_t decompTimeUs;
+} SRpcCompStat;
+
 int32_t rpcInit();
 void  rpcCleanup();
 void *rpcOpen(const SRpcInit *pRpc);
@@ -93,6 +105,7 @@ void  rpcSendRecv(void *shandle, SRpcEpSet *pEpSet, SRpcMsg *pReq, SRpcMsg *pRsp
 int   rpcReportProgress(void *pConn, char *pCont, int contLen);
 void  rpcCancelRequest(int64_t rid);
 int32_t rpcUnusedSession(void * rpcInfo, bool bLock);
+void  rpcGetCompStat(SRpcCompStat *pStat);
 
 #ifdef __cplusplus
 }
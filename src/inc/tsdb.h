@@ -161,6 +161,29 @@ typedef struct {
  */
 int32_t tsdbInsertData(STsdbRepo *repo, SSubmitMsg *pMsg, SShellSubmitRspMsg *pRsp);
 
+// a received message whose rows are referenced by the memtable instead of being copied
+typedef struct STsdbRetainMsg {
+  int32_t refCount;
+  int32_t size;                 // bytes kept alive, taken into account to trigger commit
+  void *  pMsg;
+  void (*freeFp)(void *pMsg);
+} STsdbRetainMsg;
+
+/**
+ * Insert data without copying the rows into the buffer pool, the rows stay in pRetain->pMsg which is referenced by
+ * the memtable and released after the memtable is committed
+ */
+int32_t tsdbInsertDataRetained(STsdbRepo *repo, SSubmitMsg *pMsg, SShellSubmitRspMsg *pRsp, STsdbRetainMsg *pRetain);
+void    tsdbReleaseRetainMsg(STsdbRetainMsg *pRetain);
+
+// write credit of a repository, used by the vnode to admit writes before they get blocked in the buffer pool
+typedef struct {
+  int64_t availBytes;      // bytes which can be inserted without waiting for a commit to release buffer blocks
+  int32_t commitRemainMs;  // estimated time until the running commit releases its buffer blocks, 0 if no commit
+} STsdbWriteCredit;
+
+void tsdbGetWriteCredit(STsdbRepo *repo, STsdbWriteCredit *pCredit);
+
 // -- FOR QUERY TIME SERIES DATA
 
 typedef void *TsdbQueryHandleT;  // Use void to hide implementation details
@@ -191,7 +214,11 @@ typedef struct {
   STableData **tData;
   SList *      actList;
   SList *      extraBuffList;
+  int32_t      extraOffset;  // allocation position in the last chunk of extraBuffList
+  int32_t      extraRemain;
   SList *      bufBlockList;
+  SList *      retainList;  // STsdbRetainMsg referenced by rows in this memtable
+  int64_t      retainSize;
   int64_t      pointsAdd;   // TODO
   int64_t      storageAdd;  // TODO
 } SMemTable;
@@ -420,6 +447,34 @@ int tsdbSyncRecv(void *pRepo, SOCKET socketFd);
 // For TSDB Compact
 int tsdbCompact(STsdbRepo *pRepo);
 
+/**
+ * move one file set to the tier by its age and reads, the copy is rate limited by tierMigrateRate
+ * @param pRepo the tsdb repo
+ * @param pStop the copy is given up once it is set
+ * @return 1 if a file set is moved, 0 if no file set to move, -1 for failure
+ */
+int tsdbMigrate(STsdbRepo *pRepo, const int8_t *pStop);
+
+// For TSDB file set reads
+typedef struct {
+  int32_t fid;
+  int8_t  level;       // tier of the files
+  int64_t reads;       // times opened by queries
+  int64_t blocksRead;  // data blocks loaded by queries
+  int64_t bytesRead;   // bytes read by queries
+  int64_t lastRead;    // ms
+  double  heat;        // reads decayed by half every hour
+} STsdbFSetStat;
+
+/**
+ * get the reads of the file sets which are read by queries, the hottest first
+ * @param pRepo the tsdb repo
+ * @param pStats the reads of the file sets got
+ * @param maxNum the maximum number of the file sets to get
+ * @return the number of the file sets got, -1 for failure
+ */
+int tsdbGetFSetStats(STsdbRepo *pRepo, STsdbFSetStat *pStats, int maxNum);
+
 // For TSDB Health Monitor
 
 // no problem return true
@@ -63,6 +63,10 @@ void     walRemoveAllOldFiles(twalh);
 int32_t  walWrite(twalh, SWalHead *);
 void     walFsync(twalh, bool forceFsync);
 int32_t  walRestore(twalh, void *pVnode, FWalWrite writeFp);
+int32_t  walRestoreFrom(twalh, int64_t fileId, void *pVnode, FWalWrite writeFp);
+int32_t  walRotate(twalh, int64_t *fileId);
+void     walRemoveFilesBefore(twalh, int64_t fileId);
+int32_t  walReadFiles(twalh, int64_t fromFileId, int64_t toFileId, void *param, FWalWrite readFp);
 int32_t  walGetWalFile(twalh, char *fileName, int64_t *fileId);
 uint64_t walGetVersion(twalh);
 void     walResetVersion(twalh, uint64_t newVer);
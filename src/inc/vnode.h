@@ -26,6 +26,7 @@ typedef struct {
   int64_t submitReqSucNum;
   int64_t submitRowNum;
   int64_t submitRowSucNum;
+  int64_t submitLatencyP99;  // us, from receiving a submit msg to its response, since last call
 } SVnodeStatisInfo;
 
 typedef struct {
@@ -43,6 +44,8 @@ typedef struct {
   void *  pVnode;
   int8_t  qtype;
   int8_t  msgType;
+  int8_t  lowPriority;  // written into the queue for long running queries
+  int64_t queuedUs;     // when it is written into the queue
   SRspRet rspRet;
   char    pCont[];
 } SVReadMsg;
@@ -50,10 +53,14 @@ typedef struct {
 typedef struct {
   int32_t  code;
   int32_t  processedCount;
+  int32_t  flowCtrlMs;  // time the msg has been held by flow control
   int32_t  qtype;
+  int64_t  arrivalUs;
   void *   pVnode;
   SRpcMsg  rpcMsg;
   SRspRet  rspRet;
+  SWalHead *pHead;   // points to walHead, or into the received rpc message if it is retained
+  void *    pRetain; // STsdbRetainMsg keeping the rpc message alive, NULL if the message is copied
   char     reserveForSync[24];
   SWalHead walHead;
 } SVWriteMsg;
@@ -153,6 +153,9 @@ typedef struct SVgObj {
   int64_t        totalStorage;
   int64_t        compStorage;
   int64_t        pointsWritten;
+  int64_t        writeBytesRate;                    // reported by the master vnode
+  int64_t        writeRowsRate;
+  int64_t        queryTimeRate[TSDB_MAX_REPLICA];  // reported by each vnode, in the order of vnodeGid
   struct SDbObj *pDb;
   void *         idPool;
 } SVgObj;
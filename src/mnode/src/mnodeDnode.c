@@ -19,6 +19,7 @@
 #include "tglobal.h"
 #include "tconfig.h"
 #include "tutil.h"
+#include "hash.h"
 #include "tsocket.h"
 #include "tbn.h"
 #include "tsync.h"
@@ -49,6 +50,25 @@ static SDnodeEps*tsDnodeEps;
 static int32_t   tsDnodeEpsSize;
 static pthread_mutex_t tsDnodeEpsMutex;
 
+// the file sets read by queries, replaced by each status msg of the dnode
+typedef struct {
+  int32_t   numOfFSets;
+  SFSetLoad fsets[];
+} SDnodeFSetLoads;
+
+typedef struct {
+  int32_t   dnodeId;
+  SFSetLoad load;
+} SFSetRow;
+
+typedef struct {
+  int32_t  numOfRows;
+  SFSetRow rows[];
+} SFSetRows;
+
+static SHashObj *      tsDnodeFSetLoads;  // dnodeId -> SDnodeFSetLoads
+static pthread_mutex_t tsDnodeFSetMutex;
+
 static int32_t mnodeCreateDnode(char *ep, SMnodeMsg *pMsg);
 static int32_t mnodeProcessCreateDnodeMsg(SMnodeMsg *pMsg);
 static int32_t mnodeProcessDropDnodeMsg(SMnodeMsg *pMsg);
@@ -63,7 +83,11 @@ static int32_t mnodeGetVnodeMeta(STableMetaMsg *pMeta, SShowObj *pShow, void *pC
 static int32_t mnodeRetrieveVnodes(SShowObj *pShow, char *data, int32_t rows, void *pConn);
 static int32_t mnodeGetDnodeMeta(STableMetaMsg *pMeta, SShowObj *pShow, void *pConn);
 static int32_t mnodeRetrieveDnodes(SShowObj *pShow, char *data, int32_t rows, void *pConn);
+static int32_t mnodeGetFSetMeta(STableMetaMsg *pMeta, SShowObj *pShow, void *pConn);
+static int32_t mnodeRetrieveFSets(SShowObj *pShow, char *data, int32_t rows, void *pConn);
+static void    mnodeFreeFSets(void *pIter);
 static void    mnodeUpdateDnodeEps();
+static void    mnodeUpdateDnodeFSetLoads(int32_t dnodeId, SFSetLoad *pLoads, int32_t numOfFSets);
 
 static char* offlineReason[] = {
   "",
@@ -118,6 +142,7 @@ static int32_t mnodeDnodeActionDelete(SSdbRow *pRow) {
   mnodeDropMnodeLocal(pDnode->dnodeId);
   bnNotify();
   mnodeUpdateDnodeEps();
+  mnodeUpdateDnodeFSetLoads(pDnode->dnodeId, NULL, 0);
 
   mDebug("dnode:%d, all vgroups is dropped from sdb", pDnode->dnodeId);
   return TSDB_CODE_SUCCESS;
@@ -172,6 +197,14 @@ int32_t mnodeInitDnodes() {
   SDnodeObj tObj;
   tsDnodeUpdateSize = (int32_t)((int8_t *)tObj.updateEnd - (int8_t *)&tObj);
   pthread_mutex_init(&tsDnodeEpsMutex, NULL);
+  pthread_mutex_init(&tsDnodeFSetMutex, NULL);
+
+  tsDnodeFSetLoads = taosHashInit(TSDB_DEFAULT_DNODES_HASH_SIZE, taosGetDefaultHashFunction(TSDB_DATA_TYPE_INT), true,
+                                  HASH_NO_LOCK);
+  if (tsDnodeFSetLoads == NULL) {
+    mError("failed to init dnode file sets");
+    return -1;
+  }
 
   SSdbTableDesc desc = {
     .id           = SDB_TABLE_DNODE,
@@ -216,6 +249,10 @@ int32_t mnodeInitDnodes() {
   mnodeAddShowMetaHandle(TSDB_MGMT_TABLE_DNODE, mnodeGetDnodeMeta);
   mnodeAddShowRetrieveHandle(TSDB_MGMT_TABLE_DNODE, mnodeRetrieveDnodes);
   mnodeAddShowFreeIterHandle(TSDB_MGMT_TABLE_DNODE, mnodeCancelGetNextDnode);
+
+  mnodeAddShowMetaHandle(TSDB_MGMT_TABLE_FILESET, mnodeGetFSetMeta);
+  mnodeAddShowRetrieveHandle(TSDB_MGMT_TABLE_FILESET, mnodeRetrieveFSets);
+  mnodeAddShowFreeIterHandle(TSDB_MGMT_TABLE_FILESET, mnodeFreeFSets);
  
   mDebug("table:dnodes table is created");
   return 0;
@@ -224,6 +261,9 @@ int32_t mnodeInitDnodes() {
 void mnodeCleanupDnodes() {
   sdbCloseTable(tsDnodeRid);
   pthread_mutex_destroy(&tsDnodeEpsMutex);
+  taosHashCleanup(tsDnodeFSetLoads);
+  tsDnodeFSetLoads = NULL;
+  pthread_mutex_destroy(&tsDnodeFSetMutex);
   free(tsDnodeEps);
   tsDnodeEps = NULL;
   tsDnodeSdb = NULL;
@@ -664,6 +704,12 @@ static int32_t mnodeProcessDnodeStatusMsg(SMnodeMsg *pMsg) {
     mnodeCheckUnCreatedVgroup(pDnode, pStatus->load, openVnodes);
   }
 
+  int32_t numOfFSets = htons(pStatus->numOfFSets);
+  if (pMsg->rpcMsg.contLen >=
+      sizeof(SStatusMsg) + openVnodes * sizeof(SVnodeLoad) + numOfFSets * sizeof(SFSetLoad)) {
+    mnodeUpdateDnodeFSetLoads(pDnode->dnodeId, (SFSetLoad *)(pStatus->load + openVnodes), numOfFSets);
+  }
+
   pDnode->lastAccess = tsAccessSquence;
 
   //this func should be called after sdb replica changed
@@ -1292,6 +1338,223 @@ static int32_t mnodeRetrieveVnodes(SShowObj *pShow, char *data, int32_t rows, vo
   return numOfRows;
 }
 
+static void mnodeUpdateDnodeFSetLoads(int32_t dnodeId, SFSetLoad *pLoads, int32_t numOfFSets) {
+  pthread_mutex_lock(&tsDnodeFSetMutex);
+
+  if (numOfFSets <= 0) {
+    taosHashRemove(tsDnodeFSetLoads, &dnodeId, sizeof(dnodeId));
+    pthread_mutex_unlock(&tsDnodeFSetMutex);
+    return;
+  }
+
+  int32_t          size = sizeof(SDnodeFSetLoads) + numOfFSets * sizeof(SFSetLoad);
+  SDnodeFSetLoads *pFSets = malloc(size);
+  if (pFSets != NULL) {
+    pFSets->numOfFSets = numOfFSets;
+    for (int32_t i = 0; i < numOfFSets; ++i) {
+      SFSetLoad *pLoad = &pFSets->fsets[i];
+      *pLoad = pLoads[i];
+      pLoad->vgId = htonl(pLoad->vgId);
+      pLoad->fid = htonl(pLoad->fid);
+      pLoad->reads = htobe64(pLoad->reads);
+      pLoad->blocksRead = htobe64(pLoad->blocksRead);
+      pLoad->bytesRead = htobe64(pLoad->bytesRead);
+      pLoad->lastRead = htobe64(pLoad->lastRead);
+    }
+
+    taosHashPut(tsDnodeFSetLoads, &dnodeId, sizeof(dnodeId), pFSets, size);
+    free(pFSets);
+  }
+
+  pthread_mutex_unlock(&tsDnodeFSetMutex);
+}
+
+// the file sets of the vgroups of the db in use, or of all vgroups if no db is in use
+static SFSetRows *mnodeGetFSetRows(SDbObj *pDb) {
+  int32_t maxRows = 0;
+
+  pthread_mutex_lock(&tsDnodeFSetMutex);
+
+  SDnodeFSetLoads *pFSets = taosHashIterate(tsDnodeFSetLoads, NULL);
+  while (pFSets != NULL) {
+    maxRows += pFSets->numOfFSets;
+    pFSets = taosHashIterate(tsDnodeFSetLoads, pFSets);
+  }
+
+  SFSetRows *pRows = calloc(1, sizeof(SFSetRows) + maxRows * sizeof(SFSetRow));
+  if (pRows == NULL) {
+    pthread_mutex_unlock(&tsDnodeFSetMutex);
+    return NULL;
+  }
+
+  pFSets = taosHashIterate(tsDnodeFSetLoads, NULL);
+  while (pFSets != NULL) {
+    int32_t *pDnodeId = taosHashGetDataKey(tsDnodeFSetLoads, pFSets);
+    for (int32_t i = 0; i < pFSets->numOfFSets; ++i) {
+      SFSetLoad *pLoad = &pFSets->fsets[i];
+      if (pDb != NULL) {
+        SVgObj *pVgroup = mnodeGetVgroup(pLoad->vgId);
+        if (pVgroup == NULL) continue;
+        bool inDb = (pVgroup->pDb == pDb);
+        mnodeDecVgroupRef(pVgroup);
+        if (!inDb) continue;
+      }
+
+      SFSetRow *pRow = &pRows->rows[pRows->numOfRows++];
+      pRow->dnodeId = *pDnodeId;
+      pRow->load = *pLoad;
+    }
+    pFSets = taosHashIterate(tsDnodeFSetLoads, pFSets);
+  }
+
+  pthread_mutex_unlock(&tsDnodeFSetMutex);
+  return pRows;
+}
+
+static void mnodeFreeFSets(void *pIter) {
+  free(pIter);
+}
+
+static int32_t mnodeGetFSetMeta(STableMetaMsg *pMeta, SShowObj *pShow, void *pConn) {
+  int32_t cols = 0;
+  SUserObj *pUser = mnodeGetUserFromConn(pConn);
+  if (pUser == NULL) return 0;
+
+  if (strcmp(pUser->pAcct->user, TSDB_DEFAULT_USER) != 0 ) {
+    mnodeDecUserRef(pUser);
+    return TSDB_CODE_MND_NO_RIGHTS;
+  }
+
+  SSchema *pSchema = pMeta->schema;
+
+  pShow->bytes[cols] = 4;
+  pSchema[cols].type = TSDB_DATA_TYPE_INT;
+  strcpy(pSchema[cols].name, "vgId");
+  pSchema[cols].bytes = htons(pShow->bytes[cols]);
+  cols++;
+
+  pShow->bytes[cols] = 2;
+  pSchema[cols].type = TSDB_DATA_TYPE_SMALLINT;
+  strcpy(pSchema[cols].name, "dnode");
+  pSchema[cols].bytes = htons(pShow->bytes[cols]);
+  cols++;
+
+  pShow->bytes[cols] = 4;
+  pSchema[cols].type = TSDB_DATA_TYPE_INT;
+  strcpy(pSchema[cols].name, "fid");
+  pSchema[cols].bytes = htons(pShow->bytes[cols]);
+  cols++;
+
+  pShow->bytes[cols] = 1;
+  pSchema[cols].type = TSDB_DATA_TYPE_TINYINT;
+  strcpy(pSchema[cols].name, "level");
+  pSchema[cols].bytes = htons(pShow->bytes[cols]);
+  cols++;
+
+  pShow->bytes[cols] = 8;
+  pSchema[cols].type = TSDB_DATA_TYPE_BIGINT;
+  strcpy(pSchema[cols].name, "reads");
+  pSchema[cols].bytes = htons(pShow->bytes[cols]);
+  cols++;
+
+  pShow->bytes[cols] = 8;
+  pSchema[cols].type = TSDB_DATA_TYPE_BIGINT;
+  strcpy(pSchema[cols].name, "blocks_read");
+  pSchema[cols].bytes = htons(pShow->bytes[cols]);
+  cols++;
+
+  pShow->bytes[cols] = 8;
+  pSchema[cols].type = TSDB_DATA_TYPE_BIGINT;
+  strcpy(pSchema[cols].name, "bytes_read");
+  pSchema[cols].bytes = htons(pShow->bytes[cols]);
+  cols++;
+
+  pShow->bytes[cols] = 8;
+  pSchema[cols].type = TSDB_DATA_TYPE_TIMESTAMP;
+  strcpy(pSchema[cols].name, "last_read");
+  pSchema[cols].bytes = htons(pShow->bytes[cols]);
+  cols++;
+
+  pShow->bytes[cols] = 4;
+  pSchema[cols].type = TSDB_DATA_TYPE_FLOAT;
+  strcpy(pSchema[cols].name, "heat");
+  pSchema[cols].bytes = htons(pShow->bytes[cols]);
+  cols++;
+
+  pMeta->numOfColumns = htons(cols);
+  pShow->numOfColumns = cols;
+
+  pShow->offset[0] = 0;
+  for (int32_t i = 1; i < cols; ++i) pShow->offset[i] = pShow->offset[i - 1] + pShow->bytes[i - 1];
+
+  SDbObj *   pDb = mnodeGetDb(pShow->db);
+  SFSetRows *pRows = mnodeGetFSetRows(pDb);
+  mnodeDecDbRef(pDb);
+
+  pShow->numOfRows = (pRows != NULL) ? pRows->numOfRows : 0;
+  pShow->rowSize = pShow->offset[cols - 1] + pShow->bytes[cols - 1];
+  pShow->pIter = pRows;
+  mnodeDecUserRef(pUser);
+
+  return 0;
+}
+
+static int32_t mnodeRetrieveFSets(SShowObj *pShow, char *data, int32_t rows, void *pConn) {
+  SFSetRows *pRows = pShow->pIter;
+  int32_t    numOfRows = 0;
+  char *     pWrite;
+  int32_t    cols = 0;
+
+  while (pRows != NULL && numOfRows < rows && pShow->numOfReads + numOfRows < pRows->numOfRows) {
+    SFSetRow * pRow = &pRows->rows[pShow->numOfReads + numOfRows];
+    SFSetLoad *pLoad = &pRow->load;
+
+    cols = 0;
+
+    pWrite = data + pShow->offset[cols] * rows + pShow->bytes[cols] * numOfRows;
+    *(int32_t *)pWrite = pLoad->vgId;
+    cols++;
+
+    pWrite = data + pShow->offset[cols] * rows + pShow->bytes[cols] * numOfRows;
+    *(int16_t *)pWrite = (int16_t)pRow->dnodeId;
+    cols++;
+
+    pWrite = data + pShow->offset[cols] * rows + pShow->bytes[cols] * numOfRows;
+    *(int32_t *)pWrite = pLoad->fid;
+    cols++;
+
+    pWrite = data + pShow->offset[cols] * rows + pShow->bytes[cols] * numOfRows;
+    *(int8_t *)pWrite = pLoad->level;
+    cols++;
+
+    pWrite = data + pShow->offset[cols] * rows + pShow->bytes[cols] * numOfRows;
+    *(int64_t *)pWrite = pLoad->reads;
+    cols++;
+
+    pWrite = data + pShow->offset[cols] * rows + pShow->bytes[cols] * numOfRows;
+    *(int64_t *)pWrite = pLoad->blocksRead;
+    cols++;
+
+    pWrite = data + pShow->offset[cols] * rows + pShow->bytes[cols] * numOfRows;
+    *(int64_t *)pWrite = pLoad->bytesRead;
+    cols++;
+
+    pWrite = data + pShow->offset[cols] * rows + pShow->bytes[cols] * numOfRows;
+    *(int64_t *)pWrite = pLoad->lastRead;
+    cols++;
+
+    pWrite = data + pShow->offset[cols] * rows + pShow->bytes[cols] * numOfRows;
+    *(float *)pWrite = pLoad->heat;
+    cols++;
+
+    numOfRows++;
+  }
+
+  mnodeVacuumResult(data, pShow->numOfColumns, numOfRows, rows, pShow);
+  pShow->numOfReads += numOfRows;
+  return numOfRows;
+}
+
 char* dnodeStatus[] = {
   "offline",
   "dropping",
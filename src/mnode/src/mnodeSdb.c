@@ -17,6 +17,9 @@
 #include "os.h"
 #include "taoserror.h"
 #include "hash.h"
+#include "talgo.h"
+#include "tchecksum.h"
+#include "tobjhash.h"
 #include "tutil.h"
 #include "tref.h"
 #include "tbn.h"
@@ -37,6 +40,7 @@
 
 #define SDB_TABLE_LEN 12
 #define MAX_QUEUED_MSG_NUM 100000
+#define SDB_SNAPSHOT_MAGIC 0x534E4150
 
 typedef enum {
   SDB_ACTION_INSERT = 0,
@@ -87,9 +91,49 @@ typedef struct {
   int32_t    queuedMsg;
   int32_t    numOfTables;
   SSdbTable *tableList[SDB_TABLE_MAX];
+  uint64_t   snapshotVersion;  // the last wal record in the snapshot
+  int64_t    snapshotFileId;   // the first wal file written after the snapshot
+  int8_t     walTruncated;     // the wal files before the snapshot are removed
+  int8_t     snapshotRunning;
+  uint64_t   nextSnapshotVersion;
+  SArray *   tombstones;       // SWalHead * of the rows deleted only in memory along with others
   pthread_mutex_t mutex;
 } SSdbMgmt;
 
+/*
+ * The snapshot keeps the last record of each row in the wal files before snapshotFileId, as an insert record. It is
+ * written in the background by merging the records of the wal files since the last snapshot into it, so it is
+ * consistent at the version where the wal was rotated. The rows of a table are sorted by key in its file.
+ */
+typedef struct {
+  uint32_t magic;
+  int8_t   truncated;
+  int8_t   reserved[3];
+  uint64_t version;
+  int64_t  fileId;
+  int64_t  numOfRows[SDB_TABLE_MAX];
+  int32_t  numOfTables;
+  uint32_t cksum;
+} SSdbSnapshotHead;
+
+typedef struct {
+  uint64_t  prevVersion;
+  uint64_t  version;
+  int64_t   prevFileId;
+  int64_t   fileId;
+  SArray *  tombstones;
+  SHashObj *delta[SDB_TABLE_MAX];  // key -> SWalHead *, the last record of the rows written since the last snapshot
+} SSdbSnapshotTask;
+
+typedef struct {
+  SSdbTable *pTable;
+  int64_t    numOfRows;
+  SArray *   pObjs;
+  int32_t    code;
+  pthread_t  thread;
+  char       name[TSDB_FILENAME_LEN * 2];
+} SSdbSnapshotLoader;
+
 typedef struct {
   pthread_t thread;
   int32_t   workerId;
@@ -174,6 +218,560 @@ static void *sdbGetTableFromId(int32_t tableId) {
   return tsSdbMgmt.tableList[tableId];
 }
 
+static int32_t sdbGetKeySize(SSdbTable *pTable, void *key) {
+  if (pTable->keyType == SDB_KEY_STRING || pTable->keyType == SDB_KEY_VAR_STRING) {
+    return (int32_t)strlen((char *)key);
+  }
+
+  return sizeof(int32_t);
+}
+
+// the rows are indexed by the keys inside them, so the index keeps no copy of the keys
+static const void *sdbGetIndexKey(void *param, const void *pObj, uint32_t *keyLen) {
+  SSdbTable *pTable = param;
+  void *     key = sdbGetObjKey(pTable, (void *)pObj);
+  *keyLen = sdbGetKeySize(pTable, key);
+  return key;
+}
+
+static int32_t sdbCompareKey(SSdbTable *pTable, void *key1, void *key2) {
+  if (pTable->keyType == SDB_KEY_STRING || pTable->keyType == SDB_KEY_VAR_STRING) {
+    int32_t ret = strcmp((char *)key1, (char *)key2);
+    return (ret < 0) ? -1 : (ret > 0);
+  }
+
+  int32_t v1 = *(int32_t *)key1;
+  int32_t v2 = *(int32_t *)key2;
+  return (v1 < v2) ? -1 : (v1 > v2);
+}
+
+static int32_t sdbCompareRecord(const void *p1, const void *p2, const void *param) {
+  SWalHead *pHead1 = *(SWalHead **)p1;
+  SWalHead *pHead2 = *(SWalHead **)p2;
+  return sdbCompareKey((SSdbTable *)param, pHead1->cont, pHead2->cont);
+}
+
+static void sdbGetSnapshotDir(char *dir, const char *suffix) {
+  snprintf(dir, TSDB_FILENAME_LEN, "%s/snapshot%s", tsMnodeDir, suffix);
+}
+
+static int32_t sdbWriteSnapshotRecord(FILE *fp, SWalHead *pHead) {
+  int32_t size = sizeof(SWalHead) + pHead->len;
+
+  pHead->sver = 2;
+  pHead->cksum = 0;
+  pHead->cksum = taosCalcChecksum(0, (uint8_t *)pHead, size);
+
+  if (fwrite(pHead, 1, size, fp) != size) return TAOS_SYSTEM_ERROR(errno);
+  return TSDB_CODE_SUCCESS;
+}
+
+// return 1 if a record is read, 0 at the end of the file
+static int32_t sdbReadSnapshotRecord(FILE *fp, SWalHead *pHead, int32_t maxRowSize) {
+  size_t ret = fread(pHead, 1, sizeof(SWalHead), fp);
+  if (ret == 0 && feof(fp)) return 0;
+
+  if (ret != sizeof(SWalHead) || pHead->len < 0 || pHead->len > maxRowSize ||
+      fread(pHead->cont, 1, pHead->len, fp) != pHead->len) {
+    return TSDB_CODE_MND_SDB_INVAID_META_ROW;
+  }
+
+  uint32_t cksum = pHead->cksum;
+  pHead->cksum = 0;
+  if (!taosCheckChecksum((uint8_t *)pHead, sizeof(SWalHead) + pHead->len, cksum)) {
+    return TSDB_CODE_MND_SDB_INVAID_META_ROW;
+  }
+
+  return 1;
+}
+
+static int32_t sdbSyncFile(FILE *fp) {
+  if (fflush(fp) != 0 || fsync(fileno(fp)) != 0) return TAOS_SYSTEM_ERROR(errno);
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t sdbWriteSnapshotHead(char *dir, SSdbSnapshotHead *pHead) {
+  char name[TSDB_FILENAME_LEN * 2];
+  snprintf(name, sizeof(name), "%s/head", dir);
+
+  FILE *fp = fopen(name, "wb");
+  if (fp == NULL) return TAOS_SYSTEM_ERROR(errno);
+
+  pHead->magic = SDB_SNAPSHOT_MAGIC;
+  taosCalcChecksumAppend(0, (uint8_t *)pHead, sizeof(SSdbSnapshotHead));
+
+  int32_t code = TSDB_CODE_SUCCESS;
+  if (fwrite(pHead, 1, sizeof(SSdbSnapshotHead), fp) != sizeof(SSdbSnapshotHead)) {
+    code = TAOS_SYSTEM_ERROR(errno);
+  } else {
+    code = sdbSyncFile(fp);
+  }
+
+  fclose(fp);
+  return code;
+}
+
+// return 1 if there is no snapshot
+static int32_t sdbReadSnapshotHead(char *dir, SSdbSnapshotHead *pHead) {
+  char name[TSDB_FILENAME_LEN * 2];
+  snprintf(name, sizeof(name), "%s/head", dir);
+
+  FILE *fp = fopen(name, "rb");
+  if (fp == NULL) return (errno == ENOENT) ? 1 : TAOS_SYSTEM_ERROR(errno);
+
+  int32_t code = TSDB_CODE_SUCCESS;
+  if (fread(pHead, 1, sizeof(SSdbSnapshotHead), fp) != sizeof(SSdbSnapshotHead) ||
+      pHead->magic != SDB_SNAPSHOT_MAGIC || !taosCheckChecksumWhole((uint8_t *)pHead, sizeof(SSdbSnapshotHead))) {
+    code = TSDB_CODE_MND_SDB_INVAID_META_ROW;
+  }
+
+  fclose(fp);
+  return code;
+}
+
+/*
+ * The rows deleted along with others, such as the tables of a dropped database, are not written into the wal. They are
+ * kept as tombstones at the version they are deleted, and removed from the snapshot as well.
+ */
+static void sdbAddTombstone(SSdbTable *pTable, void *pObj) {
+  if (tsMnodeSnapshotRows <= 0 || tsCompactMnodeWal == 1 || tsSdbMgmt.tombstones == NULL) return;
+
+  void *  key = sdbGetObjKey(pTable, pObj);
+  int32_t keySize = sdbGetKeySize(pTable, key);
+  if (pTable->keyType == SDB_KEY_STRING || pTable->keyType == SDB_KEY_VAR_STRING) keySize++;
+
+  SWalHead *pHead = calloc(1, sizeof(SWalHead) + keySize);
+  if (pHead == NULL) return;
+
+  pHead->msgType = pTable->id * 10 + SDB_ACTION_DELETE;
+  pHead->len = keySize;
+  memcpy(pHead->cont, key, keySize);
+
+  pthread_mutex_lock(&tsSdbMgmt.mutex);
+  pHead->version = tsSdbMgmt.version;
+  taosArrayPush(tsSdbMgmt.tombstones, &pHead);
+  pthread_mutex_unlock(&tsSdbMgmt.mutex);
+}
+
+static void sdbFreeTombstone(void *p) { tfree(*(SWalHead **)p); }
+
+// keep the last record of each row, a tombstone replaces the records before it
+static int32_t sdbPutSnapshotRecord(SSdbSnapshotTask *pTask, SWalHead *pHead, bool tombstone) {
+  int32_t tableId = pHead->msgType / 10;
+  int32_t action = pHead->msgType % 10;
+  if (tableId < 0 || tableId >= SDB_TABLE_MAX || pTask->delta[tableId] == NULL) return TSDB_CODE_SUCCESS;
+
+  SSdbTable *pTable = sdbGetTableFromId(tableId);
+  int32_t    keySize = sdbGetKeySize(pTable, pHead->cont);
+
+  SWalHead **ppPrev = taosHashGet(pTask->delta[tableId], pHead->cont, keySize);
+  if (tombstone && ppPrev != NULL && (*ppPrev)->version > pHead->version) return TSDB_CODE_SUCCESS;
+
+  SWalHead *pRecord = malloc(sizeof(SWalHead) + pHead->len);
+  if (pRecord == NULL) return TSDB_CODE_MND_OUT_OF_MEMORY;
+
+  memcpy(pRecord, pHead, sizeof(SWalHead) + pHead->len);
+  pRecord->msgType = tableId * 10 + ((action == SDB_ACTION_DELETE) ? SDB_ACTION_DELETE : SDB_ACTION_INSERT);
+  if (ppPrev != NULL) tfree(*ppPrev);
+
+  if (taosHashPut(pTask->delta[tableId], pHead->cont, keySize, &pRecord, POINTER_BYTES) != 0) {
+    free(pRecord);
+    return TSDB_CODE_MND_OUT_OF_MEMORY;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t sdbAddToSnapshotTask(void *param, void *hparam, int32_t qtype, void *unused) {
+  SSdbSnapshotTask *pTask = param;
+  SWalHead *        pHead = hparam;
+
+  if (tsSdbMgmt.status == SDB_STATUS_CLOSING) return TSDB_CODE_MND_SDB_ERROR;
+  if (pHead->version <= pTask->prevVersion || pHead->version > pTask->version) return TSDB_CODE_SUCCESS;
+
+  return sdbPutSnapshotRecord(pTask, pHead, false);
+}
+
+static void sdbFreeSnapshotTask(SSdbSnapshotTask *pTask) {
+  for (int32_t tableId = 0; tableId < SDB_TABLE_MAX; ++tableId) {
+    SHashObj *pDelta = pTask->delta[tableId];
+    if (pDelta == NULL) continue;
+
+    SWalHead **ppRecord = taosHashIterate(pDelta, NULL);
+    while (ppRecord) {
+      free(*ppRecord);
+      ppRecord = taosHashIterate(pDelta, ppRecord);
+    }
+    taosHashCleanup(pDelta);
+  }
+
+  taosArrayDestroyEx(&pTask->tombstones, sdbFreeTombstone);
+  free(pTask);
+}
+
+// merge the sorted rows of the last snapshot with the sorted records since it, the deleted rows are dropped
+static int32_t sdbWriteSnapshotTable(SSdbSnapshotTask *pTask, SSdbTable *pTable, char *prevDir, char *dir,
+                                     int64_t *numOfRows) {
+  SHashObj * pDelta = pTask->delta[pTable->id];
+  int32_t    numOfRecords = taosHashGetSize(pDelta);
+  SWalHead **records = malloc(POINTER_BYTES * (numOfRecords + 1));
+  SWalHead * pPrev = malloc(sizeof(SWalHead) + pTable->maxRowSize);
+  FILE *     prevFp = NULL;
+  FILE *     fp = NULL;
+  int32_t    code = TSDB_CODE_SUCCESS;
+  char       name[TSDB_FILENAME_LEN * 2];
+
+  if (records == NULL || pPrev == NULL) {
+    code = TSDB_CODE_MND_OUT_OF_MEMORY;
+    goto _over;
+  }
+
+  int32_t    num = 0;
+  SWalHead **ppRecord = taosHashIterate(pDelta, NULL);
+  while (ppRecord) {
+    records[num++] = *ppRecord;
+    ppRecord = taosHashIterate(pDelta, ppRecord);
+  }
+  taosqsort(records, num, POINTER_BYTES, pTable, sdbCompareRecord);
+
+  if (prevDir != NULL) {
+    snprintf(name, sizeof(name), "%s/%s", prevDir, pTable->name);
+    prevFp = fopen(name, "rb");
+    if (prevFp == NULL) {
+      code = TAOS_SYSTEM_ERROR(errno);
+      goto _over;
+    }
+  }
+
+  snprintf(name, sizeof(name), "%s/%s", dir, pTable->name);
+  fp = fopen(name, "wb");
+  if (fp == NULL) {
+    code = TAOS_SYSTEM_ERROR(errno);
+    goto _over;
+  }
+
+  int32_t hasPrev = (prevFp != NULL) ? sdbReadSnapshotRecord(prevFp, pPrev, pTable->maxRowSize) : 0;
+  int32_t i = 0;
+  while (hasPrev == 1 || i < num) {
+    if (tsSdbMgmt.status == SDB_STATUS_CLOSING) {
+      code = TSDB_CODE_MND_SDB_ERROR;
+      goto _over;
+    }
+
+    int32_t cmp = 1;
+    if (hasPrev != 1) {
+      cmp = 1;
+    } else if (i >= num) {
+      cmp = -1;
+    } else {
+      cmp = sdbCompareKey(pTable, pPrev->cont, records[i]->cont);
+    }
+
+    // the record since the last snapshot replaces the row of the same key in it
+    SWalHead *pRecord = (cmp < 0) ? pPrev : records[i++];
+    if (pRecord->msgType % 10 != SDB_ACTION_DELETE) {
+      code = sdbWriteSnapshotRecord(fp, pRecord);
+      if (code != TSDB_CODE_SUCCESS) goto _over;
+      (*numOfRows)++;
+    }
+
+    if (cmp <= 0) hasPrev = sdbReadSnapshotRecord(prevFp, pPrev, pTable->maxRowSize);
+  }
+
+  code = (hasPrev < 0) ? hasPrev : sdbSyncFile(fp);
+
+_over:
+  if (fp != NULL) fclose(fp);
+  if (prevFp != NULL) fclose(prevFp);
+  tfree(pPrev);
+  tfree(records);
+  return code;
+}
+
+static int32_t sdbReplaceSnapshot() {
+  char dir[TSDB_FILENAME_LEN];
+  char tmpDir[TSDB_FILENAME_LEN];
+  char oldDir[TSDB_FILENAME_LEN];
+  sdbGetSnapshotDir(dir, "");
+  sdbGetSnapshotDir(tmpDir, ".tmp");
+  sdbGetSnapshotDir(oldDir, ".old");
+
+  if (taosDirExist(dir) && taosRename(dir, oldDir) != 0) return TAOS_SYSTEM_ERROR(errno);
+  if (taosRename(tmpDir, dir) != 0) return TAOS_SYSTEM_ERROR(errno);
+
+  taosRemoveDir(oldDir);
+  return TSDB_CODE_SUCCESS;
+}
+
+static void *sdbSnapshotThreadFp(void *param) {
+  SSdbSnapshotTask *pTask = param;
+  SSdbSnapshotHead  head = {0};
+  int64_t           st = taosGetTimestampMs();
+  char              dir[TSDB_FILENAME_LEN];
+  char              tmpDir[TSDB_FILENAME_LEN];
+
+  setThreadName("sdbSnapshot");
+  sdbGetSnapshotDir(dir, "");
+  sdbGetSnapshotDir(tmpDir, ".tmp");
+
+  // without other mnodes to sync from this one, the wal before the snapshot is useless
+  head.truncated = tsSdbMgmt.walTruncated || (tsNumOfMnodes == 1 && mnodeGetMnodesNum() <= 1);
+  head.version = pTask->version;
+  head.fileId = pTask->fileId;
+
+  int32_t code = walReadFiles(tsSdbMgmt.wal, pTask->prevFileId, pTask->fileId, pTask, sdbAddToSnapshotTask);
+  for (size_t i = 0; i < taosArrayGetSize(pTask->tombstones) && code == TSDB_CODE_SUCCESS; ++i) {
+    code = sdbPutSnapshotRecord(pTask, taosArrayGetP(pTask->tombstones, i), true);
+  }
+
+  if (code == TSDB_CODE_SUCCESS) {
+    taosRemoveDir(tmpDir);
+    if (taosMkDir(tmpDir, 0755) != 0) code = TAOS_SYSTEM_ERROR(errno);
+  }
+
+  for (int32_t tableId = 0; tableId < SDB_TABLE_MAX && code == TSDB_CODE_SUCCESS; ++tableId) {
+    SSdbTable *pTable = sdbGetTableFromId(tableId);
+    if (pTable == NULL) continue;
+
+    code = sdbWriteSnapshotTable(pTask, pTable, (pTask->prevFileId > 0) ? dir : NULL, tmpDir, &head.numOfRows[tableId]);
+    head.numOfTables++;
+  }
+
+  if (code == TSDB_CODE_SUCCESS) code = sdbWriteSnapshotHead(tmpDir, &head);
+  if (code == TSDB_CODE_SUCCESS) code = sdbReplaceSnapshot();
+
+  if (code == TSDB_CODE_SUCCESS) {
+    if (head.truncated) walRemoveFilesBefore(tsSdbMgmt.wal, pTask->fileId);
+
+    tsSdbMgmt.snapshotVersion = pTask->version;
+    tsSdbMgmt.snapshotFileId = pTask->fileId;
+    tsSdbMgmt.walTruncated = head.truncated;
+    sdbInfo("vgId:1, sdb snapshot is written, mver:%" PRIu64 " fileId:%" PRId64 " records:%" PRIu64 " truncated:%d, %" PRId64 " ms",
+            pTask->version, pTask->fileId, pTask->version - pTask->prevVersion, head.truncated, taosGetTimestampMs() - st);
+  } else {
+    sdbError("vgId:1, failed to write sdb snapshot at mver:%" PRIu64 " since %s", pTask->version, tstrerror(code));
+    taosRemoveDir(tmpDir);
+
+    // the tombstones are taken by the next snapshot
+    pthread_mutex_lock(&tsSdbMgmt.mutex);
+    if (tsSdbMgmt.tombstones != NULL && taosArrayAddAll(tsSdbMgmt.tombstones, pTask->tombstones) != NULL) {
+      taosArrayClear(pTask->tombstones);
+    }
+    pthread_mutex_unlock(&tsSdbMgmt.mutex);
+  }
+
+  sdbFreeSnapshotTask(pTask);
+  atomic_store_8(&tsSdbMgmt.snapshotRunning, 0);
+  return NULL;
+}
+
+// called by the sdb worker after the records are written, the wal is rotated at the version of the snapshot
+static void sdbStartSnapshot() {
+  if (tsMnodeSnapshotRows <= 0 || tsCompactMnodeWal == 1 || tsSdbMgmt.status != SDB_STATUS_SERVING) return;
+  if (tsSdbMgmt.version < tsSdbMgmt.nextSnapshotVersion) return;
+  if (atomic_val_compare_exchange_8(&tsSdbMgmt.snapshotRunning, 0, 1) != 0) return;
+
+  SSdbSnapshotTask *pTask = calloc(1, sizeof(SSdbSnapshotTask));
+  if (pTask == NULL) {
+    atomic_store_8(&tsSdbMgmt.snapshotRunning, 0);
+    return;
+  }
+
+  pTask->prevVersion = tsSdbMgmt.snapshotVersion;
+  pTask->prevFileId = tsSdbMgmt.snapshotFileId;
+  for (int32_t tableId = 0; tableId < SDB_TABLE_MAX; ++tableId) {
+    SSdbTable *pTable = sdbGetTableFromId(tableId);
+    if (pTable == NULL) continue;
+
+    _hash_fn_t hashFp = taosGetDefaultHashFunction(TSDB_DATA_TYPE_INT);
+    if (pTable->keyType == SDB_KEY_STRING || pTable->keyType == SDB_KEY_VAR_STRING) {
+      hashFp = taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY);
+    }
+    pTask->delta[tableId] = taosHashInit(1024, hashFp, true, HASH_NO_LOCK);
+  }
+
+  SArray *tombstones = taosArrayInit(64, POINTER_BYTES);
+  if (tombstones == NULL) {
+    sdbFreeSnapshotTask(pTask);
+    atomic_store_8(&tsSdbMgmt.snapshotRunning, 0);
+    return;
+  }
+
+  pthread_mutex_lock(&tsSdbMgmt.mutex);
+  pTask->version = tsSdbMgmt.version;
+  int32_t code = walRotate(tsSdbMgmt.wal, &pTask->fileId);
+  if (code == TSDB_CODE_SUCCESS) {
+    pTask->tombstones = tsSdbMgmt.tombstones;
+    tsSdbMgmt.tombstones = tombstones;
+  }
+  pthread_mutex_unlock(&tsSdbMgmt.mutex);
+
+  if (code != TSDB_CODE_SUCCESS) taosArrayDestroy(&tombstones);
+
+  // retry after another batch of records if failed
+  tsSdbMgmt.nextSnapshotVersion = pTask->version + tsMnodeSnapshotRows;
+
+  if (code == TSDB_CODE_SUCCESS) {
+    pthread_t      thread;
+    pthread_attr_t thAttr;
+    pthread_attr_init(&thAttr);
+    pthread_attr_setdetachstate(&thAttr, PTHREAD_CREATE_DETACHED);
+    if (pthread_create(&thread, &thAttr, sdbSnapshotThreadFp, pTask) != 0) {
+      code = TAOS_SYSTEM_ERROR(errno);
+    }
+    pthread_attr_destroy(&thAttr);
+  }
+
+  if (code != TSDB_CODE_SUCCESS) {
+    sdbError("vgId:1, failed to start sdb snapshot at mver:%" PRIu64 " since %s", pTask->version, tstrerror(code));
+    sdbFreeSnapshotTask(pTask);
+    atomic_store_8(&tsSdbMgmt.snapshotRunning, 0);
+  } else {
+    sdbDebug("vgId:1, sdb snapshot is started, mver:%" PRIu64 " fileId:%" PRId64, pTask->version, pTask->fileId);
+  }
+}
+
+static void *sdbLoadSnapshotTableFp(void *param) {
+  SSdbSnapshotLoader *pLoader = param;
+  SSdbTable *         pTable = pLoader->pTable;
+
+  setThreadName("sdbLoad");
+
+  FILE *fp = fopen(pLoader->name, "rb");
+  if (fp == NULL) {
+    pLoader->code = TAOS_SYSTEM_ERROR(errno);
+    return NULL;
+  }
+
+  SWalHead *pHead = malloc(sizeof(SWalHead) + pTable->maxRowSize);
+  pLoader->pObjs = taosArrayInit((size_t)pLoader->numOfRows + 1, POINTER_BYTES);
+  if (pHead == NULL || pLoader->pObjs == NULL) {
+    pLoader->code = TSDB_CODE_MND_OUT_OF_MEMORY;
+    fclose(fp);
+    tfree(pHead);
+    return NULL;
+  }
+
+  int32_t ret = 0;
+  while ((ret = sdbReadSnapshotRecord(fp, pHead, pTable->maxRowSize)) == 1) {
+    SSdbRow row = {.rowSize = pHead->len, .rowData = pHead->cont, .pTable = pTable};
+    pLoader->code = (*pTable->fpDecode)(&row);
+    if (pLoader->code != TSDB_CODE_SUCCESS) break;
+    taosArrayPush(pLoader->pObjs, &row.pObj);
+  }
+
+  if (pLoader->code == TSDB_CODE_SUCCESS) {
+    if (ret < 0) {
+      pLoader->code = ret;
+    } else if (taosArrayGetSize(pLoader->pObjs) != pLoader->numOfRows) {
+      pLoader->code = TSDB_CODE_MND_SDB_INVAID_META_ROW;
+    }
+  }
+
+  fclose(fp);
+  tfree(pHead);
+  return NULL;
+}
+
+static void sdbRecoverSnapshotDir() {
+  char dir[TSDB_FILENAME_LEN];
+  char tmpDir[TSDB_FILENAME_LEN];
+  char oldDir[TSDB_FILENAME_LEN];
+  sdbGetSnapshotDir(dir, "");
+  sdbGetSnapshotDir(tmpDir, ".tmp");
+  sdbGetSnapshotDir(oldDir, ".old");
+
+  // stopped while the snapshot is replaced
+  if (!taosDirExist(dir) && taosDirExist(oldDir)) {
+    taosRename(oldDir, dir);
+  }
+
+  taosRemoveDir(tmpDir);
+  taosRemoveDir(oldDir);
+}
+
+/*
+ * The files of the tables in the snapshot are read and decoded in parallel, then the rows are inserted in the order of
+ * the tables, since a row may refer to the rows of the tables before it. The wal files before the snapshot are skipped
+ * while restore.
+ */
+static int32_t sdbLoadSnapshot() {
+  SSdbSnapshotHead   head = {0};
+  SSdbSnapshotLoader loaders[SDB_TABLE_MAX] = {{0}};
+  char               dir[TSDB_FILENAME_LEN];
+  int64_t            st = taosGetTimestampMs();
+
+  sdbRecoverSnapshotDir();
+  sdbGetSnapshotDir(dir, "");
+
+  int32_t code = sdbReadSnapshotHead(dir, &head);
+  if (code == 1) return TSDB_CODE_SUCCESS;
+  if (code != TSDB_CODE_SUCCESS) {
+    sdbError("vgId:1, failed to read sdb snapshot head in %s since %s", dir, tstrerror(code));
+    return -1;
+  }
+
+  dnodeReportStep("mnode-sdb", "load snapshot", 0);
+
+  for (int32_t tableId = 0; tableId < SDB_TABLE_MAX; ++tableId) {
+    SSdbSnapshotLoader *pLoader = &loaders[tableId];
+    pLoader->pTable = sdbGetTableFromId(tableId);
+    if (pLoader->pTable == NULL) continue;
+
+    pLoader->numOfRows = head.numOfRows[tableId];
+    snprintf(pLoader->name, sizeof(pLoader->name), "%s/%s", dir, pLoader->pTable->name);
+    if (pthread_create(&pLoader->thread, NULL, sdbLoadSnapshotTableFp, pLoader) != 0) {
+      pLoader->thread = 0;
+      sdbLoadSnapshotTableFp(pLoader);
+    }
+  }
+
+  for (int32_t tableId = 0; tableId < SDB_TABLE_MAX; ++tableId) {
+    SSdbSnapshotLoader *pLoader = &loaders[tableId];
+    if (pLoader->pTable == NULL) continue;
+    if (pLoader->thread) pthread_join(pLoader->thread, NULL);
+    if (pLoader->code != TSDB_CODE_SUCCESS && code == TSDB_CODE_SUCCESS) {
+      sdbError("vgId:1, failed to load sdb snapshot file %s since %s", pLoader->name, tstrerror(pLoader->code));
+      code = pLoader->code;
+    }
+  }
+
+  int64_t totalRows = 0;
+  for (int32_t tableId = 0; tableId < SDB_TABLE_MAX; ++tableId) {
+    SSdbSnapshotLoader *pLoader = &loaders[tableId];
+    if (pLoader->pObjs == NULL) continue;
+
+    size_t num = taosArrayGetSize(pLoader->pObjs);
+    for (size_t i = 0; i < num; ++i) {
+      SSdbRow row = {.pTable = pLoader->pTable, .pObj = *(void **)taosArrayGet(pLoader->pObjs, i)};
+      if (code == TSDB_CODE_SUCCESS) {
+        sdbInsertHash(pLoader->pTable, &row);
+      } else {
+        (*pLoader->pTable->fpDestroy)(&row);
+      }
+    }
+    totalRows += num;
+    taosArrayDestroy(&pLoader->pObjs);
+  }
+
+  if (code != TSDB_CODE_SUCCESS) {
+    if (head.truncated) return -1;
+
+    // all the wal files are kept, restore from them
+    sdbWarn("vgId:1, sdb snapshot is skipped, restore from the whole wal");
+    return TSDB_CODE_SUCCESS;
+  }
+
+  tsSdbMgmt.version = head.version;
+  tsSdbMgmt.snapshotVersion = head.version;
+  tsSdbMgmt.snapshotFileId = head.fileId;
+  tsSdbMgmt.walTruncated = head.truncated;
+
+  sdbInfo("vgId:1, sdb snapshot is loaded, mver:%" PRIu64 " fileId:%" PRId64 " rows:%" PRId64 " tables:%d, %" PRId64 " ms",
+          head.version, head.fileId, totalRows, head.numOfTables, taosGetTimestampMs() - st);
+  return TSDB_CODE_SUCCESS;
+}
+
 static int32_t sdbInitWal() {
   SWalCfg walCfg = {.vgId = 1, .walLevel = TAOS_WAL_FSYNC, .keep = TAOS_WAL_KEEP, .fsyncPeriod = 0};
   char    temp[TSDB_FILENAME_LEN] = {0};
@@ -184,13 +782,19 @@ static int32_t sdbInitWal() {
     return -1;
   }
 
-  sdbInfo("vgId:1, open sdb wal for restore");
-  int32_t code = walRestore(tsSdbMgmt.wal, NULL, sdbProcessWrite);
+  if (sdbLoadSnapshot() != TSDB_CODE_SUCCESS) {
+    return -1;
+  }
+
+  sdbInfo("vgId:1, open sdb wal for restore from file:%" PRId64, tsSdbMgmt.snapshotFileId);
+  int32_t code = walRestoreFrom(tsSdbMgmt.wal, tsSdbMgmt.snapshotFileId, NULL, sdbProcessWrite);
   if (code != TSDB_CODE_SUCCESS) {
     sdbError("vgId:1, failed to open wal for restore since %s", tstrerror(code));
     return -1;
   }
 
+  tsSdbMgmt.nextSnapshotVersion = tsSdbMgmt.snapshotVersion + tsMnodeSnapshotRows;
+
   sdbInfo("vgId:1, sdb wal load success");
   return 0;
 }
@@ -245,6 +849,12 @@ void sdbUpdateMnodeRoles() {
 }
 
 static int32_t sdbGetWalInfo(int32_t vgId, char *fileName, int64_t *fileId) {
+  if (tsSdbMgmt.walTruncated) {
+    sdbError("vgId:1, wal before mver:%" PRIu64 " is removed after snapshot, run taosd with --compact-mnode-wal before "
+             "adding mnodes", tsSdbMgmt.snapshotVersion);
+    return -1;
+  }
+
   return walGetWalFile(tsSdbMgmt.wal, fileName, fileId);
 }
 
@@ -436,6 +1046,7 @@ void sdbCleanUpRef() { taosCloseRef(tsSdbRid); }
 
 int32_t sdbInit() {
   pthread_mutex_init(&tsSdbMgmt.mutex, NULL);
+  tsSdbMgmt.tombstones = taosArrayInit(64, POINTER_BYTES);
 
   if (sdbInitWorker() != 0) {
     return -1;
@@ -469,6 +1080,10 @@ void sdbCleanUp() {
   sdbCleanupWorker();
   sdbDebug("vgId:1, sdb will be closed, mver:%" PRIu64, tsSdbMgmt.version);
 
+  while (atomic_load_8(&tsSdbMgmt.snapshotRunning)) {
+    taosMsleep(10);
+  }
+
   if (tsSdbMgmt.sync) {
     syncStop(tsSdbMgmt.sync);
     tsSdbMgmt.sync = -1;
@@ -479,6 +1094,7 @@ void sdbCleanUp() {
     tsSdbMgmt.wal = NULL;
   }
 
+  taosArrayDestroyEx(&tsSdbMgmt.tombstones, sdbFreeTombstone);
   pthread_mutex_destroy(&tsSdbMgmt.mutex);
 }
 
@@ -510,15 +1126,7 @@ void sdbDecRef(void *tparam, void *pRow) {
 static void *sdbGetRowMeta(SSdbTable *pTable, void *key) {
   if (pTable == NULL) return NULL;
 
-  int32_t keySize = sizeof(int32_t);
-  if (pTable->keyType == SDB_KEY_STRING || pTable->keyType == SDB_KEY_VAR_STRING) {
-    keySize = (int32_t)strlen((char *)key);
-  }
-
-  void **ppRow = (void **)taosHashGet(pTable->iHandle, key, keySize);
-  if (ppRow != NULL) return *ppRow;
-
-  return NULL;
+  return taosObjHashGet(pTable->iHandle, key, sdbGetKeySize(pTable, key));
 }
 
 static void *sdbGetRowMetaFromObj(SSdbTable *pTable, void *key) {
@@ -541,17 +1149,16 @@ static void *sdbGetRowFromObj(SSdbTable *pTable, void *key) {
 }
 
 static int32_t sdbInsertHash(SSdbTable *pTable, SSdbRow *pRow) {
-  void *  key = sdbGetObjKey(pTable, pRow->pObj);
-  int32_t keySize = sizeof(int32_t);
-
-  if (pTable->keyType == SDB_KEY_STRING || pTable->keyType == SDB_KEY_VAR_STRING) {
-    keySize =  (int32_t)strlen((char *)key);
-  }
-
   pthread_mutex_lock(&pTable->mutex);
-  taosHashPut(pTable->iHandle, key, keySize, &pRow->pObj, sizeof(int64_t));
+  int32_t ret = taosObjHashPut(pTable->iHandle, pRow->pObj);
   pthread_mutex_unlock(&pTable->mutex);
 
+  if (ret != 0) {
+    sdbError("vgId:1, sdb:%s, failed to insert key:%s to hash, out of memory", pTable->name,
+             sdbGetRowStr(pTable, pRow->pObj));
+    return TSDB_CODE_MND_OUT_OF_MEMORY;
+  }
+
   sdbIncRef(pTable, pRow->pObj);
   atomic_add_fetch_32(&pTable->numOfRows, 1);
 
@@ -585,14 +1192,10 @@ static int32_t sdbDeleteHash(SSdbTable *pTable, SSdbRow *pRow) {
 
   (*pTable->fpDelete)(pRow);
   
-  void *  key = sdbGetObjKey(pTable, pRow->pObj);
-  int32_t keySize = sizeof(int32_t);
-  if (pTable->keyType == SDB_KEY_STRING || pTable->keyType == SDB_KEY_VAR_STRING) {
-    keySize = (int32_t)strlen((char *)key);
-  }
+  void *key = sdbGetObjKey(pTable, pRow->pObj);
 
   pthread_mutex_lock(&pTable->mutex);
-  taosHashRemove(pTable->iHandle, key, keySize);
+  taosObjHashRemove(pTable->iHandle, key, sdbGetKeySize(pTable, key));
   pthread_mutex_unlock(&pTable->mutex);
 
   atomic_sub_fetch_32(&pTable->numOfRows, 1);
@@ -800,6 +1403,10 @@ int32_t sdbDeleteRow(SSdbRow *pRow) {
     return TSDB_CODE_MND_SDB_OBJ_NOT_THERE;
   }
 
+  if (pRow->type != SDB_OPER_GLOBAL) {
+    sdbAddTombstone(pTable, pRow->pObj);
+  }
+
   int32_t code = sdbDeleteHash(pTable, pRow);
   if (code != TSDB_CODE_SUCCESS) {
     sdbError("vgId:1, sdb:%s, failed to delete from hash", pTable->name);
@@ -851,17 +1458,12 @@ void *sdbFetchRow(void *tparam, void *pIter, void **ppRow) {
   *ppRow = NULL;
   if (pTable == NULL) return NULL;
 
-  pIter = taosHashIterate(pTable->iHandle, pIter);
+  void *pObj = NULL;
+  pIter = taosObjHashIterate(pTable->iHandle, pIter, &pObj);
   if (pIter == NULL) return NULL;
 
-  void **ppMetaRow = pIter;
-  if (ppMetaRow == NULL) {
-    taosHashCancelIterate(pTable->iHandle, pIter);
-    return NULL;
-  }
-
-  *ppRow = *ppMetaRow;
-  sdbIncRef(pTable, *ppMetaRow);
+  *ppRow = pObj;
+  sdbIncRef(pTable, pObj);
 
   return pIter;
 }
@@ -870,7 +1472,7 @@ void sdbFreeIter(void *tparam, void *pIter) {
   SSdbTable *pTable = tparam;
   if (pTable == NULL || pIter == NULL) return;
 
-  taosHashCancelIterate(pTable->iHandle, pIter);
+  taosObjHashCancelIterate(pTable->iHandle, pIter);
 }
 
 int64_t sdbOpenTable(SSdbTableDesc *pDesc) {
@@ -897,7 +1499,7 @@ int64_t sdbOpenTable(SSdbTableDesc *pDesc) {
   if (pTable->keyType == SDB_KEY_STRING || pTable->keyType == SDB_KEY_VAR_STRING) {
     hashFp = taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY);
   }
-  pTable->iHandle = taosHashInit(pTable->hashSessions, hashFp, true, HASH_ENTRY_LOCK);
+  pTable->iHandle = taosObjHashInit(pTable->hashSessions, hashFp, sdbGetIndexKey, pTable);
 
   tsSdbMgmt.numOfTables++;
   tsSdbMgmt.tableList[pTable->id] = pTable;
@@ -922,22 +1524,18 @@ static void sdbCloseTableObj(void *handle) {
   tsSdbMgmt.numOfTables--;
   tsSdbMgmt.tableList[pTable->id] = NULL;
 
-  void *pIter = taosHashIterate(pTable->iHandle, NULL);
-  while (pIter) {
-    void **ppRow = pIter;
-    pIter = taosHashIterate(pTable->iHandle, pIter);
-    if (ppRow == NULL) continue;
-
+  void *pIter = NULL;
+  void *pObj = NULL;
+  while ((pIter = taosObjHashIterate(pTable->iHandle, pIter, &pObj)) != NULL) {
     SSdbRow row = {
-      .pObj = *ppRow,
+      .pObj = pObj,
       .pTable = pTable,
     };
 
     (*pTable->fpDestroy)(&row);
   }
 
-  taosHashCancelIterate(pTable->iHandle, pIter);
-  taosHashCleanup(pTable->iHandle);
+  taosObjHashCleanup(pTable->iHandle);
   pTable->iHandle = NULL;
   pthread_mutex_destroy(&pTable->mutex);
 
@@ -1135,6 +1733,7 @@ static void *sdbWorkerFp(void *pWorker) {
     }
 
     walFsync(tsSdbMgmt.wal, true);
+    sdbStartSnapshot();
 
     // browse all items, and process them one by one
     taosResetQitems(tsSdbWQall);
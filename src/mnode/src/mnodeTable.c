@@ -27,6 +27,7 @@
 #include "tdataformat.h"
 #include "tgrant.h"
 #include "tqueue.h"
+#include "tskiplist.h"
 #include "hash.h"
 #include "mnode.h"
 #include "dnode.h"
@@ -48,6 +49,10 @@
 #define CREATE_CTABLE_RETRY_TIMES 10
 #define CREATE_CTABLE_RETRY_SEC   14
 
+// the name index is unlocked after this number of tables are checked for a page of 'show tables'
+#define SHOW_TABLES_SCAN_STEP     1024
+#define CREATE_CTABLES_MAX_SIZE   (TSDB_MAX_WAL_SIZE / 2)
+
 // informal
 #define META_SYNC_TABLE_NAME "_taos_meta_sync_table_name_taos_"
 #define META_SYNC_TABLE_NAME_LEN 32
@@ -62,6 +67,16 @@ static SHashObj *tsSTableUidHash;
 static int32_t   tsChildTableUpdateSize;
 static int32_t   tsSuperTableUpdateSize;
 
+// the child and normal tables ordered by name, a db and a name prefix of it are both a range of the index
+static SSkipList *      tsCTableNameIndex;
+static pthread_rwlock_t tsCTableNameIndexLock;
+
+typedef struct {
+  char    range[TSDB_TABLE_FNAME_LEN];  // the prefix of all the names to show
+  char    name[TSDB_TABLE_FNAME_LEN];   // the last name checked, the next page starts after it
+  int8_t  inclusive;                    // the page starts from the name itself
+} SShowTablesCursor;
+
 static void *  mnodeGetChildTable(char *tableId);
 static void *  mnodeGetSuperTable(char *tableId);
 static void *  mnodeGetSuperTableByUid(uint64_t uid);
@@ -71,6 +86,7 @@ static void    mnodeRemoveTableFromStable(SSTableObj *pStable, SCTableObj *pCtab
 
 static int32_t mnodeGetShowTableMeta(STableMetaMsg *pMeta, SShowObj *pShow, void *pConn);
 static int32_t mnodeRetrieveShowTables(SShowObj *pShow, char *data, int32_t rows, void *pConn);
+static void    mnodeCancelShowTables(void *pIter);
 static int32_t mnodeGetShowSuperTableMeta(STableMetaMsg *pMeta, SShowObj *pShow, void *pConn);
 static int32_t mnodeRetrieveShowSuperTables(SShowObj *pShow, char *data, int32_t rows, void *pConn);
 static int32_t mnodeGetStreamTableMeta(STableMetaMsg *pMeta, SShowObj *pShow, void *pConn);
@@ -80,6 +96,9 @@ static int32_t mnodeProcessCreateTableMsg(SMnodeMsg *pMsg);
 static int32_t mnodeProcessCreateSuperTableMsg(SMnodeMsg *pMsg);
 static int32_t mnodeProcessCreateChildTableMsg(SMnodeMsg *pMsg);
 static void    mnodeProcessCreateChildTableRsp(SRpcMsg *rpcMsg);
+static void    mnodeProcessCreateChildTablesRsp(SRpcMsg *rpcMsg);
+static void    mnodeSendCreateChildTablesMsg(SArray *pBatch);
+static void    mnodeAbortCreateChildTables(SArray *pBatch);
 
 static int32_t mnodeProcessDropTableMsg(SMnodeMsg *pMsg);
 static int32_t mnodeProcessDropSuperTableMsg(SMnodeMsg *pMsg);
@@ -104,13 +123,46 @@ static int32_t mnodeChangeSuperTableColumn(SMnodeMsg *pMsg);
 static int32_t mnodeChangeSuperTableTag(SMnodeMsg *pMsg);
 static int32_t mnodeChangeNormalTableColumn(SMnodeMsg *pMsg);
 
+// the name is kept in the same allocation of the table, which saves an allocation for each of the millions of tables
+static SCTableObj *mnodeCreateChildTableObj(char *tableId) {
+  size_t      len = strlen(tableId) + 1;
+  SCTableObj *pTable = calloc(1, sizeof(SCTableObj) + len);
+  if (pTable == NULL) return NULL;
+
+  pTable->info.tableId = (char *)(pTable + 1);
+  memcpy(pTable->info.tableId, tableId, len);
+  return pTable;
+}
+
 static void mnodeDestroyChildTable(SCTableObj *pTable) {
-  tfree(pTable->info.tableId);
   tfree(pTable->schema);
   tfree(pTable->sql);
   tfree(pTable);
 }
 
+static char *mnodeGetTableIndexKey(const void *pData) {
+  return ((STableObj *)pData)->tableId;
+}
+
+// the names are ordered without case first, for the patterns of 'like' match them in that way
+static int32_t mnodeCompareTableName(const void *pLeft, const void *pRight) {
+  int32_t ret = strcasecmp(pLeft, pRight);
+  if (ret == 0) ret = strcmp(pLeft, pRight);
+  return (ret < 0) ? -1 : (ret > 0);
+}
+
+static void mnodeAddTableIntoIndex(SCTableObj *pTable) {
+  pthread_rwlock_wrlock(&tsCTableNameIndexLock);
+  tSkipListPut(tsCTableNameIndex, pTable);
+  pthread_rwlock_unlock(&tsCTableNameIndexLock);
+}
+
+static void mnodeRemoveTableFromIndex(SCTableObj *pTable) {
+  pthread_rwlock_wrlock(&tsCTableNameIndexLock);
+  tSkipListRemove(tsCTableNameIndex, pTable->info.tableId);
+  pthread_rwlock_unlock(&tsCTableNameIndexLock);
+}
+
 static char* mnodeGetTableShowPattern(SShowObj *pShow) {
   char* pattern = NULL;
   if (pShow != NULL && pShow->payloadLen > 0) {
@@ -134,6 +186,9 @@ static int32_t mnodeChildTableActionInsert(SSdbRow *pRow) {
   SCTableObj *pTable = pRow->pObj;
   int32_t code = 0;
 
+  // a table failed to insert is deleted by sdb, which removes it from the index as well
+  mnodeAddTableIntoIndex(pTable);
+
   SVgObj *pVgroup = mnodeGetVgroup(pTable->vgId);
   if (pVgroup == NULL) {
     mError("ctable:%s, not in vgId:%d", pTable->info.tableId, pTable->vgId);
@@ -197,6 +252,8 @@ static int32_t mnodeChildTableActionInsert(SSdbRow *pRow) {
 
 static int32_t mnodeChildTableActionDelete(SSdbRow *pRow) {
   SCTableObj *pTable = pRow->pObj;
+  mnodeRemoveTableFromIndex(pTable);
+
   if (pTable->vgId == 0) {
     mError("table:%s, vgId:%d tid:%d, failed to perform delete action, uid:%" PRIu64 " suid:%" PRIu64,
            pTable->info.tableId, pTable->vgId, pTable->tid, pTable->uid, pTable->suid);
@@ -239,7 +296,7 @@ static int32_t mnodeChildTableActionUpdate(SSdbRow *pRow) {
   SCTableObj *pNew = pRow->pObj;
   SCTableObj *pTable = mnodeGetChildTable(pNew->info.tableId);
   if (pTable != pNew) {
-    void *oldTableId = pTable->info.tableId;
+    char *oldTableId = pTable->info.tableId;
     void *oldSql = pTable->sql;
     void *oldSchema = pTable->schema;
     void *oldSTable = pTable->superTable;
@@ -247,6 +304,7 @@ static int32_t mnodeChildTableActionUpdate(SSdbRow *pRow) {
 
     memcpy(pTable, pNew, sizeof(SCTableObj));
 
+    pTable->info.tableId = oldTableId;
     pTable->refCount = oldRefCount;
     pTable->sql = pNew->sql;
     pTable->schema = pNew->schema;
@@ -255,7 +313,6 @@ static int32_t mnodeChildTableActionUpdate(SSdbRow *pRow) {
     free(pNew);
     free(oldSql);
     free(oldSchema);
-    free(oldTableId);
   }
   mnodeDecTableRef(pTable);
 
@@ -294,15 +351,13 @@ static int32_t mnodeChildTableActionEncode(SSdbRow *pRow) {
 
 static int32_t mnodeChildTableActionDecode(SSdbRow *pRow) {
   assert(pRow->rowData != NULL);
-  SCTableObj *pTable = calloc(1, sizeof(SCTableObj));
-  if (pTable == NULL) return TSDB_CODE_MND_OUT_OF_MEMORY;
-
   int32_t len = (int32_t)strlen(pRow->rowData);
   if (len >= TSDB_TABLE_FNAME_LEN) {
-    free(pTable);
     return TSDB_CODE_MND_INVALID_TABLE_ID;
   }
-  pTable->info.tableId = strdup(pRow->rowData);
+
+  SCTableObj *pTable = mnodeCreateChildTableObj(pRow->rowData);
+  if (pTable == NULL) return TSDB_CODE_MND_OUT_OF_MEMORY;
   len++;
 
   memcpy((char *)pTable + sizeof(char *), (char *)pRow->rowData + len, tsChildTableUpdateSize);
@@ -398,6 +453,14 @@ static int32_t mnodeInitChildTables() {
   SCTableObj tObj;
   tsChildTableUpdateSize = (int32_t)((int8_t *)tObj.updateEnd - (int8_t *)&tObj.info.type);
 
+  tsCTableNameIndex = tSkipListCreate(MAX_SKIP_LIST_LEVEL, TSDB_DATA_TYPE_BINARY, TSDB_TABLE_FNAME_LEN,
+                                      mnodeCompareTableName, SL_ALLOW_DUP_KEY, mnodeGetTableIndexKey);
+  if (tsCTableNameIndex == NULL) {
+    mError("failed to init child table name index");
+    return -1;
+  }
+  pthread_rwlock_init(&tsCTableNameIndexLock, NULL);
+
   SSdbTableDesc desc = {
     .id           = SDB_TABLE_CTABLE,
     .name         = "ctables",
@@ -428,6 +491,10 @@ static int32_t mnodeInitChildTables() {
 static void mnodeCleanupChildTables() {
   sdbCloseTable(tsCTableRid);
   tsChildTableSdb = NULL;
+
+  tSkipListDestroy(tsCTableNameIndex);
+  tsCTableNameIndex = NULL;
+  pthread_rwlock_destroy(&tsCTableNameIndexLock);
 }
 
 int64_t mnodeGetSuperTableNum() {
@@ -660,6 +727,7 @@ int32_t mnodeInitTables() {
   mnodeAddReadMsgHandle(TSDB_MSG_TYPE_CM_STABLE_VGROUP, mnodeProcessSuperTableVgroupMsg);
 
   mnodeAddPeerRspHandle(TSDB_MSG_TYPE_MD_CREATE_TABLE_RSP, mnodeProcessCreateChildTableRsp);
+  mnodeAddPeerRspHandle(TSDB_MSG_TYPE_MD_CREATE_TABLES_RSP, mnodeProcessCreateChildTablesRsp);
   mnodeAddPeerRspHandle(TSDB_MSG_TYPE_MD_DROP_TABLE_RSP, mnodeProcessDropChildTableRsp);
   mnodeAddPeerRspHandle(TSDB_MSG_TYPE_MD_DROP_STABLE_RSP, mnodeProcessDropSuperTableRsp);
   mnodeAddPeerRspHandle(TSDB_MSG_TYPE_MD_ALTER_TABLE_RSP, mnodeProcessAlterTableRsp);
@@ -668,7 +736,7 @@ int32_t mnodeInitTables() {
 
   mnodeAddShowMetaHandle(TSDB_MGMT_TABLE_TABLE, mnodeGetShowTableMeta);
   mnodeAddShowRetrieveHandle(TSDB_MGMT_TABLE_TABLE, mnodeRetrieveShowTables);
-  mnodeAddShowFreeIterHandle(TSDB_MGMT_TABLE_TABLE, mnodeCancelGetNextChildTable);
+  mnodeAddShowFreeIterHandle(TSDB_MGMT_TABLE_TABLE, mnodeCancelShowTables);
   mnodeAddShowMetaHandle(TSDB_MGMT_TABLE_METRIC, mnodeGetShowSuperTableMeta);
   mnodeAddShowRetrieveHandle(TSDB_MGMT_TABLE_METRIC, mnodeRetrieveShowSuperTables);
   mnodeAddShowFreeIterHandle(TSDB_MGMT_TABLE_METRIC, mnodeCancelGetNextSuperTable);
@@ -771,6 +839,7 @@ static SMnodeMsg *mnodeCreateSubMsg(SMnodeMsg *pBatchMasterMsg, int32_t contSize
 
   //pSubMsg->pCont = (char *) pSubMsg + sizeof(SMnodeMsg);
   pSubMsg->rpcMsg.pCont = pSubMsg->pCont;
+  pSubMsg->pCreateBatch = NULL;
   pSubMsg->successed = 0;
   pSubMsg->expected = 0;
   SCMCreateTableMsg *pCM = pSubMsg->rpcMsg.pCont;
@@ -844,6 +913,9 @@ static int32_t mnodeProcessBatchCreateTableMsg(SMnodeMsg *pMsg) {
     int32_t contentLen = htonl(pCreate->contLen);
     pMsg->expected = numOfTables;
 
+    // the child tables created in this round are sent to each vgroup together after all of them are in sdb
+    pMsg->pCreateBatch = taosArrayInit(numOfTables, POINTER_BYTES);
+
     int32_t code = TSDB_CODE_SUCCESS;
     SCreateTableMsg *pCreateTable = (SCreateTableMsg*) ((char*) pCreate + sizeof(SCMCreateTableMsg));
     for (SCreateTableMsg *p = pCreateTable; p < (SCreateTableMsg *) ((char *) pCreate + contentLen); p = (SCreateTableMsg *) ((char *) p + htonl(p->len))) {
@@ -859,10 +931,21 @@ static int32_t mnodeProcessBatchCreateTableMsg(SMnodeMsg *pMsg) {
 
       if (code != TSDB_CODE_MND_ACTION_IN_PROGRESS) {
         mnodeDestroySubMsg(pSubMsg);
+        mnodeAbortCreateChildTables(pMsg->pCreateBatch);
+        pMsg->pCreateBatch = NULL;
         return code;
       }
     }
 
+    SArray *pBatch = pMsg->pCreateBatch;
+    pMsg->pCreateBatch = NULL;
+    if (pBatch != NULL && taosArrayGetSize(pBatch) > 0) {
+      // the master is responded only after all of these tables are created
+      mnodeSendCreateChildTablesMsg(pBatch);
+      return TSDB_CODE_MND_ACTION_IN_PROGRESS;
+    }
+    taosArrayDestroy(&pBatch);
+
     if (pMsg->successed >= pMsg->expected) {
       return code;
     } else {
@@ -2048,6 +2131,12 @@ static int32_t mnodeDoCreateChildTableFp(SMnodeMsg *pMsg) {
   mDebug("msg:%p, app:%p table:%s, created in mnode, vgId:%d sid:%d, uid:%" PRIu64, pMsg, pMsg->rpcMsg.ahandle,
          pTable->info.tableId, pTable->vgId, pTable->tid, pTable->uid);
 
+  SMnodeMsg *pMaster = pMsg->pBatchMasterMsg;
+  if (pMsg->retry == 0 && pMaster != NULL && pMaster != pMsg && pMaster->pCreateBatch != NULL) {
+    taosArrayPush(pMaster->pCreateBatch, &pMsg);
+    return TSDB_CODE_MND_ACTION_IN_PROGRESS;
+  }
+
   SCMCreateTableMsg *pCreate = pMsg->rpcMsg.pCont;
   SMDCreateTableMsg *pMDCreate = mnodeBuildCreateChildTableMsg(pCreate, pTable);
   if (pMDCreate == NULL) {
@@ -2067,6 +2156,129 @@ static int32_t mnodeDoCreateChildTableFp(SMnodeMsg *pMsg) {
   return TSDB_CODE_MND_ACTION_IN_PROGRESS;
 }
 
+static int32_t mnodeCompareCreateBatchVgId(const void *p1, const void *p2) {
+  int32_t vgId1 = (*(SMnodeMsg **)p1)->pVgroup->vgId;
+  int32_t vgId2 = (*(SMnodeMsg **)p2)->pVgroup->vgId;
+  if (vgId1 == vgId2) return 0;
+  return (vgId1 < vgId2) ? -1 : 1;
+}
+
+static void mnodeSendCreateChildTablesToVgroup(SArray *pSubMsgs, SArray *pCreates, int32_t contLen) {
+  SMnodeMsg *         pFirst = taosArrayGetP(pSubMsgs, 0);
+  int32_t             numOfTables = (int32_t)taosArrayGetSize(pSubMsgs);
+  SMDCreateTablesMsg *pCreate = rpcMallocCont(contLen);
+
+  if (pCreate != NULL) {
+    pCreate->contLen = htonl(contLen);
+    pCreate->vgId = htonl(pFirst->pVgroup->vgId);
+    pCreate->numOfTables = htonl(numOfTables);
+
+    char *p = pCreate->data;
+    for (int32_t i = 0; i < numOfTables; ++i) {
+      SMDCreateTableMsg *pMDCreate = taosArrayGetP(pCreates, i);
+      int32_t            len = htonl(pMDCreate->contLen);
+      memcpy(p, pMDCreate, len);
+      p += len;
+    }
+  }
+
+  for (int32_t i = 0; i < numOfTables; ++i) {
+    rpcFreeCont(taosArrayGetP(pCreates, i));
+  }
+  taosArrayClear(pCreates);
+
+  if (pCreate == NULL) {
+    SRpcMsg rpcRsp = {.ahandle = pSubMsgs, .code = TSDB_CODE_MND_OUT_OF_MEMORY};
+    mnodeProcessCreateChildTablesRsp(&rpcRsp);
+    return;
+  }
+
+  mDebug("vgId:%d, send create msg of %d tables to vnode together, len:%d", pFirst->pVgroup->vgId, numOfTables, contLen);
+
+  SRpcEpSet epSet = mnodeGetEpSetFromVgroup(pFirst->pVgroup);
+  SRpcMsg   rpcMsg = {
+      .ahandle = pSubMsgs,
+      .pCont   = pCreate,
+      .contLen = contLen,
+      .code    = 0,
+      .msgType = TSDB_MSG_TYPE_MD_CREATE_TABLES
+  };
+
+  dnodeSendMsgToDnode(&epSet, &rpcMsg);
+}
+
+/*
+ * the create msgs of the child tables in one vgroup are sent in one message, so the vnode writes them into its wal as
+ * one record, the responses of the sub msgs are dispatched as the single one when the result returns
+ */
+static void mnodeSendCreateChildTablesMsg(SArray *pBatch) {
+  taosArraySort(pBatch, mnodeCompareCreateBatchVgId);
+
+  int32_t numOfMsgs = (int32_t)taosArrayGetSize(pBatch);
+  SArray *pCreates = taosArrayInit(16, POINTER_BYTES);
+  SArray *pSubMsgs = NULL;
+  int32_t contLen = 0;
+
+  for (int32_t i = 0; i < numOfMsgs; ++i) {
+    SMnodeMsg *pMsg = taosArrayGetP(pBatch, i);
+
+    SMDCreateTableMsg *pMDCreate = mnodeBuildCreateChildTableMsg(pMsg->rpcMsg.pCont, (SCTableObj *)pMsg->pTable);
+    if (pMDCreate == NULL || pCreates == NULL) {
+      rpcFreeCont(pMDCreate);
+      SRpcMsg rpcRsp = {.ahandle = pMsg, .code = TSDB_CODE_MND_OUT_OF_MEMORY};
+      mnodeProcessCreateChildTableRsp(&rpcRsp);
+      continue;
+    }
+
+    int32_t len = htonl(pMDCreate->contLen);
+    if (pSubMsgs != NULL) {
+      SMnodeMsg *pFirst = taosArrayGetP(pSubMsgs, 0);
+      if (pFirst->pVgroup->vgId != pMsg->pVgroup->vgId || contLen + len > CREATE_CTABLES_MAX_SIZE) {
+        mnodeSendCreateChildTablesToVgroup(pSubMsgs, pCreates, contLen);
+        pSubMsgs = NULL;
+      }
+    }
+
+    if (pSubMsgs == NULL) {
+      pSubMsgs = taosArrayInit(16, POINTER_BYTES);
+      contLen = sizeof(SMDCreateTablesMsg);
+      if (pSubMsgs == NULL) {
+        rpcFreeCont(pMDCreate);
+        SRpcMsg rpcRsp = {.ahandle = pMsg, .code = TSDB_CODE_MND_OUT_OF_MEMORY};
+        mnodeProcessCreateChildTableRsp(&rpcRsp);
+        continue;
+      }
+    }
+
+    taosArrayPush(pSubMsgs, &pMsg);
+    taosArrayPush(pCreates, &pMDCreate);
+    contLen += len;
+  }
+
+  if (pSubMsgs != NULL) {
+    mnodeSendCreateChildTablesToVgroup(pSubMsgs, pCreates, contLen);
+  }
+
+  taosArrayDestroy(&pCreates);
+  taosArrayDestroy(&pBatch);
+}
+
+// the tables of a batch failed before sent to vnodes are removed from sdb
+static void mnodeAbortCreateChildTables(SArray *pBatch) {
+  int32_t numOfMsgs = (int32_t)taosArrayGetSize(pBatch);
+  for (int32_t i = 0; i < numOfMsgs; ++i) {
+    SMnodeMsg *pMsg = taosArrayGetP(pBatch, i);
+    mDebug("msg:%p, app:%p table:%s, removed since the batch failed", pMsg, pMsg->rpcMsg.ahandle,
+           pMsg->pTable->tableId);
+
+    SSdbRow row = {.type = SDB_OPER_GLOBAL, .pTable = tsChildTableSdb, .pObj = pMsg->pTable};
+    sdbDeleteRow(&row);
+    mnodeDestroySubMsg(pMsg);
+  }
+
+  taosArrayDestroy(&pBatch);
+}
+
 static int32_t mnodeDoCreateChildTableCb(SMnodeMsg *pMsg, int32_t code) {
   SCTableObj *pTable = (SCTableObj *)pMsg->pTable;
 
@@ -2126,14 +2338,13 @@ static int32_t mnodeDoCreateChildTable(SMnodeMsg *pMsg, int32_t tid) {
   SCMCreateTableMsg *p1 = pMsg->rpcMsg.pCont;
   SCreateTableMsg   *pCreate = (SCreateTableMsg*)((char*)p1 + sizeof(SCMCreateTableMsg));
 
-  SCTableObj *pTable = calloc(1, sizeof(SCTableObj));
+  SCTableObj *pTable = mnodeCreateChildTableObj(pCreate->tableName);
   if (pTable == NULL) {
     mError("msg:%p, app:%p table:%s, failed to alloc memory", pMsg, pMsg->rpcMsg.ahandle, pCreate->tableName);
     return TSDB_CODE_MND_OUT_OF_MEMORY;
   }
 
   pTable->info.type    = (pCreate->numOfColumns == 0)? TSDB_CHILD_TABLE:TSDB_NORMAL_TABLE;
-  pTable->info.tableId = strdup(pCreate->tableName);
   pTable->createdTime  = taosGetTimestampMs();
   pTable->tid          = tid;
   pTable->vgId         = pVgroup->vgId;
@@ -2826,6 +3037,43 @@ static void mnodeProcessDropChildTableRsp(SRpcMsg *rpcMsg) {
   dnodeSendRpcMWriteRsp(pMsg, TSDB_CODE_SUCCESS);
 }
 
+// dispatch the result of each table to its sub msg
+static void mnodeProcessCreateChildTablesRsp(SRpcMsg *rpcMsg) {
+  SArray *pSubMsgs = rpcMsg->ahandle;
+  if (pSubMsgs == NULL) return;
+
+  int32_t             numOfTables = (int32_t)taosArrayGetSize(pSubMsgs);
+  SMDCreateTablesRsp *pRsp = rpcMsg->pCont;
+  int32_t             code = rpcMsg->code;
+  if (code == TSDB_CODE_SUCCESS &&
+      (pRsp == NULL || rpcMsg->contLen < sizeof(SMDCreateTablesRsp) + sizeof(int32_t) * numOfTables ||
+       htonl(pRsp->numOfTables) != numOfTables)) {
+    code = TSDB_CODE_MND_INVALID_MSG_LEN;
+  }
+
+  mDebug("create msg of %d tables rsp received, result:%s", numOfTables, tstrerror(code));
+
+  // a message rejected by vnode as invalid is not created again table by table, the error is returned instead
+  bool invalid = (code == TSDB_CODE_DND_INVALID_MSG_LEN);
+  if (invalid) {
+    mError("create msg of %d tables is rejected by vnode, result:%s", numOfTables, tstrerror(code));
+  }
+
+  for (int32_t i = 0; i < numOfTables; ++i) {
+    if (invalid) {
+      ((SMnodeMsg *)taosArrayGetP(pSubMsgs, i))->retry = CREATE_CTABLE_RETRY_TIMES;
+    }
+
+    SRpcMsg rsp = {
+      .ahandle = taosArrayGetP(pSubMsgs, i),
+      .code    = (code == TSDB_CODE_SUCCESS) ? (int32_t)htonl(pRsp->codes[i]) : code
+    };
+    mnodeProcessCreateChildTableRsp(&rsp);
+  }
+
+  taosArrayDestroy(&pSubMsgs);
+}
+
 /*
  * handle create table response from dnode
  *   if failed, drop the table cached
@@ -3030,6 +3278,11 @@ static int32_t mnodeProcessMultiTableMetaMsg(SMnodeMsg *pMsg) {
     char *fullName = nameList[t];
 
     pMsg->pTable = mnodeGetTable(fullName);
+    if (pMsg->pTable == NULL && (pInfo->extend & TSDB_MULTI_META_SKIP_MISSING)) {
+      mDebug("msg:%p, app:%p table:%s, not exist, skip it", pMsg, pMsg->rpcMsg.ahandle, fullName);
+      continue;
+    }
+
     if (pMsg->pTable == NULL) {
       mError("msg:%p, app:%p table:%s, failed to get table meta, table not exist", pMsg, pMsg->rpcMsg.ahandle, fullName);
       code = TSDB_CODE_MND_INVALID_TABLE_NAME;
@@ -3055,6 +3308,9 @@ static int32_t mnodeProcessMultiTableMetaMsg(SMnodeMsg *pMsg) {
         code = TSDB_CODE_MND_OUT_OF_MEMORY;
         goto _end;
       }
+
+      // the meta are built on zeroed memory, such as the number of eps in the vgroup
+      memset((char *)pMultiMeta + pMultiMeta->contLen, 0, totalMallocLen - pMultiMeta->contLen);
     }
 
     STableMetaMsg *pMeta = (STableMetaMsg *)((char*) pMultiMeta + pMultiMeta->contLen);
@@ -3165,7 +3421,7 @@ static int32_t mnodeProcessMultiTableMetaMsg(SMnodeMsg *pMsg) {
   pMultiMeta->rawLen = pMultiMeta->contLen;
   if (len == -1 || len >= dataLen + 2) { // compress failed, do not compress this binary data
     pMultiMeta->compressed = 0;
-    memcpy(tmp, pMultiMeta, sizeof(SMultiTableMeta) + pMultiMeta->contLen);
+    memcpy(tmp, pMultiMeta, pMultiMeta->contLen);
   } else {
     pMultiMeta->compressed = 1;
     pMultiMeta->contLen = sizeof(SMultiTableMeta) + len;
@@ -3265,6 +3521,98 @@ static int32_t mnodeGetShowTableMeta(STableMetaMsg *pMeta, SShowObj *pShow, void
   return 0;
 }
 
+static void mnodeCancelShowTables(void *pIter) {
+  free(pIter);
+}
+
+static SShowTablesCursor *mnodeCreateShowTablesCursor(char *prefix, char *pattern) {
+  SShowTablesCursor *pCursor = calloc(1, sizeof(SShowTablesCursor));
+  if (pCursor == NULL) return NULL;
+
+  // the characters before the first wildcard narrow the range, the escaped ones are left to the pattern compare
+  SPatternCompareInfo info = PATTERN_COMPARE_INFO_INITIALIZER;
+  int32_t len = (int32_t)strlen(prefix);
+  tstrncpy(pCursor->range, prefix, sizeof(pCursor->range));
+  for (int32_t i = 0; pattern != NULL && pattern[i] != 0 && len < sizeof(pCursor->range) - 1; ++i) {
+    char c = pattern[i];
+    if (c == info.matchAll || c == info.matchOne || c == '\\') break;
+    pCursor->range[len++] = c;
+  }
+  pCursor->range[len] = 0;
+
+  // the upper case is the first one of the names equal without case
+  for (int32_t i = 0; i < len; ++i) {
+    pCursor->name[i] = (char)toupper(pCursor->range[i]);
+  }
+  pCursor->inclusive = 1;
+
+  return pCursor;
+}
+
+/*
+ * fetch the tables of the next page from the name index, with their references held. The index is locked for no more
+ * than SHOW_TABLES_SCAN_STEP tables at a time, so that a pattern matching few tables does not block the creating and
+ * dropping of tables while the page is filled.
+ */
+static int32_t mnodeGetNextShowTables(SShowObj *pShow, char *prefix, char *pattern, SCTableObj **ppTables,
+                                      int32_t rows) {
+  SShowTablesCursor *pCursor = pShow->pIter;
+  if (pCursor == NULL) {
+    pCursor = mnodeCreateShowTablesCursor(prefix, pattern);
+    if (pCursor == NULL) return 0;
+    pShow->pIter = pCursor;
+  }
+
+  SPatternCompareInfo info = PATTERN_COMPARE_INFO_INITIALIZER;
+  int32_t prefixLen = (int32_t)strlen(prefix);
+  int32_t rangeLen = (int32_t)strlen(pCursor->range);
+  int32_t numOfTables = 0;
+  bool    end = false;
+
+  while (numOfTables < rows && !end) {
+    int32_t steps = 0;
+    end = true;
+
+    pthread_rwlock_rdlock(&tsCTableNameIndexLock);
+    SSkipListIterator *pIter =
+        tSkipListCreateIterFromVal(tsCTableNameIndex, pCursor->name, TSDB_DATA_TYPE_BINARY, TSDB_ORDER_ASC);
+
+    while (tSkipListIterNext(pIter)) {
+      SCTableObj *pTable = SL_GET_NODE_DATA(tSkipListIterGet(pIter));
+      char *      tableId = pTable->info.tableId;
+      if (!pCursor->inclusive && mnodeCompareTableName(tableId, pCursor->name) <= 0) continue;
+      if (strncasecmp(tableId, pCursor->range, rangeLen) != 0) break;
+
+      tstrncpy(pCursor->name, tableId, sizeof(pCursor->name));
+      pCursor->inclusive = 0;
+
+      char tableName[TSDB_TABLE_NAME_LEN] = {0};
+      mnodeExtractTableName(tableId, tableName);
+
+      if (strncmp(tableId, prefix, prefixLen) == 0 &&
+          (pattern == NULL || patternMatch(pattern, tableName, sizeof(tableName) - 1, &info) == TSDB_PATTERN_MATCH)) {
+        mnodeIncTableRef(pTable);
+        ppTables[numOfTables++] = pTable;
+      }
+
+      if (numOfTables >= rows || ++steps >= SHOW_TABLES_SCAN_STEP) {
+        end = false;
+        break;
+      }
+    }
+
+    tSkipListDestroyIter(pIter);
+    pthread_rwlock_unlock(&tsCTableNameIndexLock);
+  }
+
+  if (end) {
+    mnodeCancelShowTables(pCursor);
+    pShow->pIter = NULL;
+  }
+
+  return numOfTables;
+}
+
 static int32_t mnodeRetrieveShowTables(SShowObj *pShow, char *data, int32_t rows, void *pConn) {
   SDbObj *pDb = mnodeGetDb(pShow->db);
   if (pDb == NULL) return 0;
@@ -3278,36 +3626,31 @@ static int32_t mnodeRetrieveShowTables(SShowObj *pShow, char *data, int32_t rows
   int32_t cols       = 0;
   int32_t numOfRows  = 0;
   SCTableObj *pTable = NULL;
-  SPatternCompareInfo info = PATTERN_COMPARE_INFO_INITIALIZER;
 
   char prefix[64] = {0};
-  int32_t prefixLen = (int32_t)tableIdPrefix(pDb->name, prefix, 64);
+  tableIdPrefix(pDb->name, prefix, 64);
 
   char* pattern = mnodeGetTableShowPattern(pShow);
   if (pShow->payloadLen > 0 && pattern == NULL) {
+    mnodeDecDbRef(pDb);
     return 0;
   }
 
-  while (numOfRows < rows) {
-    pShow->pIter = mnodeGetNextChildTable(pShow->pIter, &pTable);
-    if (pTable == NULL) break;
+  SCTableObj **ppTables = malloc(sizeof(SCTableObj *) * MAX(rows, 1));
+  if (ppTables == NULL) {
+    mnodeDecDbRef(pDb);
+    free(pattern);
+    return 0;
+  }
 
-    // not belong to current db
-    if (strncmp(pTable->info.tableId, prefix, prefixLen)) {
-      mnodeDecTableRef(pTable);
-      continue;
-    }
+  int32_t numOfTables = mnodeGetNextShowTables(pShow, prefix, pattern, ppTables, rows);
 
-    char tableName[TSDB_TABLE_NAME_LEN] = {0};
+  for (int32_t i = 0; i < numOfTables; ++i) {
+    pTable = ppTables[i];
 
-    // pattern compare for table name
+    char tableName[TSDB_TABLE_NAME_LEN] = {0};
     mnodeExtractTableName(pTable->info.tableId, tableName);
 
-    if (pattern != NULL && patternMatch(pattern, tableName, sizeof(tableName) - 1, &info) != TSDB_PATTERN_MATCH) {
-      mnodeDecTableRef(pTable);
-      continue;
-    }
-
     cols = 0;
     char *pWrite = data + pShow->offset[cols] * rows + pShow->bytes[cols] * numOfRows;
 
@@ -3361,6 +3704,7 @@ static int32_t mnodeRetrieveShowTables(SShowObj *pShow, char *data, int32_t rows
 
   mnodeVacuumResult(data, pShow->numOfColumns, numOfRows, rows, pShow);
   mnodeDecDbRef(pDb);
+  free(ppTables);
   free(pattern);
 
   return numOfRows;
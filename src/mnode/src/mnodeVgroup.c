@@ -323,6 +323,7 @@ void mnodeUpdateVgroupStatus(SVgObj *pVgroup, SDnodeObj *pDnode, SVnodeLoad *pVl
       mTrace("vgId:%d, receive vnode status from dnode:%d, status:%s last:%s vver:%" PRIu64, pVgroup->vgId,
              pDnode->dnodeId, syncRole[pVload->role], syncRole[pVgid->role], pVload->vnodeVersion);
       pVgid->role = pVload->role;
+      pVgroup->queryTimeRate[i] = htobe64(pVload->queryTimeRate);
       mnodeSetVgidVer(pVgid->vver, pVload->vnodeVersion);
       if (pVload->role == TAOS_SYNC_ROLE_MASTER) {
         pVgroup->inUse = i;
@@ -343,6 +344,8 @@ void mnodeUpdateVgroupStatus(SVgObj *pVgroup, SDnodeObj *pDnode, SVnodeLoad *pVl
     pVgroup->totalStorage = htobe64(pVload->totalStorage);
     pVgroup->compStorage = htobe64(pVload->compStorage);
     pVgroup->pointsWritten = htobe64(pVload->pointsWritten);
+    pVgroup->writeBytesRate = htobe64(pVload->writeBytesRate);
+    pVgroup->writeRowsRate = htobe64(pVload->writeRowsRate);
   }
 
   if (pVload->dbCfgVersion != pVgroup->pDb->dbCfgVersion || pVload->replica != pVgroup->numOfVnodes ||
@@ -24,12 +24,14 @@ extern "C" {
   typedef struct tsem_s *tsem_t;
   int tsem_init(tsem_t *sem, int pshared, unsigned int value);
   int tsem_wait(tsem_t *sem);
+  int tsem_trywait(tsem_t *sem);
   int tsem_post(tsem_t *sem);
   int tsem_destroy(tsem_t *sem);
 #else
   #define tsem_t sem_t
   #define tsem_init sem_init
   int tsem_wait(tsem_t* sem);
+  #define tsem_trywait sem_trywait
   #define tsem_post sem_post
   #define tsem_destroy sem_destroy
 #endif
@@ -195,6 +195,46 @@ int tsem_wait(tsem_t *sem) {
 #endif // SEM_USE_PTHREAD
 }
 
+int tsem_trywait(tsem_t *sem) {
+  if (!*sem) {
+    fprintf(stderr, "==%s[%d]%s():[%p]==not initialized\n", basename(__FILE__), __LINE__, __func__, sem);
+    abort();
+  }
+  struct tsem_s *p = *sem;
+  if (!p->valid) {
+    fprintf(stderr, "==%s[%d]%s():[%p]==already destroyed\n", basename(__FILE__), __LINE__, __func__, sem);
+    abort();
+  }
+#ifdef SEM_USE_PTHREAD
+  int r = -1;
+  if (pthread_mutex_lock(&p->lock)) {
+    fprintf(stderr, "==%s[%d]%s():[%p]==internal logic error\n", basename(__FILE__), __LINE__, __func__, sem);
+    abort();
+  }
+  if (p->val > 0) {
+    p->val -= 1;
+    r = 0;
+  }
+  if (pthread_mutex_unlock(&p->lock)) {
+    fprintf(stderr, "==%s[%d]%s():[%p]==internal logic error\n", basename(__FILE__), __LINE__, __func__, sem);
+    abort();
+  }
+  if (r) errno = EAGAIN;
+  return r;
+#elif defined(SEM_USE_POSIX)
+  return sem_trywait(p->sem);
+#elif defined(SEM_USE_SEM)
+  mach_timespec_t ts = {0, 0};
+  if (semaphore_timedwait(p->sem, ts) == KERN_SUCCESS) return 0;
+  errno = EAGAIN;
+  return -1;
+#else // SEM_USE_PTHREAD
+  if (dispatch_semaphore_wait(p->sem, DISPATCH_TIME_NOW) == 0) return 0;
+  errno = EAGAIN;
+  return -1;
+#endif // SEM_USE_PTHREAD
+}
+
 int tsem_post(tsem_t *sem) {
   if (!*sem) {
     fprintf(stderr, "==%s[%d]%s():[%p]==not initialized\n", basename(__FILE__), __LINE__, __func__, sem);
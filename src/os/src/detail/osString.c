@@ -24,8 +24,17 @@ int64_t taosStr2int64(char *str) {
 
 #if !(defined(_TD_WINDOWS_64) || defined(_TD_WINDOWS_32))
 
+// the nchar values in rows are not aligned as wchar_t, which wcsncmp assumes and may read past the value without
 int32_t tasoUcs4Compare(void *f1_ucs4, void *f2_ucs4, int32_t bytes) {
-  return wcsncmp((wchar_t *)f1_ucs4, (wchar_t *)f2_ucs4, bytes / TSDB_NCHAR_SIZE);
+  for (int32_t i = 0; i < bytes / TSDB_NCHAR_SIZE; ++i) {
+    wchar_t c1, c2;
+    memcpy(&c1, (char *)f1_ucs4 + i * TSDB_NCHAR_SIZE, TSDB_NCHAR_SIZE);
+    memcpy(&c2, (char *)f2_ucs4 + i * TSDB_NCHAR_SIZE, TSDB_NCHAR_SIZE);
+    if (c1 != c2) return (c1 < c2) ? -1 : 1;
+    if (c1 == 0) break;
+  }
+
+  return 0;
 }
 
 #endif
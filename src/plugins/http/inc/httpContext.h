@@ -22,13 +22,14 @@ bool        httpInitContexts();
 void        httpCleanupContexts();
 const char *httpContextStateStr(HttpContextState state);
 
-HttpContext *httpCreateContext(SOCKET fd);
+HttpContext *httpCreateContext(HttpThread *pThread, SOCKET fd);
 bool         httpInitContext(HttpContext *pContext);
-HttpContext *httpGetContext(void * pContext);
+HttpContext *httpGetContext(uint64_t id);
 void         httpReleaseContext(HttpContext *pContext/*, bool clearRes*/);
 void         httpCloseContextByServer(HttpContext *pContext);
 void         httpCloseContextByApp(HttpContext *pContext);
 void         httpNotifyContextClose(HttpContext *pContext);
 bool         httpAlterContextState(HttpContext *pContext, HttpContextState srcState, HttpContextState destState);
+void         httpCleanupContextPool(HttpThread *pThread);
 
 #endif
@@ -36,12 +36,14 @@
 #define HTTP_BUFFER_INIT            4096
 #define HTTP_BUFFER_SIZE            8388608
 #define HTTP_STEP_SIZE              4096    //http message get process step by step
+#define HTTP_BODY_STEP_SIZE         65536   //http body handed to the handlers step by step
 #define HTTP_METHOD_SCANNER_SIZE    7       //http method fp size
 #define HTTP_GC_TARGET_SIZE         16384
+#define HTTP_CONTEXT_POOL_SIZE      64      //the closed contexts kept by each http thread for the new connections
 #define HTTP_WRITE_RETRY_TIMES      500
 #define HTTP_WRITE_WAIT_TIME_MS     5
 #define HTTP_PASSWORD_LEN           TSDB_UNI_LEN
-#define HTTP_SESSION_ID_LEN         (TSDB_USER_LEN + HTTP_PASSWORD_LEN)
+#define HTTP_SESSION_ID_LEN         (TSDB_USER_LEN + HTTP_PASSWORD_LEN + TSDB_DB_NAME_LEN)
 #define HTTP_STATUS_CODE_NUM        63
 
 typedef enum HttpReqType {
@@ -49,7 +51,8 @@ typedef enum HttpReqType {
   HTTP_REQTYPE_LOGIN = 1,
   HTTP_REQTYPE_HEARTBEAT = 2,
   HTTP_REQTYPE_SINGLE_SQL = 3,
-  HTTP_REQTYPE_MULTI_SQL = 4
+  HTTP_REQTYPE_MULTI_SQL = 4,
+  HTTP_REQTYPE_SCHEMALESS = 5
 } HttpReqType;
 
 typedef enum {
@@ -122,6 +125,8 @@ typedef struct {
 typedef struct {
   char *module;
   bool (*fpDecode)(struct HttpContext *pContext);
+  // takes the body by pieces as it is received instead of the parser buffering it, returns the error code
+  int32_t (*fpBody)(struct HttpContext *pContext, const char *chunk, int32_t len);
 } HttpDecodeMethod;
 
 typedef struct {
@@ -143,12 +148,15 @@ typedef enum {
 typedef struct HttpContext {
   int32_t            refCount;
   SOCKET             fd;
+  uint64_t           id;  // the key in the cache and the epoll events, not reused as the context is by the pool
   uint32_t           accessTimes;
   uint32_t           lastAccessTime;
   int32_t            state;
   uint8_t            reqType;
   uint8_t            parsed;
   bool               error;
+  int8_t             readPaused;  // the body handler takes no more of the body till it is resumed
+  int8_t             resumeQueued;  // in the resumed list of the thread, guarded by the mutex of the thread
   char               ipstr[22];
   char               user[TSDB_USER_LEN];  // parsed from auth token or login message
   char               pass[HTTP_PASSWORD_LEN];
@@ -162,9 +170,12 @@ typedef struct HttpContext {
   HttpSqlCmd         singleCmd;
   HttpSqlCmds       *multiCmds;
   JsonBuf           *jsonBuf;
+  struct HttpArrowWriter *arrowWriter;
+  struct HttpSmlWriter   *smlWriter;
   HttpEncodeMethod  *encodeMethod;
   HttpDecodeMethod  *decodeMethod;
   struct HttpThread *pThread;
+  struct HttpContext *pNext;  // in the resumed list or the pool of the thread
 } HttpContext;
 
 typedef struct HttpThread {
@@ -173,6 +184,10 @@ typedef struct HttpThread {
   pthread_mutex_t threadMutex;
   bool            stop;
   EpollFd         pollFd;
+  int32_t         wakeFd;         // wakes up the thread to read the resumed contexts
+  HttpContext *   pResumed;       // the keep-alive contexts whose responses are sent
+  HttpContext *   pPool;          // the closed contexts to be reused
+  int32_t         numOfPooled;
   int32_t         numOfContexts;
   int32_t         threadId;
   char            label[HTTP_LABEL_SIZE << 1];
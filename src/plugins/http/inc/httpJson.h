@@ -36,12 +36,26 @@ extern char JsonNulTkn[];
 extern char JsonTrueTkn[];
 extern char JsonFalseTkn[];
 
+#define HTTP_NUM_STR_SZ 25  // the longest number formatted, including the terminating 0
+#define HTTP_TS_STR_SZ  48  // the longest timestamp formatted, including the terminating 0
+
+// the date and time of the last minute formatted, the rows of a result are mostly in the same minute
+typedef struct {
+  int64_t minute;  // the first second of the minute, in seconds since epoch
+  int8_t  utc;
+  int8_t  prefixLen;
+  int8_t  zoneLen;
+  char    prefix[24];  // up to the minutes, with the separator of the seconds
+  char    zone[8];
+} HttpTimeCache;
+
 typedef struct {
   int32_t size;
   int32_t total;
   char*   lst;
   char    buf[JSON_BUFFER_SIZE];
   struct  HttpContext* pContext;
+  HttpTimeCache timeCache;
 } JsonBuf;
 
 // http response
@@ -55,9 +69,16 @@ typedef void (*httpJsonBuilder)(JsonBuf* buf, void* jsnHandle);
 // buffer
 void    httpInitJsonBuf(JsonBuf* buf, struct HttpContext* pContext);
 void    httpWriteJsonBufHead(JsonBuf* buf);
+void    httpWriteBufHeadWithType(JsonBuf* buf, const char* contentType);
 int32_t httpWriteJsonBufBody(JsonBuf* buf, bool isTheLast);
 void    httpWriteJsonBufEnd(JsonBuf* buf);
 
+// format, without the terminating 0, return the length
+int32_t httpFormatInt64(char* str, int64_t num);
+int32_t httpFormatUInt64(char* str, uint64_t num);
+int32_t httpFormatFixed(char* str, double num, int32_t decimals);
+int32_t httpFormatTimestamp(JsonBuf* buf, char* str, int64_t t, int32_t timePrecision, bool utc);
+
 // value
 void httpJsonString(JsonBuf* buf, char* sVal, int32_t len);
 void httpJsonOriginString(JsonBuf* buf, char* sVal, int32_t len);
@@ -95,6 +116,7 @@ void httpJsonTestBuf(JsonBuf* buf, int32_t safety);
 void httpJsonToken(JsonBuf* buf, char c);
 void httpJsonItemToken(JsonBuf* buf);
 void httpJsonPrint(JsonBuf* buf, const char* json, int32_t len);
+void httpJsonAppend(JsonBuf* buf, const char* data, int32_t len);
 
 // quick
 void httpJsonPairStatus(JsonBuf* buf, int32_t code);
@@ -122,6 +122,12 @@ typedef enum HTTP_KEEPALIVE {
   HTTP_KEEPALIVE_DISABLE = 2
 } HTTP_KEEPALIVE;
 
+typedef enum HTTP_ACCEPT {
+  HTTP_ACCEPT_JSON = 0,
+  HTTP_ACCEPT_CSV = 1,
+  HTTP_ACCEPT_ARROW = 2
+} HTTP_ACCEPT;
+
 typedef struct HttpString {
   char *  str;
   int32_t pos;
@@ -146,6 +152,7 @@ typedef struct HttpParser {
   HttpStack     stacks;
   HttpString    str;
   HttpString    body;
+  HttpString    pending;  // the bytes of the pipelined requests after the one parsed
   HttpString    path[HTTP_MAX_URL];
   char *  method;
   char *  target;
@@ -162,6 +169,7 @@ typedef struct HttpParser {
   int8_t  transferGzip;
   int8_t  transferChunked;
   int8_t  keepAlive;
+  int8_t  accept;
   int8_t  authType;
   int32_t contentLength;
   int32_t chunkSize;
@@ -178,6 +186,7 @@ void        httpInitParser(HttpParser *parser);
 HttpParser *httpCreateParser(struct HttpContext *pContext);
 void        httpClearParser(HttpParser *parser);
 void        httpDestroyParser(HttpParser *parser);
+void        httpResetParser(HttpParser *parser);
 int32_t     httpParseBuf(HttpParser *parser, const char *buf, int32_t len);
 char *      httpGetStatusDesc(int32_t statusCode);
 
@@ -18,6 +18,10 @@
 
 #include "httpInt.h"
 
+#define HTTP_CONTENT_TYPE_JSON  "application/json;charset=utf-8"
+#define HTTP_CONTENT_TYPE_CSV   "text/csv;charset=utf-8"
+#define HTTP_CONTENT_TYPE_ARROW "application/vnd.apache.arrow.stream"
+
 enum _httpRespTempl {
   HTTP_RESPONSE_JSON_OK,
   HTTP_RESPONSE_JSON_ERROR,
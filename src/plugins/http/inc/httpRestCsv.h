@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TDENGINE_REST_CSV_H
+#define TDENGINE_REST_CSV_H
+#include <stdbool.h>
+#include "httpHandle.h"
+#include "httpJson.h"
+#include "taos.h"
+
+void restBuildSqlAffectRowsCsv(HttpContext *pContext, HttpSqlCmd *cmd, int32_t affect_rows);
+
+void restStartSqlCsv(HttpContext *pContext, HttpSqlCmd *cmd, TAOS_RES *result);
+bool restBuildSqlTimestampCsv(HttpContext *pContext, HttpSqlCmd *cmd, TAOS_RES *result, int32_t numOfRows);
+bool restBuildSqlLocalTimeStringCsv(HttpContext *pContext, HttpSqlCmd *cmd, TAOS_RES *result, int32_t numOfRows);
+bool restBuildSqlUtcTimeStringCsv(HttpContext *pContext, HttpSqlCmd *cmd, TAOS_RES *result, int32_t numOfRows);
+void restStopSqlCsv(HttpContext *pContext, HttpSqlCmd *cmd);
+
+#endif
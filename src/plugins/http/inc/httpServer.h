@@ -20,6 +20,7 @@
 
 bool httpInitConnect();
 void httpCleanUpConnect();
+void httpResumeContext(HttpContext *pContext);
 
 void *httpInitServer(char *ip, uint16_t port, char *label, int32_t numOfThreads, void *fp, void *shandle);
 void  httpCleanUpServer(HttpServer *pServer);
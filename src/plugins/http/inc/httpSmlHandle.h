@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TDENGINE_SML_HANDLE_H
+#define TDENGINE_SML_HANDLE_H
+
+#include "http.h"
+#include "httpInt.h"
+#include "httpUtil.h"
+#include "httpResp.h"
+#include "httpSql.h"
+
+#define SML_ROOT_URL_POS      0
+#define SML_PROTOCOL_URL_POS  1
+#define SML_DB_URL_POS        2
+
+#define SML_FLUSH_SIZE        1048576  // the received points are inserted by batches of this size
+#define SML_PAUSE_SIZE        2097152  // the reads are paused at this size received while a batch is inserted
+#define SML_MAX_LINES         65536    // the most lines taken by one schemaless insertion
+
+void smlInitHandle(HttpServer *pServer);
+
+bool    smlProcessRequest(struct HttpContext *pContext);
+int32_t smlProcessBody(struct HttpContext *pContext, const char *chunk, int32_t len);
+void    smlProcessCmd(HttpContext *pContext);
+void    smlFreeWriter(HttpContext *pContext);
+
+#endif
@@ -28,6 +28,11 @@
 #include "httpSession.h"
 #include "httpContext.h"
 #include "httpParser.h"
+#include "httpRestArrow.h"
+#include "httpSmlHandle.h"
+#include "httpServer.h"
+
+static uint64_t tsHttpContextId = 0;  // the id 0 is of no context, but of the wake events of the threads
 
 static void httpDestroyContext(void *data);
 
@@ -44,6 +49,67 @@ static void httpRemoveContextFromEpoll(HttpContext *pContext) {
   }
 }
 
+static void httpFreeContext(HttpContext *pContext) {
+  httpFreeJsonBuf(pContext);
+  if (pContext->parser) {
+    httpDestroyParser(pContext->parser);
+    pContext->parser = NULL;
+  }
+
+  tfree(pContext);
+}
+
+// the parser and json buffer of the closed context are kept for the next connection of the thread
+static bool httpPutContextToPool(HttpThread *pThread, HttpContext *pContext) {
+  bool pooled = false;
+  if (pThread == NULL || pThread->stop || pContext->parser == NULL) return false;
+
+  pthread_mutex_lock(&pThread->threadMutex);
+  if (!pThread->stop && pThread->numOfPooled < HTTP_CONTEXT_POOL_SIZE) {
+    httpResetParser(pContext->parser);
+    pContext->pNext = pThread->pPool;
+    pThread->pPool = pContext;
+    pThread->numOfPooled++;
+    pooled = true;
+  }
+  pthread_mutex_unlock(&pThread->threadMutex);
+
+  return pooled;
+}
+
+static HttpContext *httpGetContextFromPool(HttpThread *pThread) {
+  HttpContext *pContext = NULL;
+
+  pthread_mutex_lock(&pThread->threadMutex);
+  if (pThread->pPool != NULL) {
+    pContext = pThread->pPool;
+    pThread->pPool = pContext->pNext;
+    pThread->numOfPooled--;
+  }
+  pthread_mutex_unlock(&pThread->threadMutex);
+
+  if (pContext != NULL) {
+    HttpParser *parser = pContext->parser;
+    JsonBuf *   jsonBuf = pContext->jsonBuf;
+    memset(pContext, 0, sizeof(HttpContext));
+    pContext->parser = parser;
+    pContext->jsonBuf = jsonBuf;
+  }
+
+  return pContext;
+}
+
+void httpCleanupContextPool(HttpThread *pThread) {
+  pthread_mutex_lock(&pThread->threadMutex);
+  while (pThread->pPool != NULL) {
+    HttpContext *pContext = pThread->pPool;
+    pThread->pPool = pContext->pNext;
+    httpFreeContext(pContext);
+  }
+  pThread->numOfPooled = 0;
+  pthread_mutex_unlock(&pThread->threadMutex);
+}
+
 static void httpDestroyContext(void *data) {
   HttpContext *pContext = *(HttpContext **)data;
   if (pContext->fd > 0) taosCloseSocket(pContext->fd);
@@ -59,17 +125,15 @@ static void httpDestroyContext(void *data) {
   pContext->state = HTTP_CONTEXT_STATE_CLOSED;
 
   // avoid double free
-  httpFreeJsonBuf(pContext);
+  restFreeArrowWriter(pContext);
+  smlFreeWriter(pContext);
   httpFreeMultiCmds(pContext);
 
-  if (pContext->parser) {
-    httpDestroyParser(pContext->parser);
-    pContext->parser = NULL;
-  }
-
   pthread_mutex_destroy(&pContext->ctxMutex);
 
-  tfree(pContext);
+  if (!httpPutContextToPool(pThread, pContext)) {
+    httpFreeContext(pContext);
+  }
 }
 
 bool httpInitContexts() {
@@ -112,21 +176,28 @@ bool httpAlterContextState(HttpContext *pContext, HttpContextState srcState, Htt
   return (atomic_val_compare_exchange_32(&pContext->state, srcState, destState) == srcState);
 }
 
-HttpContext *httpCreateContext(SOCKET fd) {
-  HttpContext *pContext = calloc(1, sizeof(HttpContext));
-  if (pContext == NULL) return NULL;
+HttpContext *httpCreateContext(HttpThread *pThread, SOCKET fd) {
+  HttpContext *pContext = httpGetContextFromPool(pThread);
+  if (pContext == NULL) {
+    pContext = calloc(1, sizeof(HttpContext));
+    if (pContext == NULL) return NULL;
+    pContext->parser = httpCreateParser(pContext);
+  }
 
   pContext->fd = fd;
+  pContext->pThread = pThread;
   pContext->lastAccessTime = taosGetTimestampSec();
   pContext->state = HTTP_CONTEXT_STATE_READY;
-  pContext->parser = httpCreateParser(pContext);
   pContext->error = false;
+  pContext->readPaused = 0;
+  pContext->resumeQueued = 0;
 
-  TSDB_CACHE_PTR_TYPE handleVal = (TSDB_CACHE_PTR_TYPE)pContext;
-  HttpContext **ppContext = taosCachePut(tsHttpServer.contextCache, &handleVal, sizeof(TSDB_CACHE_PTR_TYPE), &pContext,
+  // a stale event of the last connection of a pooled context finds no context by the new id
+  pContext->id = atomic_add_fetch_64(&tsHttpContextId, 1);
+  HttpContext **ppContext = taosCachePut(tsHttpServer.contextCache, &pContext->id, sizeof(pContext->id), &pContext,
                                          sizeof(TSDB_CACHE_PTR_TYPE), tsHttpKeepAlive);
   pContext->ppContext = ppContext;
-  httpDebug("context:%p, fd:%d, is created, data:%p", pContext, fd, ppContext);
+  httpDebug("context:%p, fd:%d, id:%" PRIu64 ", is created, data:%p", pContext, fd, pContext->id, ppContext);
 
   // set the ref to 0
   taosCacheRelease(tsHttpServer.contextCache, (void **)&ppContext, false);
@@ -136,9 +207,8 @@ HttpContext *httpCreateContext(SOCKET fd) {
   return pContext;
 }
 
-HttpContext *httpGetContext(void *ptr) {
-  TSDB_CACHE_PTR_TYPE handleVal = (TSDB_CACHE_PTR_TYPE)ptr;
-  HttpContext **ppContext = taosCacheAcquireByKey(tsHttpServer.contextCache, &handleVal, sizeof(TSDB_CACHE_PTR_TYPE));
+HttpContext *httpGetContext(uint64_t id) {
+  HttpContext **ppContext = taosCacheAcquireByKey(tsHttpServer.contextCache, &id, sizeof(id));
 
   if (ppContext) {
     HttpContext *pContext = *ppContext;
@@ -192,6 +262,7 @@ void httpCloseContextByApp(HttpContext *pContext) {
   HttpParser *parser = pContext->parser;
   pContext->parsed = false;
   bool keepAlive = true;
+  bool resume = false;
 
   if (pContext->error == true) {
     keepAlive = false;
@@ -204,6 +275,7 @@ void httpCloseContextByApp(HttpContext *pContext) {
   if (keepAlive) {
     if (httpAlterContextState(pContext, HTTP_CONTEXT_STATE_HANDLING, HTTP_CONTEXT_STATE_READY)) {
       httpTrace("context:%p, fd:%d, last state:handling, keepAlive:true, reuse context", pContext, pContext->fd);
+      resume = true;
     } else if (httpAlterContextState(pContext, HTTP_CONTEXT_STATE_DROPPING, HTTP_CONTEXT_STATE_CLOSED)) {
       httpRemoveContextFromEpoll(pContext);
       httpTrace("context:%p, fd:%d, ast state:dropping, keepAlive:true, close connect", pContext, pContext->fd);
@@ -223,6 +295,12 @@ void httpCloseContextByApp(HttpContext *pContext) {
               httpContextStateStr(pContext->state), pContext->state);
   }
 
+  // the http thread reads the next request, and takes over the reference
+  if (resume) {
+    httpResumeContext(pContext);
+    return;
+  }
+
   httpReleaseContext(pContext/*, true*/);
 }
 
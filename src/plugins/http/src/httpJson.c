@@ -24,7 +24,15 @@
 #include "httpResp.h"
 #include "httpUtil.h"
 
-#define MAX_NUM_STR_SZ 25
+// the deflate output of a chunk which does not compress, such as the binary results, is a bit longer than the input
+#define GZIP_BUFFER_SIZE (JSON_BUFFER_SIZE + 1024)
+
+static const char httpDigitPairs[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+static const double httpPowersOf10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9};
 
 char JsonItmTkn = ',';
 char JsonObjStt = '{';
@@ -121,8 +129,8 @@ int32_t httpWriteJsonBufBody(JsonBuf* buf, bool isTheLast) {
       remain = httpWriteBufNoTrace(buf->pContext, buf->buf, srcLen);
     }
   } else {
-    char    compressBuf[JSON_BUFFER_SIZE] = {0};
-    int32_t compressBufLen = JSON_BUFFER_SIZE;
+    char    compressBuf[GZIP_BUFFER_SIZE] = {0};
+    int32_t compressBufLen = GZIP_BUFFER_SIZE;
     int32_t ret = httpGzipCompress(buf->pContext, buf->buf, srcLen, compressBuf, &compressBufLen, isTheLast);
     if (ret == 0) {
       if (compressBufLen > 0) {
@@ -150,7 +158,9 @@ int32_t httpWriteJsonBufBody(JsonBuf* buf, bool isTheLast) {
   return remain;
 }
 
-void httpWriteJsonBufHead(JsonBuf* buf) {
+void httpWriteJsonBufHead(JsonBuf* buf) { httpWriteBufHeadWithType(buf, HTTP_CONTENT_TYPE_JSON); }
+
+void httpWriteBufHeadWithType(JsonBuf* buf, const char* contentType) {
   if (buf->pContext->fd <= 0) {
     buf->pContext->fd = -1;
   }
@@ -160,10 +170,10 @@ void httpWriteJsonBufHead(JsonBuf* buf) {
 
   if (buf->pContext->parser->acceptEncodingGzip == 0 || !tsHttpEnableCompress) {
     len = sprintf(msg, httpRespTemplate[HTTP_RESPONSE_CHUNKED_UN_COMPRESS], httpVersionStr[buf->pContext->parser->httpVersion],
-                  httpKeepAliveStr[buf->pContext->parser->keepAlive]);
+                  httpKeepAliveStr[buf->pContext->parser->keepAlive], contentType);
   } else {
     len = sprintf(msg, httpRespTemplate[HTTP_RESPONSE_CHUNKED_COMPRESS], httpVersionStr[buf->pContext->parser->httpVersion],
-                  httpKeepAliveStr[buf->pContext->parser->keepAlive]);
+                  httpKeepAliveStr[buf->pContext->parser->keepAlive], contentType);
   }
 
   httpWriteBuf(buf->pContext, (const char*)msg, len);
@@ -184,6 +194,7 @@ void httpInitJsonBuf(JsonBuf* buf, struct HttpContext* pContext) {
   buf->total = 0;
   buf->size = JSON_BUFFER_SIZE;  // option setting
   buf->pContext = pContext;
+  buf->timeCache.minute = INT64_MIN;
   memset(buf->lst, 0, JSON_BUFFER_SIZE);
 
   if (pContext->parser->acceptEncodingGzip == 1 && tsHttpEnableCompress) {
@@ -193,6 +204,145 @@ void httpInitJsonBuf(JsonBuf* buf, struct HttpContext* pContext) {
   httpTrace("context:%p, fd:%d, json buffer initialized", buf->pContext, buf->pContext->fd);
 }
 
+int32_t httpFormatUInt64(char* str, uint64_t num) {
+  char  tmp[HTTP_NUM_STR_SZ];
+  char* p = tmp + sizeof(tmp);
+
+  while (num >= 100) {
+    const char* pair = httpDigitPairs + (num % 100) * 2;
+    num /= 100;
+    *--p = pair[1];
+    *--p = pair[0];
+  }
+
+  if (num >= 10) {
+    const char* pair = httpDigitPairs + num * 2;
+    *--p = pair[1];
+    *--p = pair[0];
+  } else {
+    *--p = (char)('0' + num);
+  }
+
+  int32_t len = (int32_t)(tmp + sizeof(tmp) - p);
+  memcpy(str, p, (size_t)len);
+  return len;
+}
+
+int32_t httpFormatInt64(char* str, int64_t num) {
+  if (num >= 0) return httpFormatUInt64(str, (uint64_t)num);
+
+  str[0] = '-';
+  return 1 + httpFormatUInt64(str + 1, 0 - (uint64_t)num);
+}
+
+// the lowest digits of the number, padded with zeros to the width
+static void httpFormatDigits(char* str, uint64_t num, int32_t width) {
+  for (int32_t i = width - 1; i >= 0; --i) {
+    str[i] = (char)('0' + num % 10);
+    num /= 10;
+  }
+}
+
+/*
+ * the same as printf("%.*f") for the finite numbers whose integral part fits in int64_t, with no more than 9 decimals.
+ * The fraction is scaled in double, which rounds at most once, and the exact rounding error tells the side of the
+ * ties, so the digits are rounded to nearest and ties to even on the exact binary value as printf does.
+ */
+int32_t httpFormatFixed(char* str, double num, int32_t decimals) {
+  int32_t len = 0;
+  if (signbit(num)) {
+    str[len++] = '-';
+    num = -num;
+  }
+
+  double   scale = httpPowersOf10[decimals];
+  double   ipart = trunc(num);
+  double   frac = num - ipart;  // exact
+  double   scaled = frac * scale;
+  double   digits = floor(scaled);
+  double   rem = scaled - digits;  // exact
+  uint64_t integral = (uint64_t)ipart;
+  uint64_t fraction = (uint64_t)digits;
+
+  if (rem > 0.5) {
+    fraction++;
+  } else if (rem == 0.5) {
+    double err = fma(frac, scale, -scaled);
+    if (err > 0 || (err == 0 && (fraction & 1) != 0)) fraction++;
+  }
+
+  if (fraction >= (uint64_t)scale) {
+    fraction -= (uint64_t)scale;
+    integral++;
+  }
+
+  len += httpFormatUInt64(str + len, integral);
+  if (decimals > 0) {
+    str[len++] = '.';
+    httpFormatDigits(str + len, fraction, decimals);
+    len += decimals;
+  }
+
+  return len;
+}
+
+/*
+ * "%Y-%m-%d %H:%M:%S" or "%Y-%m-%dT%H:%M:%S" with the fraction of the precision, the latter is followed by the zone
+ * as "%z". The local time is only converted once a minute, the seconds and the fraction are appended by hand.
+ */
+int32_t httpFormatTimestamp(JsonBuf* buf, char* str, int64_t t, int32_t timePrecision, bool utc) {
+  int64_t unit;
+  int32_t fractionLen;
+
+  switch (timePrecision) {
+    case TSDB_TIME_PRECISION_MICRO:
+      unit = 1000000;
+      fractionLen = 6;
+      break;
+    case TSDB_TIME_PRECISION_NANO:
+      unit = 1000000000;
+      fractionLen = 9;
+      break;
+    default:
+      assert(timePrecision == TSDB_TIME_PRECISION_MILLI);
+      unit = 1000;
+      fractionLen = 3;
+      break;
+  }
+
+  int64_t quot = t / unit;
+  int64_t mod = t % unit;
+  if (mod < 0) {
+    mod += unit;
+    quot--;
+  }
+
+  HttpTimeCache* pCache = &buf->timeCache;
+  if (quot < pCache->minute || quot >= pCache->minute + 60 || pCache->utc != utc) {
+    time_t    tt = (time_t)quot;
+    struct tm ptm = {0};
+    localtime_r(&tt, &ptm);
+
+    pCache->minute = quot - ptm.tm_sec;
+    pCache->utc = utc;
+    pCache->prefixLen = (int8_t)strftime(pCache->prefix, sizeof(pCache->prefix),
+                                         utc ? "%Y-%m-%dT%H:%M:" : "%Y-%m-%d %H:%M:", &ptm);
+    pCache->zoneLen = utc ? (int8_t)strftime(pCache->zone, sizeof(pCache->zone), "%z", &ptm) : 0;
+  }
+
+  int32_t len = pCache->prefixLen;
+  memcpy(str, pCache->prefix, (size_t)len);
+  httpFormatDigits(str + len, (uint64_t)(quot - pCache->minute), 2);
+  len += 2;
+  str[len++] = '.';
+  httpFormatDigits(str + len, (uint64_t)mod, fractionLen);
+  len += fractionLen;
+  memcpy(str + len, pCache->zone, (size_t)pCache->zoneLen);
+  len += pCache->zoneLen;
+
+  return len;
+}
+
 void httpJsonItemToken(JsonBuf* buf) {
   char c = *(buf->lst - 1);
   if (c == JsonArrStt || c == JsonObjStt || c == JsonPairTkn || c == JsonItmTkn) {
@@ -252,160 +402,61 @@ void httpJsonStringForTransMean(JsonBuf* buf, char* sVal, int32_t maxLen) {
 
 void httpJsonInt64(JsonBuf* buf, int64_t num) {
   httpJsonItemToken(buf);
-  httpJsonTestBuf(buf, MAX_NUM_STR_SZ);
-  buf->lst += snprintf(buf->lst, MAX_NUM_STR_SZ, "%" PRId64, num);
+  httpJsonTestBuf(buf, HTTP_NUM_STR_SZ);
+  buf->lst += httpFormatInt64(buf->lst, num);
 }
 
 void httpJsonUInt64(JsonBuf* buf, uint64_t num) {
   httpJsonItemToken(buf);
-  httpJsonTestBuf(buf, MAX_NUM_STR_SZ);
-  buf->lst += snprintf(buf->lst, MAX_NUM_STR_SZ, "%" PRIu64, num);
+  httpJsonTestBuf(buf, HTTP_NUM_STR_SZ);
+  buf->lst += httpFormatUInt64(buf->lst, num);
 }
 
 void httpJsonTimestamp(JsonBuf* buf, int64_t t, int32_t timePrecision) {
-  char       ts[35] = {0};
-  
-  int32_t fractionLen;
-  char* format = NULL;
-  time_t quot = 0;
-  int64_t mod = 0;
-
-  switch (timePrecision) {
-    case TSDB_TIME_PRECISION_MILLI: {
-      mod = ((t) % 1000 + 1000) % 1000;
-      if (t < 0 && mod != 0) {
-        t -= 1000;
-      }
-      quot = t / 1000;
-      fractionLen = 5;
-      format = ".%03" PRId64;
-      break;
-    }
-
-    case TSDB_TIME_PRECISION_MICRO: {
-      mod = ((t) % 1000000 + 1000000) % 1000000;
-      if (t < 0 && mod != 0) {
-        t -= 1000000;
-      }
-      quot = t / 1000000;
-      fractionLen = 8;
-      format = ".%06" PRId64;
-      break;
-    }
-
-    case TSDB_TIME_PRECISION_NANO: {
-      mod = ((t) % 1000000000 + 1000000000) % 1000000000;
-      if (t < 0 && mod != 0) {
-        t -= 1000000000;
-      }
-      quot = t / 1000000000;
-      fractionLen = 11;
-      format = ".%09" PRId64;
-      break;
-    }
-
-    default:
-      fractionLen = 0;
-      assert(false);
-  }
-
-  struct tm ptm = {0};
-  localtime_r(&quot, &ptm);
-  int32_t length = (int32_t)strftime(ts, 35, "%Y-%m-%d %H:%M:%S", &ptm);
-  length += snprintf(ts + length, fractionLen, format, mod);
-
+  char    ts[HTTP_TS_STR_SZ];
+  int32_t length = httpFormatTimestamp(buf, ts, t, timePrecision, false);
   httpJsonString(buf, ts, length);
 }
 
 void httpJsonUtcTimestamp(JsonBuf* buf, int64_t t, int32_t timePrecision) {
-  char       ts[40] = {0};
-  struct tm* ptm;
-
-  int32_t fractionLen;
-  char* format = NULL;
-  time_t quot = 0;
-  long mod = 0;
-
-  switch (timePrecision) {
-    case TSDB_TIME_PRECISION_MILLI: {
-      mod = ((t) % 1000 + 1000) % 1000;
-      if (t < 0 && mod != 0) {
-        t -= 1000;
-      }
-      quot = t / 1000;
-      fractionLen = 5;
-      format = ".%03" PRId64;
-      break;
-    }
-
-    case TSDB_TIME_PRECISION_MICRO: {
-      mod = ((t) % 1000000 + 1000000) % 1000000;
-      if (t < 0 && mod != 0) {
-        t -= 1000000;
-      }
-      quot = t / 1000000;
-      fractionLen = 8;
-      format = ".%06" PRId64;
-      break;
-    }
-
-    case TSDB_TIME_PRECISION_NANO: {
-      mod = ((t) % 1000000000 + 1000000000) % 1000000000;
-      if (t < 0 && mod != 0) {
-        t -= 1000000000;
-      }
-      quot = t / 1000000000;
-      fractionLen = 11;
-      format = ".%09" PRId64;
-      break;
-    }
-
-    default:
-      fractionLen = 0;
-      assert(false);
-  }
-
-  ptm = localtime(&quot);
-  int32_t length = (int32_t)strftime(ts, 40, "%Y-%m-%dT%H:%M:%S", ptm);
-  length += snprintf(ts + length, fractionLen, format, mod);
-  length += (int32_t)strftime(ts + length, 40 - length, "%z", ptm);
-
+  char    ts[HTTP_TS_STR_SZ];
+  int32_t length = httpFormatTimestamp(buf, ts, t, timePrecision, true);
   httpJsonString(buf, ts, length);
 }
 
 void httpJsonInt(JsonBuf* buf, int32_t num) {
   httpJsonItemToken(buf);
-  httpJsonTestBuf(buf, MAX_NUM_STR_SZ);
-  buf->lst += snprintf(buf->lst, MAX_NUM_STR_SZ, "%d", num);
+  httpJsonTestBuf(buf, HTTP_NUM_STR_SZ);
+  buf->lst += httpFormatInt64(buf->lst, num);
 }
 
 void httpJsonUInt(JsonBuf* buf, uint32_t num) {
   httpJsonItemToken(buf);
-  httpJsonTestBuf(buf, MAX_NUM_STR_SZ);
-  buf->lst += snprintf(buf->lst, MAX_NUM_STR_SZ, "%u", num);
+  httpJsonTestBuf(buf, HTTP_NUM_STR_SZ);
+  buf->lst += httpFormatUInt64(buf->lst, num);
 }
 
 void httpJsonFloat(JsonBuf* buf, float num) {
   httpJsonItemToken(buf);
-  httpJsonTestBuf(buf, MAX_NUM_STR_SZ);
+  httpJsonTestBuf(buf, HTTP_NUM_STR_SZ);
   if (isinf(num) || isnan(num)) {
-    buf->lst += snprintf(buf->lst, MAX_NUM_STR_SZ, "null");
+    buf->lst += snprintf(buf->lst, HTTP_NUM_STR_SZ, "null");
   } else if (num > 1E10 || num < -1E10) {
-    buf->lst += snprintf(buf->lst, MAX_NUM_STR_SZ, "%.5e", num);
+    buf->lst += snprintf(buf->lst, HTTP_NUM_STR_SZ, "%.5e", num);
   } else {
-    buf->lst += snprintf(buf->lst, MAX_NUM_STR_SZ, "%.5f", num);
+    buf->lst += httpFormatFixed(buf->lst, num, 5);
   }
 }
 
 void httpJsonDouble(JsonBuf* buf, double num) {
   httpJsonItemToken(buf);
-  httpJsonTestBuf(buf, MAX_NUM_STR_SZ);
+  httpJsonTestBuf(buf, HTTP_NUM_STR_SZ);
   if (isinf(num) || isnan(num)) {
-    buf->lst += snprintf(buf->lst, MAX_NUM_STR_SZ, "null");
+    buf->lst += snprintf(buf->lst, HTTP_NUM_STR_SZ, "null");
   } else if (num > 1E10 || num < -1E10) {
-    buf->lst += snprintf(buf->lst, MAX_NUM_STR_SZ, "%.9e", num);
+    buf->lst += snprintf(buf->lst, HTTP_NUM_STR_SZ, "%.9e", num);
   } else {
-    buf->lst += snprintf(buf->lst, MAX_NUM_STR_SZ, "%.9f", num);
+    buf->lst += httpFormatFixed(buf->lst, num, 9);
   }
 }
 
@@ -495,7 +546,7 @@ void httpJsonTestBuf(JsonBuf* buf, int32_t safety) {
 }
 
 void httpJsonToken(JsonBuf* buf, char c) {
-  httpJsonTestBuf(buf, MAX_NUM_STR_SZ);  // maybe object stack
+  httpJsonTestBuf(buf, HTTP_NUM_STR_SZ);  // maybe object stack
   *buf->lst++ = c;
 }
 
@@ -515,6 +566,23 @@ void httpJsonPrint(JsonBuf* buf, const char* json, int32_t len) {
   buf->lst += len;
 }
 
+// copy the data of any length, flushing the chunks when the buffer is full, keep one byte for the trace of the chunk
+void httpJsonAppend(JsonBuf* buf, const char* data, int32_t len) {
+  while (len > 0) {
+    int32_t avail = buf->size - 1 - (int32_t)(buf->lst - buf->buf);
+    if (avail <= 0) {
+      httpWriteJsonBufBody(buf, false);
+      continue;
+    }
+
+    int32_t n = MIN(avail, len);
+    memcpy(buf->lst, data, (size_t)n);
+    buf->lst += n;
+    data += n;
+    len -= n;
+  }
+}
+
 void httpJsonPairStatus(JsonBuf* buf, int32_t code) {
   if (code == 0) {
     httpJsonPair(buf, "status", 6, "succ", 4);
@@ -175,6 +175,25 @@ bool metricsProcessRequest(HttpContext* pContext) {
     }
   }
 
+  {
+    SDnodeVReadStatis vreadStatis = {{{0}}};
+    dnodeGetVReadStatis(&vreadStatis);
+    char* keyVReadWait = "vread_wait";
+    char* keyQueues[DNODE_VREAD_QUEUE_NUM] = {"query", "long_query", "fetch"};
+    httpJsonPairHead(jsonBuf, keyVReadWait, (int32_t)strlen(keyVReadWait));
+    httpJsonToken(jsonBuf, JsonObjStt);
+    for (int i = 0; i < DNODE_VREAD_QUEUE_NUM; ++i) {
+      httpJsonPairHead(jsonBuf, keyQueues[i], (int32_t)strlen(keyQueues[i]));
+      httpJsonToken(jsonBuf, JsonArrStt);
+      for (int j = 0; j < DNODE_VREAD_WAIT_BUCKETS; ++j) {
+        httpJsonItemToken(jsonBuf);
+        httpJsonInt64(jsonBuf, vreadStatis.waitHist[i][j]);
+      }
+      httpJsonToken(jsonBuf, JsonArrEnd);
+    }
+    httpJsonToken(jsonBuf, JsonObjEnd);
+  }
+
   httpJsonToken(jsonBuf, JsonObjEnd);
 
   httpWriteJsonBufEnd(jsonBuf);
@@ -208,6 +208,54 @@ static int32_t httpOnStatusLine(HttpParser *pParser, int32_t code, const char *r
   return 0;
 }
 
+/*
+ * pick the result format by the media ranges of the Accept header, the one with the highest quality wins and the
+ * earlier one wins a tie. json is answered if no supported format is acceptable, as before the header was parsed.
+ */
+static int8_t httpParseAccept(const char *val) {
+  int8_t      accept = HTTP_ACCEPT_JSON;
+  double      bestQ = -1;
+  const char *p = val;
+
+  while (*p) {
+    while (*p == ' ' || *p == '\t' || *p == ',') p++;
+    if (*p == 0) break;
+
+    const char *type = p;
+    while (*p && *p != ';' && *p != ',' && *p != ' ' && *p != '\t') p++;
+    int32_t typeLen = (int32_t)(p - type);
+
+    double q = 1;
+    while (*p && *p != ',') {
+      if (*p == ';') {
+        p++;
+        while (*p == ' ' || *p == '\t') p++;
+        if ((p[0] == 'q' || p[0] == 'Q') && p[1] == '=') q = atof(p + 2);
+      } else {
+        p++;
+      }
+    }
+
+    int8_t format = -1;
+    if (typeLen == 8 && strncasecmp(type, "text/csv", 8) == 0) {
+      format = HTTP_ACCEPT_CSV;
+    } else if (typeLen == 35 && strncasecmp(type, "application/vnd.apache.arrow.stream", 35) == 0) {
+      format = HTTP_ACCEPT_ARROW;
+    } else if ((typeLen == 16 && strncasecmp(type, "application/json", 16) == 0) ||
+               (typeLen == 13 && strncasecmp(type, "application/*", 13) == 0) ||
+               (typeLen == 3 && strncmp(type, "*/*", 3) == 0)) {
+      format = HTTP_ACCEPT_JSON;
+    }
+
+    if (format >= 0 && q > 0 && q > bestQ) {
+      bestQ = q;
+      accept = format;
+    }
+  }
+
+  return accept;
+}
+
 static int32_t httpOnParseHeaderField(HttpParser *parser, const char *key, const char *val) {
   HttpContext *pContext = parser->pContext;
   httpTrace("context:%p, fd:%d, key:%s val:%s", pContext, pContext->fd, key, val);
@@ -242,6 +290,12 @@ static int32_t httpOnParseHeaderField(HttpParser *parser, const char *key, const
     return 0;
   }
 
+  else if (0 == strcasecmp(key, "Accept")) {
+    parser->accept = httpParseAccept(val);
+    httpTrace("context:%p, fd:%d, accept:%d", pContext, pContext->fd, parser->accept);
+    return 0;
+  }
+
   else if (strncasecmp(key, "Connection", 10) == 0) {
     if (strncasecmp(val, "Keep-Alive", 10) == 0) {
       parser->keepAlive = HTTP_KEEPALIVE_ENABLE;
@@ -333,6 +387,16 @@ static int32_t httpOnBody(HttpParser *parser, const char *chunk, int32_t len) {
   HttpString *buf = &parser->body;
   if (parser->parseCode != TSDB_CODE_SUCCESS) return -1;
 
+  if (pContext->decodeMethod != NULL && pContext->decodeMethod->fpBody != NULL) {
+    int32_t code = (*pContext->decodeMethod->fpBody)(pContext, chunk, len);
+    if (code != TSDB_CODE_SUCCESS) {
+      httpError("context:%p, fd:%d, failed to process body, code:%s", pContext, pContext->fd, tstrerror(code));
+      httpOnError(parser, 0, code);
+      return -1;
+    }
+    return 0;
+  }
+
   if (buf->size <= 0) {
     buf->size = MIN(len + 2, HTTP_BUFFER_SIZE);
     buf->str = malloc(buf->size);
@@ -448,6 +512,7 @@ void httpInitParser(HttpParser *parser) {
   parser->transferGzip = 0;
   parser->transferChunked = 0;
   parser->keepAlive = 0;
+  parser->accept = HTTP_ACCEPT_JSON;
   parser->authType = 0;
   parser->contentLength = 0;
   parser->chunkSize = 0;
@@ -514,6 +579,7 @@ void httpDestroyParser(HttpParser *parser) {
   httpCleanupStack(&parser->stacks);
   httpCleanupString(&parser->str);
   httpCleanupString(&parser->body);
+  httpCleanupString(&parser->pending);
   for (int32_t i = 0; i < HTTP_MAX_URL; ++i) {
     httpCleanupString(&parser->path[i]);
   }
@@ -526,6 +592,17 @@ void httpDestroyParser(HttpParser *parser) {
   free(parser);
 }
 
+void httpResetParser(HttpParser *parser) {
+  httpInitParser(parser);
+  httpClearParser(parser);
+  httpClearString(&parser->pending);
+
+  // the pooled parser keeps the small buffers only
+  if (parser->body.size > HTTP_BODY_STEP_SIZE) httpCleanupString(&parser->body);
+  if (parser->str.size > HTTP_BODY_STEP_SIZE) httpCleanupString(&parser->str);
+  if (parser->pending.size > HTTP_STEP_SIZE) httpCleanupString(&parser->pending);
+}
+
 #define is_token(c) (strchr("!#$%&'*+-.^_`|~", c) || isdigit(c) || isalpha(c))
 
 char *httpDecodeUrl(const char *enc) {
@@ -1022,6 +1099,20 @@ static int32_t httpParserOnChunkSize(HttpParser *parser, HTTP_PARSER_STATE state
   return ok;
 }
 
+static int32_t httpOnChunkData(HttpParser *parser) {
+  HttpContext *pContext = parser->pContext;
+  if (parser->gzip) {
+    if (ehttp_gzip_write(parser->gzip, parser->str.str, parser->str.pos)) {
+      httpError("context:%p, fd:%d, gzip failed", pContext, pContext->fd);
+      httpOnError(parser, HTTP_CODE_INTERNAL_SERVER_ERROR, TSDB_CODE_HTTP_PARSE_CHUNK_FAILED);
+      return -1;
+    }
+  } else {
+    httpOnBody(parser, parser->str.str, parser->str.pos);
+  }
+  return 0;
+}
+
 static int32_t httpParserOnChunk(HttpParser *parser, HTTP_PARSER_STATE state, const char c, int32_t *again) {
   HttpContext *pContext = parser->pContext;
   int32_t      ok = 0;
@@ -1034,18 +1125,16 @@ static int32_t httpParserOnChunk(HttpParser *parser, HTTP_PARSER_STATE state, co
     }
     ++parser->receivedSize;
     ++parser->receivedChunkSize;
-    if (parser->receivedChunkSize < parser->chunkSize) break;
-
-    if (parser->gzip) {
-      if (ehttp_gzip_write(parser->gzip, parser->str.str, parser->str.pos)) {
-        httpError("context:%p, fd:%d, gzip failed", pContext, pContext->fd);
-        ok = -1;
-        httpOnError(parser, HTTP_CODE_INTERNAL_SERVER_ERROR, TSDB_CODE_HTTP_PARSE_CHUNK_FAILED);
-        break;
-      }
-    } else {
-      httpOnBody(parser, parser->str.str, parser->str.pos);
+    if (parser->receivedChunkSize < parser->chunkSize) {
+      // the long chunks are handed over by steps, so the body is not held twice
+      if (parser->str.pos < HTTP_BODY_STEP_SIZE) break;
+      ok = httpOnChunkData(parser);
+      httpClearString(&parser->str);
+      break;
     }
+
+    ok = httpOnChunkData(parser);
+    if (ok != 0) break;
     parser->receivedChunkSize = 0;
     httpClearString(&parser->str);
     httpPopStack(parser);
@@ -1160,6 +1249,21 @@ static int32_t httpParseChar(HttpParser *parser, const char c, int32_t *again) {
   return ok;
 }
 
+// keep the bytes after the request parsed, they may be in the pending buffer already
+static int32_t httpKeepPending(HttpParser *parser, const char *buf, int32_t len) {
+  HttpString *pending = &parser->pending;
+
+  if (pending->str != NULL && buf >= pending->str && buf < pending->str + pending->pos) {
+    memmove(pending->str, buf, len);
+    pending->pos = len;
+    pending->str[len] = 0;
+    return 0;
+  }
+
+  httpClearString(pending);
+  return httpAppendString(pending, buf, len);
+}
+
 int32_t httpParseBuf(HttpParser *parser, const char *buf, int32_t len) {
   HttpContext *pContext = parser->pContext;
   const char * p = buf;
@@ -1176,6 +1280,19 @@ int32_t httpParseBuf(HttpParser *parser, const char *buf, int32_t len) {
     if (again) continue;
     ++p;
     ++i;
+
+    // the pipelined requests are parsed after the response of this one
+    if (parser->parsed) break;
+  }
+
+  if (ret == 0 && parser->parsed && i < len) {
+    httpTrace("context:%p, fd:%d, %d bytes of pipelined requests pending", pContext, pContext->fd, len - i);
+    if (httpKeepPending(parser, p, len - i) != 0) {
+      httpOnError(parser, HTTP_CODE_INSUFFICIENT_STORAGE, TSDB_CODE_HTTP_NO_ENOUGH_MEMORY);
+      ret = -1;
+    }
+  } else if (buf == parser->pending.str) {
+    httpClearString(&parser->pending);
   }
 
   return ret;
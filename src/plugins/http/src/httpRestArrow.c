@@ -0,0 +1,551 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _DEFAULT_SOURCE
+#include "os.h"
+#include "tglobal.h"
+#include "tsclient.h"
+#include "httpLog.h"
+#include "httpJson.h"
+#include "httpRestHandle.h"
+#include "httpRestJson.h"
+#include "httpRestArrow.h"
+
+/*
+ * The results are written as an Arrow IPC stream: a schema message, a record batch message of each block fetched,
+ * and the end of stream marker. Each message is the continuation marker, the length of the metadata, the metadata
+ * as a flatbuffer and the body of the buffers, which are padded to 8 bytes. The flatbuffers are built forward here,
+ * a table after its vtable and before its children, so the offsets are patched once the children are written.
+ * The values are written in the byte order of the host, which is little endian as the schema declares.
+ */
+
+#define ARROW_CONTINUATION       0xFFFFFFFF
+#define ARROW_METADATA_V5        4
+#define ARROW_HEADER_SCHEMA      1
+#define ARROW_HEADER_RECORDBATCH 3
+
+#define ARROW_TYPE_INT       2
+#define ARROW_TYPE_FLOAT     3
+#define ARROW_TYPE_UTF8      5
+#define ARROW_TYPE_BOOL      6
+#define ARROW_TYPE_TIMESTAMP 10
+
+#define ARROW_PRECISION_SINGLE 1
+#define ARROW_PRECISION_DOUBLE 2
+
+#define ARROW_UNIT_MILLI 1
+#define ARROW_UNIT_MICRO 2
+#define ARROW_UNIT_NANO  3
+
+#define ARROW_MAX_SLOTS 8
+#define ARROW_ALIGN(x, a) (((x) + (a) - 1) / (a) * (a))
+
+typedef struct {
+  char *  data;
+  int32_t len;
+  int32_t cap;
+} HttpArrowBuf;
+
+typedef struct {
+  int8_t       type;   // tsdb data type
+  int8_t       bytes;  // bytes of the fixed width values, 0 for the bits of bool and the strings
+  int32_t      nullCount;
+  HttpArrowBuf valid;
+  HttpArrowBuf offsets;
+  HttpArrowBuf values;
+} HttpArrowColumn;
+
+typedef struct HttpArrowWriter {
+  int32_t          numOfCols;
+  int32_t          numOfRows;  // rows of the batch being built
+  HttpArrowColumn *cols;
+  HttpArrowBuf     meta;
+} HttpArrowWriter;
+
+typedef struct {
+  int8_t  id;    // field id in the flatbuffer schema
+  int8_t  size;  // bytes of the scalar, the offsets of the children are 4 bytes
+  int64_t val;
+  int32_t pos;   // where the field is written
+} HttpFbField;
+
+static bool restArrowReserve(HttpArrowBuf *pBuf, int32_t size) {
+  if (pBuf->len + size <= pBuf->cap) return true;
+
+  int32_t cap = MAX(pBuf->cap * 2, 256);
+  while (cap < pBuf->len + size) cap *= 2;
+
+  char *data = realloc(pBuf->data, (size_t)cap);
+  if (data == NULL) return false;
+
+  pBuf->data = data;
+  pBuf->cap = cap;
+  return true;
+}
+
+static bool restArrowPut(HttpArrowBuf *pBuf, const void *data, int32_t size) {
+  if (!restArrowReserve(pBuf, size)) return false;
+  if (data != NULL) {
+    memcpy(pBuf->data + pBuf->len, data, (size_t)size);
+  } else {
+    memset(pBuf->data + pBuf->len, 0, (size_t)size);
+  }
+  pBuf->len += size;
+  return true;
+}
+
+static bool restArrowPad(HttpArrowBuf *pBuf, int32_t align) {
+  return restArrowPut(pBuf, NULL, ARROW_ALIGN(pBuf->len, align) - pBuf->len);
+}
+
+static void restArrowFreeBuf(HttpArrowBuf *pBuf) {
+  tfree(pBuf->data);
+  pBuf->len = 0;
+  pBuf->cap = 0;
+}
+
+// the offset at pos refers to the target after it
+static void restFbPatch(HttpArrowBuf *pBuf, int32_t pos, int32_t target) {
+  uint32_t offset = (uint32_t)(target - pos);
+  memcpy(pBuf->data + pos, &offset, sizeof(offset));
+}
+
+// write the vtable and then the table of the fields, return the position of the table or -1
+static int32_t restFbTable(HttpArrowBuf *pBuf, HttpFbField *fields, int32_t numOfFields) {
+  uint16_t slots[ARROW_MAX_SLOTS] = {0};
+  int32_t  numOfSlots = 0;
+  int32_t  tableSize = 4;
+
+  // the table is 8 bytes aligned, so are the fields in it
+  for (int32_t i = 0; i < numOfFields; ++i) {
+    tableSize = ARROW_ALIGN(tableSize, fields[i].size);
+    slots[fields[i].id] = (uint16_t)tableSize;
+    tableSize += fields[i].size;
+    numOfSlots = MAX(numOfSlots, fields[i].id + 1);
+  }
+
+  uint16_t vtableHead[2] = {(uint16_t)(4 + 2 * numOfSlots), (uint16_t)tableSize};
+  if (!restArrowPad(pBuf, 2)) return -1;
+  int32_t vtable = pBuf->len;
+  if (!restArrowPut(pBuf, vtableHead, sizeof(vtableHead))) return -1;
+  if (!restArrowPut(pBuf, slots, 2 * numOfSlots)) return -1;
+
+  if (!restArrowPad(pBuf, 8)) return -1;
+  int32_t table = pBuf->len;
+  if (!restArrowPut(pBuf, NULL, tableSize)) return -1;
+
+  int32_t soffset = table - vtable;
+  memcpy(pBuf->data + table, &soffset, sizeof(soffset));
+  for (int32_t i = 0; i < numOfFields; ++i) {
+    fields[i].pos = table + slots[fields[i].id];
+    memcpy(pBuf->data + fields[i].pos, &fields[i].val, (size_t)fields[i].size);  // the low bytes of little endian
+  }
+
+  return table;
+}
+
+static int32_t restFbString(HttpArrowBuf *pBuf, const char *str) {
+  uint32_t len = (uint32_t)strlen(str);
+  if (!restArrowPad(pBuf, 4)) return -1;
+
+  int32_t pos = pBuf->len;
+  if (!restArrowPut(pBuf, &len, sizeof(len))) return -1;
+  if (!restArrowPut(pBuf, str, (int32_t)len + 1)) return -1;
+  return pos;
+}
+
+// a vector of the elements, which are the offsets of the tables or the structs of 8 bytes aligned
+static int32_t restFbVector(HttpArrowBuf *pBuf, int32_t numOfElems, int32_t elemSize) {
+  if (!restArrowPad(pBuf, 4)) return -1;
+  if (elemSize == 16 && (pBuf->len + 4) % 8 != 0 && !restArrowPut(pBuf, NULL, 4)) return -1;
+
+  int32_t  pos = pBuf->len;
+  uint32_t num = (uint32_t)numOfElems;
+  if (!restArrowPut(pBuf, &num, sizeof(num))) return -1;
+  if (!restArrowPut(pBuf, NULL, numOfElems * elemSize)) return -1;
+  return pos;
+}
+
+// the message table after the root offset, return the position of the header offset
+static int32_t restFbMessage(HttpArrowBuf *pBuf, int8_t headerType, int64_t bodyLength) {
+  HttpFbField fields[] = {{3, 8, bodyLength}, {2, 4, 0}, {0, 2, ARROW_METADATA_V5}, {1, 1, headerType}};
+
+  pBuf->len = 0;
+  if (!restArrowPut(pBuf, NULL, 4)) return -1;
+
+  int32_t table = restFbTable(pBuf, fields, tListLen(fields));
+  if (table < 0) return -1;
+
+  restFbPatch(pBuf, 0, table);
+  return fields[1].pos;
+}
+
+static int32_t restFbFieldType(HttpArrowBuf *pBuf, int8_t type, int32_t precision, int8_t *pTypeType) {
+  switch (type) {
+    case TSDB_DATA_TYPE_BOOL:
+      *pTypeType = ARROW_TYPE_BOOL;
+      return restFbTable(pBuf, NULL, 0);
+    case TSDB_DATA_TYPE_TINYINT:
+    case TSDB_DATA_TYPE_SMALLINT:
+    case TSDB_DATA_TYPE_INT:
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_UTINYINT:
+    case TSDB_DATA_TYPE_USMALLINT:
+    case TSDB_DATA_TYPE_UINT:
+    case TSDB_DATA_TYPE_UBIGINT: {
+      HttpFbField fields[] = {{0, 4, tDataTypes[type].bytes * 8}, {1, 1, !IS_UNSIGNED_NUMERIC_TYPE(type)}};
+      *pTypeType = ARROW_TYPE_INT;
+      return restFbTable(pBuf, fields, tListLen(fields));
+    }
+    case TSDB_DATA_TYPE_FLOAT:
+    case TSDB_DATA_TYPE_DOUBLE: {
+      HttpFbField fields[] = {
+          {0, 2, (type == TSDB_DATA_TYPE_FLOAT) ? ARROW_PRECISION_SINGLE : ARROW_PRECISION_DOUBLE}};
+      *pTypeType = ARROW_TYPE_FLOAT;
+      return restFbTable(pBuf, fields, tListLen(fields));
+    }
+    case TSDB_DATA_TYPE_TIMESTAMP: {
+      int64_t unit = (precision == TSDB_TIME_PRECISION_MICRO)  ? ARROW_UNIT_MICRO
+                     : (precision == TSDB_TIME_PRECISION_NANO) ? ARROW_UNIT_NANO
+                                                               : ARROW_UNIT_MILLI;
+      HttpFbField fields[] = {{1, 4, 0}, {0, 2, unit}};
+      *pTypeType = ARROW_TYPE_TIMESTAMP;
+
+      int32_t table = restFbTable(pBuf, fields, tListLen(fields));
+      if (table < 0) return -1;
+
+      int32_t timezone = restFbString(pBuf, "UTC");
+      if (timezone < 0) return -1;
+      restFbPatch(pBuf, fields[0].pos, timezone);
+      return table;
+    }
+    default:
+      // binary, nchar and json are all text to the clients
+      *pTypeType = ARROW_TYPE_UTF8;
+      return restFbTable(pBuf, NULL, 0);
+  }
+}
+
+static int32_t restFbField(HttpArrowBuf *pBuf, const char *name, int8_t type, int32_t precision) {
+  HttpFbField fields[] = {{0, 4, 0}, {3, 4, 0}, {5, 4, 0}, {1, 1, 1}, {2, 1, 0}};
+  int32_t     table = restFbTable(pBuf, fields, tListLen(fields));
+  if (table < 0) return -1;
+
+  int32_t str = restFbString(pBuf, name);
+  if (str < 0) return -1;
+  restFbPatch(pBuf, fields[0].pos, str);
+
+  int8_t  typeType = 0;
+  int32_t typeTable = restFbFieldType(pBuf, type, precision, &typeType);
+  if (typeTable < 0) return -1;
+  restFbPatch(pBuf, fields[1].pos, typeTable);
+  pBuf->data[fields[4].pos] = typeType;
+
+  int32_t children = restFbVector(pBuf, 0, 4);
+  if (children < 0) return -1;
+  restFbPatch(pBuf, fields[2].pos, children);
+
+  return table;
+}
+
+static void restArrowWriteMessage(JsonBuf *jsonBuf, HttpArrowBuf *pMeta) {
+  uint32_t prefix[2] = {ARROW_CONTINUATION, (uint32_t)pMeta->len};
+  httpJsonAppend(jsonBuf, (const char *)prefix, sizeof(prefix));
+  httpJsonAppend(jsonBuf, pMeta->data, pMeta->len);
+}
+
+static bool restArrowWriteSchema(JsonBuf *jsonBuf, HttpArrowWriter *pWriter, TAOS_FIELD *fields, int32_t precision) {
+  HttpArrowBuf *pMeta = &pWriter->meta;
+
+  int32_t header = restFbMessage(pMeta, ARROW_HEADER_SCHEMA, 0);
+  if (header < 0) return false;
+
+  HttpFbField schemaFields[] = {{1, 4, 0}, {0, 2, 0}};
+  int32_t     schema = restFbTable(pMeta, schemaFields, tListLen(schemaFields));
+  if (schema < 0) return false;
+  restFbPatch(pMeta, header, schema);
+
+  int32_t vector = restFbVector(pMeta, pWriter->numOfCols, 4);
+  if (vector < 0) return false;
+  restFbPatch(pMeta, schemaFields[0].pos, vector);
+
+  for (int32_t i = 0; i < pWriter->numOfCols; ++i) {
+    const char *name = (fields == NULL) ? REST_JSON_AFFECT_ROWS : fields[i].name;
+    int32_t     field = restFbField(pMeta, name, pWriter->cols[i].type, precision);
+    if (field < 0) return false;
+    restFbPatch(pMeta, vector + 4 + 4 * i, field);
+  }
+
+  if (!restArrowPad(pMeta, 8)) return false;
+  restArrowWriteMessage(jsonBuf, pMeta);
+  return true;
+}
+
+static void restArrowResetBatch(HttpArrowWriter *pWriter) {
+  int32_t zero = 0;
+  pWriter->numOfRows = 0;
+
+  for (int32_t i = 0; i < pWriter->numOfCols; ++i) {
+    HttpArrowColumn *pCol = &pWriter->cols[i];
+    pCol->nullCount = 0;
+    pCol->valid.len = 0;
+    pCol->values.len = 0;
+    pCol->offsets.len = 0;
+    if (pCol->bytes == 0 && pCol->type != TSDB_DATA_TYPE_BOOL) {
+      restArrowPut(&pCol->offsets, &zero, sizeof(zero));  // reserved by restArrowInitWriter
+    }
+  }
+}
+
+static HttpArrowWriter *restArrowInitWriter(HttpContext *pContext, TAOS_FIELD *fields, int32_t numOfCols) {
+  restFreeArrowWriter(pContext);
+
+  HttpArrowWriter *pWriter = calloc(1, sizeof(HttpArrowWriter));
+  if (pWriter == NULL) return NULL;
+  pContext->arrowWriter = pWriter;
+
+  pWriter->numOfCols = (fields == NULL) ? 1 : numOfCols;
+  pWriter->cols = calloc((size_t)pWriter->numOfCols, sizeof(HttpArrowColumn));
+  if (pWriter->cols == NULL) return NULL;
+
+  for (int32_t i = 0; i < pWriter->numOfCols; ++i) {
+    HttpArrowColumn *pCol = &pWriter->cols[i];
+    pCol->type = (fields == NULL) ? TSDB_DATA_TYPE_INT : (int8_t)fields[i].type;
+
+    switch (pCol->type) {
+      case TSDB_DATA_TYPE_BOOL:
+      case TSDB_DATA_TYPE_BINARY:
+      case TSDB_DATA_TYPE_NCHAR:
+      case TSDB_DATA_TYPE_JSON:
+        pCol->bytes = 0;
+        break;
+      default:
+        pCol->bytes = (int8_t)tDataTypes[pCol->type].bytes;
+        break;
+    }
+
+    if (pCol->bytes == 0 && pCol->type != TSDB_DATA_TYPE_BOOL && !restArrowReserve(&pCol->offsets, 4)) return NULL;
+  }
+
+  restArrowResetBatch(pWriter);
+  return pWriter;
+}
+
+static bool restArrowSetBit(HttpArrowBuf *pBuf, int32_t bit, bool set) {
+  if (bit % 8 == 0 && !restArrowPut(pBuf, NULL, 1)) return false;
+  if (set) pBuf->data[bit / 8] |= (char)(1u << (bit % 8));
+  return true;
+}
+
+static bool restArrowAppend(HttpArrowWriter *pWriter, HttpArrowColumn *pCol, const char *val, int32_t len) {
+  int32_t row = pWriter->numOfRows;
+  if (!restArrowSetBit(&pCol->valid, row, val != NULL)) return false;
+  if (val == NULL) pCol->nullCount++;
+
+  if (pCol->type == TSDB_DATA_TYPE_BOOL) {
+    return restArrowSetBit(&pCol->values, row, val != NULL && *(int8_t *)val != 0);
+  } else if (pCol->bytes > 0) {
+    return restArrowPut(&pCol->values, val, pCol->bytes);
+  } else {
+    if (val != NULL && !restArrowPut(&pCol->values, val, len)) return false;
+    return restArrowPut(&pCol->offsets, &pCol->values.len, sizeof(int32_t));
+  }
+}
+
+static void restArrowAppendBody(JsonBuf *jsonBuf, HttpArrowBuf *pBuf, int32_t len) {
+  static const char padding[8] = {0};
+  httpJsonAppend(jsonBuf, pBuf->data, len);
+  httpJsonAppend(jsonBuf, padding, ARROW_ALIGN(len, 8) - len);
+}
+
+// the lengths of the validity, values and offsets of a column, in the order of the buffers in the body
+static int32_t restArrowGetBufLens(HttpArrowColumn *pCol, int32_t *lens) {
+  int32_t numOfBufs = 0;
+  lens[numOfBufs++] = (pCol->nullCount > 0) ? pCol->valid.len : 0;
+  if (pCol->bytes == 0 && pCol->type != TSDB_DATA_TYPE_BOOL) lens[numOfBufs++] = pCol->offsets.len;
+  lens[numOfBufs++] = pCol->values.len;
+  return numOfBufs;
+}
+
+static bool restArrowWriteBatch(JsonBuf *jsonBuf, HttpArrowWriter *pWriter) {
+  if (pWriter->numOfRows == 0) return true;
+
+  HttpArrowBuf *pMeta = &pWriter->meta;
+  int32_t       lens[3];
+  int32_t       numOfBufs = 0;
+  int64_t       bodyLength = 0;
+
+  for (int32_t i = 0; i < pWriter->numOfCols; ++i) {
+    int32_t num = restArrowGetBufLens(&pWriter->cols[i], lens);
+    for (int32_t b = 0; b < num; ++b) bodyLength += ARROW_ALIGN(lens[b], 8);
+    numOfBufs += num;
+  }
+
+  int32_t header = restFbMessage(pMeta, ARROW_HEADER_RECORDBATCH, bodyLength);
+  if (header < 0) return false;
+
+  HttpFbField batchFields[] = {{0, 8, pWriter->numOfRows}, {1, 4, 0}, {2, 4, 0}};
+  int32_t     batch = restFbTable(pMeta, batchFields, tListLen(batchFields));
+  if (batch < 0) return false;
+  restFbPatch(pMeta, header, batch);
+
+  int32_t nodes = restFbVector(pMeta, pWriter->numOfCols, 16);
+  if (nodes < 0) return false;
+  restFbPatch(pMeta, batchFields[1].pos, nodes);
+
+  int32_t buffers = restFbVector(pMeta, numOfBufs, 16);
+  if (buffers < 0) return false;
+  restFbPatch(pMeta, batchFields[2].pos, buffers);
+
+  int64_t offset = 0;
+  int32_t buf = 0;
+  for (int32_t i = 0; i < pWriter->numOfCols; ++i) {
+    HttpArrowColumn *pCol = &pWriter->cols[i];
+    int64_t          node[2] = {pWriter->numOfRows, pCol->nullCount};
+    memcpy(pMeta->data + nodes + 4 + 16 * i, node, sizeof(node));
+
+    int32_t num = restArrowGetBufLens(pCol, lens);
+    for (int32_t b = 0; b < num; ++b, ++buf) {
+      int64_t buffer[2] = {offset, lens[b]};
+      memcpy(pMeta->data + buffers + 4 + 16 * buf, buffer, sizeof(buffer));
+      offset += ARROW_ALIGN(lens[b], 8);
+    }
+  }
+
+  if (!restArrowPad(pMeta, 8)) return false;
+  restArrowWriteMessage(jsonBuf, pMeta);
+
+  for (int32_t i = 0; i < pWriter->numOfCols; ++i) {
+    HttpArrowColumn *pCol = &pWriter->cols[i];
+    int32_t          num = restArrowGetBufLens(pCol, lens);
+    HttpArrowBuf *   bufs[3] = {&pCol->valid, &pCol->offsets, &pCol->values};
+    if (num == 2) bufs[1] = &pCol->values;
+
+    for (int32_t b = 0; b < num; ++b) {
+      restArrowAppendBody(jsonBuf, bufs[b], lens[b]);
+    }
+  }
+
+  restArrowResetBatch(pWriter);
+  return true;
+}
+
+void restBuildSqlAffectRowsArrow(HttpContext *pContext, HttpSqlCmd *cmd, int32_t affect_rows) {
+  JsonBuf *        jsonBuf = httpMallocJsonBuf(pContext);
+  HttpArrowWriter *pWriter = pContext->arrowWriter;
+  if (jsonBuf == NULL || pWriter == NULL) return;
+
+  if (!restArrowAppend(pWriter, &pWriter->cols[0], (const char *)&affect_rows, sizeof(affect_rows))) return;
+  pWriter->numOfRows++;
+  restArrowWriteBatch(jsonBuf, pWriter);
+
+  cmd->numOfRows = 1;
+}
+
+void restStartSqlArrow(HttpContext *pContext, HttpSqlCmd *cmd, TAOS_RES *result) {
+  JsonBuf *jsonBuf = httpMallocJsonBuf(pContext);
+  if (jsonBuf == NULL) return;
+
+  TAOS_FIELD *fields = taos_fetch_fields(result);
+  int32_t     num_fields = taos_num_fields(result);
+
+  httpInitJsonBuf(jsonBuf, pContext);
+  httpWriteBufHeadWithType(jsonBuf, HTTP_CONTENT_TYPE_ARROW);
+
+  // the affected rows are a batch of one row
+  if (num_fields == 0) fields = NULL;
+
+  HttpArrowWriter *pWriter = restArrowInitWriter(pContext, fields, num_fields);
+  if (pWriter == NULL || !restArrowWriteSchema(jsonBuf, pWriter, fields, taos_result_precision(result))) {
+    httpError("context:%p, fd:%d, user:%s, failed to build arrow schema", pContext, pContext->fd, pContext->user);
+    restFreeArrowWriter(pContext);
+  }
+}
+
+bool restBuildSqlArrow(HttpContext *pContext, HttpSqlCmd *cmd, TAOS_RES *result, int32_t numOfRows) {
+  JsonBuf *        jsonBuf = httpMallocJsonBuf(pContext);
+  HttpArrowWriter *pWriter = pContext->arrowWriter;
+  if (jsonBuf == NULL || pWriter == NULL) return false;
+
+  bool isContinue = true;
+
+  for (int32_t k = 0; k < numOfRows; ++k) {
+    TAOS_ROW row = taos_fetch_row(result);
+    if (row == NULL) {
+      continue;
+    }
+    int32_t *length = taos_fetch_lengths(result);
+
+    for (int32_t i = 0; i < pWriter->numOfCols; i++) {
+      if (!restArrowAppend(pWriter, &pWriter->cols[i], row[i], length[i])) {
+        httpError("context:%p, fd:%d, user:%s, out of memory, abort retrieve", pContext, pContext->fd, pContext->user);
+        restFreeArrowWriter(pContext);
+        return false;
+      }
+    }
+
+    pWriter->numOfRows++;
+    cmd->numOfRows++;
+
+    if (pContext->fd <= 0) {
+      httpError("context:%p, fd:%d, user:%s, conn closed, abort retrieve", pContext, pContext->fd, pContext->user);
+      isContinue = false;
+      break;
+    }
+
+    if (cmd->numOfRows >= tsRestRowLimit) {
+      httpDebug("context:%p, fd:%d, user:%s, retrieve rows:%d larger than limit:%d, abort retrieve", pContext,
+                pContext->fd, pContext->user, cmd->numOfRows, tsRestRowLimit);
+      isContinue = false;
+      break;
+    }
+  }
+
+  if (!restArrowWriteBatch(jsonBuf, pWriter)) {
+    httpError("context:%p, fd:%d, user:%s, failed to build arrow batch", pContext, pContext->fd, pContext->user);
+    restFreeArrowWriter(pContext);
+    return false;
+  }
+
+  httpDebug("context:%p, fd:%d, user:%s, retrieved row:%d", pContext, pContext->fd, pContext->user, cmd->numOfRows);
+  return isContinue;
+}
+
+void restStopSqlArrow(HttpContext *pContext, HttpSqlCmd *cmd) {
+  JsonBuf *jsonBuf = httpMallocJsonBuf(pContext);
+  if (jsonBuf == NULL) return;
+
+  // the end of stream
+  uint32_t eos[2] = {ARROW_CONTINUATION, 0};
+  httpJsonAppend(jsonBuf, (const char *)eos, sizeof(eos));
+  httpWriteJsonBufEnd(jsonBuf);
+
+  restFreeArrowWriter(pContext);
+}
+
+void restFreeArrowWriter(HttpContext *pContext) {
+  HttpArrowWriter *pWriter = pContext->arrowWriter;
+  if (pWriter == NULL) return;
+
+  for (int32_t i = 0; pWriter->cols != NULL && i < pWriter->numOfCols; ++i) {
+    restArrowFreeBuf(&pWriter->cols[i].valid);
+    restArrowFreeBuf(&pWriter->cols[i].offsets);
+    restArrowFreeBuf(&pWriter->cols[i].values);
+  }
+
+  restArrowFreeBuf(&pWriter->meta);
+  tfree(pWriter->cols);
+  tfree(pContext->arrowWriter);
+}
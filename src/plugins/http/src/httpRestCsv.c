@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _DEFAULT_SOURCE
+#include "os.h"
+#include "tglobal.h"
+#include "tsclient.h"
+#include "httpLog.h"
+#include "httpJson.h"
+#include "httpRestHandle.h"
+#include "httpRestJson.h"
+#include "httpRestCsv.h"
+
+/*
+ * The results are written as RFC 4180 CSV: a line of the column names and a line of each row, the null values are
+ * empty fields, and the fields with commas, quotes or line breaks are quoted. The values are formatted directly
+ * into the chunk buffer, the same as the json values are.
+ */
+
+static void restCsvString(JsonBuf *jsonBuf, const char *str, int32_t len) {
+  int32_t i = 0;
+  for (; i < len; ++i) {
+    char c = str[i];
+    if (c == ',' || c == '"' || c == '\n' || c == '\r') break;
+  }
+
+  if (i == len) {
+    httpJsonAppend(jsonBuf, str, len);
+    return;
+  }
+
+  httpJsonAppend(jsonBuf, "\"", 1);
+
+  // a quote is written twice, once at the end of a segment and again at the start of the next one
+  const char *start = str;
+  for (const char *p = str + i; p < str + len; ++p) {
+    if (*p == '"') {
+      httpJsonAppend(jsonBuf, start, (int32_t)(p - start + 1));
+      start = p;
+    }
+  }
+
+  httpJsonAppend(jsonBuf, start, (int32_t)(str + len - start));
+  httpJsonAppend(jsonBuf, "\"", 1);
+}
+
+static void restCsvDouble(JsonBuf *jsonBuf, double num, int32_t decimals) {
+  if (!isfinite(num) || num > 1E10 || num < -1E10) {
+    jsonBuf->lst += snprintf(jsonBuf->lst, HTTP_NUM_STR_SZ, "%.*e", decimals, num);
+  } else {
+    jsonBuf->lst += httpFormatFixed(jsonBuf->lst, num, decimals);
+  }
+}
+
+void restBuildSqlAffectRowsCsv(HttpContext *pContext, HttpSqlCmd *cmd, int32_t affect_rows) {
+  JsonBuf *jsonBuf = httpMallocJsonBuf(pContext);
+  if (jsonBuf == NULL) return;
+
+  httpJsonTestBuf(jsonBuf, HTTP_NUM_STR_SZ);
+  jsonBuf->lst += httpFormatInt64(jsonBuf->lst, affect_rows);
+  *jsonBuf->lst++ = '\n';
+
+  cmd->numOfRows = 1;
+}
+
+void restStartSqlCsv(HttpContext *pContext, HttpSqlCmd *cmd, TAOS_RES *result) {
+  JsonBuf *jsonBuf = httpMallocJsonBuf(pContext);
+  if (jsonBuf == NULL) return;
+
+  TAOS_FIELD *fields = taos_fetch_fields(result);
+  int32_t     num_fields = taos_num_fields(result);
+
+  httpInitJsonBuf(jsonBuf, pContext);
+  httpWriteBufHeadWithType(jsonBuf, HTTP_CONTENT_TYPE_CSV);
+
+  SSqlObj *pObj = (SSqlObj *) result;
+  bool     isAlterSql = (pObj->sqlstr == NULL) ? false : httpCheckAlterSql(pObj->sqlstr);
+
+  if (num_fields == 0 || isAlterSql) {
+    restCsvString(jsonBuf, REST_JSON_AFFECT_ROWS, REST_JSON_AFFECT_ROWS_LEN);
+  } else {
+    for (int32_t i = 0; i < num_fields; ++i) {
+      if (i > 0) httpJsonAppend(jsonBuf, ",", 1);
+      restCsvString(jsonBuf, fields[i].name, (int32_t)strlen(fields[i].name));
+    }
+  }
+
+  httpJsonAppend(jsonBuf, "\n", 1);
+}
+
+static bool restBuildSqlCsv(HttpContext *pContext, HttpSqlCmd *cmd, TAOS_RES *result, int32_t numOfRows,
+                            int32_t timestampFormat) {
+  JsonBuf *jsonBuf = httpMallocJsonBuf(pContext);
+  if (jsonBuf == NULL) return false;
+
+  int32_t     num_fields = taos_num_fields(result);
+  TAOS_FIELD *fields = taos_fetch_fields(result);
+  int32_t     precision = taos_result_precision(result);
+
+  for (int32_t k = 0; k < numOfRows; ++k) {
+    TAOS_ROW row = taos_fetch_row(result);
+    if (row == NULL) {
+      continue;
+    }
+    int32_t *length = taos_fetch_lengths(result);
+
+    for (int32_t i = 0; i < num_fields; i++) {
+      // room for the separator and any value but the strings, which are appended piece by piece
+      httpJsonTestBuf(jsonBuf, HTTP_TS_STR_SZ);
+      if (i > 0) *jsonBuf->lst++ = ',';
+
+      if (row[i] == NULL) {
+        continue;
+      }
+
+      switch (fields[i].type) {
+        case TSDB_DATA_TYPE_BOOL:
+        case TSDB_DATA_TYPE_TINYINT:
+          jsonBuf->lst += httpFormatInt64(jsonBuf->lst, *((int8_t *)row[i]));
+          break;
+        case TSDB_DATA_TYPE_SMALLINT:
+          jsonBuf->lst += httpFormatInt64(jsonBuf->lst, *((int16_t *)row[i]));
+          break;
+        case TSDB_DATA_TYPE_INT:
+          jsonBuf->lst += httpFormatInt64(jsonBuf->lst, *((int32_t *)row[i]));
+          break;
+        case TSDB_DATA_TYPE_BIGINT:
+          jsonBuf->lst += httpFormatInt64(jsonBuf->lst, *((int64_t *)row[i]));
+          break;
+        case TSDB_DATA_TYPE_UTINYINT:
+          jsonBuf->lst += httpFormatUInt64(jsonBuf->lst, *((uint8_t *)row[i]));
+          break;
+        case TSDB_DATA_TYPE_USMALLINT:
+          jsonBuf->lst += httpFormatUInt64(jsonBuf->lst, *((uint16_t *)row[i]));
+          break;
+        case TSDB_DATA_TYPE_UINT:
+          jsonBuf->lst += httpFormatUInt64(jsonBuf->lst, *((uint32_t *)row[i]));
+          break;
+        case TSDB_DATA_TYPE_UBIGINT:
+          jsonBuf->lst += httpFormatUInt64(jsonBuf->lst, *((uint64_t *)row[i]));
+          break;
+        case TSDB_DATA_TYPE_FLOAT:
+          restCsvDouble(jsonBuf, GET_FLOAT_VAL(row[i]), 5);
+          break;
+        case TSDB_DATA_TYPE_DOUBLE:
+          restCsvDouble(jsonBuf, GET_DOUBLE_VAL(row[i]), 9);
+          break;
+        case TSDB_DATA_TYPE_BINARY:
+        case TSDB_DATA_TYPE_NCHAR:
+        case TSDB_DATA_TYPE_JSON:
+          restCsvString(jsonBuf, (char *)row[i], length[i]);
+          break;
+        case TSDB_DATA_TYPE_TIMESTAMP:
+          if (timestampFormat == REST_TIMESTAMP_FMT_TIMESTAMP) {
+            jsonBuf->lst += httpFormatInt64(jsonBuf->lst, *((int64_t *)row[i]));
+          } else {
+            jsonBuf->lst += httpFormatTimestamp(jsonBuf, jsonBuf->lst, *((int64_t *)row[i]), precision,
+                                                timestampFormat == REST_TIMESTAMP_FMT_UTC_STRING);
+          }
+          break;
+        default:
+          break;
+      }
+    }
+
+    httpJsonTestBuf(jsonBuf, 2);
+    *jsonBuf->lst++ = '\n';
+    cmd->numOfRows++;
+
+    if (pContext->fd <= 0) {
+      httpError("context:%p, fd:%d, user:%s, conn closed, abort retrieve", pContext, pContext->fd, pContext->user);
+      return false;
+    }
+
+    if (cmd->numOfRows >= tsRestRowLimit) {
+      httpDebug("context:%p, fd:%d, user:%s, retrieve rows:%d larger than limit:%d, abort retrieve", pContext,
+                pContext->fd, pContext->user, cmd->numOfRows, tsRestRowLimit);
+      return false;
+    }
+  }
+
+  httpDebug("context:%p, fd:%d, user:%s, retrieved row:%d", pContext, pContext->fd, pContext->user, cmd->numOfRows);
+  return true;
+}
+
+bool restBuildSqlTimestampCsv(HttpContext *pContext, HttpSqlCmd *cmd, TAOS_RES *result, int32_t numOfRows) {
+  return restBuildSqlCsv(pContext, cmd, result, numOfRows, REST_TIMESTAMP_FMT_TIMESTAMP);
+}
+
+bool restBuildSqlLocalTimeStringCsv(HttpContext *pContext, HttpSqlCmd *cmd, TAOS_RES *result, int32_t numOfRows) {
+  return restBuildSqlCsv(pContext, cmd, result, numOfRows, REST_TIMESTAMP_FMT_LOCAL_STRING);
+}
+
+bool restBuildSqlUtcTimeStringCsv(HttpContext *pContext, HttpSqlCmd *cmd, TAOS_RES *result, int32_t numOfRows) {
+  return restBuildSqlCsv(pContext, cmd, result, numOfRows, REST_TIMESTAMP_FMT_UTC_STRING);
+}
+
+void restStopSqlCsv(HttpContext *pContext, HttpSqlCmd *cmd) {
+  JsonBuf *jsonBuf = httpMallocJsonBuf(pContext);
+  if (jsonBuf == NULL) return;
+
+  httpWriteJsonBufEnd(jsonBuf);
+}
@@ -19,6 +19,8 @@
 #include "httpLog.h"
 #include "httpRestHandle.h"
 #include "httpRestJson.h"
+#include "httpRestCsv.h"
+#include "httpRestArrow.h"
 #include "tglobal.h"
 
 static HttpDecodeMethod restDecodeMethod = {"rest", restProcessRequest};
@@ -56,6 +58,51 @@ static HttpEncodeMethod restEncodeSqlUtcTimeStringMethod = {
   .setNextCmdFp         = NULL
 };
 
+static HttpEncodeMethod restEncodeSqlTimestampCsvMethod = {
+  .startJsonFp          = restStartSqlCsv,
+  .stopJsonFp           = restStopSqlCsv,
+  .buildQueryJsonFp     = restBuildSqlTimestampCsv,
+  .buildAffectRowJsonFp = restBuildSqlAffectRowsCsv,
+  .initJsonFp           = NULL,
+  .cleanJsonFp          = NULL,
+  .checkFinishedFp      = NULL,
+  .setNextCmdFp         = NULL
+};
+
+static HttpEncodeMethod restEncodeSqlLocalTimeStringCsvMethod = {
+  .startJsonFp          = restStartSqlCsv,
+  .stopJsonFp           = restStopSqlCsv,
+  .buildQueryJsonFp     = restBuildSqlLocalTimeStringCsv,
+  .buildAffectRowJsonFp = restBuildSqlAffectRowsCsv,
+  .initJsonFp           = NULL,
+  .cleanJsonFp          = NULL,
+  .checkFinishedFp      = NULL,
+  .setNextCmdFp         = NULL
+};
+
+static HttpEncodeMethod restEncodeSqlUtcTimeStringCsvMethod = {
+  .startJsonFp          = restStartSqlCsv,
+  .stopJsonFp           = restStopSqlCsv,
+  .buildQueryJsonFp     = restBuildSqlUtcTimeStringCsv,
+  .buildAffectRowJsonFp = restBuildSqlAffectRowsCsv,
+  .initJsonFp           = NULL,
+  .cleanJsonFp          = NULL,
+  .checkFinishedFp      = NULL,
+  .setNextCmdFp         = NULL
+};
+
+// the timestamps are the epoch values in arrow whatever the url asks
+static HttpEncodeMethod restEncodeSqlArrowMethod = {
+  .startJsonFp          = restStartSqlArrow,
+  .stopJsonFp           = restStopSqlArrow,
+  .buildQueryJsonFp     = restBuildSqlArrow,
+  .buildAffectRowJsonFp = restBuildSqlAffectRowsArrow,
+  .initJsonFp           = NULL,
+  .cleanJsonFp          = NULL,
+  .checkFinishedFp      = NULL,
+  .setNextCmdFp         = NULL
+};
+
 void restInitHandle(HttpServer* pServer) {
   httpAddMethod(pServer, &restDecodeMethod);
   httpAddMethod(pServer, &restDecodeMethod2);
@@ -127,7 +174,17 @@ bool restProcessSqlRequest(HttpContext* pContext, int32_t timestampFmt) {
   }
 
   pContext->reqType = HTTP_REQTYPE_SINGLE_SQL;
-  if (timestampFmt == REST_TIMESTAMP_FMT_LOCAL_STRING) {
+  if (pContext->parser->accept == HTTP_ACCEPT_ARROW) {
+    pContext->encodeMethod = &restEncodeSqlArrowMethod;
+  } else if (pContext->parser->accept == HTTP_ACCEPT_CSV) {
+    if (timestampFmt == REST_TIMESTAMP_FMT_LOCAL_STRING) {
+      pContext->encodeMethod = &restEncodeSqlLocalTimeStringCsvMethod;
+    } else if (timestampFmt == REST_TIMESTAMP_FMT_TIMESTAMP) {
+      pContext->encodeMethod = &restEncodeSqlTimestampCsvMethod;
+    } else if (timestampFmt == REST_TIMESTAMP_FMT_UTC_STRING) {
+      pContext->encodeMethod = &restEncodeSqlUtcTimeStringCsvMethod;
+    }
+  } else if (timestampFmt == REST_TIMESTAMP_FMT_LOCAL_STRING) {
     pContext->encodeMethod = &restEncodeSqlLocalTimeStringMethod;
   } else if (timestampFmt == REST_TIMESTAMP_FMT_TIMESTAMP) {
     pContext->encodeMethod = &restEncodeSqlTimestampMethod;
@@ -64,7 +64,7 @@ void restStartSqlJson(HttpContext *pContext, HttpSqlCmd *cmd, TAOS_RES *result)
   httpJsonToken(jsonBuf, JsonArrStt);
 
   SSqlObj *pObj = (SSqlObj *) result;
-  bool     isAlterSql = (pObj->sqlstr == NULL) ? false : httpCheckAlterSql(pObj->sqlstr);
+  bool     isAlterSql = (pObj == NULL || pObj->sqlstr == NULL) ? false : httpCheckAlterSql(pObj->sqlstr);
 
   if (num_fields == 0) {
     httpJsonItemToken(jsonBuf);
@@ -25,6 +25,15 @@
 #include "httpResp.h"
 #include "httpUtil.h"
 
+#ifndef _TD_NINGSI_60
+#define HTTP_EPOLL_EVENTS (EPOLLPRI | EPOLLWAKEUP | EPOLLERR | EPOLLHUP | EPOLLRDHUP)
+#else
+#define HTTP_EPOLL_EVENTS (EPOLLPRI | EPOLLERR | EPOLLHUP | EPOLLRDHUP)
+#endif
+
+// the ids of the contexts start from 1, see httpCreateContext
+#define HTTP_WAKE_EVENT_ID 0
+
 static bool httpReadData(HttpContext *pContext);
 
 #ifdef __APPLE__
@@ -94,7 +103,13 @@ static void httpStopThread(HttpThread *pThread) {
   }
 #endif  // __APPLE__
 
+  if (pThread->wakeFd != -1) {
+    taosCloseSocket(pThread->wakeFd);
+    pThread->wakeFd = -1;
+  }
+
   EpollClose(pThread->pollFd);
+  httpCleanupContextPool(pThread);
   pthread_mutex_destroy(&(pThread->threadMutex));
 }
 
@@ -116,6 +131,87 @@ void httpCleanUpConnect() {
   httpDebug("http server:%s is cleaned up", pServer->label);
 }
 
+/*
+ * The reads of a context are not watched while its request is handled, so the pipelined requests do not wake up the
+ * thread again and again. They are watched again when the response is sent, and the requests left in the parser are
+ * read then.
+ */
+static void httpWatchRead(HttpContext *pContext, bool read) {
+  HttpThread *       pThread = pContext->pThread;
+  struct epoll_event event = {0};
+
+  event.events = read ? (EPOLLIN | HTTP_EPOLL_EVENTS) : HTTP_EPOLL_EVENTS;
+  event.data.u64 = pContext->id;
+  if (epoll_ctl(pThread->pollFd, EPOLL_CTL_MOD, pContext->fd, &event) < 0) {
+    httpDebug("context:%p, fd:%d, failed to watch read:%d, error:%s", pContext, pContext->fd, read, strerror(errno));
+  }
+}
+
+/*
+ * The reference of the caller is taken over by the thread. A context queued already is not queued again, as it is in
+ * the intrusive list, and the thread which handles it afterwards sees the state changed by the caller.
+ */
+void httpResumeContext(HttpContext *pContext) {
+  HttpThread *pThread = pContext->pThread;
+  bool        wake;
+
+  pthread_mutex_lock(&pThread->threadMutex);
+  if (pContext->resumeQueued) {
+    pthread_mutex_unlock(&pThread->threadMutex);
+    httpDebug("context:%p, fd:%d, already queued to resume", pContext, pContext->fd);
+    httpReleaseContext(pContext);
+    return;
+  }
+
+  pContext->resumeQueued = 1;
+  wake = (pThread->pResumed == NULL);
+  pContext->pNext = pThread->pResumed;
+  pThread->pResumed = pContext;
+  pthread_mutex_unlock(&pThread->threadMutex);
+
+  if (wake) {
+    uint64_t one = 1;
+    if (write(pThread->wakeFd, &one, sizeof(one)) != sizeof(one)) {
+      httpDebug("%s, failed to wake up the thread, error:%s", pThread->label, strerror(errno));
+    }
+  }
+}
+
+static void httpProcessResumedContexts(HttpThread *pThread) {
+  HttpServer * pServer = &tsHttpServer;
+  HttpContext *pContext;
+
+  pthread_mutex_lock(&pThread->threadMutex);
+  pContext = pThread->pResumed;
+  pThread->pResumed = NULL;
+  pthread_mutex_unlock(&pThread->threadMutex);
+
+  while (pContext != NULL) {
+    pthread_mutex_lock(&pThread->threadMutex);
+    HttpContext *pNext = pContext->pNext;
+    pContext->pNext = NULL;
+    pContext->resumeQueued = 0;
+    pthread_mutex_unlock(&pThread->threadMutex);
+
+    if (pContext->state != HTTP_CONTEXT_STATE_READY) {
+      httpReleaseContext(pContext);
+    } else {
+      httpWatchRead(pContext, true);
+      if (pContext->parser->pending.pos == 0) {
+        httpReleaseContext(pContext);
+      } else if (pServer->status != HTTP_SERVER_RUNNING) {
+        httpSendErrorResp(pContext, TSDB_CODE_HTTP_SERVER_OFFLINE);
+        httpNotifyContextClose(pContext);
+      } else if (httpReadData(pContext)) {
+        (*(pThread->processData))(pContext);
+        atomic_fetch_add_64(&pServer->requestNum, 1);
+      }
+    }
+
+    pContext = pNext;
+  }
+}
+
 static void httpProcessHttpData(void *param) {
   HttpServer * pServer = &tsHttpServer;
   HttpThread * pThread = (HttpThread *)param;
@@ -133,9 +229,15 @@ static void httpProcessHttpData(void *param) {
       httpDebug("%p, http thread get stop event, exiting...", pThread);
       break;
     }
-    if (fdNum <= 0) continue;
 
     for (int32_t i = 0; i < fdNum; ++i) {
+      if (events[i].data.u64 == HTTP_WAKE_EVENT_ID) {
+        uint64_t count;
+        if (read(pThread->wakeFd, &count, sizeof(count)) < 0) {
+          httpDebug("%s, failed to read wake event, error:%s", pThread->label, strerror(errno));
+        }
+        continue;
+      }
 #ifdef __APPLE__
       if (events[i].data.ptr == &sv_dummy) {
         // no need to drain the recv buffer of sv[0]
@@ -145,9 +247,9 @@ static void httpProcessHttpData(void *param) {
         continue;
       }
 #endif // __APPLE__
-      pContext = httpGetContext(events[i].data.ptr);
+      pContext = httpGetContext(events[i].data.u64);
       if (pContext == NULL) {
-        httpError("context:%p, is already released, close connect", events[i].data.ptr);
+        httpError("context id:%" PRIu64 ", is already released, close connect", events[i].data.u64);
         // epoll_ctl(pThread->pollFd, EPOLL_CTL_DEL, events[i].data.fd, NULL);
         // taosClose(events[i].data.fd);
         continue;
@@ -200,6 +302,9 @@ static void httpProcessHttpData(void *param) {
         }
       }
     }
+
+    // after the wake event is read, so the contexts resumed later wake up the thread again
+    httpProcessResumedContexts(pThread);
   }
 }
 
@@ -263,7 +368,7 @@ static void *httpAcceptHttpConnection(void *arg) {
     // pick up the thread to handle this connection
     pThread = pServer->pThreads + threadId;
 
-    pContext = httpCreateContext(connFd);
+    pContext = httpCreateContext(pThread, connFd);
     if (pContext == NULL) {
       httpError("fd:%d, ip:%s:%u, no enough resource to allocate http context", connFd,
                 taosInetNtoa(clientAddr.sin_addr), htons(clientAddr.sin_port));
@@ -271,16 +376,11 @@ static void *httpAcceptHttpConnection(void *arg) {
       continue;
     }
 
-    pContext->pThread = pThread;
     sprintf(pContext->ipstr, "%s:%u", taosInetNtoa(clientAddr.sin_addr), htons(clientAddr.sin_port));
 
     struct epoll_event event;
-#ifndef _TD_NINGSI_60    
-    event.events = EPOLLIN | EPOLLPRI | EPOLLWAKEUP | EPOLLERR | EPOLLHUP | EPOLLRDHUP;
-#else
-    event.events = EPOLLIN | EPOLLPRI | EPOLLERR | EPOLLHUP | EPOLLRDHUP;
-#endif    
-    event.data.ptr = pContext;
+    event.events = EPOLLIN | HTTP_EPOLL_EVENTS;
+    event.data.u64 = pContext->id;
     if (epoll_ctl(pThread->pollFd, EPOLL_CTL_ADD, connFd, &event) < 0) {
       httpError("context:%p, fd:%d, ip:%s, thread:%s, failed to add http fd for epoll, error:%s", pContext, connFd,
                 pContext->ipstr, pThread->label, strerror(errno));
@@ -316,6 +416,7 @@ bool httpInitConnect() {
     sprintf(pThread->label, "%s%d", pServer->label, i);
     pThread->processData = pServer->processData;
     pThread->threadId = i;
+    pThread->wakeFd = -1;
 
     if (pthread_mutex_init(&(pThread->threadMutex), NULL) < 0) {
       httpError("http thread:%s, failed to init HTTP process data mutex, reason:%s", pThread->label, strerror(errno));
@@ -329,6 +430,26 @@ bool httpInitConnect() {
       return false;
     }
 
+    // the resumed contexts are not read till the thread is waked up
+    pThread->wakeFd = (int32_t)eventfd(0, EFD_NONBLOCK);
+    if (pThread->wakeFd == -1) {
+      httpError("http thread:%s, failed to create wake fd, error:%s", pThread->label, strerror(errno));
+      EpollClose(pThread->pollFd);
+      pthread_mutex_destroy(&(pThread->threadMutex));
+      return false;
+    }
+
+    struct epoll_event event = {.events = EPOLLIN};
+    event.data.u64 = HTTP_WAKE_EVENT_ID;
+    if (epoll_ctl(pThread->pollFd, EPOLL_CTL_ADD, pThread->wakeFd, &event) < 0) {
+      httpError("http thread:%s, failed to add wake fd for epoll, error:%s", pThread->label, strerror(errno));
+      taosCloseSocket(pThread->wakeFd);
+      pThread->wakeFd = -1;
+      EpollClose(pThread->pollFd);
+      pthread_mutex_destroy(&(pThread->threadMutex));
+      return false;
+    }
+
     pthread_attr_t thattr;
     pthread_attr_init(&thattr);
     pthread_attr_setdetachstate(&thattr, PTHREAD_CREATE_JOINABLE);
@@ -375,11 +496,13 @@ static bool httpReadData(HttpContext *pContext) {
   char buf[HTTP_STEP_SIZE + 1] = {0};
 
   while (1) {
-    int32_t nread = (int32_t)taosReadSocket(pContext->fd, buf, HTTP_STEP_SIZE);
+    // the pipelined requests read before are parsed first
+    char *  data = (pParser->pending.pos > 0) ? pParser->pending.str : buf;
+    int32_t nread = (data != buf) ? pParser->pending.pos : (int32_t)taosReadSocket(pContext->fd, buf, HTTP_STEP_SIZE);
     if (nread > 0) {
-      buf[nread] = '\0';
-      httpTraceL("context:%p, fd:%d, nread:%d content:%s", pContext, pContext->fd, nread, buf);
-      int32_t ok = httpParseBuf(pParser, buf, nread);
+      data[nread] = '\0';
+      httpTraceL("context:%p, fd:%d, nread:%d content:%s", pContext, pContext->fd, nread, data);
+      int32_t ok = httpParseBuf(pParser, data, nread);
 
       if (ok) {
         httpError("context:%p, fd:%d, parse failed, ret:%d code:%d close connect", pContext, pContext->fd, ok,
@@ -397,10 +520,18 @@ static bool httpReadData(HttpContext *pContext) {
       }
 
       if (!pParser->parsed) {
+        // the reads are watched again when the body handler resumes the context
+        if (atomic_load_8(&pContext->readPaused)) {
+          httpDebug("context:%p, fd:%d, read is paused by the body handler", pContext, pContext->fd);
+          httpWatchRead(pContext, false);
+          httpReleaseContext(pContext/*, false */);
+          return false;
+        }
         httpTrace("context:%p, fd:%d, read not finished", pContext, pContext->fd);
         continue;
       } else {
         httpDebug("context:%p, fd:%d, bodyLen:%d", pContext, pContext->fd, pParser->body.pos);
+        httpWatchRead(pContext, false);
         return true;
       }
     } else if (nread < 0) {
@@ -23,6 +23,14 @@
 #include "httpContext.h"
 #include "httpSession.h"
 
+// the schemaless connections insert into the database of the url, they are not shared with the others
+static int32_t httpGetSessionId(HttpContext *pContext, char *sessionId) {
+  if (pContext->reqType == HTTP_REQTYPE_SCHEMALESS) {
+    return snprintf(sessionId, HTTP_SESSION_ID_LEN, "%s.%s/%s", pContext->user, pContext->pass, pContext->db);
+  }
+  return snprintf(sessionId, HTTP_SESSION_ID_LEN, "%s.%s", pContext->user, pContext->pass);
+}
+
 void httpCreateSession(HttpContext *pContext, void *taos) {
   HttpServer *server = &tsHttpServer;
   httpReleaseSession(pContext);
@@ -33,7 +41,7 @@ void httpCreateSession(HttpContext *pContext, void *taos) {
   memset(&session, 0, sizeof(HttpSession));
   session.taos = taos;
   session.refCount = 1;
-  int32_t len = snprintf(session.id, HTTP_SESSION_ID_LEN, "%s.%s", pContext->user, pContext->pass);
+  int32_t len = httpGetSessionId(pContext, session.id);
 
   pContext->session =
       taosCachePut(server->sessionCache, session.id, len, &session, sizeof(HttpSession), tsHttpSessionExpire * 1000);
@@ -58,7 +66,7 @@ static void httpFetchSessionImp(HttpContext *pContext) {
   pthread_mutex_lock(&server->serverMutex);
 
   char    sessionId[HTTP_SESSION_ID_LEN];
-  int32_t len = snprintf(sessionId, HTTP_SESSION_ID_LEN, "%s.%s", pContext->user, pContext->pass);
+  int32_t len = httpGetSessionId(pContext, sessionId);
 
   pContext->session = taosCacheAcquireByKey(server->sessionCache, sessionId, len);
   if (pContext->session != NULL) {
@@ -76,8 +84,6 @@ void httpGetSession(HttpContext *pContext) {
   if (pContext->session == NULL) {
     httpFetchSessionImp(pContext);
   } else {
-    char sessionId[HTTP_SESSION_ID_LEN];
-    snprintf(sessionId, HTTP_SESSION_ID_LEN, "%s.%s", pContext->user, pContext->pass);
     httpReleaseSession(pContext);
     httpFetchSessionImp(pContext);
   }
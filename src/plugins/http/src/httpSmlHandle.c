@@ -0,0 +1,601 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _DEFAULT_SOURCE
+#include "os.h"
+#include "taos.h"
+#include "taoserror.h"
+#include "httpLog.h"
+#include "httpInt.h"
+#include "httpContext.h"
+#include "httpSession.h"
+#include "httpQueue.h"
+#include "httpRestJson.h"
+#include "httpServer.h"
+#include "httpSmlHandle.h"
+
+/*
+ * the schemaless endpoints take the points in the body and insert them through the schemaless interface, which
+ * writes them into the submit blocks directly instead of rendering sql:
+ *
+ *   POST /schemaless/line/<db>[?precision=ns|us|ms|s|m|h]    influxdb line protocol
+ *   POST /schemaless/telnet/<db>                             opentsdb telnet protocol
+ *   POST /schemaless/json/<db>                               opentsdb json objects, or arrays of them
+ *
+ * the body is not buffered as a whole, the complete lines or json objects are inserted by batches while the rest
+ * of the body is still being received. The batches are inserted by the result workers one at a time, the http thread
+ * keeps receiving the body meanwhile, and stops reading the connection if the next batch is ready before the last
+ * one is inserted.
+ */
+
+typedef struct HttpSmlWriter {
+  pthread_mutex_t mutex;  // guards the state shared with the result worker, from inserting to code
+  int8_t  inserting;    // a batch is being inserted by a result worker
+  int8_t  finished;     // the whole body is received, the rest is inserted after the batch being inserted
+  int32_t code;         // the first failure, the rest of the body is discarded after it
+  char *  pending;      // the batch being inserted
+  int32_t pendingLen;
+  int8_t  protocol;
+  int8_t  connected;
+  int8_t  inString;     // the json scanner is in a string
+  int8_t  escaped;      // the json scanner is after a backslash in a string
+  int8_t  inArray;      // the json scanner is in the top level array of the points
+  int32_t precision;
+  int32_t depth;        // the nesting level of the json scanner
+  int32_t unitStart;    // the start of the json object being scanned, -1 if it is between the objects
+  int32_t scanned;      // the bytes of the buffer scanned already
+  int64_t affectedRows;
+  char *  buf;          // the received body not inserted yet
+  int32_t len;
+  int32_t size;
+  char *  batch;        // the complete json objects wrapped into an array
+  int32_t batchLen;
+  int32_t batchSize;
+  char ** lines;
+  int32_t maxLines;
+} HttpSmlWriter;
+
+static HttpDecodeMethod smlDecodeMethod = {"schemaless", smlProcessRequest, smlProcessBody};
+static HttpEncodeMethod smlEncodeMethod = {
+  .startJsonFp          = restStartSqlJson,
+  .stopJsonFp           = restStopSqlJson,
+  .buildQueryJsonFp     = NULL,
+  .buildAffectRowJsonFp = restBuildSqlAffectRowsJson,
+  .initJsonFp           = NULL,
+  .cleanJsonFp          = NULL,
+  .checkFinishedFp      = NULL,
+  .setNextCmdFp         = NULL
+};
+
+void smlInitHandle(HttpServer *pServer) { httpAddMethod(pServer, &smlDecodeMethod); }
+
+static int32_t smlReserve(char **buf, int32_t *size, int32_t need) {
+  if (need <= *size) return 0;
+
+  int32_t newSize = MAX(*size * 2, need);
+  newSize = MAX(newSize, HTTP_BUFFER_INIT);
+  char *  newBuf = realloc(*buf, newSize);
+  if (newBuf == NULL) return -1;
+
+  *buf = newBuf;
+  *size = newSize;
+  return 0;
+}
+
+static int32_t smlGetPrecision(char *query, int32_t *precision) {
+  *precision = TSDB_SML_TIMESTAMP_NOT_CONFIGURED;
+
+  char *param = query;
+  while (param != NULL && *param != 0) {
+    char *next = strchr(param, '&');
+    if (next != NULL) *next++ = 0;
+
+    if (strncmp(param, "precision=", 10) == 0) {
+      char *val = param + 10;
+      if (strcmp(val, "ns") == 0 || strcmp(val, "n") == 0) {
+        *precision = TSDB_SML_TIMESTAMP_NANO_SECONDS;
+      } else if (strcmp(val, "us") == 0 || strcmp(val, "u") == 0) {
+        *precision = TSDB_SML_TIMESTAMP_MICRO_SECONDS;
+      } else if (strcmp(val, "ms") == 0) {
+        *precision = TSDB_SML_TIMESTAMP_MILLI_SECONDS;
+      } else if (strcmp(val, "s") == 0) {
+        *precision = TSDB_SML_TIMESTAMP_SECONDS;
+      } else if (strcmp(val, "m") == 0) {
+        *precision = TSDB_SML_TIMESTAMP_MINUTES;
+      } else if (strcmp(val, "h") == 0) {
+        *precision = TSDB_SML_TIMESTAMP_HOURS;
+      } else {
+        return TSDB_CODE_TSC_INVALID_PRECISION_TYPE;
+      }
+    }
+
+    param = next;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t smlCreateWriter(HttpContext *pContext) {
+  HttpParser *pParser = pContext->parser;
+  if (strlen(pContext->user) == 0 || strlen(pContext->pass) == 0) {
+    return TSDB_CODE_HTTP_NO_AUTH_INFO;
+  }
+
+  int8_t protocol;
+  char * name = pParser->path[SML_PROTOCOL_URL_POS].str;
+  if (name == NULL) {
+    return TSDB_CODE_HTTP_INVALID_URL;
+  } else if (strcmp(name, "line") == 0) {
+    protocol = TSDB_SML_LINE_PROTOCOL;
+  } else if (strcmp(name, "telnet") == 0) {
+    protocol = TSDB_SML_TELNET_PROTOCOL;
+  } else if (strcmp(name, "json") == 0) {
+    protocol = TSDB_SML_JSON_PROTOCOL;
+  } else {
+    return TSDB_CODE_TSC_INVALID_PROTOCOL_TYPE;
+  }
+
+  // the database may be followed by the query string
+  char *db = pParser->path[SML_DB_URL_POS].str;
+  if (db == NULL) {
+    return TSDB_CODE_HTTP_TG_DB_NOT_INPUT;
+  }
+
+  char *query = strchr(db, '?');
+  if (query != NULL) *query++ = 0;
+
+  int32_t dbLen = (int32_t)strlen(db);
+  if (dbLen == 0) {
+    return TSDB_CODE_HTTP_TG_DB_NOT_INPUT;
+  }
+  if (dbLen >= TSDB_DB_NAME_LEN) {
+    return TSDB_CODE_HTTP_TG_DB_TOO_LONG;
+  }
+
+  int32_t precision;
+  int32_t code = smlGetPrecision(query, &precision);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  HttpSmlWriter *pWriter = calloc(1, sizeof(HttpSmlWriter));
+  if (pWriter == NULL) {
+    return TSDB_CODE_HTTP_NO_ENOUGH_MEMORY;
+  }
+
+  pthread_mutex_init(&pWriter->mutex, NULL);
+  pWriter->protocol = protocol;
+  pWriter->precision = precision;
+  pWriter->unitStart = -1;
+
+  tstrncpy(pContext->db, db, TSDB_DB_NAME_LEN);
+  pContext->reqType = HTTP_REQTYPE_SCHEMALESS;
+  pContext->smlWriter = pWriter;
+
+  httpDebug("context:%p, fd:%d, user:%s, db:%s, schemaless protocol:%d precision:%d", pContext, pContext->fd,
+            pContext->user, pContext->db, protocol, precision);
+  return TSDB_CODE_SUCCESS;
+}
+
+void smlFreeWriter(HttpContext *pContext) {
+  HttpSmlWriter *pWriter = pContext->smlWriter;
+  if (pWriter == NULL) return;
+
+  pthread_mutex_destroy(&pWriter->mutex);
+  tfree(pWriter->pending);
+  tfree(pWriter->buf);
+  tfree(pWriter->batch);
+  tfree(pWriter->lines);
+  tfree(pContext->smlWriter);
+}
+
+// the batches are inserted by the result workers one at a time, the session is fetched or created here
+static TAOS *smlGetConnection(HttpContext *pContext, HttpSmlWriter *pWriter, int32_t *code) {
+  if (!pWriter->connected) {
+    httpGetSession(pContext);
+    if (pContext->session == NULL) {
+      TAOS *taos = taos_connect(NULL, pContext->user, pContext->pass, pContext->db, 0);
+      if (taos == NULL) {
+        *code = terrno;
+        return NULL;
+      }
+
+      httpCreateSession(pContext, taos);
+      if (pContext->session == NULL) {
+        *code = TSDB_CODE_HTTP_SESSION_FULL;
+        return NULL;
+      }
+    }
+
+    pWriter->connected = 1;
+  }
+
+  return pContext->session->taos;
+}
+
+static int32_t smlInsert(HttpContext *pContext, HttpSmlWriter *pWriter, char **lines, int32_t numOfLines) {
+  int32_t code = TSDB_CODE_SUCCESS;
+  TAOS *  taos = smlGetConnection(pContext, pWriter, &code);
+  if (taos == NULL) {
+    httpError("context:%p, fd:%d, user:%s, db:%s, failed to connect, code:%s", pContext, pContext->fd, pContext->user,
+              pContext->db, tstrerror(code));
+    return code;
+  }
+
+  TAOS_RES *result = taos_schemaless_insert(taos, lines, numOfLines, pWriter->protocol, pWriter->precision);
+  code = taos_errno(result);
+  if (code == TSDB_CODE_SUCCESS) {
+    pWriter->affectedRows += taos_affected_rows(result);
+  } else {
+    httpError("context:%p, fd:%d, user:%s, db:%s, failed to insert %d lines, code:%s", pContext, pContext->fd,
+              pContext->user, pContext->db, numOfLines, tstrerror(code));
+  }
+
+  taos_free_result(result);
+  return code;
+}
+
+// the batch is a json array, or the lines separated by line feeds, the buffer of which has one more byte
+static int32_t smlInsertBatch(HttpContext *pContext, HttpSmlWriter *pWriter, char *batch, int32_t len) {
+  if (pWriter->protocol == TSDB_SML_JSON_PROTOCOL) {
+    return smlInsert(pContext, pWriter, &batch, 1);
+  }
+
+  if (pWriter->lines == NULL) {
+    pWriter->maxLines = SML_MAX_LINES;
+    pWriter->lines = malloc(pWriter->maxLines * sizeof(char *));
+    if (pWriter->lines == NULL) {
+      return TSDB_CODE_HTTP_NO_ENOUGH_MEMORY;
+    }
+  }
+
+  int32_t numOfLines = 0;
+  char *  p = batch;
+  char *  end = batch + len;
+  while (p < end) {
+    char *lf = memchr(p, '\n', end - p);
+    if (lf == NULL) lf = end;
+
+    char *e = lf;
+    *e = 0;
+    if (e > p && e[-1] == '\r') *--e = 0;
+    while (p < e && (*p == ' ' || *p == '\t')) ++p;
+
+    // the empty lines and the comments are skipped
+    if (p < e && *p != '#') {
+      pWriter->lines[numOfLines++] = p;
+      if (numOfLines == pWriter->maxLines) {
+        int32_t code = smlInsert(pContext, pWriter, pWriter->lines, numOfLines);
+        if (code != TSDB_CODE_SUCCESS) return code;
+        numOfLines = 0;
+      }
+    }
+
+    p = lf + 1;
+  }
+
+  if (numOfLines > 0) {
+    return smlInsert(pContext, pWriter, pWriter->lines, numOfLines);
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static void smlTakeLines(HttpSmlWriter *pWriter, bool final, char **batch, int32_t *len) {
+  // the lines are taken up to the last line feed, the partial line is kept for the next piece of the body
+  int32_t stop = pWriter->len;
+  if (stop == 0) return;
+  if (!final) {
+    while (stop > pWriter->scanned && pWriter->buf[stop - 1] != '\n') --stop;
+    if (stop == pWriter->scanned) {
+      pWriter->scanned = pWriter->len;
+      return;
+    }
+  }
+
+  // the buffer goes with the lines, the partial line is moved into a new one
+  char *rest = malloc(pWriter->size);
+  if (rest == NULL) {
+    pWriter->code = TSDB_CODE_HTTP_NO_ENOUGH_MEMORY;
+    return;
+  }
+
+  memcpy(rest, pWriter->buf + stop, pWriter->len - stop);
+  *batch = pWriter->buf;
+  *len = stop;
+
+  pWriter->buf = rest;
+  pWriter->len -= stop;
+  pWriter->scanned = pWriter->len;
+}
+
+static void smlAppendJson(HttpSmlWriter *pWriter, int32_t start, int32_t end) {
+  // one more byte for the comma or the bracket ahead, and two for the closing bracket and the terminating 0
+  if (smlReserve(&pWriter->batch, &pWriter->batchSize, pWriter->batchLen + end - start + 3) != 0) {
+    pWriter->code = TSDB_CODE_HTTP_NO_ENOUGH_MEMORY;
+    return;
+  }
+
+  pWriter->batch[pWriter->batchLen] = (pWriter->batchLen == 0) ? '[' : ',';
+  pWriter->batchLen++;
+  memcpy(pWriter->batch + pWriter->batchLen, pWriter->buf + start, end - start);
+  pWriter->batchLen += end - start;
+}
+
+/*
+ * the body is a sequence of json objects and arrays of them, every complete object is copied into the batch
+ * as an element of an array, which is taken once it is big enough
+ */
+static void smlTakeJson(HttpSmlWriter *pWriter, bool final, char **batch, int32_t *len) {
+  char *  buf = pWriter->buf;
+  int32_t consumed = 0;
+  int32_t pos = pWriter->scanned;
+
+  for (; pos < pWriter->len && pWriter->code == TSDB_CODE_SUCCESS && pWriter->batchLen < SML_FLUSH_SIZE; ++pos) {
+    char c = buf[pos];
+
+    if (pWriter->unitStart >= 0) {
+      if (pWriter->inString) {
+        if (pWriter->escaped) {
+          pWriter->escaped = 0;
+        } else if (c == '\\') {
+          pWriter->escaped = 1;
+        } else if (c == '"') {
+          pWriter->inString = 0;
+        }
+      } else if (c == '"') {
+        pWriter->inString = 1;
+      } else if (c == '{' || c == '[') {
+        pWriter->depth++;
+      } else if (c == '}' || c == ']') {
+        if (--pWriter->depth == pWriter->inArray) {
+          smlAppendJson(pWriter, pWriter->unitStart, pos + 1);
+          pWriter->unitStart = -1;
+          consumed = pos + 1;
+        }
+      }
+      continue;
+    }
+
+    if (c == '{') {
+      pWriter->unitStart = pos;
+      pWriter->depth++;
+      continue;
+    }
+
+    if (c == '[' && !pWriter->inArray) {
+      pWriter->inArray = 1;
+      pWriter->depth = 1;
+    } else if (c == ']' && pWriter->inArray) {
+      pWriter->inArray = 0;
+      pWriter->depth = 0;
+    } else if (c != ',' && !isspace((unsigned char)c)) {
+      pWriter->code = TSDB_CODE_TSC_INVALID_JSON;
+    }
+    consumed = pos + 1;
+  }
+
+  if (pWriter->code != TSDB_CODE_SUCCESS) return;
+
+  pWriter->len -= consumed;
+  memmove(buf, buf + consumed, pWriter->len);
+  pWriter->scanned = pos - consumed;
+  if (pWriter->unitStart >= 0) pWriter->unitStart -= consumed;
+
+  bool whole = final && pWriter->scanned == pWriter->len;
+  if (whole && (pWriter->unitStart >= 0 || pWriter->inArray)) {
+    pWriter->code = TSDB_CODE_TSC_INVALID_JSON;
+    return;
+  }
+
+  if (pWriter->batchLen == 0 || (!whole && pWriter->batchLen < SML_FLUSH_SIZE)) return;
+
+  pWriter->batch[pWriter->batchLen++] = ']';
+  pWriter->batch[pWriter->batchLen] = 0;
+  *batch = pWriter->batch;
+  *len = pWriter->batchLen;
+
+  pWriter->batch = NULL;
+  pWriter->batchLen = 0;
+  pWriter->batchSize = 0;
+}
+
+// the batch to insert next, which is NULL if the points received are not enough
+static char *smlTakeBatch(HttpContext *pContext, HttpSmlWriter *pWriter, bool final, int32_t *len) {
+  char *batch = NULL;
+  if (pWriter->protocol == TSDB_SML_JSON_PROTOCOL) {
+    smlTakeJson(pWriter, final, &batch, len);
+  } else {
+    smlTakeLines(pWriter, final, &batch, len);
+  }
+
+  // a single point can not take more than the buffer of a whole request
+  if (pWriter->code == TSDB_CODE_SUCCESS && pWriter->len >= HTTP_BUFFER_SIZE) {
+    httpError("context:%p, fd:%d, user:%s, point exceeds buffer size %d", pContext, pContext->fd, pContext->user,
+              HTTP_BUFFER_SIZE);
+    pWriter->code = TSDB_CODE_HTTP_REQUSET_TOO_BIG;
+  }
+
+  if (pWriter->code != TSDB_CODE_SUCCESS) {
+    pWriter->len = 0;
+    pWriter->scanned = 0;
+    tfree(batch);
+  }
+
+  return batch;
+}
+
+static void smlProcessCmdImp(void *param, TAOS_RES *unUsed, int32_t unUsedCode, int32_t unUsedRows);
+
+/*
+ * the batch is inserted by a result worker, which holds a reference of the context. The reads paused meanwhile are
+ * resumed by the http thread, and the rest of the body is inserted here if it is received already. A context is
+ * queued to resume only once: if the whole body is received, it is resumed by the reply instead of here.
+ */
+static void smlInsertBatchImp(void *param, TAOS_RES *unUsed, int32_t unUsedCode, int32_t unUsedRows) {
+  HttpContext *  pContext = param;
+  HttpSmlWriter *pWriter = pContext->smlWriter;
+
+  int32_t code = smlInsertBatch(pContext, pWriter, pWriter->pending, pWriter->pendingLen);
+
+  pthread_mutex_lock(&pWriter->mutex);
+  tfree(pWriter->pending);
+  pWriter->pendingLen = 0;
+  pWriter->inserting = 0;
+  if (pWriter->code == TSDB_CODE_SUCCESS) pWriter->code = code;
+  bool finished = pWriter->finished;
+  bool paused = pContext->readPaused;
+  pContext->readPaused = 0;
+  pthread_mutex_unlock(&pWriter->mutex);
+
+  if (paused && !finished) {
+    httpResumeContext(pContext);
+  } else {
+    httpReleaseContext(pContext);
+  }
+
+  if (finished) {
+    smlProcessCmdImp(pContext, NULL, TSDB_CODE_SUCCESS, 0);
+  }
+}
+
+static void smlInsertAsync(HttpContext *pContext, HttpSmlWriter *pWriter, char *batch, int32_t len) {
+  if (httpGetContext(pContext->id) == NULL) {
+    free(batch);
+    return;
+  }
+
+  pthread_mutex_lock(&pWriter->mutex);
+  pWriter->pending = batch;
+  pWriter->pendingLen = len;
+  pWriter->inserting = 1;
+  pthread_mutex_unlock(&pWriter->mutex);
+
+  httpTrace("context:%p, fd:%d, user:%s, batch of %d bytes is inserted by result workers", pContext, pContext->fd,
+            pContext->user, len);
+  httpDispatchToResultQueue(pContext, NULL, TSDB_CODE_SUCCESS, 0, smlInsertBatchImp);
+}
+
+int32_t smlProcessBody(HttpContext *pContext, const char *chunk, int32_t len) {
+  if (pContext->smlWriter == NULL) {
+    int32_t code = smlCreateWriter(pContext);
+    if (code != TSDB_CODE_SUCCESS) return code;
+  }
+
+  HttpSmlWriter *pWriter = pContext->smlWriter;
+  pthread_mutex_lock(&pWriter->mutex);
+  int32_t code = pWriter->code;
+  bool    inserting = pWriter->inserting;
+  pthread_mutex_unlock(&pWriter->mutex);
+
+  // the rest of the body is discarded after a failure, which is replied when the whole request is received
+  if (code != TSDB_CODE_SUCCESS) {
+    pWriter->len = 0;
+    pWriter->scanned = 0;
+    return TSDB_CODE_SUCCESS;
+  }
+
+  // one more byte to terminate the last line
+  if (smlReserve(&pWriter->buf, &pWriter->size, pWriter->len + len + 1) != 0) {
+    return TSDB_CODE_HTTP_NO_ENOUGH_MEMORY;
+  }
+
+  memcpy(pWriter->buf + pWriter->len, chunk, len);
+  pWriter->len += len;
+
+  // the connection is not read till the batch is inserted, if the next one is received already
+  if (inserting) {
+    if (pWriter->len >= SML_PAUSE_SIZE) {
+      pthread_mutex_lock(&pWriter->mutex);
+      if (pWriter->inserting) pContext->readPaused = 1;
+      pthread_mutex_unlock(&pWriter->mutex);
+    }
+    return TSDB_CODE_SUCCESS;
+  }
+
+  if (pWriter->len >= SML_FLUSH_SIZE) {
+    int32_t batchLen = 0;
+    char *  batch = smlTakeBatch(pContext, pWriter, false, &batchLen);
+    if (batch != NULL) {
+      smlInsertAsync(pContext, pWriter, batch, batchLen);
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+bool smlProcessRequest(HttpContext *pContext) {
+  if (pContext->smlWriter == NULL) {
+    int32_t code = smlCreateWriter(pContext);
+    if (code != TSDB_CODE_SUCCESS) {
+      httpSendErrorResp(pContext, code);
+      return false;
+    }
+  }
+
+  httpDebug("context:%p, fd:%d, user:%s, process schemaless msg, affect rows:%" PRId64 " before end", pContext,
+            pContext->fd, pContext->user, pContext->smlWriter->affectedRows);
+
+  pContext->reqType = HTTP_REQTYPE_SCHEMALESS;
+  pContext->encodeMethod = &smlEncodeMethod;
+  return true;
+}
+
+// the rest of the body is inserted by the result workers as well, after the batch being inserted if any
+static void smlProcessCmdImp(void *param, TAOS_RES *unUsed, int32_t unUsedCode, int32_t unUsedRows) {
+  HttpContext *     pContext = param;
+  HttpEncodeMethod *encode = pContext->encodeMethod;
+  HttpSmlWriter *   pWriter = pContext->smlWriter;
+
+  while (pWriter->code == TSDB_CODE_SUCCESS) {
+    int32_t len = 0;
+    char *  batch = smlTakeBatch(pContext, pWriter, true, &len);
+    if (batch == NULL) break;
+
+    pWriter->code = smlInsertBatch(pContext, pWriter, batch, len);
+    free(batch);
+  }
+
+  // the context may take the next request once replied
+  int32_t code = pWriter->code;
+  int32_t affectRows = (int32_t)MIN(pWriter->affectedRows, INT32_MAX);
+  smlFreeWriter(pContext);
+
+  if (code != TSDB_CODE_SUCCESS) {
+    httpSendErrorResp(pContext, code);
+    return;
+  }
+
+  httpDebug("context:%p, fd:%d, user:%s, db:%s, schemaless affect rows:%d", pContext, pContext->fd, pContext->user,
+            pContext->db, affectRows);
+
+  (encode->startJsonFp)(pContext, &pContext->singleCmd, NULL);
+  (encode->buildAffectRowJsonFp)(pContext, &pContext->singleCmd, affectRows);
+  (encode->stopJsonFp)(pContext, &pContext->singleCmd);
+  httpCloseContextByApp(pContext);
+}
+
+void smlProcessCmd(HttpContext *pContext) {
+  HttpSmlWriter *pWriter = pContext->smlWriter;
+
+  pthread_mutex_lock(&pWriter->mutex);
+  pWriter->finished = 1;
+  bool inserting = pWriter->inserting;
+  pthread_mutex_unlock(&pWriter->mutex);
+
+  if (!inserting) {
+    httpDispatchToResultQueue(pContext, NULL, TSDB_CODE_SUCCESS, 0, smlProcessCmdImp);
+  }
+}
@@ -26,6 +26,7 @@
 #include "httpAuth.h"
 #include "httpSession.h"
 #include "httpQueue.h"
+#include "httpSmlHandle.h"
 
 void httpProcessMultiSql(HttpContext *pContext);
 
@@ -418,6 +419,12 @@ void httpProcessRequestCb(void *param, TAOS_RES *result, int32_t code) {
 }
 
 void httpProcessRequest(HttpContext *pContext) {
+  // the session of a schemaless request is taken by the result workers, which insert its body
+  if (pContext->reqType == HTTP_REQTYPE_SCHEMALESS) {
+    smlProcessCmd(pContext);
+    return;
+  }
+
   httpGetSession(pContext);
 
   if (pContext->session == NULL || pContext->reqType == HTTP_REQTYPE_LOGIN) {
@@ -30,6 +30,7 @@
 #include "httpGcHandle.h"
 #include "httpRestHandle.h"
 #include "httpTgHandle.h"
+#include "httpSmlHandle.h"
 #include "httpMetricsHandle.h"
 
 #ifndef _ADMIN
@@ -52,6 +53,7 @@ int32_t httpInitSystem() {
   adminInitHandle(&tsHttpServer);
   gcInitHandle(&tsHttpServer);
   tgInitHandle(&tsHttpServer);
+  smlInitHandle(&tsHttpServer);
   opInitHandle(&tsHttpServer);
   metricsInitHandle(&tsHttpServer);
   return 0;
@@ -512,6 +512,7 @@ static void monGetSysStats() {
 
   tsMonStat.dInfo = dnodeGetStatisInfo();
   tsMonStat.vInfo = vnodeGetStatisInfo();
+  monDebug("submit latency p99:%" PRId64 "us", tsMonStat.vInfo.submitLatencyP99);
 
   tsMonStat.monQueryReqCnt = monFetchQueryReqCnt();
   tsMonStat.monSubmitReqCnt = monFetchSubmitReqCnt();
@@ -25,6 +25,54 @@
 #include "tutil.h"
 #include "tscUtil.h"
 
+typedef struct {
+  const char *words[3];
+  int32_t     numOfWords;
+  int32_t     showType;
+} SFixedShowStmt;
+
+// the show statements below are matched ahead of the generated parser, their words are not made keywords since they
+// are common names of the tables and columns
+static const SFixedShowStmt fixedShowStmts[] = {
+    {{"show", "balance", "plan"}, 3, TSDB_MGMT_TABLE_BALANCE_PLAN},
+    {{"show", "filesets"}, 2, TSDB_MGMT_TABLE_FILESET},
+};
+
+static bool qParseFixedShowStmt(const char *pStr, const SFixedShowStmt *pStmt) {
+  int32_t numOfWords = 0;
+  int32_t i = 0;
+
+  while (pStr[i] != 0) {
+    SStrToken t0 = {0};
+    t0.n = tGetToken((char *)&pStr[i], &t0.type);
+    t0.z = (char *)(pStr + i);
+    if (t0.n <= 0) return false;
+    i += t0.n;
+
+    if (t0.type == TK_SPACE || t0.type == TK_COMMENT) continue;
+    if (t0.type == TK_SEMI) break;
+
+    if (numOfWords >= pStmt->numOfWords || t0.n != (uint32_t)strlen(pStmt->words[numOfWords]) ||
+        strncasecmp(t0.z, pStmt->words[numOfWords], t0.n) != 0) {
+      return false;
+    }
+    numOfWords++;
+  }
+
+  return numOfWords == pStmt->numOfWords;
+}
+
+static bool qParseFixedShow(const char *pStr, SSqlInfo *pInfo) {
+  for (int32_t i = 0; i < (int32_t)tListLen(fixedShowStmts); ++i) {
+    if (qParseFixedShowStmt(pStr, &fixedShowStmts[i])) {
+      setShowOptions(pInfo, fixedShowStmts[i].showType, 0, 0);
+      return true;
+    }
+  }
+
+  return false;
+}
+
 SSqlInfo qSqlParse(const char *pStr) {
   void *pParser = ParseAlloc(malloc);
 
@@ -32,6 +80,10 @@ SSqlInfo qSqlParse(const char *pStr) {
   sqlInfo.valid = true;
   sqlInfo.funcs = taosArrayInit(4, sizeof(SStrToken));
 
+  if (qParseFixedShow(pStr, &sqlInfo)) {
+    goto abort_parse;
+  }
+
   int32_t i = 0;
   bool inWhere = false;
   while (1) {
@@ -454,6 +454,16 @@ int32_t qQueryCompleted(qinfo_t qinfo) {
   return isQueryKilled(pQInfo) || Q_STATUS_EQUAL(pQInfo->runtimeEnv.status, QUERY_OVER);
 }
 
+int64_t qGetQueryExecTime(qinfo_t qinfo) {
+  SQInfo *pQInfo = (SQInfo *)qinfo;
+
+  if (pQInfo == NULL || !isValidQInfo(pQInfo)) {
+    return 0;
+  }
+
+  return (int64_t)pQInfo->summary.elapsedTime;
+}
+
 void qDestroyQueryInfo(qinfo_t qHandle) {
   SQInfo* pQInfo = (SQInfo*) qHandle;
   if (!isValidQInfo(pQInfo)) {
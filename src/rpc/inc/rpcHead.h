@@ -22,6 +22,13 @@ extern "C" {
 
 #define RPC_CONN_TCP    2
 
+// compression algorithms carried in SRpcHead.comp
+#define RPC_COMP_NONE      0
+#define RPC_COMP_LZ4       1
+#define RPC_COMP_DEFLATE   2
+#define RPC_COMP_LZ4_DICT  3
+#define RPC_COMP_MASK(comp) ((uint8_t)(1u << (comp)))
+
 extern int tsRpcOverhead;
 
 typedef struct {
@@ -39,7 +46,7 @@ typedef struct {
 
 typedef struct {
   char     version:4; // RPC version
-  char     comp:4;    // compression algorithm, 0:no compression 1:lz4
+  char     comp:4;    // compression algorithm, 0:no compression 1:lz4 2:deflate 3:lz4 with dictionary
   char     resflag:2; // reserved bits
   char     spi:3;     // security parameter index
   char     encrypt:3; // encrypt algorithm, 0: no encryption
@@ -48,10 +55,10 @@ typedef struct {
   uint64_t ahandle;   // ahandle assigned by client 
   uint32_t sourceId;  // source ID, an index for connection list  
   uint32_t destId;    // destination ID, an index for connection list
-  uint32_t destIp;    // destination IP address, for NAT scenario
+  uint32_t compDict;  // ID of the sender's compression dictionary, 0 if none(the former destIp, never used)
   char     user[TSDB_UNI_LEN]; // user ID 
   uint16_t port;      // for UDP only, port may be changed
-  char     empty[1];  // reserved
+  uint8_t  compMask;  // algorithms the sender is able to decompress, 0 for legacy peers(lz4 only)
   uint8_t  msgType;   // message type  
   int32_t  msgLen;    // message length including the header iteslf
   uint32_t msgVer;
@@ -60,7 +67,7 @@ typedef struct {
 } SRpcHead;
 
 typedef struct {
-  int32_t  reserved;
+  int32_t  reserved;  // dictionary ID for RPC_COMP_LZ4_DICT, otherwise 0
   int32_t  contLen;
 } SRpcComp;
 
@@ -19,7 +19,9 @@
 #include "tmempool.h"
 #include "ttimer.h"
 #include "tutil.h"
+#define LZ4_STATIC_LINKING_ONLY
 #include "lz4.h"
+#include "zlib.h"
 #include "tref.h"
 #include "taoserror.h"
 #include "tsocket.h"
@@ -40,6 +42,10 @@
 #define rpcContLenFromMsg(msgLen) (msgLen - sizeof(SRpcHead))
 #define rpcIsReq(type) (type & 1U)
 
+#define RPC_COMP_STREAM_CHUNK  (64 * 1024)  // input chunk size for the streaming compressor
+#define RPC_COMP_DICT_MAX_SIZE (64 * 1024)  // LZ4 only references the last 64KB of a dictionary
+#define RPC_COMP_DICT_MSG_SIZE (64 * 1024)  // dictionary is only applied to messages smaller than it
+
 typedef struct {
   int      sessions;     // number of sessions allowed
   int      numOfThreads; // number of threads to process incoming messages
@@ -101,6 +107,8 @@ typedef struct SRpcConn {
   char      ckey[TSDB_KEY_LEN];   // ciphering key 
   char      secured;              // if set to 1, no authentication
   uint16_t  localPort;      // for UDP only
+  uint8_t   peerComp;       // compression algorithms accepted by peer, see SRpcHead.compMask
+  uint32_t  peerDict;       // ID of the compression dictionary of peer, see SRpcHead.compDict
   uint32_t  linkUid;        // connection unique ID assigned by client
   uint32_t  peerIp;         // peer IP
   uint16_t  peerPort;       // peer port
@@ -135,6 +143,14 @@ int tsRpcOverhead;
 
 static int     tsRpcRefId = -1;
 static int32_t tsRpcNum = 0;
+
+// compression dictionary shared by all rpc instances, loaded from compressMsgDict
+static char         *tsRpcCompDict = NULL;
+static int32_t       tsRpcCompDictSize = 0;
+static uint32_t      tsRpcCompDictId = 0;
+static LZ4_stream_t *tsRpcCompDictStream = NULL;
+static uint8_t       tsRpcCompMask = RPC_COMP_MASK(RPC_COMP_LZ4) | RPC_COMP_MASK(RPC_COMP_DEFLATE);
+static SRpcCompStat  tsRpcCompStat = {0};
 //static pthread_once_t tsRpcInit = PTHREAD_ONCE_INIT;
 
 // server:0 client:1  tcp:2 udp:0
@@ -206,8 +222,10 @@ static void  rpcProcessIdleTimer(void *param, void *tmrId);
 static void  rpcProcessProgressTimer(void *param, void *tmrId);
 
 static void  rpcFreeMsg(void *msg);
-static int32_t rpcCompressRpcMsg(char* pCont, int32_t contLen);
-static SRpcHead *rpcDecompressRpcMsg(SRpcHead *pHead);
+static int32_t rpcCompressRpcMsg(char* pCont, int32_t contLen, uint8_t peerComp, uint32_t peerDict);
+static SRpcHead *rpcDecompressRpcMsg(SRpcHead *pHead, int32_t *pCode);
+static void  rpcLoadCompDict(void);
+static void  rpcFreeCompDict(void);
 static int   rpcAddAuthPart(SRpcConn *pConn, char *msg, int msgLen);
 static int   rpcCheckAuthentication(SRpcConn *pConn, char *msg, int msgLen);
 static void  rpcLockConn(SRpcConn *pConn);
@@ -227,6 +245,7 @@ int32_t rpcInit(void) {
   tsRpcOverhead = sizeof(SRpcReqContext);
 
   tsRpcRefId = taosOpenRef(200, rpcFree);
+  rpcLoadCompDict();
 
   return 0;
 }
@@ -234,6 +253,19 @@ int32_t rpcInit(void) {
 void rpcCleanup(void) {
   taosCloseRef(tsRpcRefId);
   tsRpcRefId = -1;
+  rpcFreeCompDict();
+}
+
+void rpcGetCompStat(SRpcCompStat *pStat) {
+  pStat->compMsgs = atomic_load_64(&tsRpcCompStat.compMsgs);
+  pStat->compSkipped = atomic_load_64(&tsRpcCompStat.compSkipped);
+  pStat->compBytesIn = atomic_load_64(&tsRpcCompStat.compBytesIn);
+  pStat->compBytesOut = atomic_load_64(&tsRpcCompStat.compBytesOut);
+  pStat->compTimeUs = atomic_load_64(&tsRpcCompStat.compTimeUs);
+  pStat->decompMsgs = atomic_load_64(&tsRpcCompStat.decompMsgs);
+  pStat->decompBytesIn = atomic_load_64(&tsRpcCompStat.decompBytesIn);
+  pStat->decompBytesOut = atomic_load_64(&tsRpcCompStat.decompBytesOut);
+  pStat->decompTimeUs = atomic_load_64(&tsRpcCompStat.decompTimeUs);
 }
  
 void *rpcOpen(const SRpcInit *pInit) {
@@ -388,7 +420,8 @@ void rpcSendRequest(void *shandle, const SRpcEpSet *pEpSet, SRpcMsg *pMsg, int64
   SRpcInfo       *pRpc = (SRpcInfo *)shandle;
   SRpcReqContext *pContext;
 
-  int contLen = rpcCompressRpcMsg(pMsg->pCont, pMsg->contLen);
+  // request is compressed before a connection is picked, so only the codec every peer accepts is used
+  int contLen = rpcCompressRpcMsg(pMsg->pCont, pMsg->contLen, 0, 0);
   pContext = (SRpcReqContext *) ((char*)pMsg->pCont-sizeof(SRpcHead)-sizeof(SRpcReqContext));
   pContext->ahandle = pMsg->ahandle;
   pContext->pRpc = (SRpcInfo *)shandle;
@@ -408,7 +441,8 @@ void rpcSendRequest(void *shandle, const SRpcEpSet *pEpSet, SRpcMsg *pMsg, int64
   if (type == TSDB_MSG_TYPE_QUERY || type == TSDB_MSG_TYPE_CM_RETRIEVE
     || type == TSDB_MSG_TYPE_FETCH || type == TSDB_MSG_TYPE_CM_STABLE_VGROUP
     || type == TSDB_MSG_TYPE_CM_TABLES_META || type == TSDB_MSG_TYPE_CM_TABLE_META
-    || type == TSDB_MSG_TYPE_CM_SHOW || type == TSDB_MSG_TYPE_DM_STATUS || type == TSDB_MSG_TYPE_CM_ALTER_TABLE)
+    || type == TSDB_MSG_TYPE_CM_SHOW || type == TSDB_MSG_TYPE_DM_STATUS || type == TSDB_MSG_TYPE_CM_ALTER_TABLE
+    || type == TSDB_MSG_TYPE_SUBSCRIBE)
     pContext->connType = RPC_CONN_TCPC;
 
   pContext->rid = taosAddRef(tsRpcRefId, pContext);
@@ -432,7 +466,7 @@ void rpcSendResponse(const SRpcMsg *pRsp) {
   SRpcHead  *pHead = rpcHeadFromCont(pMsg->pCont);
   char      *msg = (char *)pHead;
 
-  pMsg->contLen = rpcCompressRpcMsg(pMsg->pCont, pMsg->contLen);
+  pMsg->contLen = rpcCompressRpcMsg(pMsg->pCont, pMsg->contLen, pConn->peerComp, pConn->peerDict);
   msgLen = rpcMsgLenFromCont(pMsg->contLen);
 
   rpcLockConn(pConn);
@@ -457,6 +491,8 @@ void rpcSendResponse(const SRpcMsg *pRsp) {
   pHead->port = htons(pConn->localPort);
   pHead->code = htonl(pMsg->code);
   pHead->ahandle = (uint64_t) pConn->ahandle;
+  pHead->compMask = tsRpcCompMask;
+  pHead->compDict = htonl(tsRpcCompDictId);
  
   // set pConn parameters
   pConn->inType = 0;
@@ -861,6 +897,8 @@ static int rpcProcessReqHead(SRpcConn *pConn, SRpcHead *pHead) {
 
     pConn->inTranId = pHead->tranId;
     pConn->inType = pHead->msgType;
+    pConn->peerComp = pHead->compMask;
+    pConn->peerDict = htonl(pHead->compDict);
 
     // start the progress timer to monitor the response from server app
     if (pConn->connType != RPC_CONN_TCPS) 
@@ -1153,18 +1191,32 @@ static void rpcProcessIncomingMsg(SRpcConn *pConn, SRpcHead *pHead, SRpcReqConte
 
   SRpcInfo *pRpc = pConn->pRpc;
   SRpcMsg   rpcMsg;
+  int32_t   code = 0;
 
-  pHead = rpcDecompressRpcMsg(pHead);
+  pHead = rpcDecompressRpcMsg(pHead, &code);
   rpcMsg.contLen = rpcContLenFromMsg(pHead->msgLen);
   rpcMsg.pCont = pHead->content;
   rpcMsg.msgType = pHead->msgType;
   rpcMsg.code = pHead->code; 
+
+  if (code != 0) {
+    // content can not be restored, hand an empty message with the error to the receiver
+    rpcMsg.contLen = 0;
+    if (!rpcIsReq(pHead->msgType)) rpcMsg.code = code;
+  }
    
   if ( rpcIsReq(pHead->msgType) ) {
     rpcMsg.ahandle = pConn->ahandle;
     rpcMsg.handle = pConn;
     rpcAddRef(pRpc);  // add the refCount for requests
 
+    if (code != 0) {
+      SRpcMsg rMsg = {.handle = rpcMsg.handle, .pCont = NULL, .contLen = 0, .code = code};
+      rpcSendResponse(&rMsg);
+      rpcFreeCont(rpcMsg.pCont);
+      return;
+    }
+
     switch (rpcMsg.msgType) {
       case TSDB_MSG_TYPE_SUBMIT:
         if (tsShortcutFlag & TSDB_SHORTCUT_RA_RPC_RECV_SUBMIT) {
@@ -1234,6 +1286,8 @@ static void rpcSendQuickRsp(SRpcConn *pConn, int32_t code) {
   pHead->destId = pConn->peerId;
   pHead->linkUid = pConn->linkUid;
   pHead->ahandle = (uint64_t)pConn->ahandle;
+  pHead->compMask = tsRpcCompMask;
+  pHead->compDict = htonl(tsRpcCompDictId);
   memcpy(pHead->user, pConn->user, tListLen(pHead->user));
   pHead->code = htonl(code);
 
@@ -1258,6 +1312,8 @@ static void rpcSendReqHead(SRpcConn *pConn) {
   pHead->destId = pConn->peerId;
   pHead->linkUid = pConn->linkUid;
   pHead->ahandle = (uint64_t)pConn->ahandle;
+  pHead->compMask = tsRpcCompMask;
+  pHead->compDict = htonl(tsRpcCompDictId);
   memcpy(pHead->user, pConn->user, tListLen(pHead->user));
   pHead->code = 1;
 
@@ -1332,6 +1388,8 @@ static void rpcSendReqToServer(SRpcInfo *pRpc, SRpcReqContext *pContext) {
   pHead->port = 0;
   pHead->linkUid = pConn->linkUid;
   pHead->ahandle = (uint64_t)pConn->ahandle;
+  pHead->compMask = tsRpcCompMask;
+  pHead->compDict = htonl(tsRpcCompDictId);
   memcpy(pHead->user, pConn->user, tListLen(pHead->user));
 
   // set the connection parameters
@@ -1468,46 +1526,220 @@ static void rpcProcessProgressTimer(void *param, void *tmrId) {
   rpcUnlockConn(pConn);
 }
 
-static int32_t rpcCompressRpcMsg(char* pCont, int32_t contLen) {
+static void rpcLoadCompDict(void) {
+  if (tsRpcCompDict != NULL || tsCompressMsgDict[0] == 0) return;
+
+  FILE *fp = fopen(tsCompressMsgDict, "rb");
+  if (fp == NULL) {
+    tError("failed to open rpc compression dictionary:%s, reason:%s", tsCompressMsgDict, strerror(errno));
+    return;
+  }
+
+  char   *dict = malloc(RPC_COMP_DICT_MAX_SIZE);
+  int32_t size = (dict == NULL) ? 0 : (int32_t)fread(dict, 1, RPC_COMP_DICT_MAX_SIZE, fp);
+  fclose(fp);
+
+  if (size <= 0) {
+    tError("failed to read rpc compression dictionary:%s", tsCompressMsgDict);
+    tfree(dict);
+    return;
+  }
+
+  tsRpcCompDictStream = LZ4_createStream();
+  if (tsRpcCompDictStream == NULL) {
+    tfree(dict);
+    return;
+  }
+
+  LZ4_loadDict(tsRpcCompDictStream, dict, size);
+  tsRpcCompDict = dict;
+  tsRpcCompDictSize = size;
+  tsRpcCompDictId = (uint32_t)adler32(adler32(0L, Z_NULL, 0), (Bytef *)dict, size);
+  tsRpcCompMask |= RPC_COMP_MASK(RPC_COMP_LZ4_DICT);
+
+  tInfo("rpc compression dictionary:%s is loaded, size:%d id:0x%08x", tsCompressMsgDict, size, tsRpcCompDictId);
+}
+
+static void rpcFreeCompDict(void) {
+  if (tsRpcCompDictStream) LZ4_freeStream(tsRpcCompDictStream);
+  tsRpcCompDictStream = NULL;
+  tfree(tsRpcCompDict);
+  tsRpcCompDictSize = 0;
+  tsRpcCompDictId = 0;
+  tsRpcCompMask &= ~RPC_COMP_MASK(RPC_COMP_LZ4_DICT);
+}
+
+/*
+ * peerComp is the compMask advertised by the peer, 0 means a legacy peer which only understands lz4.
+ * Small messages are compressed with the shared dictionary only if the peer has loaded the same one, large ones
+ * with the configured algorithm, and lz4 is the fallback every peer accepts.
+ */
+static int8_t rpcChooseCompAlgo(int32_t contLen, uint8_t peerComp, uint32_t peerDict) {
+  if (tsRpcCompDict != NULL && contLen <= RPC_COMP_DICT_MSG_SIZE && (peerComp & RPC_COMP_MASK(RPC_COMP_LZ4_DICT)) &&
+      peerDict == tsRpcCompDictId) {
+    return RPC_COMP_LZ4_DICT;
+  }
+
+  if (tsCompressMsgAlgo == RPC_COMP_DEFLATE && (peerComp & RPC_COMP_MASK(RPC_COMP_DEFLATE))) {
+    return RPC_COMP_DEFLATE;
+  }
+
+  return RPC_COMP_LZ4;
+}
+
+static int32_t rpcCompressWithDict(char *pCont, char *buf, int32_t contLen, int32_t bufLen) {
+  LZ4_stream_t *pStream = LZ4_createStream();
+  if (pStream == NULL) return -1;
+
+  LZ4_attach_dictionary(pStream, tsRpcCompDictStream);
+  int32_t compLen = LZ4_compress_fast_continue(pStream, pCont, buf, contLen, bufLen, 1);
+  LZ4_freeStream(pStream);
+
+  return compLen;
+}
+
+/*
+ * Large messages are deflated as a stream: the input is fed in chunks of RPC_COMP_STREAM_CHUNK, and the output
+ * buffer grows as the compressed data comes out, so it is sized by the compressed length instead of the message.
+ * The compressor gives up as soon as the output reaches limit, which can not be smaller than the original message.
+ */
+static int32_t rpcDeflateMsg(char *pCont, int32_t contLen, int32_t limit, char **ppBuf) {
+  z_stream strm = {0};
+  char *   buf = NULL;
+  int32_t  size = 0;
+  int32_t  offset = 0;
+  int      ret = Z_OK;
+
+  *ppBuf = NULL;
+  if (deflateInit(&strm, tsCompressMsgLevel) != Z_OK) return -1;
+
+  while (ret == Z_OK) {
+    if (strm.avail_in == 0 && offset < contLen) {
+      int32_t len = MIN(RPC_COMP_STREAM_CHUNK, contLen - offset);
+      strm.next_in = (Bytef *)(pCont + offset);
+      strm.avail_in = len;
+      offset += len;
+    }
+
+    if (strm.avail_out == 0) {
+      int32_t newSize = MAX(size * 2, RPC_COMP_STREAM_CHUNK);
+      newSize = MIN(newSize, limit);
+      char *  p = (newSize > size) ? realloc(buf, newSize) : NULL;
+      if (p == NULL) break;
+
+      buf = p;
+      strm.next_out = (Bytef *)(buf + size);
+      strm.avail_out = newSize - size;
+      size = newSize;
+    }
+
+    ret = deflate(&strm, (offset < contLen) ? Z_NO_FLUSH : Z_FINISH);
+  }
+
+  int32_t compLen = (ret == Z_STREAM_END) ? (int32_t)strm.total_out : -1;
+  deflateEnd(&strm);
+
+  if (compLen < 0) {
+    tfree(buf);
+  }
+
+  *ppBuf = buf;
+  return compLen;
+}
+
+// the counterpart of rpcDeflateMsg, the input is fed chunk by chunk as well
+static int32_t rpcInflateMsg(char *pComp, char *buf, int32_t compLen, int32_t contLen) {
+  z_stream strm = {0};
+  int32_t  offset = 0;
+  int      ret = Z_OK;
+
+  if (inflateInit(&strm) != Z_OK) return -1;
+
+  strm.next_out = (Bytef *)buf;
+  strm.avail_out = contLen;
+
+  while (ret == Z_OK) {
+    if (strm.avail_in == 0) {
+      if (offset >= compLen) break;
+
+      int32_t len = MIN(RPC_COMP_STREAM_CHUNK, compLen - offset);
+      strm.next_in = (Bytef *)(pComp + offset);
+      strm.avail_in = len;
+      offset += len;
+    }
+
+    ret = inflate(&strm, Z_NO_FLUSH);
+  }
+
+  int32_t origLen = (ret == Z_STREAM_END) ? (int32_t)strm.total_out : -1;
+  inflateEnd(&strm);
+
+  return origLen;
+}
+
+static int32_t rpcCompressRpcMsg(char* pCont, int32_t contLen, uint8_t peerComp, uint32_t peerDict) {
   SRpcHead  *pHead = rpcHeadFromCont(pCont);
   int32_t    finalLen = 0;
   int        overhead = sizeof(SRpcComp);
+  char      *buf = NULL;
   
   if (!NEEDTO_COMPRESSS_MSG(contLen)) {
     return contLen;
   }
   
-  char *buf = malloc (contLen + overhead + 8);  // 8 extra bytes
-  if (buf == NULL) {
-    tError("failed to allocate memory for rpc msg compression, contLen:%d", contLen);
-    return contLen;
+  int8_t  comp = rpcChooseCompAlgo(contLen, peerComp, peerDict);
+  int64_t st = taosGetTimestampUs();
+  int32_t compLen = 0;
+
+  if (comp == RPC_COMP_DEFLATE) {
+    compLen = rpcDeflateMsg(pCont, contLen, contLen - overhead, &buf);
+  } else {
+    buf = malloc (contLen + overhead + 8);  // 8 extra bytes
+    if (buf == NULL) {
+      tError("failed to allocate memory for rpc msg compression, contLen:%d", contLen);
+      return contLen;
+    }
+
+    if (comp == RPC_COMP_LZ4_DICT) {
+      compLen = rpcCompressWithDict(pCont, buf, contLen, contLen + overhead);
+    } else {
+      compLen = LZ4_compress_default(pCont, buf, contLen, contLen + overhead);
+    }
   }
-  
-  int32_t compLen = LZ4_compress_default(pCont, buf, contLen, contLen + overhead);
-  tDebug("compress rpc msg, before:%d, after:%d, overhead:%d", contLen, compLen, overhead);
+
+  int64_t el = taosGetTimestampUs() - st;
+  tDebug("compress rpc msg, algo:%d before:%d, after:%d, overhead:%d, elapsed:%" PRId64 "us", comp, contLen, compLen,
+         overhead, el);
+  atomic_add_fetch_64(&tsRpcCompStat.compTimeUs, el);
   
   /*
    * only the compressed size is less than the value of contLen - overhead, the compression is applied
-   * The first four bytes is set to 0, the second four bytes are utilized to keep the original length of message
+   * The first four bytes keep the dictionary ID(0 if no dictionary is used), the second four bytes are utilized
+   * to keep the original length of message
    */
   if (compLen > 0 && compLen < contLen - overhead) {
     SRpcComp *pComp = (SRpcComp *)pCont;
-    pComp->reserved = 0; 
+    pComp->reserved = (comp == RPC_COMP_LZ4_DICT) ? htonl(tsRpcCompDictId) : 0;
     pComp->contLen = htonl(contLen); 
     memcpy(pCont + overhead, buf, compLen);
     
-    pHead->comp = 1;
+    pHead->comp = comp;
     tDebug("compress rpc msg, before:%d, after:%d", contLen, compLen);
     finalLen = compLen + overhead;
+
+    atomic_add_fetch_64(&tsRpcCompStat.compMsgs, 1);
+    atomic_add_fetch_64(&tsRpcCompStat.compBytesIn, contLen);
+    atomic_add_fetch_64(&tsRpcCompStat.compBytesOut, finalLen);
   } else {
     finalLen = contLen;
+    atomic_add_fetch_64(&tsRpcCompStat.compSkipped, 1);
   }
 
-  free(buf);
+  tfree(buf);
   return finalLen;
 }
 
-static SRpcHead *rpcDecompressRpcMsg(SRpcHead *pHead) {
+static SRpcHead *rpcDecompressRpcMsg(SRpcHead *pHead, int32_t *pCode) {
   int overhead = sizeof(SRpcComp);
   SRpcHead   *pNewHead = NULL;  
   uint8_t    *pCont = pHead->content;
@@ -1515,17 +1747,50 @@ static SRpcHead *rpcDecompressRpcMsg(SRpcHead *pHead) {
 
   if (pHead->comp) {
     // decompress the content
-    assert(pComp->reserved == 0);
     int contLen = htonl(pComp->contLen);
+    int compLen = rpcContLenFromMsg(pHead->msgLen) - overhead;
+    int comp = pHead->comp;
+
+    if (comp == RPC_COMP_LZ4_DICT && (tsRpcCompDict == NULL || (uint32_t)htonl(pComp->reserved) != tsRpcCompDictId)) {
+      tError("rpc msg is compressed with dictionary:0x%08x, local dictionary:0x%08x", (uint32_t)htonl(pComp->reserved),
+             tsRpcCompDictId);
+      *pCode = TSDB_CODE_RPC_APP_ERROR;
+      return pHead;
+    }
   
     // prepare the temporary buffer to decompress message
     char *temp = (char *)malloc(contLen + RPC_MSG_OVERHEAD);
     pNewHead = (SRpcHead *)(temp + sizeof(SRpcReqContext)); // reserve SRpcReqContext
   
-    if (pNewHead) {
-      int compLen = rpcContLenFromMsg(pHead->msgLen) - overhead;
-      int origLen = LZ4_decompress_safe((char*)(pCont + overhead), (char *)pNewHead->content, compLen, contLen);
-      assert(origLen == contLen);
+    if (temp) {
+      int64_t st = taosGetTimestampUs();
+      int     origLen = 0;
+      char   *pSrc = (char *)(pCont + overhead);
+      char   *pDst = (char *)pNewHead->content;
+
+      switch (comp) {
+        case RPC_COMP_LZ4_DICT:
+          origLen = LZ4_decompress_safe_usingDict(pSrc, pDst, compLen, contLen, tsRpcCompDict, tsRpcCompDictSize);
+          break;
+        case RPC_COMP_DEFLATE:
+          origLen = rpcInflateMsg(pSrc, pDst, compLen, contLen);
+          break;
+        default:
+          origLen = LZ4_decompress_safe(pSrc, pDst, compLen, contLen);
+          break;
+      }
+
+      if (origLen != contLen) {
+        tError("failed to decompress msg, algo:%d compLen:%d contLen:%d origLen:%d", comp, compLen, contLen, origLen);
+        free(temp);
+        *pCode = TSDB_CODE_RPC_APP_ERROR;
+        return pHead;
+      }
+
+      atomic_add_fetch_64(&tsRpcCompStat.decompMsgs, 1);
+      atomic_add_fetch_64(&tsRpcCompStat.decompBytesIn, compLen + overhead);
+      atomic_add_fetch_64(&tsRpcCompStat.decompBytesOut, origLen);
+      atomic_add_fetch_64(&tsRpcCompStat.decompTimeUs, taosGetTimestampUs() - st);
     
       memcpy(pNewHead, pHead, sizeof(SRpcHead));
       pNewHead->msgLen = rpcMsgLenFromCont(origLen);
@@ -1534,6 +1799,7 @@ static SRpcHead *rpcDecompressRpcMsg(SRpcHead *pHead) {
       tTrace("decomp malloc mem:%p", temp);
     } else {
       tError("failed to allocate memory to decompress msg, contLen:%d", contLen);
+      *pCode = TSDB_CODE_RPC_APP_ERROR;
     }
   }
 
@@ -188,6 +188,13 @@ int main(int argc, char *argv[]) {
   tInfo("it takes %.3f mseconds to send %d requests to server", usedTime, numOfReqs*appThreads);
   tInfo("Performance: %.3f requests per second, msgSize:%d bytes", 1000.0*numOfReqs*appThreads/usedTime, msgSize);
 
+  SRpcCompStat compStat;
+  rpcGetCompStat(&compStat);
+  tInfo("compression: msgs:%" PRId64 " skipped:%" PRId64 " bytes:%" PRId64 "->%" PRId64 " time:%" PRId64 "us",
+        compStat.compMsgs, compStat.compSkipped, compStat.compBytesIn, compStat.compBytesOut, compStat.compTimeUs);
+  tInfo("decompression: msgs:%" PRId64 " bytes:%" PRId64 "->%" PRId64 " time:%" PRId64 "us", compStat.decompMsgs,
+        compStat.decompBytesIn, compStat.decompBytesOut, compStat.decompTimeUs);
+
   int ch = getchar();
   UNUSED(ch); 
 
@@ -139,6 +139,10 @@ int main(int argc, char *argv[]) {
       rpcInit.sessions = atoi(argv[++i]);
     } else if (strcmp(argv[i], "-o")==0 && i < argc-1) {
       tsCompressMsgSize = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-c")==0 && i < argc-1) {
+      tsCompressMsgAlgo = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-l")==0 && i < argc-1) {
+      tsCompressMsgLevel = atoi(argv[++i]);
     } else if (strcmp(argv[i], "-w")==0 && i < argc-1) {
       commit = atoi(argv[++i]);
     } else if (strcmp(argv[i], "-d")==0 && i < argc-1) {
@@ -152,6 +156,8 @@ int main(int argc, char *argv[]) {
       printf("  [-s sessions]: number of sessions, default is:%d\n", rpcInit.sessions);
       printf("  [-m msgSize]: message body size, default is:%d\n", msgSize);
       printf("  [-o compSize]: compression message size, default is:%d\n", tsCompressMsgSize);
+      printf("  [-c compAlgo]: compression algorithm for responses(1:lz4 2:deflate), default is:%d\n", tsCompressMsgAlgo);
+      printf("  [-l compLevel]: deflate compression level, default is:%d\n", tsCompressMsgLevel);
       printf("  [-w write]: write received data to file(0, 1, 2), default is:%d\n", commit);
       printf("  [-d debugFlag]: debug flag, default:%d\n", rpcDebugFlag);
       printf("  [-h help]: print out this help\n\n");
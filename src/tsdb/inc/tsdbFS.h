@@ -20,16 +20,18 @@
  * 1. The fileset .head/.data/.last use the same fver 0 before 2021.10.10.
  * 2. .head fver is 1 when extract aggregate block data from .data/.last file and save to separate .smad/.smal file
  * since 2021.10.10
+ * 3. 'current' file version is 2 when the reads of the file sets are saved after the file sets.
  * // TODO update date and add release version.
  */
 typedef enum {
   TSDB_FS_VER_0 = 0,
   TSDB_FS_VER_1,
+  TSDB_FS_VER_2,
 } ETsdbFsVer;
 
 #define TSDB_FVER_TYPE uint32_t
 #define TSDB_LATEST_FVER TSDB_FS_VER_1     // latest version for DFile
-#define TSDB_LATEST_SFS_VER TSDB_FS_VER_1  // latest version for 'current' file
+#define TSDB_LATEST_SFS_VER TSDB_FS_VER_2  // latest version for 'current' file
 
 static FORCE_INLINE uint32_t tsdbGetDFSVersion(TSDB_FILE_T fType) {  // latest version for DFile
   switch (fType) {
@@ -64,6 +66,18 @@ typedef struct {
   SArray*     df;    // data file array
 } SFSStatus;
 
+// ================== Reads of the file sets by queries
+#define TSDB_FSET_HEAT_HALF_LIFE 3600000  // ms
+
+typedef struct {
+  int     fid;
+  int64_t reads;       // times opened by queries
+  int64_t blocksRead;  // data blocks loaded by queries
+  int64_t bytesRead;   // bytes read by queries, including the index and the statis
+  int64_t lastRead;    // ms
+  double  heat;        // reads decayed by half every TSDB_FSET_HEAT_HALF_LIFE
+} STsdbFSetAccess;
+
 typedef struct {
   pthread_rwlock_t lock;
 
@@ -72,6 +86,10 @@ typedef struct {
   SHashObj*  metaCacheComp;   // meta cache for compact
   bool       intxn;
   SFSStatus* nstatus;  // new status
+
+  pthread_mutex_t accessMutex;
+  SHashObj*       access;         // fid -> STsdbFSetAccess, saved in the 'current' file
+  bool            accessChanged;  // reads not saved yet
 } STsdbFS;
 
 #define FS_CURRENT_STATUS(pfs) ((pfs)->cstatus)
@@ -107,6 +125,12 @@ void       tsdbFSIterInit(SFSIter *pIter, STsdbFS *pfs, int direction);
 void       tsdbFSIterSeek(SFSIter *pIter, int fid);
 SDFileSet *tsdbFSIterNext(SFSIter *pIter);
 int        tsdbLoadMetaCache(STsdbRepo *pRepo, bool recoverMeta);
+int        tsdbOpenFSFromCurrent(STsdbRepo *pRepo);
+int        tsdbSaveFSStatus(STsdbFS *pfs, SFSStatus *pStatus, int vid);
+
+void   tsdbRecordFSetRead(STsdbFS *pfs, int fid);
+void   tsdbRecordFSetBlocksRead(STsdbFS *pfs, int fid, int64_t blocks, int64_t bytes);
+double tsdbGetFSetHeat(STsdbFS *pfs, int fid);
 
 static FORCE_INLINE int tsdbRLockFS(STsdbFS* pFs) {
   int code = pthread_rwlock_rdlock(&(pFs->lock));
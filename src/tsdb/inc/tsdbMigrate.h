@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _TD_TSDB_MIGRATE_H_
+#define _TD_TSDB_MIGRATE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// the file sets are moved between the tiers by the background mover instead of the commits
+#define TSDB_MIGRATE_ENABLED() (tsTierMigrateInterval > 0)
+#define TSDB_MIGRATE_MAX_FAILED 8
+
+// a file set failed to migrate is skipped by the mover for a backoff, which doubles by each failure
+typedef struct {
+  int     fid;
+  int     nFails;   // 0 means the slot is free
+  int64_t retryMs;  // the file set is not tried again before
+} SMigrateFail;
+
+int tsdbGetMigrateLevel(STsdbRepo *pRepo, SDFileSet *pSet, SRtn *pRtn);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _TD_TSDB_MIGRATE_H_ */
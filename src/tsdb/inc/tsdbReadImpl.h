@@ -175,6 +175,9 @@ struct SReadH {
   void *      pBuf;   // buffer
   void *      pCBuf;  // compression buffer
   void *      pExBuf;  // extra buffer
+  bool        countReads;  // the reads are added to the file set, only for the queries
+  int64_t     blocksRead;  // reads of the file set not added yet
+  int64_t     bytesRead;
 };
 
 #define TSDB_READ_REPO(rh) ((rh)->pRepo)
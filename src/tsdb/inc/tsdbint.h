@@ -66,6 +66,8 @@ extern "C" {
 #include "tsdbCommit.h"
 // Compact
 #include "tsdbCompact.h"
+// Migrate
+#include "tsdbMigrate.h"
 // Commit Queue
 #include "tsdbCommitQueue.h"
 
@@ -94,10 +96,14 @@ struct STsdbRepo {
   pthread_mutex_t mutex;
   bool            repoLocked;
   int32_t         code;  // Commit code
+  int64_t         commitStartMs;  // start time of the running commit
+  int64_t         commitBytes;    // bytes of the memtable being committed
+  int64_t         commitRate;     // smoothed commit throughput, bytes per second, 0 if unknown
 
   SMergeBuf       mergeBuf;  //used when update=2
   int8_t          compactState;  // compact state: inCompact/noCompact/waitingCompact?
   pthread_t*      pthread;
+  SMigrateFail    migFails[TSDB_MIGRATE_MAX_FAILED];  // only used by the mover
 };
 
 #define REPO_ID(r) (r)->config.tsdbId
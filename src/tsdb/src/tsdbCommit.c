@@ -135,6 +135,10 @@ int tsdbApplyRtnOnFSet(STsdbRepo *pRepo, SDFileSet *pSet, SRtn *pRtn) {
   ASSERT(pSet->fid >= pRtn->minFid);
 
   level = tsdbGetFidLevel(pSet->fid, pRtn);
+  if (TSDB_MIGRATE_ENABLED()) {
+    // the background mover moves the file set, the commit does not wait for the copy
+    level = MIN(level, TSDB_FSET_LEVEL(pSet));
+  }
 
   tfsAllocDisk(level, &(did.level), &(did.id));
   if (did.level == TFS_UNDECIDED_LEVEL) {
@@ -708,6 +712,12 @@ static void tsdbEndCommit(STsdbRepo *pRepo, int eno) {
 
   SMemTable *pIMem = pRepo->imem;
   (void)tsdbLockRepo(pRepo);
+  if (pIMem != NULL && eno == TSDB_CODE_SUCCESS) {
+    // track commit throughput so that writers can anticipate when the buffer blocks come back
+    int64_t elapsed = MAX(taosGetTimestampMs() - pRepo->commitStartMs, 1);
+    int64_t rate = pRepo->commitBytes * 1000 / elapsed;
+    pRepo->commitRate = (pRepo->commitRate == 0) ? rate : (pRepo->commitRate * 3 + rate) / 4;
+  }
   pRepo->imem = NULL;
   (void)tsdbUnlockRepo(pRepo);
   tsdbUnRefMemTable(pRepo, pIMem);
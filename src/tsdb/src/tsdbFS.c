@@ -23,10 +23,10 @@ static const char *tsdbTxnFname[] = {"current.t", "current"};
 
 static int  tsdbComparFidFSet(const void *arg1, const void *arg2);
 static void tsdbResetFSStatus(SFSStatus *pStatus);
-static int  tsdbSaveFSStatus(SFSStatus *pStatus, int vid);
+static SArray *tsdbGetFSetAccessArray(STsdbFS *pfs, SFSStatus *pStatus);
+static void    tsdbPurgeFSetAccess(STsdbFS *pfs);
 static void tsdbApplyFSTxnOnDisk(SFSStatus *pFrom, SFSStatus *pTo);
 static void tsdbGetTxnFname(int repoid, TSDB_TXN_FILE_T ftype, char fname[]);
-static int  tsdbOpenFSFromCurrent(STsdbRepo *pRepo);
 static int  tsdbScanAndTryFixFS(STsdbRepo *pRepo);
 static int  tsdbScanRootDir(STsdbRepo *pRepo);
 static int  tsdbScanDataDir(STsdbRepo *pRepo);
@@ -90,7 +90,7 @@ static int tsdbEncodeDFileSetArray(void **buf, SArray *pArray) {
   return tlen;
 }
 
-static int tsdbDecodeDFileSetArray(void **originBuf, void *buf, SArray *pArray, SFSHeader *pSFSHeader) {
+static void *tsdbDecodeDFileSetArray(void **originBuf, void *buf, SArray *pArray, SFSHeader *pSFSHeader) {
   uint64_t  nset = 0;
   
   taosArrayClear(pArray);
@@ -104,7 +104,7 @@ static int tsdbDecodeDFileSetArray(void **originBuf, void *buf, SArray *pArray,
       size_t ptrDistance = POINTER_DISTANCE(buf, *originBuf);
       if (tsdbMakeRoom(originBuf, (size_t)extendedSize) < 0) {
         terrno = TSDB_CODE_FS_OUT_OF_MEMORY;
-        return -1;
+        return NULL;
       }
       buf = POINTER_SHIFT(*originBuf, ptrDistance);
     }
@@ -115,21 +115,68 @@ static int tsdbDecodeDFileSetArray(void **originBuf, void *buf, SArray *pArray,
     buf = tsdbDecodeDFileSet(buf, &dset, pSFSHeader->version);
     taosArrayPush(pArray, (void *)(&dset));
   }
-  return TSDB_CODE_SUCCESS;
+  return buf;
+}
+
+// ================== STsdbFSetAccess array, since TSDB_FS_VER_2
+static int tsdbEncodeFSetAccessArray(void **buf, SArray *pArray) {
+  int      tlen = 0;
+  uint64_t nset = taosArrayGetSize(pArray);
+
+  tlen += taosEncodeFixedU64(buf, nset);
+  for (size_t i = 0; i < nset; i++) {
+    STsdbFSetAccess *pAccess = taosArrayGet(pArray, i);
+    uint64_t         heat;
+
+    memcpy(&heat, &pAccess->heat, sizeof(heat));
+    tlen += taosEncodeFixedI32(buf, pAccess->fid);
+    tlen += taosEncodeFixedI64(buf, pAccess->reads);
+    tlen += taosEncodeFixedI64(buf, pAccess->blocksRead);
+    tlen += taosEncodeFixedI64(buf, pAccess->bytesRead);
+    tlen += taosEncodeFixedI64(buf, pAccess->lastRead);
+    tlen += taosEncodeFixedU64(buf, heat);
+  }
+
+  return tlen;
 }
 
-static int tsdbEncodeFSStatus(void **buf, SFSStatus *pStatus) {
+static void *tsdbDecodeFSetAccessArray(void *buf, SHashObj *pAccessHash) {
+  uint64_t nset = 0;
+
+  buf = taosDecodeFixedU64(buf, &nset);
+  for (size_t i = 0; i < nset; i++) {
+    STsdbFSetAccess access = {0};
+    int32_t         fid = 0;
+    uint64_t        heat = 0;
+
+    buf = taosDecodeFixedI32(buf, &fid);
+    buf = taosDecodeFixedI64(buf, &access.reads);
+    buf = taosDecodeFixedI64(buf, &access.blocksRead);
+    buf = taosDecodeFixedI64(buf, &access.bytesRead);
+    buf = taosDecodeFixedI64(buf, &access.lastRead);
+    buf = taosDecodeFixedU64(buf, &heat);
+    access.fid = fid;
+    memcpy(&access.heat, &heat, sizeof(heat));
+
+    taosHashPut(pAccessHash, &access.fid, sizeof(access.fid), &access, sizeof(access));
+  }
+
+  return buf;
+}
+
+static int tsdbEncodeFSStatus(void **buf, SFSStatus *pStatus, SArray *aAccess) {
   ASSERT(pStatus->pmf);
 
   int tlen = 0;
 
   tlen += tsdbEncodeSMFile(buf, pStatus->pmf);
   tlen += tsdbEncodeDFileSetArray(buf, pStatus->df);
+  tlen += tsdbEncodeFSetAccessArray(buf, aAccess);
 
   return tlen;
 }
 
-static int tsdbDecodeFSStatus(void **originBuf, void *buf, SFSStatus *pStatus, SFSHeader *pSFSHeader) {
+static void *tsdbDecodeFSStatus(void **originBuf, void *buf, SFSStatus *pStatus, SFSHeader *pSFSHeader) {
   tsdbResetFSStatus(pStatus);
   pStatus->pmf = &(pStatus->mf);
 
@@ -230,6 +277,14 @@ STsdbFS *tsdbNewFS(STsdbCfg *pCfg) {
   pfs->intxn = false;
   pfs->metaCacheComp = NULL;
 
+  pthread_mutex_init(&(pfs->accessMutex), NULL);
+  pfs->access = taosHashInit(64, taosGetDefaultHashFunction(TSDB_DATA_TYPE_INT), true, HASH_NO_LOCK);
+  if (pfs->access == NULL) {
+    terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+    tsdbFreeFS(pfs);
+    return NULL;
+  }
+
   pfs->nstatus = tsdbNewFSStatus(maxFSet);
   if (pfs->nstatus == NULL) {
     tsdbFreeFS(pfs);
@@ -245,6 +300,11 @@ void *tsdbFreeFS(STsdbFS *pfs) {
     taosHashCleanup(pfs->metaCache);
     pfs->metaCache = NULL;
     pfs->cstatus = tsdbFreeFSStatus(pfs->cstatus);
+    if (pfs->access != NULL) {
+      taosHashCleanup(pfs->access);
+      pfs->access = NULL;
+      pthread_mutex_destroy(&(pfs->accessMutex));
+    }
     pthread_rwlock_destroy(&(pfs->lock));
     free(pfs);
   }
@@ -351,7 +411,14 @@ int tsdbOpenFS(STsdbRepo *pRepo) {
 }
 
 void tsdbCloseFS(STsdbRepo *pRepo) {
-  // Do nothing
+  STsdbFS *pfs = REPO_FS(pRepo);
+
+  // the reads since the last commit are saved, the file sets are not changed
+  if (pfs->accessChanged && pfs->cstatus->pmf != NULL) {
+    if (tsdbSaveFSStatus(pfs, pfs->cstatus, REPO_ID(pRepo)) < 0) {
+      tsdbError("vgId:%d failed to save the reads of the file sets since %s", REPO_ID(pRepo), tstrerror(terrno));
+    }
+  }
 }
 
 // Start a new transaction to modify the file system
@@ -379,7 +446,7 @@ int tsdbEndFSTxn(STsdbRepo *pRepo) {
   SFSStatus *pStatus;
 
   // Write current file system snapshot
-  if (tsdbSaveFSStatus(pfs->nstatus, REPO_ID(pRepo)) < 0) {
+  if (tsdbSaveFSStatus(pfs, pfs->nstatus, REPO_ID(pRepo)) < 0) {
     tsdbEndFSTxnWithError(pfs);
     return -1;
   }
@@ -393,6 +460,7 @@ int tsdbEndFSTxn(STsdbRepo *pRepo) {
 
   // Apply actual change to each file and SDFileSet
   tsdbApplyFSTxnOnDisk(pfs->nstatus, pfs->cstatus);
+  tsdbPurgeFSetAccess(pfs);
 
   pfs->intxn = false;
   return 0;
@@ -409,29 +477,32 @@ void tsdbUpdateMFile(STsdbFS *pfs, const SMFile *pMFile) { tsdbSetStatusMFile(pf
 
 int tsdbUpdateDFileSet(STsdbFS *pfs, const SDFileSet *pSet) { return tsdbAddDFileSetToStatus(pfs->nstatus, pSet); }
 
-static int tsdbSaveFSStatus(SFSStatus *pStatus, int vid) {
+int tsdbSaveFSStatus(STsdbFS *pfs, SFSStatus *pStatus, int vid) {
   SFSHeader fsheader;
   void *    pBuf = NULL;
   void *    ptr;
   char      hbuf[TSDB_FILE_HEAD_SIZE] = "\0";
   char      tfname[TSDB_FILENAME_LEN] = "\0";
   char      cfname[TSDB_FILENAME_LEN] = "\0";
+  SArray *  aAccess = NULL;
 
   tsdbGetTxnFname(vid, TSDB_TXN_TEMP_FILE, tfname);
   tsdbGetTxnFname(vid, TSDB_TXN_CURR_FILE, cfname);
 
-  int fd = open(tfname, O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, 0755);
-  if (fd < 0) {
-    terrno = TAOS_SYSTEM_ERROR(errno);
-    return -1;
-  }
-
   fsheader.version = TSDB_LATEST_SFS_VER;
   if (pStatus->pmf == NULL) {
     ASSERT(taosArrayGetSize(pStatus->df) == 0);
     fsheader.len = 0;
   } else {
-    fsheader.len = tsdbEncodeFSStatus(NULL, pStatus) + sizeof(TSCKSUM);
+    aAccess = tsdbGetFSetAccessArray(pfs, pStatus);
+    if (aAccess == NULL) return -1;
+    fsheader.len = tsdbEncodeFSStatus(NULL, pStatus, aAccess) + sizeof(TSCKSUM);
+  }
+
+  int fd = open(tfname, O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, 0755);
+  if (fd < 0) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    goto _err;
   }
 
   // Encode header part and write
@@ -443,46 +514,52 @@ static int tsdbSaveFSStatus(SFSStatus *pStatus, int vid) {
 
   if (taosWrite(fd, hbuf, TSDB_FILE_HEAD_SIZE) < TSDB_FILE_HEAD_SIZE) {
     terrno = TAOS_SYSTEM_ERROR(errno);
-    close(fd);
-    remove(tfname);
-    return -1;
+    goto _err;
   }
 
   // Encode file status and write to file
   if (fsheader.len > 0) {
     if (tsdbMakeRoom(&(pBuf), fsheader.len) < 0) {
-      close(fd);
-      remove(tfname);
-      return -1;
+      goto _err;
     }
 
     ptr = pBuf;
-    tsdbEncodeFSStatus(&ptr, pStatus);
+    tsdbEncodeFSStatus(&ptr, pStatus, aAccess);
     taosCalcChecksumAppend(0, (uint8_t *)pBuf, fsheader.len);
 
     if (taosWrite(fd, pBuf, fsheader.len) < fsheader.len) {
       terrno = TAOS_SYSTEM_ERROR(errno);
-      close(fd);
-      (void)remove(tfname);
-      taosTZfree(pBuf);
-      return -1;
+      goto _err;
     }
   }
 
   // fsync, close and rename
   if (taosFsync(fd) < 0) {
     terrno = TAOS_SYSTEM_ERROR(errno);
-    close(fd);
-    remove(tfname);
-    taosTZfree(pBuf);
-    return -1;
+    goto _err;
   }
 
   (void)close(fd);
   (void)taosRename(tfname, cfname);
   taosTZfree(pBuf);
+  taosArrayDestroy(&aAccess);
 
   return 0;
+
+_err:
+  if (fd >= 0) {
+    close(fd);
+    (void)remove(tfname);
+  }
+  taosTZfree(pBuf);
+  if (aAccess != NULL) {
+    // the reads are saved by the next time
+    pthread_mutex_lock(&(pfs->accessMutex));
+    pfs->accessChanged = true;
+    pthread_mutex_unlock(&(pfs->accessMutex));
+    taosArrayDestroy(&aAccess);
+  }
+  return -1;
 }
 
 static void tsdbApplyFSTxnOnDisk(SFSStatus *pFrom, SFSStatus *pTo) {
@@ -551,6 +628,153 @@ static void tsdbApplyFSTxnOnDisk(SFSStatus *pFrom, SFSStatus *pTo) {
   }
 }
 
+// ================== Reads of the file sets
+static double tsdbDecayFSetHeat(STsdbFSetAccess *pAccess, int64_t now) {
+  if (now <= pAccess->lastRead) return pAccess->heat;
+  return pAccess->heat * pow(0.5, (double)(now - pAccess->lastRead) / TSDB_FSET_HEAT_HALF_LIFE);
+}
+
+static STsdbFSetAccess *tsdbGetFSetAccess(STsdbFS *pfs, int fid) {
+  STsdbFSetAccess *pAccess = taosHashGet(pfs->access, &fid, sizeof(fid));
+  if (pAccess == NULL) {
+    STsdbFSetAccess access = {.fid = fid};
+    if (taosHashPut(pfs->access, &fid, sizeof(fid), &access, sizeof(access)) < 0) return NULL;
+    pAccess = taosHashGet(pfs->access, &fid, sizeof(fid));
+  }
+
+  return pAccess;
+}
+
+void tsdbRecordFSetRead(STsdbFS *pfs, int fid) {
+  int64_t now = taosGetTimestampMs();
+
+  pthread_mutex_lock(&(pfs->accessMutex));
+  STsdbFSetAccess *pAccess = tsdbGetFSetAccess(pfs, fid);
+  if (pAccess != NULL) {
+    pAccess->reads++;
+    pAccess->heat = tsdbDecayFSetHeat(pAccess, now) + 1;
+    pAccess->lastRead = MAX(pAccess->lastRead, now);
+    pfs->accessChanged = true;
+  }
+  pthread_mutex_unlock(&(pfs->accessMutex));
+}
+
+void tsdbRecordFSetBlocksRead(STsdbFS *pfs, int fid, int64_t blocks, int64_t bytes) {
+  pthread_mutex_lock(&(pfs->accessMutex));
+  STsdbFSetAccess *pAccess = tsdbGetFSetAccess(pfs, fid);
+  if (pAccess != NULL) {
+    pAccess->blocksRead += blocks;
+    pAccess->bytesRead += bytes;
+    pfs->accessChanged = true;
+  }
+  pthread_mutex_unlock(&(pfs->accessMutex));
+}
+
+double tsdbGetFSetHeat(STsdbFS *pfs, int fid) {
+  double heat = 0;
+
+  pthread_mutex_lock(&(pfs->accessMutex));
+  STsdbFSetAccess *pAccess = taosHashGet(pfs->access, &fid, sizeof(fid));
+  if (pAccess != NULL) heat = tsdbDecayFSetHeat(pAccess, taosGetTimestampMs());
+  pthread_mutex_unlock(&(pfs->accessMutex));
+
+  return heat;
+}
+
+// the reads of the file sets in the status, in the order of fid, to be saved with the status
+static SArray *tsdbGetFSetAccessArray(STsdbFS *pfs, SFSStatus *pStatus) {
+  size_t  nset = taosArrayGetSize(pStatus->df);
+  SArray *aAccess = taosArrayInit(MAX(nset, 1), sizeof(STsdbFSetAccess));
+  if (aAccess == NULL) {
+    terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+    return NULL;
+  }
+
+  pthread_mutex_lock(&(pfs->accessMutex));
+  for (size_t i = 0; i < nset; i++) {
+    SDFileSet *      pSet = taosArrayGet(pStatus->df, i);
+    STsdbFSetAccess *pAccess = taosHashGet(pfs->access, &pSet->fid, sizeof(pSet->fid));
+    if (pAccess != NULL) taosArrayPush(aAccess, pAccess);
+  }
+  pfs->accessChanged = false;
+  pthread_mutex_unlock(&(pfs->accessMutex));
+
+  return aAccess;
+}
+
+// the reads of the file sets removed are dropped, a file set created again with the same fid starts from no reads
+static void tsdbPurgeFSetAccess(STsdbFS *pfs) {
+  SArray *aFid = taosArrayInit(4, sizeof(int));
+  if (aFid == NULL) return;
+
+  pthread_mutex_lock(&(pfs->accessMutex));
+  STsdbFSetAccess *pAccess = taosHashIterate(pfs->access, NULL);
+  while (pAccess != NULL) {
+    if (taosArraySearch(pfs->cstatus->df, &pAccess->fid, tsdbComparFidFSet, TD_EQ) == NULL) {
+      taosArrayPush(aFid, &pAccess->fid);
+    }
+    pAccess = taosHashIterate(pfs->access, pAccess);
+  }
+
+  for (size_t i = 0; i < taosArrayGetSize(aFid); i++) {
+    taosHashRemove(pfs->access, taosArrayGet(aFid, i), sizeof(int));
+  }
+  pthread_mutex_unlock(&(pfs->accessMutex));
+
+  taosArrayDestroy(&aFid);
+}
+
+static int tsdbComparFSetStatHeat(const void *arg1, const void *arg2) {
+  double heat1 = ((STsdbFSetStat *)arg1)->heat;
+  double heat2 = ((STsdbFSetStat *)arg2)->heat;
+
+  if (heat1 > heat2) return -1;
+  if (heat1 < heat2) return 1;
+  return 0;
+}
+
+int tsdbGetFSetStats(STsdbRepo *pRepo, STsdbFSetStat *pStats, int maxNum) {
+  STsdbFS *pfs = REPO_FS(pRepo);
+  int64_t  now = taosGetTimestampMs();
+  int      num = 0;
+
+  if (tsdbRLockFS(pfs) < 0) return -1;
+
+  size_t         nset = taosArrayGetSize(pfs->cstatus->df);
+  STsdbFSetStat *stats = malloc(MAX(nset, 1) * sizeof(STsdbFSetStat));
+  if (stats == NULL) {
+    tsdbUnLockFS(pfs);
+    terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  pthread_mutex_lock(&(pfs->accessMutex));
+  for (size_t i = 0; i < nset; i++) {
+    SDFileSet *      pSet = taosArrayGet(pfs->cstatus->df, i);
+    STsdbFSetAccess *pAccess = taosHashGet(pfs->access, &pSet->fid, sizeof(pSet->fid));
+    if (pAccess == NULL || pAccess->reads <= 0) continue;
+
+    STsdbFSetStat *pStat = &stats[num++];
+    pStat->fid = pSet->fid;
+    pStat->level = TSDB_FSET_LEVEL(pSet);
+    pStat->reads = pAccess->reads;
+    pStat->blocksRead = pAccess->blocksRead;
+    pStat->bytesRead = pAccess->bytesRead;
+    pStat->lastRead = pAccess->lastRead;
+    pStat->heat = tsdbDecayFSetHeat(pAccess, now);
+  }
+  pthread_mutex_unlock(&(pfs->accessMutex));
+
+  tsdbUnLockFS(pfs);
+
+  qsort(stats, num, sizeof(STsdbFSetStat), tsdbComparFSetStatHeat);
+  num = MIN(num, maxNum);
+  memcpy(pStats, stats, num * sizeof(STsdbFSetStat));
+  free(stats);
+
+  return num;
+}
+
 // ================== SFSIter
 // ASSUMPTIONS: the FS Should be read locked when calling these functions
 void tsdbFSIterInit(SFSIter *pIter, STsdbFS *pfs, int direction) {
@@ -654,7 +878,7 @@ static void tsdbGetTxnFname(int repoid, TSDB_TXN_FILE_T ftype, char fname[]) {
   snprintf(fname, TSDB_FILENAME_LEN, "%s/vnode/vnode%d/tsdb/%s", TFS_PRIMARY_PATH(), repoid, tsdbTxnFname[ftype]);
 }
 
-static int tsdbOpenFSFromCurrent(STsdbRepo *pRepo) {
+int tsdbOpenFSFromCurrent(STsdbRepo *pRepo) {
   STsdbFS * pfs = REPO_FS(pRepo);
   int       fd = -1;
   void *    buffer = NULL;
@@ -701,8 +925,12 @@ static int tsdbOpenFSFromCurrent(STsdbRepo *pRepo) {
   ptr = tsdbDecodeFSHeader(ptr, &fsheader);
   ptr = tsdbDecodeFSMeta(ptr, &(pStatus->meta));
 
-  if (fsheader.version != TSDB_FS_VER_0) {
-    // TODO: handle file version change
+  // written by a newer version, which may be decoded wrongly
+  if (fsheader.version > TSDB_LATEST_SFS_VER) {
+    tsdbError("vgId:%d file %s is of version %u, newer than %u", REPO_ID(pRepo), current, fsheader.version,
+              TSDB_LATEST_SFS_VER);
+    terrno = TSDB_CODE_TDB_FILE_CORRUPTED;
+    goto _err;
   }
 
   if (fsheader.len > 0) {
@@ -730,9 +958,14 @@ static int tsdbOpenFSFromCurrent(STsdbRepo *pRepo) {
     }
 
     ptr = buffer;
-    if (tsdbDecodeFSStatus(&buffer, ptr, pStatus, &fsheader) < 0) {
+    ptr = tsdbDecodeFSStatus(&buffer, ptr, pStatus, &fsheader);
+    if (ptr == NULL) {
       goto _err;
     }
+
+    if (fsheader.version >= TSDB_FS_VER_2) {
+      tsdbDecodeFSetAccessArray(ptr, pfs->access);
+    }
   } else {
     tsdbResetFSStatus(pStatus);
   }
@@ -1363,7 +1596,7 @@ static int tsdbRestoreCurrent(STsdbRepo *pRepo) {
     return -1;
   }
 
-  if (tsdbSaveFSStatus(pRepo->fs->cstatus, REPO_ID(pRepo)) < 0) {
+  if (tsdbSaveFSStatus(pRepo->fs, pRepo->fs->cstatus, REPO_ID(pRepo)) < 0) {
     tsdbError("vgId:%d failed to restore corrent since %s", REPO_ID(pRepo), tstrerror(terrno));
     return -1;
   }
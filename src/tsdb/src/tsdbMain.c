@@ -199,7 +199,9 @@ int tsdbCheckCommit(STsdbRepo *pRepo) {
 
   STsdbBufBlock *pBufBlock = tsdbGetCurrBufBlock(pRepo);
   ASSERT(pBufBlock != NULL);
-  if ((pRepo->mem->extraBuffList != NULL) ||
+  // rows retained in received messages occupy memory outside of the buffer pool, count them as buffer blocks
+  int64_t retainLimit = (int64_t)(pCfg->totalBlocks / 3) * pCfg->cacheBlockSize * 1024 * 1024;
+  if ((pRepo->mem->extraBuffList != NULL) || (pRepo->mem->retainSize > 0 && pRepo->mem->retainSize >= retainLimit) ||
       ((listNEles(pRepo->mem->bufBlockList) >= pCfg->totalBlocks / 3) && (pBufBlock->remain < TSDB_BUFFER_RESERVE))) {
     // trigger commit
     if (tsdbAsyncCommit(pRepo) < 0) return -1;
@@ -215,12 +217,32 @@ int tsdbGetState(STsdbRepo *repo) { return repo->state; }
 
 int8_t tsdbGetCompactState(STsdbRepo *repo) { return (int8_t)(repo->compactState); }
 
+// the bytes of the meta file and the data files on disk
+static int64_t tsdbGetDiskStorage(STsdbRepo *pRepo) {
+  STsdbFS *pfs = REPO_FS(pRepo);
+  int64_t  size = 0;
+
+  if (pfs == NULL || tsdbRLockFS(pfs) < 0) return 0;
+
+  SFSStatus *pStatus = pfs->cstatus;
+  if (pStatus->pmf != NULL) size += pStatus->pmf->info.size;
+  for (size_t i = 0; i < taosArrayGetSize(pStatus->df); ++i) {
+    SDFileSet *pSet = taosArrayGet(pStatus->df, i);
+    for (TSDB_FILE_T ftype = 0; ftype < tsdbGetNFiles(pSet); ftype++) {
+      size += TSDB_DFILE_IN_SET(pSet, ftype)->info.size;
+    }
+  }
+
+  tsdbUnLockFS(pfs);
+  return size;
+}
+
 void tsdbReportStat(void *repo, int64_t *totalPoints, int64_t *totalStorage, int64_t *compStorage) {
   ASSERT(repo != NULL);
   STsdbRepo *pRepo = repo;
   *totalPoints = pRepo->stat.pointsWritten;
   *totalStorage = pRepo->stat.totalStorage;
-  *compStorage = pRepo->stat.compStorage;
+  *compStorage = tsdbGetDiskStorage(pRepo);
 }
 
 int32_t tsdbConfigRepo(STsdbRepo *repo, STsdbCfg *pCfg) {
@@ -15,12 +15,15 @@
 
 #include "tdataformat.h"
 #include "tfunctional.h"
+#include "tglobal.h"
 #include "tsdbint.h"
 #include "tskiplist.h"
 #include "tsdbRowMergeBuf.h"
 
 #define TSDB_DATA_SKIPLIST_LEVEL 5
 #define TSDB_MAX_INSERT_BATCH 512
+#define TSDB_EXTRA_BUFFER_CHUNK (64 * 1024)  // SYSTEM memory is allocated in chunks once the buffer blocks run out
+#define TSDB_COMMIT_REMAIN_DEFAULT 100      // ms, commit remaining time assumed before the commit rate is known
 
 typedef struct {
   int32_t  totalLen;
@@ -44,7 +47,9 @@ static int          tsdbAppendTableRowToCols(STable *pTable, SDataCols *pCols, S
 static int          tsdbInitSubmitBlkIter(SSubmitBlk *pBlock, SSubmitBlkIter *pIter);
 static SMemRow      tsdbGetSubmitBlkNext(SSubmitBlkIter *pIter);
 static int          tsdbScanAndConvertSubmitMsg(STsdbRepo *pRepo, SSubmitMsg *pMsg);
-static int          tsdbInsertDataToTable(STsdbRepo *pRepo, SSubmitBlk *pBlock, int32_t *affectedrows);
+static int          tsdbInsertDataToTable(STsdbRepo *pRepo, SSubmitBlk *pBlock, int32_t *affectedrows,
+                                          STsdbRetainMsg *pRetain);
+static int          tsdbAddRetainMsg(STsdbRepo *pRepo, STsdbRetainMsg *pRetain);
 static int          tsdbInitSubmitMsgIter(SSubmitMsg *pMsg, SSubmitMsgIter *pIter);
 static int          tsdbGetSubmitMsgNext(SSubmitMsgIter *pIter, SSubmitBlk **pPBlock);
 static int          tsdbCheckTableSchema(STsdbRepo *pRepo, SSubmitBlk *pBlock, STable *pTable);
@@ -54,6 +59,10 @@ static FORCE_INLINE int tsdbCheckRowRange(STsdbRepo *pRepo, STable *pTable, SMem
                                           TSKEY now);
 
 int32_t tsdbInsertData(STsdbRepo *repo, SSubmitMsg *pMsg, SShellSubmitRspMsg *pRsp) {
+  return tsdbInsertDataRetained(repo, pMsg, pRsp, NULL);
+}
+
+int32_t tsdbInsertDataRetained(STsdbRepo *repo, SSubmitMsg *pMsg, SShellSubmitRspMsg *pRsp, STsdbRetainMsg *pRetain) {
   STsdbRepo *    pRepo = repo;
   SSubmitMsgIter msgIter = {0};
   SSubmitBlk *   pBlock = NULL;
@@ -66,11 +75,15 @@ int32_t tsdbInsertData(STsdbRepo *repo, SSubmitMsg *pMsg, SShellSubmitRspMsg *pR
     return -1;
   }
 
+  if (pRetain != NULL && tsdbAddRetainMsg(pRepo, pRetain) < 0) {
+    return -1;
+  }
+
   tsdbInitSubmitMsgIter(pMsg, &msgIter);
   while (true) {
     tsdbGetSubmitMsgNext(&msgIter, &pBlock);
     if (pBlock == NULL) break;
-    if (tsdbInsertDataToTable(pRepo, pBlock, &affectedrows) < 0) {
+    if (tsdbInsertDataToTable(pRepo, pBlock, &affectedrows, pRetain) < 0) {
       return -1;
     }
     numOfRows += pBlock->numOfRows;
@@ -85,6 +98,15 @@ int32_t tsdbInsertData(STsdbRepo *repo, SSubmitMsg *pMsg, SShellSubmitRspMsg *pR
   return 0;
 }
 
+void tsdbReleaseRetainMsg(STsdbRetainMsg *pRetain) {
+  if (pRetain == NULL) return;
+
+  if (atomic_sub_fetch_32(&pRetain->refCount, 1) == 0) {
+    (*pRetain->freeFp)(pRetain->pMsg);
+    free(pRetain);
+  }
+}
+
 // ---------------- INTERNAL FUNCTIONS ----------------
 int tsdbRefMemTable(STsdbRepo *pRepo, SMemTable *pMemTable) {
   if (pMemTable == NULL) return 0;
@@ -136,6 +158,15 @@ int tsdbUnRefMemTable(STsdbRepo *pRepo, SMemTable *pMemTable) {
       }
     }
 
+    if (pMemTable->retainList != NULL) {
+      while ((pNode = tdListPopHead(pMemTable->retainList)) != NULL) {
+        STsdbRetainMsg *pRetain = NULL;
+        tdListNodeGetData(pMemTable->retainList, pNode, (void *)(&pRetain));
+        tsdbReleaseRetainMsg(pRetain);
+        free(pNode);
+      }
+    }
+
     tdListDiscard(pMemTable->actList);
     tdListDiscard(pMemTable->bufBlockList);
     tsdbFreeMemTable(pMemTable);
@@ -246,19 +277,28 @@ void *tsdbAllocBytes(STsdbRepo *pRepo, int bytes) {
     }
 
     ASSERT(pRepo->mem->extraBuffList != NULL);
-    SListNode *pNode = (SListNode *)malloc(sizeof(SListNode) + bytes);
-    if (pNode == NULL) {
-      if (listNEles(pRepo->mem->extraBuffList) == 0) {
-        tdListFree(pRepo->mem->extraBuffList);
-        pRepo->mem->extraBuffList = NULL;
+    if (pRepo->mem->extraRemain < bytes) {
+      // rows keep arriving until the commit is triggered, allocate chunks instead of one malloc per row
+      int32_t    chunkSize = MAX(bytes, TSDB_EXTRA_BUFFER_CHUNK);
+      SListNode *pNode = (SListNode *)malloc(sizeof(SListNode) + chunkSize);
+      if (pNode == NULL) {
+        if (listNEles(pRepo->mem->extraBuffList) == 0) {
+          tdListFree(pRepo->mem->extraBuffList);
+          pRepo->mem->extraBuffList = NULL;
+        }
+        terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+        return NULL;
       }
-      terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
-      return NULL;
+
+      pNode->next = pNode->prev = NULL;
+      tdListAppendNode(pRepo->mem->extraBuffList, pNode);
+      pRepo->mem->extraOffset = 0;
+      pRepo->mem->extraRemain = chunkSize;
     }
 
-    pNode->next = pNode->prev = NULL;
-    tdListAppendNode(pRepo->mem->extraBuffList, pNode);
-    ptr = (void *)(pNode->data);
+    ptr = POINTER_SHIFT(listTail(pRepo->mem->extraBuffList)->data, pRepo->mem->extraOffset);
+    pRepo->mem->extraOffset += bytes;
+    pRepo->mem->extraRemain -= bytes;
     tsdbTrace("vgId:%d allocate %d bytes from SYSTEM buffer block", REPO_ID(pRepo), bytes);
   } else {  // allocate from TSDB buffer pool
     if (pBufBlock == NULL || pBufBlock->remain < bytes) {
@@ -322,12 +362,58 @@ int tsdbAsyncCommit(STsdbRepo *pRepo) {
   if (tsdbLockRepo(pRepo) < 0) return -1;
   pRepo->imem = pRepo->mem;
   pRepo->mem = NULL;
+  pRepo->commitStartMs = taosGetTimestampMs();
+  pRepo->commitBytes = (int64_t)listNEles(pRepo->imem->bufBlockList) * pRepo->pPool->bufBlockSize +
+                       pRepo->imem->retainSize;
   tsdbScheduleCommit(pRepo, COMMIT_REQ);
   if (tsdbUnlockRepo(pRepo) < 0) return -1;
 
   return 0;
 }
 
+void tsdbGetWriteCredit(STsdbRepo *repo, STsdbWriteCredit *pCredit) {
+  STsdbRepo *   pRepo = repo;
+  STsdbCfg *    pCfg = REPO_CFG(pRepo);
+  STsdbBufPool *pPool = pRepo->pPool;
+
+  pCredit->availBytes = INT64_MAX;
+  pCredit->commitRemainMs = 0;
+
+  if (tsdbLockRepo(pRepo) < 0) return;
+
+  if (pRepo->imem != NULL) {
+    // a commit is running, the memtable can only grow up to its share of the pool before the writer has to wait for
+    // the commit, elastic blocks may be added if the pool runs dry
+    int32_t memBlocks = 0;
+    int64_t blockRemain = 0;
+    int64_t retainSize = 0;
+    if (pRepo->mem != NULL) {
+      memBlocks = listNEles(pRepo->mem->bufBlockList);
+      retainSize = pRepo->mem->retainSize;
+      if (memBlocks > 0) blockRemain = tsdbGetCurrBufBlock(pRepo)->remain;
+    }
+
+    int32_t freeBlocks = listNEles(pPool->bufBlockList);
+    if (tsDeadLockKillQuery) freeBlocks += MAX(pCfg->totalBlocks / 3 - pPool->nElasticBlocks, 0);
+    int32_t newBlocks = MIN(pCfg->totalBlocks / 3 - memBlocks, freeBlocks);
+    int64_t memLimit = (int64_t)(pCfg->totalBlocks / 3) * pPool->bufBlockSize;
+
+    pCredit->availBytes = (int64_t)MAX(newBlocks, 0) * pPool->bufBlockSize + blockRemain;
+    pCredit->availBytes = MIN(pCredit->availBytes, memLimit - retainSize);
+    if (pCredit->availBytes < 0) pCredit->availBytes = 0;
+
+    if (pRepo->commitRate > 0) {
+      int64_t elapsed = taosGetTimestampMs() - pRepo->commitStartMs;
+      int64_t remain = pRepo->commitBytes * 1000 / pRepo->commitRate - elapsed;
+      pCredit->commitRemainMs = (remain < 1) ? 1 : (int32_t)MIN(remain, INT32_MAX);
+    } else {
+      pCredit->commitRemainMs = TSDB_COMMIT_REMAIN_DEFAULT;
+    }
+  }
+
+  tsdbUnlockRepo(pRepo);
+}
+
 int tsdbSyncCommit(STsdbRepo *repo) {
   STsdbRepo *pRepo = repo;
 
@@ -515,6 +601,7 @@ static void tsdbFreeMemTable(SMemTable* pMemTable) {
     ASSERT((pMemTable->actList == NULL) ? true : (listNEles(pMemTable->actList) == 0));
 
     tdListFree(pMemTable->extraBuffList);
+    tdListFree(pMemTable->retainList);
     tdListFree(pMemTable->bufBlockList);
     tdListFree(pMemTable->actList);
     tfree(pMemTable->tData);
@@ -713,7 +800,7 @@ static int tsdbScanAndConvertSubmitMsg(STsdbRepo *pRepo, SSubmitMsg *pMsg) {
 //row1 has higher priority
 static SMemRow tsdbInsertDupKeyMerge(SMemRow row1, SMemRow row2, STsdbRepo* pRepo,
                                      STSchema **ppSchema1, STSchema **ppSchema2,
-                                     STable* pTable, int32_t* pPoints, SMemRow* pLastRow) {
+                                     STable* pTable, int32_t* pPoints, SMemRow* pLastRow, STsdbRetainMsg *pRetain) {
 
   //for compatiblity, duplicate key inserted when update=0 should be also calculated as affected rows!
   if(row1 == NULL && row2 == NULL && pRepo->config.update == TD_ROW_DISCARD_UPDATE) {
@@ -726,6 +813,13 @@ static SMemRow tsdbInsertDupKeyMerge(SMemRow row1, SMemRow row2, STsdbRepo* pRep
             memRowKey(row1));
 
   if(row2 == NULL || pRepo->config.update != TD_ROW_PARTIAL_UPDATE) {
+    if (pRetain != NULL) {
+      // the row is kept in the retained message, which is referenced by the memtable
+      (*pPoints)++;
+      *pLastRow = row1;
+      return row1;
+    }
+
     void* pMem = tsdbAllocBytes(pRepo, memRowTLen(row1));
     if(pMem == NULL) return NULL;
     memRowCpy(pMem, row1);
@@ -769,10 +863,12 @@ static SMemRow tsdbInsertDupKeyMerge(SMemRow row1, SMemRow row2, STsdbRepo* pRep
 }
 
 static void* tsdbInsertDupKeyMergePacked(void** args) {
-  return tsdbInsertDupKeyMerge(args[0], args[1], args[2], (STSchema**)&args[3], (STSchema**)&args[4], args[5], args[6], args[7]);
+  return tsdbInsertDupKeyMerge(args[0], args[1], args[2], (STSchema**)&args[3], (STSchema**)&args[4], args[5], args[6], args[7],
+                               args[8]);
 }
 
-static void tsdbSetupSkipListHookFns(SSkipList* pSkipList, STsdbRepo *pRepo, STable *pTable, int32_t* pPoints, SMemRow* pLastRow) {
+static void tsdbSetupSkipListHookFns(SSkipList* pSkipList, STsdbRepo *pRepo, STable *pTable, int32_t* pPoints, SMemRow* pLastRow,
+                                     STsdbRetainMsg *pRetain) {
 
   if(pSkipList->insertHandleFn == NULL) {
     tGenericSavedFunc *dupHandleSavedFunc = genericSavedFuncInit((GenericVaFunc)&tsdbInsertDupKeyMergePacked, 9);
@@ -784,9 +880,10 @@ static void tsdbSetupSkipListHookFns(SSkipList* pSkipList, STsdbRepo *pRepo, STa
   }
   pSkipList->insertHandleFn->args[6] = pPoints;
   pSkipList->insertHandleFn->args[7] = pLastRow;
+  pSkipList->insertHandleFn->args[8] = pRetain;
 }
 
-static int tsdbInsertDataToTable(STsdbRepo* pRepo, SSubmitBlk* pBlock, int32_t *pAffectedRows) {
+static int tsdbInsertDataToTable(STsdbRepo* pRepo, SSubmitBlk* pBlock, int32_t *pAffectedRows, STsdbRetainMsg *pRetain) {
 
   STsdbMeta       *pMeta = pRepo->tsdbMeta;
   int32_t          points = 0;
@@ -840,7 +937,7 @@ static int tsdbInsertDataToTable(STsdbRepo* pRepo, SSubmitBlk* pBlock, int32_t *
 
   SMemRow lastRow = NULL;
   int64_t osize = SL_SIZE(pTableData->pData);
-  tsdbSetupSkipListHookFns(pTableData->pData, pRepo, pTable, &points, &lastRow);
+  tsdbSetupSkipListHookFns(pTableData->pData, pRepo, pTable, &points, &lastRow, pRetain);
   tSkipListPutBatchByIter(pTableData->pData, &blkIter, (iter_next_fn_t)tsdbGetSubmitBlkNext);
   int64_t dsize = SL_SIZE(pTableData->pData) - osize;
   (*pAffectedRows) += points;
@@ -866,6 +963,28 @@ static int tsdbInsertDataToTable(STsdbRepo* pRepo, SSubmitBlk* pBlock, int32_t *
   return 0;
 }
 
+static int tsdbAddRetainMsg(STsdbRepo *pRepo, STsdbRetainMsg *pRetain) {
+  tsdbAllocBytes(pRepo, 0);
+  SMemTable *pMemTable = pRepo->mem;
+  if (pMemTable == NULL) return -1;
+
+  if (pMemTable->retainList == NULL) {
+    pMemTable->retainList = tdListNew(sizeof(STsdbRetainMsg *));
+    if (pMemTable->retainList == NULL) {
+      terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+      return -1;
+    }
+  }
+
+  if (tdListAppend(pMemTable->retainList, (void *)(&pRetain)) < 0) {
+    terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  atomic_add_fetch_32(&pRetain->refCount, 1);
+  pMemTable->retainSize += pRetain->size;
+  return 0;
+}
 
 static int tsdbInitSubmitMsgIter(SSubmitMsg *pMsg, SSubmitMsgIter *pIter) {
   if (pMsg == NULL) {
@@ -0,0 +1,354 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "tsdbint.h"
+
+#define TSDB_MIGRATE_BUF_SIZE 1048576
+#define TSDB_MIGRATE_SUFFIX   ".mig"
+#define TSDB_MIGRATE_MAX_BACKOFF 86400  // seconds
+
+typedef struct {
+  const int8_t *pStop;
+  int64_t       startMs;
+  int64_t       bytes;  // bytes copied since startMs
+  void *        pBuf;
+} SMigrateH;
+
+static bool tsdbFindFSetToMigrate(STsdbRepo *pRepo, SDFileSet *pSet, SDiskID *pDid);
+static int  tsdbCopyFSetToMigrate(SMigrateH *pMigh, SDFileSet *pSet, SDiskID did, TFILE *tfiles);
+static int  tsdbCopyFileToMigrate(SMigrateH *pMigh, const TFILE *pSrc, const TFILE *pDest, int64_t size);
+static int  tsdbThrottleMigrate(SMigrateH *pMigh);
+static int  tsdbSwapMigratedFSet(STsdbRepo *pRepo, SDFileSet *pSet, SDiskID did, TFILE *tfiles);
+static bool tsdbIsFSetUnchanged(STsdbFS *pfs, SDFileSet *pSet);
+static void tsdbRemoveMigrateFiles(TFILE *tfiles, int nFiles);
+static bool tsdbIsMigrateBackedOff(STsdbRepo *pRepo, int fid, int64_t now);
+static void tsdbSetMigrateFailed(STsdbRepo *pRepo, int fid);
+static void tsdbClearMigrateFailed(STsdbRepo *pRepo, int fid);
+
+int tsdbMigrate(STsdbRepo *pRepo, const int8_t *pStop) {
+  SMigrateH migh = {0};
+  SDFileSet set;
+  SDiskID   did;
+  TFILE     tfiles[TSDB_FILE_MAX];
+
+  if (!TSDB_MIGRATE_ENABLED() || pRepo->state != TSDB_STATE_OK) return 0;
+  if (!tsdbFindFSetToMigrate(pRepo, &set, &did)) return 0;
+
+  tsdbInfo("vgId:%d start to migrate FSET %d from level %d disk id %d to level %d disk id %d", REPO_ID(pRepo), set.fid,
+           TSDB_FSET_LEVEL(&set), TSDB_FSET_ID(&set), did.level, did.id);
+
+  migh.pStop = pStop;
+  migh.startMs = taosGetTimestampMs();
+  if (tsdbMakeRoom(&(migh.pBuf), TSDB_MIGRATE_BUF_SIZE) < 0) {
+    return -1;
+  }
+
+  if (tsdbCopyFSetToMigrate(&migh, &set, did, tfiles) < 0) {
+    tsdbError("vgId:%d failed to migrate FSET %d since %s", REPO_ID(pRepo), set.fid, tstrerror(terrno));
+    if (terrno != TSDB_CODE_APP_NOT_READY) tsdbSetMigrateFailed(pRepo, set.fid);
+    taosTZfree(migh.pBuf);
+    return -1;
+  }
+  taosTZfree(migh.pBuf);
+
+  int code = tsdbSwapMigratedFSet(pRepo, &set, did, tfiles);
+  if (code < 0) {
+    tsdbError("vgId:%d failed to swap the migrated FSET %d since %s", REPO_ID(pRepo), set.fid, tstrerror(terrno));
+    tsdbSetMigrateFailed(pRepo, set.fid);
+  } else if (code > 0) {
+    tsdbClearMigrateFailed(pRepo, set.fid);
+    tsdbInfo("vgId:%d FSET %d is migrated to level %d disk id %d, %" PRId64 " bytes in %" PRId64 " ms",
+             REPO_ID(pRepo), set.fid, did.level, did.id, migh.bytes, taosGetTimestampMs() - migh.startMs);
+  }
+
+  return code;
+}
+
+// the level by the age of the file set, or one level hotter while the file set is read frequently. A hot file set
+// stays hot until its heat halves, so it does not move back and forth around the threshold
+int tsdbGetMigrateLevel(STsdbRepo *pRepo, SDFileSet *pSet, SRtn *pRtn) {
+  int level = tsdbGetFidLevel(pSet->fid, pRtn);
+  if (level <= 0 || tsTierHotReads <= 0) return level;
+
+  double heat = tsdbGetFSetHeat(REPO_FS(pRepo), pSet->fid);
+  if (heat >= tsTierHotReads || (heat >= tsTierHotReads / 2.0 && TSDB_FSET_LEVEL(pSet) < level)) {
+    level--;
+  }
+
+  return level;
+}
+
+static bool tsdbFindFSetToMigrate(STsdbRepo *pRepo, SDFileSet *pSet, SDiskID *pDid) {
+  STsdbFS *  pfs = REPO_FS(pRepo);
+  SFSIter    fsiter;
+  SRtn       rtn;
+  SDFileSet *pIterSet;
+  bool       found = false;
+  int64_t    now = taosGetTimestampMs();
+
+  tsdbGetRtnSnap(pRepo, &rtn);
+
+  if (tsdbRLockFS(pfs) < 0) return false;
+
+  tsdbFSIterInit(&fsiter, pfs, TSDB_FS_ITER_FORWARD);
+  while ((pIterSet = tsdbFSIterNext(&fsiter))) {
+    // the expired file sets are removed by the next commit
+    if (pIterSet->fid < rtn.minFid) continue;
+    // the file sets after it are tried while a failed one backs off
+    if (tsdbIsMigrateBackedOff(pRepo, pIterSet->fid, now)) continue;
+
+    int level = tsdbGetMigrateLevel(pRepo, pIterSet, &rtn);
+    int curLevel = TSDB_FSET_LEVEL(pIterSet);
+    if (level == curLevel) continue;
+
+    // the disk may be on a hotter level than expected when the expected level is full, never move towards it then
+    tfsAllocDisk(level, &(pDid->level), &(pDid->id));
+    if (pDid->level == TFS_UNDECIDED_LEVEL || (level > curLevel && pDid->level <= curLevel)) continue;
+
+    *pSet = *pIterSet;
+    TSDB_FSET_SET_CLOSED(pSet);
+    found = true;
+    break;
+  }
+
+  tsdbUnLockFS(pfs);
+  return found;
+}
+
+// copy the files to temporary names on the new disk, so nothing the commits create is overwritten
+static int tsdbCopyFSetToMigrate(SMigrateH *pMigh, SDFileSet *pSet, SDiskID did, TFILE *tfiles) {
+  char tname[TSDB_FILENAME_LEN];
+
+  for (TSDB_FILE_T ftype = 0; ftype < tsdbGetNFiles(pSet); ftype++) {
+    SDFile *pDFile = TSDB_DFILE_IN_SET(pSet, ftype);
+
+    if (snprintf(tname, TSDB_FILENAME_LEN, "%s%s", TFILE_REL_NAME(TSDB_FILE_F(pDFile)), TSDB_MIGRATE_SUFFIX) >=
+        TSDB_FILENAME_LEN) {
+      terrno = TSDB_CODE_TDB_INVALID_ACTION;
+      tsdbRemoveMigrateFiles(tfiles, ftype);
+      return -1;
+    }
+    tfsInitFile(tfiles + ftype, did.level, did.id, tname);
+
+    // only the committed part of the file is copied, the commit may be appending to it
+    if (tsdbCopyFileToMigrate(pMigh, TSDB_FILE_F(pDFile), tfiles + ftype, pDFile->info.size) < 0) {
+      tsdbRemoveMigrateFiles(tfiles, ftype);
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+static int tsdbCopyFileToMigrate(SMigrateH *pMigh, const TFILE *pSrc, const TFILE *pDest, int64_t size) {
+  int     sfd = -1, dfd = -1;
+  int64_t offset = 0;
+
+  sfd = tfsopen(pSrc, O_RDONLY);
+  if (sfd < 0) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    return -1;
+  }
+
+  // only the mover creates the copies, one may be left by a crash
+  (void)tfsremove(pDest);
+  dfd = tfsopen(pDest, O_WRONLY | O_CREAT | O_EXCL);
+  if (dfd < 0) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    tfsclose(sfd);
+    return -1;
+  }
+
+  while (offset < size) {
+    int64_t nread = taosRead(sfd, pMigh->pBuf, MIN(size - offset, TSDB_MIGRATE_BUF_SIZE));
+    if (nread <= 0) {
+      terrno = (nread < 0) ? TAOS_SYSTEM_ERROR(errno) : TSDB_CODE_TDB_FILE_CORRUPTED;
+      goto _err;
+    }
+
+    if (taosWrite(dfd, pMigh->pBuf, nread) < nread) {
+      terrno = TAOS_SYSTEM_ERROR(errno);
+      goto _err;
+    }
+
+    offset += nread;
+    pMigh->bytes += nread;
+    if (tsdbThrottleMigrate(pMigh) < 0) goto _err;
+  }
+
+  if (taosFsync(dfd) < 0) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    goto _err;
+  }
+
+  tfsclose(sfd);
+  tfsclose(dfd);
+  return 0;
+
+_err:
+  tfsclose(sfd);
+  tfsclose(dfd);
+  (void)tfsremove(pDest);
+  return -1;
+}
+
+// sleep until the bytes copied are within tierMigrateRate
+static int tsdbThrottleMigrate(SMigrateH *pMigh) {
+  int64_t expected = pMigh->bytes * 1000 / ((int64_t)tsTierMigrateRate * 1024 * 1024);
+
+  while (true) {
+    if (pMigh->pStop != NULL && *(pMigh->pStop)) {
+      terrno = TSDB_CODE_APP_NOT_READY;
+      return -1;
+    }
+
+    int64_t elapsed = taosGetTimestampMs() - pMigh->startMs;
+    if (elapsed >= expected) break;
+
+    taosMsleep((int32_t)MIN(expected - elapsed, 100));
+  }
+
+  return 0;
+}
+
+// replace the file set by the copy in a FS transaction, if nothing has changed the file set while it is copied.
+// The queries which have opened the old files read them until they are closed
+static int tsdbSwapMigratedFSet(STsdbRepo *pRepo, SDFileSet *pSet, SDiskID did, TFILE *tfiles) {
+  STsdbFS *  pfs = REPO_FS(pRepo);
+  SFSIter    fsiter;
+  SDFileSet *pIterSet;
+  SDFileSet  nSet;
+  int        nFiles = tsdbGetNFiles(pSet);
+
+  // no commit, compaction or sync is running while the semaphore is held
+  tsem_wait(&(pRepo->readyToCommit));
+
+  if (!tsdbIsFSetUnchanged(pfs, pSet)) {
+    tsem_post(&(pRepo->readyToCommit));
+    tsdbInfo("vgId:%d FSET %d is changed while migrated, migrate it later", REPO_ID(pRepo), pSet->fid);
+    tsdbRemoveMigrateFiles(tfiles, nFiles);
+    return 0;
+  }
+
+  tsdbStartFSTxn(pRepo, 0, 0);
+  tsdbUpdateMFile(pfs, pfs->cstatus->pmf);
+
+  tsdbInitDFileSet(&nSet, did, REPO_ID(pRepo), pSet->fid, FS_TXN_VERSION(pfs), pSet->ver);
+  for (TSDB_FILE_T ftype = 0; ftype < nFiles; ftype++) {
+    SDFile *pDFile = TSDB_DFILE_IN_SET(&nSet, ftype);
+
+    tsdbSetDFileInfo(pDFile, TSDB_FILE_INFO(TSDB_DFILE_IN_SET(pSet, ftype)));
+    if (tfsrename(tfiles + ftype, TSDB_FILE_F(pDFile)) < 0) {
+      terrno = TAOS_SYSTEM_ERROR(errno);
+      for (TSDB_FILE_T rtype = 0; rtype < ftype; rtype++) {
+        (void)tfsremove(TSDB_FILE_F(TSDB_DFILE_IN_SET(&nSet, rtype)));
+      }
+      tsdbRemoveMigrateFiles(tfiles + ftype, nFiles - ftype);
+      tsdbEndFSTxnWithError(pfs);
+      tsem_post(&(pRepo->readyToCommit));
+      return -1;
+    }
+  }
+
+  // the new files are removed when the transaction fails
+  tsdbFSIterInit(&fsiter, pfs, TSDB_FS_ITER_FORWARD);
+  while ((pIterSet = tsdbFSIterNext(&fsiter))) {
+    if (tsdbUpdateDFileSet(pfs, (pIterSet->fid == pSet->fid) ? &nSet : pIterSet) < 0) {
+      tsdbEndFSTxnWithError(pfs);
+      tsem_post(&(pRepo->readyToCommit));
+      return -1;
+    }
+  }
+
+  if (tsdbEndFSTxn(pRepo) < 0) {
+    tsem_post(&(pRepo->readyToCommit));
+    return -1;
+  }
+
+  tsem_post(&(pRepo->readyToCommit));
+  return 1;
+}
+
+static bool tsdbIsFSetUnchanged(STsdbFS *pfs, SDFileSet *pSet) {
+  SFSIter    fsiter;
+  SDFileSet *pIterSet;
+
+  tsdbFSIterInit(&fsiter, pfs, TSDB_FS_ITER_FORWARD);
+  tsdbFSIterSeek(&fsiter, pSet->fid);
+  pIterSet = tsdbFSIterNext(&fsiter);
+  if (pIterSet == NULL || pIterSet->fid != pSet->fid || pIterSet->ver != pSet->ver) return false;
+
+  for (TSDB_FILE_T ftype = 0; ftype < tsdbGetNFiles(pSet); ftype++) {
+    SDFile *pDFile = TSDB_DFILE_IN_SET(pSet, ftype);
+    SDFile *pIterDFile = TSDB_DFILE_IN_SET(pIterSet, ftype);
+
+    if (!tfsIsSameFile(TSDB_FILE_F(pDFile), TSDB_FILE_F(pIterDFile))) return false;
+    if (pDFile->info.size != pIterDFile->info.size || pDFile->info.offset != pIterDFile->info.offset ||
+        pDFile->info.magic != pIterDFile->info.magic) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static void tsdbRemoveMigrateFiles(TFILE *tfiles, int nFiles) {
+  for (int i = 0; i < nFiles; i++) {
+    (void)tfsremove(tfiles + i);
+  }
+}
+
+static bool tsdbIsMigrateBackedOff(STsdbRepo *pRepo, int fid, int64_t now) {
+  for (int i = 0; i < TSDB_MIGRATE_MAX_FAILED; i++) {
+    SMigrateFail *pFail = pRepo->migFails + i;
+    if (pFail->nFails > 0 && pFail->fid == fid) return now < pFail->retryMs;
+  }
+
+  return false;
+}
+
+// the slot of the file set, or a free one, or the one to retry first is taken
+static void tsdbSetMigrateFailed(STsdbRepo *pRepo, int fid) {
+  SMigrateFail *pFail = NULL;
+
+  for (int i = 0; i < TSDB_MIGRATE_MAX_FAILED; i++) {
+    SMigrateFail *pIter = pRepo->migFails + i;
+    if (pIter->nFails > 0 && pIter->fid == fid) {
+      pFail = pIter;
+      break;
+    }
+
+    if (pFail == NULL || (pFail->nFails > 0 && (pIter->nFails == 0 || pIter->retryMs < pFail->retryMs))) {
+      pFail = pIter;
+    }
+  }
+
+  if (pFail->fid != fid) pFail->nFails = 0;
+  pFail->fid = fid;
+  pFail->nFails++;
+
+  int     shift = MIN(pFail->nFails - 1, 16);
+  int64_t backoff = MIN((int64_t)tsTierMigrateInterval << shift, TSDB_MIGRATE_MAX_BACKOFF);
+  pFail->retryMs = taosGetTimestampMs() + backoff * 1000;
+
+  tsdbInfo("vgId:%d FSET %d failed to migrate %d times, retry it in %" PRId64 " seconds", REPO_ID(pRepo), fid,
+           pFail->nFails, backoff);
+}
+
+static void tsdbClearMigrateFailed(STsdbRepo *pRepo, int fid) {
+  for (int i = 0; i < TSDB_MIGRATE_MAX_FAILED; i++) {
+    SMigrateFail *pFail = pRepo->migFails + i;
+    if (pFail->nFails > 0 && pFail->fid == fid) pFail->nFails = 0;
+  }
+}
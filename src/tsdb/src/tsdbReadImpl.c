@@ -19,6 +19,7 @@
 
 static void tsdbResetReadTable(SReadH *pReadh);
 static void tsdbResetReadFile(SReadH *pReadh);
+static void tsdbAddReadsToFSet(SReadH *pReadh);
 static int  tsdbLoadBlockDataImpl(SReadH *pReadh, SBlock *pBlock, SDataCols *pDataCols);
 static int  tsdbCheckAndDecodeColumnData(SDataCol *pDataCol, void *content, int32_t len, int8_t comp, int numOfRows,
                                          int maxPoints, char *buffer, int bufferSize);
@@ -75,6 +76,7 @@ void tsdbDestroyReadH(SReadH *pReadh) {
   pReadh->pBlkIdx = NULL;
   pReadh->pTable = NULL;
   pReadh->aBlkIdx = taosArrayDestroy(&pReadh->aBlkIdx);
+  tsdbAddReadsToFSet(pReadh);
   tsdbCloseDFileSet(TSDB_READ_FSET(pReadh));
   pReadh->pRepo = NULL;
 }
@@ -91,6 +93,10 @@ int tsdbSetAndOpenReadFSet(SReadH *pReadh, SDFileSet *pSet) {
     return -1;
   }
 
+  if (pReadh->countReads) {
+    tsdbRecordFSetRead(REPO_FS(TSDB_READ_REPO(pReadh)), TSDB_FSET_FID(pSet));
+  }
+
   return 0;
 }
 
@@ -122,6 +128,7 @@ int tsdbLoadBlockIdx(SReadH *pReadh) {
     return -1;
   }
 
+  pReadh->bytesRead += nread;
   if (nread < pHeadf->info.len) {
     terrno = TSDB_CODE_TDB_FILE_CORRUPTED;
     tsdbError("vgId:%d SBlockIdx part in file %s is corrupted, offset:%u expected bytes:%u read bytes: %" PRId64,
@@ -223,6 +230,7 @@ int tsdbLoadBlockInfo(SReadH *pReadh, void *pTarget) {
     return -1;
   }
 
+  pReadh->bytesRead += nread;
   if (nread < pBlkIdx->len) {
     terrno = TSDB_CODE_TDB_FILE_CORRUPTED;
     tsdbError("vgId:%d SBlockInfo part in file %s is corrupted, offset:%u expected bytes:%u read bytes:%" PRId64,
@@ -330,6 +338,7 @@ int tsdbLoadBlockInfo(SReadH *pReadh, void **pTarget, uint32_t *extendedLen) {
     return -1;
   }
 
+  pReadh->bytesRead += nread;
   if (nread < pBlkIdx->len) {
     terrno = TSDB_CODE_TDB_FILE_CORRUPTED;
     tsdbError("vgId:%d SBlockInfo part in file %s is corrupted, offset:%u expected bytes:%u read bytes:%" PRId64,
@@ -382,6 +391,7 @@ int tsdbLoadBlockData(SReadH *pReadh, SBlock *pBlock, SBlockInfo *pBlkInfo) {
     }
   }
 
+  pReadh->blocksRead++;
   if (tsdbLoadBlockDataImpl(pReadh, iBlock, pReadh->pDCols[0]) < 0) return -1;
   for (int i = 1; i < pBlock->numOfSubBlocks; i++) {
     iBlock++;
@@ -409,6 +419,7 @@ int tsdbLoadBlockDataCols(SReadH *pReadh, SBlock *pBlock, SBlockInfo *pBlkInfo,
     }
   }
 
+  pReadh->blocksRead++;
   if (tsdbLoadBlockDataColsImpl(pReadh, iBlock, pReadh->pDCols[0], colIds, numOfColsIds) < 0) return -1;
   for (int i = 1; i < pBlock->numOfSubBlocks; i++) {
     iBlock++;
@@ -441,6 +452,7 @@ static int tsdbLoadBlockStatisFromDFile(SReadH *pReadh, SBlock *pBlock) {
     return -1;
   }
 
+  pReadh->bytesRead += nread;
   if (nread < size) {
     terrno = TSDB_CODE_TDB_FILE_CORRUPTED;
     tsdbError("vgId:%d block statis part in file %s is corrupted, offset:%" PRId64 " expected bytes:%" PRIzu
@@ -480,6 +492,7 @@ static int tsdbLoadBlockStatisFromAggr(SReadH *pReadh, SBlock *pBlock) {
     return -1;
   }
 
+  pReadh->bytesRead += nreadAggr;
   if (nreadAggr < sizeAggr) {
     terrno = TSDB_CODE_TDB_FILE_CORRUPTED;
     tsdbError("vgId:%d block aggr part in file %s is corrupted, offset:%" PRIu64 " expected bytes:%" PRIzu
@@ -616,9 +629,21 @@ static void tsdbResetReadTable(SReadH *pReadh) {
 static void tsdbResetReadFile(SReadH *pReadh) {
   tsdbResetReadTable(pReadh);
   taosArrayClear(pReadh->aBlkIdx);
+  tsdbAddReadsToFSet(pReadh);
   tsdbCloseDFileSet(TSDB_READ_FSET(pReadh));
 }
 
+// the blocks and bytes are added once the file set is done, not by every block
+static void tsdbAddReadsToFSet(SReadH *pReadh) {
+  if (pReadh->countReads && (pReadh->blocksRead > 0 || pReadh->bytesRead > 0)) {
+    tsdbRecordFSetBlocksRead(REPO_FS(TSDB_READ_REPO(pReadh)), TSDB_FSET_FID(TSDB_READ_FSET(pReadh)),
+                             pReadh->blocksRead, pReadh->bytesRead);
+  }
+
+  pReadh->blocksRead = 0;
+  pReadh->bytesRead = 0;
+}
+
 static int tsdbLoadBlockDataImpl(SReadH *pReadh, SBlock *pBlock, SDataCols *pDataCols) {
   ASSERT(pBlock->numOfSubBlocks == 0 || pBlock->numOfSubBlocks == 1);
 
@@ -643,6 +668,7 @@ static int tsdbLoadBlockDataImpl(SReadH *pReadh, SBlock *pBlock, SDataCols *pDat
     return -1;
   }
 
+  pReadh->bytesRead += nread;
   if (nread < pBlock->len) {
     terrno = TSDB_CODE_TDB_FILE_CORRUPTED;
     tsdbError("vgId:%d block data part in file %s is corrupted, offset:%" PRId64
@@ -859,6 +885,7 @@ static int tsdbLoadColData(SReadH *pReadh, SDFile *pDFile, SBlock *pBlock, SBloc
     return -1;
   }
 
+  pReadh->bytesRead += nread;
   if (nread < pBlockCol->len) {
     terrno = TSDB_CODE_TDB_FILE_CORRUPTED;
     tsdbError("vgId:%d block column data in file %s is corrupted, offset:%" PRId64 " expected bytes:%d" PRIzu
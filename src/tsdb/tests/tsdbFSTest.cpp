@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+#include <iostream>
+
+#include "tsdbFSTestUtil.h"
+
+namespace {
+const char *testDir = "/tmp/tsdbFSTest";
+const int   testVid = 2;
+const int   testFids[] = {100, 101};
+const int   numOfFids = sizeof(testFids) / sizeof(testFids[0]);
+
+// the version of the 'current' file, see ETsdbFsVer
+const uint32_t fsVer1 = 1;
+const uint32_t fsVer2 = 2;
+
+void checkFSets(void *pRepo) {
+  SFSTestMeta meta = {0};
+  fsTestGetMeta(pRepo, &meta);
+
+  EXPECT_EQ(meta.version, 5);
+  EXPECT_EQ(meta.totalPoints, 10);
+  EXPECT_EQ(meta.totalStorage, 20);
+  EXPECT_EQ(meta.mfSize, 4096);
+  ASSERT_EQ(meta.numOfFSets, numOfFids);
+
+  for (int i = 0; i < numOfFids; i++) {
+    SFSTestFSet set = {0};
+    fsTestGetFSet(pRepo, i, &set);
+
+    EXPECT_EQ(set.fid, testFids[i]);
+    EXPECT_GT(set.numOfFiles, 0);
+    for (int f = 0; f < set.numOfFiles; f++) {
+      EXPECT_EQ(set.sizes[f], (uint64_t)(testFids[i] * 1000 + f));
+    }
+  }
+}
+
+class TsdbFSTest : public ::testing::Test {
+ protected:
+  static void SetUpTestCase() { ASSERT_EQ(fsTestInit(testDir, testVid), 0); }
+  static void TearDownTestCase() { fsTestCleanup(testDir); }
+
+  void SetUp() override {
+    pRepo = fsTestOpenRepo(testVid);
+    ASSERT_NE(pRepo, nullptr);
+  }
+  void TearDown() override { fsTestCloseRepo(pRepo); }
+
+  void *pRepo;
+};
+}  // namespace
+
+// a version 1 file is read without the reads of the file sets
+TEST_F(TsdbFSTest, readV1) {
+  ASSERT_EQ(fsTestWriteCurrent(testVid, fsVer1, testFids, numOfFids), 0);
+  ASSERT_EQ(fsTestLoadCurrent(pRepo), 0);
+
+  checkFSets(pRepo);
+  EXPECT_EQ(fsTestGetNumOfAccess(pRepo), 0);
+}
+
+// the reads are saved after the file sets as version 2, and read back
+TEST_F(TsdbFSTest, roundTripV2) {
+  const int otherFid = 999;
+
+  ASSERT_EQ(fsTestWriteCurrent(testVid, fsVer1, testFids, numOfFids), 0);
+  ASSERT_EQ(fsTestLoadCurrent(pRepo), 0);
+
+  fsTestRecordRead(pRepo, testFids[0], 0, 0);
+  fsTestRecordRead(pRepo, testFids[0], 0, 0);
+  fsTestRecordRead(pRepo, testFids[0], 5, 40960);
+  fsTestRecordRead(pRepo, testFids[1], 0, 0);
+  fsTestRecordRead(pRepo, otherFid, 1, 100);  // not a file set of the status, not saved
+
+  SFSTestAccess saved = {0};
+  ASSERT_EQ(fsTestGetAccess(pRepo, testFids[0], &saved), 0);
+
+  ASSERT_EQ(fsTestSaveCurrent(pRepo), 0);
+  EXPECT_EQ(fsTestGetCurrentVersion(testVid), fsVer2);
+
+  void *pNewRepo = fsTestOpenRepo(testVid);
+  ASSERT_NE(pNewRepo, nullptr);
+  ASSERT_EQ(fsTestLoadCurrent(pNewRepo), 0);
+  checkFSets(pNewRepo);
+
+  SFSTestAccess access = {0};
+  EXPECT_EQ(fsTestGetNumOfAccess(pNewRepo), 2);
+  EXPECT_EQ(fsTestGetAccess(pNewRepo, otherFid, &access), -1);
+
+  ASSERT_EQ(fsTestGetAccess(pNewRepo, testFids[0], &access), 0);
+  EXPECT_EQ(access.reads, 3);
+  EXPECT_EQ(access.blocksRead, 5);
+  EXPECT_EQ(access.bytesRead, 40960);
+  EXPECT_EQ(access.lastRead, saved.lastRead);
+  EXPECT_EQ(access.heat, saved.heat);
+
+  ASSERT_EQ(fsTestGetAccess(pNewRepo, testFids[1], &access), 0);
+  EXPECT_EQ(access.reads, 1);
+  EXPECT_EQ(access.blocksRead, 0);
+  EXPECT_EQ(access.bytesRead, 0);
+
+  // saved again as it is read
+  ASSERT_EQ(fsTestSaveCurrent(pNewRepo), 0);
+  fsTestCloseRepo(pNewRepo);
+
+  pNewRepo = fsTestOpenRepo(testVid);
+  ASSERT_EQ(fsTestLoadCurrent(pNewRepo), 0);
+  checkFSets(pNewRepo);
+  ASSERT_EQ(fsTestGetAccess(pNewRepo, testFids[0], &access), 0);
+  EXPECT_EQ(access.reads, 3);
+  EXPECT_EQ(access.heat, saved.heat);
+  fsTestCloseRepo(pNewRepo);
+}
+
+// a file of a version newer than this one is rejected instead of decoded wrongly
+TEST_F(TsdbFSTest, rejectNewer) {
+  ASSERT_EQ(fsTestWriteCurrent(testVid, fsVer2 + 1, testFids, numOfFids), 0);
+  EXPECT_EQ(fsTestLoadCurrent(pRepo), -1);
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
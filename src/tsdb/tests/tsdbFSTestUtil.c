@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tglobal.h"
+#include "tsdbint.h"
+#include "tsdbFSTestUtil.h"
+
+static void fsTestGetCurrentName(int vid, char *fname) {
+  snprintf(fname, TSDB_FILENAME_LEN, "%s/vnode/vnode%d/tsdb/current", TFS_PRIMARY_PATH(), vid);
+}
+
+// the size of each file is made of the fid and the file type
+static void fsTestInitFSet(SDFileSet *pSet, int vid, int fid) {
+  SDiskID did = {0, 0};
+
+  tsdbInitDFileSet(pSet, did, vid, fid, 1, TSDB_LATEST_FSET_VER);
+  for (TSDB_FILE_T ftype = 0; ftype < tsdbGetNFiles(pSet); ftype++) {
+    TSDB_DFILE_IN_SET(pSet, ftype)->info.size = fid * 1000 + ftype;
+  }
+}
+
+int fsTestInit(const char *dir, int vid) {
+  SDiskCfg cfg = {0};
+  char     path[TSDB_FILENAME_LEN * 2];
+
+  taosRemoveDir((char *)dir);
+  if (taosMkDir(dir, 0755) != 0) return -1;
+
+  tstrncpy(cfg.dir, dir, sizeof(cfg.dir));
+  cfg.level = 0;
+  cfg.primary = 1;
+  if (tfsInit(&cfg, 1) < 0) return -1;
+
+  snprintf(path, sizeof(path), "%s/vnode", dir);
+  if (taosMkDir(path, 0755) != 0) return -1;
+  snprintf(path, sizeof(path), "%s/vnode/vnode%d", dir, vid);
+  if (taosMkDir(path, 0755) != 0) return -1;
+  snprintf(path, sizeof(path), "%s/vnode/vnode%d/tsdb", dir, vid);
+  if (taosMkDir(path, 0755) != 0) return -1;
+
+  return 0;
+}
+
+void fsTestCleanup(const char *dir) {
+  tfsDestroy();
+  taosRemoveDir((char *)dir);
+}
+
+// the file sets without their reads, as the 'current' file is written before version 2
+int fsTestWriteCurrent(int vid, uint32_t sfver, const int *fids, int numOfFSets) {
+  char        fname[TSDB_FILENAME_LEN];
+  char        hbuf[TSDB_FILE_HEAD_SIZE] = "\0";
+  SMFile      mf;
+  SDiskID     did = {0, 0};
+  SFSHeader   fsheader = {.version = sfver};
+  STsdbFSMeta meta = {.version = 5, .totalPoints = 10, .totalStorage = 20};
+  SDFileSet   set;
+  void *      ptr;
+
+  tsdbInitMFile(&mf, did, vid, 1);
+  mf.info.size = 4096;
+
+  fsheader.len = tsdbEncodeSMFile(NULL, &mf) + taosEncodeFixedU64(NULL, numOfFSets) + sizeof(TSCKSUM);
+  for (int i = 0; i < numOfFSets; i++) {
+    fsTestInitFSet(&set, vid, fids[i]);
+    fsheader.len += tsdbEncodeDFileSet(NULL, &set);
+  }
+
+  ptr = hbuf;
+  taosEncodeFixedU32(&ptr, fsheader.version);
+  taosEncodeFixedU32(&ptr, fsheader.len);
+  taosEncodeFixedU32(&ptr, meta.version);
+  taosEncodeFixedI64(&ptr, meta.totalPoints);
+  taosEncodeFixedI64(&ptr, meta.totalStorage);
+  taosCalcChecksumAppend(0, (uint8_t *)hbuf, TSDB_FILE_HEAD_SIZE);
+
+  char *buf = calloc(1, fsheader.len);
+  if (buf == NULL) return -1;
+
+  ptr = buf;
+  tsdbEncodeSMFile(&ptr, &mf);
+  taosEncodeFixedU64(&ptr, numOfFSets);
+  for (int i = 0; i < numOfFSets; i++) {
+    fsTestInitFSet(&set, vid, fids[i]);
+    tsdbEncodeDFileSet(&ptr, &set);
+  }
+  taosCalcChecksumAppend(0, (uint8_t *)buf, fsheader.len);
+
+  fsTestGetCurrentName(vid, fname);
+  FILE *fp = fopen(fname, "wb");
+  if (fp == NULL) {
+    free(buf);
+    return -1;
+  }
+
+  int code = 0;
+  if (fwrite(hbuf, 1, TSDB_FILE_HEAD_SIZE, fp) != TSDB_FILE_HEAD_SIZE ||
+      fwrite(buf, 1, fsheader.len, fp) != fsheader.len) {
+    code = -1;
+  }
+
+  fclose(fp);
+  free(buf);
+  return code;
+}
+
+uint32_t fsTestGetCurrentVersion(int vid) {
+  char      fname[TSDB_FILENAME_LEN];
+  char      hbuf[TSDB_FILE_HEAD_SIZE];
+  SFSHeader fsheader = {0};
+
+  fsTestGetCurrentName(vid, fname);
+  FILE *fp = fopen(fname, "rb");
+  if (fp == NULL) return UINT32_MAX;
+
+  if (fread(hbuf, 1, TSDB_FILE_HEAD_SIZE, fp) == TSDB_FILE_HEAD_SIZE) {
+    void *ptr = taosDecodeFixedU32(hbuf, &fsheader.version);
+    (void)ptr;
+  } else {
+    fsheader.version = UINT32_MAX;
+  }
+
+  fclose(fp);
+  return fsheader.version;
+}
+
+void *fsTestOpenRepo(int vid) {
+  STsdbRepo *pRepo = calloc(1, sizeof(STsdbRepo));
+  if (pRepo == NULL) return NULL;
+
+  pRepo->config.tsdbId = vid;
+  pRepo->config.keep = 3650;
+  pRepo->config.daysPerFile = 10;
+  pRepo->fs = tsdbNewFS(&pRepo->config);
+  if (pRepo->fs == NULL) {
+    free(pRepo);
+    return NULL;
+  }
+
+  return pRepo;
+}
+
+void fsTestCloseRepo(void *pRepo) {
+  tsdbFreeFS(REPO_FS((STsdbRepo *)pRepo));
+  free(pRepo);
+}
+
+int fsTestLoadCurrent(void *pRepo) { return tsdbOpenFSFromCurrent(pRepo); }
+
+int fsTestSaveCurrent(void *pRepo) {
+  STsdbFS *pfs = REPO_FS((STsdbRepo *)pRepo);
+  return tsdbSaveFSStatus(pfs, pfs->cstatus, REPO_ID((STsdbRepo *)pRepo));
+}
+
+void fsTestRecordRead(void *pRepo, int fid, int64_t blocks, int64_t bytes) {
+  STsdbFS *pfs = REPO_FS((STsdbRepo *)pRepo);
+
+  tsdbRecordFSetRead(pfs, fid);
+  if (blocks > 0) tsdbRecordFSetBlocksRead(pfs, fid, blocks, bytes);
+}
+
+void fsTestGetMeta(void *pRepo, SFSTestMeta *pMeta) {
+  SFSStatus *pStatus = REPO_FS((STsdbRepo *)pRepo)->cstatus;
+
+  pMeta->version = pStatus->meta.version;
+  pMeta->totalPoints = pStatus->meta.totalPoints;
+  pMeta->totalStorage = pStatus->meta.totalStorage;
+  pMeta->mfSize = (pStatus->pmf != NULL) ? pStatus->pmf->info.size : -1;
+  pMeta->numOfFSets = (int)taosArrayGetSize(pStatus->df);
+}
+
+void fsTestGetFSet(void *pRepo, int index, SFSTestFSet *pTestSet) {
+  SDFileSet *pSet = taosArrayGet(REPO_FS((STsdbRepo *)pRepo)->cstatus->df, index);
+
+  pTestSet->fid = pSet->fid;
+  pTestSet->ver = pSet->ver;
+  pTestSet->numOfFiles = MIN(tsdbGetNFiles(pSet), FS_TEST_MAX_FILES);
+  for (int i = 0; i < pTestSet->numOfFiles; i++) {
+    pTestSet->sizes[i] = TSDB_DFILE_IN_SET(pSet, i)->info.size;
+  }
+}
+
+int fsTestGetNumOfAccess(void *pRepo) { return (int)taosHashGetSize(REPO_FS((STsdbRepo *)pRepo)->access); }
+
+int fsTestGetAccess(void *pRepo, int fid, SFSTestAccess *pTestAccess) {
+  STsdbFSetAccess *pAccess = taosHashGet(REPO_FS((STsdbRepo *)pRepo)->access, &fid, sizeof(fid));
+  if (pAccess == NULL) return -1;
+
+  pTestAccess->reads = pAccess->reads;
+  pTestAccess->blocksRead = pAccess->blocksRead;
+  pTestAccess->bytesRead = pAccess->bytesRead;
+  pTestAccess->lastRead = pAccess->lastRead;
+  pTestAccess->heat = pAccess->heat;
+  return 0;
+}
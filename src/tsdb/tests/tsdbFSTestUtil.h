@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TDENGINE_TSDB_FS_TEST_UTIL_H
+#define TDENGINE_TSDB_FS_TEST_UTIL_H
+
+// the headers of tsdb are not compiled as C++, the tests reach the 'current' file through these
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stdint.h>
+
+#define FS_TEST_MAX_FILES 8
+
+typedef struct {
+  uint32_t version;
+  int64_t  totalPoints;
+  int64_t  totalStorage;
+  int64_t  mfSize;
+  int      numOfFSets;
+} SFSTestMeta;
+
+typedef struct {
+  int      fid;
+  uint16_t ver;
+  int      numOfFiles;
+  uint64_t sizes[FS_TEST_MAX_FILES];
+} SFSTestFSet;
+
+typedef struct {
+  int64_t reads;
+  int64_t blocksRead;
+  int64_t bytesRead;
+  int64_t lastRead;
+  double  heat;
+} SFSTestAccess;
+
+int      fsTestInit(const char *dir, int vid);
+void     fsTestCleanup(const char *dir);
+int      fsTestWriteCurrent(int vid, uint32_t sfver, const int *fids, int numOfFSets);
+uint32_t fsTestGetCurrentVersion(int vid);
+
+void *fsTestOpenRepo(int vid);
+void  fsTestCloseRepo(void *pRepo);
+int   fsTestLoadCurrent(void *pRepo);
+int   fsTestSaveCurrent(void *pRepo);
+void  fsTestRecordRead(void *pRepo, int fid, int64_t blocks, int64_t bytes);
+void  fsTestGetMeta(void *pRepo, SFSTestMeta *pMeta);
+void  fsTestGetFSet(void *pRepo, int index, SFSTestFSet *pSet);
+int   fsTestGetNumOfAccess(void *pRepo);
+int   fsTestGetAccess(void *pRepo, int fid, SFSTestAccess *pAccess);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // TDENGINE_TSDB_FS_TEST_UTIL_H
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TDENGINE_TOBJHASH_H
+#define TDENGINE_TOBJHASH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "hashfunc.h"
+
+/*
+ * A hash of objects which hold their own keys, for the tables with many small objects. The objects are kept in a dense
+ * array and indexed by an open addressing table of positions, so there is neither a node allocated nor a key copied
+ * for an object. A removed object leaves a hole reused by the following puts, and the objects are moved to the front
+ * only when most of the array are holes and no iteration is going on.
+ */
+typedef struct SObjHash SObjHash;
+
+// return the key of the object and its length
+typedef const void *(*_obj_key_fn_t)(void *param, const void *pObj, uint32_t *keyLen);
+
+/**
+ * initialize an object hash
+ *
+ * @param capacity   initial number of objects
+ * @param fn         hash function
+ * @param keyFp      function to get the key of an object
+ * @param param      the first parameter of keyFp
+ * @return           object hash
+ */
+SObjHash *taosObjHashInit(size_t capacity, _hash_fn_t fn, _obj_key_fn_t keyFp, void *param);
+
+/**
+ * return the number of objects
+ */
+int32_t taosObjHashGetSize(SObjHash *pHash);
+
+/**
+ * return the bytes allocated for the index, excluding the objects
+ */
+int64_t taosObjHashGetMemSize(SObjHash *pHash);
+
+/**
+ * put an object, it replaces the object with the same key
+ *
+ * @return  0 if success, -1 if out of memory
+ */
+int32_t taosObjHashPut(SObjHash *pHash, void *pObj);
+
+/**
+ * @return  the object of the key, or NULL
+ */
+void *taosObjHashGet(SObjHash *pHash, const void *key, uint32_t keyLen);
+
+/**
+ * @return  the object removed, or NULL if the key does not exist
+ */
+void *taosObjHashRemove(SObjHash *pHash, const void *key, uint32_t keyLen);
+
+/**
+ * iterate the objects, the objects put or removed during the iteration may be returned or not, the others are
+ * returned once. The rows are not compacted while an iteration is going on, so an iteration stopped before the end
+ * shall be cancelled.
+ *
+ * @param pIter  NULL to start the iteration, or the iterator returned by the last call
+ * @param ppObj  the object
+ * @return       the iterator for the next call, NULL at the end
+ */
+void *taosObjHashIterate(SObjHash *pHash, void *pIter, void **ppObj);
+
+/**
+ * cancel an iteration stopped before the end
+ *
+ * @param pIter  the iterator returned by the last call of taosObjHashIterate, nothing is done if it is NULL
+ */
+void taosObjHashCancelIterate(SObjHash *pHash, void *pIter);
+
+void taosObjHashCleanup(SObjHash *pHash);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // TDENGINE_TOBJHASH_H
@@ -31,12 +31,18 @@ Notes:
 1: taosOpenQueue/taosCloseQueue, taosOpenQset/taosCloseQset is NOT multi-thread safe 
 2: after taosCloseQueue/taosCloseQset is called, read/write operation APIs are not safe.
 3: read/write operation APIs are multi-thread safe
+4: writers never block each other, items are pushed without any lock. Readers of the same queue are
+   serialized, so a queue behaves as a multi-producer single-consumer queue
 
 To remove the limitation and make this set of queue APIs multi-thread safe, REF(tref.c)
 shall be used to set up the protection. 
 
 */
 
+// priority of a queue in a queue set, taosReadQitemFromQset serves high priority queues first
+#define TAOS_QPRIORITY_HIGH 0
+#define TAOS_QPRIORITY_LOW  1
+
 typedef void* taos_queue;
 typedef void* taos_qset;
 typedef void* taos_qall;
@@ -45,6 +51,7 @@ taos_queue taosOpenQueue();
 void       taosCloseQueue(taos_queue);
 void      *taosAllocateQitem(int size);
 void       taosFreeQitem(void *item);
+void       taosSetQueuePriority(taos_queue, int32_t priority);
 int        taosWriteQitem(taos_queue, int type, void *item);
 int        taosReadQitem(taos_queue, int *type, void **pitem);
 
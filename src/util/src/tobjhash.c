@@ -0,0 +1,300 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "os.h"
+#include "tlockfree.h"
+#include "tobjhash.h"
+
+#define OBJ_SLOT_EMPTY   -1
+#define OBJ_SLOT_REMOVED -2
+#define OBJ_MIN_SLOTS    16
+
+// a hole in the rows keeps the position of the next hole, it is odd so never taken as an object
+#define OBJ_IS_HOLE(_p)     (((uintptr_t)(_p)) & 1u)
+#define OBJ_MAKE_HOLE(_n)   ((void *)((((uintptr_t)((_n) + 1)) << 1u) | 1u))
+#define OBJ_NEXT_HOLE(_p)   ((int32_t)((uintptr_t)(_p) >> 1u) - 1)
+
+typedef struct {
+  uint32_t hashVal;
+  int32_t  pos;
+} SObjHashSlot;
+
+struct SObjHash {
+  SRWLatch      latch;
+  _hash_fn_t    hashFp;
+  _obj_key_fn_t keyFp;
+  void *        param;
+  int32_t       size;
+  int32_t       numOfSlots;  // power of 2
+  int32_t       numOfUsed;   // slots not empty, including the removed ones
+  SObjHashSlot *slots;
+  int32_t       numOfRows;   // positions used in rows, including the holes
+  int32_t       maxRows;
+  int32_t       freeHole;    // the first hole in rows, -1 if none
+  int32_t       numOfIters;  // the iterations not finished, the rows are not compacted till they are
+  void **       rows;
+};
+
+static int32_t objHashRoundSlots(int64_t num) {
+  int32_t numOfSlots = OBJ_MIN_SLOTS;
+  while (numOfSlots < num) numOfSlots <<= 1;
+  return numOfSlots;
+}
+
+static int32_t objHashResizeSlots(SObjHash *pHash, int32_t numOfSlots) {
+  SObjHashSlot *slots = malloc(sizeof(SObjHashSlot) * numOfSlots);
+  if (slots == NULL) return -1;
+
+  for (int32_t i = 0; i < numOfSlots; ++i) {
+    slots[i].pos = OBJ_SLOT_EMPTY;
+  }
+
+  uint32_t mask = numOfSlots - 1;
+  for (int32_t i = 0; i < pHash->numOfSlots; ++i) {
+    SObjHashSlot *pSlot = &pHash->slots[i];
+    if (pSlot->pos < 0) continue;
+
+    uint32_t j = pSlot->hashVal & mask;
+    while (slots[j].pos != OBJ_SLOT_EMPTY) j = (j + 1) & mask;
+    slots[j] = *pSlot;
+  }
+
+  tfree(pHash->slots);
+  pHash->slots = slots;
+  pHash->numOfSlots = numOfSlots;
+  pHash->numOfUsed = pHash->size;
+  return 0;
+}
+
+static bool objHashKeyEqual(SObjHash *pHash, const void *pObj, const void *key, uint32_t keyLen) {
+  uint32_t    len = 0;
+  const void *objKey = (*pHash->keyFp)(pHash->param, pObj, &len);
+  return len == keyLen && memcmp(objKey, key, keyLen) == 0;
+}
+
+// return the slot of the key, or the slot to put it if it does not exist
+static int32_t objHashFindSlot(SObjHash *pHash, const void *key, uint32_t keyLen, uint32_t hashVal, bool *found) {
+  uint32_t mask = pHash->numOfSlots - 1;
+  int32_t  removed = -1;
+
+  for (uint32_t i = hashVal & mask;; i = (i + 1) & mask) {
+    SObjHashSlot *pSlot = &pHash->slots[i];
+    if (pSlot->pos == OBJ_SLOT_EMPTY) {
+      *found = false;
+      return (removed >= 0) ? removed : (int32_t)i;
+    }
+
+    if (pSlot->pos == OBJ_SLOT_REMOVED) {
+      if (removed < 0) removed = i;
+    } else if (pSlot->hashVal == hashVal && objHashKeyEqual(pHash, pHash->rows[pSlot->pos], key, keyLen)) {
+      *found = true;
+      return i;
+    }
+  }
+}
+
+static int32_t objHashAllocPos(SObjHash *pHash) {
+  if (pHash->freeHole >= 0) {
+    int32_t pos = pHash->freeHole;
+    pHash->freeHole = OBJ_NEXT_HOLE(pHash->rows[pos]);
+    return pos;
+  }
+
+  if (pHash->numOfRows >= pHash->maxRows) {
+    int32_t maxRows = MAX(pHash->maxRows * 2, OBJ_MIN_SLOTS);
+    void ** rows = realloc(pHash->rows, POINTER_BYTES * maxRows);
+    if (rows == NULL) return -1;
+
+    pHash->rows = rows;
+    pHash->maxRows = maxRows;
+  }
+
+  return pHash->numOfRows++;
+}
+
+/*
+ * The objects are moved to the front of the rows once most of the rows are holes, e.g. after many tables are dropped,
+ * and the rows and the slots are shrunk. It is skipped while an iteration is going on, since the objects moved behind
+ * the iterator would be missed.
+ */
+static void objHashCompact(SObjHash *pHash) {
+  if (pHash->numOfRows <= OBJ_MIN_SLOTS || (int64_t)pHash->size * 4 >= pHash->numOfRows) return;
+  if (atomic_load_32(&pHash->numOfIters) > 0) return;
+
+  int32_t *newPos = malloc(sizeof(int32_t) * pHash->numOfRows);
+  if (newPos == NULL) return;
+
+  int32_t num = 0;
+  for (int32_t i = 0; i < pHash->numOfRows; ++i) {
+    if (OBJ_IS_HOLE(pHash->rows[i])) continue;
+    newPos[i] = num;
+    pHash->rows[num++] = pHash->rows[i];
+  }
+
+  for (int32_t i = 0; i < pHash->numOfSlots; ++i) {
+    if (pHash->slots[i].pos >= 0) pHash->slots[i].pos = newPos[pHash->slots[i].pos];
+  }
+  free(newPos);
+
+  pHash->numOfRows = num;
+  pHash->freeHole = -1;
+
+  int32_t maxRows = MAX(num * 2, OBJ_MIN_SLOTS);
+  void ** rows = realloc(pHash->rows, POINTER_BYTES * maxRows);
+  if (rows != NULL) {
+    pHash->rows = rows;
+    pHash->maxRows = maxRows;
+  }
+
+  // the slots are shrunk as well, it is kept as it is if out of memory
+  objHashResizeSlots(pHash, objHashRoundSlots((int64_t)num * 2));
+}
+
+SObjHash *taosObjHashInit(size_t capacity, _hash_fn_t fn, _obj_key_fn_t keyFp, void *param) {
+  SObjHash *pHash = calloc(1, sizeof(SObjHash));
+  if (pHash == NULL) return NULL;
+
+  pHash->hashFp = fn;
+  pHash->keyFp = keyFp;
+  pHash->param = param;
+  pHash->freeHole = -1;
+  taosInitRWLatch(&pHash->latch);
+
+  if (objHashResizeSlots(pHash, objHashRoundSlots((int64_t)capacity * 2)) != 0) {
+    free(pHash);
+    return NULL;
+  }
+
+  return pHash;
+}
+
+int32_t taosObjHashGetSize(SObjHash *pHash) {
+  if (pHash == NULL) return 0;
+  return pHash->size;
+}
+
+int64_t taosObjHashGetMemSize(SObjHash *pHash) {
+  if (pHash == NULL) return 0;
+  return sizeof(SObjHash) + (int64_t)sizeof(SObjHashSlot) * pHash->numOfSlots + (int64_t)POINTER_BYTES * pHash->maxRows;
+}
+
+int32_t taosObjHashPut(SObjHash *pHash, void *pObj) {
+  if (pHash == NULL || pObj == NULL) return -1;
+
+  uint32_t    keyLen = 0;
+  const void *key = (*pHash->keyFp)(pHash->param, pObj, &keyLen);
+  uint32_t    hashVal = (*pHash->hashFp)(key, keyLen);
+  int32_t     code = 0;
+
+  taosWLockLatch(&pHash->latch);
+
+  // keep the slots at most 3/4 used, the removed slots are dropped while resize
+  if ((int64_t)(pHash->numOfUsed + 1) * 4 > (int64_t)pHash->numOfSlots * 3) {
+    code = objHashResizeSlots(pHash, objHashRoundSlots(((int64_t)pHash->size + 1) * 2));
+  }
+
+  if (code == 0) {
+    bool    found = false;
+    int32_t i = objHashFindSlot(pHash, key, keyLen, hashVal, &found);
+    if (found) {
+      pHash->rows[pHash->slots[i].pos] = pObj;
+    } else {
+      int32_t pos = objHashAllocPos(pHash);
+      if (pos < 0) {
+        code = -1;
+      } else {
+        if (pHash->slots[i].pos == OBJ_SLOT_EMPTY) pHash->numOfUsed++;
+        pHash->slots[i].pos = pos;
+        pHash->slots[i].hashVal = hashVal;
+        pHash->rows[pos] = pObj;
+        pHash->size++;
+      }
+    }
+  }
+
+  taosWUnLockLatch(&pHash->latch);
+  return code;
+}
+
+void *taosObjHashGet(SObjHash *pHash, const void *key, uint32_t keyLen) {
+  if (pHash == NULL || key == NULL) return NULL;
+
+  uint32_t hashVal = (*pHash->hashFp)(key, keyLen);
+  void *   pObj = NULL;
+  bool     found = false;
+
+  taosRLockLatch(&pHash->latch);
+  int32_t i = objHashFindSlot(pHash, key, keyLen, hashVal, &found);
+  if (found) pObj = pHash->rows[pHash->slots[i].pos];
+  taosRUnLockLatch(&pHash->latch);
+
+  return pObj;
+}
+
+void *taosObjHashRemove(SObjHash *pHash, const void *key, uint32_t keyLen) {
+  if (pHash == NULL || key == NULL) return NULL;
+
+  uint32_t hashVal = (*pHash->hashFp)(key, keyLen);
+  void *   pObj = NULL;
+  bool     found = false;
+
+  taosWLockLatch(&pHash->latch);
+  int32_t i = objHashFindSlot(pHash, key, keyLen, hashVal, &found);
+  if (found) {
+    int32_t pos = pHash->slots[i].pos;
+    pObj = pHash->rows[pos];
+    pHash->rows[pos] = OBJ_MAKE_HOLE(pHash->freeHole);
+    pHash->freeHole = pos;
+    pHash->slots[i].pos = OBJ_SLOT_REMOVED;
+    pHash->size--;
+    objHashCompact(pHash);
+  }
+  taosWUnLockLatch(&pHash->latch);
+
+  return pObj;
+}
+
+void *taosObjHashIterate(SObjHash *pHash, void *pIter, void **ppObj) {
+  int32_t pos = (int32_t)(intptr_t)pIter;
+  *ppObj = NULL;
+  if (pHash == NULL) return NULL;
+
+  taosRLockLatch(&pHash->latch);
+  while (pos < pHash->numOfRows && OBJ_IS_HOLE(pHash->rows[pos])) pos++;
+  if (pos < pHash->numOfRows) *ppObj = pHash->rows[pos];
+
+  // the iteration is counted from its first object to the end or its cancel
+  if (pIter == NULL && *ppObj != NULL) {
+    atomic_add_fetch_32(&pHash->numOfIters, 1);
+  } else if (pIter != NULL && *ppObj == NULL) {
+    atomic_sub_fetch_32(&pHash->numOfIters, 1);
+  }
+  taosRUnLockLatch(&pHash->latch);
+
+  return (*ppObj != NULL) ? (void *)(intptr_t)(pos + 1) : NULL;
+}
+
+void taosObjHashCancelIterate(SObjHash *pHash, void *pIter) {
+  if (pHash == NULL || pIter == NULL) return;
+  atomic_sub_fetch_32(&pHash->numOfIters, 1);
+}
+
+void taosObjHashCleanup(SObjHash *pHash) {
+  if (pHash == NULL) return;
+
+  tfree(pHash->slots);
+  tfree(pHash->rows);
+  free(pHash);
+}
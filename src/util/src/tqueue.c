@@ -18,21 +18,36 @@
 #include "taoserror.h"
 #include "tqueue.h"
 
+// the minimum and maximum number of times a consumer polls the qset semaphore before it parks itself
+#define TAOS_QSET_MIN_SPIN 4
+#define TAOS_QSET_MAX_SPIN 256
+
+// one out of this number of reads from a qset serves the low priority queues first, so they are not starved
+#define TAOS_QSET_LOW_PRIORITY_QUOTA 4
+
 typedef struct STaosQnode {
   int                 type;
   struct STaosQnode  *next;
   char                item[];
 } STaosQnode;
 
+/*
+  Producers never take a lock: an item is pushed onto the lock-free LIFO stack 'pending' with a CAS.
+  The consumer, serialized by 'mutex', detaches the whole stack with a single exchange and reverses
+  it into the FIFO list 'head/tail', so items are still read out in the order they are written.
+*/
 typedef struct STaosQueue {
   int32_t             itemSize;
-  int32_t             numOfItems;
-  struct STaosQnode  *head;
+  int32_t             numOfItems;  // updated atomically, items written but not read out yet
+  int32_t             readyItems;  // number of items in the FIFO list, protected by mutex
+  int32_t             priority;    // TAOS_QPRIORITY_HIGH or TAOS_QPRIORITY_LOW
+  struct STaosQnode  *pending;     // pushed by producers, the latest item is on top
+  struct STaosQnode  *head;        // FIFO list owned by the consumer
   struct STaosQnode  *tail;
   struct STaosQueue  *next;    // for queue set
   struct STaosQset   *qset;    // for queue set
   void               *ahandle; // for queue set
-  pthread_mutex_t     mutex;  
+  pthread_mutex_t     mutex;   // for consumers only
 } STaosQueue;
 
 typedef struct STaosQset {
@@ -40,7 +55,9 @@ typedef struct STaosQset {
   STaosQueue        *current;
   pthread_mutex_t    mutex;
   int32_t            numOfQueues;
-  int32_t            numOfItems;
+  int32_t            numOfLowQueues;
+  int64_t            numOfReads;
+  int32_t            spin;     // adaptive number of semaphore polls before parking
   tsem_t             sem;
 } STaosQset;
 
@@ -50,6 +67,82 @@ typedef struct STaosQall {
   int32_t       itemSize;
   int32_t       numOfItems;
 } STaosQall; 
+
+// move the items pushed by producers into the FIFO list, shall be called with queue->mutex locked
+static void taosMovePendingQnodes(STaosQueue *queue) {
+  STaosQnode *pNode = atomic_exchange_ptr(&queue->pending, NULL);
+  if (pNode == NULL) return;
+
+  STaosQnode *first = NULL;
+  STaosQnode *last = pNode;
+  int32_t     num = 0;
+
+  while (pNode) {
+    STaosQnode *pNext = pNode->next;
+    pNode->next = first;
+    first = pNode;
+    pNode = pNext;
+    num++;
+  }
+
+  if (queue->tail) {
+    queue->tail->next = first;
+  } else {
+    queue->head = first;
+  }
+
+  queue->tail = last;
+  queue->readyItems += num;
+}
+
+// shall be called with queue->mutex locked
+static STaosQnode *taosPopQnode(STaosQueue *queue) {
+  if (queue->head == NULL) taosMovePendingQnodes(queue);
+
+  STaosQnode *pNode = queue->head;
+  if (pNode) {
+    queue->head = pNode->next;
+    if (queue->head == NULL) queue->tail = NULL;
+    queue->readyItems--;
+    atomic_sub_fetch_32(&queue->numOfItems, 1);
+  }
+
+  return pNode;
+}
+
+// detach all the items, shall be called with queue->mutex locked
+static int32_t taosPopAllQnodes(STaosQueue *queue, STaosQall *qall) {
+  taosMovePendingQnodes(queue);
+  if (queue->head == NULL) return 0;
+
+  qall->current = queue->head;
+  qall->start = queue->head;
+  qall->numOfItems = queue->readyItems;
+  qall->itemSize = queue->itemSize;
+
+  queue->head = NULL;
+  queue->tail = NULL;
+  queue->readyItems = 0;
+  atomic_sub_fetch_32(&queue->numOfItems, qall->numOfItems);
+
+  return qall->numOfItems;
+}
+
+// spin on the semaphore for a while before parking, the number of polls grows if it pays off
+static void taosWaitQset(STaosQset *qset) {
+  int32_t spin = atomic_load_32(&qset->spin);
+
+  for (int32_t i = 0; i < spin; ++i) {
+    if (tsem_trywait(&qset->sem) == 0) {
+      if (spin < TAOS_QSET_MAX_SPIN) atomic_store_32(&qset->spin, spin * 2);
+      return;
+    }
+    sched_yield();
+  }
+
+  if (spin > TAOS_QSET_MIN_SPIN) atomic_store_32(&qset->spin, spin / 2);
+  tsem_wait(&qset->sem);
+}
   
 taos_queue taosOpenQueue() {
   
@@ -72,8 +165,10 @@ void taosCloseQueue(taos_queue param) {
   STaosQset  *qset;
 
   pthread_mutex_lock(&queue->mutex);
+  taosMovePendingQnodes(queue);
   STaosQnode *pNode = queue->head;  
   queue->head = NULL;
+  queue->tail = NULL;
   qset = queue->qset;
   pthread_mutex_unlock(&queue->mutex);
 
@@ -108,29 +203,40 @@ void taosFreeQitem(void *param) {
   free(temp);
 }
 
+void taosSetQueuePriority(taos_queue param, int32_t priority) {
+  STaosQueue *queue = (STaosQueue *)param;
+  STaosQset  *qset = queue->qset;
+
+  if (qset) pthread_mutex_lock(&qset->mutex);
+
+  if (qset && queue->priority != priority) {
+    qset->numOfLowQueues += (priority == TAOS_QPRIORITY_LOW) ? 1 : -1;
+  }
+  queue->priority = priority;
+
+  if (qset) pthread_mutex_unlock(&qset->mutex);
+
+  uTrace("queue:%p, priority is set to %d", queue, priority);
+}
+
 int taosWriteQitem(taos_queue param, int type, void *item) {
   STaosQueue *queue = (STaosQueue *)param;
   STaosQnode *pNode = (STaosQnode *)(((char *)item) - sizeof(STaosQnode));
+  STaosQset  *qset = atomic_load_ptr(&queue->qset);
+  STaosQnode *pTop;
   pNode->type = type;
-  pNode->next = NULL;
-
-  pthread_mutex_lock(&queue->mutex);
 
-  if (queue->tail) {
-    queue->tail->next = pNode;
-    queue->tail = pNode;
-  } else {
-    queue->head = pNode;
-    queue->tail = pNode; 
-  }
+  // count the item before it is visible, so numOfItems never drops below the number of readable items
+  int32_t items = atomic_add_fetch_32(&queue->numOfItems, 1);
 
-  queue->numOfItems++;
-  if (queue->qset) atomic_add_fetch_32(&queue->qset->numOfItems, 1);
-  uTrace("item:%p is put into queue:%p, type:%d items:%d", item, queue, type, queue->numOfItems);
+  do {
+    pTop = atomic_load_ptr(&queue->pending);
+    pNode->next = pTop;
+  } while (atomic_val_compare_exchange_ptr(&queue->pending, pTop, pNode) != pTop);
 
-  pthread_mutex_unlock(&queue->mutex);
+  uTrace("item:%p is put into queue:%p, type:%d items:%d", item, queue, type, items);
 
-  if (queue->qset) tsem_post(&queue->qset->sem);
+  if (qset) tsem_post(&qset->sem);
 
   return 0;
 }
@@ -140,19 +246,16 @@ int taosReadQitem(taos_queue param, int *type, void **pitem) {
   STaosQnode *pNode = NULL;
   int         code = 0;
 
+  if (atomic_load_32(&queue->numOfItems) == 0) return 0;
+
   pthread_mutex_lock(&queue->mutex);
 
-  if (queue->head) {
-      pNode = queue->head;
-      *pitem = pNode->item;
-      *type = pNode->type;
-      queue->head = pNode->next;
-      if (queue->head == NULL) 
-        queue->tail = NULL;
-      queue->numOfItems--;
-      if (queue->qset) atomic_sub_fetch_32(&queue->qset->numOfItems, 1);
-      code = 1;
-      uDebug("item:%p is read out from queue:%p, type:%d items:%d", *pitem, queue, *type, queue->numOfItems);
+  pNode = taosPopQnode(queue);
+  if (pNode) {
+    *pitem = pNode->item;
+    *type = pNode->type;
+    code = 1;
+    uDebug("item:%p is read out from queue:%p, type:%d items:%d", *pitem, queue, *type, queue->numOfItems);
   } 
 
   pthread_mutex_unlock(&queue->mutex);
@@ -173,29 +276,15 @@ int taosReadAllQitems(taos_queue param, taos_qall p2) {
   STaosQueue *queue = (STaosQueue *)param;
   STaosQall  *qall = (STaosQall *)p2;
   int         code = 0;
-  bool        empty;
-
-  pthread_mutex_lock(&queue->mutex);
 
-  empty = queue->head == NULL;
-  if (!empty) {
-    memset(qall, 0, sizeof(STaosQall));
-    qall->current = queue->head;
-    qall->start = queue->head;
-    qall->numOfItems = queue->numOfItems;
-    qall->itemSize = queue->itemSize;
-    code = qall->numOfItems;
-
-    queue->head = NULL;
-    queue->tail = NULL;
-    queue->numOfItems = 0;
-    if (queue->qset) atomic_sub_fetch_32(&queue->qset->numOfItems, qall->numOfItems);
+  if (atomic_load_32(&queue->numOfItems) > 0) {
+    pthread_mutex_lock(&queue->mutex);
+    code = taosPopAllQnodes(queue, qall);
+    pthread_mutex_unlock(&queue->mutex);
   }
 
-  pthread_mutex_unlock(&queue->mutex);
-
   // if source queue is empty, we set destination qall to empty too.
-  if (empty) {
+  if (code == 0) {
     qall->current = NULL;
     qall->start = NULL;
     qall->numOfItems = 0;
@@ -237,6 +326,7 @@ taos_qset taosOpenQset() {
 
   pthread_mutex_init(&qset->mutex, NULL);
   tsem_init(&qset->sem, 0, 0);
+  qset->spin = TAOS_QSET_MIN_SPIN;
 
   uTrace("qset:%p is opened", qset);
   return qset;
@@ -284,11 +374,8 @@ int taosAddIntoQset(taos_qset p1, taos_queue p2, void *ahandle) {
   queue->ahandle = ahandle;
   qset->head = queue;
   qset->numOfQueues++;
-
-  pthread_mutex_lock(&queue->mutex);
-  atomic_add_fetch_32(&qset->numOfItems, queue->numOfItems);
-  queue->qset = qset;
-  pthread_mutex_unlock(&queue->mutex);
+  if (queue->priority == TAOS_QPRIORITY_LOW) qset->numOfLowQueues++;
+  atomic_store_ptr(&queue->qset, qset);
 
   pthread_mutex_unlock(&qset->mutex);
 
@@ -326,12 +413,10 @@ void taosRemoveFromQset(taos_qset p1, taos_queue p2) {
     if (tqueue) {
       if (qset->current == queue) qset->current = tqueue->next;
       qset->numOfQueues--;
+      if (queue->priority == TAOS_QPRIORITY_LOW) qset->numOfLowQueues--;
 
-      pthread_mutex_lock(&queue->mutex);
-      atomic_sub_fetch_32(&qset->numOfItems, queue->numOfItems);
-      queue->qset = NULL;
+      atomic_store_ptr(&queue->qset, NULL);
       queue->next = NULL;
-      pthread_mutex_unlock(&queue->mutex);
     }
   } 
   
@@ -349,36 +434,44 @@ int taosReadQitemFromQset(taos_qset param, int *type, void **pitem, void **phand
   STaosQnode *pNode = NULL;
   int         code = 0;
    
-  tsem_wait(&qset->sem);
+  taosWaitQset(qset);
 
   pthread_mutex_lock(&qset->mutex);
 
-  for(int i=0; i<qset->numOfQueues; ++i) {
-    if (qset->current == NULL) 
-      qset->current = qset->head;   
-    STaosQueue *queue = qset->current;
-    if (queue) qset->current = queue->next;
-    if (queue == NULL) break;
-    if (queue->head == NULL) continue;
+  // if there are low priority queues, high priority ones are scanned in the first pass and the rest in the second
+  int32_t passes = 1;
+  int32_t priority = TAOS_QPRIORITY_HIGH;
+  if (qset->numOfLowQueues > 0) {
+    passes = 2;
+    if (++qset->numOfReads % TAOS_QSET_LOW_PRIORITY_QUOTA == 0) priority = TAOS_QPRIORITY_LOW;
+  }
 
-    pthread_mutex_lock(&queue->mutex);
+  for (int32_t p = 0; p < passes && pNode == NULL; ++p) {
+    for(int i=0; i<qset->numOfQueues; ++i) {
+      if (qset->current == NULL) 
+        qset->current = qset->head;   
+      STaosQueue *queue = qset->current;
+      if (queue) qset->current = queue->next;
+      if (queue == NULL) break;
+      if (passes > 1 && queue->priority != priority) continue;
+      if (atomic_load_32(&queue->numOfItems) == 0) continue;
 
-    if (queue->head) {
-        pNode = queue->head;
-        *pitem = pNode->item;
-        if (type) *type = pNode->type;
-        if (phandle) *phandle = queue->ahandle;
-        queue->head = pNode->next;
-        if (queue->head == NULL) 
-          queue->tail = NULL;
-        queue->numOfItems--;
-        atomic_sub_fetch_32(&qset->numOfItems, 1);
-        code = 1;
-        uTrace("item:%p is read out from queue:%p, type:%d items:%d", *pitem, queue, pNode->type, queue->numOfItems);
-    } 
+      pthread_mutex_lock(&queue->mutex);
 
-    pthread_mutex_unlock(&queue->mutex);
-    if (pNode) break;
+      pNode = taosPopQnode(queue);
+      if (pNode) {
+          *pitem = pNode->item;
+          if (type) *type = pNode->type;
+          if (phandle) *phandle = queue->ahandle;
+          code = 1;
+          uTrace("item:%p is read out from queue:%p, type:%d items:%d", *pitem, queue, pNode->type, queue->numOfItems);
+      } 
+
+      pthread_mutex_unlock(&queue->mutex);
+      if (pNode) break;
+    }
+
+    priority = (priority == TAOS_QPRIORITY_HIGH) ? TAOS_QPRIORITY_LOW : TAOS_QPRIORITY_HIGH;
   }
 
   pthread_mutex_unlock(&qset->mutex);
@@ -392,7 +485,7 @@ int taosReadAllQitemsFromQset(taos_qset param, taos_qall p2, void **phandle) {
   STaosQall  *qall = (STaosQall *)p2;
   int         code = 0;
 
-  tsem_wait(&qset->sem);
+  taosWaitQset(qset);
   pthread_mutex_lock(&qset->mutex);
 
   for(int i=0; i<qset->numOfQueues; ++i) {
@@ -401,28 +494,18 @@ int taosReadAllQitemsFromQset(taos_qset param, taos_qall p2, void **phandle) {
     queue = qset->current;
     if (queue) qset->current = queue->next;
     if (queue == NULL) break;
-    if (queue->head == NULL) continue;
+    if (atomic_load_32(&queue->numOfItems) == 0) continue;
 
     pthread_mutex_lock(&queue->mutex);
-
-    if (queue->head) {
-      qall->current = queue->head;
-      qall->start = queue->head;
-      qall->numOfItems = queue->numOfItems;
-      qall->itemSize = queue->itemSize;
-      code = qall->numOfItems;
-      *phandle = queue->ahandle;
-          
-      queue->head = NULL;
-      queue->tail = NULL;
-      queue->numOfItems = 0;
-      atomic_sub_fetch_32(&qset->numOfItems, qall->numOfItems);
-      for (int j=1; j<qall->numOfItems; ++j) tsem_wait(&qset->sem);
-    } 
-
+    code = taosPopAllQnodes(queue, qall);
+    if (code > 0) *phandle = queue->ahandle;
     pthread_mutex_unlock(&queue->mutex);
 
-    if (code != 0) break;  
+    if (code != 0) {
+      // one token is posted for each item, the first one is taken by taosWaitQset
+      for (int j=1; j<code; ++j) tsem_wait(&qset->sem);
+      break;
+    }
   }
 
   pthread_mutex_unlock(&qset->mutex);
@@ -433,11 +516,7 @@ int taosGetQueueItemsNumber(taos_queue param) {
   STaosQueue *queue = (STaosQueue *)param;
   if (!queue) return 0;
 
-  int num;
-  pthread_mutex_lock(&queue->mutex);
-  num = queue->numOfItems;
-  pthread_mutex_unlock(&queue->mutex);
-  return num;
+  return atomic_load_32(&queue->numOfItems);
 }
 
 int taosGetQsetItemsNumber(taos_qset param) {
@@ -446,7 +525,9 @@ int taosGetQsetItemsNumber(taos_qset param) {
 
   int num = 0;
   pthread_mutex_lock(&qset->mutex);
-  num = qset->numOfItems;
+  for (STaosQueue *queue = qset->head; queue; queue = queue->next) {
+    num += atomic_load_32(&queue->numOfItems);
+  }
   pthread_mutex_unlock(&qset->mutex);
   return num;
 }
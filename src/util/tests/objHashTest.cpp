@@ -0,0 +1,213 @@
+#include "os.h"
+#include <gtest/gtest.h>
+#include <taosdef.h>
+#include <iostream>
+#include <set>
+
+#include "taos.h"
+#include "tobjhash.h"
+
+namespace {
+typedef struct {
+  char   *name;
+  int32_t value;
+} SObj;
+
+const void *getObjKey(void *param, const void *pObj, uint32_t *keyLen) {
+  const char *name = ((const SObj *)pObj)->name;
+  *keyLen = (uint32_t)strlen(name);
+  return name;
+}
+
+SObj *createObj(int32_t i) {
+  char name[32] = {0};
+  sprintf(name, "db.t%d", i);
+
+  SObj *pObj = (SObj *)malloc(sizeof(SObj) + strlen(name) + 1);
+  pObj->name = (char *)(pObj + 1);
+  strcpy(pObj->name, name);
+  pObj->value = i;
+  return pObj;
+}
+
+SObj *getObj(SObjHash *pHash, int32_t i) {
+  char name[32] = {0};
+  sprintf(name, "db.t%d", i);
+  return (SObj *)taosObjHashGet(pHash, name, (uint32_t)strlen(name));
+}
+
+SObj *removeObj(SObjHash *pHash, int32_t i) {
+  char name[32] = {0};
+  sprintf(name, "db.t%d", i);
+  return (SObj *)taosObjHashRemove(pHash, name, (uint32_t)strlen(name));
+}
+
+void cleanup(SObjHash *pHash) {
+  void *pIter = NULL;
+  SObj *pObj = NULL;
+  while ((pIter = taosObjHashIterate(pHash, pIter, (void **)&pObj)) != NULL) {
+    free(pObj);
+  }
+  taosObjHashCleanup(pHash);
+}
+
+void putGetTest() {
+  SObjHash *pHash = taosObjHashInit(8, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), getObjKey, NULL);
+  ASSERT_EQ(taosObjHashGetSize(pHash), 0);
+
+  for (int32_t i = 0; i < 10000; ++i) {
+    ASSERT_EQ(taosObjHashPut(pHash, createObj(i)), 0);
+  }
+  ASSERT_EQ(taosObjHashGetSize(pHash), 10000);
+
+  for (int32_t i = 0; i < 10000; ++i) {
+    SObj *pObj = getObj(pHash, i);
+    ASSERT_TRUE(pObj != nullptr);
+    ASSERT_EQ(pObj->value, i);
+  }
+  ASSERT_TRUE(getObj(pHash, 10000) == nullptr);
+
+  // the object of the same key is replaced
+  SObj *pOld = getObj(pHash, 5);
+  SObj *pNew = createObj(5);
+  pNew->value = -5;
+  ASSERT_EQ(taosObjHashPut(pHash, pNew), 0);
+  ASSERT_EQ(taosObjHashGetSize(pHash), 10000);
+  ASSERT_EQ(getObj(pHash, 5)->value, -5);
+  free(pOld);
+
+  cleanup(pHash);
+}
+
+void removeTest() {
+  SObjHash *pHash = taosObjHashInit(8, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), getObjKey, NULL);
+
+  for (int32_t i = 0; i < 1000; ++i) {
+    taosObjHashPut(pHash, createObj(i));
+  }
+
+  for (int32_t i = 0; i < 1000; i += 2) {
+    SObj *pObj = removeObj(pHash, i);
+    ASSERT_TRUE(pObj != nullptr);
+    ASSERT_EQ(pObj->value, i);
+    free(pObj);
+  }
+  ASSERT_TRUE(removeObj(pHash, 0) == nullptr);
+  ASSERT_EQ(taosObjHashGetSize(pHash), 500);
+
+  for (int32_t i = 0; i < 1000; ++i) {
+    ASSERT_EQ(getObj(pHash, i) == nullptr, i % 2 == 0);
+  }
+
+  // the holes are reused
+  int64_t memSize = taosObjHashGetMemSize(pHash);
+  for (int32_t i = 0; i < 1000; i += 2) {
+    taosObjHashPut(pHash, createObj(i));
+  }
+  ASSERT_EQ(taosObjHashGetSize(pHash), 1000);
+  ASSERT_EQ(taosObjHashGetMemSize(pHash), memSize);
+
+  // put and remove many times, the removed slots are dropped while resize
+  for (int32_t n = 0; n < 100; ++n) {
+    for (int32_t i = 1000; i < 1100; ++i) {
+      taosObjHashPut(pHash, createObj(i));
+    }
+    for (int32_t i = 1000; i < 1100; ++i) {
+      free(removeObj(pHash, i));
+    }
+    if (n == 0) memSize = taosObjHashGetMemSize(pHash);
+  }
+  ASSERT_EQ(taosObjHashGetSize(pHash), 1000);
+  ASSERT_EQ(taosObjHashGetMemSize(pHash), memSize);
+
+  cleanup(pHash);
+}
+
+void iterateTest() {
+  SObjHash *pHash = taosObjHashInit(8, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), getObjKey, NULL);
+
+  for (int32_t i = 0; i < 1000; ++i) {
+    taosObjHashPut(pHash, createObj(i));
+  }
+
+  // remove the objects while iterating, all of them are visited once
+  std::set<int32_t> visited;
+  void *pIter = NULL;
+  SObj *pObj = NULL;
+  while ((pIter = taosObjHashIterate(pHash, pIter, (void **)&pObj)) != NULL) {
+    ASSERT_TRUE(visited.insert(pObj->value).second);
+    if (pObj->value % 3 == 0) {
+      free(removeObj(pHash, pObj->value));
+    }
+  }
+
+  ASSERT_EQ(visited.size(), 1000u);
+  ASSERT_EQ(taosObjHashGetSize(pHash), 1000 - 334);
+  ASSERT_TRUE(pObj == nullptr);
+
+  cleanup(pHash);
+}
+
+void compactTest() {
+  SObjHash *pHash = taosObjHashInit(8, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), getObjKey, NULL);
+
+  for (int32_t i = 0; i < 10000; ++i) {
+    taosObjHashPut(pHash, createObj(i));
+  }
+  int64_t memSize = taosObjHashGetMemSize(pHash);
+
+  // the rows are not compacted during an iteration, which is stopped and cancelled here
+  void *pIter = NULL;
+  SObj *pObj = NULL;
+  pIter = taosObjHashIterate(pHash, pIter, (void **)&pObj);
+  ASSERT_TRUE(pIter != nullptr);
+  for (int32_t i = 0; i < 9000; ++i) {
+    free(removeObj(pHash, i));
+  }
+  ASSERT_EQ(taosObjHashGetMemSize(pHash), memSize);
+  taosObjHashCancelIterate(pHash, pIter);
+
+  // compacted by the next remove, with the objects left kept
+  free(removeObj(pHash, 9000));
+  ASSERT_LT(taosObjHashGetMemSize(pHash), memSize / 4);
+  ASSERT_EQ(taosObjHashGetSize(pHash), 999);
+  for (int32_t i = 9001; i < 10000; ++i) {
+    pObj = getObj(pHash, i);
+    ASSERT_TRUE(pObj != nullptr);
+    ASSERT_EQ(pObj->value, i);
+  }
+
+  // an iteration to the end does not hold the compaction either
+  std::set<int32_t> visited;
+  pIter = NULL;
+  while ((pIter = taosObjHashIterate(pHash, pIter, (void **)&pObj)) != NULL) {
+    ASSERT_TRUE(visited.insert(pObj->value).second);
+  }
+  ASSERT_EQ(visited.size(), 999u);
+
+  memSize = taosObjHashGetMemSize(pHash);
+  for (int32_t i = 9001; i < 9900; ++i) {
+    free(removeObj(pHash, i));
+  }
+  ASSERT_LT(taosObjHashGetMemSize(pHash), memSize);
+  ASSERT_EQ(taosObjHashGetSize(pHash), 100);
+
+  // the objects put after the compaction are found
+  for (int32_t i = 0; i < 100; ++i) {
+    taosObjHashPut(pHash, createObj(i));
+  }
+  for (int32_t i = 0; i < 100; ++i) {
+    ASSERT_EQ(getObj(pHash, i)->value, i);
+    ASSERT_EQ(getObj(pHash, i + 9900)->value, i + 9900);
+  }
+
+  cleanup(pHash);
+}
+}  // namespace
+
+TEST(testCase, objHashTest) {
+  putGetTest();
+  removeTest();
+  iterateTest();
+  compactTest();
+}
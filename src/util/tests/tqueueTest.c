@@ -0,0 +1,233 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+#include "os.h"
+#include "tqueue.h"
+#include "tlog.h"
+#include "tulog.h"
+
+/*
+  Contention benchmark for taos_queue. Several producers write into one queue that is consumed
+  through a qset by one worker reading in batches, the same way vnode write workers do. The same
+  workload is run against a reference queue guarded by a mutex, which is how taos_queue used to be
+  implemented, and the results are compared. The per-producer order of the items is verified.
+*/
+
+typedef struct {
+  int32_t producer;
+  int32_t seq;
+} SQItem;
+
+typedef struct SMQnode {
+  struct SMQnode *next;
+  SQItem          item;
+} SMQnode;
+
+// reference queue: every write and read is serialized on a mutex, wakeup through a semaphore
+typedef struct {
+  pthread_mutex_t mutex;
+  tsem_t          sem;
+  SMQnode        *head;
+  SMQnode        *tail;
+} SMutexQueue;
+
+typedef struct {
+  int          lockFree;
+  int          producers;
+  int          items;
+  taos_queue   queue;
+  taos_qset    qset;
+  taos_qall    qall;
+  SMutexQueue  mqueue;
+  int32_t     *lastSeq;
+  int64_t      numOfReads;
+  int64_t      errors;
+} SQBench;
+
+typedef struct {
+  SQBench *pBench;
+  int32_t  id;
+} SQProducer;
+
+static void mqueueWrite(SMutexQueue *pQueue, SMQnode *pNode) {
+  pNode->next = NULL;
+  pthread_mutex_lock(&pQueue->mutex);
+  if (pQueue->tail) {
+    pQueue->tail->next = pNode;
+  } else {
+    pQueue->head = pNode;
+  }
+  pQueue->tail = pNode;
+  pthread_mutex_unlock(&pQueue->mutex);
+  tsem_post(&pQueue->sem);
+}
+
+static SMQnode *mqueueReadAll(SMutexQueue *pQueue, int *num) {
+  tsem_wait(&pQueue->sem);
+  pthread_mutex_lock(&pQueue->mutex);
+  SMQnode *pNode = pQueue->head;
+  pQueue->head = NULL;
+  pQueue->tail = NULL;
+  pthread_mutex_unlock(&pQueue->mutex);
+
+  *num = 0;
+  for (SMQnode *p = pNode; p; p = p->next) (*num)++;
+  for (int i = 1; i < *num; ++i) tsem_wait(&pQueue->sem);
+  return pNode;
+}
+
+static void checkItem(SQBench *pBench, SQItem *pItem) {
+  if (pItem->seq != pBench->lastSeq[pItem->producer] + 1) pBench->errors++;
+  pBench->lastSeq[pItem->producer] = pItem->seq;
+}
+
+static void *produce(void *param) {
+  SQProducer *pProducer = (SQProducer *)param;
+  SQBench    *pBench = pProducer->pBench;
+
+  for (int32_t i = 0; i < pBench->items; ++i) {
+    if (pBench->lockFree) {
+      SQItem *pItem = taosAllocateQitem(sizeof(SQItem));
+      pItem->producer = pProducer->id;
+      pItem->seq = i;
+      taosWriteQitem(pBench->queue, 0, pItem);
+    } else {
+      SMQnode *pNode = malloc(sizeof(SMQnode));
+      pNode->item.producer = pProducer->id;
+      pNode->item.seq = i;
+      mqueueWrite(&pBench->mqueue, pNode);
+    }
+  }
+
+  return NULL;
+}
+
+static void *consume(void *param) {
+  SQBench *pBench = (SQBench *)param;
+  int64_t  total = (int64_t)pBench->producers * pBench->items;
+  int64_t  received = 0;
+
+  while (received < total) {
+    int num = 0;
+    pBench->numOfReads++;
+
+    if (pBench->lockFree) {
+      void *ahandle = NULL;
+      num = taosReadAllQitemsFromQset(pBench->qset, pBench->qall, &ahandle);
+      for (int i = 0; i < num; ++i) {
+        int     type;
+        SQItem *pItem = NULL;
+        taosGetQitem(pBench->qall, &type, (void **)&pItem);
+        checkItem(pBench, pItem);
+        taosFreeQitem(pItem);
+      }
+    } else {
+      SMQnode *pNode = mqueueReadAll(&pBench->mqueue, &num);
+      while (pNode) {
+        SMQnode *pNext = pNode->next;
+        checkItem(pBench, &pNode->item);
+        free(pNode);
+        pNode = pNext;
+      }
+    }
+
+    received += num;
+  }
+
+  return NULL;
+}
+
+static int runBench(int lockFree, int producers, int items) {
+  SQBench bench;
+  memset(&bench, 0, sizeof(bench));
+  bench.lockFree = lockFree;
+  bench.producers = producers;
+  bench.items = items;
+  bench.lastSeq = malloc(sizeof(int32_t) * producers);
+  for (int i = 0; i < producers; ++i) bench.lastSeq[i] = -1;
+
+  if (lockFree) {
+    bench.queue = taosOpenQueue();
+    bench.qset = taosOpenQset();
+    bench.qall = taosAllocateQall();
+    taosAddIntoQset(bench.qset, bench.queue, NULL);
+  } else {
+    pthread_mutex_init(&bench.mqueue.mutex, NULL);
+    tsem_init(&bench.mqueue.sem, 0, 0);
+  }
+
+  SQProducer *pProducers = calloc(producers, sizeof(SQProducer));
+  pthread_t  *pThreads = calloc(producers, sizeof(pthread_t));
+  pthread_t   consumer;
+
+  int64_t st = taosGetTimestampUs();
+  pthread_create(&consumer, NULL, consume, &bench);
+  for (int i = 0; i < producers; ++i) {
+    pProducers[i].pBench = &bench;
+    pProducers[i].id = i;
+    pthread_create(pThreads + i, NULL, produce, pProducers + i);
+  }
+
+  for (int i = 0; i < producers; ++i) pthread_join(pThreads[i], NULL);
+  pthread_join(consumer, NULL);
+  int64_t elapsed = taosGetTimestampUs() - st;
+  if (elapsed <= 0) elapsed = 1;
+
+  int64_t total = (int64_t)producers * items;
+  printf("%-10s producers:%3d items:%" PRId64 " elapsed:%8.3f ms  %8.3f Mitems/s  avg batch:%8.2f  errors:%" PRId64 "\n",
+         lockFree ? "lock-free" : "mutex", producers, total, elapsed / 1000.0, total / (double)elapsed,
+         total / (double)bench.numOfReads, bench.errors);
+
+  if (lockFree) {
+    if (taosGetQueueItemsNumber(bench.queue) != 0) bench.errors++;
+    taosFreeQall(bench.qall);
+    taosCloseQueue(bench.queue);
+    taosCloseQset(bench.qset);
+  } else {
+    pthread_mutex_destroy(&bench.mqueue.mutex);
+    tsem_destroy(&bench.mqueue.sem);
+  }
+
+  free(pProducers);
+  free(pThreads);
+  free(bench.lastSeq);
+
+  return bench.errors == 0 ? 0 : -1;
+}
+
+int main(int argc, char *argv[]) {
+  int producers = 8;
+  int items = 200000;
+  int loops = 1;
+
+  uDebugFlag = 131;
+
+  for (int i=1; i<argc; ++i) {
+    if (strcmp(argv[i], "-p")==0 && i < argc-1) {
+      producers = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-n")==0 && i < argc-1) {
+      items = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-l")==0 && i < argc-1) {
+      loops = atoi(argv[++i]);
+    } else {
+      printf("\nusage: %s [options] \n", argv[0]);
+      printf("  [-p]: max number of producer threads, it is doubled from 1 in each round, default: %d\n", producers);
+      printf("  [-n]: number of items written by each producer, default: %d\n", items);
+      printf("  [-l]: number of loops, default: %d\n", loops);
+      exit(0);
+    }
+  }
+
+  int code = 0;
+  for (int l = 0; l < loops; ++l) {
+    for (int p = 1; p <= producers; p *= 2) {
+      if (runBench(0, p, items) != 0) code = -1;
+      if (runBench(1, p, items) != 0) code = -1;
+    }
+  }
+
+  if (code != 0) printf("items are lost or out of order\n");
+  return code;
+}
@@ -35,6 +35,18 @@ extern int32_t vNumOfExistedQHandle;   // current initialized and existed query
 #define vDebug(...) { if (vDebugFlag & DEBUG_DEBUG) { taosPrintLog("VND ", vDebugFlag, __VA_ARGS__); }}
 #define vTrace(...) { if (vDebugFlag & DEBUG_TRACE) { taosPrintLog("VND ", vDebugFlag, __VA_ARGS__); }}
 
+// the rolling load of a vnode reported to mnode, the rates are averaged over VNODE_LOAD_WINDOW_MS
+typedef struct {
+  int64_t startTime;  // ms of the first sample
+  int64_t lastTime;   // ms of the last sample
+  int64_t lastWrittenBytes;
+  int64_t lastPointsWritten;
+  int64_t lastQueryTimeUs;
+  double  writeBytesRate;
+  double  writeRowsRate;
+  double  queryTimeRate;
+} SVnodeLoadStat;
+
 typedef struct {
   int32_t  vgId;      // global vnode group ID
   int32_t  refCount;  // reference count
@@ -59,12 +71,14 @@ typedef struct {
   uint32_t tblMsgVer; // create table msg version
   void *   wqueue;    // write queue
   void *   qqueue;    // read query queue
+  void *   lqueue;    // read query queue for long running queries, served after qqueue
   void *   fqueue;    // read fetch/cancel queue
   void *   wal;
   void *   tsdb;
   int64_t  sync;
   void *   events;
   void *   cq;  // continuous query
+  void *   sub; // subscribe requests waiting for the submits
   int32_t  dbCfgVersion;
   int32_t  vgCfgVersion;
   STsdbCfg tsdbCfg;
@@ -75,6 +89,9 @@ typedef struct {
   tsem_t   sem;
   char     db[TSDB_ACCT_ID_LEN + TSDB_DB_NAME_LEN];
   pthread_mutex_t statusMutex;
+  int64_t  writtenBytes;  // bytes of the write msgs processed, WAL restore excluded
+  int64_t  queryTimeUs;   // time spent on the query and fetch msgs
+  SVnodeLoadStat loadStat;
 } SVnodeObj;
 
 #ifdef __cplusplus
@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TDENGINE_VNODE_SUB_H
+#define TDENGINE_VNODE_SUB_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "vnodeInt.h"
+
+// the subscribe requests wait in the vnode until the tables they subscribe are written, the waiting requests are kept
+// in memory only, they are responded with TSDB_CODE_APP_NOT_READY once the vnode is closed
+int32_t vnodeOpenSub(SVnodeObj *pVnode);
+void    vnodeCloseSub(SVnodeObj *pVnode);
+int32_t vnodeProcessSubscribeMsg(SVnodeObj *pVnode, SVReadMsg *pRead);
+
+// called after the submit message is inserted into tsdb, the message is already converted to host order
+void    vnodeNotifySubscribers(SVnodeObj *pVnode, SSubmitMsg *pMsg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -29,6 +29,7 @@
 #include "vnodeWorker.h"
 #include "vnodeBackup.h"
 #include "vnodeMain.h"
+#include "vnodeSub.h"
 
 static int32_t vnodeProcessTsdbStatus(void *arg, int32_t status, int32_t eno);
 
@@ -294,8 +295,9 @@ int32_t vnodeOpen(int32_t vgId) {
   
   pVnode->wqueue = dnodeAllocVWriteQueue(pVnode);
   pVnode->qqueue = dnodeAllocVQueryQueue(pVnode);
+  pVnode->lqueue = dnodeAllocVLQueryQueue(pVnode);
   pVnode->fqueue = dnodeAllocVFetchQueue(pVnode);
-  if (pVnode->wqueue == NULL || pVnode->qqueue == NULL || pVnode->fqueue == NULL) {
+  if (pVnode->wqueue == NULL || pVnode->qqueue == NULL || pVnode->lqueue == NULL || pVnode->fqueue == NULL) {
     vnodeCleanUp(pVnode);
     return terrno;
   }
@@ -382,6 +384,12 @@ int32_t vnodeOpen(int32_t vgId) {
     return terrno;
   }
 
+  code = vnodeOpenSub(pVnode);
+  if (code != TSDB_CODE_SUCCESS) {
+    vnodeCleanUp(pVnode);
+    return code;
+  }
+
   pVnode->events = NULL;
 
   vDebug("vgId:%d, vnode is opened in %s - %s, pVnode:%p", pVnode->vgId, rootDir, walRootDir, pVnode);
@@ -457,6 +465,9 @@ void vnodeDestroy(SVnodeObj *pVnode) {
     pVnode->tsdb = NULL;
   }
 
+  // respond the subscribe requests still waiting
+  vnodeCloseSub(pVnode);
+
   // stop continuous query
   if (pVnode->cq) {
     void *cq = pVnode->cq;
@@ -484,6 +495,11 @@ void vnodeDestroy(SVnodeObj *pVnode) {
     pVnode->qqueue = NULL;
   }
 
+  if (pVnode->lqueue) {
+    dnodeFreeVQueryQueue(pVnode->lqueue);
+    pVnode->lqueue = NULL;
+  }
+
   if (pVnode->fqueue) {
     dnodeFreeVFetchQueue(pVnode->fqueue);
     pVnode->fqueue = NULL;
@@ -18,11 +18,14 @@
 #include "dnode.h"
 #include "vnodeStatus.h"
 #include "vnodeBackup.h"
+#include "vnodeMigrate.h"
 #include "vnodeWorker.h"
 #include "vnodeRead.h"
 #include "vnodeWrite.h"
 #include "vnodeMain.h"
 
+#define VNODE_LOAD_WINDOW_MS 60000
+
 static SHashObj *tsVnodesHash = NULL;
 
 static int32_t vnodeInitHash(void);
@@ -35,7 +38,8 @@ static SStep tsVnodeSteps[] = {
   {"vnode-write",  vnodeInitWrite,      vnodeCleanupWrite},
   {"vnode-read",   vnodeInitRead,       vnodeCleanupRead},
   {"vnode-hash",   vnodeInitHash,       vnodeCleanupHash},
-  {"tsdb-queue",   tsdbInitCommitQueue, tsdbDestroyCommitQueue}
+  {"tsdb-queue",   tsdbInitCommitQueue, tsdbDestroyCommitQueue},
+  {"vnode-migrate", vnodeInitMigrate,   vnodeCleanupMigrate}
 };
 
 int32_t vnodeInitMgmt() {
@@ -139,6 +143,40 @@ void *vnodeAcquireNotClose(int32_t vgId) {
   return pVnode;
 }
 
+static double vnodeRollRate(double rate, int64_t delta, int64_t elapsed, double weight) {
+  // the counters restart from zero after the tsdb is reset
+  double sample = (delta > 0) ? delta * 1000.0 / elapsed : 0;
+  return rate + (sample - rate) * weight;
+}
+
+// called by the status timer only, so the rolling rates are updated without lock
+static void vnodeUpdateLoadStat(SVnodeObj *pVnode, int64_t pointsWritten) {
+  SVnodeLoadStat *pStat = &pVnode->loadStat;
+  int64_t         now = taosGetTimestampMs();
+  int64_t         writtenBytes = atomic_load_64(&pVnode->writtenBytes);
+  int64_t         queryTimeUs = atomic_load_64(&pVnode->queryTimeUs);
+
+  if (pStat->startTime == 0) pStat->startTime = now;
+
+  if (pStat->lastTime > 0 && now > pStat->lastTime) {
+    // before a whole window is sampled, the rates are the averages since the vnode is opened, so the vnode just
+    // moved in is not taken as an idle one
+    int64_t elapsed = now - pStat->lastTime;
+    int64_t window = MIN(VNODE_LOAD_WINDOW_MS, now - pStat->startTime);
+    double  weight = MIN(1.0, (double)elapsed / window);
+    pStat->writeBytesRate =
+        vnodeRollRate(pStat->writeBytesRate, writtenBytes - pStat->lastWrittenBytes, elapsed, weight);
+    pStat->writeRowsRate =
+        vnodeRollRate(pStat->writeRowsRate, pointsWritten - pStat->lastPointsWritten, elapsed, weight);
+    pStat->queryTimeRate = vnodeRollRate(pStat->queryTimeRate, queryTimeUs - pStat->lastQueryTimeUs, elapsed, weight);
+  }
+
+  pStat->lastTime = now;
+  pStat->lastWrittenBytes = writtenBytes;
+  pStat->lastPointsWritten = pointsWritten;
+  pStat->lastQueryTimeUs = queryTimeUs;
+}
+
 static void vnodeBuildVloadMsg(SVnodeObj *pVnode, SStatusMsg *pStatus) {
   int64_t totalStorage = 0;
   int64_t compStorage = 0;
@@ -150,6 +188,7 @@ static void vnodeBuildVloadMsg(SVnodeObj *pVnode, SStatusMsg *pStatus) {
   if (pVnode->tsdb) {
     tsdbReportStat(pVnode->tsdb, &pointsWritten, &totalStorage, &compStorage);
   }
+  vnodeUpdateLoadStat(pVnode, pointsWritten);
 
   SVnodeLoad *pLoad = &pStatus->load[pStatus->openVnodes++];
   pLoad->vgId = htonl(pVnode->vgId);
@@ -163,6 +202,9 @@ static void vnodeBuildVloadMsg(SVnodeObj *pVnode, SStatusMsg *pStatus) {
   pLoad->role = pVnode->role;
   pLoad->replica = pVnode->syncCfg.replica;  
   pLoad->compact = (pVnode->tsdb != NULL) ? tsdbGetCompactState(pVnode->tsdb) : 0; 
+  pLoad->writeBytesRate = htobe64((int64_t)pVnode->loadStat.writeBytesRate);
+  pLoad->writeRowsRate = htobe64((int64_t)pVnode->loadStat.writeRowsRate);
+  pLoad->queryTimeRate = htobe64((int64_t)pVnode->loadStat.queryTimeRate);
 }
 
 int32_t vnodeGetVnodeList(int32_t vnodeList[], int32_t *numOfVnodes) {
@@ -186,6 +228,32 @@ int32_t vnodeGetVnodeList(int32_t vnodeList[], int32_t *numOfVnodes) {
   return TSDB_CODE_SUCCESS;
 }
 
+static void vnodeBuildFSetLoadMsg(SVnodeObj *pVnode, SStatusMsg *pStatus) {
+  STsdbFSetStat stats[TSDB_MAX_VNODE_FSET_LOADS];
+
+  if (vnodeInClosingStatus(pVnode) || pVnode->tsdb == NULL) return;
+
+  int32_t maxNum = MIN(TSDB_MAX_VNODE_FSET_LOADS, TSDB_MAX_FSET_LOADS - pStatus->numOfFSets);
+  if (maxNum <= 0) return;
+
+  int32_t num = tsdbGetFSetStats(pVnode->tsdb, stats, maxNum);
+  if (num <= 0) return;
+
+  // the file sets follow the vnode loads
+  SFSetLoad *pLoads = (SFSetLoad *)(pStatus->load + pStatus->openVnodes);
+  for (int32_t i = 0; i < num; ++i) {
+    SFSetLoad *pLoad = &pLoads[pStatus->numOfFSets++];
+    pLoad->vgId = htonl(pVnode->vgId);
+    pLoad->fid = htonl(stats[i].fid);
+    pLoad->reads = htobe64(stats[i].reads);
+    pLoad->blocksRead = htobe64(stats[i].blocksRead);
+    pLoad->bytesRead = htobe64(stats[i].bytesRead);
+    pLoad->lastRead = htobe64(stats[i].lastRead);
+    pLoad->heat = (float)stats[i].heat;
+    pLoad->level = stats[i].level;
+  }
+}
+
 void vnodeBuildStatusMsg(void *param) {
   SStatusMsg *pStatus = param;
 
@@ -197,6 +265,15 @@ void vnodeBuildStatusMsg(void *param) {
     }
     pIter = taosHashIterate(tsVnodesHash, pIter);
   }
+
+  pIter = taosHashIterate(tsVnodesHash, NULL);
+  while (pIter) {
+    SVnodeObj **pVnode = pIter;
+    if (*pVnode) {
+      vnodeBuildFSetLoadMsg(*pVnode, pStatus);
+    }
+    pIter = taosHashIterate(tsVnodesHash, pIter);
+  }
 }
 
 void vnodeSetAccess(SVgroupAccess *pAccess, int32_t numOfVnodes) {
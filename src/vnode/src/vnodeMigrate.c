@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _DEFAULT_SOURCE
+#include "os.h"
+#include "tglobal.h"
+#include "vnodeStatus.h"
+#include "vnodeMgmt.h"
+#include "vnodeMigrate.h"
+
+#define VNODE_MIGRATE_MAX_FSETS 100  // file sets of a vnode moved in one round at most
+
+typedef struct {
+  pthread_t thread;
+  int8_t    stop;
+} SVMigrateWorker;
+
+static SVMigrateWorker tsVMigrate;
+
+// the file sets of the vnodes are moved one by one, so the copies of all vnodes share tierMigrateRate
+static void vnodeMigrateVnodes() {
+  int32_t vnodeList[TSDB_MAX_VNODES] = {0};
+  int32_t numOfVnodes = 0;
+
+  vnodeGetVnodeList(vnodeList, &numOfVnodes);
+  numOfVnodes = MIN(numOfVnodes, TSDB_MAX_VNODES);
+
+  for (int32_t i = 0; i < numOfVnodes && !tsVMigrate.stop; ++i) {
+    SVnodeObj *pVnode = vnodeAcquireNotClose(vnodeList[i]);
+    if (pVnode == NULL) continue;
+
+    int32_t numOfFSets = 0;
+    while (!tsVMigrate.stop && !pVnode->preClose && vnodeInReadyStatus(pVnode) &&
+           numOfFSets < VNODE_MIGRATE_MAX_FSETS) {
+      if (tsdbMigrate(pVnode->tsdb, &pVnode->preClose) <= 0) break;
+      numOfFSets++;
+    }
+
+    vnodeRelease(pVnode);
+  }
+}
+
+static void *vnodeMigrateFunc(void *param) {
+  int64_t lastTime = taosGetTimestampSec();
+
+  setThreadName("vnodeMigrate");
+
+  while (!tsVMigrate.stop) {
+    taosMsleep(1000);
+
+    int64_t now = taosGetTimestampSec();
+    if (tsTierMigrateInterval <= 0 || now - lastTime < tsTierMigrateInterval) continue;
+
+    vnodeMigrateVnodes();
+    lastTime = taosGetTimestampSec();
+  }
+
+  return NULL;
+}
+
+int32_t vnodeInitMigrate() {
+  pthread_attr_t thAttr;
+  pthread_attr_init(&thAttr);
+  pthread_attr_setdetachstate(&thAttr, PTHREAD_CREATE_JOINABLE);
+
+  tsVMigrate.stop = 0;
+  if (pthread_create(&tsVMigrate.thread, &thAttr, vnodeMigrateFunc, NULL) != 0) {
+    vError("failed to create thread to migrate vnode files, reason:%s", strerror(errno));
+    pthread_attr_destroy(&thAttr);
+    return -1;
+  }
+
+  pthread_attr_destroy(&thAttr);
+  vDebug("vmigrate is launched, interval:%ds rate:%dMB/s", tsTierMigrateInterval, tsTierMigrateRate);
+  return 0;
+}
+
+void vnodeCleanupMigrate() {
+  tsVMigrate.stop = 1;
+  if (taosCheckPthreadValid(tsVMigrate.thread)) {
+    pthread_join(tsVMigrate.thread, NULL);
+  }
+  vDebug("vmigrate is closed");
+}
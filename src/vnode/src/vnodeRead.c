@@ -20,6 +20,7 @@
 #include "tglobal.h"
 #include "query.h"
 #include "vnodeStatus.h"
+#include "vnodeSub.h"
 #include "tgrant.h"
 
 int32_t vNumOfExistedQHandle;   // current initialized and existed query handle in current dnode
@@ -33,6 +34,7 @@ static int32_t  vnodeNotifyCurrentQhandle(void* handle, uint64_t qId, void* qhan
 int32_t vnodeInitRead(void) {
   vnodeProcessReadMsgFp[TSDB_MSG_TYPE_QUERY] = vnodeProcessQueryMsg;
   vnodeProcessReadMsgFp[TSDB_MSG_TYPE_FETCH] = vnodeProcessFetchMsg;
+  vnodeProcessReadMsgFp[TSDB_MSG_TYPE_SUBSCRIBE] = vnodeProcessSubscribeMsg;
   return 0;
 }
 
@@ -52,7 +54,11 @@ int32_t vnodeProcessRead(void *vparam, SVReadMsg *pRead) {
     return TSDB_CODE_VND_MSG_NOT_PROCESSED;
   }
 
-  return (*vnodeProcessReadMsgFp[msgType])(pVnode, pRead);
+  int64_t st = taosGetTimestampUs();
+  int32_t code = (*vnodeProcessReadMsgFp[msgType])(pVnode, pRead);
+  atomic_add_fetch_64(&pVnode->queryTimeUs, taosGetTimestampUs() - st);
+
+  return code;
 }
 
 static int32_t vnodeCheckRead(SVnodeObj *pVnode) {
@@ -119,11 +125,19 @@ static SVReadMsg *vnodeBuildVReadMsg(SVnodeObj *pVnode, void *pCont, int32_t con
   }
 
   pRead->qtype = qtype;
+  pRead->queuedUs = taosGetTimestampUs();
   atomic_add_fetch_32(&pVnode->refCount, 1);
 
   return pRead;
 }
 
+static bool vnodeIsLongQuery(SVReadMsg *pRead) {
+  if (tsQueryTimeSlice <= 0 || pRead->qtype != TAOS_QTYPE_QUERY || pRead->contLen != 0) return false;
+
+  void **qhandle = (void **)pRead->qhandle;
+  return qGetQueryExecTime(*qhandle) >= (int64_t)tsQueryTimeSlice * 1000;
+}
+
 int32_t vnodeWriteToRQueue(void *vparam, void *pCont, int32_t contLen, int8_t qtype, void *rparam) {
   SVnodeObj *pVnode = vparam;
   if (pVnode->dropped) {
@@ -145,10 +159,19 @@ int32_t vnodeWriteToRQueue(void *vparam, void *pCont, int32_t contLen, int8_t qt
 
   atomic_add_fetch_32(&pVnode->queuedRMsg, 1);
 
-  if (pRead->code == TSDB_CODE_RPC_NETWORK_UNAVAIL || pRead->msgType == TSDB_MSG_TYPE_FETCH) {
+  // the subscribe requests do not scan data, they are processed along with the fetch requests
+  if (pRead->code == TSDB_CODE_RPC_NETWORK_UNAVAIL || pRead->msgType == TSDB_MSG_TYPE_FETCH ||
+      pRead->msgType == TSDB_MSG_TYPE_SUBSCRIBE) {
     vTrace("vgId:%d, write into vfetch queue, refCount:%d queued:%d", pVnode->vgId, pVnode->refCount,
            pVnode->queuedRMsg);
     return taosWriteQitem(pVnode->fqueue, qtype, pRead);
+  } else if (vnodeIsLongQuery(pRead)) {
+    // a query is resumed at result block boundaries, once it has run longer than the time slice, it yields to
+    // new queries and short running ones
+    pRead->lowPriority = 1;
+    vTrace("vgId:%d, write into vquery queue for long queries, refCount:%d queued:%d", pVnode->vgId,
+           pVnode->refCount, pVnode->queuedRMsg);
+    return taosWriteQitem(pVnode->lqueue, qtype, pRead);
   } else {
     vTrace("vgId:%d, write into vquery queue, refCount:%d queued:%d", pVnode->vgId, pVnode->refCount,
            pVnode->queuedRMsg);
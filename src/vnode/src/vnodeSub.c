@@ -0,0 +1,379 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _DEFAULT_SOURCE
+#include "os.h"
+#include "taoserror.h"
+#include "taosmsg.h"
+#include "hash.h"
+#include "tarray.h"
+#include "ttimer.h"
+#include "trpc.h"
+#include "vnodeMgmt.h"
+#include "vnodeSub.h"
+
+// the expired requests are responded by a timer, so the wait time of a request is rounded up to it
+#define VNODE_SUB_TIMER_MS 100
+
+// the tables not waited are pruned once the table hash grows to twice the size after the last prune
+#define VNODE_SUB_MIN_PRUNE_SIZE 1024
+
+extern void *tsDnodeTmr;
+
+typedef struct {
+  int64_t version;  // vnode version of the last submit of the table
+  SArray *waiters;  // SVnodeSubWaiter*, the requests waiting for the submits of the table
+} SVnodeSubTable;
+
+typedef struct {
+  void *  rpcHandle;
+  int64_t version;   // version in the request
+  int64_t expireAt;  // ms
+  int32_t numOfTables;
+  int64_t uids[];
+} SVnodeSubWaiter;
+
+typedef struct {
+  pthread_mutex_t mutex;
+  int32_t         vgId;
+  int64_t         version;  // vnode version of the last submit
+  SHashObj *      tables;   // uid -> SVnodeSubTable, the tables subscribed
+  int32_t         pruneSize;  // the size of the tables to prune them
+  SArray *        waiters;  // SVnodeSubWaiter*
+  void *          timer;
+} SVnodeSub;
+
+static void vnodeSubTimerFp(void *param, void *tmrId);
+
+int32_t vnodeOpenSub(SVnodeObj *pVnode) {
+  SVnodeSub *pSub = calloc(1, sizeof(SVnodeSub));
+  if (pSub == NULL) return TSDB_CODE_VND_OUT_OF_MEMORY;
+
+  pSub->vgId = pVnode->vgId;
+  pSub->version = (int64_t)pVnode->version;
+  pSub->tables = taosHashInit(64, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), true, HASH_NO_LOCK);
+  pSub->waiters = taosArrayInit(4, POINTER_BYTES);
+  pSub->pruneSize = VNODE_SUB_MIN_PRUNE_SIZE;
+  if (pSub->tables == NULL || pSub->waiters == NULL) {
+    taosHashCleanup(pSub->tables);
+    taosArrayDestroy(&pSub->waiters);
+    free(pSub);
+    return TSDB_CODE_VND_OUT_OF_MEMORY;
+  }
+
+  pthread_mutex_init(&pSub->mutex, NULL);
+  pVnode->sub = pSub;
+  return TSDB_CODE_SUCCESS;
+}
+
+static void vnodeSendSubscribeRsps(SArray *rsps) {
+  size_t num = taosArrayGetSize(rsps);
+  for (size_t i = 0; i < num; ++i) {
+    SRpcMsg *rpcRsp = taosArrayGet(rsps, i);
+    rpcSendResponse(rpcRsp);
+  }
+}
+
+static SRpcMsg vnodeBuildSubscribeRsp(void *rpcHandle, int64_t version, int64_t *uids, int32_t numOfTables) {
+  SRpcMsg rpcRsp = {.handle = rpcHandle};
+  int32_t len = (int32_t)(sizeof(SSubscribeRsp) + sizeof(int64_t) * numOfTables);
+
+  SSubscribeRsp *pRsp = rpcMallocCont(len);
+  if (pRsp == NULL) {
+    rpcRsp.code = TSDB_CODE_VND_OUT_OF_MEMORY;
+  } else {
+    pRsp->version = htobe64(version);
+    pRsp->numOfTables = htonl(numOfTables);
+    for (int32_t i = 0; i < numOfTables; ++i) {
+      pRsp->uids[i] = htobe64(uids[i]);
+    }
+    rpcRsp.pCont = pRsp;
+    rpcRsp.contLen = len;
+  }
+
+  return rpcRsp;
+}
+
+static SVnodeSubTable *vnodeGetSubTable(SVnodeSub *pSub, int64_t uid) {
+  SVnodeSubTable *pTable = taosHashGet(pSub->tables, &uid, sizeof(uid));
+  if (pTable != NULL) return pTable;
+
+  // a table subscribed for the first time is regarded as written by the last submit
+  SVnodeSubTable table = {.version = pSub->version};
+  if (taosHashPut(pSub->tables, &uid, sizeof(uid), &table, sizeof(table)) != 0) return NULL;
+  return taosHashGet(pSub->tables, &uid, sizeof(uid));
+}
+
+/*
+ * The tables without waiters and not written by the last submit are removed, so the short-lived subscriptions do not
+ * leave their tables behind. A removed table is regarded as written when it is subscribed again with an older version,
+ * and the subscriber only queries it once more.
+ */
+static bool vnodeKeepSubTable(void *param, void *data) {
+  SVnodeSub *     pSub = param;
+  SVnodeSubTable *pTable = data;
+
+  if ((pTable->waiters != NULL && taosArrayGetSize(pTable->waiters) > 0) || pTable->version >= pSub->version) {
+    return true;
+  }
+
+  taosArrayDestroy(&pTable->waiters);
+  return false;
+}
+
+static void vnodePruneSubTables(SVnodeSub *pSub) {
+  int32_t size = taosHashGetSize(pSub->tables);
+  if (size < pSub->pruneSize) return;
+
+  taosHashCondTraverse(pSub->tables, vnodeKeepSubTable, pSub);
+
+  int32_t remain = taosHashGetSize(pSub->tables);
+  pSub->pruneSize = MAX(VNODE_SUB_MIN_PRUNE_SIZE, remain * 2);
+  vDebug("vgId:%d, %d of %d subscribed tables are pruned", pSub->vgId, size - remain, size);
+}
+
+static void vnodeRemoveSubWaiter(SVnodeSub *pSub, SVnodeSubWaiter *pWaiter) {
+  for (int32_t i = 0; i < pWaiter->numOfTables; ++i) {
+    SVnodeSubTable *pTable = taosHashGet(pSub->tables, &pWaiter->uids[i], sizeof(int64_t));
+    if (pTable == NULL || pTable->waiters == NULL) continue;
+
+    size_t num = taosArrayGetSize(pTable->waiters);
+    for (size_t j = 0; j < num; ++j) {
+      if (taosArrayGetP(pTable->waiters, j) == pWaiter) {
+        taosArrayRemove(pTable->waiters, j);
+        break;
+      }
+    }
+  }
+
+  size_t num = taosArrayGetSize(pSub->waiters);
+  for (size_t j = 0; j < num; ++j) {
+    if (taosArrayGetP(pSub->waiters, j) == pWaiter) {
+      taosArrayRemove(pSub->waiters, j);
+      break;
+    }
+  }
+}
+
+// the tables of the request written after its version, all the tables are regarded as written if the version is
+// newer than the vnode, e.g. the vnode is restored from another replica
+static int32_t vnodeGetChangedTables(SVnodeSub *pSub, int64_t version, int64_t *uids, int32_t numOfTables,
+                                     int64_t *changed) {
+  int32_t num = 0;
+  for (int32_t i = 0; i < numOfTables; ++i) {
+    SVnodeSubTable *pTable = taosHashGet(pSub->tables, &uids[i], sizeof(int64_t));
+    if (version > pSub->version || pTable == NULL || pTable->version > version) {
+      changed[num++] = uids[i];
+    }
+  }
+  return num;
+}
+
+static void vnodeStartSubTimer(SVnodeSub *pSub) {
+  taosTmrReset(vnodeSubTimerFp, VNODE_SUB_TIMER_MS, (void *)(int64_t)pSub->vgId, tsDnodeTmr, &pSub->timer);
+}
+
+int32_t vnodeProcessSubscribeMsg(SVnodeObj *pVnode, SVReadMsg *pRead) {
+  SVnodeSub *    pSub = pVnode->sub;
+  SSubscribeMsg *pMsg = (SSubscribeMsg *)pRead->pCont;
+  if (pSub == NULL) return TSDB_CODE_APP_NOT_READY;
+
+  if (pRead->contLen < (int32_t)sizeof(SSubscribeMsg)) return TSDB_CODE_QRY_INVALID_MSG;
+  int64_t version = htobe64(pMsg->version);
+  int32_t waitTime = htonl(pMsg->waitTime);
+  int32_t numOfTables = htonl(pMsg->numOfTables);
+  if (numOfTables < 0 || pRead->contLen < (int32_t)(sizeof(SSubscribeMsg) + sizeof(int64_t) * numOfTables)) {
+    return TSDB_CODE_QRY_INVALID_MSG;
+  }
+
+  SVnodeSubWaiter *pWaiter = malloc(sizeof(SVnodeSubWaiter) + sizeof(int64_t) * numOfTables);
+  if (pWaiter == NULL) return TSDB_CODE_VND_OUT_OF_MEMORY;
+
+  pWaiter->rpcHandle = pRead->rpcHandle;
+  pWaiter->version = version;
+  pWaiter->expireAt = taosGetTimestampMs() + waitTime;
+  pWaiter->numOfTables = numOfTables;
+  for (int32_t i = 0; i < numOfTables; ++i) {
+    pWaiter->uids[i] = htobe64(pMsg->uids[i]);
+  }
+
+  pthread_mutex_lock(&pSub->mutex);
+
+  vnodePruneSubTables(pSub);
+  for (int32_t i = 0; i < numOfTables; ++i) {
+    vnodeGetSubTable(pSub, pWaiter->uids[i]);
+  }
+
+  // the changed tables are written into the front of the uids
+  int32_t numOfChanged = vnodeGetChangedTables(pSub, version, pWaiter->uids, numOfTables, pWaiter->uids);
+  if (numOfChanged > 0 || waitTime <= 0 || pRead->rpcHandle == NULL) {
+    SRpcMsg rpcRsp = vnodeBuildSubscribeRsp(NULL, pSub->version, pWaiter->uids, numOfChanged);
+    pthread_mutex_unlock(&pSub->mutex);
+
+    pRead->rspRet.rsp = rpcRsp.pCont;
+    pRead->rspRet.len = rpcRsp.contLen;
+
+    vTrace("vgId:%d, subscribe of %d tables after version:%" PRId64 " is responded, changed:%d", pVnode->vgId,
+           numOfTables, version, numOfChanged);
+    free(pWaiter);
+    return rpcRsp.code;
+  }
+
+  for (int32_t i = 0; i < numOfTables; ++i) {
+    SVnodeSubTable *pTable = taosHashGet(pSub->tables, &pWaiter->uids[i], sizeof(int64_t));
+    if (pTable == NULL) continue;
+    if (pTable->waiters == NULL) pTable->waiters = taosArrayInit(1, POINTER_BYTES);
+    taosArrayPush(pTable->waiters, &pWaiter);
+  }
+  taosArrayPush(pSub->waiters, &pWaiter);
+
+  if (pSub->timer == NULL) {
+    vnodeStartSubTimer(pSub);
+  }
+
+  pthread_mutex_unlock(&pSub->mutex);
+
+  vTrace("vgId:%d, subscribe of %d tables after version:%" PRId64 " waits for %d ms", pVnode->vgId, numOfTables,
+         version, waitTime);
+  return TSDB_CODE_QRY_NOT_READY;
+}
+
+void vnodeNotifySubscribers(SVnodeObj *pVnode, SSubmitMsg *pMsg) {
+  SVnodeSub *pSub = pVnode->sub;
+  if (pSub == NULL) return;
+
+  SArray *completed = NULL;
+
+  pthread_mutex_lock(&pSub->mutex);
+  pSub->version = (int64_t)pVnode->version;
+
+  if (taosHashGetSize(pSub->tables) > 0) {
+    int32_t len = sizeof(SSubmitMsg);
+    for (int32_t i = 0; i < pMsg->numOfBlocks && len < pMsg->length; ++i) {
+      SSubmitBlk *    pBlock = (SSubmitBlk *)POINTER_SHIFT(pMsg, len);
+      int64_t         uid = (int64_t)pBlock->uid;
+      SVnodeSubTable *pTable = taosHashGet(pSub->tables, &uid, sizeof(uid));
+      len += (int32_t)(sizeof(SSubmitBlk) + pBlock->dataLen + pBlock->schemaLen);
+      if (pTable == NULL) continue;
+
+      pTable->version = pSub->version;
+      while (pTable->waiters != NULL && taosArrayGetSize(pTable->waiters) > 0) {
+        SVnodeSubWaiter *pWaiter = taosArrayGetP(pTable->waiters, 0);
+        vnodeRemoveSubWaiter(pSub, pWaiter);
+        if (completed == NULL) completed = taosArrayInit(4, POINTER_BYTES);
+        taosArrayPush(completed, &pWaiter);
+      }
+    }
+  }
+
+  // the responses carry all the tables of a request written in the message
+  SArray *rsps = NULL;
+  size_t  numOfCompleted = (completed == NULL) ? 0 : taosArrayGetSize(completed);
+  if (numOfCompleted > 0) rsps = taosArrayInit(numOfCompleted, sizeof(SRpcMsg));
+
+  for (size_t i = 0; i < numOfCompleted; ++i) {
+    SVnodeSubWaiter *pWaiter = taosArrayGetP(completed, i);
+    int32_t num = vnodeGetChangedTables(pSub, pWaiter->version, pWaiter->uids, pWaiter->numOfTables, pWaiter->uids);
+    SRpcMsg rpcRsp = vnodeBuildSubscribeRsp(pWaiter->rpcHandle, pSub->version, pWaiter->uids, num);
+    taosArrayPush(rsps, &rpcRsp);
+    free(pWaiter);
+  }
+
+  // the timer is left to the expiry of the remaining requests
+  if (numOfCompleted > 0 && taosArrayGetSize(pSub->waiters) == 0) {
+    taosTmrStopA(&pSub->timer);
+  }
+  pthread_mutex_unlock(&pSub->mutex);
+
+  if (rsps != NULL) {
+    vTrace("vgId:%d, %d subscribes are responded at version:%" PRId64, pVnode->vgId, (int32_t)numOfCompleted,
+           (int64_t)pVnode->version);
+    vnodeSendSubscribeRsps(rsps);
+    taosArrayDestroy(&rsps);
+  }
+  taosArrayDestroy(&completed);
+}
+
+static void vnodeSubTimerFp(void *param, void *tmrId) {
+  int32_t    vgId = (int32_t)(int64_t)param;
+  SVnodeObj *pVnode = vnodeAcquire(vgId);
+  if (pVnode == NULL) return;
+
+  SVnodeSub *pSub = pVnode->sub;
+  SArray *   rsps = NULL;
+
+  if (pSub != NULL) {
+    pthread_mutex_lock(&pSub->mutex);
+    if (pSub->timer == tmrId) {
+      int64_t now = taosGetTimestampMs();
+      for (size_t i = 0; i < taosArrayGetSize(pSub->waiters);) {
+        SVnodeSubWaiter *pWaiter = taosArrayGetP(pSub->waiters, i);
+        if (pWaiter->expireAt > now) {
+          ++i;
+          continue;
+        }
+
+        vnodeRemoveSubWaiter(pSub, pWaiter);
+        if (rsps == NULL) rsps = taosArrayInit(4, sizeof(SRpcMsg));
+        SRpcMsg rpcRsp = vnodeBuildSubscribeRsp(pWaiter->rpcHandle, pSub->version, NULL, 0);
+        taosArrayPush(rsps, &rpcRsp);
+        free(pWaiter);
+      }
+
+      pSub->timer = NULL;
+      if (taosArrayGetSize(pSub->waiters) > 0) vnodeStartSubTimer(pSub);
+    }
+    pthread_mutex_unlock(&pSub->mutex);
+  }
+
+  if (rsps != NULL) {
+    vTrace("vgId:%d, %d subscribes are expired", vgId, (int32_t)taosArrayGetSize(rsps));
+    vnodeSendSubscribeRsps(rsps);
+    taosArrayDestroy(&rsps);
+  }
+
+  vnodeRelease(pVnode);
+}
+
+void vnodeCloseSub(SVnodeObj *pVnode) {
+  SVnodeSub *pSub = pVnode->sub;
+  if (pSub == NULL) return;
+  pVnode->sub = NULL;
+
+  pthread_mutex_lock(&pSub->mutex);
+  taosTmrStopA(&pSub->timer);
+  pthread_mutex_unlock(&pSub->mutex);
+
+  size_t num = taosArrayGetSize(pSub->waiters);
+  for (size_t i = 0; i < num; ++i) {
+    SVnodeSubWaiter *pWaiter = taosArrayGetP(pSub->waiters, i);
+    SRpcMsg          rpcRsp = {.handle = pWaiter->rpcHandle, .code = TSDB_CODE_APP_NOT_READY};
+    rpcSendResponse(&rpcRsp);
+    free(pWaiter);
+  }
+  taosArrayDestroy(&pSub->waiters);
+
+  SVnodeSubTable *pTable = taosHashIterate(pSub->tables, NULL);
+  while (pTable != NULL) {
+    taosArrayDestroy(&pTable->waiters);
+    pTable = taosHashIterate(pSub->tables, pTable);
+  }
+  taosHashCleanup(pSub->tables);
+
+  pthread_mutex_destroy(&pSub->mutex);
+  free(pSub);
+
+  vDebug("vgId:%d, %d subscribes are responded since vnode is closed", pVnode->vgId, (int32_t)num);
+}
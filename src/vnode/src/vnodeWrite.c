@@ -23,28 +23,42 @@
 #include "ttimer.h"
 #include "dnode.h"
 #include "vnodeStatus.h"
+#include "vnodeSub.h"
 
 #define MAX_QUEUED_MSG_NUM 100000
 #define MAX_QUEUED_MSG_SIZE 1024*1024*1024  //1GB
 
+#define VND_FLOWCTRL_MIN_DELAY_MS 10
+#define VND_FLOWCTRL_MAX_DELAY_MS 100
+#define VND_FLOWCTRL_MAX_HOLD_MS  1000  // held longer than this, the client is asked to retry later
+
+// submit latency histogram, 4 buckets per power of two microseconds
+#define VND_LATENCY_SUB_BUCKETS 4
+#define VND_LATENCY_BUCKETS     128
+
 static int64_t tsSubmitReqSucNum = 0;
 static int64_t tsSubmitRowNum = 0;
 static int64_t tsSubmitRowSucNum = 0;
+static int64_t tsSubmitLatencyHist[VND_LATENCY_BUCKETS] = {0};
 
 extern void *  tsDnodeTmr;
 static int32_t (*vnodeProcessWriteMsgFp[TSDB_MSG_TYPE_MAX])(SVnodeObj *, void *pCont, SRspRet *);
 static int32_t vnodeProcessSubmitMsg(SVnodeObj *pVnode, void *pCont, SRspRet *);
+static int32_t vnodeProcessSubmitMsgImp(SVnodeObj *pVnode, void *pCont, SRspRet *, STsdbRetainMsg *pRetain);
 static int32_t vnodeProcessCreateTableMsg(SVnodeObj *pVnode, void *pCont, SRspRet *);
+static int32_t vnodeProcessCreateTablesMsg(SVnodeObj *pVnode, void *pCont, SRspRet *);
 static int32_t vnodeProcessDropTableMsg(SVnodeObj *pVnode, void *pCont, SRspRet *);
 static int32_t vnodeProcessAlterTableMsg(SVnodeObj *pVnode, void *pCont, SRspRet *);
 static int32_t vnodeProcessDropStableMsg(SVnodeObj *pVnode, void *pCont, SRspRet *);
 static int32_t vnodeProcessUpdateTagValMsg(SVnodeObj *pVnode, void *pCont, SRspRet *);
 static int32_t vnodePerformFlowCtrl(SVWriteMsg *pWrite);
 static int32_t vnodeCheckWal(SVnodeObj *pVnode);
+static void    vnodeDestroyVWriteMsg(SVWriteMsg *pWrite);
 
 int32_t vnodeInitWrite(void) {
   vnodeProcessWriteMsgFp[TSDB_MSG_TYPE_SUBMIT]          = vnodeProcessSubmitMsg;
   vnodeProcessWriteMsgFp[TSDB_MSG_TYPE_MD_CREATE_TABLE] = vnodeProcessCreateTableMsg;
+  vnodeProcessWriteMsgFp[TSDB_MSG_TYPE_MD_CREATE_TABLES] = vnodeProcessCreateTablesMsg;
   vnodeProcessWriteMsgFp[TSDB_MSG_TYPE_MD_DROP_TABLE]   = vnodeProcessDropTableMsg;
   vnodeProcessWriteMsgFp[TSDB_MSG_TYPE_MD_ALTER_TABLE]  = vnodeProcessAlterTableMsg;
   vnodeProcessWriteMsgFp[TSDB_MSG_TYPE_MD_DROP_STABLE]  = vnodeProcessDropStableMsg;
@@ -95,7 +109,7 @@ int32_t vnodeProcessWrite(void *vparam, void *wparam, int32_t qtype, void *rpara
 
   // forward to peers, even it is WAL/FWD, it shall be called to update version in sync
   int32_t syncCode = 0;
-  bool    force = (pWrite == NULL ? false : pWrite->walHead.msgType != TSDB_MSG_TYPE_SUBMIT);
+  bool    force = (pWrite == NULL ? false : pWrite->pHead->msgType != TSDB_MSG_TYPE_SUBMIT);
   syncCode = syncForwardToPeer(pVnode->sync, pHead, pWrite, qtype, force);
   if (syncCode < 0) {
     pHead->version = 0;
@@ -116,12 +130,20 @@ int32_t vnodeProcessWrite(void *vparam, void *wparam, int32_t qtype, void *rpara
   pVnode->version = pHead->version;
 
   // write data locally
-  code = (*vnodeProcessWriteMsgFp[pHead->msgType])(pVnode, pHead->cont, pRspRet);
+  if (pWrite != NULL && pWrite->pRetain != NULL) {
+    code = vnodeProcessSubmitMsgImp(pVnode, pHead->cont, pRspRet, pWrite->pRetain);
+  } else {
+    code = (*vnodeProcessWriteMsgFp[pHead->msgType])(pVnode, pHead->cont, pRspRet);
+  }
   if (code < 0) {
     if (syncCode > 0) atomic_sub_fetch_32(&pWrite->processedCount, 1);
     return code;
   }
 
+  if (qtype != TAOS_QTYPE_WAL) {
+    atomic_add_fetch_64(&pVnode->writtenBytes, pHead->len);
+  }
+
   return syncCode;
 }
 
@@ -153,6 +175,10 @@ static int32_t vnodeCheckWrite(SVnodeObj *pVnode) {
 }
 
 static int32_t vnodeProcessSubmitMsg(SVnodeObj *pVnode, void *pCont, SRspRet *pRet) {
+  return vnodeProcessSubmitMsgImp(pVnode, pCont, pRet, NULL);
+}
+
+static int32_t vnodeProcessSubmitMsgImp(SVnodeObj *pVnode, void *pCont, SRspRet *pRet, STsdbRetainMsg *pRetain) {
   int32_t code = TSDB_CODE_SUCCESS;
 
   vTrace("vgId:%d, submit msg is processed", pVnode->vgId);
@@ -169,10 +195,11 @@ static int32_t vnodeProcessSubmitMsg(SVnodeObj *pVnode, void *pCont, SRspRet *pR
     pRsp = pRet->rsp;
   }
 
-  if (tsdbInsertData(pVnode->tsdb, pCont, pRsp) < 0) {
+  if (tsdbInsertDataRetained(pVnode->tsdb, pCont, pRsp, pRetain) < 0) {
     code = terrno;
   } else {
     if (pRsp != NULL) atomic_fetch_add_64(&tsSubmitReqSucNum, 1);
+    vnodeNotifySubscribers(pVnode, pCont);
   }
 
   if (pRsp) {
@@ -212,6 +239,58 @@ static int32_t vnodeProcessCreateTableMsg(SVnodeObj *pVnode, void *pCont, SRspRe
   return code;
 }
 
+// the lengths of the tables shall add up within the message, otherwise none of them is created, the length of the
+// message itself is converted into host order by dnode as the head of any write msg
+static bool vnodeCheckCreateTablesMsg(SMDCreateTablesMsg *pCreate, int32_t numOfTables) {
+  int32_t contLen = pCreate->contLen;
+  if (numOfTables < 0 || contLen < (int32_t)sizeof(SMDCreateTablesMsg)) return false;
+
+  char   *p = pCreate->data;
+  int32_t left = contLen - (int32_t)sizeof(SMDCreateTablesMsg);
+  for (int32_t i = 0; i < numOfTables; ++i) {
+    if (left < (int32_t)sizeof(SMDCreateTableMsg)) return false;
+
+    int32_t len = htonl(((SMDCreateTableMsg *)p)->contLen);
+    if (len < (int32_t)sizeof(SMDCreateTableMsg) || len > left) return false;
+
+    p += len;
+    left -= len;
+  }
+
+  return true;
+}
+
+// the result of each table is returned in the response, the message itself succeeds once it is valid
+static int32_t vnodeProcessCreateTablesMsg(SVnodeObj *pVnode, void *pCont, SRspRet *pRet) {
+  SMDCreateTablesMsg *pCreate = pCont;
+  int32_t             numOfTables = htonl(pCreate->numOfTables);
+
+  if (!vnodeCheckCreateTablesMsg(pCreate, numOfTables)) {
+    vError("vgId:%d, create msg of %d tables is invalid, len:%d", pVnode->vgId, numOfTables, pCreate->contLen);
+    return TSDB_CODE_DND_INVALID_MSG_LEN;
+  }
+
+  SMDCreateTablesRsp *pRsp = NULL;
+  if (pRet) {
+    pRet->len = sizeof(SMDCreateTablesRsp) + sizeof(int32_t) * numOfTables;
+    pRet->rsp = rpcMallocCont(pRet->len);
+    if (pRet->rsp == NULL) return TSDB_CODE_VND_OUT_OF_MEMORY;
+    pRsp = pRet->rsp;
+    pRsp->numOfTables = htonl(numOfTables);
+  }
+
+  char *p = pCreate->data;
+  for (int32_t i = 0; i < numOfTables; ++i) {
+    SMDCreateTableMsg *pTable = (SMDCreateTableMsg *)p;
+    int32_t            code = vnodeProcessCreateTableMsg(pVnode, pTable, NULL);
+    if (pRsp) pRsp->codes[i] = htonl(code);
+    p += htonl(pTable->contLen);
+  }
+
+  vDebug("vgId:%d, %d tables are created in one msg", pVnode->vgId, numOfTables);
+  return TSDB_CODE_SUCCESS;
+}
+
 static int32_t vnodeProcessDropTableMsg(SVnodeObj *pVnode, void *pCont, SRspRet *pRet) {
   SMDDropTableMsg *pTable = pCont;
   int32_t          code = TSDB_CODE_SUCCESS;
@@ -264,7 +343,11 @@ static SVWriteMsg *vnodeBuildVWriteMsg(SVnodeObj *pVnode, SWalHead *pHead, int32
     return NULL;
   }
 
-  int32_t size = sizeof(SVWriteMsg) + pHead->len;
+  // submit msg from client is retained and referenced by WAL and memtable, instead of being copied
+  bool retain = (tsZeroCopySubmit && qtype == TAOS_QTYPE_RPC && pRpcMsg != NULL &&
+                 pHead->msgType == TSDB_MSG_TYPE_SUBMIT);
+
+  int32_t size = sizeof(SVWriteMsg) + (retain ? 0 : pHead->len);
   SVWriteMsg *pWrite = taosAllocateQitem(size);
   if (pWrite == NULL) {
     terrno = TSDB_CODE_VND_OUT_OF_MEMORY;
@@ -275,9 +358,30 @@ static SVWriteMsg *vnodeBuildVWriteMsg(SVnodeObj *pVnode, SWalHead *pHead, int32
     pWrite->rpcMsg = *pRpcMsg;
   }
 
-  memcpy(&pWrite->walHead, pHead, sizeof(SWalHead) + pHead->len);
+  if (retain) {
+    STsdbRetainMsg *pRetain = calloc(1, sizeof(STsdbRetainMsg));
+    if (pRetain == NULL) {
+      taosFreeQitem(pWrite);
+      terrno = TSDB_CODE_VND_OUT_OF_MEMORY;
+      return NULL;
+    }
+
+    pRetain->refCount = 1;
+    pRetain->size = pRpcMsg->contLen;
+    pRetain->pMsg = pRpcMsg->pCont;
+    pRetain->freeFp = rpcFreeCont;
+    pRpcMsg->pCont = NULL;  // ownership is taken over, caller shall not free it
+
+    pWrite->pRetain = pRetain;
+    pWrite->pHead = pHead;
+  } else {
+    memcpy(&pWrite->walHead, pHead, sizeof(SWalHead) + pHead->len);
+    pWrite->pHead = &pWrite->walHead;
+  }
+
   pWrite->pVnode = pVnode;
   pWrite->qtype = qtype;
+  if (qtype == TAOS_QTYPE_RPC) pWrite->arrivalUs = taosGetTimestampUs();
 
   atomic_add_fetch_32(&pVnode->refCount, 1);
 
@@ -291,7 +395,7 @@ static int32_t vnodeWriteToWQueueImp(SVWriteMsg *pWrite) {
     int32_t code = vnodeCheckWrite(pVnode);
     if (code != TSDB_CODE_SUCCESS) {
       vError("vgId:%d, failed to write into vwqueue since %s", pVnode->vgId, tstrerror(code));
-      taosFreeQitem(pWrite);
+      vnodeDestroyVWriteMsg(pWrite);
       vnodeRelease(pVnode);
       return code;
     }
@@ -299,7 +403,7 @@ static int32_t vnodeWriteToWQueueImp(SVWriteMsg *pWrite) {
 
   if (tsAvailDataDirGB <= tsMinimalDataDirGB) {
     vError("vgId:%d, failed to write into vwqueue since no diskspace, avail:%fGB", pVnode->vgId, tsAvailDataDirGB);
-    taosFreeQitem(pWrite);
+    vnodeDestroyVWriteMsg(pWrite);
     vnodeRelease(pVnode);
     return TSDB_CODE_VND_NO_DISKSPACE;
   }
@@ -307,18 +411,18 @@ static int32_t vnodeWriteToWQueueImp(SVWriteMsg *pWrite) {
   if (!vnodeInReadyOrUpdatingStatus(pVnode)) {
     vError("vgId:%d, failed to write into vwqueue, vstatus is %s, refCount:%d pVnode:%p", pVnode->vgId,
            vnodeStatus[pVnode->status], pVnode->refCount, pVnode);
-    taosFreeQitem(pWrite);
+    vnodeDestroyVWriteMsg(pWrite);
     vnodeRelease(pVnode);
     return TSDB_CODE_APP_NOT_READY;
   }
 
   int32_t queued = atomic_add_fetch_32(&pVnode->queuedWMsg, 1);
-  int64_t queuedSize = atomic_add_fetch_64(&pVnode->queuedWMsgSize, pWrite->walHead.len);
+  int64_t queuedSize = atomic_add_fetch_64(&pVnode->queuedWMsgSize, pWrite->pHead->len);
 
   if (queued > MAX_QUEUED_MSG_NUM || queuedSize > MAX_QUEUED_MSG_SIZE) {
     if (pWrite->qtype == TAOS_QTYPE_FWD) {
       queued = atomic_sub_fetch_32(&pVnode->queuedWMsg, 1);
-      queuedSize = atomic_sub_fetch_64(&pVnode->queuedWMsgSize, pWrite->walHead.len);
+      queuedSize = atomic_sub_fetch_64(&pVnode->queuedWMsgSize, pWrite->pHead->len);
 
       return -1;
     }
@@ -360,18 +464,65 @@ int32_t vnodeWriteToWQueue(void *vparam, void *wparam, int32_t qtype, void *rpar
   return vnodeWriteToWQueueImp(pWrite);
 }
 
+static int32_t vnodeLatencyBucket(int64_t us) {
+  if (us < VND_LATENCY_SUB_BUCKETS) return (int32_t)MAX(us, 0);
+
+  int32_t exp = 63 - __builtin_clzll((uint64_t)us);
+  int32_t sub = (int32_t)(us >> (exp - 2)) & (VND_LATENCY_SUB_BUCKETS - 1);
+  return MIN((exp - 1) * VND_LATENCY_SUB_BUCKETS + sub, VND_LATENCY_BUCKETS - 1);
+}
+
+// the smallest latency which falls into the bucket
+static int64_t vnodeLatencyBucketFloor(int32_t bucket) {
+  if (bucket < VND_LATENCY_SUB_BUCKETS) return bucket;
+
+  int32_t exp = bucket / VND_LATENCY_SUB_BUCKETS + 1;
+  int32_t sub = bucket % VND_LATENCY_SUB_BUCKETS;
+  return (int64_t)(VND_LATENCY_SUB_BUCKETS + sub) << (exp - 2);
+}
+
 void vnodeFreeFromWQueue(void *vparam, SVWriteMsg *pWrite) {
   SVnodeObj *pVnode = vparam;
+  if (pWrite->qtype == TAOS_QTYPE_RPC && pWrite->pHead->msgType == TSDB_MSG_TYPE_SUBMIT) {
+    int32_t bucket = vnodeLatencyBucket(taosGetTimestampUs() - pWrite->arrivalUs);
+    atomic_add_fetch_64(&tsSubmitLatencyHist[bucket], 1);
+  }
+
   if (pVnode) {
     int32_t queued = atomic_sub_fetch_32(&pVnode->queuedWMsg, 1);
-    int64_t queuedSize = atomic_sub_fetch_64(&pVnode->queuedWMsgSize, pWrite->walHead.len);
+    int64_t queuedSize = atomic_sub_fetch_64(&pVnode->queuedWMsgSize, pWrite->pHead->len);
 
     vTrace("vgId:%d, msg:%p, app:%p, free from vwqueue, queued:%d size:%" PRId64, pVnode->vgId, pWrite,
            pWrite->rpcMsg.ahandle, queued, queuedSize);
   }
 
+  vnodeDestroyVWriteMsg(pWrite);
+  vnodeRelease(pVnode);
+}
+
+static void vnodeDestroyVWriteMsg(SVWriteMsg *pWrite) {
+  // the retained message may still be referenced by memtable, it is freed after commit
+  tsdbReleaseRetainMsg(pWrite->pRetain);
   taosFreeQitem(pWrite);
+}
+
+// reject a held msg, the client is told when the memory is expected to be available again
+static void vnodeRejectFlowCtrlMsg(SVWriteMsg *pWrite, int32_t code, int32_t retryAfter) {
+  SVnodeObj *pVnode = pWrite->pVnode;
+  void *     handle = pWrite->rpcMsg.handle;
+
+  vnodeDestroyVWriteMsg(pWrite);
   vnodeRelease(pVnode);
+
+  SRpcMsg rpcRsp = {.handle = handle, .code = code};
+  SShellFlowCtrlRspMsg *pRsp = rpcMallocCont(sizeof(SShellFlowCtrlRspMsg));
+  if (pRsp != NULL) {
+    pRsp->code = htonl(code);
+    pRsp->retryAfter = htonl(retryAfter);
+    rpcRsp.pCont = pRsp;
+    rpcRsp.contLen = sizeof(SShellFlowCtrlRspMsg);
+  }
+  rpcSendResponse(&rpcRsp);
 }
 
 static void vnodeFlowCtrlMsgToWQueue(void *param, void *tmrId) {
@@ -385,16 +536,12 @@ static void vnodeFlowCtrlMsgToWQueue(void *param, void *tmrId) {
   if (pWrite->processedCount >= 100) {
     vError("vgId:%d, msg:%p, failed to process since %s, retry:%d", pVnode->vgId, pWrite, tstrerror(code),
            pWrite->processedCount);
-    void *handle = pWrite->rpcMsg.handle;
-    taosFreeQitem(pWrite);
-    vnodeRelease(pVnode);
-    SRpcMsg rpcRsp = {.handle = handle, .code = code};
-    rpcSendResponse(&rpcRsp);
+    vnodeRejectFlowCtrlMsg(pWrite, code, VND_FLOWCTRL_MAX_DELAY_MS);
   } else {
     code = vnodePerformFlowCtrl(pWrite);
     if (code == 0) {
-      vDebug("vgId:%d, msg:%p, write into vwqueue after flowctrl, retry:%d", pVnode->vgId, pWrite,
-             pWrite->processedCount);
+      vDebug("vgId:%d, msg:%p, write into vwqueue after flowctrl, retry:%d held:%dms", pVnode->vgId, pWrite,
+             pWrite->processedCount, pWrite->flowCtrlMs);
       pWrite->processedCount = 0;
       void *handle = pWrite->rpcMsg.handle;
       code = vnodeWriteToWQueueImp(pWrite);
@@ -406,10 +553,42 @@ static void vnodeFlowCtrlMsgToWQueue(void *param, void *tmrId) {
   }
 }
 
+/*
+ * A submit msg is admitted if the memtable can take it without waiting for the running commit to release buffer
+ * blocks, otherwise it is held until the commit is expected to be over, so that the write worker is not blocked.
+ * Returns 0 if admitted, the time to hold it, or -1 if it shall be rejected.
+ */
+static int32_t vnodeCheckWriteCredit(SVWriteMsg *pWrite, int32_t *retryAfter) {
+  SVnodeObj *pVnode = pWrite->pVnode;
+  if (pWrite->pHead->msgType != TSDB_MSG_TYPE_SUBMIT || pVnode->tsdb == NULL) return 0;
+
+  STsdbWriteCredit credit;
+  tsdbGetWriteCredit(pVnode->tsdb, &credit);
+  if (pVnode->queuedWMsgSize + pWrite->pHead->len <= credit.availBytes) return 0;
+
+  *retryAfter = MAX(credit.commitRemainMs, VND_FLOWCTRL_MIN_DELAY_MS);
+  if (pWrite->flowCtrlMs + credit.commitRemainMs > VND_FLOWCTRL_MAX_HOLD_MS) return -1;
+
+  return MIN(*retryAfter, VND_FLOWCTRL_MAX_DELAY_MS);
+}
+
 static int32_t vnodePerformFlowCtrl(SVWriteMsg *pWrite) {
   SVnodeObj *pVnode = pWrite->pVnode;
   if (pWrite->qtype != TAOS_QTYPE_RPC) return 0;
-  if (pVnode->queuedWMsg < MAX_QUEUED_MSG_NUM && pVnode->queuedWMsgSize < MAX_QUEUED_MSG_SIZE &&
+
+  int32_t delay = 0;
+  if (tsEnableFlowCtrl != 0) {
+    int32_t retryAfter = 0;
+    delay = vnodeCheckWriteCredit(pWrite, &retryAfter);
+    if (delay < 0) {
+      vDebug("vgId:%d, msg:%p, app:%p, no write credit after %dms, retry after %dms", pVnode->vgId, pWrite,
+             pWrite->rpcMsg.ahandle, pWrite->flowCtrlMs, retryAfter);
+      vnodeRejectFlowCtrlMsg(pWrite, TSDB_CODE_VND_IS_FLOWCTRL, retryAfter);
+      return TSDB_CODE_VND_IS_FLOWCTRL;
+    }
+  }
+
+  if (delay == 0 && pVnode->queuedWMsg < MAX_QUEUED_MSG_NUM && pVnode->queuedWMsgSize < MAX_QUEUED_MSG_SIZE &&
       pVnode->flowctrlLevel <= 0)
     return 0;
 
@@ -420,11 +599,14 @@ static int32_t vnodePerformFlowCtrl(SVWriteMsg *pWrite) {
     taosMsleep(ms);
     return 0;
   } else {
+    if (delay == 0) delay = VND_FLOWCTRL_MAX_DELAY_MS;
+    pWrite->flowCtrlMs += delay;
+
     void *unUsedTimerId = NULL;
-    taosTmrReset(vnodeFlowCtrlMsgToWQueue, 100, pWrite, tsDnodeTmr, &unUsedTimerId);
+    taosTmrReset(vnodeFlowCtrlMsgToWQueue, delay, pWrite, tsDnodeTmr, &unUsedTimerId);
 
-    vTrace("vgId:%d, msg:%p, app:%p, perform flowctrl, retry:%d", pVnode->vgId, pWrite, pWrite->rpcMsg.ahandle,
-           pWrite->processedCount);
+    vTrace("vgId:%d, msg:%p, app:%p, perform flowctrl for %d ms, retry:%d", pVnode->vgId, pWrite,
+           pWrite->rpcMsg.ahandle, delay, pWrite->processedCount);
     return TSDB_CODE_VND_ACTION_IN_PROGRESS;
   }
 }
@@ -447,5 +629,22 @@ SVnodeStatisInfo vnodeGetStatisInfo() {
   info.submitRowNum = atomic_exchange_64(&tsSubmitRowNum, 0);
   info.submitRowSucNum = atomic_exchange_64(&tsSubmitRowSucNum, 0);
 
+  int64_t hist[VND_LATENCY_BUCKETS];
+  int64_t total = 0;
+  for (int32_t i = 0; i < VND_LATENCY_BUCKETS; ++i) {
+    hist[i] = atomic_exchange_64(&tsSubmitLatencyHist[i], 0);
+    total += hist[i];
+  }
+
+  int64_t target = total - total / 100;
+  int64_t count = 0;
+  for (int32_t i = 0; i < VND_LATENCY_BUCKETS && total > 0; ++i) {
+    count += hist[i];
+    if (count >= target) {
+      info.submitLatencyP99 = vnodeLatencyBucketFloor(MIN(i + 1, VND_LATENCY_BUCKETS - 1));
+      break;
+    }
+  }
+
   return info;
 }
@@ -186,15 +186,22 @@ void walFsync(void *handle, bool forceFsync) {
 }
 
 int32_t walRestore(void *handle, void *pVnode, FWalWrite writeFp) {
+  return walRestoreFrom(handle, 0, pVnode, writeFp);
+}
+
+// restore the wal files from fileId, the files before it have been covered by a snapshot of the caller
+int32_t walRestoreFrom(void *handle, int64_t startFileId, void *pVnode, FWalWrite writeFp) {
   if (handle == NULL) return -1;
 
   SWal *  pWal = handle;
   int32_t count = 0;
   int32_t code = 0;
-  int64_t fileId = -1;
+  int64_t fileId = startFileId - 1;
+  int64_t lastFileId = startFileId;
 
   while ((code = walGetNextFile(pWal, &fileId)) >= 0) {
     if (fileId == pWal->fileId) continue;
+    lastFileId = fileId;
 
     char walName[WAL_FILE_LEN];
     snprintf(walName, sizeof(pWal->name), "%s/%s%" PRId64, pWal->path, WAL_PREFIX, fileId);
@@ -213,12 +220,12 @@ int32_t walRestore(void *handle, void *pVnode, FWalWrite writeFp) {
 
   if (pWal->keep != TAOS_WAL_KEEP) return TSDB_CODE_SUCCESS;
 
-  if (count == 0) {
+  if (count == 0 && startFileId <= 0) {
     wDebug("vgId:%d, wal file not exist, renew it", pWal->vgId);
     return walRenew(pWal);
   } else {
-    // open the existing WAL file in append mode
-    pWal->fileId = 0;
+    // open the last WAL file in append mode
+    pWal->fileId = lastFileId;
     snprintf(pWal->name, sizeof(pWal->name), "%s/%s%" PRId64, pWal->path, WAL_PREFIX, pWal->fileId);
     pWal->tfd = tfOpenM(pWal->name, O_WRONLY | O_CREAT | O_APPEND, S_IRWXU | S_IRWXG | S_IRWXO);
     if (!tfValid(pWal->tfd)) {
@@ -231,6 +238,125 @@ int32_t walRestore(void *handle, void *pVnode, FWalWrite writeFp) {
   return TSDB_CODE_SUCCESS;
 }
 
+// the current file is closed and the following records are written into a new one, only for the wal kept
+int32_t walRotate(void *handle, int64_t *fileId) {
+  if (handle == NULL) return -1;
+
+  SWal *  pWal = handle;
+  int32_t code = 0;
+
+  pthread_mutex_lock(&pWal->mutex);
+
+  if (tfValid(pWal->tfd)) {
+    if (tfFsync(pWal->tfd) < 0) {
+      wError("vgId:%d, file:%s, fsync failed while rotate since %s", pWal->vgId, pWal->name, strerror(errno));
+    }
+    tfClose(pWal->tfd);
+  }
+
+  int64_t prevFileId = pWal->fileId;
+  int64_t maxFileId = 0;
+  if (walGetNewFile(pWal, &maxFileId) != 0) maxFileId = pWal->fileId;
+  pWal->fileId = MAX(maxFileId, pWal->fileId) + 1;
+
+  snprintf(pWal->name, sizeof(pWal->name), "%s/%s%" PRId64, pWal->path, WAL_PREFIX, pWal->fileId);
+  pWal->tfd = tfOpenM(pWal->name, O_WRONLY | O_CREAT | O_APPEND, S_IRWXU | S_IRWXG | S_IRWXO);
+  if (!tfValid(pWal->tfd)) {
+    code = TAOS_SYSTEM_ERROR(errno);
+    wError("vgId:%d, file:%s, failed to open while rotate since %s", pWal->vgId, pWal->name, strerror(errno));
+
+    // keep writing into the previous file
+    pWal->fileId = prevFileId;
+    snprintf(pWal->name, sizeof(pWal->name), "%s/%s%" PRId64, pWal->path, WAL_PREFIX, pWal->fileId);
+    pWal->tfd = tfOpenM(pWal->name, O_WRONLY | O_CREAT | O_APPEND, S_IRWXU | S_IRWXG | S_IRWXO);
+  } else {
+    wInfo("vgId:%d, file:%s, it is created while rotate, wver:%" PRIu64, pWal->vgId, pWal->name, pWal->version);
+  }
+
+  *fileId = pWal->fileId;
+  pthread_mutex_unlock(&pWal->mutex);
+
+  return code;
+}
+
+void walRemoveFilesBefore(void *handle, int64_t fileId) {
+  if (handle == NULL) return;
+
+  SWal *  pWal = handle;
+  int64_t id = -1;
+  char    walName[WAL_FILE_LEN];
+
+  pthread_mutex_lock(&pWal->mutex);
+  while (walGetNextFile(pWal, &id) >= 0 && id < fileId) {
+    if (id == pWal->fileId) continue;
+
+    snprintf(walName, sizeof(walName), "%s/%s%" PRId64, pWal->path, WAL_PREFIX, id);
+    if (remove(walName) < 0) {
+      wError("vgId:%d, file:%s, failed to remove since %s", pWal->vgId, walName, strerror(errno));
+    } else {
+      wInfo("vgId:%d, file:%s, it is removed", pWal->vgId, walName);
+    }
+  }
+  pthread_mutex_unlock(&pWal->mutex);
+}
+
+/*
+ * Read the records of the wal files in [fromFileId, toFileId), which shall not be written anymore. Unlike restore,
+ * the files are never modified, and reading stops at the first damaged record.
+ */
+int32_t walReadFiles(void *handle, int64_t fromFileId, int64_t toFileId, void *param, FWalWrite readFp) {
+  if (handle == NULL) return -1;
+
+  SWal *  pWal = handle;
+  int32_t code = TSDB_CODE_SUCCESS;
+  int64_t fileId = fromFileId - 1;
+  char    walName[WAL_FILE_LEN];
+
+  SWalHead *pHead = tmalloc(WAL_MAX_SIZE);
+  if (pHead == NULL) return TAOS_SYSTEM_ERROR(errno);
+
+  while (code == TSDB_CODE_SUCCESS && walGetNextFile(pWal, &fileId) >= 0 && fileId < toFileId) {
+    snprintf(walName, sizeof(walName), "%s/%s%" PRId64, pWal->path, WAL_PREFIX, fileId);
+    int64_t tfd = tfOpen(walName, O_RDONLY);
+    if (!tfValid(tfd)) {
+      wError("vgId:%d, file:%s, failed to open for read since %s", pWal->vgId, walName, strerror(errno));
+      code = TAOS_SYSTEM_ERROR(errno);
+      break;
+    }
+
+    while (1) {
+      int32_t ret = (int32_t)tfRead(tfd, pHead, sizeof(SWalHead));
+      if (ret == 0) break;
+
+      if (ret != sizeof(SWalHead) || pHead->len < 0 || pHead->len > WAL_MAX_SIZE - sizeof(SWalHead) ||
+          tfRead(tfd, pHead->cont, pHead->len) != pHead->len) {
+        wError("vgId:%d, file:%s, failed to read wal record, ret:%d", pWal->vgId, walName, ret);
+        code = TSDB_CODE_WAL_FILE_CORRUPTED;
+        break;
+      }
+
+#if defined(WAL_CHECKSUM_WHOLE)
+      bool valid = (pHead->sver >= 0 && pHead->sver <= 2 && walValidateChecksum(pHead));
+#else
+      bool valid = taosCheckChecksumWhole((uint8_t *)pHead, sizeof(SWalHead));
+#endif
+      if (!valid) {
+        wError("vgId:%d, file:%s, wal cksum is messed up, hver:%" PRIu64, pWal->vgId, walName, pHead->version);
+        code = TSDB_CODE_WAL_FILE_CORRUPTED;
+        break;
+      }
+
+      code = (*readFp)(param, pHead, TAOS_QTYPE_WAL, NULL);
+      if (code != TSDB_CODE_SUCCESS) break;
+    }
+
+    tfClose(tfd);
+  }
+
+  tfree(pHead);
+  return code;
+}
+
 int32_t walGetWalFile(void *handle, char *fileName, int64_t *fileId) {
   if (handle == NULL) return -1;
   SWal *pWal = handle;
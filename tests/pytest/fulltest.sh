@@ -47,6 +47,7 @@ python3 ./test.py -f table/alter_column.py
 python3 ./test.py -f table/boundary.py
 #python3 ./test.py -f table/create.py
 python3 ./test.py -f table/del_stable.py
+python3 ./test.py -f table/showTablesPaged.py
 python3 ./test.py -f table/create_db_from_normal_db.py
 
 #stable
@@ -181,6 +182,7 @@ python3 test.py -f tools/taosdemoTestInterlace.py
 # restful test for python
 # python3 test.py -f restful/restful_bind_db1.py
 # python3 test.py -f restful/restful_bind_db2.py
+python3 test.py -f restful/restful_schemaless.py
 
 # nano support
 python3 test.py -f tools/taosdemoAllTest/NanoTestCase/taosdemoTestSupportNanoInsert.py
@@ -341,6 +343,7 @@ python3 ./test.py -f update/merge_commit_data-0.py
 # wal
 python3 ./test.py -f wal/addOldWalTest.py
 python3 ./test.py -f wal/sdbComp.py
+python3 ./test.py -f wal/sdbSnapshot.py
 
 # function
 python3 ./test.py -f functions/all_null_value.py
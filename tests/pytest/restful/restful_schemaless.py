@@ -0,0 +1,139 @@
+###################################################################
+#           Copyright (c) 2021 by TAOS Technologies, Inc.
+#                     All rights reserved.
+#
+#  This file is proprietary and confidential to TAOS Technologies.
+#  No part of this file may be reproduced, stored, transmitted,
+#  disclosed or used in any form or by any means other than as
+#  expressly provided by the written permission from Jianhui Tao
+#
+###################################################################
+
+# -*- coding: utf-8 -*-
+
+# the schemaless endpoints insert the body by batches while it is streamed in, and stop reading the connection when
+# the next batch is ready before the last one is inserted. The bodies here are sent slowly in pieces, at once to be
+# paused, and gzipped, each followed by another request on the same keep-alive connection
+
+import gzip
+import json
+import socket
+import time
+from util.log import *
+from util.cases import *
+from util.sql import *
+
+
+class TDTestCase:
+    def init(self, conn, logSql):
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor(), logSql)
+        self.auth = 'Basic cm9vdDp0YW9zZGF0YQ=='
+        self.ts = 1626006833639
+
+    def lines(self, stable, numOfLines):
+        body = []
+        for i in range(numOfLines):
+            body.append("%s,t1=t%d c1=%di64,c2=\"%s\" %d" % (stable, i % 100, i, "v" * 64, self.ts + i))
+        return ("\n".join(body) + "\n").encode()
+
+    def connect(self):
+        sock = socket.create_connection(("127.0.0.1", 6041))
+        sock.settimeout(60)
+        return sock
+
+    def recvUntil(self, sock, data, end):
+        while end not in data:
+            chunk = sock.recv(65536)
+            if not chunk:
+                tdLog.exit("connection closed in the response")
+            data += chunk
+        return data
+
+    # the response is sent in chunks, which end with an empty one
+    def recvResponse(self, sock):
+        data = self.recvUntil(sock, b"", b"\r\n\r\n")
+        data = self.recvUntil(sock, data, b"\r\n0\r\n\r\n")
+        body = data.split(b"\r\n\r\n", 1)[1]
+        content = b""
+        while True:
+            size, body = body.split(b"\r\n", 1)
+            if int(size, 16) == 0:
+                break
+            content += body[:int(size, 16)]
+            body = body[int(size, 16) + 2:]
+        return json.loads(content.decode())
+
+    def post(self, sock, path, body, pieces=1, delay=0, headers=""):
+        head = ("POST %s HTTP/1.1\r\nHost: 127.0.0.1\r\nAuthorization: %s\r\nConnection: keep-alive\r\n"
+                "Content-Length: %d\r\n%s\r\n" % (path, self.auth, len(body), headers))
+        sock.sendall(head.encode())
+        step = (len(body) + pieces - 1) // pieces
+        for i in range(0, len(body), step):
+            sock.sendall(body[i:i + step])
+            if delay > 0:
+                time.sleep(delay)
+        return self.recvResponse(sock)
+
+    def checkInserted(self, rsp, stable, numOfLines):
+        if rsp.get("status") != "succ":
+            tdLog.exit("%s failed: %s" % (stable, rsp))
+        tdSql.query("select count(*) from test.%s" % stable)
+        tdSql.checkData(0, 0, numOfLines)
+
+    # the same connection takes the next request after a schemaless one
+    def checkNextRequest(self, sock):
+        rsp = self.post(sock, "/rest/sql", b"select server_version()")
+        if rsp.get("status") != "succ":
+            tdLog.exit("request after schemaless failed: %s" % rsp)
+
+    def run(self):
+        tdSql.prepare()
+        tdSql.execute("drop database if exists test")
+        tdSql.execute("create database test")
+
+        # streamed: the batches are inserted while the rest of the body is sent in pieces
+        sock = self.connect()
+        body = self.lines("streamed", 30000)
+        rsp = self.post(sock, "/schemaless/line/test?precision=ms", body, pieces=30, delay=0.05)
+        self.checkInserted(rsp, "streamed", 30000)
+        self.checkNextRequest(sock)
+        sock.close()
+
+        # paused: the body is sent at once, the reads are paused while the batches are inserted
+        sock = self.connect()
+        for i in range(3):
+            body = self.lines("paused%d" % i, 100000)
+            rsp = self.post(sock, "/schemaless/line/test?precision=ms", body)
+            self.checkInserted(rsp, "paused%d" % i, 100000)
+        self.checkNextRequest(sock)
+        sock.close()
+
+        # paused by many connections together, each of which is resumed and takes the next request
+        socks = [self.connect() for i in range(8)]
+        bodies = [self.lines("many%d" % i, 40000) for i in range(len(socks))]
+        for sock, body in zip(socks, bodies):
+            head = ("POST /schemaless/line/test?precision=ms HTTP/1.1\r\nHost: 127.0.0.1\r\nAuthorization: %s\r\n"
+                    "Connection: keep-alive\r\nContent-Length: %d\r\n\r\n" % (self.auth, len(body)))
+            sock.sendall(head.encode() + body)
+        for i, sock in enumerate(socks):
+            self.checkInserted(self.recvResponse(sock), "many%d" % i, 40000)
+            self.checkNextRequest(sock)
+            sock.close()
+
+        # gzip: the body is decompressed as it is received
+        sock = self.connect()
+        body = gzip.compress(self.lines("gzipped", 50000))
+        rsp = self.post(sock, "/schemaless/line/test?precision=ms", body, pieces=10, delay=0.02,
+                        headers="Content-Encoding: gzip\r\n")
+        self.checkInserted(rsp, "gzipped", 50000)
+        self.checkNextRequest(sock)
+        sock.close()
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
+
+
+tdCases.addWindows(__file__, TDTestCase())
+tdCases.addLinux(__file__, TDTestCase())
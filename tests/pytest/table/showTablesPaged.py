@@ -0,0 +1,127 @@
+###################################################################
+#           Copyright (c) 2016 by TAOS Technologies, Inc.
+#                     All rights reserved.
+#
+#  This file is proprietary and confidential to TAOS Technologies.
+#  No part of this file may be reproduced, stored, transmitted,
+#  disclosed or used in any form or by any means other than as
+#  expressly provided by the written permission from Jianhui Tao
+#
+###################################################################
+
+# -*- coding: utf-8 -*-
+
+# 'show tables' is retrieved by pages of 100 rows, each of which seeks the name index from the last name returned. The
+# tables here are created and dropped around that name between the pages, and more names than SHOW_TABLES_SCAN_STEP
+# are scanned for a page of a sparse pattern
+
+import re
+from util.log import *
+from util.cases import *
+from util.sql import *
+
+
+class TDTestCase:
+    def init(self, conn, logSql):
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor(), logSql)
+        self.conn = conn
+        self.numOfTables = 3000
+        self.pageRows = 100
+
+    def createTables(self, names):
+        for i in range(0, len(names), 100):
+            sql = " ".join("db.%s using db.st tags(%d)" % (name, j) for j, name in enumerate(names[i:i + 100]))
+            tdSql.execute("create table %s" % sql)
+
+    def prepareTables(self):
+        tdSql.execute("drop database if exists db")
+        tdSql.execute("create database db")
+        tdSql.execute("create table db.st (ts timestamp, c int) tags (t int)")
+        # before the range of the pattern, not returned
+        self.createTables(["other%d" % i for i in range(500)])
+        names = ["pg%04d" % i for i in range(self.numOfTables)]
+        self.createTables(names)
+        return names
+
+    def checkPaged(self, pattern):
+        names = self.prepareTables()
+        regex = re.compile("^" + pattern.replace("%", ".*") + "$")
+        suffix = "_%d" + pattern.split("%")[-1]  # the created names match the pattern too
+        volatile = set(names[::3])  # dropped around the last name returned
+        existing = set(names)
+        mustAppear = set(name for name in names if regex.match(name))
+        mustNotAppear = set()
+
+        cursor = self.conn.cursor()
+        cursor.execute("show db.tables like '%s'" % pattern)
+        returned = []
+        page = 0
+        while True:
+            try:
+                row = next(cursor)
+            except StopIteration:
+                break
+            returned.append(row[0])
+            if len(returned) % self.pageRows != 0:
+                continue
+
+            # the next page is retrieved after the tables are changed
+            page += 1
+            last = returned[-1]
+            ahead = sorted(name for name in existing & volatile if name > last)[:2]
+            behind = sorted(name for name in existing & volatile if name < last)[-2:]
+            for name in ahead + behind:
+                tdSql.execute("drop table db.%s" % name)
+                existing.discard(name)
+            for name in ahead:
+                mustAppear.discard(name)
+                mustNotAppear.add(name)
+
+            created = []
+            following = sorted(name for name in existing if name > last)
+            if following:
+                created.append(following[0] + suffix % page)
+                mustAppear.add(created[-1])
+            if len(returned) >= 2:
+                created.append(returned[-2] + suffix % page)
+                mustNotAppear.add(created[-1])
+            self.createTables(created)
+            existing.update(created)
+        cursor.close()
+
+        tdLog.info("pattern:%s, %d tables returned in %d pages" % (pattern, len(returned), page + 1))
+        if len(returned) != len(set(returned)):
+            tdLog.exit("pattern:%s, duplicated tables returned" % pattern)
+        if returned != sorted(returned):
+            tdLog.exit("pattern:%s, tables not returned in name order" % pattern)
+        for name in returned:
+            if not regex.match(name):
+                tdLog.exit("pattern:%s, table %s not matched is returned" % (pattern, name))
+        missed = mustAppear - set(returned)
+        if missed:
+            tdLog.exit("pattern:%s, tables missed: %s" % (pattern, sorted(missed)[:10]))
+        unexpected = mustNotAppear & set(returned)
+        if unexpected:
+            tdLog.exit("pattern:%s, tables returned unexpectedly: %s" % (pattern, sorted(unexpected)[:10]))
+
+        # the tables left are all returned once changes stop
+        tdSql.query("show db.tables like '%s'" % pattern)
+        tdSql.checkRows(len([name for name in existing if regex.match(name)]))
+
+    def run(self):
+        tdSql.prepare()
+        # 30 pages of every table in the range
+        self.checkPaged("pg%")
+        # 4 pages of one table in 10, each of which scans more than 1024 names
+        self.checkPaged("pg%7")
+        # a single page of one table in 100, which is scanned through the whole range
+        self.checkPaged("pg%99")
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
+
+
+tdCases.addWindows(__file__, TDTestCase())
+tdCases.addLinux(__file__, TDTestCase())
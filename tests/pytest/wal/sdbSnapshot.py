@@ -0,0 +1,153 @@
+###################################################################
+#           Copyright (c) 2016 by TAOS Technologies, Inc.
+#                     All rights reserved.
+#
+#  This file is proprietary and confidential to TAOS Technologies.
+#  No part of this file may be reproduced, stored, transmitted,
+#  disclosed or used in any form or by any means other than as
+#  expressly provided by the written permission from Jianhui Tao
+#
+###################################################################
+
+# -*- coding: utf-8 -*-
+
+# the sdb of a single mnode is restored from its snapshot and the wal written after it, since the wal files before the
+# snapshot are removed. The snapshot dirs are also left as a crash would leave them while the snapshot is replaced
+
+import os
+import shutil
+import time
+from util.log import *
+from util.cases import *
+from util.sql import *
+from util.dnodes import *
+
+
+class TDTestCase:
+    updatecfgDict = {'mnodeSnapshotRows': 100}
+
+    def init(self, conn, logSql):
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor(), logSql)
+
+    def mnodeDir(self):
+        return "%s/dnode1/data/mnode" % tdDnodes.getDnodesRootDir()
+
+    # wait for a snapshot written after the last one
+    def waitSnapshot(self, lastTime=0):
+        head = "%s/snapshot/head" % self.mnodeDir()
+        for i in range(60):
+            if os.path.exists(head) and os.path.getmtime(head) > lastTime:
+                return os.path.getmtime(head)
+            time.sleep(1)
+        tdLog.exit("sdb snapshot is not written")
+
+    def checkMeta(self):
+        tdSql.query("select count(tbname) from meta.st")
+        tdSql.checkData(0, 0, 320)
+        tdSql.query("select tbname from meta.st where t < 10")
+        tdSql.checkRows(0)
+        tdSql.query("select count(tbname) from meta.st where t = 329")
+        tdSql.checkData(0, 0, 1)
+        tdSql.query("describe meta.st")
+        tdSql.checkRows(4)
+        tdSql.checkData(3, 0, "t2")
+        tdSql.query("select count(*) from meta.t329")
+        tdSql.checkData(0, 0, 1)
+        tdSql.query("show users")
+        if "snapshot" not in [row[0] for row in tdSql.queryResult]:
+            tdLog.exit("user snapshot is lost")
+        tdSql.query("show databases")
+        if "dropped" in [row[0] for row in tdSql.queryResult]:
+            tdLog.exit("database dropped is restored")
+
+    def checkSnapshotDirs(self):
+        mnodeDir = self.mnodeDir()
+        if not os.path.exists("%s/snapshot/head" % mnodeDir):
+            tdLog.exit("sdb snapshot is lost")
+        for suffix in [".tmp", ".old"]:
+            if os.path.exists("%s/snapshot%s" % (mnodeDir, suffix)):
+                tdLog.exit("snapshot%s is left" % suffix)
+
+    def restart(self):
+        tdDnodes.stop(1)
+        tdDnodes.start(1)
+        self.checkMeta()
+        self.checkSnapshotDirs()
+
+    def run(self):
+        tdSql.prepare()
+        tdSql.execute("create database dropped")
+        tdSql.execute("create table dropped.st (ts timestamp, c int) tags (t int)")
+        for i in range(20):
+            tdSql.execute("create table dropped.t%d using dropped.st tags(%d)" % (i, i))
+
+        tdSql.execute("create database meta")
+        tdSql.execute("create table meta.st (ts timestamp, c int) tags (t int)")
+        for i in range(300):
+            tdSql.execute("create table meta.t%d using meta.st tags(%d)" % (i, i))
+        # the tables of a database are dropped along with it, without their own wal records
+        tdSql.execute("drop database dropped")
+        lastTime = self.waitSnapshot()
+
+        # the wal tail after the snapshot
+        tdSql.execute("create user snapshot pass 'taosdata'")
+        tdSql.execute("alter table meta.st add tag t2 int")
+        for i in range(300, 330):
+            tdSql.execute("create table meta.t%d using meta.st tags(%d, 0)" % (i, i))
+        tdSql.execute("insert into meta.t329 values(now, 1)")
+        for i in range(10):
+            tdSql.execute("drop table meta.t%d" % i)
+        self.checkMeta()
+
+        # killed without closing the wal
+        tdDnodes.forcestop(1)
+        tdDnodes.start(1)
+        self.checkMeta()
+        self.checkSnapshotDirs()
+
+        mnodeDir = self.mnodeDir()
+        snapshotDir = "%s/snapshot" % mnodeDir
+        tmpDir = "%s/snapshot.tmp" % mnodeDir
+        oldDir = "%s/snapshot.old" % mnodeDir
+
+        # crashed while the next snapshot is written, the partial one is removed
+        tdDnodes.stop(1)
+        shutil.copytree(snapshotDir, tmpDir)
+        os.remove("%s/head" % tmpDir)
+        tdDnodes.start(1)
+        self.checkMeta()
+        self.checkSnapshotDirs()
+
+        # crashed between the renames, the last snapshot is moved back
+        tdDnodes.stop(1)
+        shutil.copytree(snapshotDir, tmpDir)
+        os.rename(snapshotDir, oldDir)
+        tdDnodes.start(1)
+        self.checkMeta()
+        self.checkSnapshotDirs()
+
+        # crashed before the last snapshot is removed
+        tdDnodes.stop(1)
+        shutil.copytree(snapshotDir, oldDir)
+        tdDnodes.start(1)
+        self.checkMeta()
+        self.checkSnapshotDirs()
+
+        # the next snapshot merges the last one with the records and the tombstones after it
+        tdSql.execute("create table meta.st2 (ts timestamp, c int) tags (t int)")
+        for i in range(120):
+            tdSql.execute("create table meta.s%d using meta.st2 tags(%d)" % (i, i))
+        tdSql.execute("drop table meta.st2")
+        self.waitSnapshot(lastTime)
+        self.restart()
+        tdSql.query("show meta.stables")
+        tdSql.checkRows(1)
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
+
+
+tdCases.addWindows(__file__, TDTestCase())
+tdCases.addLinux(__file__, TDTestCase())
@@ -0,0 +1,191 @@
+// sample code to verify the child tables created automatically by insert statements: the new tables of one statement
+// are created in batch, and the throughput is printed in tables per second. The tables of a create statement are
+// created in batch as well, which fails the statement if the vnode rejects the batch
+// to compile: gcc -o autoCreate autoCreate.c -ltaos -lpthread
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <taos.h>
+#include <unistd.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <sys/time.h>
+
+static int errors = 0;
+static int numOfTables = 20000;
+static int tablesPerSql = 100;
+static int numOfThreads = 1;
+
+static int64_t now_ms() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return (int64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+}
+
+static void execute(TAOS* taos, const char* sql) {
+  TAOS_RES* result = taos_query(taos, sql);
+  if (taos_errno(result) != 0) {
+    printf("\033[31mfailed to execute: %.100s, reason: %s\033[0m\n", sql, taos_errstr(result));
+    __atomic_add_fetch(&errors, 1, __ATOMIC_SEQ_CST);
+  }
+  taos_free_result(result);
+}
+
+static int64_t query_count(TAOS* taos, const char* sql) {
+  int64_t   count = -1;
+  TAOS_RES* result = taos_query(taos, sql);
+  if (taos_errno(result) != 0) {
+    printf("\033[31mfailed to execute: %s, reason: %s\033[0m\n", sql, taos_errstr(result));
+    errors++;
+  } else {
+    TAOS_ROW row = taos_fetch_row(result);
+    count = (row != NULL) ? *(int64_t*)row[0] : 0;
+  }
+  taos_free_result(result);
+  return count;
+}
+
+static TAOS* connect_db() {
+  TAOS* taos = taos_connect("127.0.0.1", "root", "taosdata", "", 0);
+  if (taos == NULL) {
+    printf("\033[31mfailed to connect to db, reason:%s\033[0m\n", taos_errstr(taos));
+    exit(1);
+  }
+  return taos;
+}
+
+typedef struct {
+  int     index;
+  int64_t ts;
+} SThreadInfo;
+
+// every thread writes one row into each of its new tables, the tables of a statement are all created by it
+static void* insert_thread(void* param) {
+  SThreadInfo* pInfo = param;
+  TAOS*        taos = connect_db();
+  taos_select_db(taos, "autocreate");
+
+  int   begin = numOfTables / numOfThreads * pInfo->index;
+  int   end = (pInfo->index == numOfThreads - 1) ? numOfTables : begin + numOfTables / numOfThreads;
+  char* sql = malloc(1024 * 1024);
+  for (int i = begin; i < end; i += tablesPerSql) {
+    int len = sprintf(sql, "insert into");
+    for (int j = i; j < i + tablesPerSql && j < end; ++j) {
+      len += sprintf(sql + len, " d%d using st tags(%d, 'group%d') values(%" PRId64 ", %d)", j, j, j % 10, pInfo->ts, j);
+    }
+    execute(taos, sql);
+  }
+
+  free(sql);
+  taos_close(taos);
+  return NULL;
+}
+
+static void insert_new_tables(int64_t ts) {
+  pthread_t   threads[64];
+  SThreadInfo info[64];
+
+  int64_t st = now_ms();
+  for (int i = 0; i < numOfThreads; ++i) {
+    info[i].index = i;
+    info[i].ts = ts;
+    pthread_create(&threads[i], NULL, insert_thread, &info[i]);
+  }
+  for (int i = 0; i < numOfThreads; ++i) {
+    pthread_join(threads[i], NULL);
+  }
+
+  int64_t elapsed = now_ms() - st;
+  printf("%d threads insert into %d new tables, %d tables per statement, in %" PRId64 " ms, %.1f tables/s\n",
+         numOfThreads, numOfTables, tablesPerSql, elapsed, numOfTables * 1000.0 / (elapsed > 0 ? elapsed : 1));
+}
+
+// the tables of one create statement are sent to each vgroup in one message, which is rejected as a whole if invalid
+static void create_tables_in_batch(TAOS* taos) {
+  int   numOfCreated = 1000;
+  char* sql = malloc(1024 * 1024);
+  for (int i = 0; i < numOfCreated; i += tablesPerSql) {
+    int len = sprintf(sql, "create table");
+    for (int j = i; j < i + tablesPerSql && j < numOfCreated; ++j) {
+      len += sprintf(sql + len, " if not exists e%d using st tags(%d, 'batch')", j, j);
+    }
+    execute(taos, sql);
+  }
+  free(sql);
+
+  int64_t count = query_count(taos, "select count(tbname) from st where g = 'batch'");
+  if (count != numOfCreated) {
+    printf("\033[31mtables created in batch: %" PRId64 ", expected %d\033[0m\n", count, numOfCreated);
+    errors++;
+  }
+
+  // every table is written after created in batch
+  execute(taos, "insert into e0 values(1600000000000, 0) e999 values(1600000000000, 999)");
+  count = query_count(taos, "select count(*) from st where g = 'batch'");
+  if (count != 2) {
+    printf("\033[31mrows of the tables created in batch: %" PRId64 ", expected 2\033[0m\n", count);
+    errors++;
+  }
+}
+
+int main(int argc, char* argv[]) {
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "-n") == 0 && i < argc - 1) {
+      numOfTables = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-b") == 0 && i < argc - 1) {
+      tablesPerSql = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-t") == 0 && i < argc - 1) {
+      numOfThreads = atoi(argv[++i]);
+    } else {
+      printf("usage: %s [-n tables] [-b tables per statement] [-t threads]\n", argv[0]);
+      exit(0);
+    }
+  }
+  if (numOfThreads > 64) {
+    numOfThreads = 64;
+  }
+  if (tablesPerSql < 1) {
+    tablesPerSql = 1;
+  }
+
+  TAOS* taos = connect_db();
+  execute(taos, "drop database if exists autocreate");
+  usleep(100000);
+  execute(taos, "create database autocreate");
+  usleep(100000);
+  taos_select_db(taos, "autocreate");
+  execute(taos, "create table st(ts timestamp, v int) tags(t int, g binary(16))");
+
+  int64_t ts = 1600000000000;
+  insert_new_tables(ts);
+
+  // the tables exist now, the rows are written into them without creating
+  insert_new_tables(ts + 1000);
+
+  int64_t count = query_count(taos, "select count(tbname) from st");
+  if (count != numOfTables) {
+    printf("\033[31mtables of st: %" PRId64 ", expected %d\033[0m\n", count, numOfTables);
+    errors++;
+  }
+
+  count = query_count(taos, "select count(*) from st");
+  if (count != numOfTables * 2) {
+    printf("\033[31mrows of st: %" PRId64 ", expected %d\033[0m\n", count, numOfTables * 2);
+    errors++;
+  }
+
+  count = query_count(taos, "select count(*) from st where g = 'group3'");
+  if (count != numOfTables / 10 * 2) {
+    printf("\033[31mrows of group3: %" PRId64 ", expected %d\033[0m\n", count, numOfTables / 10 * 2);
+    errors++;
+  }
+
+  create_tables_in_batch(taos);
+
+  taos_close(taos);
+  taos_cleanup();
+
+  printf("%s\n", errors == 0 ? "done" : "failed");
+  return errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,241 @@
+// sample code to verify taos_fetch_columns and the blocks fetched ahead by taos_fetch_row/taos_fetch_rows_a
+// to compile: gcc -o fetchColumns fetchColumns.c -ltaos
+
+#include "taoserror.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <taos.h>
+#include <unistd.h>
+#include <inttypes.h>
+#include <semaphore.h>
+
+#define NUM_OF_ROWS   30000
+#define ROWS_PER_SQL  500
+
+static int errors = 0;
+
+static void execute(TAOS* taos, const char* sql) {
+  TAOS_RES* result = taos_query(taos, sql);
+  if (taos_errno(result) != 0) {
+    printf("\033[31mfailed to execute: %s, reason: %s\033[0m\n", sql, taos_errstr(result));
+    errors++;
+  }
+  taos_free_result(result);
+}
+
+static void prepare_data(TAOS* taos) {
+  execute(taos, "drop database if exists test");
+  usleep(100000);
+  execute(taos, "create database test precision 'ms'");
+  usleep(100000);
+  taos_select_db(taos, "test");
+
+  execute(taos, "create table tb(ts timestamp, c0 int, c1 double, c2 binary(16), c3 nchar(16))");
+
+  char* sql = malloc(ROWS_PER_SQL * 128 + 64);
+  for (int i = 0; i < NUM_OF_ROWS; i += ROWS_PER_SQL) {
+    int len = sprintf(sql, "insert into tb values");
+    for (int j = i; j < i + ROWS_PER_SQL; ++j) {
+      if (j % 7 == 0) {
+        len += sprintf(sql + len, " (%" PRId64 ", %d, NULL, NULL, NULL)", (int64_t)1600000000000 + j, j);
+      } else {
+        len += sprintf(sql + len, " (%" PRId64 ", %d, %d.5, 'b%d', 'n%d')", (int64_t)1600000000000 + j, j, j, j, j);
+      }
+    }
+    execute(taos, sql);
+  }
+  free(sql);
+}
+
+static void verify_columns(TAOS* taos) {
+  TAOS_RES* res = taos_query(taos, "select * from tb");
+  int       numOfFields = taos_num_fields(res);
+  int       numOfBlocks = 0;
+  int       total = 0;
+  int       rows = 0;
+
+  TAOS_COLUMN* columns = NULL;
+  while ((rows = taos_fetch_columns(res, &columns)) > 0) {
+    numOfBlocks++;
+    if (numOfFields != 5 || columns[0].type != TSDB_DATA_TYPE_TIMESTAMP || columns[2].type != TSDB_DATA_TYPE_DOUBLE ||
+        columns[3].type != TSDB_DATA_TYPE_BINARY || columns[4].type != TSDB_DATA_TYPE_NCHAR) {
+      printf("\033[31minvalid columns of the block\033[0m\n");
+      errors++;
+      break;
+    }
+
+    for (int i = 0; i < rows; ++i) {
+      int     r = total + i;
+      int64_t ts = *(int64_t*)(columns[0].data + i * columns[0].bytes);
+      int32_t c0 = *(int32_t*)(columns[1].data + i * columns[1].bytes);
+      if (ts != (int64_t)1600000000000 + r || c0 != r || columns[0].isNull[i] || columns[1].isNull[i]) {
+        printf("\033[31mrow %d: ts:%" PRId64 " c0:%d mismatch\033[0m\n", r, ts, c0);
+        errors++;
+        break;
+      }
+
+      if (r % 7 == 0) {
+        if (!columns[2].isNull[i] || !columns[3].isNull[i] || !columns[4].isNull[i]) {
+          printf("\033[31mrow %d: NULL expected\033[0m\n", r);
+          errors++;
+          break;
+        }
+        continue;
+      }
+
+      char  expect3[32], expect4[32];
+      char* c2 = columns[2].data + i * columns[2].bytes;
+      char* c3 = columns[3].data + i * columns[3].bytes;
+      char* c4 = columns[4].data + i * columns[4].bytes;
+      int   len3 = sprintf(expect3, "b%d", r);
+      int   len4 = sprintf(expect4, "n%d", r);
+      if (*(double*)c2 != r + 0.5 || *(int16_t*)c3 != len3 || memcmp(c3 + sizeof(int16_t), expect3, len3) != 0 ||
+          *(int16_t*)c4 != len4 || memcmp(c4 + sizeof(int16_t), expect4, len4) != 0 ||
+          columns[2].isNull[i] || columns[3].isNull[i] || columns[4].isNull[i]) {
+        printf("\033[31mrow %d: value mismatch\033[0m\n", r);
+        errors++;
+        break;
+      }
+    }
+
+    total += rows;
+  }
+
+  if (taos_errno(res) != 0 || total != NUM_OF_ROWS) {
+    printf("\033[31m%d rows in %d blocks retrieved, %d expected, reason: %s\033[0m\n", total, numOfBlocks, NUM_OF_ROWS,
+           taos_errstr(res));
+    errors++;
+  } else {
+    printf("%d rows in %d blocks retrieved by columns\n", total, numOfBlocks);
+  }
+  taos_free_result(res);
+
+  // the blocks of taos_fetch_block after the first block fetched by columns, the second block is fetched ahead
+  res = taos_query(taos, "select ts from tb");
+  total = taos_fetch_columns(res, &columns);
+  TAOS_ROW block = NULL;
+  while ((rows = taos_fetch_block(res, &block)) > 0) {
+    total += rows;
+  }
+  if (total != NUM_OF_ROWS) {
+    printf("\033[31m%d rows retrieved by columns and blocks, %d expected\033[0m\n", total, NUM_OF_ROWS);
+    errors++;
+  }
+  taos_free_result(res);
+
+  // free the result while the next block is being fetched ahead
+  for (int i = 0; i < 20; ++i) {
+    res = taos_query(taos, "select * from tb");
+    taos_fetch_columns(res, &columns);
+    if (i % 2 == 0) {
+      usleep(10000);
+    }
+    taos_free_result(res);
+  }
+
+  res = taos_query(taos, "select * from tb");
+  taos_fetch_columns(res, &columns);
+  taos_stop_query(res);
+  taos_free_result(res);
+}
+
+// the blocks fetched ahead are returned in order by taos_fetch_row
+static void verify_rows(TAOS* taos) {
+  TAOS_RES* res = taos_query(taos, "select ts, c0 from tb");
+  TAOS_ROW  row = NULL;
+  int       total = 0;
+  while ((row = taos_fetch_row(res)) != NULL) {
+    if (*(int64_t*)row[0] != (int64_t)1600000000000 + total || *(int32_t*)row[1] != total) {
+      printf("\033[31mrow %d: ts:%" PRId64 " mismatch\033[0m\n", total, *(int64_t*)row[0]);
+      errors++;
+      break;
+    }
+    total++;
+  }
+
+  if (taos_errno(res) != 0 || total != NUM_OF_ROWS) {
+    printf("\033[31m%d rows retrieved by rows, %d expected\033[0m\n", total, NUM_OF_ROWS);
+    errors++;
+  } else {
+    printf("%d rows retrieved by rows\n", total);
+  }
+  taos_free_result(res);
+}
+
+typedef struct {
+  int64_t total;
+  sem_t   done;
+} SAsyncFetch;
+
+static void fetch_rows_cb(void* param, TAOS_RES* res, int numOfRows) {
+  SAsyncFetch* pFetch = param;
+  if (numOfRows <= 0) {
+    sem_post(&pFetch->done);
+    return;
+  }
+
+  // slow consumer, the next blocks are fetched ahead meanwhile
+  usleep(2000);
+
+  for (int i = 0; i < numOfRows; ++i) {
+    TAOS_ROW row = taos_fetch_row(res);
+    if (row == NULL || *(int64_t*)row[0] != (int64_t)1600000000000 + pFetch->total + i) {
+      printf("\033[31mrow %" PRId64 ": mismatch in async fetch\033[0m\n", pFetch->total + i);
+      errors++;
+      break;
+    }
+  }
+
+  pFetch->total += numOfRows;
+  taos_fetch_rows_a(res, fetch_rows_cb, param);
+}
+
+static void verify_rows_async(TAOS* taos) {
+  SAsyncFetch fetch = {0};
+  sem_init(&fetch.done, 0, 0);
+
+  TAOS_RES* res = taos_query(taos, "select ts from tb");
+  taos_fetch_rows_a(res, fetch_rows_cb, &fetch);
+  sem_wait(&fetch.done);
+
+  if (taos_errno(res) != 0 || fetch.total != NUM_OF_ROWS) {
+    printf("\033[31m%" PRId64 " rows retrieved asynchronously, %d expected\033[0m\n", fetch.total, NUM_OF_ROWS);
+    errors++;
+  } else {
+    printf("%" PRId64 " rows retrieved asynchronously\n", fetch.total);
+  }
+
+  taos_free_result(res);
+  sem_destroy(&fetch.done);
+}
+
+int main(int argc, char* argv[]) {
+  const char* host = "127.0.0.1";
+  const char* user = "root";
+  const char* passwd = "taosdata";
+
+  taos_options(TSDB_OPTION_TIMEZONE, "GMT-8");
+  TAOS* taos = taos_connect(host, user, passwd, "", 0);
+  if (taos == NULL) {
+    printf("\033[31mfailed to connect to db, reason:%s\033[0m\n", taos_errstr(taos));
+    exit(1);
+  }
+
+  printf("************  Prepare data *************\n");
+  prepare_data(taos);
+
+  printf("************  Fetch columns *************\n");
+  verify_columns(taos);
+
+  printf("************  Fetch rows *************\n");
+  verify_rows(taos);
+  verify_rows_async(taos);
+
+  taos_close(taos);
+  taos_cleanup();
+
+  printf("%s\n", errors == 0 ? "done" : "failed");
+  return errors == 0 ? 0 : 1;
+}
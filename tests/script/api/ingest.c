@@ -0,0 +1,213 @@
+// sample code to verify the ingest pipeline (taos_ingest_*), and compare its throughput with taos_query
+// to compile: gcc -o ingest ingest.c -ltaos
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <taos.h>
+#include <unistd.h>
+#include <inttypes.h>
+#include <sys/time.h>
+
+#define START_TS ((int64_t)1600000000000)
+
+static int errors = 0;
+static int numOfTables = 100;
+static int numOfRows = 1000;         // rows per table
+static int rowsPerTable = 10;        // rows of a table in a statement
+static int tablesPerStmt = 10;       // tables in a statement
+
+static int64_t now_us() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return (int64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+static void execute(TAOS* taos, const char* sql) {
+  TAOS_RES* result = taos_query(taos, sql);
+  if (taos_errno(result) != 0) {
+    printf("\033[31mfailed to execute: %s, reason: %s\033[0m\n", sql, taos_errstr(result));
+    errors++;
+  }
+  taos_free_result(result);
+}
+
+static void prepare_tables(TAOS* taos) {
+  execute(taos, "drop database if exists ingest");
+  usleep(100000);
+  execute(taos, "create database ingest precision 'ms'");
+  usleep(100000);
+  taos_select_db(taos, "ingest");
+
+  char sql[256];
+  execute(taos, "create table st(ts timestamp, c0 int, c1 double) tags(t0 int)");
+  for (int i = 0; i < numOfTables; ++i) {
+    sprintf(sql, "create table t%d using st tags(%d)", i, i);
+    execute(taos, sql);
+  }
+}
+
+// the statements insert rowsPerTable rows into each of tablesPerStmt tables
+static char** build_statements(int* num) {
+  int    numOfStmts = (numOfTables / tablesPerStmt) * (numOfRows / rowsPerTable);
+  char** stmts = calloc(numOfStmts, sizeof(char*));
+  int    n = 0;
+
+  for (int r = 0; r < numOfRows; r += rowsPerTable) {
+    for (int t = 0; t + tablesPerStmt <= numOfTables; t += tablesPerStmt) {
+      char* sql = malloc(64 + tablesPerStmt * (16 + rowsPerTable * 48));
+      int   len = sprintf(sql, "insert into");
+      for (int i = t; i < t + tablesPerStmt; ++i) {
+        len += sprintf(sql + len, " t%d values", i);
+        for (int j = r; j < r + rowsPerTable; ++j) {
+          len += sprintf(sql + len, " (%" PRId64 ", %d, %d.5)", START_TS + j, j, i);
+        }
+      }
+      stmts[n++] = sql;
+    }
+  }
+
+  *num = n;
+  return stmts;
+}
+
+static void verify_count(TAOS* taos, int64_t expected) {
+  TAOS_RES* res = taos_query(taos, "select count(*), sum(c0) from st");
+  TAOS_ROW  row = taos_fetch_row(res);
+  int64_t   count = (row != NULL) ? *(int64_t*)row[0] : 0;
+  int64_t   sum = (row != NULL) ? *(int64_t*)row[1] : 0;
+  int64_t   expectedSum = (int64_t)numOfTables * (numOfRows - 1) * numOfRows / 2;
+
+  if (count != expected || (expected > 0 && sum != expectedSum)) {
+    printf("\033[31mcount:%" PRId64 " sum:%" PRId64 ", expected count:%" PRId64 " sum:%" PRId64 "\033[0m\n", count,
+           sum, expected, expectedSum);
+    errors++;
+  }
+  taos_free_result(res);
+}
+
+static void insert_by_query(TAOS* taos, char** stmts, int num) {
+  prepare_tables(taos);
+
+  int64_t st = now_us();
+  for (int i = 0; i < num; ++i) {
+    execute(taos, stmts[i]);
+  }
+  int64_t elapsed = now_us() - st;
+
+  printf("taos_query : %d statements, %.3f s, %.0f rows/s\n", num, elapsed / 1000000.0,
+         (double)numOfTables * numOfRows * 1000000 / elapsed);
+  verify_count(taos, (int64_t)numOfTables * numOfRows);
+}
+
+static void insert_by_ingest(TAOS* taos, char** stmts, int num) {
+  prepare_tables(taos);
+
+  TAOS_INGEST* ingest = taos_ingest_open(taos);
+  if (ingest == NULL) {
+    printf("\033[31mfailed to open ingest pipeline\033[0m\n");
+    errors++;
+    return;
+  }
+
+  int64_t st = now_us();
+  for (int i = 0; i < num; ++i) {
+    int code = taos_ingest_write(ingest, stmts[i]);
+    if (code != 0) {
+      printf("\033[31mfailed to write statement %d, reason: %s\033[0m\n", i, taos_errstr(NULL));
+      errors++;
+    }
+  }
+
+  if (taos_ingest_flush(ingest) != 0) {
+    printf("\033[31mfailed to flush ingest pipeline\033[0m\n");
+    errors++;
+  }
+  int64_t elapsed = now_us() - st;
+
+  TAOS_INGEST_STAT stat = {0};
+  taos_ingest_stat(ingest, &stat);
+  printf("taos_ingest: %d statements, %.3f s, %.0f rows/s, submits:%" PRId64 " rows per submit:%.1f max:%d "
+         "bytes per submit:%.1f direct statements:%" PRId64 "\n",
+         num, elapsed / 1000000.0, (double)numOfTables * numOfRows * 1000000 / elapsed, stat.submits,
+         stat.submits > 0 ? (double)stat.submitRows / stat.submits : 0, stat.maxSubmitRows,
+         stat.submits > 0 ? (double)stat.submitBytes / stat.submits : 0, stat.directStatements);
+
+  if (stat.rows != (int64_t)numOfTables * numOfRows || stat.failedStatements != 0 || stat.statements != num) {
+    printf("\033[31mrows:%" PRId64 " statements:%" PRId64 " failed:%" PRId64 "\033[0m\n", stat.rows, stat.statements,
+           stat.failedStatements);
+    errors++;
+  }
+  verify_count(taos, (int64_t)numOfTables * numOfRows);
+
+  // the tables created by the statements are not in the meta cache, and the invalid statement fails
+  taos_ingest_write(ingest, "insert into tn0 using st tags(-1) values(now, 1, 1.0)");
+  taos_ingest_write(ingest, "insert into tn1 using st tags(-2) values(now, 1, 1.0) tn0 values(now + 1s, 1, 1.0)");
+  taos_ingest_write(ingest, "insert into t0 values(now, 'abc', 1.0)");
+  if (taos_ingest_write(ingest, "select * from st") == 0) {
+    printf("\033[31mquery is written into ingest pipeline\033[0m\n");
+    errors++;
+  }
+
+  if (taos_ingest_close(ingest) == 0) {
+    printf("\033[31mthe error of the invalid statement is not returned\033[0m\n");
+    errors++;
+  }
+
+  TAOS_RES* res = taos_query(taos, "select count(*) from st where t0 < 0");
+  TAOS_ROW  row = taos_fetch_row(res);
+  if (row == NULL || *(int64_t*)row[0] != 3) {
+    printf("\033[31mrows of the tables created by the statements are not inserted\033[0m\n");
+    errors++;
+  }
+  taos_free_result(res);
+}
+
+int main(int argc, char* argv[]) {
+  const char* host = "127.0.0.1";
+  const char* user = "root";
+  const char* passwd = "taosdata";
+
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "-t") == 0 && i < argc - 1) {
+      numOfTables = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-n") == 0 && i < argc - 1) {
+      numOfRows = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-r") == 0 && i < argc - 1) {
+      rowsPerTable = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-s") == 0 && i < argc - 1) {
+      tablesPerStmt = atoi(argv[++i]);
+    } else {
+      printf("usage: %s [-t tables] [-n rows per table] [-r rows of a table in a statement] [-s tables in a statement]\n",
+             argv[0]);
+      exit(0);
+    }
+  }
+
+  taos_options(TSDB_OPTION_TIMEZONE, "GMT-8");
+  TAOS* taos = taos_connect(host, user, passwd, "", 0);
+  if (taos == NULL) {
+    printf("\033[31mfailed to connect to db, reason:%s\033[0m\n", taos_errstr(taos));
+    exit(1);
+  }
+
+  int    num = 0;
+  char** stmts = build_statements(&num);
+
+  printf("************  Insert by taos_query *************\n");
+  insert_by_query(taos, stmts, num);
+
+  printf("************  Insert by taos_ingest *************\n");
+  insert_by_ingest(taos, stmts, num);
+
+  for (int i = 0; i < num; ++i) {
+    free(stmts[i]);
+  }
+  free(stmts);
+
+  taos_close(taos);
+  taos_cleanup();
+
+  printf("%s\n", errors == 0 ? "done" : "failed");
+  return errors == 0 ? 0 : 1;
+}
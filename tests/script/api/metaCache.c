@@ -0,0 +1,203 @@
+// sample code to verify the client table meta cache (metaCacheMaxSize): the meta of the tables written by an insert
+// statement are retrieved in one request, the concurrent lookups of the same table are merged, and the child tables
+// are evicted beyond the limit
+// to compile: gcc -o metaCache metaCache.c -ltaos -lpthread
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <taos.h>
+#include <unistd.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <sys/time.h>
+
+#define TABLES_PER_SQL 100
+
+static int errors = 0;
+static int numOfTables = 20000;
+static int numOfThreads = 4;
+static int cacheSize = 1;
+
+static int64_t now_ms() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return (int64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+}
+
+static void execute(TAOS* taos, const char* sql) {
+  TAOS_RES* result = taos_query(taos, sql);
+  if (taos_errno(result) != 0) {
+    printf("\033[31mfailed to execute: %.100s, reason: %s\033[0m\n", sql, taos_errstr(result));
+    __atomic_add_fetch(&errors, 1, __ATOMIC_SEQ_CST);
+  }
+  taos_free_result(result);
+}
+
+static int64_t query_count(TAOS* taos, const char* sql) {
+  int64_t   count = -1;
+  TAOS_RES* result = taos_query(taos, sql);
+  if (taos_errno(result) != 0) {
+    printf("\033[31mfailed to execute: %s, reason: %s\033[0m\n", sql, taos_errstr(result));
+    errors++;
+  } else {
+    TAOS_ROW row = taos_fetch_row(result);
+    count = (row != NULL) ? *(int64_t*)row[0] : 0;
+  }
+  taos_free_result(result);
+  return count;
+}
+
+static TAOS* connect_db() {
+  TAOS* taos = taos_connect("127.0.0.1", "root", "taosdata", "", 0);
+  if (taos == NULL) {
+    printf("\033[31mfailed to connect to db, reason:%s\033[0m\n", taos_errstr(taos));
+    exit(1);
+  }
+  return taos;
+}
+
+static void prepare_tables() {
+  TAOS* taos = connect_db();
+  execute(taos, "drop database if exists metacache");
+  usleep(100000);
+  execute(taos, "create database metacache");
+  usleep(100000);
+  taos_select_db(taos, "metacache");
+
+  execute(taos, "create table st(ts timestamp, v int) tags(t int)");
+
+  char* sql = malloc(1024 * 1024);
+  for (int i = 0; i < numOfTables; i += 500) {
+    int len = sprintf(sql, "create table");
+    for (int j = i; j < i + 500 && j < numOfTables; ++j) {
+      len += sprintf(sql + len, " if not exists t%d using st tags(%d)", j, j);
+    }
+    execute(taos, sql);
+  }
+  free(sql);
+
+  // the cache of the client is released with the last connection
+  taos_close(taos);
+}
+
+// insert one row into every table, from a connection without any table meta cached
+static void insert_cold(int64_t ts) {
+  TAOS* taos = connect_db();
+  taos_select_db(taos, "metacache");
+
+  char*   sql = malloc(1024 * 1024);
+  int64_t st = now_ms();
+  for (int i = 0; i < numOfTables; i += TABLES_PER_SQL) {
+    int len = sprintf(sql, "insert into");
+    for (int j = i; j < i + TABLES_PER_SQL && j < numOfTables; ++j) {
+      len += sprintf(sql + len, " t%d values(%" PRId64 ", %d)", j, ts, j);
+    }
+    execute(taos, sql);
+  }
+  printf("insert into %d tables in %" PRId64 " ms\n", numOfTables, now_ms() - st);
+  free(sql);
+
+  // the tables evicted from the cache are retrieved again
+  int64_t count = query_count(taos, "select count(*) from t0");
+  if (count != 1) {
+    printf("\033[31mrows of t0: %" PRId64 ", expected 1\033[0m\n", count);
+    errors++;
+  }
+  taos_close(taos);
+}
+
+typedef struct {
+  int     index;
+  int64_t ts;
+} SThreadInfo;
+
+// every thread writes its rows into the same tables created automatically, one table or many tables per statement
+static void* insert_thread(void* param) {
+  SThreadInfo* pInfo = param;
+  TAOS*        taos = connect_db();
+  taos_select_db(taos, "metacache");
+
+  char sql[32 * 1024];
+  for (int i = 0; i < 200; ++i) {
+    if (i % 2 == 0) {
+      sprintf(sql, "insert into c%d using st tags(%d) values(%" PRId64 ", %d)", i, i, pInfo->ts + pInfo->index, i);
+    } else {
+      int len = sprintf(sql, "insert into");
+      for (int j = 0; j < 10; ++j) {
+        int t = 1000 + i * 10 + j;
+        len += sprintf(sql + len, " c%d using st tags(%d) values(%" PRId64 ", %d)", t, t, pInfo->ts + pInfo->index, t);
+      }
+    }
+    execute(taos, sql);
+  }
+
+  taos_close(taos);
+  return NULL;
+}
+
+static void insert_concurrent(int64_t ts) {
+  pthread_t   threads[64];
+  SThreadInfo info[64];
+
+  int64_t st = now_ms();
+  for (int i = 0; i < numOfThreads; ++i) {
+    info[i].index = i;
+    info[i].ts = ts;
+    pthread_create(&threads[i], NULL, insert_thread, &info[i]);
+  }
+  for (int i = 0; i < numOfThreads; ++i) {
+    pthread_join(threads[i], NULL);
+  }
+  printf("%d threads insert into the same new tables in %" PRId64 " ms\n", numOfThreads, now_ms() - st);
+}
+
+int main(int argc, char* argv[]) {
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "-n") == 0 && i < argc - 1) {
+      numOfTables = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-t") == 0 && i < argc - 1) {
+      numOfThreads = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-m") == 0 && i < argc - 1) {
+      cacheSize = atoi(argv[++i]);
+    } else {
+      printf("usage: %s [-n tables] [-t threads] [-m metaCacheMaxSize in MB, 0: no limit]\n", argv[0]);
+      exit(0);
+    }
+  }
+  if (numOfThreads > 64) {
+    numOfThreads = 64;
+  }
+
+  char config[128];
+  sprintf(config, "{\"metaCacheMaxSize\":\"%d\"}", cacheSize);
+  taos_set_config(config);
+
+  prepare_tables();
+
+  int64_t ts = 1600000000000;
+  insert_cold(ts);
+  insert_concurrent(ts + 1000);
+
+  TAOS* taos = connect_db();
+  taos_select_db(taos, "metacache");
+
+  int64_t count = query_count(taos, "select count(*) from st");
+  int64_t expected = numOfTables + 1100 * (int64_t)numOfThreads;
+  if (count != expected) {
+    printf("\033[31mrows of st: %" PRId64 ", expected %" PRId64 "\033[0m\n", count, expected);
+    errors++;
+  }
+
+  count = query_count(taos, "select count(tbname) from st");
+  if (count != numOfTables + 1100) {
+    printf("\033[31mtables of st: %" PRId64 ", expected %d\033[0m\n", count, numOfTables + 1100);
+    errors++;
+  }
+
+  taos_close(taos);
+  taos_cleanup();
+
+  printf("%s\n", errors == 0 ? "done" : "failed");
+  return errors == 0 ? 0 : 1;
+}
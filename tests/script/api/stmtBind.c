@@ -0,0 +1,322 @@
+// sample code to verify taos_stmt_bind_param_batch on wide tables, and compare the rows/s of 10, 100 and 1000 columns
+// to compile: gcc -o stmtBind stmtBind.c -ltaos
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <taos.h>
+#include <unistd.h>
+#include <inttypes.h>
+#include <sys/time.h>
+
+#define START_TS      ((int64_t)1600000000000)
+#define MAX_BATCH     1000
+#define BATCH_BYTES   (512 * 1024)
+#define BINARY_LEN    16
+
+static int errors = 0;
+static int numOfRows = 20000;
+
+static const int types[] = {TSDB_DATA_TYPE_INT,   TSDB_DATA_TYPE_BIGINT,   TSDB_DATA_TYPE_DOUBLE, TSDB_DATA_TYPE_FLOAT,
+                            TSDB_DATA_TYPE_SMALLINT, TSDB_DATA_TYPE_TINYINT, TSDB_DATA_TYPE_BOOL};
+static const char* typeNames[] = {"int", "bigint", "double", "float", "smallint", "tinyint", "bool"};
+
+static int64_t now_us() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return (int64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+static void execute(TAOS* taos, const char* sql) {
+  TAOS_RES* result = taos_query(taos, sql);
+  if (taos_errno(result) != 0) {
+    printf("\033[31mfailed to execute: %s, reason: %s\033[0m\n", sql, taos_errstr(result));
+    errors++;
+  }
+  taos_free_result(result);
+}
+
+// column 1 is an int, every 10th column after it is a binary if withBinary is set
+static int column_type(int col, int withBinary) {
+  if (col == 0) {
+    return TSDB_DATA_TYPE_TIMESTAMP;
+  }
+  if (withBinary && col > 1 && col % 10 == 0) {
+    return TSDB_DATA_TYPE_BINARY;
+  }
+  return types[(col - 1) % (sizeof(types) / sizeof(types[0]))];
+}
+
+static int column_bytes(int type) {
+  switch (type) {
+    case TSDB_DATA_TYPE_TIMESTAMP:
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_DOUBLE:
+      return 8;
+    case TSDB_DATA_TYPE_INT:
+    case TSDB_DATA_TYPE_FLOAT:
+      return 4;
+    case TSDB_DATA_TYPE_SMALLINT:
+      return 2;
+    case TSDB_DATA_TYPE_BINARY:
+      return BINARY_LEN;
+    default:
+      return 1;
+  }
+}
+
+static void create_table(TAOS* taos, int numOfCols, int withBinary) {
+  execute(taos, "drop table if exists tb");
+
+  char* sql = malloc(64 + numOfCols * 32);
+  int   len = sprintf(sql, "create table tb(ts timestamp");
+  for (int i = 1; i < numOfCols; ++i) {
+    int type = column_type(i, withBinary);
+    if (type == TSDB_DATA_TYPE_BINARY) {
+      len += sprintf(sql + len, ", c%d binary(%d)", i, BINARY_LEN);
+    } else {
+      len += sprintf(sql + len, ", c%d %s", i, typeNames[(i - 1) % (sizeof(types) / sizeof(types[0]))]);
+    }
+  }
+  sprintf(sql + len, ")");
+  execute(taos, sql);
+  free(sql);
+}
+
+// the columns of a batch, the value of row r in every column is r, and it is NULL if r % 13 == 0
+static TAOS_MULTI_BIND* init_columns(int numOfCols, int withBinary, int batch) {
+  TAOS_MULTI_BIND* binds = calloc(numOfCols, sizeof(TAOS_MULTI_BIND));
+  for (int i = 0; i < numOfCols; ++i) {
+    TAOS_MULTI_BIND* b = &binds[i];
+    b->buffer_type = column_type(i, withBinary);
+    b->buffer_length = column_bytes(b->buffer_type);
+    b->buffer = calloc(batch, b->buffer_length);
+    b->is_null = (i == 0) ? NULL : calloc(batch, sizeof(char));
+    b->length = (b->buffer_type == TSDB_DATA_TYPE_BINARY) ? calloc(batch, sizeof(int32_t)) : NULL;
+    b->num = batch;
+  }
+  return binds;
+}
+
+static void fill_columns(TAOS_MULTI_BIND* binds, int numOfCols, int start, int batch) {
+  for (int i = 0; i < numOfCols; ++i) {
+    TAOS_MULTI_BIND* b = &binds[i];
+    b->num = batch;
+    for (int j = 0; j < batch; ++j) {
+      int   r = start + j;
+      char* p = (char*)b->buffer + b->buffer_length * j;
+      if (b->is_null != NULL) {
+        b->is_null[j] = (r % 13 == 0);
+      }
+
+      switch (b->buffer_type) {
+        case TSDB_DATA_TYPE_TIMESTAMP: *(int64_t*)p = START_TS + r; break;
+        case TSDB_DATA_TYPE_BIGINT:    *(int64_t*)p = r; break;
+        case TSDB_DATA_TYPE_DOUBLE:    *(double*)p = r; break;
+        case TSDB_DATA_TYPE_INT:       *(int32_t*)p = r; break;
+        case TSDB_DATA_TYPE_FLOAT:     *(float*)p = (float)r; break;
+        case TSDB_DATA_TYPE_SMALLINT:  *(int16_t*)p = (int16_t)r; break;
+        case TSDB_DATA_TYPE_TINYINT:   *(int8_t*)p = (int8_t)r; break;
+        case TSDB_DATA_TYPE_BOOL:      *(int8_t*)p = (int8_t)(r & 1); break;
+        case TSDB_DATA_TYPE_BINARY:    b->length[j] = sprintf(p, "b%d", r); break;
+      }
+    }
+  }
+}
+
+static void free_columns(TAOS_MULTI_BIND* binds, int numOfCols) {
+  for (int i = 0; i < numOfCols; ++i) {
+    free(binds[i].buffer);
+    free(binds[i].is_null);
+    free(binds[i].length);
+  }
+  free(binds);
+}
+
+static void verify_table(TAOS* taos, int numOfCols, int withBinary) {
+  int64_t expectSum = 0, expectCount = 0;
+  for (int r = 0; r < numOfRows; ++r) {
+    if (r % 13 != 0) {
+      expectSum += r;
+      expectCount++;
+    }
+  }
+
+  char sql[128];
+  sprintf(sql, "select count(*), count(c1), sum(c1), last(c%d) from tb", numOfCols - 1);
+  TAOS_RES*   res = taos_query(taos, sql);
+  TAOS_ROW    row = taos_fetch_row(res);
+  TAOS_FIELD* fields = taos_fetch_fields(res);
+  int64_t     r = numOfRows - 1;
+  while (r % 13 == 0) {
+    r--;
+  }
+
+  char last[64] = {0};
+  if (row != NULL && row[3] != NULL) {
+    if (fields[3].type == TSDB_DATA_TYPE_BINARY) {
+      memcpy(last, row[3], ((int16_t*)row[3])[-1]);
+    } else {
+      taos_print_row(last, row + 3, fields + 3, 1);
+    }
+  }
+
+  char expectLast[64];
+  int  lastType = column_type(numOfCols - 1, withBinary);
+  if (lastType == TSDB_DATA_TYPE_BINARY) {
+    sprintf(expectLast, "b%" PRId64, r);
+  } else if (lastType == TSDB_DATA_TYPE_BOOL) {
+    sprintf(expectLast, "%s", (r & 1) ? "true" : "false");
+  } else if (lastType == TSDB_DATA_TYPE_TINYINT) {
+    sprintf(expectLast, "%d", (int8_t)r);
+  } else if (lastType == TSDB_DATA_TYPE_SMALLINT) {
+    sprintf(expectLast, "%d", (int16_t)r);
+  } else if (lastType == TSDB_DATA_TYPE_FLOAT || lastType == TSDB_DATA_TYPE_DOUBLE) {
+    sprintf(expectLast, "%.*f", lastType == TSDB_DATA_TYPE_FLOAT ? 5 : 9, (double)r);
+  } else {
+    sprintf(expectLast, "%" PRId64, r);
+  }
+
+  if (row == NULL || *(int64_t*)row[0] != numOfRows || *(int64_t*)row[1] != expectCount ||
+      *(int64_t*)row[2] != expectSum || strcmp(last, expectLast) != 0) {
+    printf("\033[31m%d columns: count:%" PRId64 " count(c1):%" PRId64 " sum(c1):%" PRId64 " last:%s, expected "
+           "%d %" PRId64 " %" PRId64 " %s\033[0m\n", numOfCols, row ? *(int64_t*)row[0] : 0,
+           row ? *(int64_t*)row[1] : 0, row ? *(int64_t*)row[2] : 0, last, numOfRows, expectCount, expectSum,
+           expectLast);
+    errors++;
+  }
+  taos_free_result(res);
+}
+
+static void bind_columns(TAOS* taos, int numOfCols, int withBinary) {
+  create_table(taos, numOfCols, withBinary);
+
+  // keep the submit message of a batch within BATCH_BYTES
+  int rowSize = 0;
+  for (int i = 0; i < numOfCols; ++i) {
+    rowSize += column_bytes(column_type(i, withBinary));
+  }
+  int batch = BATCH_BYTES / rowSize;
+  if (batch > MAX_BATCH) {
+    batch = MAX_BATCH;
+  }
+
+  char* sql = malloc(64 + numOfCols * 3);
+  int   len = sprintf(sql, "insert into tb values(?");
+  for (int i = 1; i < numOfCols; ++i) {
+    len += sprintf(sql + len, ",?");
+  }
+  sprintf(sql + len, ")");
+
+  TAOS_STMT* stmt = taos_stmt_init(taos);
+  if (taos_stmt_prepare(stmt, sql, 0) != 0) {
+    printf("\033[31mfailed to prepare: %s\033[0m\n", taos_stmt_errstr(stmt));
+    errors++;
+    taos_stmt_close(stmt);
+    free(sql);
+    return;
+  }
+
+  TAOS_MULTI_BIND* binds = init_columns(numOfCols, withBinary, batch);
+  int64_t          bindTime = 0;
+  int64_t          st = now_us();
+
+  for (int r = 0; r < numOfRows; r += batch) {
+    int num = (numOfRows - r < batch) ? numOfRows - r : batch;
+    fill_columns(binds, numOfCols, r, num);
+
+    int64_t bst = now_us();
+    if (taos_stmt_bind_param_batch(stmt, binds) != 0 || taos_stmt_add_batch(stmt) != 0) {
+      printf("\033[31mfailed to bind, reason: %s\033[0m\n", taos_stmt_errstr(stmt));
+      errors++;
+      break;
+    }
+    bindTime += now_us() - bst;
+
+    if (taos_stmt_execute(stmt) != 0) {
+      printf("\033[31mfailed to execute, reason: %s\033[0m\n", taos_stmt_errstr(stmt));
+      errors++;
+      break;
+    }
+  }
+
+  int64_t elapsed = now_us() - st;
+  printf("%4d columns%s, %4d rows per batch: bind %10.0f rows/s, %8.1f Mvalues/s, insert %8.0f rows/s\n",
+         numOfCols, withBinary ? " (with binary)" : "              ", batch,
+         (double)numOfRows * 1000000 / bindTime, (double)numOfRows * numOfCols / bindTime,
+         (double)numOfRows * 1000000 / elapsed);
+
+  free_columns(binds, numOfCols);
+  taos_stmt_close(stmt);
+  free(sql);
+
+  verify_table(taos, numOfCols, withBinary);
+}
+
+// a NULL primary timestamp in a batch is rejected by the bind
+static void bind_null_timestamp(TAOS* taos) {
+  const int numOfCols = 10;
+  const int batch = 100;
+
+  create_table(taos, numOfCols, 0);
+
+  TAOS_STMT* stmt = taos_stmt_init(taos);
+  if (taos_stmt_prepare(stmt, "insert into tb values(?,?,?,?,?,?,?,?,?,?)", 0) != 0) {
+    printf("\033[31mfailed to prepare: %s\033[0m\n", taos_stmt_errstr(stmt));
+    errors++;
+    taos_stmt_close(stmt);
+    return;
+  }
+
+  TAOS_MULTI_BIND* binds = init_columns(numOfCols, 0, batch);
+  fill_columns(binds, numOfCols, 1, batch);
+  binds[0].is_null = calloc(batch, sizeof(char));
+  binds[0].is_null[batch / 2] = 1;
+
+  if (taos_stmt_bind_param_batch(stmt, binds) == 0) {
+    printf("\033[31mNULL primary timestamp is bound\033[0m\n");
+    errors++;
+  } else {
+    printf("NULL primary timestamp is rejected: %s\n", taos_stmt_errstr(stmt));
+  }
+
+  free_columns(binds, numOfCols);
+  taos_stmt_close(stmt);
+}
+
+int main(int argc, char* argv[]) {
+  const char* host = "127.0.0.1";
+  const char* user = "root";
+  const char* passwd = "taosdata";
+
+  if (argc > 1) {
+    numOfRows = atoi(argv[1]);
+  }
+
+  taos_options(TSDB_OPTION_TIMEZONE, "GMT-8");
+  TAOS* taos = taos_connect(host, user, passwd, "", 0);
+  if (taos == NULL) {
+    printf("\033[31mfailed to connect to db, reason:%s\033[0m\n", taos_errstr(taos));
+    exit(1);
+  }
+
+  execute(taos, "drop database if exists stmtbind");
+  usleep(100000);
+  execute(taos, "create database stmtbind precision 'ms'");
+  usleep(100000);
+  taos_select_db(taos, "stmtbind");
+
+  printf("************  Bind %d rows by columns *************\n", numOfRows);
+  int numOfCols[] = {10, 100, 1000};
+  for (int i = 0; i < 3; ++i) {
+    bind_columns(taos, numOfCols[i], 0);
+    bind_columns(taos, numOfCols[i], 1);
+  }
+  bind_null_timestamp(taos);
+
+  taos_close(taos);
+  taos_cleanup();
+
+  printf("%s\n", errors == 0 ? "done" : "failed");
+  return errors == 0 ? 0 : 1;
+}
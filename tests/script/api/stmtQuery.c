@@ -0,0 +1,178 @@
+// sample code to verify the prepared select statements, whose plan is cached when the parameters only bound the
+// primary timestamp, and the time window is patched for each execution
+// to compile: gcc -o stmtQuery stmtQuery.c -ltaos
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <taos.h>
+#include <unistd.h>
+#include <inttypes.h>
+#include <sys/time.h>
+
+#define NUM_OF_ROWS   30000
+#define ROWS_PER_SQL  500
+#define START_TS      ((int64_t)1600000000000)
+
+static int errors = 0;
+
+static int64_t now_us() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return (int64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+static void execute(TAOS* taos, const char* sql) {
+  TAOS_RES* result = taos_query(taos, sql);
+  if (taos_errno(result) != 0) {
+    printf("\033[31mfailed to execute: %s, reason: %s\033[0m\n", sql, taos_errstr(result));
+    errors++;
+  }
+  taos_free_result(result);
+}
+
+static void prepare_data(TAOS* taos) {
+  execute(taos, "drop database if exists test");
+  usleep(100000);
+  execute(taos, "create database test precision 'ms'");
+  usleep(100000);
+  taos_select_db(taos, "test");
+
+  execute(taos, "create table tb(ts timestamp, c0 int, c1 double)");
+  execute(taos, "create table st(ts timestamp, c0 int) tags(t0 int)");
+  execute(taos, "create table ct0 using st tags(0)");
+
+  char* sql = malloc(ROWS_PER_SQL * 64 + 64);
+  for (int i = 0; i < NUM_OF_ROWS; i += ROWS_PER_SQL) {
+    int len = sprintf(sql, "insert into tb values");
+    for (int j = i; j < i + ROWS_PER_SQL; ++j) {
+      len += sprintf(sql + len, " (%" PRId64 ", %d, %d.5)", START_TS + j, j, j);
+    }
+    execute(taos, sql);
+
+    len = sprintf(sql, "insert into ct0 values");
+    for (int j = i; j < i + ROWS_PER_SQL; ++j) {
+      len += sprintf(sql + len, " (%" PRId64 ", %d)", START_TS + j, j);
+    }
+    execute(taos, sql);
+  }
+  free(sql);
+}
+
+// the sum of c0 in [skey, ekey]
+static int64_t expected_sum(int64_t skey, int64_t ekey) {
+  if (skey < START_TS) skey = START_TS;
+  if (ekey > START_TS + NUM_OF_ROWS - 1) ekey = START_TS + NUM_OF_ROWS - 1;
+  if (skey > ekey) return 0;
+
+  int64_t s = skey - START_TS, e = ekey - START_TS;
+  return (s + e) * (e - s + 1) / 2;
+}
+
+// bind the window [skey, ekey) and check count(*) and sum(c0), or the rows if it is a projection
+static void query_window(TAOS_STMT* stmt, int64_t skey, int64_t ekey, int projection) {
+  uintptr_t len = sizeof(int64_t);
+  TAOS_BIND params[2] = {{0}};
+  params[0].buffer_type = TSDB_DATA_TYPE_TIMESTAMP;
+  params[0].buffer_length = sizeof(int64_t);
+  params[0].buffer = &skey;
+  params[0].length = &len;
+  params[1] = params[0];
+  params[1].buffer = &ekey;
+
+  if (taos_stmt_bind_param(stmt, params) != 0 || taos_stmt_execute(stmt) != 0) {
+    printf("\033[31mfailed to execute the statement, reason: %s\033[0m\n", taos_stmt_errstr(stmt));
+    errors++;
+    return;
+  }
+
+  TAOS_RES* res = taos_stmt_use_result(stmt);
+  int64_t   count = 0, sum = 0;
+  TAOS_ROW  row = NULL;
+
+  if (projection) {
+    int64_t ts = (skey > START_TS) ? skey : START_TS;
+    while ((row = taos_fetch_row(res)) != NULL) {
+      if (*(int64_t*)row[0] != ts || *(int32_t*)row[1] != ts - START_TS) {
+        printf("\033[31mrow %" PRId64 " mismatch in [%" PRId64 ", %" PRId64 ")\033[0m\n", count, skey, ekey);
+        errors++;
+        break;
+      }
+      sum += *(int32_t*)row[1];
+      count++;
+      ts++;
+    }
+  } else if ((row = taos_fetch_row(res)) != NULL) {
+    count = *(int64_t*)row[0];
+    sum = *(int64_t*)row[1];
+  }
+
+  int64_t s = (skey > START_TS) ? skey : START_TS;
+  int64_t e = (ekey - 1 < START_TS + NUM_OF_ROWS - 1) ? ekey - 1 : START_TS + NUM_OF_ROWS - 1;
+  int64_t expectCount = (s <= e) ? e - s + 1 : 0;
+
+  if (taos_errno(res) != 0 || count != expectCount || sum != expected_sum(skey, ekey - 1)) {
+    printf("\033[31m[%" PRId64 ", %" PRId64 "): count:%" PRId64 " sum:%" PRId64 ", expected count:%" PRId64
+           " sum:%" PRId64 "\033[0m\n", skey, ekey, count, sum, expectCount, expected_sum(skey, ekey - 1));
+    errors++;
+  }
+
+  taos_free_result(res);
+}
+
+static void verify_windows(TAOS* taos, const char* sql, int projection, int loops) {
+  TAOS_STMT* stmt = taos_stmt_init(taos);
+  if (taos_stmt_prepare(stmt, sql, 0) != 0) {
+    printf("\033[31mfailed to prepare: %s, reason: %s\033[0m\n", sql, taos_stmt_errstr(stmt));
+    errors++;
+    taos_stmt_close(stmt);
+    return;
+  }
+
+  int64_t st = now_us();
+  for (int i = 0; i < loops; ++i) {
+    int64_t skey = START_TS - 100 + (i * 7919) % (NUM_OF_ROWS + 200);
+    int64_t ekey = skey + 1 + (i * 104729) % 3000;
+    query_window(stmt, skey, ekey, projection);
+  }
+
+  // empty window and the whole table
+  query_window(stmt, START_TS + 10, START_TS + 10, projection);
+  query_window(stmt, START_TS - 1000, START_TS + NUM_OF_ROWS + 1000, projection);
+
+  printf("%-70s %d executions, %.1f us per execution\n", sql, loops + 2, (double)(now_us() - st) / (loops + 2));
+  taos_stmt_close(stmt);
+}
+
+int main(int argc, char* argv[]) {
+  const char* host = "127.0.0.1";
+  const char* user = "root";
+  const char* passwd = "taosdata";
+  int         loops = (argc > 1) ? atoi(argv[1]) : 200;
+
+  taos_options(TSDB_OPTION_TIMEZONE, "GMT-8");
+  TAOS* taos = taos_connect(host, user, passwd, "", 0);
+  if (taos == NULL) {
+    printf("\033[31mfailed to connect to db, reason:%s\033[0m\n", taos_errstr(taos));
+    exit(1);
+  }
+
+  printf("************  Prepare data *************\n");
+  prepare_data(taos);
+
+  printf("************  Prepared select *************\n");
+  // the plan is cached
+  verify_windows(taos, "select count(*), sum(c0) from tb where ts >= ? and ts < ?", 0, loops);
+  verify_windows(taos, "select count(*), sum(c0) from ct0 where ts >= ? and ts < ?", 0, loops);
+  verify_windows(taos, "select ts, c0 from tb where ts >= ? and ts < ? order by ts", 1, loops);
+
+  // the plan is not cached, the statements are parsed for each execution
+  verify_windows(taos, "select count(*), sum(c0) from st where ts >= ? and ts < ?", 0, loops);
+  verify_windows(taos, "select count(*), sum(c0) from tb where ts >= ? and ts < ? and ts > 0", 0, loops);
+
+  taos_close(taos);
+  taos_cleanup();
+
+  printf("%s\n", errors == 0 ? "done" : "failed");
+  return errors == 0 ? 0 : 1;
+}
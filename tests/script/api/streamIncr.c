@@ -0,0 +1,193 @@
+// sample code to verify the incremental stream (incrementalStream), the windows emitted by the stream are compared
+// with the result of the same query, and the time of both is printed
+// to compile: gcc -o streamIncr streamIncr.c -ltaos -lpthread
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <taos.h>
+#include <unistd.h>
+#include <inttypes.h>
+#include <sys/time.h>
+
+#define MAX_ROWS  4096
+#define ROW_LEN   512
+
+typedef struct {
+  const char* sql;
+  int         numOfRows;
+  int         closed;
+  char        rows[MAX_ROWS][ROW_LEN];
+} SStreamResult;
+
+static int     errors = 0;
+static int     incremental = 1;
+static int     numOfRows = 3000;
+static int64_t base = 0;
+
+static int64_t now_ms() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return (int64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+}
+
+static void execute(TAOS* taos, const char* sql) {
+  TAOS_RES* result = taos_query(taos, sql);
+  if (taos_errno(result) != 0) {
+    printf("\033[31mfailed to execute: %s, reason: %s\033[0m\n", sql, taos_errstr(result));
+    errors++;
+  }
+  taos_free_result(result);
+}
+
+static void prepare_tables(TAOS* taos) {
+  execute(taos, "drop database if exists streamincr");
+  usleep(100000);
+  execute(taos, "create database streamincr precision 'ms'");
+  usleep(100000);
+  taos_select_db(taos, "streamincr");
+
+  execute(taos, "create table st(ts timestamp, v int, f double) tags(t int)");
+  execute(taos, "create table t0 using st tags(0)");
+  execute(taos, "create table t1 using st tags(1)");
+
+  // the rows of the last hour, with null values and gaps longer than the windows
+  base = (now_ms() - 3600 * 1000) / 10000 * 10000;
+  char*   sql = malloc(1024 * 1024);
+  int64_t ts = base;
+  int     len = 0;
+  for (int i = 0; i < numOfRows; ++i) {
+    ts += 1 + (i * 7919) % 1500 + ((i % 500 == 499) ? 30000 : 0);
+    if (len == 0) {
+      len = sprintf(sql, "insert into t%d values", i % 2);
+    }
+    if (i % 11 == 0) {
+      len += sprintf(sql + len, " (%" PRId64 ", null, %f)", ts, (i % 37) * 0.5);
+    } else {
+      len += sprintf(sql + len, " (%" PRId64 ", %d, %f)", ts, (i * 31) % 1000 - 500, (i % 37) * 0.5);
+    }
+    if (i % 2 == 1) {
+      execute(taos, sql);
+      len = 0;
+    }
+  }
+  if (len > 0) {
+    execute(taos, sql);
+  }
+  free(sql);
+}
+
+static void stream_callback(void* param, TAOS_RES* res, TAOS_ROW row) {
+  SStreamResult* pResult = param;
+  if (res == NULL || row == NULL) {
+    return;
+  }
+
+  if (pResult->numOfRows < MAX_ROWS) {
+    taos_print_row(pResult->rows[pResult->numOfRows], row, taos_fetch_fields(res), taos_num_fields(res));
+  }
+  pResult->numOfRows++;
+}
+
+static void stream_stopped(void* param) {
+  SStreamResult* pResult = param;
+  pResult->closed = 1;
+}
+
+static void run_stream(TAOS* taos, const char* func, const char* window, int64_t range) {
+  static SStreamResult result;
+  char                 sql[1024];
+
+  sprintf(sql, "select %s from st where ts >= %" PRId64 " and ts < %" PRId64 " %s", func, base, base + range, window);
+  memset(&result, 0, sizeof(result));
+  result.sql = sql;
+
+  int64_t      st = now_ms();
+  TAOS_STREAM* pStream = taos_open_stream(taos, sql, stream_callback, base, &result, stream_stopped);
+  if (pStream == NULL) {
+    printf("\033[31mfailed to open stream: %s\033[0m\n", sql);
+    errors++;
+    return;
+  }
+
+  while (!result.closed && now_ms() - st < 600 * 1000) {
+    usleep(100000);
+  }
+  int64_t streamTime = now_ms() - st;
+  if (!result.closed) {
+    printf("\033[31mthe stream is not stopped: %s\033[0m\n", sql);
+    errors++;
+    taos_close_stream(pStream);
+    return;
+  }
+
+  st = now_ms();
+  TAOS_RES* res = taos_query(taos, sql);
+  if (taos_errno(res) != 0) {
+    printf("\033[31mfailed to execute: %s, reason: %s\033[0m\n", sql, taos_errstr(res));
+    errors++;
+    taos_free_result(res);
+    return;
+  }
+
+  TAOS_ROW row;
+  int      num = 0, mismatches = 0;
+  char     str[ROW_LEN];
+  while ((row = taos_fetch_row(res)) != NULL) {
+    taos_print_row(str, row, taos_fetch_fields(res), taos_num_fields(res));
+    if (num >= result.numOfRows || strcmp(str, result.rows[num]) != 0) {
+      if (mismatches++ < 5) {
+        printf("\033[31mrow %d, query: %s, stream: %s\033[0m\n", num, str, num < result.numOfRows ? result.rows[num] : "");
+      }
+    }
+    num++;
+  }
+  taos_free_result(res);
+
+  printf("%s: %d windows in %" PRId64 " ms, query: %d windows in %" PRId64 " ms, sql: %s\n",
+         incremental ? "incremental" : "query", result.numOfRows, streamTime, num, now_ms() - st, sql);
+
+  if (num != result.numOfRows || mismatches > 0) {
+    printf("\033[31m%d windows of the stream, %d windows of the query, %d mismatches\033[0m\n", result.numOfRows, num,
+           mismatches);
+    errors++;
+  }
+}
+
+int main(int argc, char* argv[]) {
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "-i") == 0 && i < argc - 1) {
+      incremental = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-n") == 0 && i < argc - 1) {
+      numOfRows = atoi(argv[++i]);
+    } else {
+      printf("usage: %s [-i 1: incremental stream, 0: query every window] [-n rows]\n", argv[0]);
+      exit(0);
+    }
+  }
+
+  char config[128];
+  sprintf(config, "{\"incrementalStream\":\"%d\", \"streamStateBufferSize\":\"1\"}", incremental);
+  taos_set_config(config);
+
+  taos_options(TSDB_OPTION_TIMEZONE, "GMT-8");
+  TAOS* taos = taos_connect("127.0.0.1", "root", "taosdata", "", 0);
+  if (taos == NULL) {
+    printf("\033[31mfailed to connect to db, reason:%s\033[0m\n", taos_errstr(taos));
+    exit(1);
+  }
+  prepare_tables(taos);
+
+  const char* func = "count(*), count(v), sum(v), min(v), max(v), avg(v), first(v), last(v), spread(v), sum(f), max(f)";
+  run_stream(taos, func, "interval(10s) sliding(2s)", 600 * 1000);
+  run_stream(taos, "count(*), avg(f), spread(f)", "interval(30s) sliding(10s)", 3000 * 1000);
+
+  // the panes of the windows are more than the buffer, and kept in a file
+  run_stream(taos, "count(*), sum(v), min(f)", "interval(60s) sliding(1001a)", 300 * 1000);
+
+  taos_close(taos);
+  taos_cleanup();
+
+  printf("%s\n", errors == 0 ? "done" : "failed");
+  return errors == 0 ? 0 : 1;
+}
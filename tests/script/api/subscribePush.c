@@ -0,0 +1,237 @@
+// sample code to verify the subscription waiting for the submits in the vnodes (subscribePush), and compare its
+// latency with the subscription querying the tables on every consume
+// to compile: gcc -o subscribePush subscribePush.c -ltaos -lpthread
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <taos.h>
+#include <unistd.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <sys/time.h>
+
+#define NUM_OF_TABLES 10
+#define INTERVAL      1000  // ms
+
+static int     errors = 0;
+static int     push = 1;
+static int     rounds = 20;
+static int64_t insertedAt[1000];
+
+static int64_t now_us() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return (int64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+static void execute(TAOS* taos, const char* sql) {
+  TAOS_RES* result = taos_query(taos, sql);
+  if (taos_errno(result) != 0) {
+    printf("\033[31mfailed to execute: %s, reason: %s\033[0m\n", sql, taos_errstr(result));
+    errors++;
+  }
+  taos_free_result(result);
+}
+
+static TAOS* connect_db() {
+  TAOS* taos = taos_connect("127.0.0.1", "root", "taosdata", "", 0);
+  if (taos == NULL) {
+    printf("\033[31mfailed to connect to db, reason:%s\033[0m\n", taos_errstr(taos));
+    exit(1);
+  }
+  return taos;
+}
+
+static void prepare_tables(TAOS* taos) {
+  execute(taos, "drop database if exists subpush");
+  usleep(100000);
+  execute(taos, "create database subpush precision 'ms'");
+  usleep(100000);
+  taos_select_db(taos, "subpush");
+
+  char sql[256];
+  execute(taos, "create table st(ts timestamp, v int) tags(t int)");
+  for (int i = 0; i < NUM_OF_TABLES; ++i) {
+    sprintf(sql, "create table t%d using st tags(%d)", i, i);
+    execute(taos, sql);
+  }
+  execute(taos, "create table nt(ts timestamp, v int)");
+
+  // the rows written before the subscription
+  for (int i = 0; i < 5; ++i) {
+    sprintf(sql, "insert into t%d values(now, -1)", i);
+    execute(taos, sql);
+  }
+}
+
+static int count_rows(TAOS_RES* res) {
+  int num = 0;
+  while (taos_fetch_row(res) != NULL) {
+    num++;
+  }
+  return num;
+}
+
+// the writer inserts one row in each round into one of the tables, the value of the row is the round
+static void* write_rows(void* param) {
+  TAOS* taos = connect_db();
+  taos_select_db(taos, "subpush");
+
+  char sql[256];
+  for (int r = 0; r < rounds; ++r) {
+    usleep(200000 + (r * 37 % 10) * 30000);
+    sprintf(sql, "insert into t%d values(now, %d)", r % NUM_OF_TABLES, r);
+    insertedAt[r] = now_us();
+    execute(taos, sql);
+  }
+
+  taos_close(taos);
+  return NULL;
+}
+
+static void consume_stable(TAOS* taos) {
+  TAOS_SUB* tsub = taos_subscribe(taos, 1, "subpush", "select * from st", NULL, NULL, INTERVAL);
+  if (tsub == NULL) {
+    printf("\033[31mfailed to subscribe\033[0m\n");
+    errors++;
+    return;
+  }
+
+  TAOS_RES* res = taos_consume(tsub);
+  int       num = count_rows(res);
+  if (num != 5) {
+    printf("\033[31m%d rows written before the subscription are consumed, expected 5\033[0m\n", num);
+    errors++;
+  }
+
+  // nothing is written, the consume returns an empty result after the interval
+  int64_t st = now_us();
+  res = taos_consume(tsub);
+  num = count_rows(res);
+  int64_t idle = now_us() - st;
+  if (num != 0) {
+    printf("\033[31m%d rows are consumed while nothing is written\033[0m\n", num);
+    errors++;
+  }
+
+  pthread_t writer;
+  pthread_create(&writer, NULL, write_rows, NULL);
+
+  int     received = 0, consumes = 0, emptyConsumes = 0;
+  int64_t totalLatency = 0, maxLatency = 0;
+  st = now_us();
+  while (received < rounds && now_us() - st < (int64_t)rounds * 2000000) {
+    res = taos_consume(tsub);
+    consumes++;
+
+    TAOS_ROW row;
+    int      rows = 0;
+    while ((row = taos_fetch_row(res)) != NULL) {
+      int     r = *(int32_t*)row[1];
+      int64_t latency = now_us() - insertedAt[r];
+      totalLatency += latency;
+      if (latency > maxLatency) {
+        maxLatency = latency;
+      }
+      rows++;
+    }
+
+    received += rows;
+    emptyConsumes += (rows == 0);
+  }
+  pthread_join(writer, NULL);
+
+  printf("%s: idle consume %.0f ms, %d rows in %d consumes (%d empty), latency avg %.1f ms max %.1f ms\n",
+         push ? "push" : "poll", (double)idle / 1000.0, received, consumes, emptyConsumes,
+         received > 0 ? (double)totalLatency / 1000.0 / received : 0, (double)maxLatency / 1000.0);
+
+  if (received != rounds) {
+    printf("\033[31m%d rows are consumed, expected %d\033[0m\n", received, rounds);
+    errors++;
+  }
+  if (push && received > 0 && totalLatency / received > INTERVAL * 1000 / 2) {
+    printf("\033[31mthe rows are not consumed once they are written\033[0m\n");
+    errors++;
+  }
+
+  taos_unsubscribe(tsub, 0);
+}
+
+static void consume_table(TAOS* taos) {
+  TAOS_SUB* tsub = taos_subscribe(taos, 1, "subpush-nt", "select * from nt", NULL, NULL, INTERVAL);
+  if (tsub == NULL) {
+    printf("\033[31mfailed to subscribe\033[0m\n");
+    errors++;
+    return;
+  }
+
+  int num = count_rows(taos_consume(tsub));
+  execute(taos, "insert into nt values(now, 1) (now + 1s, 2)");
+  num += count_rows(taos_consume(tsub));
+  num += count_rows(taos_consume(tsub));
+  if (num != 2) {
+    printf("\033[31m%d rows of the normal table are consumed, expected 2\033[0m\n", num);
+    errors++;
+  }
+
+  taos_unsubscribe(tsub, 0);
+}
+
+static int asyncRows = 0;
+
+static void subscribe_callback(TAOS_SUB* tsub, TAOS_RES* res, void* param, int code) {
+  __atomic_add_fetch(&asyncRows, count_rows(res), __ATOMIC_SEQ_CST);
+}
+
+static void consume_async(TAOS* taos) {
+  TAOS_SUB* tsub = taos_subscribe(taos, 1, "subpush-async", "select * from st", subscribe_callback, NULL, 200);
+  if (tsub == NULL) {
+    printf("\033[31mfailed to subscribe\033[0m\n");
+    errors++;
+    return;
+  }
+
+  usleep(1000000);
+  execute(taos, "insert into t0 values(now, 1000)");
+  usleep(1000000);
+
+  // unsubscribe while the subscribe requests are waiting in the vnodes
+  taos_unsubscribe(tsub, 0);
+  if (asyncRows != 5 + rounds + 1) {
+    printf("\033[31m%d rows are consumed by the callback, expected %d\033[0m\n", asyncRows, 5 + rounds + 1);
+    errors++;
+  }
+}
+
+int main(int argc, char* argv[]) {
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "-p") == 0 && i < argc - 1) {
+      push = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-r") == 0 && i < argc - 1) {
+      rounds = atoi(argv[++i]);
+      if (rounds > 1000) rounds = 1000;
+    } else {
+      printf("usage: %s [-p 1: wait for the submits in the vnodes, 0: query on every consume] [-r rounds]\n", argv[0]);
+      exit(0);
+    }
+  }
+
+  char config[64];
+  sprintf(config, "{\"subscribePush\":\"%d\"}", push);
+  taos_set_config(config);
+
+  taos_options(TSDB_OPTION_TIMEZONE, "GMT-8");
+  TAOS* taos = connect_db();
+  prepare_tables(taos);
+
+  consume_stable(taos);
+  consume_table(taos);
+  consume_async(taos);
+
+  taos_close(taos);
+  taos_cleanup();
+
+  printf("%s\n", errors == 0 ? "done" : "failed");
+  return errors == 0 ? 0 : 1;
+}